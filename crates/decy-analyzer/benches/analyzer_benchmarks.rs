@@ -1,10 +1,20 @@
 //! Benchmarks for pattern detection (Box/Vec candidates)
 //!
-//! Measures performance of malloc/free pattern analysis.
+//! Measures performance of malloc/free pattern analysis, and the throughput
+//! of the single-pass analyzer suite over the `validation/kr-c` corpus.
 
-use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use decy_analyzer::lock_analysis::LockAnalyzer;
+use decy_analyzer::output_params::OutputParamDetector;
 use decy_analyzer::patterns::PatternDetector;
-use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirStatement, HirType};
+use decy_analyzer::subprocess_analysis::SubprocessDetector;
+use decy_analyzer::suite::AnalyzerSuite;
+use decy_analyzer::tagged_union_analysis::TaggedUnionAnalyzer;
+use decy_analyzer::void_ptr_analysis::VoidPtrAnalyzer;
+use decy_hir::{
+    BinaryOperator, HirExpression, HirFunction, HirStatement, HirStruct, HirStructField, HirType,
+};
+use std::path::{Path, PathBuf};
 
 fn create_simple_box_function() -> HirFunction {
     HirFunction::new_with_body(
@@ -138,6 +148,84 @@ fn bench_combined_detection(c: &mut Criterion) {
     });
 }
 
+fn collect_c_files(dir: &Path, files: &mut Vec<PathBuf>) {
+    let Ok(entries) = std::fs::read_dir(dir) else { return };
+    for path in entries.filter_map(|e| e.ok()).map(|e| e.path()) {
+        if path.is_dir() {
+            collect_c_files(&path, files);
+        } else if path.extension().is_some_and(|ext| ext == "c") {
+            files.push(path);
+        }
+    }
+}
+
+/// Parse every file of the K&R corpus that the parser accepts into HIR.
+fn load_kr_c_corpus() -> (Vec<HirFunction>, Vec<HirStruct>) {
+    let root = Path::new(env!("CARGO_MANIFEST_DIR")).join("../../validation/kr-c");
+    let mut files = Vec::new();
+    collect_c_files(&root, &mut files);
+    files.sort();
+
+    let parser = decy_parser::CParser::new().expect("Failed to create parser");
+    let (mut functions, mut structs) = (Vec::new(), Vec::new());
+    for file in files {
+        let Ok(source) = std::fs::read_to_string(&file) else { continue };
+        let Ok(ast) = parser.parse(&source) else { continue };
+        functions.extend(ast.functions().iter().map(HirFunction::from_ast_function));
+        structs.extend(ast.structs().iter().map(|s| {
+            let fields = s
+                .fields()
+                .iter()
+                .map(|f| HirStructField::new(f.name.clone(), HirType::from_ast_type(&f.field_type)))
+                .collect();
+            HirStruct::new(s.name().to_string(), fields)
+        }));
+    }
+    (functions, structs)
+}
+
+fn bench_suite_kr_c(c: &mut Criterion) {
+    let (functions, structs) = load_kr_c_corpus();
+    if functions.is_empty() {
+        return;
+    }
+
+    let mut group = c.benchmark_group("analyzer_suite_kr_c");
+    // Report functions/sec
+    group.throughput(Throughput::Elements(functions.len() as u64));
+
+    group.bench_function("separate_detectors", |b| {
+        let (patterns, locks) = (PatternDetector::new(), LockAnalyzer::new());
+        let (outputs, void_ptrs) = (OutputParamDetector::new(), VoidPtrAnalyzer::new());
+        let (subprocess, tagged) = (SubprocessDetector::new(), TaggedUnionAnalyzer::new());
+        b.iter(|| {
+            for func in black_box(&functions) {
+                black_box(patterns.find_box_candidates(func));
+                black_box(patterns.find_vec_candidates(func));
+                black_box(locks.find_lock_regions(func));
+                black_box(locks.analyze_lock_data_mapping(func));
+                black_box(outputs.detect(func));
+                black_box(void_ptrs.analyze(func));
+                black_box(subprocess.detect(func));
+            }
+            for s in black_box(&structs) {
+                black_box(tagged.analyze_struct(s));
+            }
+        })
+    });
+
+    let single = AnalyzerSuite::new().with_threads(1);
+    group.bench_function("suite_single_thread", |b| {
+        b.iter(|| single.analyze(black_box(&functions), black_box(&structs)))
+    });
+
+    let parallel = AnalyzerSuite::new();
+    group.bench_function("suite_parallel", |b| {
+        b.iter(|| parallel.analyze(black_box(&functions), black_box(&structs)))
+    });
+    group.finish();
+}
+
 criterion_group!(
     benches,
     bench_box_detection_simple,
@@ -145,5 +233,6 @@ criterion_group!(
     bench_box_detection_scaling,
     bench_vec_detection_scaling,
     bench_combined_detection,
+    bench_suite_kr_c,
 );
 criterion_main!(benches);
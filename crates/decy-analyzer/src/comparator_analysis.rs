@@ -0,0 +1,241 @@
+//! Recognition of `qsort`/`bsearch` comparators that order by one key.
+//!
+//! Most C comparators compare one integer of each element:
+//!
+//! ```c
+//! int by_value(const void *a, const void *b) { return *(const int *)a - *(const int *)b; }
+//! int by_id(const void *a, const void *b) {
+//!     const struct rec *x = a;
+//!     const struct rec *y = b;
+//!     return (x->id > y->id) - (x->id < y->id);
+//! }
+//! ```
+//!
+//! [`ComparatorAnalyzer`] reports these as a [`KeyComparator`], so codegen
+//! can sort with `sort_unstable()` or by key instead of calling the
+//! comparator and turning its `int` into an `Ordering`. The `void*` form is
+//! recognised as well as the one left once the parameters take a concrete
+//! type.
+
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirStatement, HirStruct, HirType};
+use std::collections::HashMap;
+
+/// What a comparator orders elements by.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub enum SortKey {
+    /// The element itself, an integer
+    Element,
+    /// An integer field of the element, a struct
+    Field(String),
+}
+
+/// A comparator ordering elements by an integer key.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct KeyComparator {
+    /// The key compared
+    pub key: SortKey,
+    /// Larger keys sort first
+    pub descending: bool,
+}
+
+/// A key read through one of the comparator's arguments.
+struct KeyRead {
+    /// Position of the argument
+    arg: usize,
+    key: SortKey,
+    ty: HirType,
+}
+
+/// Resolves the key reads of one comparator body.
+struct KeyScan<'a> {
+    structs: &'a [HirStruct],
+    /// Parameters of the comparator, with their positions and types
+    params: HashMap<&'a str, (usize, &'a HirType)>,
+    /// Locals declared before the `return`, with their types and initialisers
+    locals: HashMap<&'a str, (&'a HirType, &'a HirExpression)>,
+}
+
+impl KeyScan<'_> {
+    /// A pointer to one of the comparator's arguments, as its position and
+    /// pointee: `a`, `(T *)a`, or a local initialised from one.
+    fn argument(&self, expr: &HirExpression) -> Option<(usize, HirType)> {
+        match expr {
+            HirExpression::Variable(name) => {
+                if let Some(&(k, ty)) = self.params.get(name.as_str()) {
+                    let HirType::Pointer(inner) = ty else {
+                        return None;
+                    };
+                    return Some((k, (**inner).clone()));
+                }
+                let (ty, init) = self.local(name)?;
+                let (k, _) = self.argument(init)?;
+                match ty {
+                    HirType::Pointer(inner) => Some((k, (**inner).clone())),
+                    _ => None,
+                }
+            }
+            HirExpression::Cast { target_type: HirType::Pointer(inner), expr } => {
+                let (k, _) = self.argument(expr)?;
+                Some((k, (**inner).clone()))
+            }
+            _ => None,
+        }
+    }
+
+    /// The key read by `expr`: `*p`, `p->f`, `(*p).f`, or a local holding one.
+    fn key(&self, expr: &HirExpression) -> Option<KeyRead> {
+        match expr {
+            HirExpression::Dereference(pointer) => {
+                let (arg, ty) = self.argument(pointer)?;
+                Some(KeyRead { arg, key: SortKey::Element, ty })
+            }
+            HirExpression::PointerFieldAccess { pointer, field } => self.field(pointer, field),
+            HirExpression::FieldAccess { object, field } => match object.as_ref() {
+                HirExpression::Dereference(pointer) => self.field(pointer, field),
+                _ => None,
+            },
+            HirExpression::Variable(name) => {
+                let (ty, init) = self.local(name)?;
+                let read = self.key(init)?;
+                (*ty == read.ty).then_some(read)
+            }
+            _ => None,
+        }
+    }
+
+    fn field(&self, pointer: &HirExpression, field: &str) -> Option<KeyRead> {
+        let (arg, HirType::Struct(name)) = self.argument(pointer)? else {
+            return None;
+        };
+        let ty = self
+            .structs
+            .iter()
+            .find(|s| s.name() == name)?
+            .fields()
+            .iter()
+            .find(|f| f.name() == field)?
+            .field_type()
+            .clone();
+        Some(KeyRead { arg, key: SortKey::Field(field.to_string()), ty })
+    }
+
+    /// A local with its initialiser, unless it refers to itself.
+    fn local(&self, name: &str) -> Option<(&HirType, &HirExpression)> {
+        let &(ty, init) = self.locals.get(name)?;
+        (*init != HirExpression::Variable(name.to_string())).then_some((ty, init))
+    }
+
+    /// `x - y` or `(x > y) - (x < y)`, with `x` and `y` the same key of
+    /// different arguments.
+    fn order(&self, expr: &HirExpression) -> Option<KeyComparator> {
+        let HirExpression::BinaryOp { op: BinaryOperator::Subtract, left, right } = expr else {
+            return None;
+        };
+        if let (
+            HirExpression::BinaryOp { op: first, left: x, right: y },
+            HirExpression::BinaryOp { op: second, left: x2, right: y2 },
+        ) = (left.as_ref(), right.as_ref())
+        {
+            if x != x2 || y != y2 {
+                return None;
+            }
+            return match (first, second) {
+                (BinaryOperator::GreaterThan, BinaryOperator::LessThan) => {
+                    self.compared(x, y, is_ordered_integer)
+                }
+                (BinaryOperator::LessThan, BinaryOperator::GreaterThan) => self
+                    .compared(x, y, is_ordered_integer)
+                    .map(|c| KeyComparator { descending: !c.descending, ..c }),
+                _ => None,
+            };
+        }
+        // The difference of two unsigned keys wraps instead of ordering them
+        self.compared(left, right, |ty| matches!(ty, HirType::Int | HirType::SignedChar))
+    }
+
+    fn compared(
+        &self,
+        x: &HirExpression,
+        y: &HirExpression,
+        key_type: fn(&HirType) -> bool,
+    ) -> Option<KeyComparator> {
+        let (x, y) = (self.key(x)?, self.key(y)?);
+        if x.arg == y.arg || x.key != y.key || x.ty != y.ty || !key_type(&x.ty) {
+            return None;
+        }
+        Some(KeyComparator { key: x.key, descending: x.arg == 1 })
+    }
+}
+
+/// Integer types that order the same in C and in Rust.
+fn is_ordered_integer(ty: &HirType) -> bool {
+    matches!(ty, HirType::Int | HirType::UnsignedInt | HirType::SignedChar)
+}
+
+/// Finds comparators that order by one integer key.
+#[derive(Debug, Clone, Default)]
+pub struct ComparatorAnalyzer;
+
+impl ComparatorAnalyzer {
+    /// Create a new comparator analyzer.
+    pub fn new() -> Self {
+        Self
+    }
+
+    /// The key comparators among the functions of a unit, by name.
+    pub fn analyze(
+        &self,
+        structs: &[HirStruct],
+        functions: &[HirFunction],
+    ) -> Vec<(String, KeyComparator)> {
+        functions
+            .iter()
+            .filter_map(|f| Some((f.name().to_string(), self.recognize(structs, f)?)))
+            .collect()
+    }
+
+    /// Recognise `func` as a comparator ordering by one integer key.
+    ///
+    /// It must take two pointers and return `int`, and its body must be
+    /// declarations of locals read from its arguments followed by a
+    /// `return` of `x - y` or `(x > y) - (x < y)` (descending with the
+    /// operands swapped), where `x` and `y` read the same key.
+    pub fn recognize(&self, structs: &[HirStruct], func: &HirFunction) -> Option<KeyComparator> {
+        let params = func.parameters();
+        if *func.return_type() != HirType::Int
+            || params.len() != 2
+            || !params.iter().all(|p| matches!(p.param_type(), HirType::Pointer(_)))
+        {
+            return None;
+        }
+        let (result, decls) = func.body().split_last()?;
+        let HirStatement::Return(Some(result)) = result else {
+            return None;
+        };
+        let mut scan = KeyScan {
+            structs,
+            params: params
+                .iter()
+                .enumerate()
+                .map(|(k, p)| (p.name(), (k, p.param_type())))
+                .collect(),
+            locals: HashMap::new(),
+        };
+        for decl in decls {
+            let HirStatement::VariableDeclaration { name, var_type, initializer: Some(init) } =
+                decl
+            else {
+                return None;
+            };
+            if scan.params.contains_key(name.as_str()) {
+                return None;
+            }
+            scan.locals.insert(name, (var_type, init));
+            // Only reads of the arguments, so dropping the call changes nothing
+            if scan.argument(init).is_none() && scan.key(init).is_none() {
+                return None;
+            }
+        }
+        scan.order(result)
+    }
+}
@@ -0,0 +1,462 @@
+//! Possible targets of calls through function pointers.
+//!
+//! A C function pointer becomes a Rust `fn` pointer, so every call through it
+//! is indirect and nothing behind it can be inlined. Within a translation
+//! unit the functions that reach a pointer are often known:
+//!
+//! ```c
+//! int fold(int (*op)(int, int), int *items, int n, int acc);
+//! total = fold(add, data, n, 0);
+//!
+//! int (*step)(int, int) = descending ? sub : add;
+//! acc = step(acc, x);
+//! ```
+//!
+//! [`DispatchAnalyzer`] finds, across the unit:
+//!
+//! - function-pointer parameters that are only called or passed on to
+//!   another such parameter. Codegen takes them as `impl Fn`, so each
+//!   caller gets a copy of the function specialised to what it passes.
+//! - function-pointer locals that only ever hold functions of the unit,
+//!   named directly or chosen by a `?:`. Their calls become a direct call
+//!   when there is one target and a `match` over the targets otherwise.
+
+use decy_hir::visit::{walk_expression, walk_statements, Visitor};
+use decy_hir::{HirExpression, HirFunction, HirStatement, HirType};
+use std::collections::{HashMap, HashSet};
+
+/// A function-pointer local that only ever holds functions of the unit.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct PointerTargets {
+    /// Name of the local
+    pub name: String,
+    /// Functions it may hold, in the order they are first assigned
+    pub targets: Vec<String>,
+}
+
+/// Function pointers of a unit whose calls can be dispatched statically.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct StaticDispatch {
+    /// Function-pointer parameters taken as `impl Fn`, as the position and
+    /// name of each, by function
+    pub params: HashMap<String, Vec<(usize, String)>>,
+    /// Function-pointer locals with their targets, by function
+    pub locals: HashMap<String, Vec<PointerTargets>>,
+}
+
+impl StaticDispatch {
+    /// The function-pointer parameters of `function` taken as `impl Fn`.
+    pub fn params_of(&self, function: &str) -> &[(usize, String)] {
+        self.params.get(function).map_or(&[], Vec::as_slice)
+    }
+
+    /// The function-pointer locals of `function` with known targets.
+    pub fn locals_of(&self, function: &str) -> &[PointerTargets] {
+        self.locals.get(function).map_or(&[], Vec::as_slice)
+    }
+
+    /// True when no call is dispatched statically.
+    pub fn is_empty(&self) -> bool {
+        self.params.is_empty() && self.locals.is_empty()
+    }
+}
+
+/// What one body (or the global initialisers) does with the names it mentions.
+///
+/// Only what the dispatch decisions read is kept, so a summary outlives its
+/// function cheaply.
+#[derive(Default)]
+struct BodyUses {
+    /// Occurrences of each name as a value, including as an argument
+    values: HashMap<String, usize>,
+    /// Every call, with the name of each argument that is a plain variable
+    calls: Vec<(String, Vec<Option<String>>)>,
+    /// Each declaration of a local: its type and, for a function pointer,
+    /// its initialiser
+    declared: HashMap<String, Vec<(HirType, Option<HirExpression>)>>,
+    /// Values assigned to each local; `None` for a value that cannot name
+    /// a function
+    assigned: HashMap<String, Vec<Option<HirExpression>>>,
+}
+
+impl Visitor for BodyUses {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        match stmt {
+            HirStatement::VariableDeclaration { name, var_type, initializer } => {
+                let initializer = match var_type {
+                    HirType::FunctionPointer { .. } => initializer.clone(),
+                    _ => None,
+                };
+                self.declared.entry(name.clone()).or_default().push((var_type.clone(), initializer))
+            }
+            HirStatement::Assignment { target, value } => {
+                let value =
+                    matches!(value, HirExpression::Variable(_) | HirExpression::Ternary { .. })
+                        .then(|| value.clone());
+                self.assigned.entry(target.clone()).or_default().push(value)
+            }
+            _ => {}
+        }
+    }
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        match expr {
+            HirExpression::Variable(name) => *self.values.entry(name.clone()).or_default() += 1,
+            HirExpression::FunctionCall { function, arguments } => {
+                let names = arguments
+                    .iter()
+                    .map(|arg| match arg {
+                        HirExpression::Variable(name) => Some(name.clone()),
+                        _ => None,
+                    })
+                    .collect();
+                self.calls.push((function.clone(), names));
+            }
+            _ => {}
+        }
+    }
+}
+
+/// Set when an expression may have an effect besides its value.
+#[derive(Default)]
+struct Effects(bool);
+
+impl Visitor for Effects {
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        self.0 |= matches!(
+            expr,
+            HirExpression::FunctionCall { .. }
+                | HirExpression::PostIncrement { .. }
+                | HirExpression::PreIncrement { .. }
+                | HirExpression::PostDecrement { .. }
+                | HirExpression::PreDecrement { .. }
+                | HirExpression::Malloc { .. }
+                | HirExpression::Calloc { .. }
+                | HirExpression::Realloc { .. }
+                | HirExpression::StringMethodCall { .. }
+                | HirExpression::CxxNew { .. }
+                | HirExpression::CxxDelete { .. }
+        );
+    }
+}
+
+fn has_effects(expr: &HirExpression) -> bool {
+    let mut effects = Effects::default();
+    walk_expression(&mut effects, expr);
+    effects.0
+}
+
+/// Types passed and returned by value alike in C and in the generated Rust,
+/// so a function taking them implements the `Fn` bound of the pointer type.
+fn is_by_value(ty: &HirType) -> bool {
+    matches!(
+        ty,
+        HirType::Void
+            | HirType::Bool
+            | HirType::Int
+            | HirType::UnsignedInt
+            | HirType::Float
+            | HirType::Double
+            | HirType::Char
+            | HirType::SignedChar
+            | HirType::Enum(_)
+            | HirType::Struct(_)
+    )
+}
+
+/// The names a function sees: its parameters and locals, then the globals
+/// and functions of the unit.
+struct Scope {
+    function: String,
+    params: Vec<(String, HirType)>,
+    uses: BodyUses,
+}
+
+impl Scope {
+    fn param(&self, name: &str) -> Option<(usize, &HirType)> {
+        let k = self.params.iter().position(|(p, _)| p == name)?;
+        Some((k, &self.params[k].1))
+    }
+
+    fn shadows(&self, name: &str) -> bool {
+        self.param(name).is_some() || self.uses.declared.contains_key(name)
+    }
+
+    /// Whether a parameter is redeclared or reassigned in the body.
+    fn rebinds(&self, name: &str) -> bool {
+        self.uses.declared.contains_key(name) || self.uses.assigned.contains_key(name)
+    }
+
+    /// The function-pointer type of a parameter or local.
+    fn pointer_type(&self, name: &str) -> Option<&HirType> {
+        let ty = match self.param(name) {
+            Some((_, ty)) => ty,
+            None => &self.uses.declared.get(name)?.first()?.0,
+        };
+        matches!(ty, HirType::FunctionPointer { .. }).then_some(ty)
+    }
+}
+
+/// Incremental form of [`DispatchAnalyzer::analyze`] for callers that lower
+/// and drop one function at a time.
+///
+/// Each body is kept only as the names it uses, calls and assigns; the
+/// decisions are made in [`DispatchScan::finish`], once every function of
+/// the unit is known.
+pub struct DispatchScan {
+    /// Arity of every function of the unit, defined or only declared
+    functions: HashMap<String, usize>,
+    globals: HashSet<String>,
+    initialisers: BodyUses,
+    scopes: Vec<Scope>,
+}
+
+impl DispatchScan {
+    /// Start a scan over the unit's globals, whose initialisers may also
+    /// name functions.
+    pub fn new(globals: &[HirStatement]) -> Self {
+        let mut initialisers = BodyUses::default();
+        walk_statements(&mut initialisers, globals);
+        Self {
+            functions: HashMap::new(),
+            globals: globals
+                .iter()
+                .filter_map(|g| match g {
+                    HirStatement::VariableDeclaration { name, .. } => Some(name.clone()),
+                    _ => None,
+                })
+                .collect(),
+            initialisers,
+            scopes: Vec::new(),
+        }
+    }
+
+    /// Record one function's signature and what its body does with the
+    /// names it mentions.
+    pub fn observe(&mut self, func: &HirFunction) {
+        self.functions.insert(func.name().to_string(), func.parameters().len());
+        if !func.has_body() {
+            return;
+        }
+        let mut uses = BodyUses::default();
+        walk_statements(&mut uses, func.body());
+        self.scopes.push(Scope {
+            function: func.name().to_string(),
+            params: func
+                .parameters()
+                .iter()
+                .map(|p| (p.name().to_string(), p.param_type().clone()))
+                .collect(),
+            uses,
+        });
+    }
+
+    /// Decide which parameters and locals are dispatched statically.
+    pub fn finish(self) -> StaticDispatch {
+        let function_values = self.function_values();
+        let fn_params = self.fn_params(&function_values);
+
+        let mut dispatch = StaticDispatch::default();
+        for scope in &self.scopes {
+            let f = &scope.function;
+            let params: Vec<(usize, String)> = scope
+                .params
+                .iter()
+                .enumerate()
+                .filter(|(k, _)| fn_params.contains(&(f.clone(), *k)))
+                .map(|(k, (name, _))| (k, name.clone()))
+                .collect();
+            if !params.is_empty() {
+                dispatch.params.insert(f.clone(), params);
+            }
+            let locals = self.pointer_locals(scope);
+            if !locals.is_empty() {
+                dispatch.locals.insert(f.clone(), locals);
+            }
+        }
+        dispatch
+    }
+
+    /// Functions mentioned as values anywhere, rather than called.
+    fn function_values(&self) -> HashSet<String> {
+        let mentioned = |scope: Option<&Scope>, uses: &BodyUses| {
+            uses.values
+                .keys()
+                .filter(|name| self.function_named(scope, name).is_some())
+                .cloned()
+                .collect::<Vec<_>>()
+        };
+        let mut values: HashSet<String> = mentioned(None, &self.initialisers).into_iter().collect();
+        for scope in &self.scopes {
+            values.extend(mentioned(Some(scope), &scope.uses));
+        }
+        values
+    }
+
+    /// The arity of the function `name` refers to in `scope`, unless a
+    /// parameter, local or global hides it.
+    fn function_named(&self, scope: Option<&Scope>, name: &str) -> Option<usize> {
+        if scope.is_some_and(|s| s.shadows(name)) || self.globals.contains(name) {
+            return None;
+        }
+        self.functions.get(name).copied()
+    }
+
+    /// Parameters only called or passed on to another parameter that is.
+    fn fn_params(&self, function_values: &HashSet<String>) -> HashSet<(String, usize)> {
+        let mut params: HashSet<(String, usize)> = self
+            .scopes
+            .iter()
+            .flat_map(|scope| {
+                scope.params.iter().enumerate().filter_map(move |(k, (name, ty))| {
+                    let HirType::FunctionPointer { param_types, return_type } = ty else {
+                        return None;
+                    };
+                    let candidate = param_types.iter().all(is_by_value)
+                        && is_by_value(return_type)
+                        && !function_values.contains(&scope.function)
+                        && !scope.rebinds(name)
+                        && self.call_sites_pass_functions(scope, k, param_types.len());
+                    candidate.then(|| (scope.function.clone(), k))
+                })
+            })
+            .collect();
+        // Passing one on needs the callee's parameter to be generic too
+        loop {
+            let kept: HashSet<(String, usize)> = params
+                .iter()
+                .filter(|(f, k)| self.only_called_or_forwarded(f, *k, &params))
+                .cloned()
+                .collect();
+            if kept.len() == params.len() {
+                return kept;
+            }
+            params = kept;
+        }
+    }
+
+    /// Every call of `f` passes a function, or a function pointer the
+    /// caller holds, at position `k`.
+    fn call_sites_pass_functions(&self, f: &Scope, k: usize, arity: usize) -> bool {
+        self.scopes.iter().all(|scope| {
+            scope
+                .uses
+                .calls
+                .iter()
+                .filter(|(callee, _)| {
+                    *callee == f.function && self.function_named(Some(scope), callee).is_some()
+                })
+                .all(|(_, args)| {
+                    let Some(Some(arg)) = (args.len() == f.params.len()).then(|| args[k].as_ref())
+                    else {
+                        return false;
+                    };
+                    scope.pointer_type(arg).is_some()
+                        || self.function_named(Some(scope), arg) == Some(arity)
+                })
+        })
+    }
+
+    fn only_called_or_forwarded(
+        &self,
+        function: &str,
+        k: usize,
+        params: &HashSet<(String, usize)>,
+    ) -> bool {
+        let Some(scope) = self.scopes.iter().find(|s| s.function == function) else {
+            return false;
+        };
+        let name = &scope.params[k].0;
+        let mut forwarded = 0;
+        for (callee, args) in &scope.uses.calls {
+            for (i, _) in args.iter().enumerate().filter(|(_, a)| a.as_ref() == Some(name)) {
+                match self.function_named(Some(scope), callee) {
+                    Some(_) if params.contains(&(callee.clone(), i)) => forwarded += 1,
+                    _ => return false,
+                }
+            }
+        }
+        scope.uses.values.get(name).copied().unwrap_or(0) == forwarded
+    }
+
+    /// Function-pointer locals that are only called and only ever hold
+    /// functions of the unit.
+    fn pointer_locals(&self, scope: &Scope) -> Vec<PointerTargets> {
+        let mut locals: Vec<PointerTargets> = scope
+            .uses
+            .declared
+            .iter()
+            .filter_map(|(name, decls)| {
+                let [(HirType::FunctionPointer { param_types, .. }, init)] = decls.as_slice()
+                else {
+                    return None;
+                };
+                if scope.param(name).is_some()
+                    || self.functions.contains_key(name.as_str())
+                    || scope.uses.values.contains_key(name)
+                    || !scope.uses.calls.iter().any(|(callee, _)| callee == name)
+                {
+                    return None;
+                }
+                let assigned = scope.uses.assigned.get(name).into_iter().flatten();
+                let values = init.iter().map(Some).chain(assigned.map(Option::as_ref));
+                let mut targets: Vec<String> = Vec::new();
+                for value in values {
+                    for target in self.targets(scope, value?, param_types.len())? {
+                        if !targets.contains(&target) {
+                            targets.push(target);
+                        }
+                    }
+                }
+                (!targets.is_empty()).then(|| PointerTargets { name: name.clone(), targets })
+            })
+            .collect();
+        locals.sort_by(|a, b| a.name.cmp(&b.name));
+        locals
+    }
+
+    /// The functions a value assigned to a function pointer may be: a
+    /// function, or a choice between them with a condition free of effects.
+    fn targets(&self, scope: &Scope, value: &HirExpression, arity: usize) -> Option<Vec<String>> {
+        match value {
+            HirExpression::Variable(name) => {
+                (self.function_named(Some(scope), name)? == arity).then(|| vec![name.clone()])
+            }
+            HirExpression::Ternary { condition, then_expr, else_expr }
+                if !has_effects(condition) =>
+            {
+                let mut targets = self.targets(scope, then_expr, arity)?;
+                targets.extend(self.targets(scope, else_expr, arity)?);
+                Some(targets)
+            }
+            _ => None,
+        }
+    }
+}
+
+/// Finds the function pointers of a unit whose calls can be dispatched
+/// statically.
+#[derive(Debug, Clone, Default)]
+pub struct DispatchAnalyzer;
+
+impl DispatchAnalyzer {
+    /// Create a new dispatch analyzer.
+    pub fn new() -> Self {
+        Self
+    }
+
+    /// Analyze the functions of a unit together with its globals, whose
+    /// initialisers may also name functions.
+    ///
+    /// A parameter is taken as `impl Fn` when its function-pointer type
+    /// passes and returns values only, it is only called or passed on to
+    /// another such parameter, every caller passes a function or a function
+    /// pointer of its own, and its function is never itself used as a value.
+    ///
+    /// A local has known targets when it is declared once, only called, and
+    /// every value it is given names functions of the unit.
+    pub fn analyze(&self, globals: &[HirStatement], functions: &[HirFunction]) -> StaticDispatch {
+        let mut scan = DispatchScan::new(globals);
+        functions.iter().for_each(|f| scan.observe(f));
+        scan.finish()
+    }
+}
@@ -6,9 +6,14 @@
 #![warn(clippy::all)]
 #![deny(unsafe_code)]
 
+pub mod comparator_analysis;
+pub mod dispatch_analysis;
 pub mod lock_analysis;
 pub mod output_params;
 pub mod patterns;
+pub mod pool_analysis;
+pub mod stdio_analysis;
 pub mod subprocess_analysis;
+pub mod suite;
 pub mod tagged_union_analysis;
 pub mod void_ptr_analysis;
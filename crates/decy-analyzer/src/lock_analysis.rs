@@ -3,6 +3,7 @@
 //! Analyzes C code with pthread_mutex locks to determine which locks
 //! protect which data variables, enabling safe `Mutex<T>` generation.
 
+use decy_hir::visit::{walk_statements, Visitor};
 use decy_hir::{HirExpression, HirFunction, HirStatement};
 use std::collections::{HashMap, HashSet};
 
@@ -71,30 +72,30 @@ impl LockAnalyzer {
     /// Identifies pthread_mutex_lock/unlock pairs and returns
     /// the code regions they protect.
     pub fn find_lock_regions(&self, func: &HirFunction) -> Vec<LockRegion> {
-        let mut regions = Vec::new();
-        let body = func.body();
-
-        // Track active locks (lock name -> start index)
-        let mut active_locks: HashMap<String, usize> = HashMap::new();
-
-        for (idx, stmt) in body.iter().enumerate() {
-            // Check for pthread_mutex_lock calls
-            if let Some(lock_name) = Self::extract_lock_call(stmt) {
-                active_locks.insert(lock_name, idx);
-            }
-            // Check for pthread_mutex_unlock calls
-            else if let Some(unlock_name) = Self::extract_unlock_call(stmt) {
-                if let Some(start_idx) = active_locks.remove(&unlock_name) {
-                    regions.push(LockRegion {
-                        lock_name: unlock_name,
-                        start_index: start_idx,
-                        end_index: idx,
-                    });
-                }
-            }
+        // Regions only depend on top-level statements, so skip nested blocks
+        let mut visitor = self.visitor(false);
+        for stmt in func.body() {
+            visitor.visit_statement(stmt);
+            visitor.leave_statement(stmt);
         }
+        visitor.into_results().0
+    }
 
-        regions
+    /// Create a visitor that finds lock regions and, optionally, the data
+    /// each lock protects, in a single walk over the body.
+    ///
+    /// Call [`LockVisitor::into_results`] after walking the function body.
+    pub fn visitor(&self, collect_data: bool) -> LockVisitor {
+        LockVisitor {
+            collect_data,
+            depth: 0,
+            index: 0,
+            top_level: TopLevel::Other,
+            active: HashMap::new(),
+            accessed: None,
+            regions: Vec::new(),
+            mapping: LockDataMapping::new(),
+        }
     }
 
     /// Extract lock name from pthread_mutex_lock call.
@@ -134,135 +135,9 @@ impl LockAnalyzer {
     /// Determines which locks protect which data variables based
     /// on variable accesses within locked regions.
     pub fn analyze_lock_data_mapping(&self, func: &HirFunction) -> LockDataMapping {
-        let mut mapping = LockDataMapping::new();
-        let regions = self.find_lock_regions(func);
-        let body = func.body();
-
-        // For each lock region, find all accessed variables
-        for region in regions {
-            let protected_vars = self.find_accessed_variables_in_region(body, &region);
-            for var in protected_vars {
-                mapping.add_protected_data(region.lock_name.clone(), var);
-            }
-        }
-
-        mapping
-    }
-
-    /// Find all variables accessed in a locked region.
-    fn find_accessed_variables_in_region(
-        &self,
-        body: &[HirStatement],
-        region: &LockRegion,
-    ) -> HashSet<String> {
-        let mut accessed = HashSet::new();
-
-        // Scan statements in the region (excluding lock/unlock calls)
-        for idx in (region.start_index + 1)..region.end_index {
-            if let Some(stmt) = body.get(idx) {
-                self.collect_accessed_variables(stmt, &mut accessed);
-            }
-        }
-
-        accessed
-    }
-
-    /// Recursively collect all variable names accessed in a statement.
-    fn collect_accessed_variables(&self, stmt: &HirStatement, accessed: &mut HashSet<String>) {
-        match stmt {
-            HirStatement::Assignment { target, value } => {
-                accessed.insert(target.clone());
-                self.collect_variables_from_expr(value, accessed);
-            }
-            HirStatement::VariableDeclaration { initializer: Some(init), .. } => {
-                // Local variable declarations don't count as protected data
-                // But if the initializer reads from other variables, those count
-                self.collect_variables_from_expr(init, accessed);
-                // Don't add the variable name itself - it's local to this scope
-            }
-            HirStatement::VariableDeclaration { initializer: None, .. } => {
-                // No initializer, nothing to track
-            }
-            HirStatement::Return(Some(e)) => {
-                self.collect_variables_from_expr(e, accessed);
-            }
-            HirStatement::Return(None) => {
-                // No return value, nothing to track
-            }
-            HirStatement::If { condition, then_block, else_block } => {
-                self.collect_variables_from_expr(condition, accessed);
-                for s in then_block {
-                    self.collect_accessed_variables(s, accessed);
-                }
-                if let Some(else_stmts) = else_block {
-                    for s in else_stmts {
-                        self.collect_accessed_variables(s, accessed);
-                    }
-                }
-            }
-            HirStatement::While { condition, body } => {
-                self.collect_variables_from_expr(condition, accessed);
-                for s in body {
-                    self.collect_accessed_variables(s, accessed);
-                }
-            }
-            HirStatement::Expression(expr) => {
-                self.collect_variables_from_expr(expr, accessed);
-            }
-            HirStatement::DerefAssignment { target, value } => {
-                self.collect_variables_from_expr(target, accessed);
-                self.collect_variables_from_expr(value, accessed);
-            }
-            HirStatement::ArrayIndexAssignment { array, index, value } => {
-                self.collect_variables_from_expr(array, accessed);
-                self.collect_variables_from_expr(index, accessed);
-                self.collect_variables_from_expr(value, accessed);
-            }
-            HirStatement::FieldAssignment { object, field: _, value } => {
-                self.collect_variables_from_expr(object, accessed);
-                self.collect_variables_from_expr(value, accessed);
-            }
-            _ => {
-                // Break, Continue, etc. don't access variables
-            }
-        }
-    }
-
-    /// Collect variable names from an expression.
-    #[allow(clippy::only_used_in_recursion)]
-    fn collect_variables_from_expr(&self, expr: &HirExpression, accessed: &mut HashSet<String>) {
-        match expr {
-            HirExpression::Variable(name) => {
-                accessed.insert(name.clone());
-            }
-            HirExpression::BinaryOp { left, right, .. } => {
-                self.collect_variables_from_expr(left, accessed);
-                self.collect_variables_from_expr(right, accessed);
-            }
-            HirExpression::UnaryOp { operand, .. } => {
-                self.collect_variables_from_expr(operand, accessed);
-            }
-            HirExpression::FunctionCall { arguments, .. } => {
-                for arg in arguments {
-                    self.collect_variables_from_expr(arg, accessed);
-                }
-            }
-            HirExpression::AddressOf(inner) | HirExpression::Dereference(inner) => {
-                self.collect_variables_from_expr(inner, accessed);
-            }
-            HirExpression::ArrayIndex { array, index } => {
-                self.collect_variables_from_expr(array, accessed);
-                self.collect_variables_from_expr(index, accessed);
-            }
-            HirExpression::FieldAccess { object, .. } => {
-                self.collect_variables_from_expr(object, accessed);
-            }
-            HirExpression::Cast { expr, .. } => {
-                self.collect_variables_from_expr(expr, accessed);
-            }
-            // Literals and other expressions don't reference variables
-            _ => {}
-        }
+        let mut visitor = self.visitor(true);
+        walk_statements(&mut visitor, func.body());
+        visitor.into_results().1
     }
 
     /// Check for lock discipline violations.
@@ -309,6 +184,117 @@ impl LockAnalyzer {
     }
 }
 
+/// Role of the top-level statement currently being walked.
+#[derive(Debug, Clone)]
+enum TopLevel {
+    Lock(String),
+    Unlock(String),
+    Other,
+}
+
+/// Streaming lock-region and lock-to-data analysis.
+///
+/// Lock and unlock calls are matched on top-level statements, as in
+/// [`LockAnalyzer::find_lock_regions`]. While any lock is open, every variable
+/// read or assigned at any depth of a top-level statement is attributed to
+/// the open locks; names introduced by local declarations are not recorded
+/// themselves, only the variables their initializers read.
+#[derive(Debug, Clone)]
+pub struct LockVisitor {
+    collect_data: bool,
+    depth: usize,
+    /// Index of the current top-level statement
+    index: usize,
+    top_level: TopLevel,
+    /// Open locks: name -> (start index, variables accessed since)
+    active: HashMap<String, (usize, HashSet<String>)>,
+    /// Variables accessed by the current top-level statement, when collecting
+    accessed: Option<HashSet<String>>,
+    regions: Vec<LockRegion>,
+    mapping: LockDataMapping,
+}
+
+impl LockVisitor {
+    /// Return the matched lock regions and the lock-to-data mapping.
+    pub fn into_results(self) -> (Vec<LockRegion>, LockDataMapping) {
+        (self.regions, self.mapping)
+    }
+
+    /// Attribute the finished top-level statement and update open locks.
+    fn finish_top_level(&mut self) {
+        let accessed = self.accessed.take().unwrap_or_default();
+        let idx = self.index;
+        self.index += 1;
+
+        let closing = match &self.top_level {
+            TopLevel::Unlock(name) => Some(name.as_str()),
+            _ => None,
+        };
+        // The lock and unlock calls themselves are outside their own region
+        for (name, (_, vars)) in &mut self.active {
+            if Some(name.as_str()) != closing {
+                vars.extend(accessed.iter().cloned());
+            }
+        }
+
+        match std::mem::replace(&mut self.top_level, TopLevel::Other) {
+            TopLevel::Lock(name) => {
+                self.active.insert(name, (idx, HashSet::new()));
+            }
+            TopLevel::Unlock(name) => {
+                if let Some((start_idx, vars)) = self.active.remove(&name) {
+                    for var in vars {
+                        self.mapping.add_protected_data(name.clone(), var);
+                    }
+                    self.regions.push(LockRegion {
+                        lock_name: name,
+                        start_index: start_idx,
+                        end_index: idx,
+                    });
+                }
+            }
+            TopLevel::Other => {}
+        }
+    }
+}
+
+impl Visitor for LockVisitor {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        if self.depth == 0 {
+            self.top_level = if let Some(name) = LockAnalyzer::extract_lock_call(stmt) {
+                TopLevel::Lock(name)
+            } else if let Some(name) = LockAnalyzer::extract_unlock_call(stmt) {
+                TopLevel::Unlock(name)
+            } else {
+                TopLevel::Other
+            };
+            if self.collect_data && !self.active.is_empty() {
+                self.accessed = Some(HashSet::new());
+            }
+        }
+        self.depth += 1;
+
+        if let (Some(accessed), HirStatement::Assignment { target, .. }) =
+            (&mut self.accessed, stmt)
+        {
+            accessed.insert(target.clone());
+        }
+    }
+
+    fn leave_statement(&mut self, _stmt: &HirStatement) {
+        self.depth -= 1;
+        if self.depth == 0 {
+            self.finish_top_level();
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        if let (Some(accessed), HirExpression::Variable(name)) = (&mut self.accessed, expr) {
+            accessed.insert(name.clone());
+        }
+    }
+}
+
 impl Default for LockAnalyzer {
     fn default() -> Self {
         Self::new()
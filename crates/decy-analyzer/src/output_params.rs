@@ -20,7 +20,8 @@
 //! }
 //! ```
 
-use decy_hir::HirFunction;
+use decy_hir::visit::{walk_statements, Visitor};
+use decy_hir::{HirExpression, HirFunction, HirStatement};
 use std::collections::HashMap;
 
 /// Represents a detected output parameter.
@@ -74,50 +75,29 @@ impl OutputParamDetector {
     /// // let params = detector.detect(&func);
     /// ```
     pub fn detect(&self, func: &HirFunction) -> Vec<OutputParameter> {
-        let mut results = Vec::new();
-
-        // Track reads and writes for each parameter
-        let mut reads: HashMap<String, bool> = HashMap::new();
-        let mut writes: HashMap<String, bool> = HashMap::new();
-
-        // Initialize tracking for pointer parameters only
-        for param in func.parameters() {
-            if Self::is_pointer_type(param.param_type()) {
-                reads.insert(param.name().to_string(), false);
-                writes.insert(param.name().to_string(), false);
-            }
-        }
-
-        // Analyze function body
-        for stmt in func.body() {
-            Self::analyze_statement_internal(stmt, &mut reads, &mut writes);
-        }
-
-        // Detect fallible functions (multiple return values, typically 0 for success, non-zero for error)
-        let is_fallible = self.is_fallible_function(func);
-
-        // Classify parameters
-        for param in func.parameters() {
-            let param_name = param.name();
-
-            if !Self::is_pointer_type(param.param_type()) {
-                continue;
-            }
-
-            let was_read = reads.get(param_name).copied().unwrap_or(false);
-            let was_written = writes.get(param_name).copied().unwrap_or(false);
+        let mut usage = self.visitor(func);
+        walk_statements(&mut usage, func.body());
+        usage.into_results()
+    }
 
-            // Output parameter: written but not read (or written before read)
-            if was_written && !was_read {
-                results.push(OutputParameter {
-                    name: param_name.to_string(),
-                    kind: ParameterKind::Output,
-                    is_fallible,
-                });
-            }
+    /// Create the body visitor behind [`OutputParamDetector::detect`].
+    ///
+    /// Walk it over the body, possibly fused with other visitors, then call
+    /// [`OutputParamVisitor::into_results`].
+    pub fn visitor(&self, func: &HirFunction) -> OutputParamVisitor {
+        let params: Vec<String> = func
+            .parameters()
+            .iter()
+            .filter(|p| Self::is_pointer_type(p.param_type()))
+            .map(|p| p.name().to_string())
+            .collect();
+        OutputParamVisitor {
+            reads: params.iter().map(|name| (name.clone(), false)).collect(),
+            writes: params.iter().map(|name| (name.clone(), false)).collect(),
+            params,
+            // Detect fallible functions (multiple return values, typically 0 for success, non-zero for error)
+            is_fallible: self.is_fallible_function(func),
         }
-
-        results
     }
 
     /// Check if a type is a pointer type.
@@ -142,155 +122,64 @@ impl OutputParamDetector {
         // Common C pattern: int func(input, output*) where int is 0=success, -1=error
         matches!(func.return_type(), HirType::Int)
     }
+}
 
-    /// Analyze a statement to track parameter reads and writes.
-    fn analyze_statement_internal(
-        stmt: &decy_hir::HirStatement,
-        reads: &mut HashMap<String, bool>,
-        writes: &mut HashMap<String, bool>,
-    ) {
-        use decy_hir::{HirExpression, HirStatement};
-
-        match stmt {
-            // Track dereference assignments: *ptr = value
-            HirStatement::DerefAssignment { target, value } => {
-                // Check if target is a parameter (write)
-                if let HirExpression::Variable(var_name) = target {
-                    if writes.contains_key(var_name) {
-                        // Mark as written only if not already read
-                        if !reads.get(var_name).copied().unwrap_or(false) {
-                            writes.insert(var_name.clone(), true);
-                        }
-                    }
-                }
-
-                // Check value expression for reads
-                Self::analyze_expression_internal(value, reads);
-            }
-
-            // Variable declarations can read from parameters
-            HirStatement::VariableDeclaration { initializer: Some(expr), .. } => {
-                Self::analyze_expression_internal(expr, reads);
-            }
-
-            // Assignment can read from parameters
-            HirStatement::Assignment { value, .. } => {
-                Self::analyze_expression_internal(value, reads);
-            }
-
-            // Return statement can read from parameters
-            HirStatement::Return(Some(expr)) => {
-                Self::analyze_expression_internal(expr, reads);
-            }
-
-            // Control flow statements
-            HirStatement::If { condition, then_block, else_block } => {
-                Self::analyze_expression_internal(condition, reads);
-                for s in then_block {
-                    Self::analyze_statement_internal(s, reads, writes);
-                }
-                if let Some(else_stmts) = else_block {
-                    for s in else_stmts {
-                        Self::analyze_statement_internal(s, reads, writes);
-                    }
-                }
-            }
-
-            HirStatement::While { condition, body } => {
-                Self::analyze_expression_internal(condition, reads);
-                for s in body {
-                    Self::analyze_statement_internal(s, reads, writes);
-                }
-            }
+/// Tracks reads and writes through pointer parameters during one body walk.
+///
+/// A parameter counts as written only if the write happens before any read
+/// of it in traversal order.
+#[derive(Debug, Clone)]
+pub struct OutputParamVisitor {
+    /// Pointer parameter names in declaration order
+    params: Vec<String>,
+    reads: HashMap<String, bool>,
+    writes: HashMap<String, bool>,
+    is_fallible: bool,
+}
 
-            HirStatement::For { init, condition, increment, body } => {
-                // DECY-224: Handle multiple init statements
-                for init_stmt in init {
-                    Self::analyze_statement_internal(init_stmt, reads, writes);
-                }
-                if let Some(cond) = condition {
-                    Self::analyze_expression_internal(cond, reads);
-                }
-                // DECY-224: Handle multiple increment statements
-                for inc_stmt in increment {
-                    Self::analyze_statement_internal(inc_stmt, reads, writes);
-                }
-                for s in body {
-                    Self::analyze_statement_internal(s, reads, writes);
-                }
-            }
+impl OutputParamVisitor {
+    /// Classify the tracked parameters once the walk is complete.
+    pub fn into_results(self) -> Vec<OutputParameter> {
+        self.params
+            .iter()
+            .filter(|name| {
+                let was_read = self.reads.get(*name).copied().unwrap_or(false);
+                let was_written = self.writes.get(*name).copied().unwrap_or(false);
+                // Output parameter: written but not read (or written before read)
+                was_written && !was_read
+            })
+            .map(|name| OutputParameter {
+                name: name.clone(),
+                kind: ParameterKind::Output,
+                is_fallible: self.is_fallible,
+            })
+            .collect()
+    }
+}
 
-            HirStatement::Switch { condition, cases, default_case } => {
-                Self::analyze_expression_internal(condition, reads);
-                for case in cases {
-                    for s in &case.body {
-                        Self::analyze_statement_internal(s, reads, writes);
-                    }
+impl Visitor for OutputParamVisitor {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        // Track dereference assignments: *ptr = value
+        if let HirStatement::DerefAssignment { target: HirExpression::Variable(var_name), .. } =
+            stmt
+        {
+            // Mark as written only if not already read
+            if !self.reads.get(var_name).copied().unwrap_or(false) {
+                if let Some(written) = self.writes.get_mut(var_name) {
+                    *written = true;
                 }
-                if let Some(default_stmts) = default_case {
-                    for s in default_stmts {
-                        Self::analyze_statement_internal(s, reads, writes);
-                    }
-                }
-            }
-
-            HirStatement::Expression(expr) => {
-                Self::analyze_expression_internal(expr, reads);
             }
-
-            _ => {}
         }
     }
 
-    /// Analyze an expression to track parameter reads.
-    fn analyze_expression_internal(
-        expr: &decy_hir::HirExpression,
-        reads: &mut HashMap<String, bool>,
-    ) {
-        use decy_hir::HirExpression;
-
-        match expr {
-            // Dereferencing a parameter is a read
-            HirExpression::Dereference(inner) => {
-                if let HirExpression::Variable(var_name) = inner.as_ref() {
-                    if reads.contains_key(var_name) {
-                        reads.insert(var_name.clone(), true);
-                    }
-                }
-            }
-
-            // Binary operations
-            HirExpression::BinaryOp { left, right, .. } => {
-                Self::analyze_expression_internal(left, reads);
-                Self::analyze_expression_internal(right, reads);
-            }
-
-            // Unary operations
-            HirExpression::UnaryOp { operand, .. } => {
-                Self::analyze_expression_internal(operand, reads);
-            }
-
-            // Function calls
-            HirExpression::FunctionCall { arguments, .. } => {
-                for arg in arguments {
-                    Self::analyze_expression_internal(arg, reads);
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        // Dereferencing a parameter is a read
+        if let HirExpression::Dereference(inner) = expr {
+            if let HirExpression::Variable(var_name) = inner.as_ref() {
+                if let Some(read) = self.reads.get_mut(var_name) {
+                    *read = true;
                 }
             }
-
-            // Field access
-            HirExpression::FieldAccess { object, .. }
-            | HirExpression::PointerFieldAccess { pointer: object, .. } => {
-                Self::analyze_expression_internal(object, reads);
-            }
-
-            // Array indexing
-            HirExpression::ArrayIndex { array, index }
-            | HirExpression::SliceIndex { slice: array, index, .. } => {
-                Self::analyze_expression_internal(array, reads);
-                Self::analyze_expression_internal(index, reads);
-            }
-
-            _ => {}
         }
     }
 }
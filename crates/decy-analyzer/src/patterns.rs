@@ -2,6 +2,7 @@
 //!
 //! Analyzes HIR to find malloc/free patterns that can be replaced with safe Rust types.
 
+use decy_hir::visit::Visitor;
 use decy_hir::{HirExpression, HirFunction, HirStatement};
 
 /// Represents a detected `Box<T>` pattern candidate.
@@ -47,24 +48,26 @@ impl PatternDetector {
     /// free(ptr);
     /// ```
     pub fn find_box_candidates(&self, func: &HirFunction) -> Vec<BoxCandidate> {
-        let mut candidates = Vec::new();
-        let body = func.body();
-
-        // Track malloc calls assigned to variables
-        for (idx, stmt) in body.iter().enumerate() {
-            if let Some(var_name) = self.is_malloc_assignment(stmt) {
-                // Look for corresponding free
-                let free_idx = self.find_free_call(body, idx + 1, &var_name);
+        let mut visitor = self.visitor(true, false);
+        func.body().iter().for_each(|stmt| visitor.top_level_statement(stmt));
+        visitor.into_results().0
+    }
 
-                candidates.push(BoxCandidate {
-                    variable: var_name,
-                    malloc_index: idx,
-                    free_index: free_idx,
-                });
-            }
+    /// Create a visitor that finds `Box<T>` and/or `Vec<T>` candidates.
+    ///
+    /// Candidates are only taken from top-level statements, so the visitor
+    /// ignores nested blocks; it exists so the scan can ride along in a fused
+    /// walk. Call [`PatternVisitor::into_results`] afterwards.
+    pub fn visitor(&self, boxes: bool, vecs: bool) -> PatternVisitor {
+        PatternVisitor {
+            detector: self.clone(),
+            boxes,
+            vecs,
+            depth: 0,
+            index: 0,
+            box_candidates: Vec::new(),
+            vec_candidates: Vec::new(),
         }
-
-        candidates
     }
 
     /// Check if a statement is an assignment from malloc.
@@ -100,21 +103,6 @@ impl PatternDetector {
         )
     }
 
-    /// Find a free call for a specific variable after a given statement index.
-    fn find_free_call(
-        &self,
-        body: &[HirStatement],
-        start_idx: usize,
-        var_name: &str,
-    ) -> Option<usize> {
-        for (offset, stmt) in body[start_idx..].iter().enumerate() {
-            if self.is_free_call(stmt, var_name) {
-                return Some(start_idx + offset);
-            }
-        }
-        None
-    }
-
     /// Check if a statement is a free call for a specific variable.
     ///
     /// Free call detection requires ExpressionStatement support in HIR.
@@ -136,30 +124,9 @@ impl PatternDetector {
     /// free(arr);
     /// ```
     pub fn find_vec_candidates(&self, func: &HirFunction) -> Vec<VecCandidate> {
-        let mut candidates = Vec::new();
-        let body = func.body();
-
-        // Track malloc calls assigned to variables that use array allocation pattern
-        for (idx, stmt) in body.iter().enumerate() {
-            if let Some((var_name, malloc_expr)) = self.is_malloc_assignment_expr(stmt) {
-                // Check if this is an array allocation pattern (n * sizeof(T))
-                if self.is_array_size_expr(malloc_expr) {
-                    let capacity = self.extract_capacity(malloc_expr);
-
-                    // Look for corresponding free (same logic as Box)
-                    let free_idx = self.find_free_call(body, idx + 1, &var_name);
-
-                    candidates.push(VecCandidate {
-                        variable: var_name,
-                        malloc_index: idx,
-                        free_index: free_idx,
-                        capacity_expr: capacity,
-                    });
-                }
-            }
-        }
-
-        candidates
+        let mut visitor = self.visitor(false, true);
+        func.body().iter().for_each(|stmt| visitor.top_level_statement(stmt));
+        visitor.into_results().1
     }
 
     /// Check if a statement is an assignment from malloc, returning var name and malloc expr.
@@ -210,6 +177,83 @@ impl PatternDetector {
     }
 }
 
+/// Streaming `Box<T>`/`Vec<T>` candidate scan over a function's top-level statements.
+#[derive(Debug, Clone)]
+pub struct PatternVisitor {
+    detector: PatternDetector,
+    boxes: bool,
+    vecs: bool,
+    depth: usize,
+    /// Index of the next top-level statement
+    index: usize,
+    box_candidates: Vec<BoxCandidate>,
+    vec_candidates: Vec<VecCandidate>,
+}
+
+impl PatternVisitor {
+    /// Return the `Box<T>` and `Vec<T>` candidates found so far.
+    pub fn into_results(self) -> (Vec<BoxCandidate>, Vec<VecCandidate>) {
+        (self.box_candidates, self.vec_candidates)
+    }
+
+    /// Feed the next top-level statement of the body.
+    fn top_level_statement(&mut self, stmt: &HirStatement) {
+        let idx = self.index;
+        self.index += 1;
+        let detector = &self.detector;
+
+        // A free closes the first still-open candidate for its variable
+        for candidate in &mut self.box_candidates {
+            if candidate.free_index.is_none() && detector.is_free_call(stmt, &candidate.variable) {
+                candidate.free_index = Some(idx);
+            }
+        }
+        for candidate in &mut self.vec_candidates {
+            if candidate.free_index.is_none() && detector.is_free_call(stmt, &candidate.variable) {
+                candidate.free_index = Some(idx);
+            }
+        }
+
+        // Track malloc calls assigned to variables
+        if self.boxes {
+            if let Some(var_name) = detector.is_malloc_assignment(stmt) {
+                self.box_candidates.push(BoxCandidate {
+                    variable: var_name,
+                    malloc_index: idx,
+                    free_index: None,
+                });
+            }
+        }
+        // Track malloc calls assigned to variables that use array allocation pattern
+        if self.vecs {
+            if let Some((var_name, malloc_expr)) = detector.is_malloc_assignment_expr(stmt) {
+                // Check if this is an array allocation pattern (n * sizeof(T))
+                if detector.is_array_size_expr(malloc_expr) {
+                    self.vec_candidates.push(VecCandidate {
+                        variable: var_name,
+                        malloc_index: idx,
+                        free_index: None,
+                        capacity_expr: detector.extract_capacity(malloc_expr),
+                    });
+                }
+            }
+        }
+    }
+}
+
+impl Visitor for PatternVisitor {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        if self.depth == 0 {
+            self.top_level_statement(stmt);
+        }
+        self.depth += 1;
+    }
+
+    fn leave_statement(&mut self, _stmt: &HirStatement) {
+        self.depth -= 1;
+    }
+}
+
 impl Default for PatternDetector {
     fn default() -> Self {
         Self::new()
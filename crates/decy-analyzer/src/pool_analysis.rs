@@ -0,0 +1,594 @@
+//! Detection of hand-rolled pool allocators and free lists.
+//!
+//! Performance-minded C often replaces `malloc` with its own allocator:
+//!
+//! - a bump pool hands out consecutive slots of a static `T pool[N]`, or
+//!   consecutive bytes of a `char pool[N]`, by advancing a global cursor,
+//!   and releases everything at once by resetting it;
+//! - a free list threads released objects through one of their own pointer
+//!   fields; allocation pops its head, optionally falling back to a bump
+//!   pool when the list is empty.
+//!
+//! [`PoolAnalyzer`] recognises these from the globals holding the pool
+//! state and the functions touching them. A pool is only reported when that
+//! state is private to its allocator: every function mentioning the cursor,
+//! the free-list head or the backing array must be the allocation function,
+//! the release function or an init/reset function of the same pool, and
+//! none of them may be called through a pointer.
+
+use decy_hir::visit::{walk_statements, Visitor};
+use decy_hir::{HirExpression, HirFunction, HirStatement, HirType, UnaryOperator};
+use std::collections::{BTreeSet, HashMap};
+
+/// How a recognised pool hands out objects.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum PoolKind {
+    /// Consecutive slots from a cursor, released all at once by a reset
+    Bump,
+    /// Released objects are chained through a pointer field and reused first
+    FreeList,
+}
+
+/// A hand-rolled allocator whose state is private to its own functions.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct PoolAllocator {
+    /// Bump pool or free list
+    pub kind: PoolKind,
+    /// Structs the pool hands out; a byte pool may serve several
+    pub object_types: Vec<String>,
+    /// Function returning a fresh object
+    pub alloc: String,
+    /// Function returning one object to a free list
+    pub release: Option<String>,
+    /// Functions that only (re)initialise the pool state
+    pub reset: Vec<String>,
+    /// Globals holding the pool: backing storage, cursor, free-list head
+    pub state: Vec<String>,
+    /// Objects the backing array holds, for a typed `T pool[N]`
+    pub capacity: Option<usize>,
+}
+
+impl PoolAllocator {
+    /// Whether `name` is one of the pool's own functions.
+    pub fn owns_function(&self, name: &str) -> bool {
+        self.functions().any(|f| f == name)
+    }
+
+    fn functions(&self) -> impl Iterator<Item = &String> {
+        std::iter::once(&self.alloc).chain(self.release.as_ref()).chain(self.reset.iter())
+    }
+}
+
+/// A global that can hold pool state.
+#[derive(Debug, Clone, PartialEq, Eq)]
+enum StateGlobal {
+    /// `struct S *free_list`, initially NULL
+    Head(String),
+    /// `struct S pool[N]` (`Some(S)`) or `char pool[N]` (`None`)
+    Slots(Option<String>, usize),
+    /// Integer cursor, initially 0
+    Cursor,
+}
+
+fn is_null(expr: &HirExpression) -> bool {
+    match expr {
+        HirExpression::NullLiteral | HirExpression::IntLiteral(0) => true,
+        HirExpression::Cast { expr, .. } => is_null(expr),
+        _ => false,
+    }
+}
+
+fn struct_pointee(ty: &HirType) -> Option<&str> {
+    match ty {
+        HirType::Pointer(inner) => match inner.as_ref() {
+            HirType::Struct(name) => Some(name),
+            _ => None,
+        },
+        _ => None,
+    }
+}
+
+/// The struct named by `malloc(sizeof(struct S))` or `calloc(1, sizeof(struct S))`.
+fn allocated_type(expr: &HirExpression) -> Option<&str> {
+    match expr {
+        HirExpression::Cast { expr, .. } => allocated_type(expr),
+        HirExpression::FunctionCall { function, arguments } => {
+            match (function.as_str(), arguments.as_slice()) {
+                ("malloc", [HirExpression::Sizeof { type_name }])
+                | ("calloc", [HirExpression::IntLiteral(1), HirExpression::Sizeof { type_name }]) => {
+                    Some(struct_name(type_name))
+                }
+                _ => None,
+            }
+        }
+        _ => None,
+    }
+}
+
+fn struct_name(type_name: &str) -> &str {
+    let name = type_name.trim();
+    name.strip_prefix("struct ").unwrap_or(name)
+}
+
+fn state_global(var_type: &HirType, init: Option<&HirExpression>) -> Option<StateGlobal> {
+    let zeroed = init.into_iter().all(is_null);
+    match var_type {
+        ty if zeroed && struct_pointee(ty).is_some() => {
+            struct_pointee(ty).map(|s| StateGlobal::Head(s.to_string()))
+        }
+        HirType::Array { element_type, size: Some(n) } if init.is_none() => {
+            match element_type.as_ref() {
+                HirType::Struct(name) => Some(StateGlobal::Slots(Some(name.clone()), *n)),
+                HirType::Char | HirType::SignedChar => Some(StateGlobal::Slots(None, *n)),
+                _ => None,
+            }
+        }
+        HirType::Int | HirType::UnsignedInt | HirType::TypeAlias(_) if zeroed => {
+            Some(StateGlobal::Cursor)
+        }
+        _ => None,
+    }
+}
+
+/// What one function does to pool state, if it only does pool-like things.
+#[derive(Debug, Default)]
+struct PoolFacts {
+    /// State globals mentioned
+    touched: BTreeSet<String>,
+    /// `head = x->next`
+    pops: bool,
+    /// `p->next = head` followed by `head = p`, for a parameter `p`
+    links: bool,
+    pushes: bool,
+    /// Other writes of a free-list head, e.g. `head = NULL`
+    head_sets: bool,
+    /// `pool[i].next = ...`
+    chains: bool,
+    /// Structs of `malloc(sizeof(T))` fallbacks for an empty free list
+    heap: BTreeSet<String>,
+    loops: bool,
+    /// Returned values; `None` for a bare `return;`
+    returns: Vec<Option<HirExpression>>,
+}
+
+/// Walks a function body, accepting only the statement forms pool
+/// functions are written in.
+struct PoolScan<'a> {
+    globals: &'a HashMap<String, StateGlobal>,
+    /// Other globals; touching them makes the function not a pool function
+    others: &'a BTreeSet<String>,
+    params: Vec<String>,
+    locals: Vec<String>,
+    facts: PoolFacts,
+}
+
+impl<'a> PoolScan<'a> {
+    fn run(
+        func: &HirFunction,
+        globals: &'a HashMap<String, StateGlobal>,
+        others: &'a BTreeSet<String>,
+    ) -> Option<PoolFacts> {
+        let mut scan = Self {
+            globals,
+            others,
+            params: func.parameters().iter().map(|p| p.name().to_string()).collect(),
+            locals: Vec::new(),
+            facts: PoolFacts::default(),
+        };
+        scan.block(func.body()).then_some(scan.facts)
+    }
+
+    fn is_local(&self, name: &str) -> bool {
+        self.locals.iter().chain(&self.params).any(|l| l == name)
+    }
+
+    fn state(&self, name: &str) -> Option<&StateGlobal> {
+        if self.is_local(name) {
+            return None;
+        }
+        self.globals.get(name)
+    }
+
+    fn block(&mut self, stmts: &[HirStatement]) -> bool {
+        stmts.iter().all(|stmt| self.statement(stmt))
+    }
+
+    fn statement(&mut self, stmt: &HirStatement) -> bool {
+        match stmt {
+            HirStatement::VariableDeclaration { name, initializer, .. } => {
+                self.locals.push(name.clone());
+                initializer.iter().all(|e| self.allocation(e))
+            }
+            HirStatement::Assignment { target, value } => match self.state(target).cloned() {
+                None if self.is_local(target) => self.pure(value),
+                None => false,
+                Some(StateGlobal::Head(_)) => {
+                    self.facts.touched.insert(target.clone());
+                    match value {
+                        HirExpression::PointerFieldAccess { pointer, .. }
+                            if matches!(pointer.as_ref(), HirExpression::Variable(_)) =>
+                        {
+                            self.facts.pops = true;
+                            self.pure(pointer)
+                        }
+                        HirExpression::Variable(p) if self.params.contains(p) => {
+                            self.facts.pushes = self.facts.links;
+                            true
+                        }
+                        other => {
+                            self.facts.head_sets = true;
+                            self.pure(other)
+                        }
+                    }
+                }
+                Some(StateGlobal::Cursor) => {
+                    self.facts.touched.insert(target.clone());
+                    self.pure(value)
+                }
+                Some(StateGlobal::Slots(..)) => false,
+            },
+            HirStatement::FieldAssignment { object, value, .. } => match object {
+                HirExpression::Variable(p) if self.params.contains(p) => match value {
+                    HirExpression::Variable(head)
+                        if matches!(self.state(head), Some(StateGlobal::Head(_))) =>
+                    {
+                        self.facts.touched.insert(head.clone());
+                        self.facts.links = true;
+                        true
+                    }
+                    _ => false,
+                },
+                // Clearing the link of an object being handed out
+                HirExpression::Variable(local) if self.is_local(local) => is_null(value),
+                HirExpression::ArrayIndex { array, index } => match array.as_ref() {
+                    HirExpression::Variable(slots)
+                        if matches!(self.state(slots), Some(StateGlobal::Slots(Some(_), _))) =>
+                    {
+                        self.facts.touched.insert(slots.clone());
+                        self.facts.chains = true;
+                        self.pure(index) && self.pure(value)
+                    }
+                    _ => false,
+                },
+                _ => false,
+            },
+            HirStatement::If { condition, then_block, else_block } => {
+                self.pure(condition)
+                    && self.block(then_block)
+                    && else_block.iter().all(|b| self.block(b))
+            }
+            HirStatement::While { condition, body } => {
+                self.facts.loops = true;
+                self.pure(condition) && self.block(body)
+            }
+            HirStatement::For { init, condition, increment, body } => {
+                self.facts.loops = true;
+                self.block(init)
+                    && condition.iter().all(|c| self.pure(c))
+                    && self.block(increment)
+                    && self.block(body)
+            }
+            HirStatement::Return(value) => {
+                self.facts.returns.push(value.clone());
+                value.iter().all(|e| self.allocation(e))
+            }
+            HirStatement::Expression(
+                expr @ (HirExpression::PostIncrement { .. }
+                | HirExpression::PreIncrement { .. }
+                | HirExpression::PostDecrement { .. }
+                | HirExpression::PreDecrement { .. }),
+            ) => self.pure(expr),
+            _ => false,
+        }
+    }
+
+    /// A pure expression, or a heap allocation of one struct.
+    fn allocation(&mut self, expr: &HirExpression) -> bool {
+        match allocated_type(expr) {
+            Some(type_name) => {
+                self.facts.heap.insert(type_name.to_string());
+                true
+            }
+            None => self.pure(expr),
+        }
+    }
+
+    /// Expressions without calls or writes outside locals and the cursor.
+    fn pure(&mut self, expr: &HirExpression) -> bool {
+        match expr {
+            HirExpression::IntLiteral(_)
+            | HirExpression::FloatLiteral(_)
+            | HirExpression::CharLiteral(_)
+            | HirExpression::NullLiteral
+            | HirExpression::Sizeof { .. } => true,
+            HirExpression::Variable(name) => {
+                if self.is_local(name) {
+                    true
+                } else if self.globals.contains_key(name) {
+                    self.facts.touched.insert(name.clone());
+                    true
+                } else {
+                    // Enum constants are fine, other globals are not
+                    !self.others.contains(name)
+                }
+            }
+            HirExpression::BinaryOp { left, right, .. } => self.pure(left) && self.pure(right),
+            HirExpression::UnaryOp { op: UnaryOperator::AddressOf, operand }
+            | HirExpression::AddressOf(operand) => match operand.as_ref() {
+                HirExpression::ArrayIndex { array, index } => {
+                    matches!(array.as_ref(), HirExpression::Variable(v)
+                        if matches!(self.state(v), Some(StateGlobal::Slots(..))))
+                        && self.pure(array)
+                        && self.pure(index)
+                }
+                _ => false,
+            },
+            HirExpression::UnaryOp { operand, .. } => self.pure(operand),
+            HirExpression::Cast { expr, .. } => self.pure(expr),
+            HirExpression::Ternary { condition, then_expr, else_expr } => {
+                self.pure(condition) && self.pure(then_expr) && self.pure(else_expr)
+            }
+            HirExpression::PostIncrement { operand }
+            | HirExpression::PreIncrement { operand }
+            | HirExpression::PostDecrement { operand }
+            | HirExpression::PreDecrement { operand } => match operand.as_ref() {
+                HirExpression::Variable(name) => {
+                    let counter = self.is_local(name)
+                        || matches!(self.state(name), Some(StateGlobal::Cursor));
+                    counter && self.pure(operand)
+                }
+                _ => false,
+            },
+            // Reading the link of the object being popped
+            HirExpression::PointerFieldAccess { pointer, .. } => {
+                matches!(pointer.as_ref(), HirExpression::Variable(_)) && self.pure(pointer)
+            }
+            _ => false,
+        }
+    }
+}
+
+/// Every call of a function and every mention of it as a value.
+#[derive(Default)]
+struct CallSites<'a> {
+    names: &'a [&'a str],
+    calls: Vec<(String, Vec<HirExpression>)>,
+    mentions: BTreeSet<String>,
+}
+
+impl Visitor for CallSites<'_> {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        if let HirStatement::Assignment { target, .. } = stmt {
+            self.mentions.insert(target.clone());
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        match expr {
+            HirExpression::FunctionCall { function, arguments }
+                if self.names.contains(&function.as_str()) =>
+            {
+                self.calls.push((function.clone(), arguments.clone()));
+            }
+            HirExpression::Variable(name) => {
+                self.mentions.insert(name.clone());
+            }
+            _ => {}
+        }
+    }
+}
+
+/// Finds pool allocators and free lists in a translation unit.
+#[derive(Debug, Clone, Default)]
+pub struct PoolAnalyzer;
+
+impl PoolAnalyzer {
+    /// Create a new pool analyzer.
+    pub fn new() -> Self {
+        Self
+    }
+
+    /// Find the pool allocators of a unit from its globals and functions.
+    pub fn analyze(
+        &self,
+        globals: &[HirStatement],
+        functions: &[HirFunction],
+    ) -> Vec<PoolAllocator> {
+        let mut state = HashMap::new();
+        let mut others = BTreeSet::new();
+        for global in globals {
+            if let HirStatement::VariableDeclaration { name, var_type, initializer } = global {
+                match state_global(var_type, initializer.as_ref()) {
+                    Some(kind) => {
+                        state.insert(name.clone(), kind);
+                    }
+                    None => {
+                        others.insert(name.clone());
+                    }
+                }
+            }
+        }
+        if state.is_empty() {
+            return Vec::new();
+        }
+
+        let defined: Vec<&HirFunction> = functions.iter().filter(|f| f.has_body()).collect();
+        let facts: HashMap<&str, PoolFacts> = defined
+            .iter()
+            .filter_map(|f| Some((f.name(), PoolScan::run(f, &state, &others)?)))
+            .collect();
+
+        let mut pools: Vec<PoolAllocator> = Vec::new();
+        for func in &defined {
+            let Some(pool) = self.allocator(func, &facts, &state, &defined) else {
+                continue;
+            };
+            // A global initialised from pool state shares it
+            let mut initialisers = CallSites::default();
+            let inits: Vec<HirStatement> = globals
+                .iter()
+                .filter_map(|g| match g {
+                    HirStatement::VariableDeclaration { initializer: Some(e), .. } => {
+                        Some(HirStatement::Expression(e.clone()))
+                    }
+                    _ => None,
+                })
+                .collect();
+            walk_statements(&mut initialisers, &inits);
+            let shared = pools.iter().any(|p| p.state.iter().any(|s| pool.state.contains(s)));
+            if !shared && pool.state.iter().all(|s| !initialisers.mentions.contains(s)) {
+                pools.push(pool);
+            }
+        }
+        pools
+    }
+
+    /// The pool allocated from by `func`, if it is an allocation function.
+    fn allocator(
+        &self,
+        func: &HirFunction,
+        facts: &HashMap<&str, PoolFacts>,
+        state: &HashMap<String, StateGlobal>,
+        defined: &[&HirFunction],
+    ) -> Option<PoolAllocator> {
+        let alloc = facts.get(func.name())?;
+        let typed = struct_pointee(func.return_type());
+        let bytes = matches!(func.return_type(), HirType::Pointer(inner)
+            if matches!(inner.as_ref(), HirType::Void | HirType::Char));
+        let signature_ok = match (typed, bytes) {
+            (Some(_), _) => func.parameters().is_empty(),
+            (None, true) => {
+                matches!(func.parameters(), [size]
+                    if matches!(size.param_type(), HirType::Int | HirType::UnsignedInt | HirType::TypeAlias(_)))
+            }
+            _ => false,
+        };
+        if !signature_ok
+            || alloc.loops
+            || alloc.links
+            || alloc.head_sets
+            || alloc.chains
+            || alloc.returns.is_empty()
+            || alloc.returns.iter().any(Option::is_none)
+            || alloc.heap.iter().any(|t| typed != Some(t.as_str()))
+        {
+            return None;
+        }
+
+        let mut head = None;
+        let mut slots = None;
+        let mut cursor = false;
+        for name in &alloc.touched {
+            match &state[name] {
+                StateGlobal::Head(s) if head.replace(s.as_str()).is_none() => {}
+                StateGlobal::Slots(element, n)
+                    if slots.replace((element.as_deref(), *n)).is_none() => {}
+                StateGlobal::Cursor if !std::mem::replace(&mut cursor, true) => {}
+                _ => return None,
+            }
+        }
+        let kind = match (typed, head, slots) {
+            (Some(s), Some(h), slots) if h == s && alloc.pops => {
+                if slots.is_some_and(|(element, _)| element != Some(s)) || slots.is_some() != cursor
+                {
+                    return None;
+                }
+                PoolKind::FreeList
+            }
+            (Some(s), None, Some((Some(element), _)))
+                if element == s && cursor && alloc.heap.is_empty() =>
+            {
+                PoolKind::Bump
+            }
+            (None, None, Some((None, _))) if cursor && bytes => PoolKind::Bump,
+            _ => return None,
+        };
+
+        let mut pool = PoolAllocator {
+            kind,
+            object_types: typed.map(|s| vec![s.to_string()]).unwrap_or_default(),
+            alloc: func.name().to_string(),
+            release: None,
+            reset: Vec::new(),
+            state: alloc.touched.iter().cloned().collect(),
+            capacity: None,
+        };
+        // Init functions may also thread the backing array onto the free list
+        let slots_of_type = |name: &String| matches!(&state[name], StateGlobal::Slots(Some(element), _) if Some(element.as_str()) == typed);
+        for other in defined.iter().filter(|f| f.name() != func.name()) {
+            let Some(found) = facts.get(other.name()) else {
+                continue;
+            };
+            let is_release = found.links
+                && found.pushes
+                && !found.pops
+                && !found.chains
+                && found.heap.is_empty()
+                && matches!(other.return_type(), HirType::Void)
+                && matches!(other.parameters(), [p] if struct_pointee(p.param_type()) == head)
+                && found.touched.iter().all(|s| {
+                    alloc.touched.contains(s) && matches!(&state[s], StateGlobal::Head(_))
+                });
+            let is_reset = !found.pops
+                && !found.links
+                && !found.pushes
+                && found.heap.is_empty()
+                && matches!(other.return_type(), HirType::Void)
+                && other.parameters().is_empty()
+                && found.returns.iter().all(Option::is_none)
+                && !found.touched.is_empty()
+                && found.touched.iter().all(|s| alloc.touched.contains(s) || slots_of_type(s));
+            if is_release && pool.release.is_none() {
+                pool.release = Some(other.name().to_string());
+            } else if is_reset {
+                pool.reset.push(other.name().to_string());
+                for name in &found.touched {
+                    if !pool.state.contains(name) {
+                        pool.state.push(name.clone());
+                    }
+                }
+            }
+        }
+        pool.capacity = pool.state.iter().find_map(|name| match &state[name] {
+            StateGlobal::Slots(Some(element), n) if Some(element.as_str()) == typed => Some(*n),
+            _ => None,
+        });
+        // An empty free list must fall back to fresh objects: bump slots, the
+        // heap, or slots an init function threads onto the list
+        let chained = pool.reset.iter().any(|r| facts[r.as_str()].chains);
+        let refills = slots.is_some() || !alloc.heap.is_empty() || chained;
+        if kind == PoolKind::FreeList && (pool.release.is_none() || !refills) {
+            return None;
+        }
+
+        // The state stays private to the pool's functions, which are only
+        // ever called directly
+        let names: Vec<&str> = pool.functions().map(String::as_str).collect();
+        let mut sites = CallSites { names: &names, ..CallSites::default() };
+        for other in defined.iter().filter(|f| !pool.owns_function(f.name())) {
+            walk_statements(&mut sites, other.body());
+        }
+        if pool.state.iter().chain(pool.functions()).any(|n| sites.mentions.contains(n.as_str())) {
+            return None;
+        }
+
+        if typed.is_none() {
+            // A byte pool serves the structs its callers ask sizeof of
+            let mut types = BTreeSet::new();
+            for (function, arguments) in &sites.calls {
+                match arguments.as_slice() {
+                    [HirExpression::Sizeof { type_name }] if *function == pool.alloc => {
+                        types.insert(struct_name(type_name).to_string());
+                    }
+                    _ if *function == pool.alloc => return None,
+                    _ => {}
+                }
+            }
+            if types.is_empty() {
+                return None;
+            }
+            pool.object_types = types.into_iter().collect();
+        }
+        Some(pool)
+    }
+}
@@ -0,0 +1,121 @@
+//! Functions that can never reach stdin or stdout.
+//!
+//! With buffered stdout, codegen flushes the function's writer before a call
+//! that may print or read stdin, so output stays in order. Most calls in a
+//! hot loop are to helpers that do neither:
+//!
+//! ```c
+//! int square(int x) { return x * x; }
+//! for (i = 0; i < n; i++) printf("%d\n", square(i));
+//! ```
+//!
+//! [`StdioAnalyzer`] walks the unit's call graph and reports the functions
+//! whose every callee is quiet too, so those calls keep the buffer.
+
+use decy_hir::visit::{walk_statements, Visitor};
+use decy_hir::{HirExpression, HirFunction};
+use std::collections::{HashMap, HashSet};
+
+/// Library functions that neither print, read stdin, call back into the
+/// unit nor end the process.
+const QUIET_LIBRARY: &[&str] = &[
+    "abs", "labs", "atoi", "atol", "atof", "strtol", "strtoul", "strtod", "strlen", "strcmp",
+    "strncmp", "strcpy", "strncpy", "strcat", "strncat", "strchr", "strrchr", "strstr", "strdup",
+    "memcpy", "memmove", "memset", "memcmp", "memchr", "malloc", "calloc", "realloc", "free",
+    "sprintf", "snprintf", "sqrt", "pow", "exp", "log", "log10", "sin", "cos", "tan", "atan",
+    "atan2", "fabs", "floor", "ceil", "fmod", "round", "fmin", "fmax", "rand", "srand", "time",
+    "clock", "isdigit", "isalpha", "isalnum", "isspace", "isupper", "islower", "isxdigit",
+    "ispunct", "toupper", "tolower",
+];
+
+/// Functions of a unit that can never reach stdin or stdout.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct QuietFunctions {
+    /// Every function of the unit, which shadows a library one of that name
+    pub defined: HashSet<String>,
+    /// Functions of the unit whose every callee is quiet
+    pub functions: HashSet<String>,
+}
+
+impl QuietFunctions {
+    /// True when a call to `callee` can neither print nor read stdin.
+    pub fn is_quiet(&self, callee: &str) -> bool {
+        if self.defined.contains(callee) {
+            self.functions.contains(callee)
+        } else {
+            QUIET_LIBRARY.contains(&callee)
+        }
+    }
+}
+
+/// The names a body calls, and those it mentions as values: a function
+/// passed as a callback may be called by the callee.
+#[derive(Default)]
+struct Callees {
+    called: HashSet<String>,
+    values: HashSet<String>,
+}
+
+impl Visitor for Callees {
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        match expr {
+            HirExpression::FunctionCall { function, .. } => {
+                self.called.insert(function.clone());
+            }
+            HirExpression::Variable(name) => {
+                self.values.insert(name.clone());
+            }
+            _ => {}
+        }
+    }
+}
+
+/// Finds the functions of a unit that can never reach stdin or stdout.
+#[derive(Debug, Clone, Default)]
+pub struct StdioAnalyzer;
+
+impl StdioAnalyzer {
+    /// Create a new stdio analyzer.
+    pub fn new() -> Self {
+        Self
+    }
+
+    /// A function is quiet when it has a body and everything it calls, or
+    /// passes on as a callback, is a quiet library function or another quiet
+    /// function of the unit. Calls through pointers and to functions only
+    /// declared are not quiet, and neither is anything that calls `exit`,
+    /// which skips the caller's flush.
+    pub fn analyze(&self, functions: &[HirFunction]) -> QuietFunctions {
+        let mut bodies: HashMap<&str, Callees> = HashMap::new();
+        for func in functions.iter().filter(|f| f.has_body()) {
+            walk_statements(bodies.entry(func.name()).or_default(), func.body());
+        }
+
+        // Greatest fixpoint, so mutually recursive quiet functions stay quiet
+        let mut quiet = QuietFunctions {
+            defined: functions.iter().map(|f| f.name().to_string()).collect(),
+            functions: bodies.keys().map(|f| f.to_string()).collect(),
+        };
+        loop {
+            let loud: Vec<String> = quiet
+                .functions
+                .iter()
+                .filter(|f| {
+                    let uses = &bodies[f.as_str()];
+                    uses.called.iter().any(|c| !quiet.is_quiet(c))
+                        || uses
+                            .values
+                            .iter()
+                            .any(|v| quiet.defined.contains(v) && !quiet.is_quiet(v))
+                })
+                .cloned()
+                .collect();
+            if loud.is_empty() {
+                return quiet;
+            }
+            for f in loud {
+                quiet.functions.remove(&f);
+            }
+        }
+    }
+}
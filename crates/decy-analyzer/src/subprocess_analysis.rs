@@ -3,6 +3,7 @@
 //! Detects C subprocess patterns like fork()+exec*() and transforms them
 //! to Rust's `std::process::Command` API.
 
+use decy_hir::visit::{walk_statements, Visitor};
 use decy_hir::{HirExpression, HirFunction, HirStatement};
 
 /// Detected fork/exec subprocess pattern.
@@ -43,47 +44,16 @@ impl SubprocessDetector {
 
     /// Detect fork/exec patterns in a function.
     pub fn detect(&self, func: &HirFunction) -> Vec<ForkExecPattern> {
-        let mut patterns = Vec::new();
-        let mut current = ForkExecPattern::default();
-
-        self.analyze_statements(func.body(), &mut current);
-
-        if current.has_fork || current.has_exec || current.has_wait {
-            patterns.push(current);
-        }
-
-        patterns
-    }
-
-    fn analyze_statements(&self, stmts: &[HirStatement], pattern: &mut ForkExecPattern) {
-        for stmt in stmts {
-            self.analyze_statement(stmt, pattern);
-        }
+        let mut visitor = self.visitor();
+        walk_statements(&mut visitor, func.body());
+        visitor.into_results()
     }
 
-    fn analyze_statement(&self, stmt: &HirStatement, pattern: &mut ForkExecPattern) {
-        match stmt {
-            HirStatement::VariableDeclaration { name, initializer: Some(init), .. } => {
-                if self.is_fork_call(init) {
-                    pattern.has_fork = true;
-                    pattern.pid_var = Some(name.clone());
-                }
-                self.analyze_expression(init, pattern);
-            }
-            HirStatement::Expression(expr) => {
-                self.analyze_expression(expr, pattern);
-            }
-            HirStatement::If { then_block, else_block, .. } => {
-                self.analyze_statements(then_block, pattern);
-                if let Some(else_stmts) = else_block {
-                    self.analyze_statements(else_stmts, pattern);
-                }
-            }
-            HirStatement::While { body, .. } | HirStatement::For { body, .. } => {
-                self.analyze_statements(body, pattern);
-            }
-            _ => {}
-        }
+    /// Create a visitor that collects the fork/exec pattern of one function.
+    ///
+    /// Call [`SubprocessVisitor::into_results`] after walking the function body.
+    pub fn visitor(&self) -> SubprocessVisitor<'_> {
+        SubprocessVisitor { detector: self, pattern: ForkExecPattern::default() }
     }
 
     fn analyze_expression(&self, expr: &HirExpression, pattern: &mut ForkExecPattern) {
@@ -119,6 +89,38 @@ impl SubprocessDetector {
     }
 }
 
+/// Streaming fork/exec detection over every statement and expression.
+pub struct SubprocessVisitor<'a> {
+    detector: &'a SubprocessDetector,
+    pattern: ForkExecPattern,
+}
+
+impl SubprocessVisitor<'_> {
+    /// Return the detected pattern, if any subprocess call was seen.
+    pub fn into_results(self) -> Vec<ForkExecPattern> {
+        let pattern = self.pattern;
+        if pattern.has_fork || pattern.has_exec || pattern.has_wait {
+            vec![pattern]
+        } else {
+            Vec::new()
+        }
+    }
+}
+
+impl Visitor for SubprocessVisitor<'_> {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        if let HirStatement::VariableDeclaration { name, initializer: Some(init), .. } = stmt {
+            if self.detector.is_fork_call(init) {
+                self.pattern.pid_var = Some(name.clone());
+            }
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        self.detector.analyze_expression(expr, &mut self.pattern);
+    }
+}
+
 impl Default for SubprocessDetector {
     fn default() -> Self {
         Self::new()
@@ -0,0 +1,221 @@
+//! Single-pass analyzer suite.
+//!
+//! Runs every enabled function-level detector in one fused HIR walk per
+//! function instead of one walk per detector, and spreads functions across a
+//! pool of worker threads. The combined per-function result is plain owned
+//! data, so callers can cache it keyed by whatever identifies the function.
+
+use crate::lock_analysis::{LockAnalyzer, LockDataMapping, LockRegion};
+use crate::output_params::{OutputParamDetector, OutputParameter};
+use crate::patterns::{BoxCandidate, PatternDetector, VecCandidate};
+use crate::subprocess_analysis::{ForkExecPattern, SubprocessDetector};
+use crate::tagged_union_analysis::{TaggedUnionAnalyzer, TaggedUnionInfo};
+use crate::void_ptr_analysis::{VoidPtrAnalyzer, VoidPtrInfo};
+use decy_hir::visit::walk_statements;
+use decy_hir::{HirFunction, HirStruct};
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+/// Which detectors an [`AnalyzerSuite`] runs.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct EnabledDetectors {
+    /// malloc/free → `Box<T>` candidates
+    pub boxes: bool,
+    /// Array allocation → `Vec<T>` candidates
+    pub vecs: bool,
+    /// pthread lock regions and the data they protect
+    pub locks: bool,
+    /// Pointer parameters used as output values
+    pub output_params: bool,
+    /// `void*` parameter type constraints
+    pub void_ptrs: bool,
+    /// fork/exec/wait subprocess patterns
+    pub subprocess: bool,
+    /// Tagged unions among struct definitions
+    pub tagged_unions: bool,
+}
+
+impl EnabledDetectors {
+    /// Every detector switched on.
+    pub fn all() -> Self {
+        Self {
+            boxes: true,
+            vecs: true,
+            locks: true,
+            output_params: true,
+            void_ptrs: true,
+            subprocess: true,
+            tagged_unions: true,
+        }
+    }
+
+    /// Every detector switched off.
+    pub fn none() -> Self {
+        Self {
+            boxes: false,
+            vecs: false,
+            locks: false,
+            output_params: false,
+            void_ptrs: false,
+            subprocess: false,
+            tagged_unions: false,
+        }
+    }
+}
+
+impl Default for EnabledDetectors {
+    fn default() -> Self {
+        Self::all()
+    }
+}
+
+/// Combined detector results for one function.
+///
+/// Fields of disabled detectors are left empty.
+#[derive(Debug, Clone, Default)]
+pub struct FunctionAnalysis {
+    /// Function name
+    pub name: String,
+    /// `Box<T>` candidates
+    pub box_candidates: Vec<BoxCandidate>,
+    /// `Vec<T>` candidates
+    pub vec_candidates: Vec<VecCandidate>,
+    /// Matched lock/unlock regions
+    pub lock_regions: Vec<LockRegion>,
+    /// Data accessed under each lock
+    pub lock_data: LockDataMapping,
+    /// Output parameters
+    pub output_params: Vec<OutputParameter>,
+    /// `void*` parameter analysis
+    pub void_ptrs: Vec<VoidPtrInfo>,
+    /// fork/exec subprocess patterns
+    pub subprocess: Vec<ForkExecPattern>,
+}
+
+/// Results of running an [`AnalyzerSuite`] over a translation unit.
+#[derive(Debug, Clone, Default)]
+pub struct SuiteResults {
+    /// Per-function results, in input order
+    pub functions: Vec<FunctionAnalysis>,
+    /// Tagged unions found among the structs
+    pub tagged_unions: Vec<TaggedUnionInfo>,
+}
+
+impl SuiteResults {
+    /// Look up the results for a function by name.
+    pub fn function(&self, name: &str) -> Option<&FunctionAnalysis> {
+        self.functions.iter().find(|f| f.name == name)
+    }
+}
+
+/// Runs all enabled detectors in a single pass per function.
+#[derive(Debug, Clone)]
+pub struct AnalyzerSuite {
+    detectors: EnabledDetectors,
+    threads: usize,
+}
+
+impl AnalyzerSuite {
+    /// Create a suite with every detector enabled, using one worker per
+    /// available CPU.
+    pub fn new() -> Self {
+        let threads = std::thread::available_parallelism().map_or(1, |n| n.get());
+        Self { detectors: EnabledDetectors::all(), threads }
+    }
+
+    /// Choose which detectors run.
+    pub fn with_detectors(mut self, detectors: EnabledDetectors) -> Self {
+        self.detectors = detectors;
+        self
+    }
+
+    /// Set the number of worker threads (at least one).
+    pub fn with_threads(mut self, threads: usize) -> Self {
+        self.threads = threads.max(1);
+        self
+    }
+
+    /// Run the enabled detectors over one function in a single walk.
+    pub fn analyze_function(&self, func: &HirFunction) -> FunctionAnalysis {
+        let d = self.detectors;
+        let (pattern_detector, lock_analyzer) = (PatternDetector::new(), LockAnalyzer::new());
+        let (output_detector, void_analyzer) = (OutputParamDetector::new(), VoidPtrAnalyzer::new());
+        let subprocess_detector = SubprocessDetector::new();
+
+        let mut pass = (
+            (d.boxes || d.vecs).then(|| pattern_detector.visitor(d.boxes, d.vecs)),
+            d.locks.then(|| lock_analyzer.visitor(true)),
+            d.output_params.then(|| output_detector.visitor(func)),
+            d.void_ptrs.then(|| void_analyzer.visitor(func)),
+            d.subprocess.then(|| subprocess_detector.visitor()),
+        );
+        walk_statements(&mut pass, func.body());
+        let (patterns, locks, outputs, void_ptrs, subprocess) = pass;
+
+        let mut analysis = FunctionAnalysis { name: func.name().to_string(), ..Default::default() };
+        if let Some(v) = patterns {
+            (analysis.box_candidates, analysis.vec_candidates) = v.into_results();
+        }
+        if let Some(v) = locks {
+            (analysis.lock_regions, analysis.lock_data) = v.into_results();
+        }
+        if let Some(v) = outputs {
+            analysis.output_params = v.into_results();
+        }
+        if let Some(v) = void_ptrs {
+            analysis.void_ptrs = v.into_results();
+        }
+        if let Some(v) = subprocess {
+            analysis.subprocess = v.into_results();
+        }
+        analysis
+    }
+
+    /// Analyze every function (in parallel) and every struct.
+    ///
+    /// Workers pull the next unclaimed function from a shared counter, so
+    /// one large function does not hold up a whole chunk of small ones.
+    pub fn analyze(&self, functions: &[HirFunction], structs: &[HirStruct]) -> SuiteResults {
+        let tagged_unions = if self.detectors.tagged_unions {
+            let analyzer = TaggedUnionAnalyzer::new();
+            structs.iter().filter_map(|s| analyzer.analyze_struct(s)).collect()
+        } else {
+            Vec::new()
+        };
+
+        let workers = self.threads.min(functions.len());
+        if workers < 2 {
+            let functions = functions.iter().map(|f| self.analyze_function(f)).collect();
+            return SuiteResults { functions, tagged_unions };
+        }
+
+        let next = AtomicUsize::new(0);
+        let mut indexed: Vec<(usize, FunctionAnalysis)> = std::thread::scope(|scope| {
+            let handles: Vec<_> = (0..workers)
+                .map(|_| {
+                    scope.spawn(|| {
+                        let mut done = Vec::new();
+                        loop {
+                            let idx = next.fetch_add(1, Ordering::Relaxed);
+                            let Some(func) = functions.get(idx) else { break };
+                            done.push((idx, self.analyze_function(func)));
+                        }
+                        done
+                    })
+                })
+                .collect();
+            handles
+                .into_iter()
+                .flat_map(|handle| handle.join().expect("analyzer worker panicked"))
+                .collect()
+        });
+        indexed.sort_unstable_by_key(|(idx, _)| *idx);
+
+        SuiteResults { functions: indexed.into_iter().map(|(_, a)| a).collect(), tagged_unions }
+    }
+}
+
+impl Default for AnalyzerSuite {
+    fn default() -> Self {
+        Self::new()
+    }
+}
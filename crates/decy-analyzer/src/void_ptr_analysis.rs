@@ -3,7 +3,10 @@
 //! Analyzes void* usage patterns to infer generic type parameters
 //! for transformation to Rust generics.
 
-use decy_hir::{HirExpression, HirFunction, HirStatement, HirType};
+use decy_hir::visit::{walk_statements, Visitor};
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirStatement, HirType, UnaryOperator};
+use std::borrow::Borrow;
+use std::collections::HashMap;
 
 /// Pattern type detected for void* usage.
 #[derive(Debug, Clone, PartialEq, Eq)]
@@ -59,35 +62,40 @@ impl VoidPtrAnalyzer {
 
     /// Analyze a function for void* usage patterns.
     pub fn analyze(&self, func: &HirFunction) -> Vec<VoidPtrInfo> {
-        let mut results = Vec::new();
+        let mut usage = self.visitor(func);
+        if !usage.infos.is_empty() {
+            walk_statements(&mut usage, func.body());
+        }
+        usage.into_results()
+    }
 
+    /// Create the body visitor behind [`VoidPtrAnalyzer::analyze`].
+    ///
+    /// Every void* parameter is tracked in the same walk. Run it over the
+    /// body, possibly fused with other visitors, then call
+    /// [`VoidPtrVisitor::into_results`].
+    pub fn visitor(&self, func: &HirFunction) -> VoidPtrVisitor {
         // Find void* parameters
         let void_ptr_params: Vec<_> =
             func.parameters().iter().filter(|p| self.is_void_ptr(p.param_type())).collect();
 
         if void_ptr_params.is_empty() {
-            return results;
+            return VoidPtrVisitor { infos: Vec::new() };
         }
 
         // Detect pattern based on function signature
         let pattern = self.detect_pattern(func, &void_ptr_params);
 
-        // Analyze each void* parameter
-        for param in void_ptr_params {
-            let mut info = VoidPtrInfo {
+        let infos = void_ptr_params
+            .iter()
+            .map(|param| VoidPtrInfo {
                 param_name: param.name().to_string(),
                 pattern: pattern.clone(),
                 inferred_types: Vec::new(),
                 constraints: Vec::new(),
-            };
-
-            // Analyze body for type casts and usage
-            self.analyze_body(func.body(), param.name(), &mut info);
-
-            results.push(info);
-        }
-
-        results
+            })
+            .collect();
+        VoidPtrVisitor { infos }
     }
 
     fn is_void_ptr(&self, ty: &HirType) -> bool {
@@ -129,115 +137,668 @@ impl VoidPtrAnalyzer {
 
         VoidPtrPattern::Generic
     }
+}
 
-    fn analyze_body(&self, stmts: &[HirStatement], param_name: &str, info: &mut VoidPtrInfo) {
-        for stmt in stmts {
-            self.analyze_statement(stmt, param_name, info);
-        }
+/// Collects casts and usage constraints for every void* parameter in one walk.
+#[derive(Debug, Clone)]
+pub struct VoidPtrVisitor {
+    infos: Vec<VoidPtrInfo>,
+}
+
+impl VoidPtrVisitor {
+    /// Return the per-parameter results once the walk is complete.
+    pub fn into_results(self) -> Vec<VoidPtrInfo> {
+        self.infos
     }
+}
 
-    fn analyze_statement(&self, stmt: &HirStatement, param_name: &str, info: &mut VoidPtrInfo) {
-        match stmt {
-            HirStatement::VariableDeclaration { initializer: Some(init), .. } => {
-                self.analyze_expression(init, param_name, info);
+impl Visitor for VoidPtrVisitor {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        let HirStatement::DerefAssignment { target, value } = stmt else {
+            return;
+        };
+        for info in &mut self.infos {
+            // Write through void* - implies mutable constraint
+            if expr_uses_param(target, &info.param_name) {
+                add_constraint(info, TypeConstraint::Mutable);
             }
-            HirStatement::DerefAssignment { target, value } => {
-                // Write through void* - implies mutable constraint
-                if self.expr_uses_param(target, param_name)
-                    && !info.constraints.contains(&TypeConstraint::Mutable)
-                {
-                    info.constraints.push(TypeConstraint::Mutable);
-                }
-                // DECY-097: If value is a dereference of a void* param, need Clone
-                if matches!(value, HirExpression::Dereference(_))
-                    && !info.constraints.contains(&TypeConstraint::Clone)
-                {
-                    info.constraints.push(TypeConstraint::Clone);
+            // DECY-097: If value is a dereference of a void* param, need Clone
+            if matches!(value, HirExpression::Dereference(_)) {
+                add_constraint(info, TypeConstraint::Clone);
+            }
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        match expr {
+            HirExpression::Cast { expr: inner, target_type: HirType::Pointer(inner_type) } => {
+                // Found a cast - extract the type
+                for info in &mut self.infos {
+                    if expr_uses_param(inner, &info.param_name)
+                        && !info.inferred_types.contains(inner_type)
+                    {
+                        info.inferred_types.push((**inner_type).clone());
+                    }
                 }
-                self.analyze_expression(target, param_name, info);
-                self.analyze_expression(value, param_name, info);
-            }
-            HirStatement::If { condition, then_block, else_block, .. } => {
-                self.analyze_expression(condition, param_name, info);
-                self.analyze_body(then_block, param_name, info);
-                if let Some(else_stmts) = else_block {
-                    self.analyze_body(else_stmts, param_name, info);
+            }
+            HirExpression::BinaryOp { op, left, right } => {
+                // DECY-097: Detect comparison/equality operations for trait bounds
+                use decy_hir::BinaryOperator;
+                let constraint = match op {
+                    BinaryOperator::LessThan
+                    | BinaryOperator::GreaterThan
+                    | BinaryOperator::LessEqual
+                    | BinaryOperator::GreaterEqual => TypeConstraint::PartialOrd,
+                    BinaryOperator::Equal | BinaryOperator::NotEqual => TypeConstraint::PartialEq,
+                    _ => return,
+                };
+                for info in &mut self.infos {
+                    if expr_uses_param(left, &info.param_name)
+                        || expr_uses_param(right, &info.param_name)
+                    {
+                        add_constraint(info, constraint.clone());
+                    }
                 }
             }
-            HirStatement::While { condition, body, .. } => {
-                self.analyze_expression(condition, param_name, info);
-                self.analyze_body(body, param_name, info);
+            _ => {}
+        }
+    }
+}
+
+fn add_constraint(info: &mut VoidPtrInfo, constraint: TypeConstraint) {
+    if !info.constraints.contains(&constraint) {
+        info.constraints.push(constraint);
+    }
+}
+
+fn expr_uses_param(expr: &HirExpression, param_name: &str) -> bool {
+    match expr {
+        HirExpression::Variable(name) => name == param_name,
+        HirExpression::Cast { expr: inner, .. } => expr_uses_param(inner, param_name),
+        HirExpression::Dereference(inner) => expr_uses_param(inner, param_name),
+        _ => false,
+    }
+}
+
+/// A `void*` parameter every use of which agrees on one pointee type.
+///
+/// Found by [`VoidPtrAnalyzer::instantiate`] across a whole unit: the
+/// parameter can be retyped to a pointer to `pointee`, the casts of it
+/// dropped, and its callbacks called without type erasure.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct VoidPtrInstantiation {
+    /// Function declaring the parameter
+    pub function: String,
+    /// Position of the parameter
+    pub param: usize,
+    /// For a function-pointer parameter, the position of the `void*`
+    /// argument of the callback; `None` for a plain `void*` parameter
+    pub callback_arg: Option<usize>,
+    /// The type every use points to
+    pub pointee: HirType,
+}
+
+/// A `void*` position whose pointee type is being inferred.
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
+struct Slot {
+    function: String,
+    param: usize,
+    callback_arg: Option<usize>,
+}
+
+impl Slot {
+    fn new(function: &str, param: usize, callback_arg: Option<usize>) -> Self {
+        Self { function: function.to_string(), param, callback_arg }
+    }
+}
+
+/// Union-find over slots that must share one pointee type.
+#[derive(Default)]
+struct Unifier {
+    slots: Vec<Slot>,
+    index: HashMap<Slot, usize>,
+    parent: Vec<usize>,
+    types: Vec<Vec<HirType>>,
+    /// Some use the retyping cannot follow
+    poisoned: Vec<bool>,
+    /// Reached from a call site or callback argument, not only from casts
+    witnessed: Vec<bool>,
+}
+
+impl Unifier {
+    fn insert(&mut self, slot: Slot) {
+        let id = self.slots.len();
+        self.index.insert(slot.clone(), id);
+        self.slots.push(slot);
+        self.parent.push(id);
+        self.types.push(Vec::new());
+        self.poisoned.push(false);
+        self.witnessed.push(false);
+    }
+
+    fn find(&mut self, mut id: usize) -> usize {
+        while self.parent[id] != id {
+            self.parent[id] = self.parent[self.parent[id]];
+            id = self.parent[id];
+        }
+        id
+    }
+
+    fn root(&mut self, slot: &Slot) -> Option<usize> {
+        let id = *self.index.get(slot)?;
+        Some(self.find(id))
+    }
+
+    fn union(&mut self, a: &Slot, b: &Slot) {
+        let (Some(a), Some(b)) = (self.root(a), self.root(b)) else {
+            return;
+        };
+        if a == b {
+            self.witnessed[a] = true;
+            return;
+        }
+        self.parent[b] = a;
+        let types = std::mem::take(&mut self.types[b]);
+        for ty in types {
+            if !self.types[a].contains(&ty) {
+                self.types[a].push(ty);
             }
-            HirStatement::For { body, .. } => {
-                self.analyze_body(body, param_name, info);
+        }
+        self.poisoned[a] |= self.poisoned[b];
+        self.witnessed[a] = true;
+    }
+
+    fn add_type(&mut self, slot: &Slot, ty: HirType, witnessed: bool) {
+        if let Some(root) = self.root(slot) {
+            if !self.types[root].contains(&ty) {
+                self.types[root].push(ty);
             }
-            HirStatement::Expression(expr) => {
-                self.analyze_expression(expr, param_name, info);
+            self.witnessed[root] |= witnessed;
+        }
+    }
+
+    fn poison(&mut self, slot: &Slot) {
+        if let Some(root) = self.root(slot) {
+            self.poisoned[root] = true;
+        }
+    }
+}
+
+fn is_void_ptr(ty: &HirType) -> bool {
+    matches!(ty, HirType::Pointer(inner) if matches!(inner.as_ref(), HirType::Void))
+}
+
+/// Positions of the `void*` arguments of a callback type.
+fn callback_void_args(ty: &HirType) -> Vec<usize> {
+    match ty {
+        HirType::FunctionPointer { param_types, .. } => {
+            param_types.iter().enumerate().filter(|(_, t)| is_void_ptr(t)).map(|(j, _)| j).collect()
+        }
+        _ => Vec::new(),
+    }
+}
+
+/// Every local declared in a body, with its C type.
+#[derive(Default)]
+struct Locals(HashMap<String, HirType>);
+
+impl Visitor for Locals {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        if let HirStatement::VariableDeclaration { name, var_type, .. } = stmt {
+            self.0.insert(name.clone(), var_type.clone());
+        }
+    }
+}
+
+/// Every variable named in an expression.
+#[derive(Default)]
+struct Names(Vec<String>);
+
+impl Visitor for Names {
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        if let HirExpression::Variable(name) = expr {
+            self.0.push(name.clone());
+        }
+    }
+}
+
+/// Feeds the uses of `void*` parameters in one function body to the unifier.
+struct InstanceScan<'a> {
+    unifier: &'a mut Unifier,
+    /// Parameter types of every function defined in the unit
+    signatures: &'a HashMap<String, Vec<HirType>>,
+    function: &'a str,
+    /// Parameters and locals of the function, with their C types
+    locals: HashMap<String, HirType>,
+    /// Positions of the function's own parameters, by name
+    params: HashMap<String, usize>,
+}
+
+impl InstanceScan<'_> {
+    /// The slot of a `void*` parameter of the function being scanned.
+    fn param_slot(&self, name: &str) -> Option<Slot> {
+        let &index = self.params.get(name)?;
+        let ty = &self.signatures[self.function][index];
+        is_void_ptr(ty).then(|| Slot::new(self.function, index, None))
+    }
+
+    /// A callback parameter of the function being scanned and its `void*` arguments.
+    fn callback_param(&self, name: &str) -> Option<(usize, Vec<usize>)> {
+        let &index = self.params.get(name)?;
+        let args = callback_void_args(&self.signatures[self.function][index]);
+        (!args.is_empty()).then_some((index, args))
+    }
+
+    /// A function of the unit named as a value rather than shadowed by a local.
+    fn function_value(&self, name: &str) -> Option<&Vec<HirType>> {
+        if self.locals.contains_key(name) {
+            return None;
+        }
+        self.signatures.get(name)
+    }
+
+    /// A name used where the retyping cannot follow it.
+    fn escapes(&mut self, name: &str) {
+        if let Some(slot) = self.param_slot(name) {
+            self.unifier.poison(&slot);
+        }
+        if let Some((index, args)) = self.callback_param(name) {
+            for j in args {
+                self.unifier.poison(&Slot::new(self.function, index, Some(j)));
             }
-            HirStatement::Return(Some(expr)) => {
-                self.analyze_expression(expr, param_name, info);
+        }
+        if let Some(params) = self.function_value(name).cloned() {
+            for (k, ty) in params.iter().enumerate() {
+                if is_void_ptr(ty) {
+                    self.unifier.poison(&Slot::new(name, k, None));
+                }
+                for j in callback_void_args(ty) {
+                    self.unifier.poison(&Slot::new(name, k, Some(j)));
+                }
             }
-            _ => {}
         }
     }
 
-    fn analyze_expression(&self, expr: &HirExpression, param_name: &str, info: &mut VoidPtrInfo) {
+    /// The pointee of a pointer-valued expression, with arrays decaying.
+    fn pointee(&self, expr: &HirExpression) -> Option<HirType> {
         match expr {
-            HirExpression::Cast { expr: inner, target_type } => {
-                // Found a cast - extract the type
-                if self.expr_uses_param(inner, param_name) {
-                    if let HirType::Pointer(inner_type) = target_type {
-                        if !info.inferred_types.contains(inner_type) {
-                            info.inferred_types.push((**inner_type).clone());
-                        }
-                    }
+            HirExpression::Variable(name) => match self.locals.get(name)? {
+                HirType::Pointer(inner) | HirType::Array { element_type: inner, .. } => {
+                    Some((**inner).clone())
                 }
+                _ => None,
+            },
+            HirExpression::Cast { target_type: HirType::Pointer(inner), .. } => {
+                Some((**inner).clone())
             }
-            HirExpression::BinaryOp { op, left, right } => {
-                // DECY-097: Detect comparison/equality operations for trait bounds
-                let uses_param = self.expr_uses_param(left, param_name)
-                    || self.expr_uses_param(right, param_name);
-                if uses_param {
-                    use decy_hir::BinaryOperator;
-                    match op {
-                        BinaryOperator::LessThan
-                        | BinaryOperator::GreaterThan
-                        | BinaryOperator::LessEqual
-                        | BinaryOperator::GreaterEqual => {
-                            if !info.constraints.contains(&TypeConstraint::PartialOrd) {
-                                info.constraints.push(TypeConstraint::PartialOrd);
-                            }
+            HirExpression::AddressOf(place)
+            | HirExpression::UnaryOp { op: UnaryOperator::AddressOf, operand: place } => {
+                self.place_type(place)
+            }
+            HirExpression::StringLiteral(_) => Some(HirType::Char),
+            _ => None,
+        }
+    }
+
+    fn place_type(&self, place: &HirExpression) -> Option<HirType> {
+        match place {
+            HirExpression::Variable(name) => self.locals.get(name).cloned(),
+            HirExpression::ArrayIndex { array, .. } => self.pointee(array),
+            HirExpression::Dereference(inner) => self.pointee(inner),
+            _ => None,
+        }
+    }
+
+    /// An argument passed where `slot` expects a `void*`.
+    fn argument(&mut self, slot: &Slot, arg: &HirExpression) {
+        let arg = match arg {
+            HirExpression::Cast { target_type, expr } if is_void_ptr(target_type) => expr,
+            other => other,
+        };
+        if let HirExpression::Variable(name) = arg {
+            if let Some(own) = self.param_slot(name) {
+                self.unifier.union(slot, &own);
+                return;
+            }
+        }
+        match self.pointee(arg) {
+            Some(HirType::Void) | None => self.unifier.poison(slot),
+            Some(ty) => self.unifier.add_type(slot, ty, true),
+        }
+        self.expression(arg);
+    }
+
+    /// A function passed where parameter `param` of `callee` expects a callback.
+    fn callback_argument(&mut self, callee: &str, param: usize, arg: &HirExpression) {
+        let slots: Vec<Slot> = callback_void_args(&self.signatures[callee][param])
+            .into_iter()
+            .map(|j| Slot::new(callee, param, Some(j)))
+            .collect();
+        let arity = match &self.signatures[callee][param] {
+            HirType::FunctionPointer { param_types, .. } => param_types.len(),
+            _ => 0,
+        };
+        let HirExpression::Variable(name) = arg else {
+            slots.iter().for_each(|slot| self.unifier.poison(slot));
+            self.expression(arg);
+            return;
+        };
+        if let Some((index, _)) = self.callback_param(name) {
+            // Forwarding a callback of our own
+            for slot in &slots {
+                let own = Slot::new(self.function, index, slot.callback_arg);
+                self.unifier.union(slot, &own);
+            }
+            return;
+        }
+        match self.function_value(name).cloned() {
+            Some(params) if params.len() == arity => {
+                for slot in &slots {
+                    let j = slot.callback_arg.unwrap_or_default();
+                    match &params[j] {
+                        ty if is_void_ptr(ty) => {
+                            self.unifier.union(slot, &Slot::new(name, j, None));
                         }
-                        BinaryOperator::Equal | BinaryOperator::NotEqual => {
-                            if !info.constraints.contains(&TypeConstraint::PartialEq) {
-                                info.constraints.push(TypeConstraint::PartialEq);
-                            }
+                        HirType::Pointer(inner) => {
+                            self.unifier.add_type(slot, (**inner).clone(), true);
                         }
-                        _ => {}
+                        _ => self.unifier.poison(slot),
                     }
                 }
-                self.analyze_expression(left, param_name, info);
-                self.analyze_expression(right, param_name, info);
             }
-            HirExpression::Dereference(inner) => {
-                self.analyze_expression(inner, param_name, info);
+            _ => {
+                slots.iter().for_each(|slot| self.unifier.poison(slot));
+                self.escapes(name);
             }
-            HirExpression::FunctionCall { arguments, .. } => {
-                for arg in arguments {
-                    self.analyze_expression(arg, param_name, info);
+        }
+    }
+
+    fn call(&mut self, function: &str, arguments: &[HirExpression]) {
+        if let Some((index, args)) = self.callback_param(function) {
+            for (j, arg) in arguments.iter().enumerate() {
+                match args.contains(&j) {
+                    true => self.argument(&Slot::new(self.function, index, Some(j)), arg),
+                    false => self.expression(arg),
                 }
             }
-            _ => {}
+            return;
+        }
+        let Some(params) = self.function_value(function).cloned() else {
+            if !self.library_sort(function, arguments) {
+                arguments.iter().for_each(|arg| self.expression(arg));
+            }
+            return;
+        };
+        for (k, arg) in arguments.iter().enumerate() {
+            match params.get(k) {
+                Some(ty) if is_void_ptr(ty) => self.argument(&Slot::new(function, k, None), arg),
+                Some(ty) if !callback_void_args(ty).is_empty() => {
+                    self.callback_argument(function, k, arg)
+                }
+                _ => self.expression(arg),
+            }
+        }
+    }
+
+    /// `qsort(base, n, size, cmp)` or `bsearch(key, base, n, size, cmp)`
+    /// from the C library, passing a comparator of the unit.
+    ///
+    /// The comparator is called with pointers into `base`, and `bsearch`
+    /// passes the key first, so its `void*` parameters point to those.
+    fn library_sort(&mut self, function: &str, arguments: &[HirExpression]) -> bool {
+        let (operands, rest, comparator) = match (function, arguments) {
+            ("qsort", [base, n, size, cmp]) => ([base, base], vec![n, size], cmp),
+            ("bsearch", [key, base, n, size, cmp]) => ([key, base], vec![n, size], cmp),
+            _ => return false,
+        };
+        let HirExpression::Variable(name) = comparator else {
+            return false;
+        };
+        match self.function_value(name) {
+            Some(params) if params.len() == 2 && params.iter().all(is_void_ptr) => {}
+            _ => return false,
+        }
+        for (k, operand) in operands.into_iter().enumerate() {
+            self.argument(&Slot::new(name, k, None), operand);
         }
+        rest.into_iter().for_each(|arg| self.expression(arg));
+        true
     }
 
-    fn expr_uses_param(&self, expr: &HirExpression, param_name: &str) -> bool {
+    /// A condition, where a bare `void*` is a NULL test.
+    fn condition(&mut self, expr: &HirExpression) {
         match expr {
-            HirExpression::Variable(name) => name == param_name,
-            HirExpression::Cast { expr: inner, .. } => self.expr_uses_param(inner, param_name),
-            HirExpression::Dereference(inner) => self.expr_uses_param(inner, param_name),
-            _ => false,
+            HirExpression::Variable(name) if self.param_slot(name).is_some() => {}
+            HirExpression::UnaryOp { op: UnaryOperator::LogicalNot, operand }
+                if matches!(operand.as_ref(), HirExpression::Variable(name)
+                    if self.param_slot(name).is_some()) => {}
+            HirExpression::BinaryOp {
+                op: BinaryOperator::LogicalAnd | BinaryOperator::LogicalOr,
+                left,
+                right,
+            } => {
+                self.condition(left);
+                self.condition(right);
+            }
+            other => self.expression(other),
+        }
+    }
+
+    fn expression(&mut self, expr: &HirExpression) {
+        match expr {
+            HirExpression::Variable(name) => self.escapes(name),
+            HirExpression::Cast { target_type: HirType::Pointer(inner), expr: operand }
+                if !matches!(inner.as_ref(), HirType::Void)
+                    && matches!(operand.as_ref(), HirExpression::Variable(name)
+                        if self.param_slot(name).is_some()) =>
+            {
+                if let HirExpression::Variable(name) = operand.as_ref() {
+                    let slot = self.param_slot(name).unwrap_or_else(|| Slot::new("", 0, None));
+                    self.unifier.add_type(&slot, (**inner).clone(), false);
+                }
+            }
+            HirExpression::BinaryOp {
+                op: BinaryOperator::Equal | BinaryOperator::NotEqual,
+                left,
+                right,
+            } if matches!(
+                right.as_ref(),
+                HirExpression::NullLiteral | HirExpression::IntLiteral(0)
+            ) && matches!(left.as_ref(), HirExpression::Variable(name)
+                        if self.param_slot(name).is_some()) => {}
+            HirExpression::FunctionCall { function, arguments } => self.call(function, arguments),
+            HirExpression::BinaryOp { left, right, .. } => {
+                self.expression(left);
+                self.expression(right);
+            }
+            HirExpression::ArrayIndex { array: left, index: right } => {
+                self.expression(left);
+                self.expression(right);
+            }
+            HirExpression::Ternary { condition, then_expr, else_expr } => {
+                self.condition(condition);
+                self.expression(then_expr);
+                self.expression(else_expr);
+            }
+            HirExpression::UnaryOp { operand: inner, .. }
+            | HirExpression::Dereference(inner)
+            | HirExpression::AddressOf(inner)
+            | HirExpression::Cast { expr: inner, .. }
+            | HirExpression::FieldAccess { object: inner, .. }
+            | HirExpression::PointerFieldAccess { pointer: inner, .. }
+            | HirExpression::PostIncrement { operand: inner }
+            | HirExpression::PreIncrement { operand: inner }
+            | HirExpression::PostDecrement { operand: inner }
+            | HirExpression::PreDecrement { operand: inner } => self.expression(inner),
+            other => {
+                // Anything else: every name in it escapes
+                let mut names = Names::default();
+                decy_hir::visit::walk_expression(&mut names, other);
+                names.0.iter().for_each(|name| self.escapes(name));
+            }
+        }
+    }
+
+    fn block(&mut self, stmts: &[HirStatement]) {
+        stmts.iter().for_each(|stmt| self.statement(stmt));
+    }
+
+    fn statement(&mut self, stmt: &HirStatement) {
+        match stmt {
+            // T *x = p, C's implicit conversion of a void* parameter
+            HirStatement::VariableDeclaration {
+                var_type: HirType::Pointer(inner),
+                initializer: Some(HirExpression::Variable(name)),
+                ..
+            } if !matches!(inner.as_ref(), HirType::Void) && self.param_slot(name).is_some() => {
+                let slot = self.param_slot(name).unwrap_or_else(|| Slot::new("", 0, None));
+                self.unifier.add_type(&slot, (**inner).clone(), false);
+            }
+            HirStatement::VariableDeclaration { initializer, .. } => {
+                initializer.iter().for_each(|e| self.expression(e));
+            }
+            HirStatement::Assignment { target, value } => {
+                self.escapes(target);
+                self.expression(value);
+            }
+            HirStatement::If { condition, then_block, else_block } => {
+                self.condition(condition);
+                self.block(then_block);
+                else_block.iter().for_each(|b| self.block(b));
+            }
+            HirStatement::While { condition, body } => {
+                self.condition(condition);
+                self.block(body);
+            }
+            HirStatement::For { init, condition, increment, body } => {
+                self.block(init);
+                condition.iter().for_each(|c| self.condition(c));
+                self.block(increment);
+                self.block(body);
+            }
+            HirStatement::Switch { condition, cases, default_case } => {
+                self.expression(condition);
+                for case in cases {
+                    self.block(&case.body);
+                }
+                default_case.iter().for_each(|b| self.block(b));
+            }
+            HirStatement::Return(value) => value.iter().for_each(|e| self.expression(e)),
+            HirStatement::DerefAssignment { target, value } => {
+                self.expression(target);
+                self.expression(value);
+            }
+            HirStatement::ArrayIndexAssignment { array, index, value } => {
+                self.expression(array);
+                self.expression(index);
+                self.expression(value);
+            }
+            HirStatement::FieldAssignment { object, value, .. } => {
+                self.expression(object);
+                self.expression(value);
+            }
+            HirStatement::Free { pointer } => self.expression(pointer),
+            HirStatement::Expression(expr) => self.expression(expr),
+            HirStatement::Break | HirStatement::Continue | HirStatement::InlineAsm { .. } => {}
+        }
+    }
+}
+
+impl VoidPtrAnalyzer {
+    /// Find the `void*` parameters of a unit that can take a concrete type.
+    ///
+    /// A parameter qualifies when the casts of it in its function, the
+    /// arguments at every call site and, for callbacks, the parameters of
+    /// every function passed in all agree on one pointee type, and it is
+    /// never used any other way: stored, returned, compared other than with
+    /// NULL, or handed to a function outside the unit. Functions passed as
+    /// callbacks must only ever be called, passed to such parameters or
+    /// passed as the comparator of `qsort`/`bsearch`.
+    pub fn instantiate(&self, functions: &[HirFunction]) -> Vec<VoidPtrInstantiation> {
+        let mut scan = VoidPtrScan::new(functions);
+        functions.iter().for_each(|f| scan.observe(f));
+        scan.finish()
+    }
+}
+
+/// Incremental form of [`VoidPtrAnalyzer::instantiate`] for callers that
+/// lower and drop one function at a time.
+///
+/// A body may call any function of the unit, so the scan starts from every
+/// signature; bodies then feed the unifier one by one and are not kept.
+pub struct VoidPtrScan {
+    /// Parameter types of every function defined in the unit
+    signatures: HashMap<String, Vec<HirType>>,
+    unifier: Unifier,
+}
+
+impl VoidPtrScan {
+    /// Start a scan from the functions of a unit; only their signatures are kept.
+    pub fn new<F: Borrow<HirFunction>>(functions: impl IntoIterator<Item = F>) -> Self {
+        let mut signatures = HashMap::new();
+        let mut unifier = Unifier::default();
+        for func in functions {
+            let func = func.borrow();
+            if !func.has_body() {
+                continue;
+            }
+            for (k, param) in func.parameters().iter().enumerate() {
+                if is_void_ptr(param.param_type()) {
+                    unifier.insert(Slot::new(func.name(), k, None));
+                }
+                for j in callback_void_args(param.param_type()) {
+                    unifier.insert(Slot::new(func.name(), k, Some(j)));
+                }
+            }
+            let params = func.parameters().iter().map(|p| p.param_type().clone()).collect();
+            signatures.insert(func.name().to_string(), params);
+        }
+        Self { signatures, unifier }
+    }
+
+    /// Feed the uses of `void*` parameters in one function body to the unifier.
+    pub fn observe(&mut self, func: &HirFunction) {
+        if !func.has_body() || self.unifier.slots.is_empty() {
+            return;
+        }
+        let mut locals = Locals::default();
+        walk_statements(&mut locals, func.body());
+        let mut locals = locals.0;
+        let mut params = HashMap::new();
+        for (k, param) in func.parameters().iter().enumerate() {
+            locals.insert(param.name().to_string(), param.param_type().clone());
+            params.insert(param.name().to_string(), k);
+        }
+        let mut scan = InstanceScan {
+            unifier: &mut self.unifier,
+            signatures: &self.signatures,
+            function: func.name(),
+            locals,
+            params,
+        };
+        scan.block(func.body());
+    }
+
+    /// The parameters whose uses all agree on one pointee type.
+    pub fn finish(mut self) -> Vec<VoidPtrInstantiation> {
+        let unifier = &mut self.unifier;
+        let mut instances = Vec::new();
+        for id in 0..unifier.slots.len() {
+            let root = unifier.find(id);
+            if unifier.poisoned[root] || !unifier.witnessed[root] {
+                continue;
+            }
+            if let [pointee] = unifier.types[root].as_slice() {
+                let slot = &unifier.slots[id];
+                instances.push(VoidPtrInstantiation {
+                    function: slot.function.clone(),
+                    param: slot.param,
+                    callback_arg: slot.callback_arg,
+                    pointee: pointee.clone(),
+                });
+            }
         }
+        instances
     }
 }
 
@@ -0,0 +1,172 @@
+//! Tests for recognising `qsort`/`bsearch` comparators that order by one key.
+
+use decy_analyzer::comparator_analysis::{ComparatorAnalyzer, KeyComparator, SortKey};
+use decy_hir::{
+    BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirStruct,
+    HirStructField, HirType,
+};
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn ptr(ty: HirType) -> HirType {
+    HirType::Pointer(Box::new(ty))
+}
+
+fn bin(op: BinaryOperator, left: HirExpression, right: HirExpression) -> HirExpression {
+    HirExpression::BinaryOp { op, left: Box::new(left), right: Box::new(right) }
+}
+
+/// *(T *)p
+fn read(ty: HirType, param: &str) -> HirExpression {
+    HirExpression::Dereference(Box::new(HirExpression::Cast {
+        target_type: ptr(ty),
+        expr: Box::new(var(param)),
+    }))
+}
+
+fn arrow(pointer: &str, field: &str) -> HirExpression {
+    HirExpression::PointerFieldAccess { pointer: Box::new(var(pointer)), field: field.to_string() }
+}
+
+fn decl(name: &str, ty: HirType, init: HirExpression) -> HirStatement {
+    HirStatement::VariableDeclaration {
+        name: name.to_string(),
+        var_type: ty,
+        initializer: Some(init),
+    }
+}
+
+/// (x > y) - (x < y)
+fn three_way(x: HirExpression, y: HirExpression) -> HirExpression {
+    bin(
+        BinaryOperator::Subtract,
+        bin(BinaryOperator::GreaterThan, x.clone(), y.clone()),
+        bin(BinaryOperator::LessThan, x, y),
+    )
+}
+
+/// int name(const void *a, const void *b) { body }
+fn comparator(body: Vec<HirStatement>) -> HirFunction {
+    HirFunction::new_with_body(
+        "cmp".to_string(),
+        HirType::Int,
+        vec![
+            HirParameter::new("a".to_string(), ptr(HirType::Void)),
+            HirParameter::new("b".to_string(), ptr(HirType::Void)),
+        ],
+        body,
+    )
+}
+
+/// struct rec { int id; double weight; };
+fn rec() -> HirStruct {
+    HirStruct::new(
+        "rec".to_string(),
+        vec![
+            HirStructField::new("id".to_string(), HirType::Int),
+            HirStructField::new("weight".to_string(), HirType::Double),
+        ],
+    )
+}
+
+/// const struct rec *x = a; const struct rec *y = b; return result;
+fn by_field(result: HirExpression) -> HirFunction {
+    let rec_ptr = || ptr(HirType::Struct("rec".to_string()));
+    comparator(vec![
+        decl("x", rec_ptr(), var("a")),
+        decl("y", rec_ptr(), var("b")),
+        HirStatement::Return(Some(result)),
+    ])
+}
+
+fn recognize(func: &HirFunction) -> Option<KeyComparator> {
+    ComparatorAnalyzer::new().recognize(&[rec()], func)
+}
+
+#[test]
+fn test_difference_of_elements_is_ascending() {
+    // return *(int *)a - *(int *)b;
+    let func = comparator(vec![HirStatement::Return(Some(bin(
+        BinaryOperator::Subtract,
+        read(HirType::Int, "a"),
+        read(HirType::Int, "b"),
+    )))]);
+
+    assert_eq!(recognize(&func), Some(KeyComparator { key: SortKey::Element, descending: false }));
+}
+
+#[test]
+fn test_swapped_comparison_through_locals_is_descending() {
+    // int x = *(int *)a; int y = *(int *)b; return (y > x) - (y < x);
+    let func = comparator(vec![
+        decl("x", HirType::Int, read(HirType::Int, "a")),
+        decl("y", HirType::Int, read(HirType::Int, "b")),
+        HirStatement::Return(Some(three_way(var("y"), var("x")))),
+    ]);
+
+    assert_eq!(recognize(&func), Some(KeyComparator { key: SortKey::Element, descending: true }));
+}
+
+#[test]
+fn test_struct_field_comparison() {
+    let func = by_field(three_way(arrow("x", "id"), arrow("y", "id")));
+
+    assert_eq!(
+        recognize(&func),
+        Some(KeyComparator { key: SortKey::Field("id".to_string()), descending: false })
+    );
+}
+
+#[test]
+fn test_non_integer_keys_are_not_recognised() {
+    // A double key has no total order
+    let func = by_field(three_way(arrow("x", "weight"), arrow("y", "weight")));
+    assert_eq!(recognize(&func), None);
+
+    // The difference of unsigned keys wraps
+    let func = comparator(vec![HirStatement::Return(Some(bin(
+        BinaryOperator::Subtract,
+        read(HirType::UnsignedInt, "a"),
+        read(HirType::UnsignedInt, "b"),
+    )))]);
+    assert_eq!(recognize(&func), None);
+}
+
+#[test]
+fn test_other_comparators_are_not_recognised() {
+    // Different keys of each element
+    let func = by_field(three_way(arrow("x", "id"), arrow("y", "weight")));
+    assert_eq!(recognize(&func), None);
+
+    // Both sides read the same argument
+    let func = comparator(vec![HirStatement::Return(Some(bin(
+        BinaryOperator::Subtract,
+        read(HirType::Int, "a"),
+        read(HirType::Int, "a"),
+    )))]);
+    assert_eq!(recognize(&func), None);
+
+    // A call before the return
+    let mut body = vec![HirStatement::Expression(HirExpression::FunctionCall {
+        function: "log_compare".to_string(),
+        arguments: vec![],
+    })];
+    body.extend(by_field(three_way(arrow("x", "id"), arrow("y", "id"))).body().to_vec());
+    assert_eq!(recognize(&comparator(body)), None);
+}
+
+#[test]
+fn test_analyze_reports_comparators_by_name() {
+    let func = by_field(three_way(arrow("y", "id"), arrow("x", "id")));
+    let found = ComparatorAnalyzer::new().analyze(&[rec()], &[func]);
+
+    assert_eq!(
+        found,
+        vec![(
+            "cmp".to_string(),
+            KeyComparator { key: SortKey::Field("id".to_string()), descending: true }
+        )]
+    );
+}
@@ -0,0 +1,256 @@
+//! Tests for finding the targets of calls through function pointers.
+
+use decy_analyzer::dispatch_analysis::{
+    DispatchAnalyzer, DispatchScan, PointerTargets, StaticDispatch,
+};
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirExpression {
+    HirExpression::FunctionCall { function: function.to_string(), arguments }
+}
+
+fn stmt(function: &str, arguments: Vec<HirExpression>) -> HirStatement {
+    HirStatement::Expression(call(function, arguments))
+}
+
+/// int (*)(int)
+fn unary() -> HirType {
+    HirType::FunctionPointer {
+        param_types: vec![HirType::Int],
+        return_type: Box::new(HirType::Int),
+    }
+}
+
+/// int name(int x) { return x; }
+fn leaf(name: &str) -> HirFunction {
+    HirFunction::new_with_body(
+        name.to_string(),
+        HirType::Int,
+        vec![HirParameter::new("x".to_string(), HirType::Int)],
+        vec![HirStatement::Return(Some(var("x")))],
+    )
+}
+
+/// int apply(int (*op)(int), int x) { body }
+fn apply(op_type: HirType, body: Vec<HirStatement>) -> HirFunction {
+    HirFunction::new_with_body(
+        "apply".to_string(),
+        HirType::Int,
+        vec![
+            HirParameter::new("op".to_string(), op_type),
+            HirParameter::new("x".to_string(), HirType::Int),
+        ],
+        body,
+    )
+}
+
+/// return op(x);
+fn call_op() -> Vec<HirStatement> {
+    vec![HirStatement::Return(Some(call("op", vec![var("x")])))]
+}
+
+/// void main(void) { body }
+fn main_with(body: Vec<HirStatement>) -> HirFunction {
+    HirFunction::new_with_body("main".to_string(), HirType::Void, vec![], body)
+}
+
+fn analyze(functions: &[HirFunction]) -> StaticDispatch {
+    DispatchAnalyzer::new().analyze(&[], functions)
+}
+
+fn op_param() -> Vec<(usize, String)> {
+    vec![(0, "op".to_string())]
+}
+
+#[test]
+fn test_param_only_called_with_functions_is_dispatched() {
+    let functions = vec![
+        leaf("inc"),
+        leaf("dec"),
+        apply(unary(), call_op()),
+        main_with(vec![
+            stmt("apply", vec![var("inc"), HirExpression::IntLiteral(1)]),
+            stmt("apply", vec![var("dec"), HirExpression::IntLiteral(2)]),
+        ]),
+    ];
+
+    assert_eq!(analyze(&functions).params_of("apply"), op_param().as_slice());
+}
+
+#[test]
+fn test_scan_sees_functions_observed_after_their_callers() {
+    let functions = vec![
+        main_with(vec![stmt("apply", vec![var("inc"), HirExpression::IntLiteral(1)])]),
+        apply(unary(), call_op()),
+        leaf("inc"),
+    ];
+
+    let mut scan = DispatchScan::new(&[]);
+    functions.iter().for_each(|f| scan.observe(f));
+    let dispatch = scan.finish();
+
+    assert_eq!(dispatch.params_of("apply"), op_param().as_slice());
+    assert_eq!(dispatch, analyze(&functions));
+}
+
+#[test]
+fn test_param_forwarded_to_dispatched_param() {
+    // int twice(int (*op)(int), int x) { return apply(op, apply(op, x)); }
+    let twice = HirFunction::new_with_body(
+        "twice".to_string(),
+        HirType::Int,
+        vec![
+            HirParameter::new("op".to_string(), unary()),
+            HirParameter::new("x".to_string(), HirType::Int),
+        ],
+        vec![HirStatement::Return(Some(call(
+            "apply",
+            vec![var("op"), call("apply", vec![var("op"), var("x")])],
+        )))],
+    );
+    let functions = vec![
+        leaf("inc"),
+        apply(unary(), call_op()),
+        twice,
+        main_with(vec![stmt("twice", vec![var("inc"), HirExpression::IntLiteral(1)])]),
+    ];
+    let dispatch = analyze(&functions);
+
+    assert_eq!(dispatch.params_of("apply"), op_param().as_slice());
+    assert_eq!(dispatch.params_of("twice"), op_param().as_slice());
+}
+
+#[test]
+fn test_param_used_as_value_is_not_dispatched() {
+    // int (*saved)(int) = op; return saved(x);
+    let body = vec![
+        HirStatement::VariableDeclaration {
+            name: "saved".to_string(),
+            var_type: unary(),
+            initializer: Some(var("op")),
+        },
+        HirStatement::Return(Some(call("saved", vec![var("x")]))),
+    ];
+    let functions = vec![
+        leaf("inc"),
+        apply(unary(), body),
+        main_with(vec![stmt("apply", vec![var("inc"), HirExpression::IntLiteral(1)])]),
+    ];
+
+    assert!(analyze(&functions).is_empty());
+}
+
+#[test]
+fn test_callers_must_pass_functions() {
+    // apply(0, 1): a null pointer has no Fn to call
+    let functions = vec![
+        apply(unary(), call_op()),
+        main_with(vec![stmt(
+            "apply",
+            vec![HirExpression::NullLiteral, HirExpression::IntLiteral(1)],
+        )]),
+    ];
+    assert!(analyze(&functions).params.is_empty());
+
+    // A function whose own address is taken keeps its fn-pointer parameter
+    let functions = vec![
+        leaf("inc"),
+        apply(unary(), call_op()),
+        main_with(vec![
+            stmt("apply", vec![var("inc"), HirExpression::IntLiteral(1)]),
+            stmt("register", vec![var("apply")]),
+        ]),
+    ];
+    assert!(analyze(&functions).params.is_empty());
+}
+
+#[test]
+fn test_pointer_arguments_are_not_dispatched() {
+    // int (*op)(int *): the function passed may take a reference instead
+    let int_ptr = HirType::Pointer(Box::new(HirType::Int));
+    let op_type = HirType::FunctionPointer {
+        param_types: vec![int_ptr.clone()],
+        return_type: Box::new(HirType::Int),
+    };
+    let peek = HirFunction::new_with_body(
+        "peek".to_string(),
+        HirType::Int,
+        vec![HirParameter::new("p".to_string(), int_ptr)],
+        vec![HirStatement::Return(Some(HirExpression::Dereference(Box::new(var("p")))))],
+    );
+    let functions = vec![
+        peek,
+        apply(op_type, vec![HirStatement::Return(Some(HirExpression::IntLiteral(0)))]),
+        main_with(vec![stmt("apply", vec![var("peek"), HirExpression::IntLiteral(1)])]),
+    ];
+
+    assert!(analyze(&functions).params.is_empty());
+}
+
+/// int (*step)(int) = init; body; step(1);
+fn with_step(init: Option<HirExpression>, body: Vec<HirStatement>) -> Vec<HirFunction> {
+    let mut stmts = vec![HirStatement::VariableDeclaration {
+        name: "step".to_string(),
+        var_type: unary(),
+        initializer: init,
+    }];
+    stmts.extend(body);
+    stmts.push(stmt("step", vec![HirExpression::IntLiteral(1)]));
+    vec![leaf("inc"), leaf("dec"), main_with(stmts)]
+}
+
+fn assign_step(value: HirExpression) -> HirStatement {
+    HirStatement::Assignment { target: "step".to_string(), value }
+}
+
+#[test]
+fn test_local_targets_in_assignment_order() {
+    // step = flag > 0 ? dec : inc; ... step = inc;
+    let choice = HirExpression::Ternary {
+        condition: Box::new(HirExpression::BinaryOp {
+            op: BinaryOperator::GreaterThan,
+            left: Box::new(var("flag")),
+            right: Box::new(HirExpression::IntLiteral(0)),
+        }),
+        then_expr: Box::new(var("dec")),
+        else_expr: Box::new(var("inc")),
+    };
+    let functions = with_step(None, vec![assign_step(choice), assign_step(var("inc"))]);
+
+    assert_eq!(
+        analyze(&functions).locals_of("main"),
+        [PointerTargets {
+            name: "step".to_string(),
+            targets: vec!["dec".to_string(), "inc".to_string()],
+        }]
+    );
+}
+
+#[test]
+fn test_local_with_unknown_value_is_not_dispatched() {
+    // step = lookup(1);
+    let functions = with_step(
+        Some(var("inc")),
+        vec![assign_step(call("lookup", vec![HirExpression::IntLiteral(1)]))],
+    );
+    assert!(analyze(&functions).locals.is_empty());
+
+    // apply(step, 1) needs it as a value
+    let functions = with_step(
+        Some(var("inc")),
+        vec![stmt("apply", vec![var("step"), HirExpression::IntLiteral(1)])],
+    );
+    assert!(analyze(&functions).locals.is_empty());
+
+    // A choice whose condition has an effect
+    let choice = HirExpression::Ternary {
+        condition: Box::new(call("next", vec![])),
+        then_expr: Box::new(var("dec")),
+        else_expr: Box::new(var("inc")),
+    };
+    assert!(analyze(&with_step(Some(choice), vec![])).locals.is_empty());
+}
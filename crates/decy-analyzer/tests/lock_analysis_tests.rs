@@ -936,3 +936,34 @@ fn test_end_to_end_lock_data_mapping() {
     assert!(lock2_data.contains(&"data2".to_string()));
     assert!(lock2_data.contains(&"data3".to_string()));
 }
+
+#[test]
+fn test_data_accessed_in_loops_and_switches_is_protected() {
+    let func = HirFunction::new_with_body(
+        "test".to_string(),
+        HirType::Void,
+        vec![],
+        vec![
+            lock_call("lock"),
+            HirStatement::For {
+                init: vec![],
+                condition: Some(HirExpression::Variable("limit".to_string())),
+                increment: vec![],
+                body: vec![HirStatement::Switch {
+                    condition: HirExpression::Variable("state".to_string()),
+                    cases: vec![],
+                    default_case: Some(vec![HirStatement::Free {
+                        pointer: HirExpression::Variable("buffer".to_string()),
+                    }]),
+                }],
+            },
+            unlock_call("lock"),
+        ],
+    );
+
+    let mapping = LockAnalyzer::new().analyze_lock_data_mapping(&func);
+
+    for var in ["limit", "state", "buffer"] {
+        assert!(mapping.is_protected_by(var, "lock"), "{var} is accessed under the lock");
+    }
+}
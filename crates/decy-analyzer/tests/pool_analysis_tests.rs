@@ -0,0 +1,330 @@
+//! Tests for hand-rolled pool allocator and free-list detection.
+
+use decy_analyzer::pool_analysis::{PoolAnalyzer, PoolKind};
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn node_ptr() -> HirType {
+    HirType::Pointer(Box::new(HirType::Struct("Node".to_string())))
+}
+
+fn global(name: &str, var_type: HirType, initializer: Option<HirExpression>) -> HirStatement {
+    HirStatement::VariableDeclaration { name: name.to_string(), var_type, initializer }
+}
+
+fn binary(op: BinaryOperator, left: HirExpression, right: HirExpression) -> HirExpression {
+    HirExpression::BinaryOp { op, left: Box::new(left), right: Box::new(right) }
+}
+
+/// Helper: struct Node pool[256]; int next_slot = 0; struct Node *free_list = NULL;
+fn free_list_globals() -> Vec<HirStatement> {
+    vec![
+        global(
+            "pool",
+            HirType::Array {
+                element_type: Box::new(HirType::Struct("Node".to_string())),
+                size: Some(256),
+            },
+            None,
+        ),
+        global("next_slot", HirType::Int, Some(HirExpression::IntLiteral(0))),
+        global("free_list", node_ptr(), Some(HirExpression::NullLiteral)),
+    ]
+}
+
+/// Helper: pop the free list, else bump the pool, else NULL
+fn node_alloc() -> HirFunction {
+    HirFunction::new_with_body(
+        "node_alloc".to_string(),
+        node_ptr(),
+        vec![],
+        vec![
+            HirStatement::If {
+                condition: binary(
+                    BinaryOperator::NotEqual,
+                    var("free_list"),
+                    HirExpression::NullLiteral,
+                ),
+                then_block: vec![
+                    HirStatement::VariableDeclaration {
+                        name: "n".to_string(),
+                        var_type: node_ptr(),
+                        initializer: Some(var("free_list")),
+                    },
+                    HirStatement::Assignment {
+                        target: "free_list".to_string(),
+                        value: HirExpression::PointerFieldAccess {
+                            pointer: Box::new(var("n")),
+                            field: "next".to_string(),
+                        },
+                    },
+                    HirStatement::Return(Some(var("n"))),
+                ],
+                else_block: None,
+            },
+            HirStatement::If {
+                condition: binary(
+                    BinaryOperator::LessThan,
+                    var("next_slot"),
+                    HirExpression::IntLiteral(256),
+                ),
+                then_block: vec![HirStatement::Return(Some(HirExpression::AddressOf(Box::new(
+                    HirExpression::ArrayIndex {
+                        array: Box::new(var("pool")),
+                        index: Box::new(HirExpression::PostIncrement {
+                            operand: Box::new(var("next_slot")),
+                        }),
+                    },
+                ))))],
+                else_block: None,
+            },
+            HirStatement::Return(Some(HirExpression::NullLiteral)),
+        ],
+    )
+}
+
+/// Helper: p->next = free_list; free_list = p;
+fn node_release() -> HirFunction {
+    HirFunction::new_with_body(
+        "node_release".to_string(),
+        HirType::Void,
+        vec![HirParameter::new("p".to_string(), node_ptr())],
+        vec![
+            HirStatement::FieldAssignment {
+                object: var("p"),
+                field: "next".to_string(),
+                value: var("free_list"),
+            },
+            HirStatement::Assignment { target: "free_list".to_string(), value: var("p") },
+        ],
+    )
+}
+
+/// Helper: a user of the pool that calls it directly
+fn push_front(alloc: &str) -> HirFunction {
+    HirFunction::new_with_body(
+        "push_front".to_string(),
+        node_ptr(),
+        vec![HirParameter::new("head".to_string(), node_ptr())],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "n".to_string(),
+                var_type: node_ptr(),
+                initializer: Some(HirExpression::FunctionCall {
+                    function: alloc.to_string(),
+                    arguments: vec![],
+                }),
+            },
+            HirStatement::FieldAssignment {
+                object: var("n"),
+                field: "next".to_string(),
+                value: var("head"),
+            },
+            HirStatement::Return(Some(var("n"))),
+        ],
+    )
+}
+
+/// Helper: char arena[4096]; int arena_used;
+fn byte_pool_globals() -> Vec<HirStatement> {
+    vec![
+        global(
+            "arena",
+            HirType::Array { element_type: Box::new(HirType::Char), size: Some(4096) },
+            None,
+        ),
+        global("arena_used", HirType::Int, None),
+    ]
+}
+
+/// Helper: void *arena_alloc(int n) { void *p = &arena[arena_used]; arena_used += n; return p; }
+fn arena_alloc() -> HirFunction {
+    let void_ptr = HirType::Pointer(Box::new(HirType::Void));
+    HirFunction::new_with_body(
+        "arena_alloc".to_string(),
+        void_ptr.clone(),
+        vec![HirParameter::new("n".to_string(), HirType::Int)],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "p".to_string(),
+                var_type: void_ptr,
+                initializer: Some(HirExpression::AddressOf(Box::new(HirExpression::ArrayIndex {
+                    array: Box::new(var("arena")),
+                    index: Box::new(var("arena_used")),
+                }))),
+            },
+            HirStatement::Assignment {
+                target: "arena_used".to_string(),
+                value: binary(BinaryOperator::Add, var("arena_used"), var("n")),
+            },
+            HirStatement::Return(Some(var("p"))),
+        ],
+    )
+}
+
+/// Helper: void arena_reset(void) { arena_used = 0; }
+fn arena_reset() -> HirFunction {
+    HirFunction::new_with_body(
+        "arena_reset".to_string(),
+        HirType::Void,
+        vec![],
+        vec![HirStatement::Assignment {
+            target: "arena_used".to_string(),
+            value: HirExpression::IntLiteral(0),
+        }],
+    )
+}
+
+/// Helper: struct Vec2 *v = arena_alloc(sizeof(struct Vec2));
+fn make_vec2() -> HirFunction {
+    let vec2_ptr = HirType::Pointer(Box::new(HirType::Struct("Vec2".to_string())));
+    HirFunction::new_with_body(
+        "make_vec2".to_string(),
+        vec2_ptr.clone(),
+        vec![],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "v".to_string(),
+                var_type: vec2_ptr,
+                initializer: Some(HirExpression::FunctionCall {
+                    function: "arena_alloc".to_string(),
+                    arguments: vec![HirExpression::Sizeof { type_name: "struct Vec2".to_string() }],
+                }),
+            },
+            HirStatement::Return(Some(var("v"))),
+        ],
+    )
+}
+
+// ============================================================================
+// FREE LISTS
+// ============================================================================
+
+#[test]
+fn test_detect_free_list_over_static_pool() {
+    let functions = vec![node_alloc(), node_release(), push_front("node_alloc")];
+    let pools = PoolAnalyzer::new().analyze(&free_list_globals(), &functions);
+
+    assert_eq!(pools.len(), 1);
+    let pool = &pools[0];
+    assert_eq!(pool.kind, PoolKind::FreeList);
+    assert_eq!(pool.object_types, vec!["Node".to_string()]);
+    assert_eq!(pool.alloc, "node_alloc");
+    assert_eq!(pool.release.as_deref(), Some("node_release"));
+    assert_eq!(pool.capacity, Some(256));
+    assert_eq!(pool.state.len(), 3);
+}
+
+#[test]
+fn test_free_list_without_release_is_not_a_pool() {
+    let functions = vec![node_alloc(), push_front("node_alloc")];
+    let pools = PoolAnalyzer::new().analyze(&free_list_globals(), &functions);
+
+    assert!(pools.is_empty());
+}
+
+#[test]
+fn test_shared_pool_state_is_not_a_pool() {
+    // A second function walking the free list makes its layout observable
+    let peek = HirFunction::new_with_body(
+        "peek".to_string(),
+        node_ptr(),
+        vec![],
+        vec![HirStatement::Return(Some(var("free_list")))],
+    );
+    let functions = vec![node_alloc(), node_release(), peek];
+    let pools = PoolAnalyzer::new().analyze(&free_list_globals(), &functions);
+
+    assert!(pools.is_empty());
+}
+
+#[test]
+fn test_allocator_called_through_pointer_is_not_a_pool() {
+    let hook = HirFunction::new_with_body(
+        "install".to_string(),
+        HirType::Void,
+        vec![],
+        vec![HirStatement::Assignment {
+            target: "alloc_hook".to_string(),
+            value: var("node_alloc"),
+        }],
+    );
+    let functions = vec![node_alloc(), node_release(), hook];
+    let pools = PoolAnalyzer::new().analyze(&free_list_globals(), &functions);
+
+    assert!(pools.is_empty());
+}
+
+#[test]
+fn test_allocator_falling_back_to_malloc_is_not_a_pool() {
+    let fallback = HirFunction::new_with_body(
+        "node_alloc".to_string(),
+        node_ptr(),
+        vec![],
+        vec![HirStatement::Return(Some(HirExpression::FunctionCall {
+            function: "malloc".to_string(),
+            arguments: vec![HirExpression::Sizeof { type_name: "struct Node".to_string() }],
+        }))],
+    );
+    let functions = vec![fallback, node_release()];
+    let pools = PoolAnalyzer::new().analyze(&free_list_globals(), &functions);
+
+    assert!(pools.is_empty());
+}
+
+#[test]
+fn test_detect_free_list_with_heap_fallback() {
+    // if (free_list) { pop } return malloc(sizeof(struct Node));
+    let mut body = node_alloc().body().to_vec();
+    body.truncate(1);
+    body.push(HirStatement::Return(Some(HirExpression::FunctionCall {
+        function: "malloc".to_string(),
+        arguments: vec![HirExpression::Sizeof { type_name: "struct Node".to_string() }],
+    })));
+    let alloc = HirFunction::new_with_body("node_alloc".to_string(), node_ptr(), vec![], body);
+    let globals = vec![global("free_list", node_ptr(), None)];
+    let pools = PoolAnalyzer::new().analyze(&globals, &[alloc, node_release()]);
+
+    assert_eq!(pools.len(), 1);
+    assert_eq!(pools[0].kind, PoolKind::FreeList);
+    assert_eq!(pools[0].state, vec!["free_list".to_string()]);
+    assert_eq!(pools[0].capacity, None);
+}
+
+// ============================================================================
+// BUMP POOLS
+// ============================================================================
+
+#[test]
+fn test_detect_byte_bump_pool_with_reset() {
+    let functions = vec![arena_alloc(), arena_reset(), make_vec2()];
+    let pools = PoolAnalyzer::new().analyze(&byte_pool_globals(), &functions);
+
+    assert_eq!(pools.len(), 1);
+    let pool = &pools[0];
+    assert_eq!(pool.kind, PoolKind::Bump);
+    assert_eq!(pool.object_types, vec!["Vec2".to_string()]);
+    assert_eq!(pool.release, None);
+    assert_eq!(pool.reset, vec!["arena_reset".to_string()]);
+    assert_eq!(pool.capacity, None);
+}
+
+#[test]
+fn test_byte_pool_with_dynamic_sizes_is_not_a_pool() {
+    let strdup_like = HirFunction::new_with_body(
+        "copy".to_string(),
+        HirType::Void,
+        vec![HirParameter::new("len".to_string(), HirType::Int)],
+        vec![HirStatement::Expression(HirExpression::FunctionCall {
+            function: "arena_alloc".to_string(),
+            arguments: vec![var("len")],
+        })],
+    );
+    let functions = vec![arena_alloc(), make_vec2(), strdup_like];
+    let pools = PoolAnalyzer::new().analyze(&byte_pool_globals(), &functions);
+
+    assert!(pools.is_empty());
+}
@@ -0,0 +1,88 @@
+//! Tests for finding the functions that never reach stdin or stdout.
+
+use decy_analyzer::stdio_analysis::StdioAnalyzer;
+use decy_hir::{HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirExpression {
+    HirExpression::FunctionCall { function: function.to_string(), arguments }
+}
+
+/// int name(int x) { return body; }
+fn returning(name: &str, body: HirExpression) -> HirFunction {
+    HirFunction::new_with_body(
+        name.to_string(),
+        HirType::Int,
+        vec![HirParameter::new("x".to_string(), HirType::Int)],
+        vec![HirStatement::Return(Some(body))],
+    )
+}
+
+/// void name(void) { call; }
+fn calling(name: &str, callee: &str, arguments: Vec<HirExpression>) -> HirFunction {
+    HirFunction::new_with_body(
+        name.to_string(),
+        HirType::Void,
+        vec![],
+        vec![HirStatement::Expression(call(callee, arguments))],
+    )
+}
+
+#[test]
+fn test_helpers_calling_quiet_functions_are_quiet() {
+    let functions = vec![
+        returning("square", var("x")),
+        returning("root", call("sqrt", vec![call("square", vec![var("x")])])),
+    ];
+    let quiet = StdioAnalyzer::new().analyze(&functions);
+
+    assert!(quiet.is_quiet("square"));
+    assert!(quiet.is_quiet("root"));
+    assert!(quiet.is_quiet("strlen"));
+}
+
+#[test]
+fn test_printing_reaches_callers() {
+    let functions = vec![
+        calling("report", "printf", vec![HirExpression::StringLiteral("x".to_string())]),
+        calling("step", "report", vec![]),
+        calling("stop", "exit", vec![HirExpression::IntLiteral(1)]),
+    ];
+    let quiet = StdioAnalyzer::new().analyze(&functions);
+
+    assert!(!quiet.is_quiet("report"));
+    assert!(!quiet.is_quiet("step"));
+    assert!(!quiet.is_quiet("stop"));
+    assert!(!quiet.is_quiet("getchar"));
+}
+
+#[test]
+fn test_mutual_recursion_stays_quiet() {
+    let functions = vec![
+        returning("even", call("odd", vec![var("x")])),
+        returning("odd", call("even", vec![var("x")])),
+    ];
+    let quiet = StdioAnalyzer::new().analyze(&functions);
+
+    assert!(quiet.is_quiet("even"));
+    assert!(quiet.is_quiet("odd"));
+}
+
+#[test]
+fn test_pointer_calls_and_unknown_callees_are_not_quiet() {
+    let functions = vec![
+        // op(): a call through a function pointer
+        calling("apply", "op", vec![]),
+        // A function only declared, or a library function the unit redefines
+        HirFunction::new("external".to_string(), HirType::Void, vec![]),
+        calling("abs", "puts", vec![HirExpression::StringLiteral("x".to_string())]),
+    ];
+    let quiet = StdioAnalyzer::new().analyze(&functions);
+
+    assert!(!quiet.is_quiet("apply"));
+    assert!(!quiet.is_quiet("external"));
+    assert!(!quiet.is_quiet("abs"));
+}
@@ -0,0 +1,122 @@
+//! Tests for the single-pass analyzer suite.
+
+use decy_analyzer::lock_analysis::LockAnalyzer;
+use decy_analyzer::output_params::OutputParamDetector;
+use decy_analyzer::patterns::PatternDetector;
+use decy_analyzer::suite::{AnalyzerSuite, EnabledDetectors};
+use decy_hir::{
+    BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirStruct,
+    HirStructField, HirType,
+};
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirExpression {
+    HirExpression::FunctionCall { function: function.to_string(), arguments }
+}
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+/// A function that exercises every function-level detector.
+fn busy_function(name: &str) -> HirFunction {
+    HirFunction::new_with_body(
+        name.to_string(),
+        HirType::Int,
+        vec![HirParameter::new("out".to_string(), HirType::Pointer(Box::new(HirType::Int)))],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "p".to_string(),
+                var_type: HirType::Pointer(Box::new(HirType::Int)),
+                initializer: Some(call("malloc", vec![HirExpression::IntLiteral(4)])),
+            },
+            HirStatement::Expression(call(
+                "pthread_mutex_lock",
+                vec![HirExpression::AddressOf(Box::new(var("m")))],
+            )),
+            HirStatement::Assignment {
+                target: "count".to_string(),
+                value: HirExpression::BinaryOp {
+                    op: BinaryOperator::Add,
+                    left: Box::new(var("count")),
+                    right: Box::new(HirExpression::IntLiteral(1)),
+                },
+            },
+            HirStatement::Expression(call(
+                "pthread_mutex_unlock",
+                vec![HirExpression::AddressOf(Box::new(var("m")))],
+            )),
+            HirStatement::DerefAssignment {
+                target: HirExpression::Dereference(Box::new(var("out"))),
+                value: HirExpression::IntLiteral(7),
+            },
+            HirStatement::VariableDeclaration {
+                name: "pid".to_string(),
+                var_type: HirType::Int,
+                initializer: Some(call("fork", vec![])),
+            },
+            HirStatement::Return(Some(HirExpression::IntLiteral(0))),
+        ],
+    )
+}
+
+#[test]
+fn test_suite_matches_individual_detectors() {
+    let func = busy_function("busy");
+    let result = AnalyzerSuite::new().analyze_function(&func);
+
+    assert_eq!(result.name, "busy");
+    assert_eq!(result.box_candidates, PatternDetector::new().find_box_candidates(&func));
+    assert_eq!(result.vec_candidates, PatternDetector::new().find_vec_candidates(&func));
+    assert_eq!(result.lock_regions, LockAnalyzer::new().find_lock_regions(&func));
+    assert_eq!(result.lock_regions.len(), 1);
+    assert!(result.lock_data.is_protected_by("count", "m"));
+    assert_eq!(result.output_params, OutputParamDetector::new().detect(&func));
+    assert_eq!(result.subprocess.len(), 1);
+    assert_eq!(result.subprocess[0].pid_var.as_deref(), Some("pid"));
+}
+
+#[test]
+fn test_parallel_results_keep_input_order() {
+    let functions: Vec<_> = (0..50).map(|i| busy_function(&format!("f{}", i))).collect();
+
+    let serial = AnalyzerSuite::new().with_threads(1).analyze(&functions, &[]);
+    let parallel = AnalyzerSuite::new().with_threads(4).analyze(&functions, &[]);
+
+    assert_eq!(parallel.functions.len(), 50);
+    for (i, (s, p)) in serial.functions.iter().zip(&parallel.functions).enumerate() {
+        assert_eq!(p.name, format!("f{}", i));
+        assert_eq!(s.box_candidates, p.box_candidates);
+        assert_eq!(s.lock_regions, p.lock_regions);
+    }
+    assert!(parallel.function("f17").is_some());
+}
+
+#[test]
+fn test_disabled_detectors_leave_results_empty() {
+    let func = busy_function("busy");
+    let tagged = HirStruct::new(
+        "Value".to_string(),
+        vec![
+            HirStructField::new("tag".to_string(), HirType::Enum("Tag".to_string())),
+            HirStructField::new(
+                "data".to_string(),
+                HirType::Union(vec![("i".to_string(), HirType::Int)]),
+            ),
+        ],
+    );
+
+    let only_locks = EnabledDetectors { locks: true, ..EnabledDetectors::none() };
+    let results = AnalyzerSuite::new()
+        .with_detectors(only_locks)
+        .analyze(std::slice::from_ref(&func), std::slice::from_ref(&tagged));
+
+    let result = &results.functions[0];
+    assert_eq!(result.lock_regions.len(), 1);
+    assert!(result.box_candidates.is_empty());
+    assert!(result.output_params.is_empty());
+    assert!(result.subprocess.is_empty());
+    assert!(results.tagged_unions.is_empty());
+
+    let all = AnalyzerSuite::new().analyze(&[func], &[tagged]);
+    assert_eq!(all.tagged_unions.len(), 1);
+}
@@ -3,8 +3,10 @@
 //! Analyzes void* usage to infer generic type parameters for
 //! transformation to Rust generics.
 
-use decy_analyzer::void_ptr_analysis::{TypeConstraint, VoidPtrAnalyzer, VoidPtrPattern};
-use decy_hir::{HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+use decy_analyzer::void_ptr_analysis::{
+    TypeConstraint, VoidPtrAnalyzer, VoidPtrPattern, VoidPtrScan,
+};
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
 
 /// Helper: Create test function
 fn create_function(name: &str, params: Vec<HirParameter>, body: Vec<HirStatement>) -> HirFunction {
@@ -815,3 +817,257 @@ fn test_expr_uses_param_default_arm() {
         "Non-param target should not add Mutable constraint"
     );
 }
+
+// ============================================================================
+// WHOLE-UNIT INSTANTIATION
+// ============================================================================
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn int_ptr() -> HirType {
+    HirType::Pointer(Box::new(HirType::Int))
+}
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirStatement {
+    HirStatement::Expression(HirExpression::FunctionCall {
+        function: function.to_string(),
+        arguments,
+    })
+}
+
+/// Helper: void foreach(void *items, int n, void (*visit)(void *))
+/// { int *base = (int *)items; for (int i = 0; i < n; i++) visit(&base[i]); }
+fn foreach() -> HirFunction {
+    let visit = HirType::FunctionPointer {
+        param_types: vec![HirType::Pointer(Box::new(HirType::Void))],
+        return_type: Box::new(HirType::Void),
+    };
+    create_function(
+        "foreach",
+        vec![
+            void_ptr_param("items"),
+            HirParameter::new("n".to_string(), HirType::Int),
+            HirParameter::new("visit".to_string(), visit),
+        ],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "base".to_string(),
+                var_type: int_ptr(),
+                initializer: Some(HirExpression::Cast {
+                    expr: Box::new(var("items")),
+                    target_type: int_ptr(),
+                }),
+            },
+            HirStatement::For {
+                init: vec![HirStatement::VariableDeclaration {
+                    name: "i".to_string(),
+                    var_type: HirType::Int,
+                    initializer: Some(HirExpression::IntLiteral(0)),
+                }],
+                condition: Some(HirExpression::BinaryOp {
+                    op: BinaryOperator::LessThan,
+                    left: Box::new(var("i")),
+                    right: Box::new(var("n")),
+                }),
+                increment: vec![HirStatement::Expression(HirExpression::PostIncrement {
+                    operand: Box::new(var("i")),
+                })],
+                body: vec![call(
+                    "visit",
+                    vec![HirExpression::AddressOf(Box::new(HirExpression::ArrayIndex {
+                        array: Box::new(var("base")),
+                        index: Box::new(var("i")),
+                    }))],
+                )],
+            },
+        ],
+    )
+}
+
+/// Helper: void bump(void *p) { int *ip = (int *)p; *ip += 1; }
+fn bump(cast_to: HirType) -> HirFunction {
+    create_function(
+        "bump",
+        vec![void_ptr_param("p")],
+        vec![HirStatement::VariableDeclaration {
+            name: "ip".to_string(),
+            var_type: cast_to.clone(),
+            initializer: Some(HirExpression::Cast {
+                expr: Box::new(var("p")),
+                target_type: cast_to,
+            }),
+        }],
+    )
+}
+
+/// Helper: int data[8]; foreach(data, 8, bump);
+fn caller(extra: Vec<HirStatement>) -> HirFunction {
+    let mut body = vec![
+        HirStatement::VariableDeclaration {
+            name: "data".to_string(),
+            var_type: HirType::Array { element_type: Box::new(HirType::Int), size: Some(8) },
+            initializer: None,
+        },
+        call("foreach", vec![var("data"), HirExpression::IntLiteral(8), var("bump")]),
+    ];
+    body.extend(extra);
+    create_function("run", vec![], body)
+}
+
+/// The (function, param, callback_arg) positions instantiated, sorted
+fn instantiated(functions: &[HirFunction]) -> Vec<(String, usize, Option<usize>)> {
+    let mut found: Vec<_> = VoidPtrAnalyzer::new()
+        .instantiate(functions)
+        .into_iter()
+        .map(|i| (i.function, i.param, i.callback_arg))
+        .collect();
+    found.sort();
+    found
+}
+
+fn items_only() -> Vec<(String, usize, Option<usize>)> {
+    vec![("foreach".to_string(), 0, None)]
+}
+
+#[test]
+fn test_instantiate_callback_api_with_one_element_type() {
+    let functions = vec![foreach(), bump(int_ptr()), caller(vec![])];
+    let mut instances = VoidPtrAnalyzer::new().instantiate(&functions);
+    instances.sort_by_key(|i| (i.function.clone(), i.param, i.callback_arg));
+
+    let found: Vec<_> =
+        instances.iter().map(|i| (i.function.as_str(), i.param, i.callback_arg)).collect();
+    assert_eq!(found, vec![("bump", 0, None), ("foreach", 0, None), ("foreach", 2, Some(0))]);
+    assert!(instances.iter().all(|i| i.pointee == HirType::Int));
+}
+
+#[test]
+fn test_scan_matches_instantiate_in_any_body_order() {
+    let functions = vec![foreach(), bump(int_ptr()), caller(vec![])];
+
+    // Only the signatures are kept up front; the caller is seen first
+    let mut scan = VoidPtrScan::new(&functions);
+    functions.iter().rev().for_each(|f| scan.observe(f));
+    let mut found: Vec<_> =
+        scan.finish().into_iter().map(|i| (i.function, i.param, i.callback_arg)).collect();
+    found.sort();
+
+    assert_eq!(found, instantiated(&functions));
+}
+
+#[test]
+fn test_conflicting_pointee_types_are_not_instantiated() {
+    // bump reads its element as a double while the caller passes ints
+    let double_ptr = HirType::Pointer(Box::new(HirType::Double));
+    let functions = vec![foreach(), bump(double_ptr), caller(vec![])];
+
+    // The array argument stays typed; the callback and its target do not
+    assert_eq!(instantiated(&functions), items_only());
+}
+
+#[test]
+fn test_callback_used_as_value_is_not_instantiated() {
+    // void (*hook)(void *) = bump; lets bump be called with anything
+    let hook = HirStatement::VariableDeclaration {
+        name: "hook".to_string(),
+        var_type: HirType::FunctionPointer {
+            param_types: vec![HirType::Pointer(Box::new(HirType::Void))],
+            return_type: Box::new(HirType::Void),
+        },
+        initializer: Some(var("bump")),
+    };
+    let functions = vec![foreach(), bump(int_ptr()), caller(vec![hook])];
+
+    assert_eq!(instantiated(&functions), items_only());
+}
+
+#[test]
+fn test_param_passed_to_external_function_is_not_instantiated() {
+    // free(p) inside bump: the pointer leaves the unit
+    let mut body = bump(int_ptr()).body().to_vec();
+    body.push(call("free", vec![var("p")]));
+    let leaky = create_function("bump", vec![void_ptr_param("p")], body);
+    let functions = vec![foreach(), leaky, caller(vec![])];
+
+    assert_eq!(instantiated(&functions), items_only());
+}
+
+#[test]
+fn test_uncalled_function_keeps_its_void_pointer() {
+    // Only casts, no call site: an exported API whose callers are elsewhere
+    assert!(VoidPtrAnalyzer::new().instantiate(&[bump(int_ptr())]).is_empty());
+}
+
+/// Helper: int cmp(const void *a, const void *b) { int *x = a; int *y = b; }
+fn comparator() -> HirFunction {
+    let decl = |name: &str, param: &str| HirStatement::VariableDeclaration {
+        name: name.to_string(),
+        var_type: int_ptr(),
+        initializer: Some(var(param)),
+    };
+    create_function(
+        "cmp",
+        vec![void_ptr_param("a"), void_ptr_param("b")],
+        vec![decl("x", "a"), decl("y", "b")],
+    )
+}
+
+#[test]
+fn test_instantiate_qsort_comparator_from_sorted_array() {
+    // int data[8]; qsort(data, 8, sizeof(int), cmp);
+    let sort = create_function(
+        "run",
+        vec![],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "data".to_string(),
+                var_type: HirType::Array { element_type: Box::new(HirType::Int), size: Some(8) },
+                initializer: None,
+            },
+            call(
+                "qsort",
+                vec![
+                    var("data"),
+                    HirExpression::IntLiteral(8),
+                    HirExpression::Sizeof { type_name: "int".to_string() },
+                    var("cmp"),
+                ],
+            ),
+        ],
+    );
+    let functions = vec![comparator(), sort];
+
+    let expected = vec![("cmp".to_string(), 0, None), ("cmp".to_string(), 1, None)];
+    assert_eq!(instantiated(&functions), expected);
+}
+
+#[test]
+fn test_bsearch_key_of_other_type_is_not_instantiated() {
+    // double key; bsearch(&key, data, 8, sizeof(int), cmp): cmp reads the key as an int
+    let search = create_function(
+        "run",
+        vec![HirParameter::new("data".to_string(), int_ptr())],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "key".to_string(),
+                var_type: HirType::Double,
+                initializer: None,
+            },
+            call(
+                "bsearch",
+                vec![
+                    HirExpression::AddressOf(Box::new(var("key"))),
+                    var("data"),
+                    HirExpression::IntLiteral(8),
+                    HirExpression::Sizeof { type_name: "int".to_string() },
+                    var("cmp"),
+                ],
+            ),
+        ],
+    );
+    let functions = vec![comparator(), search];
+
+    assert_eq!(instantiated(&functions), vec![("cmp".to_string(), 1, None)]);
+}
@@ -0,0 +1,100 @@
+//! Benchmarks for counted loops lowered to usize ranges
+//!
+//! Measures runtime of the `for __i in 0..n` loops decy emits for canonical
+//! counted `for` loops ("range") against the `while i < n` lowering with
+//! `a[(i) as usize]` indexing they replace ("while").
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
+
+const SIZES: [usize; 2] = [1024, 64 * 1024];
+
+// ============================================================================
+// Kernels: generated shapes for `c[i] = a[i] + b[i]` and `s += a[i]`
+// ============================================================================
+
+fn add_while(a: &[i32], b: &[i32], c: &mut [i32]) {
+    let mut i: i32 = 0;
+    while i < a.len() as i32 {
+        c[(i) as usize] = a[(i) as usize].wrapping_add(b[(i) as usize]);
+        i = i + 1;
+    }
+}
+
+fn add_range(a: &[i32], b: &[i32], c: &mut [i32]) {
+    let __i_end = a.len();
+    assert!(__i_end <= c.len() && __i_end <= b.len());
+    for __i in 0..__i_end {
+        c[__i] = a[__i].wrapping_add(b[__i]);
+    }
+}
+
+fn count_while(a: &[u8], n: i32) -> i32 {
+    let mut hits: i32 = 0;
+    let mut i: i32 = 0;
+    while i < n {
+        if a[(i) as usize] == b' ' {
+            hits = hits + 1;
+        }
+        i = i + 1;
+    }
+    hits
+}
+
+fn count_range(a: &[u8], n: i32) -> i32 {
+    let mut hits: i32 = 0;
+    for __i in 0..(n).max(0) as usize {
+        if a[__i] == b' ' {
+            hits = hits + 1;
+        }
+    }
+    hits
+}
+
+// ============================================================================
+// Benchmark: element-wise add over three slices
+// ============================================================================
+
+fn bench_elementwise_add(c: &mut Criterion) {
+    let mut group = c.benchmark_group("counted_loop_add");
+
+    for size in SIZES {
+        let a: Vec<i32> = (0..size as i32).collect();
+        let b = a.clone();
+        let mut out = vec![0; size];
+
+        group.bench_with_input(BenchmarkId::new("while", size), &size, |bench, _| {
+            bench.iter(|| add_while(black_box(&a), black_box(&b), black_box(&mut out)))
+        });
+
+        group.bench_with_input(BenchmarkId::new("range", size), &size, |bench, _| {
+            bench.iter(|| add_range(black_box(&a), black_box(&b), black_box(&mut out)))
+        });
+    }
+
+    group.finish();
+}
+
+// ============================================================================
+// Benchmark: byte count with a separate length bound
+// ============================================================================
+
+fn bench_byte_count(c: &mut Criterion) {
+    let mut group = c.benchmark_group("counted_loop_count");
+
+    for size in SIZES {
+        let text: Vec<u8> = (0..size).map(|i| if i % 7 == 0 { b' ' } else { b'x' }).collect();
+
+        group.bench_with_input(BenchmarkId::new("while", size), &size, |bench, &n| {
+            bench.iter(|| count_while(black_box(&text), black_box(n as i32)))
+        });
+
+        group.bench_with_input(BenchmarkId::new("range", size), &size, |bench, &n| {
+            bench.iter(|| count_range(black_box(&text), black_box(n as i32)))
+        });
+    }
+
+    group.finish();
+}
+
+criterion_group!(benches, bench_elementwise_add, bench_byte_count);
+criterion_main!(benches);
@@ -0,0 +1,162 @@
+//! Benchmarks for pointer-walking loops lowered to slice iteration
+//!
+//! Measures runtime of the shapes decy emits for `while (*s) { ...; s++; }`,
+//! `while (*src) *dst++ = *src++;` and `while (arr < end) { ...; arr++; }`
+//! ("slice") against the per-element indexing or raw pointer walks they
+//! replace ("walk").
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
+
+const SIZES: [usize; 2] = [4 * 1024, 64 * 1024];
+
+fn text(len: usize) -> Vec<u8> {
+    let mut s: Vec<u8> = (0..len).map(|i| if i % 7 == 0 { b' ' } else { b'x' }).collect();
+    s.push(0);
+    s
+}
+
+// ============================================================================
+// Kernels: generated shapes before and after the lowering
+// ============================================================================
+
+fn count_walk(s: &[u8], c: u8) -> i32 {
+    let mut s_idx: usize = 0;
+    let mut n: i32 = 0;
+    while (s[s_idx]) != 0 {
+        if s[s_idx] == c {
+            n = n + 1;
+        }
+        s_idx += 1 as usize;
+    }
+    n
+}
+
+fn count_slice(s: &[u8], c: u8) -> i32 {
+    let mut s_idx: usize = 0;
+    let mut n: i32 = 0;
+    for &__s_byte in s[s_idx..].iter().take_while(|&&__b| __b != 0) {
+        if __s_byte == c {
+            n = n + 1;
+        }
+        s_idx += 1;
+    }
+    black_box(s_idx);
+    n
+}
+
+fn copy_walk(dst: &mut [u8], src: &[u8]) {
+    let mut dst_idx: usize = 0;
+    let mut src_idx: usize = 0;
+    while (src[src_idx]) != 0 {
+        dst[dst_idx] = src[src_idx];
+        src_idx += 1;
+        dst_idx += 1;
+    }
+    dst[dst_idx] = 0;
+}
+
+fn copy_slice(dst: &mut [u8], src: &[u8]) {
+    let mut dst_idx: usize = 0;
+    let mut src_idx: usize = 0;
+    {
+        let __n = std::ffi::CStr::from_bytes_until_nul(&src[src_idx..])
+            .map_or(src.len() - src_idx, |__c| __c.to_bytes().len());
+        dst[dst_idx..dst_idx + __n].copy_from_slice(&src[src_idx..src_idx + __n]);
+        dst_idx += __n;
+        src_idx += __n;
+    }
+    black_box(src_idx);
+    dst[dst_idx] = 0;
+}
+
+/// # Safety
+///
+/// `arr` must point to `size` readable elements.
+unsafe fn sum_walk(mut arr: *const i32, size: i32) -> i32 {
+    let mut sum: i32 = 0;
+    let end = arr.add(size as usize);
+    while arr < end {
+        sum = sum.wrapping_add(*arr);
+        arr = arr.add(1);
+    }
+    sum
+}
+
+fn sum_slice(arr: &[i32]) -> i32 {
+    let mut sum: i32 = 0;
+    for __arr_idx in 0..arr.len() {
+        sum = sum.wrapping_add(arr[__arr_idx]);
+    }
+    sum
+}
+
+// ============================================================================
+// Benchmark: NUL-terminated byte count
+// ============================================================================
+
+fn bench_nul_walk(c: &mut Criterion) {
+    let mut group = c.benchmark_group("pointer_walk_count");
+
+    for size in SIZES {
+        let s = text(size);
+
+        group.bench_with_input(BenchmarkId::new("walk", size), &s, |b, s| {
+            b.iter(|| count_walk(black_box(s), b' '))
+        });
+
+        group.bench_with_input(BenchmarkId::new("slice", size), &s, |b, s| {
+            b.iter(|| count_slice(black_box(s), b' '))
+        });
+    }
+
+    group.finish();
+}
+
+// ============================================================================
+// Benchmark: *dst++ = *src++ string copy
+// ============================================================================
+
+fn bench_copy(c: &mut Criterion) {
+    let mut group = c.benchmark_group("pointer_walk_copy");
+
+    for size in SIZES {
+        let src = text(size);
+        let mut dst = vec![0u8; size + 1];
+
+        group.bench_with_input(BenchmarkId::new("walk", size), &size, |b, _| {
+            b.iter(|| copy_walk(black_box(&mut dst), black_box(&src)))
+        });
+
+        group.bench_with_input(BenchmarkId::new("slice", size), &size, |b, _| {
+            b.iter(|| copy_slice(black_box(&mut dst), black_box(&src)))
+        });
+    }
+
+    group.finish();
+}
+
+// ============================================================================
+// Benchmark: arr < end array walk
+// ============================================================================
+
+fn bench_array_walk(c: &mut Criterion) {
+    let mut group = c.benchmark_group("pointer_walk_sum");
+
+    for size in SIZES {
+        let a: Vec<i32> = (0..size as i32).collect();
+
+        group.bench_with_input(BenchmarkId::new("walk", size), &a, |b, a| {
+            // SAFETY: the pointer and length come from the same Vec
+            b.iter(|| unsafe { sum_walk(black_box(a.as_ptr()), black_box(a.len() as i32)) })
+        });
+
+        group.bench_with_input(BenchmarkId::new("slice", size), &a, |b, a| {
+            b.iter(|| sum_slice(black_box(a)))
+        });
+    }
+
+    group.finish();
+}
+
+criterion_group!(benches, bench_nul_walk, bench_copy, bench_array_walk);
+criterion_main!(benches);
@@ -0,0 +1,177 @@
+//! Benchmarks for reduction loops lowered to iterator chains
+//!
+//! Measures runtime of the `sum`, `fold` and `filter().count()` chains decy
+//! emits for accumulator loops ("iter") against the counted range loops they
+//! replace ("range"). Float dot products are also measured with the opt-in
+//! eight-lane reassociated sum ("lanes").
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
+
+const SIZES: [usize; 2] = [1024, 64 * 1024];
+
+// ============================================================================
+// Kernels: generated shapes for sum, dot product, count and maximum
+// ============================================================================
+
+fn sum_range(a: &[i32]) -> i32 {
+    let mut s: i32 = 0;
+    for __i in 0..a.len() {
+        s = s + a[__i];
+    }
+    s
+}
+
+fn sum_iter(a: &[i32]) -> i32 {
+    let s: i32 = 0;
+    s + a.iter().copied().sum::<i32>()
+}
+
+fn dot_range(a: &[f64], b: &[f64], n: i32) -> f64 {
+    let mut s: f64 = 0.0;
+    for __i in 0..(n).max(0) as usize {
+        s = s + a[__i] * b[__i];
+    }
+    s
+}
+
+fn dot_iter(a: &[f64], b: &[f64], n: i32) -> f64 {
+    let s: f64 = 0.0;
+    a[..(n).max(0) as usize]
+        .iter()
+        .zip(b[..(n).max(0) as usize].iter())
+        .map(|(&__x, &__y)| __x * __y)
+        .fold(s, |__acc, __v| __acc + __v)
+}
+
+fn dot_lanes(a: &[f64], b: &[f64], n: i32) -> f64 {
+    let s: f64 = 0.0;
+    s + {
+        let mut __lanes: [f64; 8] = [0.0; 8];
+        let (mut __cx, mut __cy) =
+            (a[..(n).max(0) as usize].chunks_exact(8), b[..(n).max(0) as usize].chunks_exact(8));
+        for (__c, __d) in (&mut __cx).zip(&mut __cy) {
+            for __l in 0..8 {
+                __lanes[__l] += __c[__l] * __d[__l];
+            }
+        }
+        __lanes.iter().sum::<f64>()
+            + __cx
+                .remainder()
+                .iter()
+                .zip(__cy.remainder().iter())
+                .map(|(&__x, &__y)| __x * __y)
+                .sum::<f64>()
+    }
+}
+
+fn count_range(a: &[i32], n: i32) -> i32 {
+    let mut c: i32 = 0;
+    for __i in 0..(n).max(0) as usize {
+        if a[__i] > 0 {
+            c = c + 1;
+        }
+    }
+    c
+}
+
+fn count_iter(a: &[i32], n: i32) -> i32 {
+    let c: i32 = 0;
+    c + a[..(n).max(0) as usize].iter().filter(|&&__x| __x > 0).count() as i32
+}
+
+fn max_range(a: &[i32]) -> i32 {
+    let mut m: i32 = i32::MIN;
+    for __i in 0..a.len() {
+        if a[__i] > m {
+            m = a[__i];
+        }
+    }
+    m
+}
+
+fn max_iter(a: &[i32]) -> i32 {
+    let m: i32 = i32::MIN;
+    a.iter().copied().fold(m, |__m, __v| __m.max(__v))
+}
+
+// ============================================================================
+// Benchmark: integer sum
+// ============================================================================
+
+fn bench_int_sum(c: &mut Criterion) {
+    let mut group = c.benchmark_group("reduction_sum");
+
+    for size in SIZES {
+        let a: Vec<i32> = (0..size as i32).map(|i| i % 100).collect();
+
+        group.bench_with_input(BenchmarkId::new("range", size), &size, |bench, _| {
+            bench.iter(|| sum_range(black_box(&a)))
+        });
+
+        group.bench_with_input(BenchmarkId::new("iter", size), &size, |bench, _| {
+            bench.iter(|| sum_iter(black_box(&a)))
+        });
+    }
+
+    group.finish();
+}
+
+// ============================================================================
+// Benchmark: f64 dot product, in order and reassociated
+// ============================================================================
+
+fn bench_dot_product(c: &mut Criterion) {
+    let mut group = c.benchmark_group("reduction_dot");
+
+    for size in SIZES {
+        let a: Vec<f64> = (0..size).map(|i| i as f64 * 0.5).collect();
+        let b: Vec<f64> = (0..size).map(|i| 1.0 / (i as f64 + 1.0)).collect();
+
+        group.bench_with_input(BenchmarkId::new("range", size), &size, |bench, &n| {
+            bench.iter(|| dot_range(black_box(&a), black_box(&b), black_box(n as i32)))
+        });
+
+        group.bench_with_input(BenchmarkId::new("iter", size), &size, |bench, &n| {
+            bench.iter(|| dot_iter(black_box(&a), black_box(&b), black_box(n as i32)))
+        });
+
+        group.bench_with_input(BenchmarkId::new("lanes", size), &size, |bench, &n| {
+            bench.iter(|| dot_lanes(black_box(&a), black_box(&b), black_box(n as i32)))
+        });
+    }
+
+    group.finish();
+}
+
+// ============================================================================
+// Benchmark: conditional count and maximum
+// ============================================================================
+
+fn bench_count_and_max(c: &mut Criterion) {
+    let mut group = c.benchmark_group("reduction_count_max");
+
+    for size in SIZES {
+        let a: Vec<i32> = (0..size as i32).map(|i| (i * 7919) % 201 - 100).collect();
+
+        group.bench_with_input(BenchmarkId::new("count_range", size), &size, |bench, &n| {
+            bench.iter(|| count_range(black_box(&a), black_box(n as i32)))
+        });
+
+        group.bench_with_input(BenchmarkId::new("count_iter", size), &size, |bench, &n| {
+            bench.iter(|| count_iter(black_box(&a), black_box(n as i32)))
+        });
+
+        group.bench_with_input(BenchmarkId::new("max_range", size), &size, |bench, _| {
+            bench.iter(|| max_range(black_box(&a)))
+        });
+
+        group.bench_with_input(BenchmarkId::new("max_iter", size), &size, |bench, _| {
+            bench.iter(|| max_iter(black_box(&a)))
+        });
+    }
+
+    group.finish();
+}
+
+criterion_group!(benches, bench_int_sum, bench_dot_product, bench_count_and_max);
+criterion_main!(benches);
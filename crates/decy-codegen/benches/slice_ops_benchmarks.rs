@@ -0,0 +1,160 @@
+//! Benchmarks for string.h calls lowered to slice operations
+//!
+//! Measures runtime of the Rust shapes decy emits for memcpy/memset/memcmp/
+//! strlen on buffers ("slice") against the element-by-element loops a direct
+//! translation of the C semantics produces ("loop").
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
+
+const SIZES: [usize; 2] = [4 * 1024, 64 * 1024];
+
+fn bytes(len: usize) -> Vec<u8> {
+    (0..len).map(|i| (i % 251) as u8 + 1).collect()
+}
+
+// ============================================================================
+// Benchmark: memcpy
+// ============================================================================
+
+fn bench_memcpy(c: &mut Criterion) {
+    let mut group = c.benchmark_group("memcpy");
+
+    for size in SIZES {
+        let src = bytes(size);
+        let mut dst = vec![0u8; size];
+
+        group.bench_with_input(BenchmarkId::new("loop", size), &size, |b, &n| {
+            b.iter(|| {
+                let mut i = 0;
+                while i < n {
+                    dst[i] = src[i];
+                    i += 1;
+                }
+                black_box(&dst);
+            })
+        });
+
+        group.bench_with_input(BenchmarkId::new("slice", size), &size, |b, &n| {
+            b.iter(|| {
+                {
+                    let __n = (n) as usize;
+                    dst[..__n].copy_from_slice(&src[..__n]);
+                };
+                black_box(&dst);
+            })
+        });
+    }
+
+    group.finish();
+}
+
+// ============================================================================
+// Benchmark: memset
+// ============================================================================
+
+fn bench_memset(c: &mut Criterion) {
+    let mut group = c.benchmark_group("memset");
+
+    for size in SIZES {
+        let mut buf = vec![0i32; size / 4];
+
+        group.bench_with_input(BenchmarkId::new("loop", size), &size, |b, &n| {
+            b.iter(|| {
+                let mut i = 0;
+                while i < n / 4 {
+                    buf[i] = 0;
+                    i += 1;
+                }
+                black_box(&buf);
+            })
+        });
+
+        group.bench_with_input(BenchmarkId::new("slice", size), &size, |b, &n| {
+            b.iter(|| {
+                {
+                    let __n = (n) as usize / std::mem::size_of::<i32>();
+                    buf[..__n].fill(0);
+                };
+                black_box(&buf);
+            })
+        });
+    }
+
+    group.finish();
+}
+
+// ============================================================================
+// Benchmark: memcmp (equal buffers, full scan)
+// ============================================================================
+
+fn bench_memcmp(c: &mut Criterion) {
+    let mut group = c.benchmark_group("memcmp");
+
+    for size in SIZES {
+        let a = bytes(size);
+        let b2 = a.clone();
+
+        group.bench_with_input(BenchmarkId::new("loop", size), &size, |b, &n| {
+            b.iter(|| {
+                let mut r = 0i32;
+                let mut i = 0;
+                while i < n {
+                    if a[i] != b2[i] {
+                        r = a[i] as i32 - b2[i] as i32;
+                        break;
+                    }
+                    i += 1;
+                }
+                black_box(r)
+            })
+        });
+
+        group.bench_with_input(BenchmarkId::new("slice", size), &size, |b, &n| {
+            b.iter(|| {
+                black_box({
+                    let __n = (n) as usize;
+                    a[..__n].cmp(&b2[..__n]) as i32
+                })
+            })
+        });
+    }
+
+    group.finish();
+}
+
+// ============================================================================
+// Benchmark: strlen
+// ============================================================================
+
+fn bench_strlen(c: &mut Criterion) {
+    let mut group = c.benchmark_group("strlen");
+
+    for size in SIZES {
+        let mut s = bytes(size);
+        s.push(0);
+
+        group.bench_with_input(BenchmarkId::new("loop", size), &s, |b, s| {
+            b.iter(|| {
+                let s = black_box(&s[..]);
+                let mut n = 0;
+                while s[n] != 0 {
+                    n += 1;
+                }
+                n as i32
+            })
+        });
+
+        group.bench_with_input(BenchmarkId::new("slice", size), &s, |b, s| {
+            b.iter(|| {
+                let s = black_box(&s[..]);
+                std::ffi::CStr::from_bytes_until_nul(s).map_or(s.len(), |__c| __c.to_bytes().len())
+                    as i32
+            })
+        });
+    }
+
+    group.finish();
+}
+
+criterion_group!(benches, bench_memcpy, bench_memset, bench_memcmp, bench_strlen);
+criterion_main!(benches);
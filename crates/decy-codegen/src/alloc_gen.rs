@@ -0,0 +1,660 @@
+//! Heap buffer code generation methods for CodeGenerator.
+//!
+//! Two C allocation idioms are lowered onto `Vec`'s own growth and reuse:
+//!
+//! - A dynamic array grown in place, `if (len == cap) { cap *= 2;
+//!   p = realloc(p, cap * sizeof *p); } p[len++] = x;`, becomes a Vec
+//!   appended with `push`, whose amortised growth replaces the realloc. The
+//!   pointer may only be indexed, appended at `len`, grown or freed, and `len`
+//!   may only change with the appends, so it always equals the Vec's length.
+//! - An array `malloc`ed and freed in the same loop body becomes one Vec
+//!   declared before the loop and cleared and refilled each iteration, so
+//!   later iterations reuse its allocation.
+
+use super::{escape_rust_keyword, CodeGenerator, TypeContext};
+use decy_hir::visit::{walk_statements, Visitor};
+use decy_hir::{BinaryOperator, HirExpression, HirStatement, HirType, UnaryOperator};
+use std::collections::HashMap;
+
+/// A pointer local lowered to a Vec grown by `push`.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub(crate) struct GrowthBuffer {
+    /// Element count, equal to the Vec's length after every append
+    len: String,
+    /// Whether the capacity variable is only read by the growth checks,
+    /// which are then dropped along with the realloc
+    drop_checks: bool,
+}
+
+impl CodeGenerator {
+    /// Find the top-level pointer locals of a function body used as growing
+    /// dynamic arrays.
+    pub(crate) fn find_growth_buffers(body: &[HirStatement]) -> HashMap<String, GrowthBuffer> {
+        body.iter()
+            .filter_map(|stmt| match stmt {
+                HirStatement::VariableDeclaration {
+                    name,
+                    var_type: HirType::Pointer(element),
+                    initializer: Some(init),
+                } if !matches!(**element, HirType::Void) && growth_start(init, name).is_some() => {
+                    Some((name.clone(), growth_buffer(name, body)?))
+                }
+                _ => None,
+            })
+            .collect()
+    }
+
+    /// Declaration of a growth buffer (`Vec::with_capacity`) or the
+    /// per-iteration reset of a hoisted scratch buffer.
+    pub(crate) fn generate_heap_buffer_declaration(
+        &self,
+        name: &str,
+        escaped_name: &str,
+        var_type: &HirType,
+        initializer: Option<&HirExpression>,
+        ctx: &mut TypeContext,
+    ) -> Option<String> {
+        let HirType::Pointer(element) = var_type else {
+            return None;
+        };
+        if ctx.growth_buffer(name).is_some() {
+            let init = match growth_start(initializer?, name)? {
+                Some(count) => format!(
+                    "Vec::with_capacity(({}) as usize)",
+                    self.generate_expression_with_context(count, ctx)
+                ),
+                None => "Vec::new()".to_string(),
+            };
+            let vec_type = HirType::Vec(element.clone());
+            let code =
+                format!("let mut {}: {} = {};", escaped_name, Self::map_type(&vec_type), init);
+            ctx.add_variable(name.to_string(), vec_type);
+            return Some(code);
+        }
+        if ctx.is_scratch_buffer(name) {
+            let count = scratch_count(initializer?, name)?;
+            // Registered here rather than at the hoisted declaration: the
+            // buffer is empty until this reset, so loop prepasses must not
+            // treat it as an array whose length is known before the loop
+            ctx.add_variable(name.to_string(), HirType::Vec(element.clone()));
+            return Some(format!(
+                "{}.clear(); {}.resize(({}) as usize, {});",
+                escaped_name,
+                escaped_name,
+                self.generate_expression_with_context(count, ctx),
+                Self::default_value_for_type(element)
+            ));
+        }
+        None
+    }
+
+    /// `p.push(x);` for an append `p[len++] = x;` or `p[len] = x;` to a
+    /// growth buffer.
+    pub(crate) fn generate_growth_append(
+        &self,
+        array: &HirExpression,
+        index: &HirExpression,
+        array_code: &str,
+        value_code: &str,
+        ctx: &TypeContext,
+    ) -> Option<String> {
+        let HirExpression::Variable(name) = array else {
+            return None;
+        };
+        let len = &ctx.growth_buffer(name)?.len;
+        match index {
+            HirExpression::Variable(counter) if counter == len => {
+                Some(format!("{}.push({});", array_code, value_code))
+            }
+            HirExpression::PostIncrement { operand } if is_variable(operand, len) => Some(format!(
+                "{}.push({}); {} += 1;",
+                array_code,
+                value_code,
+                self.generate_expression_with_context(operand, ctx)
+            )),
+            _ => None,
+        }
+    }
+
+    /// `p = realloc(p, size);` of a growth buffer: `Vec::push` grows it instead.
+    pub(crate) fn generate_growth_realloc(
+        target: &str,
+        value: &HirExpression,
+        ctx: &TypeContext,
+    ) -> Option<String> {
+        (ctx.growth_buffer(target).is_some() && is_realloc_of(value, target))
+            .then(|| format!("// '{}' grows in Vec::push", target))
+    }
+
+    /// A whole growth check, when nothing but the check reads the capacity.
+    pub(crate) fn generate_growth_check(
+        then_block: &[HirStatement],
+        ctx: &TypeContext,
+    ) -> Option<String> {
+        then_block.iter().find_map(|stmt| match stmt {
+            HirStatement::Assignment { target, value }
+                if ctx.growth_buffer(target).is_some_and(|growth| growth.drop_checks) =>
+            {
+                Self::generate_growth_realloc(target, value, ctx)
+            }
+            _ => None,
+        })
+    }
+
+    /// The comment replacing `free(p)` of a scratch buffer inside its loop.
+    pub(crate) fn generate_scratch_free(expr: &HirExpression, ctx: &TypeContext) -> Option<String> {
+        match expr {
+            HirExpression::FunctionCall { function, arguments } if function == "free" => {
+                match arguments.as_slice() {
+                    [HirExpression::Variable(name)] if ctx.is_scratch_buffer(name) => {
+                        Some(format!("// '{}' is reused by the next iteration", name))
+                    }
+                    _ => None,
+                }
+            }
+            _ => None,
+        }
+    }
+
+    /// Generate a loop whose body allocates and frees scratch buffers, with
+    /// the buffers declared once ahead of it.
+    pub(crate) fn generate_loop_with_scratch_buffers(
+        &self,
+        body: &[HirStatement],
+        ctx: &mut TypeContext,
+        generate_loop: impl FnOnce(&mut TypeContext) -> String,
+    ) -> String {
+        let hoisted: Vec<(&str, &HirType)> = scratch_buffers(body)
+            .into_iter()
+            .filter(|(name, _)| ctx.get_type(name).is_none() && !ctx.is_global(name))
+            .collect();
+        let mut code = String::new();
+        for (name, element) in &hoisted {
+            let vec_type = HirType::Vec(Box::new((*element).clone()));
+            code.push_str(&format!(
+                "let mut {}: {} = Vec::new();\n",
+                escape_rust_keyword(name),
+                Self::map_type(&vec_type)
+            ));
+            ctx.add_scratch_buffer(name.to_string());
+        }
+        code.push_str(&generate_loop(ctx));
+        for (name, _) in &hoisted {
+            ctx.remove_scratch_buffer(name);
+        }
+        code
+    }
+}
+
+fn is_variable(expr: &HirExpression, name: &str) -> bool {
+    matches!(expr, HirExpression::Variable(v) if v == name)
+}
+
+fn strip_casts(expr: &HirExpression) -> &HirExpression {
+    match expr {
+        HirExpression::Cast { expr, .. } => strip_casts(expr),
+        other => other,
+    }
+}
+
+/// `count` in `count * sizeof(T)` or `sizeof(T) * count` for an allocation
+/// assigned to `buffer`.
+fn element_count<'a>(size: &'a HirExpression, buffer: &str) -> Option<&'a HirExpression> {
+    match size {
+        HirExpression::BinaryOp { op: BinaryOperator::Multiply, left, right } => {
+            if is_element_size(right, buffer) {
+                Some(left)
+            } else if is_element_size(left, buffer) {
+                Some(right)
+            } else {
+                None
+            }
+        }
+        _ => None,
+    }
+}
+
+/// `sizeof(T)`, or the operand of `sizeof *buffer` / `sizeof buffer[0]`,
+/// which the parser leaves as the bare expression when it has no parentheses.
+fn is_element_size(expr: &HirExpression, buffer: &str) -> bool {
+    match expr {
+        HirExpression::Sizeof { .. } => true,
+        HirExpression::Dereference(inner) => is_variable(inner, buffer),
+        HirExpression::ArrayIndex { array, index } => {
+            is_variable(array, buffer) && matches!(**index, HirExpression::IntLiteral(0))
+        }
+        _ => false,
+    }
+}
+
+/// How a growth buffer starts: `Some(None)` when NULL, `Some(Some(count))`
+/// for `malloc(count * sizeof(T))`.
+fn growth_start<'a>(init: &'a HirExpression, buffer: &str) -> Option<Option<&'a HirExpression>> {
+    match strip_casts(init) {
+        HirExpression::NullLiteral | HirExpression::IntLiteral(0) => Some(None),
+        HirExpression::FunctionCall { function, arguments } if function == "malloc" => {
+            match arguments.as_slice() {
+                [size] => element_count(size, buffer).map(Some),
+                _ => None,
+            }
+        }
+        _ => None,
+    }
+}
+
+/// `p = realloc(p, size)`, through casts.
+fn is_realloc_of(value: &HirExpression, buffer: &str) -> bool {
+    matches!(
+        strip_casts(value),
+        HirExpression::FunctionCall { function, arguments }
+            if function == "realloc"
+                && arguments.len() == 2
+                && is_variable(&arguments[0], buffer)
+    )
+}
+
+/// Whether the size of the `malloc`/`realloc` in `alloc` is measured by
+/// `sizeof *buffer`, a read of `buffer` that only sizes an element.
+fn measures_element(alloc: &HirExpression, buffer: &str) -> bool {
+    let size = match strip_casts(alloc) {
+        HirExpression::FunctionCall { function, arguments } => {
+            match (function.as_str(), arguments.as_slice()) {
+                ("malloc", [size]) | ("realloc", [_, size]) => size,
+                _ => return false,
+            }
+        }
+        _ => return false,
+    };
+    match size {
+        HirExpression::BinaryOp { op: BinaryOperator::Multiply, left, right } => {
+            [left, right].into_iter().any(|side| {
+                matches!(side.as_ref(), HirExpression::Dereference(inner) if is_variable(inner, buffer))
+            })
+        }
+        _ => false,
+    }
+}
+
+fn is_increment_of(stmt: &HirStatement, counter: &str) -> bool {
+    match stmt {
+        HirStatement::Assignment {
+            target,
+            value: HirExpression::BinaryOp { op: BinaryOperator::Add, left, right },
+        } => {
+            target == counter
+                && is_variable(left, counter)
+                && matches!(**right, HirExpression::IntLiteral(1))
+        }
+        HirStatement::Expression(
+            HirExpression::PostIncrement { operand } | HirExpression::PreIncrement { operand },
+        ) => is_variable(operand, counter),
+        _ => false,
+    }
+}
+
+/// Decide whether `buffer` is used only as a dynamic array appended at one
+/// counter and grown by checked reallocs.
+fn growth_buffer(buffer: &str, body: &[HirStatement]) -> Option<GrowthBuffer> {
+    let mut scan = GrowthScan::new(buffer);
+    walk_statements(&mut scan, body);
+    if !scan.valid
+        || scan.uses != scan.contained
+        || scan.declarations != 1
+        || scan.checks.is_empty()
+        || scan.reallocs != scan.checked_reallocs
+    {
+        return None;
+    }
+
+    // Every append must use the same counter, compared against one capacity
+    let (_, left, right) = scan.checks.first()?;
+    let len = scan
+        .append_counters
+        .first()
+        .or_else(|| scan.bare_writes.iter().find(|c| *c == left || *c == right))?
+        .as_str();
+    if scan.append_counters.iter().any(|c| c != len) {
+        return None;
+    }
+    let mut caps = scan.checks.iter().map(|(op, left, right)| match op {
+        BinaryOperator::Equal if left == len => Some(right),
+        BinaryOperator::Equal | BinaryOperator::LessEqual if right == len => Some(left),
+        BinaryOperator::GreaterEqual if left == len => Some(right),
+        _ => None,
+    });
+    let cap = caps.next()??;
+    if caps.any(|c| c != Some(cap)) || cap == len || cap == buffer || len == buffer {
+        return None;
+    }
+
+    // A bare `p[len] = x;` appends only when `len++` follows it
+    let paired = paired_appends(body, buffer, len);
+    if scan.bare_writes.iter().filter(|c| *c == len).count() != paired {
+        return None;
+    }
+
+    // `len` starts at zero and changes only with the appends
+    let starts_empty = body.iter().any(|stmt| {
+        matches!(
+            stmt,
+            HirStatement::VariableDeclaration {
+                name,
+                initializer: Some(HirExpression::IntLiteral(0)),
+                ..
+            } if name == len
+        )
+    });
+    let mut counter = CounterWrites { var: len, writes: 0, declarations: 0, address_taken: false };
+    walk_statements(&mut counter, body);
+    if paired + scan.append_counters.len() == 0
+        || !starts_empty
+        || counter.address_taken
+        || counter.declarations != 1
+        || counter.writes != scan.append_counters.len() + paired
+    {
+        return None;
+    }
+
+    // Growth checks can go when nothing else reads the capacity
+    let mut cap_reads = Reads { var: cap, count: 0 };
+    walk_statements(&mut cap_reads, body);
+    let mut decl_reads = Reads { var: cap, count: 0 };
+    let decl = body.iter().filter(
+        |stmt| matches!(stmt, HirStatement::VariableDeclaration { name, .. } if name == buffer),
+    );
+    walk_statements(&mut decl_reads, &decl.cloned().collect::<Vec<_>>());
+    let drop_checks = cap_reads.count == scan.cap_reads_in_checks(cap) + decl_reads.count;
+
+    Some(GrowthBuffer { len: len.to_string(), drop_checks })
+}
+
+/// Count `p[len] = x;` statements directly followed by `len++`.
+fn paired_appends(stmts: &[HirStatement], buffer: &str, len: &str) -> usize {
+    let pairs = stmts
+        .windows(2)
+        .filter(|pair| match &pair[0] {
+            HirStatement::ArrayIndexAssignment { array, index, .. } => {
+                is_variable(array, buffer)
+                    && is_variable(index, len)
+                    && is_increment_of(&pair[1], len)
+            }
+            _ => false,
+        })
+        .count();
+    let nested: usize = stmts
+        .iter()
+        .map(|stmt| match stmt {
+            HirStatement::If { then_block, else_block, .. } => {
+                paired_appends(then_block, buffer, len)
+                    + else_block.as_deref().map_or(0, |b| paired_appends(b, buffer, len))
+            }
+            HirStatement::While { body, .. } => paired_appends(body, buffer, len),
+            HirStatement::For { body, .. } => paired_appends(body, buffer, len),
+            HirStatement::Switch { cases, default_case, .. } => {
+                cases.iter().map(|case| paired_appends(&case.body, buffer, len)).sum::<usize>()
+                    + default_case.as_deref().map_or(0, |b| paired_appends(b, buffer, len))
+            }
+            _ => 0,
+        })
+        .sum();
+    pairs + nested
+}
+
+/// The direct `T* p = malloc(n * sizeof(T))` declarations of a loop body
+/// that the same body frees and never rebinds.
+fn scratch_buffers(body: &[HirStatement]) -> Vec<(&str, &HirType)> {
+    body.iter()
+        .enumerate()
+        .filter_map(|(i, stmt)| {
+            let HirStatement::VariableDeclaration {
+                name,
+                var_type: HirType::Pointer(element),
+                initializer: Some(init),
+            } = stmt
+            else {
+                return None;
+            };
+            let plain = matches!(
+                **element,
+                HirType::Bool
+                    | HirType::Int
+                    | HirType::UnsignedInt
+                    | HirType::Float
+                    | HirType::Double
+                    | HirType::Char
+                    | HirType::SignedChar
+            );
+            let freed = body[i + 1..].iter().any(|stmt| match stmt {
+                HirStatement::Free { pointer } => is_variable(pointer, name),
+                HirStatement::Expression(HirExpression::FunctionCall { function, arguments }) => {
+                    function == "free"
+                        && matches!(arguments.as_slice(), [arg] if is_variable(arg, name))
+                }
+                _ => false,
+            });
+            let mut bindings =
+                CounterWrites { var: name, writes: 0, declarations: 0, address_taken: false };
+            walk_statements(&mut bindings, body);
+            let bound_once =
+                bindings.declarations == 1 && bindings.writes == 0 && !bindings.address_taken;
+            (plain && freed && bound_once && scratch_count(init, name).is_some())
+                .then_some((name.as_str(), element.as_ref()))
+        })
+        .collect()
+}
+
+/// Element count of `malloc(n * sizeof(T))` or `calloc(n, size)` assigned
+/// to `buffer`.
+fn scratch_count<'a>(init: &'a HirExpression, buffer: &str) -> Option<&'a HirExpression> {
+    match strip_casts(init) {
+        HirExpression::FunctionCall { function, arguments } => {
+            match (function.as_str(), arguments.as_slice()) {
+                ("malloc", [size]) => element_count(size, buffer),
+                ("calloc", [count, _]) => Some(count),
+                _ => None,
+            }
+        }
+        _ => None,
+    }
+}
+
+/// Classifies every use of a candidate growth buffer.
+struct GrowthScan<'a> {
+    buffer: &'a str,
+    uses: usize,
+    contained: usize,
+    declarations: usize,
+    /// Counters of `p[c++] = x;` and `p[c] = x; c++;` appends
+    append_counters: Vec<String>,
+    /// Bare variable indices written, `p[c] = x;`
+    bare_writes: Vec<String>,
+    reallocs: usize,
+    checked_reallocs: usize,
+    /// `(op, left, right)` of each growth check condition
+    checks: Vec<(BinaryOperator, String, String)>,
+    /// The growth checks, for counting capacity reads
+    check_stmts: Vec<HirStatement>,
+    valid: bool,
+}
+
+impl<'a> GrowthScan<'a> {
+    fn new(buffer: &'a str) -> Self {
+        Self {
+            buffer,
+            uses: 0,
+            contained: 0,
+            declarations: 0,
+            append_counters: Vec::new(),
+            bare_writes: Vec::new(),
+            reallocs: 0,
+            checked_reallocs: 0,
+            checks: Vec::new(),
+            check_stmts: Vec::new(),
+            valid: true,
+        }
+    }
+
+    fn cap_reads_in_checks(&self, cap: &str) -> usize {
+        let mut reads = Reads { var: cap, count: 0 };
+        walk_statements(&mut reads, &self.check_stmts);
+        reads.count
+    }
+
+    /// `if (len == cap) { cap = ...; p = realloc(p, ...); }`
+    fn growth_check(&mut self, condition: &HirExpression, then_block: &[HirStatement]) {
+        let buffer = self.buffer;
+        let realloc = |stmt: &HirStatement| matches!(stmt, HirStatement::Assignment { target, value } if target == buffer && is_realloc_of(value, buffer));
+        let check = match condition {
+            HirExpression::BinaryOp {
+                op:
+                    op @ (BinaryOperator::Equal
+                    | BinaryOperator::GreaterEqual
+                    | BinaryOperator::LessEqual),
+                left,
+                right,
+            } => match (left.as_ref(), right.as_ref()) {
+                (HirExpression::Variable(l), HirExpression::Variable(r)) => {
+                    Some((*op, l.clone(), r.clone()))
+                }
+                _ => None,
+            },
+            _ => None,
+        };
+        let Some(check) = check else {
+            self.valid = false;
+            return;
+        };
+        // Only capacity updates may accompany the realloc
+        let cap_updates = then_block.iter().all(|stmt| {
+            realloc(stmt)
+                || matches!(stmt, HirStatement::Assignment { target, .. }
+                    if *target == check.1 || *target == check.2)
+        });
+        self.valid &= cap_updates;
+        self.checked_reallocs += then_block.iter().filter(|stmt| realloc(stmt)).count();
+        self.checks.push(check);
+        self.check_stmts.push(HirStatement::If {
+            condition: condition.clone(),
+            then_block: then_block.to_vec(),
+            else_block: None,
+        });
+    }
+}
+
+impl Visitor for GrowthScan<'_> {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        let buffer = self.buffer;
+        match stmt {
+            HirStatement::VariableDeclaration { name, initializer, .. } if name == buffer => {
+                self.declarations += 1;
+                self.contained += usize::from(initializer.as_ref().is_some_and(|init| {
+                    measures_element(init, buffer)
+                }));
+            }
+            HirStatement::Assignment { target, value } if target == buffer => {
+                self.valid &= is_realloc_of(value, buffer);
+                self.reallocs += 1;
+                self.contained += 1 + usize::from(measures_element(value, buffer));
+            }
+            HirStatement::ArrayIndexAssignment { array, index, .. } if is_variable(array, buffer) => {
+                self.contained += 1;
+                match index.as_ref() {
+                    HirExpression::PostIncrement { operand } => match operand.as_ref() {
+                        HirExpression::Variable(counter) => {
+                            self.append_counters.push(counter.clone())
+                        }
+                        _ => self.valid = false,
+                    },
+                    HirExpression::Variable(counter) => self.bare_writes.push(counter.clone()),
+                    _ => {}
+                }
+            }
+            HirStatement::If { condition, then_block, else_block }
+                if then_block.iter().any(|stmt| {
+                    matches!(stmt, HirStatement::Assignment { target, .. } if target == buffer)
+                }) =>
+            {
+                if else_block.is_some() {
+                    self.valid = false;
+                } else {
+                    self.growth_check(condition, then_block);
+                }
+            }
+            HirStatement::Free { pointer } => self.contained += usize::from(is_variable(pointer, buffer)),
+            HirStatement::Expression(HirExpression::FunctionCall { function, arguments })
+                if function == "free" =>
+            {
+                self.contained +=
+                    usize::from(matches!(arguments.as_slice(), [arg] if is_variable(arg, buffer)));
+            }
+            _ => {}
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        match expr {
+            HirExpression::Variable(name) => self.uses += usize::from(name == self.buffer),
+            HirExpression::ArrayIndex { array, .. } => {
+                self.contained += usize::from(is_variable(array, self.buffer))
+            }
+            _ => {}
+        }
+    }
+}
+
+/// Counts the declarations of a local and the writes that change it.
+struct CounterWrites<'a> {
+    var: &'a str,
+    writes: usize,
+    declarations: usize,
+    address_taken: bool,
+}
+
+impl Visitor for CounterWrites<'_> {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        match stmt {
+            HirStatement::VariableDeclaration { name, .. } => {
+                self.declarations += usize::from(name == self.var)
+            }
+            HirStatement::Assignment { target, .. } => {
+                self.writes += usize::from(target == self.var)
+            }
+            _ => {}
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        match expr {
+            HirExpression::PostIncrement { operand }
+            | HirExpression::PreIncrement { operand }
+            | HirExpression::PostDecrement { operand }
+            | HirExpression::PreDecrement { operand } => {
+                self.writes += usize::from(is_variable(operand, self.var))
+            }
+            HirExpression::UnaryOp { op, operand } => match op {
+                UnaryOperator::PostIncrement
+                | UnaryOperator::PreIncrement
+                | UnaryOperator::PostDecrement
+                | UnaryOperator::PreDecrement => {
+                    self.writes += usize::from(is_variable(operand, self.var))
+                }
+                UnaryOperator::AddressOf => self.address_taken |= is_variable(operand, self.var),
+                _ => {}
+            },
+            HirExpression::AddressOf(inner) => self.address_taken |= is_variable(inner, self.var),
+            _ => {}
+        }
+    }
+}
+
+/// Counts the reads of a variable.
+struct Reads<'a> {
+    var: &'a str,
+    count: usize,
+}
+
+impl Visitor for Reads<'_> {
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        self.count += usize::from(is_variable(expr, self.var));
+    }
+}
@@ -302,7 +302,7 @@ fn expr_variable_errno() {
     let gen = CodeGenerator::new();
     assert_eq!(
         gen.generate_expression(&HirExpression::Variable("errno".to_string())),
-        "unsafe { ERRNO }"
+        "ERRNO.get()"
     );
 }
 
@@ -1517,8 +1517,7 @@ fn stmt_assignment_errno() {
         target: "errno".to_string(),
         value: HirExpression::IntLiteral(22),
     });
-    assert!(result.contains("unsafe"));
-    assert!(result.contains("ERRNO"));
+    assert!(result.contains("ERRNO.set(22)"));
 }
 
 // ============================================================================
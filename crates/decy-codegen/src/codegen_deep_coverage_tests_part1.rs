@@ -1467,8 +1467,7 @@ fn stmt_assignment_errno() {
         value: HirExpression::IntLiteral(0),
     };
     let code = cg.generate_statement_with_context(&stmt, None, &mut ctx, None);
-    assert!(code.contains("unsafe"));
-    assert!(code.contains("ERRNO"));
+    assert!(code.contains("ERRNO.set(0)"));
 }
 
 // ============================================================================
@@ -1723,7 +1722,7 @@ fn expression_compares_to_null_eq_zero() {
         left: Box::new(HirExpression::Variable("ptr".to_string())),
         right: Box::new(HirExpression::IntLiteral(0)),
     };
-    assert!(cg.expression_compares_to_null(&expr, "ptr"));
+    assert!(decy_ownership::raw_pointer::expression_compares_to_null(&expr, "ptr"));
 }
 
 #[test]
@@ -1734,7 +1733,7 @@ fn expression_compares_to_null_ne_null() {
         left: Box::new(HirExpression::Variable("ptr".to_string())),
         right: Box::new(HirExpression::NullLiteral),
     };
-    assert!(cg.expression_compares_to_null(&expr, "ptr"));
+    assert!(decy_ownership::raw_pointer::expression_compares_to_null(&expr, "ptr"));
 }
 
 #[test]
@@ -1745,7 +1744,7 @@ fn expression_compares_to_null_different_var() {
         left: Box::new(HirExpression::Variable("other".to_string())),
         right: Box::new(HirExpression::IntLiteral(0)),
     };
-    assert!(!cg.expression_compares_to_null(&expr, "ptr"));
+    assert!(!decy_ownership::raw_pointer::expression_compares_to_null(&expr, "ptr"));
 }
 
 // ============================================================================
@@ -951,8 +951,8 @@ fn expr_context_qsort_with_args() {
     };
     let code = cg.generate_expression_with_context(&expr, &mut ctx);
     assert!(
-        code.contains("sort_by") && code.contains("compare"),
-        "qsort → sort_by: {}",
+        code.contains("sort_unstable_by") && code.contains("compare"),
+        "qsort → sort_unstable_by: {}",
         code
     );
 }
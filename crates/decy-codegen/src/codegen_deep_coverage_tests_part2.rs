@@ -282,7 +282,7 @@ fn stdlib_sprintf_invalid_args() {
 }
 
 #[test]
-fn stdlib_qsort_generates_sort_by() {
+fn stdlib_qsort_generates_sort_unstable_by() {
     let cg = CodeGenerator::new();
     let expr = HirExpression::FunctionCall {
         function: "qsort".to_string(),
@@ -298,8 +298,8 @@ fn stdlib_qsort_generates_sort_by() {
     };
     let code = cg.generate_expression(&expr);
     assert!(
-        code.contains("sort_by"),
-        "qsort should generate sort_by, got: {}",
+        code.contains("sort_unstable_by"),
+        "qsort should generate sort_unstable_by, got: {}",
         code
     );
 }
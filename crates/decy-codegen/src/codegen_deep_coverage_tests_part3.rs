@@ -1201,7 +1201,7 @@ fn expr_function_call_qsort() {
     let code = cg.generate_expression(&expr);
     assert!(
         code.contains("sort") || code.contains("arr"),
-        "qsort should generate sort_by, got: {}",
+        "qsort should generate sort_unstable_by, got: {}",
         code
     );
 }
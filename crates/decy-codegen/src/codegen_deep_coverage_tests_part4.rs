@@ -674,18 +674,14 @@ fn expr_char_literal_minus_int_reversed() {
 
 #[test]
 fn stmt_errno_assignment() {
-    // C: errno = EACCES; → unsafe { ERRNO = EACCES; }
+    // C: errno = EACCES; → ERRNO.set(13i32);
     let cg = CodeGenerator::new();
     let stmt = HirStatement::Assignment {
         target: "errno".to_string(),
         value: HirExpression::Variable("EACCES".to_string()),
     };
     let code = cg.generate_statement(&stmt);
-    assert!(
-        code.contains("unsafe") && code.contains("ERRNO"),
-        "Errno assignment should use unsafe ERRNO, got: {}",
-        code
-    );
+    assert!(code.contains("ERRNO.set("), "Errno assignment should set ERRNO, got: {}", code);
 }
 
 #[test]
@@ -1854,7 +1854,7 @@ fn null_comparison_reversed_zero_eq_var() {
         else_block: None,
     };
     assert!(
-        cg.statement_uses_null_comparison(&stmt, "ptr"),
+        decy_ownership::raw_pointer::statement_compares_to_null(&stmt, "ptr"),
         "0 == ptr should be detected as null comparison"
     );
 }
@@ -1872,7 +1872,7 @@ fn null_comparison_null_neq_var() {
         else_block: None,
     };
     assert!(
-        cg.statement_uses_null_comparison(&stmt, "ptr"),
+        decy_ownership::raw_pointer::statement_compares_to_null(&stmt, "ptr"),
         "NULL != ptr should be detected as null comparison"
     );
 }
@@ -1894,7 +1894,7 @@ fn pointer_arithmetic_linked_list_traversal() {
         },
     };
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "head"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "head"),
         "head = head->next should be detected as pointer arithmetic"
     );
 }
@@ -11,7 +11,7 @@ fn pointer_arithmetic_other_field_access() {
         },
     };
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "ptr"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "ptr"),
         "ptr = other->data should be detected as pointer arithmetic"
     );
 }
@@ -24,7 +24,7 @@ fn pointer_arithmetic_post_increment_in_expression() {
         operand: Box::new(HirExpression::Variable("str".to_string())),
     });
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "str"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "str"),
         "str++ should be detected as pointer arithmetic"
     );
 }
@@ -37,7 +37,7 @@ fn pointer_arithmetic_pre_decrement_in_expression() {
         operand: Box::new(HirExpression::Variable("ptr".to_string())),
     });
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "ptr"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "ptr"),
         "--ptr should be detected as pointer arithmetic"
     );
 }
@@ -484,7 +484,7 @@ fn null_comparison_in_while_condition() {
         body: vec![],
     };
     assert!(
-        cg.statement_uses_null_comparison(&stmt, "ptr"),
+        decy_ownership::raw_pointer::statement_compares_to_null(&stmt, "ptr"),
         "While with ptr != 0 should detect null comparison"
     );
 }
@@ -504,7 +504,7 @@ fn null_comparison_in_for_condition() {
         body: vec![],
     };
     assert!(
-        cg.statement_uses_null_comparison(&stmt, "node"),
+        decy_ownership::raw_pointer::statement_compares_to_null(&stmt, "node"),
         "For with node != NULL should detect null comparison"
     );
 }
@@ -523,7 +523,7 @@ fn null_comparison_reversed_in_expression() {
         else_block: None,
     };
     assert!(
-        cg.statement_uses_null_comparison(&stmt, "ptr"),
+        decy_ownership::raw_pointer::statement_compares_to_null(&stmt, "ptr"),
         "NULL == ptr should detect null comparison"
     );
 }
@@ -544,7 +544,7 @@ fn ptr_arithmetic_field_access_reassignment() {
         },
     };
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "head"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "head"),
         "head = head->next should detect pointer arithmetic"
     );
 }
@@ -561,7 +561,7 @@ fn ptr_arithmetic_any_pointer_field_assign() {
         },
     };
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "ptr"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "ptr"),
         "ptr = other->data should detect pointer arithmetic"
     );
 }
@@ -574,7 +574,7 @@ fn ptr_arithmetic_in_expression_stmt_post_increment() {
         operand: Box::new(HirExpression::Variable("str".to_string())),
     });
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "str"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "str"),
         "str++ as expression should detect pointer arithmetic"
     );
 }
@@ -587,7 +587,7 @@ fn ptr_arithmetic_in_expression_stmt_pre_decrement() {
         operand: Box::new(HirExpression::Variable("ptr".to_string())),
     });
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "ptr"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "ptr"),
         "--ptr as expression should detect pointer arithmetic"
     );
 }
@@ -608,7 +608,7 @@ fn ptr_arithmetic_in_while_body() {
         }],
     };
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "ptr"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "ptr"),
         "ptr = ptr + 1 in while body should detect pointer arithmetic"
     );
 }
@@ -626,7 +626,7 @@ fn ptr_arithmetic_in_for_body() {
         })],
     };
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "p"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "p"),
         "p++ in for body should detect pointer arithmetic"
     );
 }
@@ -259,7 +259,7 @@ fn ptr_arithmetic_add_assignment_not_same_var() {
         },
     };
     assert!(
-        !cg.statement_uses_pointer_arithmetic(&stmt, "ptr"),
+        !decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "ptr"),
         "ptr = other + 1 should NOT detect pointer arithmetic for ptr"
     );
 }
@@ -276,7 +276,7 @@ fn ptr_arithmetic_field_access_any_pointer() {
         },
     };
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "cur"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "cur"),
         "cur = head->next should detect pointer arithmetic"
     );
 }
@@ -289,7 +289,7 @@ fn ptr_arithmetic_expression_pre_increment() {
         operand: Box::new(HirExpression::Variable("ptr".to_string())),
     });
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "ptr"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "ptr"),
         "++ptr should detect pointer arithmetic"
     );
 }
@@ -302,7 +302,7 @@ fn ptr_arithmetic_expression_post_decrement() {
         operand: Box::new(HirExpression::Variable("ptr".to_string())),
     });
     assert!(
-        cg.statement_uses_pointer_arithmetic(&stmt, "ptr"),
+        decy_ownership::raw_pointer::statement_uses_pointer_arithmetic(&stmt, "ptr"),
         "ptr-- should detect pointer arithmetic"
     );
 }
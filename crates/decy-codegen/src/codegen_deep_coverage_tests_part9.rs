@@ -85,8 +85,7 @@ fn stmt_ctx_assignment_errno_special_handling() {
         value: HirExpression::IntLiteral(0),
     };
     let result = cg.generate_statement_with_context(&stmt, None, &mut ctx, None);
-    assert!(result.contains("unsafe"), "Got: {}", result);
-    assert!(result.contains("ERRNO"), "Got: {}", result);
+    assert_eq!(result, "ERRNO.set(0);", "Got: {}", result);
 }
 
 #[test]
@@ -1739,7 +1738,7 @@ fn expr_target_sprintf_no_extra_args() {
     assert!(result.contains("format!"), "Got: {}", result);
 }
 
-// --- FunctionCall: qsort → .sort_by ---
+// --- FunctionCall: qsort → .sort_unstable_by ---
 #[test]
 fn expr_target_qsort() {
     let cg = CodeGenerator::new();
@@ -1754,7 +1753,7 @@ fn expr_target_qsort() {
         ],
     };
     let result = cg.generate_expression_with_target_type(&expr, &ctx, None);
-    assert!(result.contains("sort_by"), "Got: {}", result);
+    assert!(result.contains("sort_unstable_by"), "Got: {}", result);
     assert!(result.contains("compare"), "Got: {}", result);
 }
 
@@ -106,7 +106,7 @@ fn calloc_default_no_target() {
     };
     let result = expr_tt(&expr, &c, None);
     assert!(
-        result.contains("vec![0i32; 5 as usize]"),
+        result.contains("vec![0i32; (5) as usize]"),
         "calloc default should use vec![0i32; n], got: {}",
         result
     );
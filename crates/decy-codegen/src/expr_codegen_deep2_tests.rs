@@ -913,11 +913,11 @@ fn variable_stdout_maps_to_io_stdout() {
 }
 
 #[test]
-fn variable_errno_maps_to_unsafe_errno() {
+fn variable_errno_maps_to_errno_cell() {
     let c = ctx();
     let expr = HirExpression::Variable("errno".to_string());
     let result = expr_no_tt(&expr, &c);
-    assert_eq!(result, "unsafe { ERRNO }");
+    assert_eq!(result, "ERRNO.get()");
 }
 
 #[test]
@@ -241,7 +241,7 @@ impl CodeGenerator {
 
         if let HirExpression::Variable(var_name) = left {
             if ctx.is_pointer(var_name) {
-                if let HirExpression::IntLiteral(0) = right {
+                if let HirExpression::IntLiteral(0) | HirExpression::NullLiteral = right {
                     let op_str = Self::binary_operator_to_string(op);
                     return Some(format!("{} {} std::ptr::null_mut()", var_name, op_str));
                 }
@@ -249,7 +249,7 @@ impl CodeGenerator {
         }
         if let HirExpression::Variable(var_name) = right {
             if ctx.is_pointer(var_name) {
-                if let HirExpression::IntLiteral(0) = left {
+                if let HirExpression::IntLiteral(0) | HirExpression::NullLiteral = left {
                     let op_str = Self::binary_operator_to_string(op);
                     return Some(format!("std::ptr::null_mut() {} {}", op_str, var_name));
                 }
@@ -456,6 +456,21 @@ impl CodeGenerator {
         ctx: &TypeContext,
         target_type: Option<&HirType>,
     ) -> Option<String> {
+        // A C comparison is an int 0 or 1, as in `(x > y) - (x < y)`
+        if Self::is_boolean_expression(left) || Self::is_boolean_expression(right) {
+            let as_int = |expr: &HirExpression, code: &str| match expr {
+                e if !Self::is_boolean_expression(e) => code.to_string(),
+                HirExpression::BinaryOp { .. } => format!("({} as i32)", code),
+                _ => format!("(({}) as i32)", code),
+            };
+            return Some(format!(
+                "{} {} {}",
+                as_int(left, left_str),
+                op_str,
+                as_int(right, right_str)
+            ));
+        }
+
         if let Some(HirType::Int) = target_type {
             let left_type = ctx.infer_expression_type(left);
             let right_type = ctx.infer_expression_type(right);
@@ -1,11 +1,16 @@
 //! Function call, dereference, and unary expression generation.
 
-use super::{CodeGenerator, TypeContext};
+use super::{escape_rust_keyword, CodeGenerator, TypeContext};
+use crate::FileStream;
+use decy_analyzer::comparator_analysis::{KeyComparator, SortKey};
 use decy_hir::{BinaryOperator, HirExpression, HirType};
 
 impl CodeGenerator {
     pub(crate) fn gen_expr_dereference(&self, inner: &HirExpression, ctx: &TypeContext) -> String {
         if let HirExpression::Variable(var_name) = inner {
+            if let Some(byte) = ctx.walked_byte(var_name) {
+                return byte.to_string();
+            }
             if let Some(idx_var) = ctx.get_string_iter_index(var_name) {
                 return format!("{}[{}]", var_name, idx_var);
             }
@@ -19,6 +24,13 @@ impl CodeGenerator {
 
         if let HirExpression::PostIncrement { operand } = inner {
             if let HirExpression::Variable(var_name) = &**operand {
+                // DECY-134: *ptr++ on a string iteration param reads and steps the index
+                if let Some(idx_var) = ctx.get_string_iter_index(var_name) {
+                    return format!(
+                        "{{ let __c = {}[{}]; {} += 1; __c }}",
+                        var_name, idx_var, idx_var
+                    );
+                }
                 if let Some(var_type) = ctx.get_type(var_name) {
                     if matches!(var_type, HirType::StringReference | HirType::StringLiteral) {
                         return self.generate_expression_with_context(inner, ctx);
@@ -58,6 +70,18 @@ impl CodeGenerator {
         ctx: &TypeContext,
     ) -> String {
         use decy_hir::UnaryOperator;
+        let step = match op {
+            UnaryOperator::PostIncrement => Some((true, false)),
+            UnaryOperator::PreIncrement => Some((true, true)),
+            UnaryOperator::PostDecrement => Some((false, false)),
+            UnaryOperator::PreDecrement => Some((false, true)),
+            _ => None,
+        };
+        if let Some(code) = step.and_then(|(increment, prefix)| {
+            Self::generate_atomic_global_step(operand, ctx, increment, prefix)
+        }) {
+            return code;
+        }
         match op {
             UnaryOperator::PostIncrement => {
                 let operand_code = self.generate_expression_with_context(operand, ctx);
@@ -130,9 +154,15 @@ impl CodeGenerator {
         ctx: &TypeContext,
         target_type: Option<&HirType>,
     ) -> String {
+        if let Some(targets) = ctx.dispatch_targets(function) {
+            return self.gen_call_dispatch(function, targets, arguments, ctx, target_type);
+        }
         match function {
             "strlen" => self.gen_call_strlen(function, arguments, ctx),
             "strcpy" => self.gen_call_strcpy(function, arguments, ctx),
+            "memcpy" | "memmove" | "memset" | "memcmp" | "memchr" | "strchr" => self
+                .gen_call_slice_op(function, arguments, ctx)
+                .unwrap_or_else(|| self.gen_call_default(function, arguments, ctx)),
             "malloc" => self.gen_call_malloc(arguments, ctx, target_type),
             "calloc" => self.gen_call_calloc(arguments, ctx, target_type),
             "realloc" => self.gen_call_realloc(arguments, ctx, target_type),
@@ -146,6 +176,7 @@ impl CodeGenerator {
             "fread" => self.gen_call_fread(arguments, ctx),
             "fwrite" => self.gen_call_fwrite(arguments, ctx),
             "fputs" => self.gen_call_fputs(arguments, ctx),
+            "fflush" => self.gen_call_fflush(arguments, ctx),
             "fork" => "/* fork() transformed to Command API */ 0".to_string(),
             "execl" | "execlp" | "execle" | "execv" | "execvp" | "execve" => {
                 self.gen_call_exec(arguments, ctx)
@@ -176,12 +207,29 @@ impl CodeGenerator {
                 }
             }
             "exit" => {
-                if arguments.len() == 1 {
+                let exit = if arguments.len() == 1 {
                     let code = self.generate_expression_with_context(&arguments[0], ctx);
                     format!("std::process::exit({})", code)
                 } else {
                     "std::process::exit(1)".to_string()
-                }
+                };
+                Self::flush_stdout_before(exit, ctx)
+            }
+            "puts" if ctx.has_buffered_stdout() => {
+                let mut lets = String::new();
+                let line = match arguments {
+                    [s] => format!("\"{{}}\", {}", self.stdout_write_arg(s, ctx, &mut lets)),
+                    _ => "\"\"".to_string(),
+                };
+                format!("{{ {}let _ = writeln!(__stdout, {}); }}", lets, line)
+            }
+            "putchar" if ctx.has_buffered_stdout() && arguments.len() == 1 => {
+                let mut lets = String::new();
+                let c = self.stdout_write_arg(&arguments[0], ctx, &mut lets);
+                format!(
+                    "{{ {}__stdout.write_all(&[({}) as u8]).map_or(-1, |_| ({}) as i32) }}",
+                    lets, c, c
+                )
             }
             "puts" => {
                 if arguments.len() == 1 {
@@ -193,17 +241,58 @@ impl CodeGenerator {
             }
             "snprintf" => self.gen_call_snprintf(arguments, ctx),
             "sprintf" => self.gen_call_sprintf(arguments, ctx),
-            "qsort" => {
-                if arguments.len() == 4 {
-                    let base = self.generate_expression_with_context(&arguments[0], ctx);
-                    let n = self.generate_expression_with_context(&arguments[1], ctx);
-                    let cmp = self.generate_expression_with_context(&arguments[3], ctx);
-                    format!("{}[..{} as usize].sort_by(|a, b| {}(a, b))", base, n, cmp)
+            "qsort" => self.gen_call_qsort(arguments, ctx),
+            "bsearch" => self.gen_call_bsearch(arguments, ctx),
+            // Unknown callees may print or read stdin themselves
+            _ => {
+                let call = self.gen_call_default(function, arguments, ctx);
+                if self.quiet.is_quiet(function) {
+                    call
                 } else {
-                    "/* qsort requires 4 args */".to_string()
+                    Self::flush_stdout_before(call, ctx)
                 }
             }
-            _ => self.gen_call_default(function, arguments, ctx),
+        }
+    }
+
+    /// Code for an argument of a write to the buffered `__stdout`.
+    ///
+    /// A call is evaluated into a temporary in `lets` first, as C does before
+    /// the write: a callee that may print flushes `__stdout`, which cannot be
+    /// borrowed again inside the `write!` that already borrows it.
+    fn stdout_write_arg(
+        &self,
+        arg: &HirExpression,
+        ctx: &TypeContext,
+        lets: &mut String,
+    ) -> String {
+        let code = self.generate_expression_with_context(arg, ctx);
+        let is_call = matches!(arg, HirExpression::FunctionCall { .. });
+        if !ctx.has_buffered_stdout() || !(is_call || code.contains("__stdout")) {
+            return code;
+        }
+        let temp = format!("__arg{}", lets.matches("let ").count());
+        lets.push_str(&format!("let {} = {}; ", temp, code));
+        temp
+    }
+
+    /// Flush the function's buffered stdout before `code` when one is active.
+    fn flush_stdout_before(code: String, ctx: &TypeContext) -> String {
+        if ctx.has_buffered_stdout() {
+            format!("{{ let _ = __stdout.flush(); {} }}", code)
+        } else {
+            code
+        }
+    }
+
+    /// Code for a `FILE*` argument; `stdout` goes to the function's buffered
+    /// writer when one is active.
+    fn stream_target(&self, stream: &HirExpression, ctx: &TypeContext) -> String {
+        match stream {
+            HirExpression::Variable(name) if name == "stdout" && ctx.has_buffered_stdout() => {
+                "__stdout".to_string()
+            }
+            _ => self.generate_expression_with_context(stream, ctx),
         }
     }
 
@@ -214,6 +303,9 @@ impl CodeGenerator {
         ctx: &TypeContext,
     ) -> String {
         if arguments.len() == 1 {
+            if let Some(code) = self.gen_byte_strlen(&arguments[0], ctx) {
+                return code;
+            }
             format!("{}.len() as i32", self.generate_expression_with_context(&arguments[0], ctx))
         } else {
             let args: Vec<String> = arguments
@@ -328,19 +420,19 @@ impl CodeGenerator {
 
             if let Some(HirType::Vec(elem_type)) = target_type {
                 let default_val = Self::default_value_for_type(elem_type);
-                return format!("vec![{}; {} as usize]", default_val, count_code);
+                return format!("vec![{}; ({}) as usize]", default_val, count_code);
             }
 
             if let Some(HirType::Pointer(inner)) = target_type {
                 let elem_type_str = Self::map_type(inner);
                 let default_val = Self::default_value_for_type(inner);
                 return format!(
-                    "Box::leak(vec![{}; {} as usize].into_boxed_slice()).as_mut_ptr() as *mut {}",
+                    "Box::leak(vec![{}; ({}) as usize].into_boxed_slice()).as_mut_ptr() as *mut {}",
                     default_val, count_code, elem_type_str
                 );
             }
 
-            format!("vec![0i32; {} as usize]", count_code)
+            format!("vec![0i32; ({}) as usize]", count_code)
         } else {
             "Vec::new()".to_string()
         }
@@ -377,9 +469,65 @@ impl CodeGenerator {
         }
     }
 
+    /// Stream direction `fopen` opens for a literal mode string.
+    ///
+    /// Read/write (`+`) modes and non-literal modes return `None` and keep the
+    /// unbuffered `File` lowering.
+    pub(crate) fn fopen_stream(arguments: &[HirExpression]) -> Option<FileStream> {
+        match arguments {
+            [_, HirExpression::StringLiteral(mode)] if !mode.contains('+') => {
+                match mode.chars().next()? {
+                    'r' => Some(FileStream::Reader),
+                    'w' | 'a' => Some(FileStream::Writer),
+                    _ => None,
+                }
+            }
+            _ => None,
+        }
+    }
+
+    /// Generated handle name and direction when `expr` is a local holding a
+    /// buffered `fopen` stream.
+    fn known_file_stream(
+        &self,
+        expr: &HirExpression,
+        ctx: &TypeContext,
+    ) -> Option<(String, FileStream)> {
+        match expr {
+            HirExpression::Variable(name) => ctx
+                .get_file_stream(name)
+                .map(|stream| (self.generate_expression_with_context(expr, ctx), stream)),
+            _ => None,
+        }
+    }
+
+    /// Run `body` (using `__w`) against a buffered writer handle, yielding
+    /// `fallback` when the handle is `None`.
+    fn with_stream_writer(handle: &str, fallback: &str, body: &str) -> String {
+        format!(
+            "{}.as_mut().map_or({}, |__w| {{ use std::io::Write; {} }})",
+            handle, fallback, body
+        )
+    }
+
     pub(crate) fn gen_call_fopen(&self, arguments: &[HirExpression], ctx: &TypeContext) -> String {
         if arguments.len() == 2 {
             let filename = self.generate_expression_with_context(&arguments[0], ctx);
+            match Self::fopen_stream(arguments) {
+                Some(FileStream::Reader) => {
+                    return format!(
+                        "std::fs::File::open({}).ok().map(std::io::BufReader::new)",
+                        filename
+                    );
+                }
+                Some(FileStream::Writer) => {
+                    return format!(
+                        "std::fs::File::create({}).ok().map(std::io::BufWriter::new)",
+                        filename
+                    );
+                }
+                None => {}
+            }
             let mode = self.generate_expression_with_context(&arguments[1], ctx);
             if mode.contains('w') || mode.contains('a') {
                 format!("std::fs::File::create({}).ok()", filename)
@@ -393,20 +541,67 @@ impl CodeGenerator {
 
     pub(crate) fn gen_call_fclose(&self, arguments: &[HirExpression], ctx: &TypeContext) -> String {
         if arguments.len() == 1 {
-            let file_code = self.generate_expression_with_context(&arguments[0], ctx);
-            format!("drop({})", file_code)
+            // Buffered writers must flush before closing to surface write errors
+            match self.known_file_stream(&arguments[0], ctx) {
+                Some((handle, FileStream::Writer)) => format!(
+                    "{}.take().map_or(-1, |mut __w| {{ use std::io::Write; __w.flush().map_or(-1, |_| 0) }})",
+                    handle
+                ),
+                Some((handle, FileStream::Reader)) => format!("{}.take().map_or(-1, |_| 0)", handle),
+                None => {
+                    let file_code = self.generate_expression_with_context(&arguments[0], ctx);
+                    format!("drop({})", file_code)
+                }
+            }
         } else {
             "/* fclose() */".to_string()
         }
     }
 
+    pub(crate) fn gen_call_fflush(&self, arguments: &[HirExpression], ctx: &TypeContext) -> String {
+        match arguments {
+            [stream] => {
+                if let Some((handle, stream)) = self.known_file_stream(stream, ctx) {
+                    return match stream {
+                        FileStream::Writer => {
+                            Self::with_stream_writer(&handle, "-1", "__w.flush().map_or(-1, |_| 0)")
+                        }
+                        FileStream::Reader => "0".to_string(),
+                    };
+                }
+                let is_stdout = matches!(stream, HirExpression::NullLiteral)
+                    || matches!(stream, HirExpression::Variable(name) if name == "stdout");
+                if is_stdout && ctx.has_buffered_stdout() {
+                    "__stdout.flush().map_or(-1, |_| 0)".to_string()
+                } else if is_stdout {
+                    "{ use std::io::Write; std::io::stdout().flush().map_or(-1, |_| 0) }"
+                        .to_string()
+                } else {
+                    let file_code = self.generate_expression_with_context(stream, ctx);
+                    format!("{{ use std::io::Write; {}.flush().map_or(-1, |_| 0) }}", file_code)
+                }
+            }
+            _ => "-1 /* fflush requires 1 arg */".to_string(),
+        }
+    }
+
     pub(crate) fn gen_call_fgetc(&self, arguments: &[HirExpression], ctx: &TypeContext) -> String {
         if arguments.len() == 1 {
+            if let Some((handle, FileStream::Reader)) = self.known_file_stream(&arguments[0], ctx) {
+                return format!(
+                    "{}.as_mut().map_or(-1, |__r| {{ use std::io::Read; let mut buf = [0u8; 1]; match __r.read(&mut buf) {{ Ok(1) => buf[0] as i32, _ => -1 }} }})",
+                    handle
+                );
+            }
             let file_code = self.generate_expression_with_context(&arguments[0], ctx);
-            format!(
-                "{{ use std::io::Read; let mut buf = [0u8; 1]; {}.read(&mut buf).map(|_| buf[0] as i32).unwrap_or(-1) }}",
+            let read = format!(
+                "{{ use std::io::Read; let mut buf = [0u8; 1]; match {}.read(&mut buf) {{ Ok(1) => buf[0] as i32, _ => -1 }} }}",
                 file_code
-            )
+            );
+            if matches!(&arguments[0], HirExpression::Variable(name) if name == "stdin") {
+                return Self::flush_stdout_before(read, ctx);
+            }
+            read
         } else {
             "-1 /* fgetc requires 1 arg */".to_string()
         }
@@ -414,11 +609,23 @@ impl CodeGenerator {
 
     pub(crate) fn gen_call_fputc(&self, arguments: &[HirExpression], ctx: &TypeContext) -> String {
         if arguments.len() == 2 {
-            let char_code = self.generate_expression_with_context(&arguments[0], ctx);
-            let file_code = self.generate_expression_with_context(&arguments[1], ctx);
+            let file_code = self.stream_target(&arguments[1], ctx);
+            let mut lets = String::new();
+            let char_code = if file_code == "__stdout" {
+                self.stdout_write_arg(&arguments[0], ctx, &mut lets)
+            } else {
+                self.generate_expression_with_context(&arguments[0], ctx)
+            };
+            if let Some((handle, FileStream::Writer)) = self.known_file_stream(&arguments[1], ctx) {
+                let body = format!(
+                    "__w.write_all(&[{} as u8]).map_or(-1, |_| {} as i32)",
+                    char_code, char_code
+                );
+                return Self::with_stream_writer(&handle, "-1", &body);
+            }
             format!(
-                "{{ use std::io::Write; {}.write(&[{} as u8]).map(|_| {} as i32).unwrap_or(-1) }}",
-                file_code, char_code, char_code
+                "{{ use std::io::Write; {}{}.write(&[{} as u8]).map(|_| {} as i32).unwrap_or(-1) }}",
+                lets, file_code, char_code, char_code
             )
         } else {
             "-1 /* fputc requires 2 args */".to_string()
@@ -431,35 +638,33 @@ impl CodeGenerator {
         ctx: &TypeContext,
     ) -> String {
         if arguments.len() >= 2 {
-            let file_code = self.generate_expression_with_context(&arguments[0], ctx);
+            let file_code = self.stream_target(&arguments[0], ctx);
+            let mut lets = String::new();
             let fmt = self.generate_expression_with_context(&arguments[1], ctx);
-            let rust_fmt = Self::convert_c_format_to_rust(&fmt);
-            if arguments.len() == 2 {
-                format!(
-                    "{{ use std::io::Write; write!({}, {}).map(|_| 0).unwrap_or(-1) }}",
-                    file_code, rust_fmt
-                )
-            } else {
-                let s_positions = Self::find_string_format_positions(&fmt);
-                let args: Vec<String> = arguments[2..]
-                    .iter()
-                    .enumerate()
-                    .map(|(i, a)| {
-                        let arg_code = self.generate_expression_with_context(a, ctx);
-                        if s_positions.contains(&i) {
-                            format!("unsafe {{ std::ffi::CStr::from_ptr({} as *const i8).to_str().unwrap_or(\"\") }}", arg_code)
-                        } else {
-                            arg_code
-                        }
-                    })
-                    .collect();
-                format!(
-                    "{{ use std::io::Write; write!({}, {}, {}).map(|_| 0).unwrap_or(-1) }}",
-                    file_code,
-                    rust_fmt,
-                    args.join(", ")
-                )
+            let mut write_args = vec![Self::convert_c_format_to_rust(&fmt)];
+            let s_positions = Self::find_string_format_positions(&fmt);
+            write_args.extend(arguments[2..].iter().enumerate().map(|(i, a)| {
+                let arg_code = if file_code == "__stdout" {
+                    self.stdout_write_arg(a, ctx, &mut lets)
+                } else {
+                    self.generate_expression_with_context(a, ctx)
+                };
+                if s_positions.contains(&i) {
+                    format!("unsafe {{ std::ffi::CStr::from_ptr({} as *const i8).to_str().unwrap_or(\"\") }}", arg_code)
+                } else {
+                    arg_code
+                }
+            }));
+            if let Some((handle, FileStream::Writer)) = self.known_file_stream(&arguments[0], ctx) {
+                let body = format!("write!(__w, {}).map_or(-1, |_| 0)", write_args.join(", "));
+                return Self::with_stream_writer(&handle, "-1", &body);
             }
+            format!(
+                "{{ use std::io::Write; {}write!({}, {}).map(|_| 0).unwrap_or(-1) }}",
+                lets,
+                file_code,
+                write_args.join(", ")
+            )
         } else {
             "-1 /* fprintf requires 2+ args */".to_string()
         }
@@ -468,40 +673,61 @@ impl CodeGenerator {
     pub(crate) fn gen_call_printf(&self, arguments: &[HirExpression], ctx: &TypeContext) -> String {
         if !arguments.is_empty() {
             let fmt = self.generate_expression_with_context(&arguments[0], ctx);
-            let rust_fmt = Self::convert_c_format_to_rust(&fmt);
-            if arguments.len() == 1 {
-                format!("print!({})", rust_fmt)
+            let mut macro_args = vec![Self::convert_c_format_to_rust(&fmt)];
+            let mut lets = String::new();
+            macro_args.extend(self.printf_args(&fmt, &arguments[1..], ctx, &mut lets));
+            if ctx.has_buffered_stdout() {
+                format!("{{ {}let _ = write!(__stdout, {}); }}", lets, macro_args.join(", "))
             } else {
-                let s_positions = Self::find_string_format_positions(&fmt);
-                let args: Vec<String> = arguments[1..]
-                    .iter()
-                    .enumerate()
-                    .map(|(i, a)| {
-                        let arg_code = self.generate_expression_with_context(a, ctx);
-                        if s_positions.contains(&i) && !Self::is_string_ternary(a) {
-                            let arg_type = ctx.infer_expression_type(a);
-                            let is_raw_pointer = matches!(arg_type, Some(HirType::Pointer(_)));
-                            let is_function_call = matches!(a, HirExpression::FunctionCall { .. });
-                            if is_raw_pointer || is_function_call {
-                                Self::wrap_raw_ptr_with_cstr(&arg_code)
-                            } else {
-                                Self::wrap_with_cstr(&arg_code)
-                            }
-                        } else {
-                            arg_code
-                        }
-                    })
-                    .collect();
-                format!("print!({}, {})", rust_fmt, args.join(", "))
+                format!("print!({})", macro_args.join(", "))
             }
+        } else if ctx.has_buffered_stdout() {
+            "()".to_string()
         } else {
             "print!(\"\")".to_string()
         }
     }
 
+    /// Format arguments of a printf call, with `%s` arguments converted from
+    /// C strings and, with buffered stdout, calls evaluated into `lets`.
+    fn printf_args(
+        &self,
+        fmt: &str,
+        arguments: &[HirExpression],
+        ctx: &TypeContext,
+        lets: &mut String,
+    ) -> Vec<String> {
+        let s_positions = Self::find_string_format_positions(fmt);
+        arguments
+            .iter()
+            .enumerate()
+            .map(|(i, a)| {
+                let arg_code = self.stdout_write_arg(a, ctx, lets);
+                if s_positions.contains(&i) && !Self::is_string_ternary(a) {
+                    let arg_type = ctx.infer_expression_type(a);
+                    let is_raw_pointer = matches!(arg_type, Some(HirType::Pointer(_)));
+                    let is_function_call = matches!(a, HirExpression::FunctionCall { .. });
+                    if is_raw_pointer || is_function_call {
+                        Self::wrap_raw_ptr_with_cstr(&arg_code)
+                    } else {
+                        Self::wrap_with_cstr(&arg_code)
+                    }
+                } else {
+                    arg_code
+                }
+            })
+            .collect()
+    }
+
     pub(crate) fn gen_call_fread(&self, arguments: &[HirExpression], ctx: &TypeContext) -> String {
         if arguments.len() == 4 {
             let buf_code = self.generate_expression_with_context(&arguments[0], ctx);
+            if let Some((handle, FileStream::Reader)) = self.known_file_stream(&arguments[3], ctx) {
+                return format!(
+                    "{}.as_mut().map_or(0, |__r| {{ use std::io::Read; __r.read(&mut {}).unwrap_or(0) }})",
+                    handle, buf_code
+                );
+            }
             let file_code = self.generate_expression_with_context(&arguments[3], ctx);
             format!("{{ use std::io::Read; {}.read(&mut {}).unwrap_or(0) }}", file_code, buf_code)
         } else {
@@ -512,6 +738,10 @@ impl CodeGenerator {
     pub(crate) fn gen_call_fwrite(&self, arguments: &[HirExpression], ctx: &TypeContext) -> String {
         if arguments.len() == 4 {
             let data_code = self.generate_expression_with_context(&arguments[0], ctx);
+            if let Some((handle, FileStream::Writer)) = self.known_file_stream(&arguments[3], ctx) {
+                let body = format!("__w.write(&{}).unwrap_or(0)", data_code);
+                return Self::with_stream_writer(&handle, "0", &body);
+            }
             let file_code = self.generate_expression_with_context(&arguments[3], ctx);
             format!("{{ use std::io::Write; {}.write(&{}).unwrap_or(0) }}", file_code, data_code)
         } else {
@@ -521,11 +751,20 @@ impl CodeGenerator {
 
     pub(crate) fn gen_call_fputs(&self, arguments: &[HirExpression], ctx: &TypeContext) -> String {
         if arguments.len() == 2 {
-            let str_code = self.generate_expression_with_context(&arguments[0], ctx);
-            let file_code = self.generate_expression_with_context(&arguments[1], ctx);
+            let file_code = self.stream_target(&arguments[1], ctx);
+            let mut lets = String::new();
+            let str_code = if file_code == "__stdout" {
+                self.stdout_write_arg(&arguments[0], ctx, &mut lets)
+            } else {
+                self.generate_expression_with_context(&arguments[0], ctx)
+            };
+            if let Some((handle, FileStream::Writer)) = self.known_file_stream(&arguments[1], ctx) {
+                let body = format!("__w.write_all({}.as_bytes()).map_or(-1, |_| 0)", str_code);
+                return Self::with_stream_writer(&handle, "-1", &body);
+            }
             format!(
-                "{{ use std::io::Write; {}.write_all({}.as_bytes()).map(|_| 0).unwrap_or(-1) }}",
-                file_code, str_code
+                "{{ use std::io::Write; {}{}.write_all({}.as_bytes()).map(|_| 0).unwrap_or(-1) }}",
+                lets, file_code, str_code
             )
         } else {
             "-1 /* fputs requires 2 args */".to_string()
@@ -594,16 +833,14 @@ impl CodeGenerator {
     ) -> String {
         if arguments.len() >= 3 {
             let fmt = self.generate_expression_with_context(&arguments[2], ctx);
-            let rust_fmt = Self::convert_c_format_to_rust(&fmt);
-            if arguments.len() == 3 {
-                format!("format!({})", rust_fmt)
-            } else {
-                let args: Vec<String> = arguments[3..]
-                    .iter()
-                    .map(|a| self.generate_expression_with_context(a, ctx))
-                    .collect();
-                format!("format!({}, {})", rust_fmt, args.join(", "))
-            }
+            let mut format_args = vec![Self::convert_c_format_to_rust(&fmt)];
+            format_args.extend(
+                arguments[3..].iter().map(|a| self.generate_expression_with_context(a, ctx)),
+            );
+            let size = self.generate_expression_with_context(&arguments[1], ctx);
+            let limit = format!("({} as usize).min(__dst.len())", size);
+            self.format_into_buffer(&arguments[0], &limit, &format_args, ctx)
+                .unwrap_or_else(|| format!("format!({})", format_args.join(", ")))
         } else {
             "String::new() /* snprintf requires 3+ args */".to_string()
         }
@@ -616,21 +853,294 @@ impl CodeGenerator {
     ) -> String {
         if arguments.len() >= 2 {
             let fmt = self.generate_expression_with_context(&arguments[1], ctx);
-            let rust_fmt = Self::convert_c_format_to_rust(&fmt);
-            if arguments.len() == 2 {
-                format!("format!({})", rust_fmt)
-            } else {
-                let args: Vec<String> = arguments[2..]
-                    .iter()
-                    .map(|a| self.generate_expression_with_context(a, ctx))
-                    .collect();
-                format!("format!({}, {})", rust_fmt, args.join(", "))
-            }
+            let mut format_args = vec![Self::convert_c_format_to_rust(&fmt)];
+            format_args.extend(
+                arguments[2..].iter().map(|a| self.generate_expression_with_context(a, ctx)),
+            );
+            self.format_into_buffer(&arguments[0], "__dst.len()", &format_args, ctx)
+                .unwrap_or_else(|| format!("format!({})", format_args.join(", ")))
         } else {
             "String::new() /* sprintf requires 2+ args */".to_string()
         }
     }
 
+    /// Format straight into a char array destination with a NUL terminator,
+    /// truncating at `limit` bytes including the NUL, and yield the length
+    /// of the whole output as C does, so `>= size` detects truncation. A
+    /// limit of 0 writes nothing. `None` when the destination is not a known
+    /// byte buffer.
+    fn format_into_buffer(
+        &self,
+        dest: &HirExpression,
+        limit: &str,
+        format_args: &[String],
+        ctx: &TypeContext,
+    ) -> Option<String> {
+        let HirExpression::Variable(name) = dest else {
+            return None;
+        };
+        let buffer = match ctx.get_type(name)? {
+            HirType::Reference { inner, .. } => inner.as_ref(),
+            other => other,
+        };
+        let is_byte_buffer = match buffer {
+            HirType::Array { element_type, .. } | HirType::Vec(element_type) => {
+                matches!(**element_type, HirType::Char)
+            }
+            _ => false,
+        };
+        if !is_byte_buffer {
+            return None;
+        }
+        let dest_code = self.generate_expression_with_context(dest, ctx);
+        // A writer that keeps what fits and counts everything
+        Some(format!(
+            "{{ use std::fmt::Write as _; struct __Truncate<'a>(&'a mut [u8], usize); \
+             impl std::fmt::Write for __Truncate<'_> {{ fn write_str(&mut self, s: &str) -> std::fmt::Result {{ \
+             let __at = self.1.min(self.0.len()); let __fit = (self.0.len() - __at).min(s.len()); \
+             self.0[__at..__at + __fit].copy_from_slice(&s.as_bytes()[..__fit]); self.1 += s.len(); Ok(()) }} }} \
+             let __dst = &mut {}[..]; let __lim = {}; let __cap = __lim.saturating_sub(1); \
+             let mut __out = __Truncate(&mut __dst[..__cap], 0); let _ = write!(__out, {}); \
+             let __n = __out.1; if __lim > 0 {{ __dst[__n.min(__cap)] = 0; }} __n as i32 }}",
+            dest_code,
+            limit,
+            format_args.join(", ")
+        ))
+    }
+
+    /// `qsort(base, n, size, cmp)` as an unstable in-place sort, like C's.
+    ///
+    /// A comparator ordering by one integer key becomes `sort_unstable()` or
+    /// a key; any other is called with the two elements and its `int`
+    /// compared with 0.
+    fn gen_call_qsort(&self, arguments: &[HirExpression], ctx: &TypeContext) -> String {
+        let [base, n, _, cmp] = arguments else {
+            return "/* qsort requires 4 args */".to_string();
+        };
+        let sort = match self.key_comparator(cmp, ctx) {
+            Some(KeyComparator { key: SortKey::Element, descending: false }) => {
+                "sort_unstable()".to_string()
+            }
+            Some(KeyComparator { key: SortKey::Element, descending: true }) => {
+                "sort_unstable_by(|a, b| b.cmp(a))".to_string()
+            }
+            Some(KeyComparator { key: SortKey::Field(f), descending: false }) => {
+                format!("sort_unstable_by_key(|e| e.{})", f)
+            }
+            Some(KeyComparator { key: SortKey::Field(f), descending: true }) => {
+                format!("sort_unstable_by(|a, b| b.{f}.cmp(&a.{f}))")
+            }
+            None => {
+                let call = self.gen_comparator_call(cmp, "a", "b", ctx);
+                format!("sort_unstable_by(|a, b| {}.cmp(&0))", call)
+            }
+        };
+        format!("{}.{}", self.gen_sorted_slice(base, n, ctx), sort)
+    }
+
+    /// `bsearch(key, base, n, size, cmp)` as a binary search of the first `n`
+    /// elements, giving a pointer to the match or NULL.
+    fn gen_call_bsearch(&self, arguments: &[HirExpression], ctx: &TypeContext) -> String {
+        let [key, base, n, _, cmp] = arguments else {
+            return "/* bsearch requires 5 args */".to_string();
+        };
+        // The key as a place: `&key` is passed as `key`
+        let key = match key {
+            HirExpression::AddressOf(place)
+            | HirExpression::UnaryOp { op: decy_hir::UnaryOperator::AddressOf, operand: place } => {
+                self.generate_expression_with_context(place, ctx)
+            }
+            HirExpression::Variable(name)
+                if matches!(ctx.get_type(name), Some(HirType::Pointer(_))) =>
+            {
+                format!(
+                    "(*{})",
+                    Self::unsafe_block(&format!("&*{}", name), "key pointer is non-null and valid")
+                )
+            }
+            other => format!("(*{})", self.generate_expression_with_context(other, ctx)),
+        };
+        let search = match self.key_comparator(cmp, ctx) {
+            Some(KeyComparator { key: SortKey::Element, descending: false }) => {
+                format!("binary_search(&{})", key)
+            }
+            Some(KeyComparator { key: SortKey::Element, descending: true }) => {
+                format!("binary_search_by(|e| {}.cmp(e))", key)
+            }
+            Some(KeyComparator { key: SortKey::Field(f), descending: false }) => {
+                format!("binary_search_by_key(&{}.{f}, |e| e.{f})", key)
+            }
+            Some(KeyComparator { key: SortKey::Field(f), descending: true }) => {
+                format!("binary_search_by(|e| {}.{f}.cmp(&e.{f}))", key)
+            }
+            // cmp(key, e) > 0 when the element sorts before the key
+            None => {
+                let call = self.gen_comparator_call(cmp, &format!("&{}", key), "e", ctx);
+                format!("binary_search_by(|e| 0.cmp(&{}))", call)
+            }
+        };
+        let base_ptr = match base {
+            HirExpression::Variable(name)
+                if matches!(ctx.get_type(name), Some(HirType::Pointer(_))) =>
+            {
+                name.clone()
+            }
+            other => format!("{}.as_ptr()", self.generate_expression_with_context(other, ctx)),
+        };
+        format!(
+            "{}.{}.map_or(std::ptr::null_mut(), |i| {}.wrapping_add(i) as *mut _)",
+            self.gen_sorted_slice(base, n, ctx),
+            search,
+            base_ptr
+        )
+    }
+
+    /// The first `n` elements of a `qsort`/`bsearch` array.
+    fn gen_sorted_slice(
+        &self,
+        base: &HirExpression,
+        n: &HirExpression,
+        ctx: &TypeContext,
+    ) -> String {
+        let n = self.generate_expression_with_context(n, ctx);
+        match base {
+            HirExpression::Variable(name)
+                if matches!(ctx.get_type(name), Some(HirType::Pointer(_))) =>
+            {
+                Self::unsafe_block(
+                    &format!("std::slice::from_raw_parts_mut({}, ({}) as usize)", name, n),
+                    "pointer is valid for n elements",
+                )
+            }
+            other => {
+                format!("{}[..({}) as usize]", self.generate_expression_with_context(other, ctx), n)
+            }
+        }
+    }
+
+    /// The key comparator passed to `qsort`/`bsearch`, unless a local
+    /// function pointer of the same name shadows it.
+    fn key_comparator<'a>(
+        &'a self,
+        cmp: &HirExpression,
+        ctx: &TypeContext,
+    ) -> Option<&'a KeyComparator> {
+        let HirExpression::Variable(name) = cmp else {
+            return None;
+        };
+        if ctx.get_type(name).is_some() {
+            return None;
+        }
+        self.comparators.get(name)
+    }
+
+    /// A call of a C comparator on two element borrows, passed the way its
+    /// parameters take them.
+    fn gen_comparator_call(
+        &self,
+        cmp: &HirExpression,
+        a: &str,
+        b: &str,
+        ctx: &TypeContext,
+    ) -> String {
+        let (callee, params) = match cmp {
+            HirExpression::Variable(name) if ctx.get_type(name).is_none() => {
+                (name.clone(), ctx.functions.get(name.as_str()))
+            }
+            other => (format!("({})", self.generate_expression_with_context(other, ctx)), None),
+        };
+        // void* parameters stay raw pointers
+        let pass = |k: usize, arg: &str| match params.and_then(|p| p.get(k)) {
+            Some(HirType::Reference { inner, .. }) if **inner == HirType::Void => {
+                format!("{} as *const _ as *mut _", arg)
+            }
+            Some(HirType::Reference { mutable: false, .. }) => arg.to_string(),
+            Some(HirType::Reference { mutable: true, .. }) => format!("&mut ({}).clone()", arg),
+            _ => format!("{} as *const _ as *mut _", arg),
+        };
+        format!("{}({}, {})", callee, pass(0, a), pass(1, b))
+    }
+
+    /// A call through a function-pointer local that only holds known
+    /// functions: the one it holds called directly, or a `match` on which.
+    fn gen_call_dispatch(
+        &self,
+        local: &str,
+        targets: &[String],
+        arguments: &[HirExpression],
+        ctx: &TypeContext,
+        target_type: Option<&HirType>,
+    ) -> String {
+        let call = |target: &str| self.gen_expr_function_call(target, arguments, ctx, target_type);
+        if let [target] = targets {
+            return call(target);
+        }
+        let arms: Vec<String> = targets
+            .iter()
+            .map(|t| {
+                format!(
+                    "{}::{} => {}",
+                    Self::dispatch_enum(local),
+                    Self::dispatch_variant(targets, t),
+                    call(t)
+                )
+            })
+            .collect();
+        let escaped = escape_rust_keyword(local);
+        let scrutinee = ctx.get_renamed_local(&escaped).cloned().unwrap_or(escaped);
+        format!("match {} {{ {} }}", scrutinee, arms.join(", "))
+    }
+
+    /// Enum of the functions a function-pointer local may hold: `step` gives
+    /// `StepTarget`.
+    pub(crate) fn dispatch_enum(local: &str) -> String {
+        format!("{}Target", pascal_case(local))
+    }
+
+    /// Variant of that enum for `target`, numbered when two of the functions
+    /// would share a name.
+    pub(crate) fn dispatch_variant(targets: &[String], target: &str) -> String {
+        let name = pascal_case(target);
+        if targets.iter().filter(|t| pascal_case(t) == name).count() > 1 {
+            let k = targets.iter().position(|t| t == target).unwrap_or(0);
+            return format!("{}{}", name, k);
+        }
+        name
+    }
+
+    /// An argument to a callback taken as a generic `FnMut`, or a function
+    /// passed where a callee takes one.
+    fn gen_generic_callback_arg(
+        &self,
+        function: &str,
+        index: usize,
+        arg: &HirExpression,
+        ctx: &TypeContext,
+    ) -> Option<String> {
+        let HirExpression::Variable(name) = arg else {
+            return None;
+        };
+        // Calling our own callback: it borrows what the pointer points to
+        if ctx.is_generic_callback(function) {
+            return matches!(ctx.get_type(name), Some(HirType::Pointer(_))).then(|| {
+                Self::unsafe_block(
+                    &format!("&mut *{}", name),
+                    "pointer is non-null and valid for the duration of the call",
+                )
+            });
+        }
+        if !self.generic_callbacks_of(function).iter().any(|(k, _)| *k == index) {
+            return None;
+        }
+        if ctx.is_generic_callback(name) {
+            return Some(format!("&mut {}", name));
+        }
+        // Wrap the function so its parameters take the borrows the callee passes
+        let arity = ctx.functions.get(name.as_str())?.len();
+        let args: Vec<String> = (0..arity).map(|k| format!("a{}", k)).collect();
+        Some(format!("|{}| {}({})", args.join(", "), name, args.join(", ")))
+    }
+
     pub(crate) fn gen_call_default(
         &self,
         function: &str,
@@ -655,7 +1165,18 @@ impl CodeGenerator {
 
                 if array_indices.contains(&i) {
                     let arg_code = self.generate_expression_with_context(arg, ctx);
-                    return Some(format!("&{}", arg_code));
+                    // The callee's parameter list no longer has the length params
+                    let removed = len_indices_to_skip.iter().filter(|&&len| len < i).count();
+                    let mutable = matches!(
+                        ctx.get_function_param_type(function, i - removed),
+                        Some(HirType::Reference { mutable: true, .. })
+                    );
+                    let borrow = if mutable { "&mut " } else { "&" };
+                    return Some(format!("{}{}", borrow, arg_code));
+                }
+
+                if let Some(callback) = self.gen_generic_callback_arg(function, i, arg, ctx) {
+                    return Some(callback);
                 }
 
                 let is_address_of = matches!(arg, HirExpression::AddressOf(_))
@@ -681,6 +1202,22 @@ impl CodeGenerator {
                         })
                         .unwrap_or(true);
 
+                    // &p[i] on a raw pointer borrows the element in place, not
+                    // a copy read out through an unsafe block
+                    if let HirExpression::ArrayIndex { array, index } = inner {
+                        if let HirExpression::Variable(pointer) = array.as_ref() {
+                            if ctx.is_pointer(pointer) {
+                                let index_code =
+                                    self.generate_expression_with_context(index, ctx);
+                                let borrow = if expects_mut { "&mut " } else { "&" };
+                                return Some(Self::unsafe_block(
+                                    &format!("{}*{}.add(({}) as usize)", borrow, pointer, index_code),
+                                    "index is within bounds of allocated array",
+                                ));
+                            }
+                        }
+                    }
+
                     let inner_code =
                         self.generate_expression_with_context(inner, ctx);
                     if expects_mut {
@@ -806,3 +1343,19 @@ impl CodeGenerator {
         format!("{}({})", safe_function, args.join(", "))
     }
 }
+
+/// `do_step` gives `DoStep`.
+fn pascal_case(name: &str) -> String {
+    let pascal: String = name
+        .split('_')
+        .filter(|part| !part.is_empty())
+        .map(|part| {
+            let mut chars = part.chars();
+            chars.next().map_or(String::new(), |c| c.to_uppercase().chain(chars).collect())
+        })
+        .collect();
+    match pascal.chars().next() {
+        Some(c) if c.is_alphabetic() => pascal,
+        _ => format!("F{}", pascal),
+    }
+}
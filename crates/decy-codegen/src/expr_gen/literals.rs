@@ -210,7 +210,7 @@ impl CodeGenerator {
 
         cast_suffix.map(|suffix| {
             let code = format!("{} as {}", escaped_name, suffix);
-            if ctx.is_global(name) {
+            if ctx.is_static_mut(name) {
                 format!("unsafe {{ {} }}", code)
             } else {
                 code
@@ -230,7 +230,7 @@ impl CodeGenerator {
             "stderr" => return "std::io::stderr()".to_string(),
             "stdin" => return "std::io::stdin()".to_string(),
             "stdout" => return "std::io::stdout()".to_string(),
-            "errno" => return "unsafe { ERRNO }".to_string(),
+            "errno" => return "ERRNO.get()".to_string(),
             "ERANGE" => return "34i32".to_string(),
             "EINVAL" => return "22i32".to_string(),
             "ENOENT" => return "2i32".to_string(),
@@ -239,6 +239,11 @@ impl CodeGenerator {
         }
         let escaped_name = escape_rust_keyword(name);
         let escaped_name = ctx.get_renamed_local(&escaped_name).cloned().unwrap_or(escaped_name);
+        let escaped_name = if ctx.is_atomic_global(name) {
+            Self::atomic_global_load(&escaped_name)
+        } else {
+            escaped_name
+        };
         if let Some(HirType::Vec(_)) = target_type {
             return escaped_name;
         }
@@ -266,7 +271,7 @@ impl CodeGenerator {
             }
         }
 
-        if ctx.is_global(name) {
+        if ctx.is_static_mut(name) {
             format!("unsafe {{ {} }}", escaped_name)
         } else {
             escaped_name
@@ -68,6 +68,10 @@ impl CodeGenerator {
             );
         }
 
+        if let Some(binding) = Self::loop_index_binding(array, index, ctx) {
+            return format!("{}[{}]", array_code, binding);
+        }
+
         let index_expr = format!("{}[({}) as usize]", array_code, index_code);
         if is_global_array {
             format!("unsafe {{ {} }}", index_expr)
@@ -76,6 +80,23 @@ impl CodeGenerator {
         }
     }
 
+    /// The usize range variable to index `array` with when `index` is the
+    /// induction variable of a counted loop over it.
+    pub(crate) fn loop_index_binding<'a>(
+        array: &HirExpression,
+        index: &HirExpression,
+        ctx: &'a TypeContext,
+    ) -> Option<&'a str> {
+        match (array, index) {
+            (HirExpression::Variable(array), HirExpression::Variable(index))
+                if !ctx.is_global(array) && !ctx.is_pointer(array) =>
+            {
+                ctx.loop_index(index)
+            }
+            _ => None,
+        }
+    }
+
     pub(crate) fn gen_expr_sizeof(&self, type_name: &str, ctx: &TypeContext) -> String {
         let trimmed = type_name.trim();
 
@@ -331,6 +352,9 @@ impl CodeGenerator {
         operand: &HirExpression,
         ctx: &TypeContext,
     ) -> String {
+        if let Some(code) = Self::generate_atomic_global_step(operand, ctx, true, false) {
+            return code;
+        }
         if let HirExpression::Variable(var_name) = operand {
             if let Some(var_type) = ctx.get_type(var_name) {
                 if matches!(var_type, HirType::StringReference | HirType::StringLiteral) {
@@ -372,6 +396,9 @@ impl CodeGenerator {
         operand: &HirExpression,
         ctx: &TypeContext,
     ) -> String {
+        if let Some(code) = Self::generate_atomic_global_step(operand, ctx, true, true) {
+            return code;
+        }
         if let HirExpression::Dereference(inner) = operand {
             if let HirExpression::Variable(var_name) = &**inner {
                 if ctx.is_pointer(var_name) {
@@ -400,6 +427,9 @@ impl CodeGenerator {
         operand: &HirExpression,
         ctx: &TypeContext,
     ) -> String {
+        if let Some(code) = Self::generate_atomic_global_step(operand, ctx, false, false) {
+            return code;
+        }
         if let HirExpression::Dereference(inner) = operand {
             if let HirExpression::Variable(var_name) = &**inner {
                 if ctx.is_pointer(var_name) {
@@ -428,6 +458,9 @@ impl CodeGenerator {
         operand: &HirExpression,
         ctx: &TypeContext,
     ) -> String {
+        if let Some(code) = Self::generate_atomic_global_step(operand, ctx, false, true) {
+            return code;
+        }
         if let HirExpression::Dereference(inner) = operand {
             if let HirExpression::Variable(var_name) = &**inner {
                 if ctx.is_pointer(var_name) {
@@ -600,9 +633,11 @@ impl CodeGenerator {
     /// This distinguishes single-element allocations (use Box) from array allocations (use Vec).
     pub(crate) fn is_malloc_array_pattern(expr: &HirExpression) -> bool {
         match expr {
-            HirExpression::FunctionCall { function, arguments }
-                if function == "malloc" || function == "calloc" =>
-            {
+            // calloc(n, size) allocates an array unless n is 1
+            HirExpression::FunctionCall { function, arguments } if function == "calloc" => {
+                !matches!(arguments.first(), Some(HirExpression::IntLiteral(1)) | None)
+            }
+            HirExpression::FunctionCall { function, arguments } if function == "malloc" => {
                 arguments
                     .first()
                     .map(|arg| {
@@ -8,6 +8,7 @@ mod binary_ops;
 mod calls;
 mod literals;
 mod misc;
+mod slice_ops;
 
 use super::{escape_rust_keyword, CodeGenerator, TypeContext};
 use decy_hir::{HirExpression, HirType};
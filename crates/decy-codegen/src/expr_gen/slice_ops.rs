@@ -0,0 +1,235 @@
+//! string.h memory and byte-scan calls lowered to slice operations.
+//!
+//! When the pointer operands name known arrays, Vecs or slices (optionally
+//! at an offset), `memcpy`/`memmove`/`memset`/`memcmp` become
+//! `copy_from_slice`/`copy_within`/`fill`/slice comparison, which std lowers
+//! to vectorised copies and compares. NUL scans for `strlen`/`strchr` use
+//! `CStr::from_bytes_until_nul` (word-at-a-time in core) and character
+//! searches use `iter().position`. Calls are only recognised when the stdlib
+//! prototype database says the callee is the string.h function with this
+//! arity; anything else keeps the plain call.
+
+use super::{CodeGenerator, TypeContext};
+use decy_hir::{BinaryOperator, HirExpression, HirType, UnaryOperator};
+use decy_stdlib::{StdHeader, StdlibPrototypes};
+use std::sync::OnceLock;
+
+/// A pointer argument that addresses a known array, Vec or slice.
+struct SliceOperand {
+    /// Root variable name, as written in C
+    name: String,
+    /// Generated code for the indexable base
+    base: String,
+    /// Generated start offset, if the pointer is not at the start
+    offset: Option<String>,
+    /// Element type
+    element: HirType,
+    /// Whether the buffer may be written through, so a pointer into it can
+    /// be `*mut`
+    mutable: bool,
+}
+
+impl SliceOperand {
+    fn start(&self) -> &str {
+        self.offset.as_deref().unwrap_or("0")
+    }
+
+    /// `base[offset..offset + len]`
+    fn range(&self, len: &str) -> String {
+        match &self.offset {
+            Some(off) => format!("{}[{}..{} + {}]", self.base, off, off, len),
+            None => format!("{}[..{}]", self.base, len),
+        }
+    }
+
+    /// `base[offset..]`
+    fn tail(&self) -> String {
+        match &self.offset {
+            Some(off) => format!("{}[{}..]", self.base, off),
+            None => format!("{}[..]", self.base),
+        }
+    }
+
+    fn is_bytes(&self) -> bool {
+        matches!(self.element, HirType::Char)
+    }
+}
+
+impl CodeGenerator {
+    /// Whether `function` with `arity` arguments is the string.h function of
+    /// that name according to the stdlib prototype database.
+    fn is_string_h_call(function: &str, arity: usize) -> bool {
+        static PROTOTYPES: OnceLock<StdlibPrototypes> = OnceLock::new();
+        PROTOTYPES
+            .get_or_init(StdlibPrototypes::new)
+            .get_prototype(function)
+            .is_some_and(|p| p.header == StdHeader::String && p.parameters.len() == arity)
+    }
+
+    /// Resolve a pointer argument to a slice operand: `arr`, `&arr[i]` or
+    /// `arr + i` where `arr` is a local array, Vec or slice.
+    fn slice_operand(&self, expr: &HirExpression, ctx: &TypeContext) -> Option<SliceOperand> {
+        let (root, offset) = match expr {
+            HirExpression::AddressOf(inner)
+            | HirExpression::UnaryOp { op: UnaryOperator::AddressOf, operand: inner } => {
+                match inner.as_ref() {
+                    HirExpression::ArrayIndex { array, index } => (array.as_ref(), Some(index)),
+                    _ => return None,
+                }
+            }
+            HirExpression::BinaryOp { op: BinaryOperator::Add, left, right } => {
+                (left.as_ref(), Some(right))
+            }
+            other => (other, None),
+        };
+        let HirExpression::Variable(name) = root else {
+            return None;
+        };
+        if ctx.is_global(name) {
+            return None;
+        }
+        // Locals and by-value parameters are always bound `mut`
+        let (buffer, mutable) = match ctx.get_type(name)? {
+            HirType::Reference { inner, mutable } => (inner.as_ref(), *mutable),
+            other => (other, true),
+        };
+        let element = match buffer {
+            HirType::Array { element_type, .. } | HirType::Vec(element_type) => {
+                element_type.as_ref().clone()
+            }
+            _ => return None,
+        };
+        let offset = offset
+            .map(|off| format!("({}) as usize", self.generate_expression_with_context(off, ctx)));
+        Some(SliceOperand {
+            name: name.clone(),
+            base: self.generate_expression_with_context(root, ctx),
+            offset,
+            element,
+            mutable,
+        })
+    }
+
+    /// Element count for a C byte count over `operand`'s element type.
+    fn element_count(
+        &self,
+        bytes: &HirExpression,
+        operand: &SliceOperand,
+        ctx: &TypeContext,
+    ) -> String {
+        let bytes = self.generate_expression_with_context(bytes, ctx);
+        if operand.is_bytes() {
+            format!("({}) as usize", bytes)
+        } else {
+            format!(
+                "({}) as usize / std::mem::size_of::<{}>()",
+                bytes,
+                Self::map_type(&operand.element)
+            )
+        }
+    }
+
+    /// `strlen` over a NUL-terminated byte buffer.
+    pub(crate) fn gen_byte_strlen(&self, arg: &HirExpression, ctx: &TypeContext) -> Option<String> {
+        let s = self.slice_operand(arg, ctx).filter(SliceOperand::is_bytes)?;
+        let tail = s.tail();
+        Some(format!(
+            "{{ let __s = &{}; std::ffi::CStr::from_bytes_until_nul(__s).map_or(__s.len(), |__c| __c.to_bytes().len()) as i32 }}",
+            tail
+        ))
+    }
+
+    /// Lower a string.h memory call on known slices; `None` keeps the plain call.
+    pub(crate) fn gen_call_slice_op(
+        &self,
+        function: &str,
+        arguments: &[HirExpression],
+        ctx: &TypeContext,
+    ) -> Option<String> {
+        if !Self::is_string_h_call(function, arguments.len()) {
+            return None;
+        }
+        match (function, arguments) {
+            ("memcpy" | "memmove", [dst, src, n]) => {
+                let (dst, src) = (self.slice_operand(dst, ctx)?, self.slice_operand(src, ctx)?);
+                if dst.element != src.element {
+                    return None;
+                }
+                let count = self.element_count(n, &dst, ctx);
+                if dst.name == src.name {
+                    // Same buffer: copy_within handles overlap like memmove
+                    return Some(format!(
+                        "{{ let __n = {}; {}.copy_within({}..{} + __n, {}); }}",
+                        count,
+                        dst.base,
+                        src.start(),
+                        src.start(),
+                        dst.start()
+                    ));
+                }
+                Some(format!(
+                    "{{ let __n = {}; {}.copy_from_slice(&{}); }}",
+                    count,
+                    dst.range("__n"),
+                    src.range("__n")
+                ))
+            }
+            ("memset", [dst, value, n]) => {
+                let dst = self.slice_operand(dst, ctx)?;
+                let fill = if dst.is_bytes() {
+                    format!("({}) as u8", self.generate_expression_with_context(value, ctx))
+                } else if matches!(value, HirExpression::IntLiteral(0)) {
+                    // Zeroing is the only byte pattern with a per-element meaning
+                    match Self::map_type(&dst.element).as_str() {
+                        "f32" | "f64" => "0.0".to_string(),
+                        "i8" | "u8" | "i16" | "u16" | "i32" | "u32" | "i64" | "u64" | "isize"
+                        | "usize" => "0".to_string(),
+                        _ => return None,
+                    }
+                } else {
+                    return None;
+                };
+                let count = self.element_count(n, &dst, ctx);
+                Some(format!("{{ let __n = {}; {}.fill({}); }}", count, dst.range("__n"), fill))
+            }
+            ("memcmp", [a, b, n]) => {
+                let (a, b) = (self.slice_operand(a, ctx)?, self.slice_operand(b, ctx)?);
+                if !a.is_bytes() || !b.is_bytes() {
+                    return None;
+                }
+                let count = self.element_count(n, &a, ctx);
+                Some(format!(
+                    "{{ let __n = {}; {}.cmp(&{}) as i32 }}",
+                    count,
+                    a.range("__n"),
+                    b.range("__n")
+                ))
+            }
+            // The result may be written through, so it is derived from a
+            // `&mut` borrow; a read-only buffer keeps the plain call
+            ("memchr", [s, c, n]) => {
+                let s = self.slice_operand(s, ctx).filter(|s| s.is_bytes() && s.mutable)?;
+                let c = self.generate_expression_with_context(c, ctx);
+                let count = self.element_count(n, &s, ctx);
+                Some(format!(
+                    "{{ let __n = {}; let __s = &mut {}; __s[..__n].iter().position(|&b| b == ({}) as u8).map_or(std::ptr::null_mut(), |i| __s.as_mut_ptr().wrapping_add(i)) }}",
+                    count,
+                    s.tail(),
+                    c
+                ))
+            }
+            ("strchr", [s, c]) => {
+                // Search up to and including the terminator, so strchr(s, 0) finds it
+                let s = self.slice_operand(s, ctx).filter(|s| s.is_bytes() && s.mutable)?;
+                let c = self.generate_expression_with_context(c, ctx);
+                let tail = s.tail();
+                Some(format!(
+                    "{{ let __s = &mut {}; let __len = std::ffi::CStr::from_bytes_until_nul(__s).map_or(__s.len(), |__c| __c.to_bytes().len() + 1); \
+                     __s[..__len].iter().position(|&b| b == ({}) as u8).map_or(std::ptr::null_mut(), |i| __s.as_mut_ptr().wrapping_add(i)) }}",
+                    tail, c
+                ))
+            }
+            _ => None,
+        }
+    }
+}
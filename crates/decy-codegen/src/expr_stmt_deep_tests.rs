@@ -350,11 +350,11 @@ fn variable_stdout_becomes_io_stdout() {
 }
 
 #[test]
-fn variable_errno_becomes_unsafe_errno() {
+fn variable_errno_reads_thread_local_errno() {
     let ctx = make_ctx();
     let expr = HirExpression::Variable("errno".to_string());
     let result = gen().generate_expression_with_target_type(&expr, &ctx, None);
-    assert_eq!(result, "unsafe { ERRNO }", "errno should be unsafe ERRNO, got: {}", result);
+    assert_eq!(result, "ERRNO.get()", "errno should read the ERRNO cell, got: {}", result);
 }
 
 #[test]
@@ -1887,7 +1887,7 @@ fn stmt_assignment_to_global_wraps_unsafe() {
 // ============================================================================
 
 #[test]
-fn stmt_assignment_to_errno_wraps_unsafe() {
+fn stmt_assignment_to_errno_sets_cell() {
     let codegen = gen();
     let func = make_void_func(vec![HirStatement::Assignment {
         target: "errno".to_string(),
@@ -1895,8 +1895,8 @@ fn stmt_assignment_to_errno_wraps_unsafe() {
     }]);
     let code = codegen.generate_function(&func);
     assert!(
-        code.contains("unsafe") && code.contains("ERRNO"),
-        "Assignment to errno should be unsafe ERRNO, got: {}",
+        code.contains("ERRNO.set(0);") && !code.contains("unsafe"),
+        "Assignment to errno should set the ERRNO cell, got: {}",
         code
     );
 }
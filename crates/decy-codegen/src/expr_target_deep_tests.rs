@@ -893,10 +893,10 @@ fn stdout_maps_to_std_io() {
 }
 
 #[test]
-fn errno_maps_to_unsafe_global() {
+fn errno_maps_to_thread_local() {
     let c = ctx();
     let result = cg().generate_expression_with_target_type(&int_var("errno"), &c, None);
-    assert_eq!(result, "unsafe { ERRNO }");
+    assert_eq!(result, "ERRNO.get()");
 }
 
 #[test]
@@ -1110,7 +1110,7 @@ fn assignment_to_global_wraps_unsafe() {
 // ============================================================================
 
 #[test]
-fn errno_assignment_generates_unsafe_global() {
+fn errno_assignment_sets_thread_local() {
     let mut c = ctx();
     let result = cg().generate_statement_with_context(
         &HirStatement::Assignment { target: "errno".to_string(), value: int_lit(0) },
@@ -1118,11 +1118,7 @@ fn errno_assignment_generates_unsafe_global() {
         &mut c,
         None,
     );
-    assert!(
-        result.contains("unsafe") && result.contains("ERRNO"),
-        "Expected unsafe ERRNO assignment, got: {}",
-        result
-    );
+    assert_eq!(result, "ERRNO.set(0);", "Expected ERRNO cell assignment, got: {}", result);
 }
 
 // ============================================================================
@@ -1811,13 +1811,13 @@ fn test_variable_stdout_maps_to_io() {
 }
 
 #[test]
-fn test_variable_errno_maps_to_unsafe() {
+fn test_variable_errno_maps_to_cell() {
     let codegen = CodeGenerator::new();
     let func = make_func_with_body(vec![HirStatement::Expression(HirExpression::Variable(
         "errno".to_string(),
     ))]);
     let code = codegen.generate_function(&func);
-    assert!(code.contains("unsafe { ERRNO }"), "Expected unsafe ERRNO, got: {}", code);
+    assert!(code.contains("ERRNO.get()"), "Expected ERRNO.get(), got: {}", code);
 }
 
 // ============================================================================
@@ -4,7 +4,8 @@
 //! declarations: function signatures, function bodies with ownership analysis,
 //! struct/enum definitions, typedefs, constants, and global variables.
 
-use super::CodeGenerator;
+use super::{CodeGenerator, TypeContext};
+use decy_hir::visit::{walk_statements, Visitor};
 use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirStatement, HirType};
 use decy_ownership::lifetime_gen::{AnnotatedSignature, AnnotatedType};
 
@@ -46,9 +47,14 @@ impl CodeGenerator {
         sig.push_str(&lifetime_syntax);
 
         // DECY-096: Detect void* parameters for generic transformation
+        // DECY-084: Detect output parameters in the same body walk
+        use decy_analyzer::output_params::{OutputParamDetector, ParameterKind};
         use decy_analyzer::void_ptr_analysis::{TypeConstraint, VoidPtrAnalyzer};
-        let void_analyzer = VoidPtrAnalyzer::new();
-        let void_patterns = void_analyzer.analyze(func);
+        let mut analyzers =
+            (VoidPtrAnalyzer::new().visitor(func), OutputParamDetector::new().visitor(func));
+        decy_hir::visit::walk_statements(&mut analyzers, func.body());
+        let (void_usage, output_usage) = analyzers;
+        let void_patterns = void_usage.into_results();
 
         // DECY-168: Only consider patterns with actual constraints/types as "real" void* usage
         // Empty body functions (stubs) will have patterns but no constraints
@@ -88,10 +94,8 @@ impl CodeGenerator {
         let analyzer = DataflowAnalyzer::new();
         let graph = analyzer.analyze(func);
 
-        // DECY-084 GREEN: Detect output parameters for transformation
-        use decy_analyzer::output_params::{OutputParamDetector, ParameterKind};
-        let output_detector = OutputParamDetector::new();
-        let output_params = output_detector.detect(func);
+        // DECY-084 GREEN: Output parameters for transformation
+        let output_params = output_usage.into_results();
 
         // Track which parameters are length parameters to skip them
         let mut skip_params = std::collections::HashSet::new();
@@ -477,7 +481,11 @@ impl CodeGenerator {
     fn statement_deref_modifies_variable(&self, stmt: &HirStatement, var_name: &str) -> bool {
         match stmt {
             HirStatement::DerefAssignment { target, .. } => {
-                // Check if this is *ptr = value where ptr is our variable
+                // Check if this is *ptr = value (or *ptr++ = value) where ptr is our variable
+                let target = match target {
+                    HirExpression::PostIncrement { operand } => &**operand,
+                    other => other,
+                };
                 if let HirExpression::Variable(name) = target {
                     return name == var_name;
                 }
@@ -510,177 +518,11 @@ impl CodeGenerator {
 
     /// Check if a parameter uses pointer arithmetic, is reassigned, or compared to NULL (DECY-123, DECY-137).
     ///
-    /// Used to determine whether a pointer parameter should remain a raw pointer
-    /// instead of being transformed to a reference.
-    /// Returns true if the parameter is used in:
-    /// - `ptr = ptr + n;` (pointer arithmetic assignment)
-    /// - `ptr = ptr - n;` (pointer arithmetic assignment)
-    /// - `ptr += n;` or `ptr -= n;` (compound pointer arithmetic)
-    /// - `ptr = ptr->field;` (DECY-137: linked list traversal pattern)
-    /// - `ptr = other_ptr;` (any pointer reassignment)
-    /// - `ptr != 0` or `ptr == 0` (DECY-137: NULL comparison - Rust refs can't be null)
-    ///
     /// References in Rust cannot be reassigned or null, so any pointer param that is
-    /// reassigned or NULL-checked must remain as a raw pointer.
+    /// stepped, reassigned or NULL-checked must remain as a raw pointer. Call sites
+    /// are built from ownership summaries that share this predicate.
     pub(crate) fn uses_pointer_arithmetic(&self, func: &HirFunction, param_name: &str) -> bool {
-        for stmt in func.body() {
-            if self.statement_uses_pointer_arithmetic(stmt, param_name) {
-                return true;
-            }
-            // DECY-137: Also check for NULL comparisons in conditions
-            if self.statement_uses_null_comparison(stmt, param_name) {
-                return true;
-            }
-        }
-        false
-    }
-
-    /// Check if a statement contains NULL comparison for a variable (DECY-137).
-    ///
-    /// If a pointer is compared to NULL (0), it should stay as raw pointer
-    /// because Rust references can never be null.
-    #[allow(clippy::only_used_in_recursion)]
-    fn statement_uses_null_comparison(&self, stmt: &HirStatement, var_name: &str) -> bool {
-        match stmt {
-            HirStatement::If { condition, then_block, else_block, .. } => {
-                // Check condition for NULL comparison
-                if self.expression_compares_to_null(condition, var_name) {
-                    return true;
-                }
-                // Recursively check nested statements
-                then_block.iter().any(|s| self.statement_uses_null_comparison(s, var_name))
-                    || else_block.as_ref().is_some_and(|blk| {
-                        blk.iter().any(|s| self.statement_uses_null_comparison(s, var_name))
-                    })
-            }
-            HirStatement::While { condition, body, .. } => {
-                if self.expression_compares_to_null(condition, var_name) {
-                    return true;
-                }
-                body.iter().any(|s| self.statement_uses_null_comparison(s, var_name))
-            }
-            HirStatement::For { condition, body, .. } => {
-                if let Some(cond) = condition {
-                    if self.expression_compares_to_null(cond, var_name) {
-                        return true;
-                    }
-                }
-                body.iter().any(|s| self.statement_uses_null_comparison(s, var_name))
-            }
-            _ => false,
-        }
-    }
-
-    /// Check if an expression compares a variable to NULL (0).
-    fn expression_compares_to_null(&self, expr: &HirExpression, var_name: &str) -> bool {
-        match expr {
-            HirExpression::BinaryOp { op, left, right } => {
-                if matches!(op, BinaryOperator::Equal | BinaryOperator::NotEqual) {
-                    // Check: var == 0 or var != 0
-                    if let HirExpression::Variable(name) = &**left {
-                        if name == var_name
-                            && matches!(
-                                **right,
-                                HirExpression::IntLiteral(0) | HirExpression::NullLiteral
-                            )
-                        {
-                            return true;
-                        }
-                    }
-                    // Check: 0 == var or 0 != var
-                    if let HirExpression::Variable(name) = &**right {
-                        if name == var_name
-                            && matches!(
-                                **left,
-                                HirExpression::IntLiteral(0) | HirExpression::NullLiteral
-                            )
-                        {
-                            return true;
-                        }
-                    }
-                }
-                // Recursively check nested expressions (e.g., in logical AND/OR)
-                self.expression_compares_to_null(left, var_name)
-                    || self.expression_compares_to_null(right, var_name)
-            }
-            _ => false,
-        }
-    }
-
-    /// Recursively check if a statement uses pointer arithmetic or reassigns a variable (DECY-123, DECY-137).
-    #[allow(clippy::only_used_in_recursion)]
-    fn statement_uses_pointer_arithmetic(&self, stmt: &HirStatement, var_name: &str) -> bool {
-        match stmt {
-            HirStatement::Assignment { target, value } => {
-                // DECY-137: Any assignment to the pointer parameter means it must stay as raw pointer
-                // This catches:
-                // - ptr = ptr + n (pointer arithmetic)
-                // - ptr = ptr->next (linked list traversal)
-                // - ptr = other_ptr (general reassignment)
-                //
-                // References cannot be reassigned, only raw pointers can.
-                if target == var_name {
-                    // Check if this is pointer arithmetic (ptr = ptr + n or ptr = ptr - n)
-                    if let HirExpression::BinaryOp { op, left, .. } = value {
-                        if matches!(op, BinaryOperator::Add | BinaryOperator::Subtract) {
-                            if let HirExpression::Variable(name) = &**left {
-                                if name == var_name {
-                                    return true;
-                                }
-                            }
-                        }
-                    }
-
-                    // DECY-137: Check for field access reassignment (ptr = ptr->field)
-                    // This is the linked list traversal pattern: head = head->next
-                    if let HirExpression::PointerFieldAccess { pointer, .. } = value {
-                        if let HirExpression::Variable(name) = &**pointer {
-                            if name == var_name {
-                                return true;
-                            }
-                        }
-                    }
-
-                    // DECY-137: Check for any other pointer reassignment
-                    // If ptr is assigned from another variable or expression, it needs
-                    // to stay as raw pointer. However, we need to be careful not to
-                    // flag initialization (which happens at declaration, not assignment).
-                    // For now, flag field access from ANY pointer as reassignment.
-                    if matches!(value, HirExpression::PointerFieldAccess { .. }) {
-                        return true;
-                    }
-                }
-                false
-            }
-            HirStatement::If { then_block, else_block, .. } => {
-                then_block.iter().any(|s| self.statement_uses_pointer_arithmetic(s, var_name))
-                    || else_block.as_ref().is_some_and(|blk| {
-                        blk.iter().any(|s| self.statement_uses_pointer_arithmetic(s, var_name))
-                    })
-            }
-            // DECY-164: Check for post/pre increment/decrement on the variable
-            HirStatement::Expression(expr) => {
-                Self::expression_uses_pointer_arithmetic_static(expr, var_name)
-            }
-            HirStatement::While { body, .. } | HirStatement::For { body, .. } => {
-                body.iter().any(|s| self.statement_uses_pointer_arithmetic(s, var_name))
-            }
-            _ => false,
-        }
-    }
-
-    /// DECY-164: Check if an expression uses pointer arithmetic on a variable.
-    /// Catches str++, ++str, str--, --str patterns.
-    fn expression_uses_pointer_arithmetic_static(expr: &HirExpression, var_name: &str) -> bool {
-        match expr {
-            HirExpression::PostIncrement { operand }
-            | HirExpression::PreIncrement { operand }
-            | HirExpression::PostDecrement { operand }
-            | HirExpression::PreDecrement { operand } => {
-                matches!(&**operand, HirExpression::Variable(name) if name == var_name)
-            }
-            _ => false,
-        }
+        decy_ownership::raw_pointer::needs_raw_pointer(func, param_name)
     }
 
     /// DECY-134b: Get all string iteration params for a function.
@@ -886,4 +728,45 @@ impl CodeGenerator {
 
         result
     }
+
+    /// Body prologue for `buffered_stdout` mode: one locked, buffered stdout
+    /// writer shared by every printf-family call in a function that prints.
+    ///
+    /// `BufWriter` flushes when it drops at function return; `exit`, `return`
+    /// from `main` and calls that may print or read stdin flush explicitly.
+    pub(crate) fn buffered_stdout_prologue(
+        &self,
+        func: &HirFunction,
+        ctx: &mut TypeContext,
+    ) -> &'static str {
+        if !self.options().buffered_stdout {
+            return "";
+        }
+        let mut scan = StdoutWriteScan { found: false };
+        walk_statements(&mut scan, func.body());
+        if !scan.found {
+            return "";
+        }
+        ctx.enable_buffered_stdout();
+        "    use std::io::Write as _;\n    let mut __stdout = std::io::BufWriter::new(std::io::stdout().lock());\n"
+    }
+}
+
+/// Finds printf-family calls that write to stdout.
+struct StdoutWriteScan {
+    found: bool,
+}
+
+impl Visitor for StdoutWriteScan {
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        if let HirExpression::FunctionCall { function, arguments } = expr {
+            let to_stdout = |idx: usize| matches!(arguments.get(idx), Some(HirExpression::Variable(name)) if name == "stdout");
+            self.found |= match function.as_str() {
+                "printf" | "puts" | "putchar" => true,
+                "fprintf" => to_stdout(0),
+                "fputs" | "fputc" | "putc" => to_stdout(1),
+                _ => false,
+            };
+        }
+    }
 }
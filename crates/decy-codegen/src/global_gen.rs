@@ -0,0 +1,407 @@
+//! Storage selection and access code for C file-scope variables and errno.
+//!
+//! Every C global used to become a `static mut`, so each access needed an
+//! `unsafe` block and the compiler had to assume any call could change it.
+//! One pass over the whole translation unit now picks the narrowest storage
+//! that preserves the program's behaviour:
+//!
+//! - A global that is never written and never aliased is read without
+//!   `unsafe`: a lookup table becomes a plain `static` indexed in place, and
+//!   a scalar tuning constant a `const` the compiler folds into its uses.
+//! - An integer scalar written only by assignment, `++` and `--` is an
+//!   `Atomic*` accessed with `Relaxed` ordering, provided the program either
+//!   starts no threads or takes locks around its shared state. Under either
+//!   condition no two unsynchronised writers exist, so updates are a plain
+//!   load and store rather than a locked read-modify-write instruction.
+//! - Anything else (floats, pointers, structs, aliased globals) stays
+//!   `static mut`.
+//!
+//! `errno` becomes a thread-local `Cell<i32>` and is only declared when the
+//! program reads or writes it.
+
+use super::{CodeGenerator, TypeContext};
+use decy_hir::visit::{walk_expression, walk_statements, Visitor};
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirStatement, HirType, UnaryOperator};
+use std::collections::HashMap;
+
+/// Memory ordering used for every atomic global access.
+const RELAXED: &str = "std::sync::atomic::Ordering::Relaxed";
+
+/// How a C file-scope variable is stored in the generated Rust module.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum GlobalStorage {
+    /// `static mut`, accessed inside `unsafe` blocks
+    #[default]
+    Mutable,
+    /// `static` atomic integer, accessed with `Relaxed` loads, stores and
+    /// read-modify-write operations
+    Atomic,
+    /// Plain `static`: never written and never aliased
+    Immutable,
+}
+
+/// Storage chosen for each global of a translation unit, and whether the
+/// unit uses `errno`.
+///
+/// # Examples
+///
+/// ```
+/// use decy_codegen::{GlobalStorage, ModuleStatics};
+/// use decy_hir::{HirExpression, HirFunction, HirStatement, HirType};
+///
+/// let globals = vec![
+///     HirStatement::VariableDeclaration {
+///         name: "limit".to_string(),
+///         var_type: HirType::Int,
+///         initializer: Some(HirExpression::IntLiteral(10)),
+///     },
+///     HirStatement::VariableDeclaration {
+///         name: "hits".to_string(),
+///         var_type: HirType::Int,
+///         initializer: None,
+///     },
+/// ];
+/// let bump = HirFunction::new_with_body(
+///     "bump".to_string(),
+///     HirType::Void,
+///     vec![],
+///     vec![HirStatement::Expression(HirExpression::PostIncrement {
+///         operand: Box::new(HirExpression::Variable("hits".to_string())),
+///     })],
+/// );
+///
+/// let statics = ModuleStatics::analyze(&globals, [&bump]);
+/// assert_eq!(statics.storage("limit"), GlobalStorage::Immutable);
+/// assert_eq!(statics.storage("hits"), GlobalStorage::Atomic);
+/// assert!(!statics.uses_errno());
+/// ```
+#[derive(Debug, Clone, Default)]
+pub struct ModuleStatics {
+    storage: HashMap<String, GlobalStorage>,
+    uses_errno: bool,
+}
+
+impl ModuleStatics {
+    /// Classify `variables` (the unit's global declarations) from every
+    /// function that can access them.
+    pub fn analyze<'a>(
+        variables: &[HirStatement],
+        functions: impl IntoIterator<Item = &'a HirFunction>,
+    ) -> Self {
+        let mut scan = StaticsScan::new(variables);
+        functions.into_iter().for_each(|func| scan.observe(func));
+        scan.finish()
+    }
+
+    /// Storage of a global; names that were not analyzed are `static mut`.
+    pub fn storage(&self, name: &str) -> GlobalStorage {
+        self.storage.get(name).copied().unwrap_or_default()
+    }
+
+    /// Whether any function reads or writes `errno`.
+    pub fn uses_errno(&self) -> bool {
+        self.uses_errno
+    }
+}
+
+impl CodeGenerator {
+    /// Declaration of the global `name` with the storage chosen for it.
+    ///
+    /// `type_str` is the Rust type of a `static mut` of this global and
+    /// `init_code` its constant initializer.
+    pub fn generate_global_declaration(
+        &self,
+        name: &str,
+        var_type: &HirType,
+        type_str: &str,
+        init_code: &str,
+    ) -> String {
+        match (self.statics.storage(name), atomic_type(var_type)) {
+            // Scalars inline as `const`; tables and anything else stay one
+            // `static` in memory
+            (GlobalStorage::Immutable, _) if is_scalar(var_type) => {
+                format!("const {}: {} = {};\n", name, type_str, init_code)
+            }
+            (GlobalStorage::Immutable, _) => {
+                format!("static {}: {} = {};\n", name, type_str, init_code)
+            }
+            (GlobalStorage::Atomic, Some(atomic)) => {
+                format!("static {}: {} = {}::new({});\n", name, atomic, atomic, init_code)
+            }
+            _ => format!("static mut {}: {} = {};\n", name, type_str, init_code),
+        }
+    }
+
+    /// The thread-local `errno` cell, when the unit reads or writes errno.
+    pub fn generate_errno_declaration(&self) -> Option<&'static str> {
+        self.statics.uses_errno().then_some(
+            "thread_local! {\n    \
+             static ERRNO: std::cell::Cell<i32> = const { std::cell::Cell::new(0) };\n}\n",
+        )
+    }
+
+    /// A `Relaxed` load of an atomic global.
+    pub(crate) fn atomic_global_load(name: &str) -> String {
+        format!("{}.load({})", name, RELAXED)
+    }
+
+    /// `g = value;` on an atomic global; reads of `g` in `value` are loads.
+    pub(crate) fn generate_atomic_global_store(
+        &self,
+        target: &str,
+        value: &HirExpression,
+        ctx: &TypeContext,
+    ) -> Option<String> {
+        if !ctx.is_atomic_global(target) {
+            return None;
+        }
+        let value_code =
+            self.generate_expression_with_target_type(value, ctx, ctx.get_type(target));
+        Some(format!("{}.store({}, {});", target, value_code, RELAXED))
+    }
+
+    /// `g++`, `++g`, `g--` or `--g` on an atomic global, yielding the old
+    /// value (postfix) or the new one (prefix).
+    pub(crate) fn generate_atomic_global_step(
+        operand: &HirExpression,
+        ctx: &TypeContext,
+        increment: bool,
+        prefix: bool,
+    ) -> Option<String> {
+        let HirExpression::Variable(name) = operand else {
+            return None;
+        };
+        if !ctx.is_atomic_global(name) {
+            return None;
+        }
+        let step = if increment { "wrapping_add" } else { "wrapping_sub" };
+        let load = Self::atomic_global_load(name);
+        Some(if prefix {
+            format!(
+                "{{ let __tmp = {}.{}(1); {}.store(__tmp, {}); __tmp }}",
+                load, step, name, RELAXED
+            )
+        } else {
+            format!(
+                "{{ let __tmp = {}; {}.store(__tmp.{}(1), {}); __tmp }}",
+                load, name, step, RELAXED
+            )
+        })
+    }
+}
+
+/// How the functions of a unit touch one global.
+#[derive(Debug, Clone, Default)]
+struct GlobalAccess {
+    /// Written by assignment or increment
+    written: bool,
+    /// Written in a form an atomic cannot express (through an index, a
+    /// field or a dereference, or by an assignment expression)
+    complex_write: bool,
+    /// Address taken or shadowed by a local or parameter
+    aliased: bool,
+    /// Times the name appears as an expression
+    uses: usize,
+    /// Uses that only read through it: `g[i]` and `g.len()`
+    contained_uses: usize,
+}
+
+/// Incremental form of [`ModuleStatics::analyze`] for callers that lower and
+/// drop one function at a time.
+#[derive(Debug, Clone)]
+pub struct StaticsScan {
+    globals: HashMap<String, (HirType, GlobalAccess)>,
+    uses_errno: bool,
+    spawns_threads: bool,
+    takes_locks: bool,
+}
+
+impl StaticsScan {
+    /// Start a scan over the unit's global declarations. Their initializers
+    /// are scanned too, since `int *p = &g;` aliases `g`.
+    pub fn new(variables: &[HirStatement]) -> Self {
+        let globals = variables
+            .iter()
+            .filter_map(|stmt| match stmt {
+                HirStatement::VariableDeclaration { name, var_type, .. } => {
+                    Some((name.clone(), (var_type.clone(), GlobalAccess::default())))
+                }
+                _ => None,
+            })
+            .collect();
+        let mut scan =
+            Self { globals, uses_errno: false, spawns_threads: false, takes_locks: false };
+        for stmt in variables {
+            if let HirStatement::VariableDeclaration { initializer: Some(init), .. } = stmt {
+                walk_expression(&mut scan, init);
+            }
+        }
+        scan
+    }
+
+    /// Record every access one function makes.
+    pub fn observe(&mut self, func: &HirFunction) {
+        for param in func.parameters() {
+            self.note(param.name(), |access| access.aliased = true);
+        }
+        walk_statements(self, func.body());
+    }
+
+    /// Decide the storage of every global.
+    pub fn finish(self) -> ModuleStatics {
+        let atomics_allowed = !self.spawns_threads || self.takes_locks;
+        let storage = self
+            .globals
+            .into_iter()
+            .map(|(name, (var_type, access))| {
+                // An array name used other than by indexing decays to a pointer
+                let decays = matches!(var_type, HirType::Array { .. })
+                    && access.uses > access.contained_uses;
+                let storage = if access.aliased || decays {
+                    GlobalStorage::Mutable
+                } else if !access.written && is_read_only_type(&var_type) {
+                    GlobalStorage::Immutable
+                } else if !access.complex_write
+                    && atomics_allowed
+                    && atomic_type(&var_type).is_some()
+                {
+                    GlobalStorage::Atomic
+                } else {
+                    GlobalStorage::Mutable
+                };
+                (name, storage)
+            })
+            .collect();
+        ModuleStatics { storage, uses_errno: self.uses_errno }
+    }
+
+    fn note(&mut self, name: &str, update: impl FnOnce(&mut GlobalAccess)) {
+        if let Some((_, access)) = self.globals.get_mut(name) {
+            update(access);
+        }
+    }
+
+    fn note_contained(&mut self, receiver: &HirExpression) {
+        if let HirExpression::Variable(name) = receiver {
+            self.note(name, |access| access.contained_uses += 1);
+        }
+    }
+
+    /// A write to `target`: plain when it names the global itself, complex
+    /// when it goes through an index, field or dereference of it.
+    fn note_write(&mut self, target: &HirExpression, complex: bool) {
+        let complex = complex || !matches!(target, HirExpression::Variable(_));
+        if let Some(name) = root_variable(target) {
+            self.note(name, |access| {
+                access.written = true;
+                access.complex_write |= complex;
+            });
+        }
+    }
+}
+
+impl Visitor for StaticsScan {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        match stmt {
+            HirStatement::VariableDeclaration { name, .. } => {
+                self.note(name, |access| access.aliased = true)
+            }
+            HirStatement::Assignment { target, .. } => {
+                self.uses_errno |= target == "errno";
+                self.note(target, |access| access.written = true);
+            }
+            HirStatement::ArrayIndexAssignment { array, .. } => self.note_write(array, true),
+            HirStatement::FieldAssignment { object: target, .. }
+            | HirStatement::DerefAssignment { target, .. } => self.note_write(target, true),
+            _ => {}
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        match expr {
+            HirExpression::Variable(name) => {
+                self.uses_errno |= name == "errno";
+                self.note(name, |access| access.uses += 1);
+            }
+            HirExpression::ArrayIndex { array, .. } => self.note_contained(array),
+            HirExpression::StringMethodCall { receiver, method, arguments }
+                if method == "len" && arguments.is_empty() =>
+            {
+                self.note_contained(receiver)
+            }
+            HirExpression::PostIncrement { operand }
+            | HirExpression::PreIncrement { operand }
+            | HirExpression::PostDecrement { operand }
+            | HirExpression::PreDecrement { operand }
+            | HirExpression::UnaryOp {
+                op:
+                    UnaryOperator::PostIncrement
+                    | UnaryOperator::PreIncrement
+                    | UnaryOperator::PostDecrement
+                    | UnaryOperator::PreDecrement,
+                operand,
+            } => self.note_write(operand, false),
+            HirExpression::BinaryOp { op: BinaryOperator::Assign, left, .. } => {
+                self.note_write(left, true)
+            }
+            HirExpression::AddressOf(inner)
+            | HirExpression::UnaryOp { op: UnaryOperator::AddressOf, operand: inner } => {
+                if let Some(name) = root_variable(inner) {
+                    self.note(name, |access| access.aliased = true);
+                }
+            }
+            HirExpression::FunctionCall { function, .. } => match function.as_str() {
+                "pthread_create" | "thrd_create" => self.spawns_threads = true,
+                "pthread_mutex_lock" | "mtx_lock" => self.takes_locks = true,
+                _ => {}
+            },
+            _ => {}
+        }
+    }
+}
+
+/// The variable an lvalue is rooted in: `g`, `g[i]`, `g.f`, `*g`.
+fn root_variable(expr: &HirExpression) -> Option<&str> {
+    match expr {
+        HirExpression::Variable(name) => Some(name),
+        HirExpression::ArrayIndex { array: inner, .. }
+        | HirExpression::FieldAccess { object: inner, .. }
+        | HirExpression::Dereference(inner)
+        | HirExpression::Cast { expr: inner, .. } => root_variable(inner),
+        _ => None,
+    }
+}
+
+/// Types a plain `static` can hold: scalars and arrays of scalars, which are
+/// `Sync` and const-initialisable.
+fn is_read_only_type(var_type: &HirType) -> bool {
+    match var_type {
+        HirType::Array { element_type, size: Some(_) } => is_read_only_type(element_type),
+        _ => is_scalar(var_type),
+    }
+}
+
+/// Arithmetic scalars, which are cheap to inline at every use.
+fn is_scalar(var_type: &HirType) -> bool {
+    matches!(
+        var_type,
+        HirType::Bool
+            | HirType::Int
+            | HirType::UnsignedInt
+            | HirType::Float
+            | HirType::Double
+            | HirType::Char
+            | HirType::SignedChar
+    )
+}
+
+/// The atomic type for an integer scalar global.
+fn atomic_type(var_type: &HirType) -> Option<&'static str> {
+    match var_type {
+        HirType::Int => Some("std::sync::atomic::AtomicI32"),
+        HirType::UnsignedInt => Some("std::sync::atomic::AtomicU32"),
+        HirType::Char => Some("std::sync::atomic::AtomicU8"),
+        HirType::SignedChar => Some("std::sync::atomic::AtomicI8"),
+        _ => None,
+    }
+}
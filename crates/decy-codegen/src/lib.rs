@@ -41,9 +41,15 @@ pub mod test_generator;
 mod transform_gen;
 mod type_gen;
 
+use alloc_gen::GrowthBuffer;
+use decy_analyzer::comparator_analysis::KeyComparator;
+use decy_analyzer::dispatch_analysis::StaticDispatch;
+use decy_analyzer::stdio_analysis::QuietFunctions;
 use decy_hir::{HirExpression, HirFunction, HirType};
 use std::collections::HashMap;
 
+pub use global_gen::{GlobalStorage, ModuleStatics, StaticsScan};
+
 /// Type context for tracking variable types and struct definitions during code generation.
 /// Used to detect pointer arithmetic, null pointer assignments, and other type-specific operations.
 #[derive(Debug, Clone)]
@@ -61,10 +67,35 @@ struct TypeContext {
     // DECY-134b: Track which functions have string iteration params (for call site transformation)
     // Maps func_name -> list of (param_index, is_mutable) for string iter params
     string_iter_funcs: HashMap<String, Vec<(usize, bool)>>,
-    // DECY-220: Track global variables (static mut) that need unsafe access
-    globals: std::collections::HashSet<String>,
+    // DECY-220: Track global variables and how each is stored
+    globals: HashMap<String, GlobalStorage>,
     // DECY-245: Track locals renamed to avoid shadowing statics (original_name -> renamed_name)
     renamed_locals: HashMap<String, String>,
+    // Locals holding a buffered fopen() handle (name -> stream direction)
+    file_streams: HashMap<String, FileStream>,
+    // Whether the function body writes stdout through a locked `__stdout` BufWriter
+    buffered_stdout: bool,
+    // Counted-loop induction variables indexed through a usize binding (C name -> binding)
+    loop_indices: HashMap<String, String>,
+    // String-iteration params walked by a byte iterator (param -> element binding)
+    walked_bytes: HashMap<String, String>,
+    // Pointer locals used as dynamic arrays and lowered to a Vec grown by push
+    growth_buffers: HashMap<String, GrowthBuffer>,
+    // Loop-body malloc buffers declared once before their loop and reused
+    scratch_buffers: std::collections::HashSet<String>,
+    // Callback parameters of this function taken as a generic `FnMut`
+    generic_callbacks: std::collections::HashSet<String>,
+    // Function-pointer locals lowered to direct calls (local -> functions it may hold)
+    dispatch_locals: HashMap<String, Vec<String>>,
+}
+
+/// Direction of a buffered `FILE*` stream opened by `fopen`.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum FileStream {
+    /// Opened for reading: `Option<BufReader<File>>`
+    Reader,
+    /// Opened for writing or appending: `Option<BufWriter<File>>`
+    Writer,
 }
 
 impl TypeContext {
@@ -76,11 +107,86 @@ impl TypeContext {
             slice_func_args: HashMap::new(),
             string_iter_params: HashMap::new(),
             string_iter_funcs: HashMap::new(),
-            globals: std::collections::HashSet::new(),
+            globals: HashMap::new(),
             renamed_locals: HashMap::new(),
+            file_streams: HashMap::new(),
+            buffered_stdout: false,
+            loop_indices: HashMap::new(),
+            walked_bytes: HashMap::new(),
+            growth_buffers: HashMap::new(),
+            scratch_buffers: std::collections::HashSet::new(),
+            generic_callbacks: std::collections::HashSet::new(),
+            dispatch_locals: HashMap::new(),
         }
     }
 
+    /// Route printf-family output through the function's `__stdout` writer.
+    fn enable_buffered_stdout(&mut self) {
+        self.buffered_stdout = true;
+    }
+
+    /// Whether printf-family output goes through the function's `__stdout` writer.
+    fn has_buffered_stdout(&self) -> bool {
+        self.buffered_stdout
+    }
+
+    /// Index arrays with `binding` (a usize range variable) wherever `name` is the index.
+    fn bind_loop_index(&mut self, name: String, binding: String) {
+        self.loop_indices.insert(name, binding);
+    }
+
+    fn unbind_loop_index(&mut self, name: &str) {
+        self.loop_indices.remove(name);
+    }
+
+    /// The usize binding standing in for a counted-loop index, if `name` is one.
+    fn loop_index(&self, name: &str) -> Option<&str> {
+        self.loop_indices.get(name).map(String::as_str)
+    }
+
+    /// Read `*name` as `binding`, the current byte of an iterator walk over `name`.
+    fn bind_walked_byte(&mut self, name: String, binding: String) {
+        self.walked_bytes.insert(name, binding);
+    }
+
+    fn unbind_walked_byte(&mut self, name: &str) {
+        self.walked_bytes.remove(name);
+    }
+
+    /// The byte binding standing in for `*name` inside a string walk, if any.
+    fn walked_byte(&self, name: &str) -> Option<&str> {
+        self.walked_bytes.get(name).map(String::as_str)
+    }
+
+    /// The length and capacity variables of a pointer lowered to a growing Vec.
+    fn growth_buffer(&self, name: &str) -> Option<&GrowthBuffer> {
+        self.growth_buffers.get(name)
+    }
+
+    /// Reuse `name`, declared inside a loop body, across iterations.
+    fn add_scratch_buffer(&mut self, name: String) {
+        self.scratch_buffers.insert(name);
+    }
+
+    fn remove_scratch_buffer(&mut self, name: &str) {
+        self.scratch_buffers.remove(name);
+    }
+
+    /// Whether `name` is a loop-body buffer hoisted before its loop.
+    fn is_scratch_buffer(&self, name: &str) -> bool {
+        self.scratch_buffers.contains(name)
+    }
+
+    /// Register a local that holds a buffered stream handle from `fopen`.
+    fn add_file_stream(&mut self, name: String, stream: FileStream) {
+        self.file_streams.insert(name, stream);
+    }
+
+    /// Get the stream direction of a buffered `fopen` handle, if known.
+    fn get_file_stream(&self, name: &str) -> Option<FileStream> {
+        self.file_streams.get(name).copied()
+    }
+
     /// DECY-245: Register a renamed local variable (for shadowing statics)
     fn add_renamed_local(&mut self, original: String, renamed: String) {
         self.renamed_locals.insert(original, renamed);
@@ -92,13 +198,35 @@ impl TypeContext {
     }
 
     /// DECY-220: Register a global variable (static mut) for unsafe tracking
+    #[cfg(test)]
     fn add_global(&mut self, name: String) {
-        self.globals.insert(name);
+        self.add_static(name, GlobalStorage::Mutable);
+    }
+
+    /// Register a global variable with the storage chosen for it.
+    fn add_static(&mut self, name: String, storage: GlobalStorage) {
+        self.globals.insert(name, storage);
     }
 
-    /// DECY-220: Check if a variable is a global (static mut) requiring unsafe
+    /// DECY-220: Check if a variable is a mutable global (static mut or
+    /// atomic) that other code may change between accesses
     fn is_global(&self, name: &str) -> bool {
-        self.globals.contains(name)
+        matches!(self.globals.get(name), Some(GlobalStorage::Mutable | GlobalStorage::Atomic))
+    }
+
+    /// Whether a variable is a `static mut`, accessed inside `unsafe`.
+    fn is_static_mut(&self, name: &str) -> bool {
+        self.globals.get(name) == Some(&GlobalStorage::Mutable)
+    }
+
+    /// Whether a variable is a global of any storage, which locals must not shadow.
+    fn is_static(&self, name: &str) -> bool {
+        self.globals.contains_key(name)
+    }
+
+    /// Whether a variable is a global lowered to an `Atomic*` integer.
+    fn is_atomic_global(&self, name: &str) -> bool {
+        self.globals.get(name) == Some(&GlobalStorage::Atomic)
     }
 
     /// DECY-134b: Register a function's string iteration params for call site transformation
@@ -142,6 +270,26 @@ impl TypeContext {
         self.slice_func_args.get(func_name)
     }
 
+    /// Register a callback parameter taken as a generic `FnMut`
+    fn add_generic_callback(&mut self, name: String) {
+        self.generic_callbacks.insert(name);
+    }
+
+    /// Whether `name` is a callback parameter taken as a generic `FnMut`
+    fn is_generic_callback(&self, name: &str) -> bool {
+        self.generic_callbacks.contains(name)
+    }
+
+    /// Call the functions a function-pointer local may hold directly
+    fn add_dispatch_local(&mut self, name: String, targets: Vec<String>) {
+        self.dispatch_locals.insert(name, targets);
+    }
+
+    /// The functions a function-pointer local called directly may hold
+    fn dispatch_targets(&self, name: &str) -> Option<&[String]> {
+        self.dispatch_locals.get(name).map(Vec::as_slice)
+    }
+
     /// DECY-117: Get the expected parameter type for a function call
     fn get_function_param_type(&self, func_name: &str, param_index: usize) -> Option<&HirType> {
         self.functions.get(func_name).and_then(|params| params.get(param_index))
@@ -153,6 +301,7 @@ impl TypeContext {
         for param in func.parameters() {
             ctx.variables.insert(param.name().to_string(), param.param_type().clone());
         }
+        ctx.growth_buffers = CodeGenerator::find_growth_buffers(func.body());
         ctx
     }
 
@@ -395,10 +544,42 @@ fn escape_rust_keyword(name: &str) -> String {
     }
 }
 
+/// Opt-in code generation modes.
+///
+/// The defaults produce the most direct translation; each flag trades some
+/// readability of the output for runtime performance.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct CodegenOptions {
+    /// Lower printf/puts/putchar to `write!` on one locked, buffered stdout
+    /// per function instead of a line-flushed `print!` per call. The buffer
+    /// is flushed before `exit`, before calls that may print or read stdin,
+    /// and when the function returns.
+    pub buffered_stdout: bool,
+    /// Sum floating-point reductions (sums and dot products over arrays) in
+    /// several independent lanes so they vectorise. This reassociates the
+    /// additions, so results may differ from C in the last bits.
+    pub reassociate_float_reductions: bool,
+    /// Allocate self-referential structs (list and tree nodes) from one
+    /// `Vec` arena per struct type and link them by `u32` index instead of
+    /// by pointer. Functions that touch the nodes take the arena as an extra
+    /// leading parameter.
+    pub index_arenas: bool,
+}
+
 /// Code generator for converting HIR to Rust source code.
 #[derive(Debug, Clone)]
 pub struct CodeGenerator {
     box_transformer: box_transform::BoxTransformer,
+    options: CodegenOptions,
+    statics: ModuleStatics,
+    // Callback parameters taken as a generic `FnMut`: func_name -> [(param_index, param_name)]
+    generic_callbacks: HashMap<String, Vec<(usize, String)>>,
+    // qsort/bsearch comparators ordering by one integer key: func_name -> key
+    comparators: HashMap<String, KeyComparator>,
+    // Function pointers whose calls are dispatched statically
+    dispatch: StaticDispatch,
+    // Callees that never reach stdio, so buffered stdout is not flushed before them
+    quiet: QuietFunctions,
 }
 
 impl CodeGenerator {
@@ -412,7 +593,98 @@ impl CodeGenerator {
     /// let codegen = CodeGenerator::new();
     /// ```
     pub fn new() -> Self {
-        Self { box_transformer: box_transform::BoxTransformer::new() }
+        Self {
+            box_transformer: box_transform::BoxTransformer::new(),
+            options: CodegenOptions::default(),
+            statics: ModuleStatics::default(),
+            generic_callbacks: HashMap::new(),
+            comparators: HashMap::new(),
+            dispatch: StaticDispatch::default(),
+            quiet: QuietFunctions::default(),
+        }
+    }
+
+    /// Create a code generator with the given opt-in modes.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use decy_codegen::{CodeGenerator, CodegenOptions};
+    ///
+    /// let options = CodegenOptions { buffered_stdout: true, ..Default::default() };
+    /// let codegen = CodeGenerator::with_options(options);
+    /// assert!(codegen.options().buffered_stdout);
+    /// ```
+    pub fn with_options(options: CodegenOptions) -> Self {
+        Self { options, ..Self::new() }
+    }
+
+    /// The opt-in modes this generator was created with.
+    pub fn options(&self) -> &CodegenOptions {
+        &self.options
+    }
+
+    /// Generate globals and their accesses with the storage chosen for the
+    /// translation unit, instead of `static mut` for every global.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use decy_codegen::{CodeGenerator, ModuleStatics};
+    /// use decy_hir::{HirExpression, HirStatement, HirType};
+    ///
+    /// let table = vec![HirStatement::VariableDeclaration {
+    ///     name: "limit".to_string(),
+    ///     var_type: HirType::Int,
+    ///     initializer: Some(HirExpression::IntLiteral(10)),
+    /// }];
+    /// let codegen =
+    ///     CodeGenerator::new().with_module_statics(ModuleStatics::analyze(&table, []));
+    /// let code = codegen.generate_global_declaration("limit", &HirType::Int, "i32", "10");
+    /// assert_eq!(code, "const limit: i32 = 10;\n");
+    /// ```
+    pub fn with_module_statics(self, statics: ModuleStatics) -> Self {
+        Self { statics, ..self }
+    }
+
+    /// Take the given callback parameters as a generic `F: FnMut` instead of
+    /// a `fn` pointer, so the function passed in can be inlined.
+    ///
+    /// Each entry names a function and the position and name of each such
+    /// parameter. Their pointer arguments are passed as `&mut T`, and
+    /// functions named at those positions in calls are wrapped in a closure.
+    pub fn with_generic_callbacks(
+        self,
+        callbacks: impl IntoIterator<Item = (String, Vec<(usize, String)>)>,
+    ) -> Self {
+        Self { generic_callbacks: callbacks.into_iter().collect(), ..self }
+    }
+
+    /// Sort and search with the key of these comparators when they are
+    /// passed to `qsort`/`bsearch`, instead of calling them.
+    pub fn with_comparators(
+        self,
+        comparators: impl IntoIterator<Item = (String, KeyComparator)>,
+    ) -> Self {
+        Self { comparators: comparators.into_iter().collect(), ..self }
+    }
+
+    /// Dispatch calls through these function pointers statically: parameters
+    /// become `impl Fn`, and locals holding known functions are called
+    /// directly or through a `match` over an enum of those functions.
+    pub fn with_static_dispatch(self, dispatch: StaticDispatch) -> Self {
+        Self { dispatch, ..self }
+    }
+
+    /// With buffered stdout, keep the buffer across calls to these functions
+    /// instead of flushing before every call decy does not lower itself.
+    pub fn with_quiet_functions(self, quiet: QuietFunctions) -> Self {
+        Self { quiet, ..self }
+    }
+
+    /// The generic callback parameters of a function, if any.
+    fn generic_callbacks_of(&self, function: &str) -> &[(usize, String)] {
+        self.generic_callbacks.get(function).map_or(&[], Vec::as_slice)
     }
 
     /// DECY-143: Generate unsafe block with SAFETY comment.
@@ -944,8 +1216,11 @@ impl CodeGenerator {
     }
 }
 
+mod alloc_gen;
 mod expr_gen;
 mod func_gen;
+mod global_gen;
+mod reduction_gen;
 mod stmt_gen;
 
 impl Default for CodeGenerator {
@@ -0,0 +1,470 @@
+//! Reduction loop code generation methods for CodeGenerator.
+//!
+//! Counted loops whose whole body folds array elements into one accumulator
+//! (sums, dot products, counts, minimum and maximum) are emitted as iterator
+//! chains over the indexed slices. Integer reductions become `sum`, `fold`
+//! and `filter().count()`, which LLVM vectorises; floating-point reductions
+//! keep C's left-to-right order through `fold` unless
+//! [`CodegenOptions::reassociate_float_reductions`](crate::CodegenOptions)
+//! allows splitting them across independent lanes.
+
+use super::{CodeGenerator, TypeContext};
+use decy_hir::visit::{fold_expression_children, walk_expression, Fold, Visitor};
+use decy_hir::{BinaryOperator, HirExpression, HirStatement, HirType, UnaryOperator};
+
+/// Lanes used by reassociated floating-point reductions.
+const FLOAT_LANES: usize = 8;
+
+/// Closure names bound to the elements of the first and second array.
+const OPERAND_NAMES: [&str; 2] = ["__x", "__y"];
+
+/// An array element `a[i]`, optionally cast: `(T)a[i]`.
+struct Operand<'a> {
+    array: &'a str,
+    cast: Option<&'a HirType>,
+}
+
+/// The accumulator update a reduction loop performs each iteration.
+enum Reduction<'a> {
+    /// `acc = acc + a[i]` or `acc = acc + a[i] * b[i]`
+    Sum { acc: &'a str, operands: Vec<Operand<'a>> },
+    /// `if (pred(a[i])) acc++;`
+    Count { acc: &'a str, pred: &'a HirExpression },
+    /// `if (a[i] > acc) acc = a[i];` and the other comparisons
+    Extreme { acc: &'a str, operand: Operand<'a>, op: BinaryOperator },
+}
+
+impl CodeGenerator {
+    /// Lower `for (int i = 0; i < bound; i++) <reduction>` to an iterator chain.
+    ///
+    /// `bound` names the variable or array the C bound reads, `end` is the
+    /// generated usize bound and `whole` the array whose full length it is, if
+    /// any; other arrays are sliced to `..end` so that a short buffer still
+    /// panics where C would read out of bounds.
+    #[allow(clippy::too_many_arguments)]
+    pub(crate) fn generate_reduction(
+        &self,
+        index: &str,
+        bound: Option<&String>,
+        end: &str,
+        whole: Option<&str>,
+        body: &[HirStatement],
+        ctx: &mut TypeContext,
+    ) -> Option<String> {
+        let [stmt] = body else {
+            return None;
+        };
+        let reduction = Self::match_reduction(stmt, index)?;
+        let acc = match &reduction {
+            Reduction::Sum { acc, .. }
+            | Reduction::Count { acc, .. }
+            | Reduction::Extreme { acc, .. } => *acc,
+        };
+        if acc == index || bound.is_some_and(|b| b == acc) || ctx.is_global(acc) {
+            return None;
+        }
+        let acc_ty = Self::map_type(ctx.get_type(acc)?);
+        let is_float = Self::numeric_kind(&acc_ty)?;
+
+        match reduction {
+            Reduction::Sum { operands, .. } => {
+                let arrays = self.reduction_arrays(&operands, &acc_ty, ctx)?;
+                let slices = self.reduction_slices(&arrays, end, whole, ctx);
+                if is_float && self.options.reassociate_float_reductions {
+                    return Some(Self::chunked_float_sum(
+                        acc, &acc_ty, &arrays, &operands, &slices,
+                    ));
+                }
+                let term = Self::reduction_term(&arrays, &operands, OPERAND_NAMES);
+                let values = Self::reduction_values(&slices, &term);
+                Some(if is_float {
+                    // Float addition is not associative: keep C's evaluation order
+                    format!("{} = {}.fold({}, |__acc, __v| __acc + __v);", acc, values, acc)
+                } else {
+                    format!("{} = {} + {}.sum::<{}>();", acc, acc, values, acc_ty)
+                })
+            }
+            Reduction::Count { pred, .. } => {
+                if is_float {
+                    return None;
+                }
+                self.generate_count(acc, &acc_ty, pred, index, end, whole, ctx)
+            }
+            Reduction::Extreme { operand, op, .. } => {
+                let operands = [operand];
+                let arrays = self.reduction_arrays(&operands, &acc_ty, ctx)?;
+                let slices = self.reduction_slices(&arrays, end, whole, ctx);
+                let term = Self::reduction_term(&arrays, &operands, OPERAND_NAMES);
+                let values = Self::reduction_values(&slices, &term);
+                let pick = if is_float {
+                    // Comparisons with NaN decide the result: keep the C comparison
+                    format!(
+                        "if __v {} __m {{ __v }} else {{ __m }}",
+                        Self::binary_operator_to_string(&op)
+                    )
+                } else if matches!(op, BinaryOperator::GreaterThan | BinaryOperator::GreaterEqual) {
+                    "__m.max(__v)".to_string()
+                } else {
+                    "__m.min(__v)".to_string()
+                };
+                Some(format!("{} = {}.fold({}, |__m, __v| {});", acc, values, acc, pick))
+            }
+        }
+    }
+
+    /// Recognise the reduction performed by a single loop body statement.
+    fn match_reduction<'a>(stmt: &'a HirStatement, index: &str) -> Option<Reduction<'a>> {
+        match stmt {
+            // acc = acc + term  |  acc = term + acc
+            HirStatement::Assignment {
+                target,
+                value: HirExpression::BinaryOp { op: BinaryOperator::Add, left, right },
+            } => {
+                let term = match (&**left, &**right) {
+                    (HirExpression::Variable(v), term) | (term, HirExpression::Variable(v))
+                        if v == target =>
+                    {
+                        term
+                    }
+                    _ => return None,
+                };
+                let operands = match term {
+                    HirExpression::BinaryOp { op: BinaryOperator::Multiply, left, right } => {
+                        vec![Self::operand(left, index)?, Self::operand(right, index)?]
+                    }
+                    term => vec![Self::operand(term, index)?],
+                };
+                Some(Reduction::Sum { acc: target, operands })
+            }
+            HirStatement::If { condition, then_block, else_block: None } => {
+                let [update] = then_block.as_slice() else {
+                    return None;
+                };
+                // if (pred) acc++;
+                if let Some(acc) = Self::increment_target(update) {
+                    return Some(Reduction::Count { acc, pred: condition });
+                }
+                // if (a[i] > acc) acc = a[i];
+                let HirStatement::Assignment { target, value } = update else {
+                    return None;
+                };
+                let HirExpression::BinaryOp { op, left, right } = condition else {
+                    return None;
+                };
+                let is_acc =
+                    |e: &HirExpression| matches!(e, HirExpression::Variable(v) if v == target);
+                let op = match (is_acc(left), is_acc(right)) {
+                    (false, true) if **left == *value => *op,
+                    (true, false) if **right == *value => Self::flip_comparison(*op)?,
+                    _ => return None,
+                };
+                if !matches!(
+                    op,
+                    BinaryOperator::GreaterThan
+                        | BinaryOperator::GreaterEqual
+                        | BinaryOperator::LessThan
+                        | BinaryOperator::LessEqual
+                ) {
+                    return None;
+                }
+                let operand = Self::operand(value, index)?;
+                Some(Reduction::Extreme { acc: target, operand, op })
+            }
+            _ => None,
+        }
+    }
+
+    /// `a[i]` or `(T)a[i]` indexed by the loop variable.
+    fn operand<'a>(expr: &'a HirExpression, index: &str) -> Option<Operand<'a>> {
+        let (expr, cast) = match expr {
+            HirExpression::Cast { target_type, expr } => (&**expr, Some(target_type)),
+            expr => (expr, None),
+        };
+        match expr {
+            HirExpression::ArrayIndex { array, index: i } if matches!(&**i, HirExpression::Variable(v) if v == index) => {
+                match &**array {
+                    HirExpression::Variable(array) => Some(Operand { array, cast }),
+                    _ => None,
+                }
+            }
+            _ => None,
+        }
+    }
+
+    /// The accumulator of `acc++`, `++acc` or `acc = acc + 1`.
+    fn increment_target(stmt: &HirStatement) -> Option<&str> {
+        match stmt {
+            HirStatement::Assignment {
+                target,
+                value: HirExpression::BinaryOp { op: BinaryOperator::Add, left, right },
+            } if matches!(&**left, HirExpression::Variable(v) if v == target)
+                && matches!(**right, HirExpression::IntLiteral(1)) =>
+            {
+                Some(target)
+            }
+            HirStatement::Expression(
+                HirExpression::PostIncrement { operand } | HirExpression::PreIncrement { operand },
+            ) => match &**operand {
+                HirExpression::Variable(v) => Some(v),
+                _ => None,
+            },
+            _ => None,
+        }
+    }
+
+    /// `acc < x` is `x > acc`.
+    fn flip_comparison(op: BinaryOperator) -> Option<BinaryOperator> {
+        Some(match op {
+            BinaryOperator::LessThan => BinaryOperator::GreaterThan,
+            BinaryOperator::LessEqual => BinaryOperator::GreaterEqual,
+            BinaryOperator::GreaterThan => BinaryOperator::LessThan,
+            BinaryOperator::GreaterEqual => BinaryOperator::LessEqual,
+            _ => return None,
+        })
+    }
+
+    /// `Some(true)` for Rust float types, `Some(false)` for integer types.
+    fn numeric_kind(rust_type: &str) -> Option<bool> {
+        match rust_type {
+            "f32" | "f64" => Some(true),
+            "i8" | "i16" | "i32" | "i64" | "isize" | "u8" | "u16" | "u32" | "u64" | "usize" => {
+                Some(false)
+            }
+            _ => None,
+        }
+    }
+
+    /// The distinct arrays the operands read, in order, if every operand is a
+    /// local buffer whose (cast) element type is the accumulator type.
+    fn reduction_arrays<'a>(
+        &self,
+        operands: &[Operand<'a>],
+        acc_ty: &str,
+        ctx: &TypeContext,
+    ) -> Option<Vec<&'a str>> {
+        let mut arrays: Vec<&str> = Vec::new();
+        for operand in operands {
+            let element = Self::buffer_element(operand.array, ctx)?;
+            if Self::map_type(operand.cast.unwrap_or(element)) != acc_ty {
+                return None;
+            }
+            if !arrays.contains(&operand.array) {
+                arrays.push(operand.array);
+            }
+        }
+        (arrays.len() <= OPERAND_NAMES.len()).then_some(arrays)
+    }
+
+    /// Element type of a local array, Vec or slice.
+    fn buffer_element<'a>(name: &str, ctx: &'a TypeContext) -> Option<&'a HirType> {
+        if ctx.is_global(name) || ctx.is_pointer(name) {
+            return None;
+        }
+        let buffer = match ctx.get_type(name)? {
+            HirType::Reference { inner, .. } => inner.as_ref(),
+            other => other,
+        };
+        match buffer {
+            HirType::Array { element_type, .. } => Some(element_type),
+            HirType::Vec(element) => Some(element),
+            _ => None,
+        }
+    }
+
+    /// `a[..end]` for each array, or `a` when `end` is its length.
+    fn reduction_slices(
+        &self,
+        arrays: &[&str],
+        end: &str,
+        whole: Option<&str>,
+        ctx: &TypeContext,
+    ) -> Vec<String> {
+        arrays
+            .iter()
+            .map(|array| {
+                let code = self.generate_expression_with_context(
+                    &HirExpression::Variable(array.to_string()),
+                    ctx,
+                );
+                if whole == Some(*array) {
+                    code
+                } else {
+                    format!("{}[..{}]", code, end)
+                }
+            })
+            .collect()
+    }
+
+    /// The per-iteration value, with each array's element named by `names`.
+    fn reduction_term(arrays: &[&str], operands: &[Operand<'_>], names: [&str; 2]) -> String {
+        let factors: Vec<String> = operands
+            .iter()
+            .map(|operand| {
+                let name = names[arrays.iter().position(|a| *a == operand.array).unwrap_or(0)];
+                match operand.cast {
+                    Some(ty) => format!("({} as {})", name, Self::map_type(ty)),
+                    None => name.to_string(),
+                }
+            })
+            .collect();
+        factors.join(" * ")
+    }
+
+    /// An iterator over the per-iteration values of `term`.
+    fn reduction_values(slices: &[String], term: &str) -> String {
+        match slices {
+            [a] if term == OPERAND_NAMES[0] => format!("{}.iter().copied()", a),
+            [a] => format!("{}.iter().map(|&__x| {})", a, term),
+            [a, b] => format!("{}.iter().zip({}.iter()).map(|(&__x, &__y)| {})", a, b, term),
+            _ => unreachable!("reductions read one or two arrays"),
+        }
+    }
+
+    /// Reassociated float sum: `FLOAT_LANES` independent partial sums over
+    /// exact chunks, then the tail.
+    fn chunked_float_sum(
+        acc: &str,
+        acc_ty: &str,
+        arrays: &[&str],
+        operands: &[Operand<'_>],
+        slices: &[String],
+    ) -> String {
+        let lane_term = Self::reduction_term(arrays, operands, ["__c[__l]", "__d[__l]"]);
+        let tail_term = Self::reduction_term(arrays, operands, OPERAND_NAMES);
+        let (setup, chunks, tail) = match slices {
+            [a] => (
+                format!("let mut __cx = {}.chunks_exact({});", a, FLOAT_LANES),
+                "__c in &mut __cx",
+                Self::reduction_values(&["__cx.remainder()".to_string()], &tail_term),
+            ),
+            [a, b] => (
+                format!(
+                    "let (mut __cx, mut __cy) = ({}.chunks_exact({n}), {}.chunks_exact({n}));",
+                    a,
+                    b,
+                    n = FLOAT_LANES
+                ),
+                "(__c, __d) in (&mut __cx).zip(&mut __cy)",
+                Self::reduction_values(
+                    &["__cx.remainder()".to_string(), "__cy.remainder()".to_string()],
+                    &tail_term,
+                ),
+            ),
+            _ => unreachable!("reductions read one or two arrays"),
+        };
+        format!(
+            "{acc} = {acc} + {{\n    let mut __lanes: [{ty}; {n}] = [0.0; {n}];\n    {setup}\n    \
+             for {chunks} {{\n        for __l in 0..{n} {{\n            __lanes[__l] += {lane_term};\n        }}\n    }}\n    \
+             __lanes.iter().sum::<{ty}>() + {tail}.sum::<{ty}>()\n}};",
+            ty = acc_ty,
+            n = FLOAT_LANES,
+        )
+    }
+
+    /// `acc = acc + a[..end].iter().filter(|&&__x| pred).count() as T;`
+    #[allow(clippy::too_many_arguments)]
+    fn generate_count(
+        &self,
+        acc: &str,
+        acc_ty: &str,
+        pred: &HirExpression,
+        index: &str,
+        end: &str,
+        whole: Option<&str>,
+        ctx: &mut TypeContext,
+    ) -> Option<String> {
+        // Name each array's element and check the predicate only reads them
+        let mut bind = BindElements { index, arrays: Vec::new() };
+        let pred = bind.fold_expression(pred.clone());
+        if bind.arrays.is_empty() || bind.arrays.len() > OPERAND_NAMES.len() {
+            return None;
+        }
+        let mut pure = PurePredicate { index, acc, ctx, pure: true };
+        walk_expression(&mut pure, &pred);
+        if !pure.pure {
+            return None;
+        }
+
+        let arrays: Vec<&str> = bind.arrays.iter().map(String::as_str).collect();
+        for (array, name) in arrays.iter().zip(OPERAND_NAMES) {
+            let element = Self::buffer_element(array, ctx)?.clone();
+            ctx.add_variable(name.to_string(), element);
+        }
+        let slices = self.reduction_slices(&arrays, end, whole, ctx);
+        let pred_code = self.generate_expression_with_context(&pred, ctx);
+        let items = match slices.as_slice() {
+            [a] => format!("{}.iter().filter(|&&__x| {})", a, pred_code),
+            [a, b] => {
+                format!("{}.iter().zip({}.iter()).filter(|&(&__x, &__y)| {})", a, b, pred_code)
+            }
+            _ => return None,
+        };
+        Some(format!("{} = {} + {}.count() as {};", acc, acc, items, acc_ty))
+    }
+}
+
+/// Replaces `a[i]` with the closure name bound to `a`'s element.
+struct BindElements<'a> {
+    index: &'a str,
+    /// Arrays indexed by the loop variable, in first-use order
+    arrays: Vec<String>,
+}
+
+impl Fold for BindElements<'_> {
+    fn fold_expression(&mut self, expr: HirExpression) -> HirExpression {
+        if let HirExpression::ArrayIndex { array, index } = &expr {
+            if let (HirExpression::Variable(array), HirExpression::Variable(i)) =
+                (&**array, &**index)
+            {
+                if i == self.index {
+                    let slot = match self.arrays.iter().position(|a| a == array) {
+                        Some(slot) => slot,
+                        None => {
+                            self.arrays.push(array.clone());
+                            self.arrays.len() - 1
+                        }
+                    };
+                    let name = OPERAND_NAMES.get(slot).copied().unwrap_or("__z");
+                    return HirExpression::Variable(name.to_string());
+                }
+            }
+        }
+        fold_expression_children(self, expr)
+    }
+}
+
+/// Accepts predicates built from element names, other locals, literals and
+/// side-effect-free operators.
+struct PurePredicate<'a> {
+    index: &'a str,
+    acc: &'a str,
+    ctx: &'a TypeContext,
+    pure: bool,
+}
+
+impl Visitor for PurePredicate<'_> {
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        let ok = match expr {
+            HirExpression::Variable(name) => {
+                OPERAND_NAMES.contains(&name.as_str())
+                    || (name != self.index
+                        && name != self.acc
+                        && !self.ctx.is_global(name)
+                        && self.ctx.get_type(name).is_some())
+            }
+            HirExpression::IntLiteral(_)
+            | HirExpression::FloatLiteral(_)
+            | HirExpression::CharLiteral(_)
+            | HirExpression::Cast { .. } => true,
+            HirExpression::BinaryOp { op, .. } => {
+                !matches!(op, BinaryOperator::Assign | BinaryOperator::Comma)
+            }
+            HirExpression::UnaryOp { op, .. } => matches!(
+                op,
+                UnaryOperator::Minus | UnaryOperator::LogicalNot | UnaryOperator::BitwiseNot
+            ),
+            _ => false,
+        };
+        self.pure &= ok;
+    }
+}
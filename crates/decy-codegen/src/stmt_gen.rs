@@ -4,8 +4,9 @@
 //! including declarations, assignments, control flow (if/while/for/switch),
 //! and pointer/array/field assignments.
 
-use super::{escape_rust_keyword, CodeGenerator, TypeContext};
-use decy_hir::{BinaryOperator, HirExpression, HirStatement, HirType};
+use super::{escape_rust_keyword, CodeGenerator, FileStream, TypeContext};
+use decy_hir::visit::{walk_statements, Visitor};
+use decy_hir::{BinaryOperator, HirExpression, HirStatement, HirType, UnaryOperator};
 
 impl CodeGenerator {
     /// Generate code for a statement.
@@ -40,31 +41,41 @@ impl CodeGenerator {
             HirStatement::Return(expr_opt) => {
                 self.generate_return_statement(expr_opt.as_ref(), function_name, ctx, return_type)
             }
-            HirStatement::If { condition, then_block, else_block } => self.generate_if_statement(
-                condition,
-                then_block,
-                else_block.as_deref(),
-                function_name,
-                ctx,
-                return_type,
-            ),
+            HirStatement::If { condition, then_block, else_block } => {
+                if let Some(code) = Self::generate_growth_check(then_block, ctx) {
+                    return code;
+                }
+                self.generate_if_statement(
+                    condition,
+                    then_block,
+                    else_block.as_deref(),
+                    function_name,
+                    ctx,
+                    return_type,
+                )
+            }
             HirStatement::While { condition, body } => {
-                self.generate_while_statement(condition, body, function_name, ctx, return_type)
+                self.generate_loop_with_scratch_buffers(body, ctx, |ctx| {
+                    self.generate_while_statement(condition, body, function_name, ctx, return_type)
+                })
             }
             HirStatement::Break => "break;".to_string(),
             HirStatement::Continue => "continue;".to_string(),
             HirStatement::Assignment { target, value } => {
                 self.generate_assignment_statement(target, value, ctx)
             }
-            HirStatement::For { init, condition, increment, body } => self.generate_for_statement(
-                init,
-                condition.as_ref(),
-                increment,
-                body,
-                function_name,
-                ctx,
-                return_type,
-            ),
+            HirStatement::For { init, condition, increment, body } => self
+                .generate_loop_with_scratch_buffers(body, ctx, |ctx| {
+                    self.generate_for_statement(
+                        init,
+                        condition.as_ref(),
+                        increment,
+                        body,
+                        function_name,
+                        ctx,
+                        return_type,
+                    )
+                }),
             HirStatement::Switch { condition, cases, default_case } => self
                 .generate_switch_statement(
                     condition,
@@ -91,6 +102,9 @@ impl CodeGenerator {
                 format!("// Memory for '{}' deallocated automatically by RAII", pointer_name)
             }
             HirStatement::Expression(expr) => {
+                if let Some(code) = Self::generate_scratch_free(expr, ctx) {
+                    return code;
+                }
                 format!("{};", self.generate_expression_with_context(expr, ctx))
             }
             HirStatement::InlineAsm { text, translatable } => {
@@ -285,6 +299,73 @@ impl CodeGenerator {
         }
     }
 
+    /// A function-pointer local with known targets. When it only ever holds
+    /// one function its calls name that function and nothing is declared;
+    /// otherwise it holds a variant of an enum of the functions.
+    fn generate_dispatch_declaration(
+        &self,
+        name: &str,
+        escaped_name: &str,
+        targets: &[String],
+        initializer: Option<&HirExpression>,
+        ctx: &TypeContext,
+    ) -> String {
+        if let [target] = targets {
+            return format!("// {} only ever holds {}, which is called directly", name, target);
+        }
+        let enum_name = Self::dispatch_enum(name);
+        let variants: Vec<String> =
+            targets.iter().map(|t| Self::dispatch_variant(targets, t)).collect();
+        // C never calls it before it is assigned, so any target will do
+        let value = match initializer {
+            Some(init) => self.generate_dispatch_value(name, targets, init, ctx),
+            None => format!("{}::{}", enum_name, variants[0]),
+        };
+        format!(
+            "#[derive(Clone, Copy)]\n    enum {} {{ {} }}\n    let mut {}: {} = {};",
+            enum_name,
+            variants.join(", "),
+            escaped_name,
+            enum_name,
+            value
+        )
+    }
+
+    /// The variant for a function assigned to a function-pointer local, or
+    /// an `if` choosing between them for `c ? f : g`.
+    fn generate_dispatch_value(
+        &self,
+        name: &str,
+        targets: &[String],
+        value: &HirExpression,
+        ctx: &TypeContext,
+    ) -> String {
+        match value {
+            HirExpression::Variable(target) => {
+                format!(
+                    "{}::{}",
+                    Self::dispatch_enum(name),
+                    Self::dispatch_variant(targets, target)
+                )
+            }
+            HirExpression::Ternary { condition, then_expr, else_expr } => {
+                let cond = self.generate_expression_with_context(condition, ctx);
+                let cond = if Self::is_boolean_expression(condition) {
+                    cond
+                } else {
+                    format!("{} != 0", cond)
+                };
+                format!(
+                    "if {} {{ {} }} else {{ {} }}",
+                    cond,
+                    self.generate_dispatch_value(name, targets, then_expr, ctx),
+                    self.generate_dispatch_value(name, targets, else_expr, ctx)
+                )
+            }
+            other => self.generate_expression_with_context(other, ctx),
+        }
+    }
+
     fn generate_declaration_statement(
         &self,
         name: &str,
@@ -293,13 +374,35 @@ impl CodeGenerator {
         ctx: &mut TypeContext,
     ) -> String {
         let escaped_name = escape_rust_keyword(name);
-        let escaped_name = if ctx.is_global(&escaped_name) {
+        let escaped_name = if ctx.is_static(&escaped_name) {
             let renamed = format!("{}_local", escaped_name);
             ctx.add_renamed_local(escaped_name.clone(), renamed.clone());
             renamed
         } else {
             escaped_name
         };
+        if let Some(targets) = ctx.dispatch_targets(name).map(<[String]>::to_vec) {
+            let code =
+                self.generate_dispatch_declaration(name, &escaped_name, &targets, initializer, ctx);
+            ctx.add_variable(name.to_string(), var_type.clone());
+            return code;
+        }
+        if let Some(code) =
+            self.generate_heap_buffer_declaration(name, &escaped_name, var_type, initializer, ctx)
+        {
+            return code;
+        }
+        // FILE* locals opened with a literal mode become buffered stream handles
+        if let Some(init @ HirExpression::FunctionCall { function, arguments }) = initializer {
+            if let Some(stream) =
+                (function == "fopen").then(|| Self::fopen_stream(arguments)).flatten()
+            {
+                let init_code = self.generate_expression_with_context(init, ctx);
+                ctx.add_variable(name.to_string(), HirType::Option(Box::new(var_type.clone())));
+                ctx.add_file_stream(name.to_string(), stream);
+                return format!("let mut {} = {};", escaped_name, init_code);
+            }
+        }
         if let HirType::Array { element_type, size: None } = var_type {
             if let Some(size_expr) = initializer {
                 let size_code = self.generate_expression_with_context(size_expr, ctx);
@@ -367,6 +470,8 @@ impl CodeGenerator {
         // Special handling for main function (DECY-AUDIT-001)
         // return N; in main becomes std::process::exit(N);
         if function_name == Some("main") {
+            // Buffered stdout would be lost: process::exit skips destructors
+            let flush = if ctx.has_buffered_stdout() { "let _ = __stdout.flush(); " } else { "" };
             if let Some(expr) = expr_opt {
                 let expr_code = self.generate_expression_with_context(expr, ctx);
                 // DECY-126: Check if expression type needs cast to i32
@@ -374,12 +479,12 @@ impl CodeGenerator {
                 let expr_type = ctx.infer_expression_type(expr);
                 let needs_cast = matches!(expr_type, Some(HirType::Char));
                 if needs_cast {
-                    format!("std::process::exit({} as i32);", expr_code)
+                    format!("{}std::process::exit({} as i32);", flush, expr_code)
                 } else {
-                    format!("std::process::exit({});", expr_code)
+                    format!("{}std::process::exit({});", flush, expr_code)
                 }
             } else {
-                "std::process::exit(0);".to_string()
+                format!("{}std::process::exit(0);", flush)
             }
         } else if let Some(expr) = expr_opt {
             // Pass return type as target type hint for null pointer detection
@@ -451,6 +556,180 @@ impl CodeGenerator {
         code
     }
 
+    /// `while ((c = fgetc(f)) != EOF)` over a buffered reader: read the rest
+    /// of the file with one `read_to_end` and iterate the bytes.
+    ///
+    /// Only applies when the body never touches `f` and has no `break`, so
+    /// consuming the whole stream up front is unobservable.
+    fn generate_read_to_end_loop(
+        &self,
+        condition: &HirExpression,
+        body: &[HirStatement],
+        function_name: Option<&str>,
+        ctx: &mut TypeContext,
+        return_type: Option<&HirType>,
+    ) -> Option<String> {
+        let HirExpression::BinaryOp { op: BinaryOperator::NotEqual, left, right } = condition
+        else {
+            return None;
+        };
+        let is_eof = match &**right {
+            HirExpression::IntLiteral(-1) => true,
+            HirExpression::UnaryOp { op: UnaryOperator::Minus, operand } => {
+                matches!(**operand, HirExpression::IntLiteral(1))
+            }
+            HirExpression::Variable(name) => name == "EOF",
+            _ => false,
+        };
+        let HirExpression::BinaryOp { op: BinaryOperator::Assign, left: target, right: call } =
+            &**left
+        else {
+            return None;
+        };
+        let (
+            HirExpression::Variable(byte_var),
+            HirExpression::FunctionCall { function, arguments },
+        ) = (&**target, &**call)
+        else {
+            return None;
+        };
+        let [stream @ HirExpression::Variable(stream_name)] = arguments.as_slice() else {
+            return None;
+        };
+        if !is_eof
+            || !matches!(function.as_str(), "fgetc" | "getc")
+            || ctx.is_global(byte_var)
+            || ctx.get_file_stream(stream_name) != Some(FileStream::Reader)
+        {
+            return None;
+        }
+        let mut scan = ReadLoopScan { stream: stream_name, escapes: false };
+        walk_statements(&mut scan, body);
+        if scan.escapes {
+            return None;
+        }
+
+        let handle = self.generate_expression_with_context(stream, ctx);
+        let byte_code = self.generate_expression_with_context(target, ctx);
+        let byte_type = ctx.get_type(byte_var).map_or_else(|| "i32".to_string(), Self::map_type);
+
+        let mut code = String::from("let mut __bytes: Vec<u8> = Vec::new();\n");
+        code.push_str(&format!(
+            "if let Some(__r) = {}.as_mut() {{ use std::io::Read; let _ = __r.read_to_end(&mut __bytes); }}\n",
+            handle
+        ));
+        code.push_str("for __byte in __bytes {\n");
+        code.push_str(&format!("    {} = __byte as {};\n", byte_code, byte_type));
+        for stmt in body {
+            code.push_str("    ");
+            code.push_str(&self.generate_statement_with_context(
+                stmt,
+                function_name,
+                ctx,
+                return_type,
+            ));
+            code.push('\n');
+        }
+        code.push_str("}\n");
+        code.push_str(&format!("{} = -1;", byte_code));
+        Some(code)
+    }
+
+    /// `while (*s) { ...; s++; }` over a string-iteration slice: walk the bytes
+    /// up to the NUL with an iterator instead of indexing `s[s_idx]` each
+    /// iteration. The copy loop `while (*src) *dst++ = *src++;` becomes one
+    /// `copy_from_slice` of the NUL-terminated prefix.
+    ///
+    /// The body may only read `*s` and must not `continue` past the `s++`;
+    /// `s_idx` is still advanced so code after the loop sees the final position.
+    fn generate_string_walk(
+        &self,
+        condition: &HirExpression,
+        body: &[HirStatement],
+        function_name: Option<&str>,
+        ctx: &mut TypeContext,
+        return_type: Option<&HirType>,
+    ) -> Option<String> {
+        let walked = Self::nul_scan_var(condition)?;
+        let idx = ctx.get_string_iter_index(walked)?.clone();
+
+        // while (*src) *dst++ = *src++;
+        if let [HirStatement::DerefAssignment {
+            target: HirExpression::PostIncrement { operand },
+            value: HirExpression::Dereference(value),
+        }] = body
+        {
+            let (HirExpression::Variable(dst), HirExpression::PostIncrement { operand: src }) =
+                (&**operand, &**value)
+            else {
+                return None;
+            };
+            if dst == walked || !matches!(&**src, HirExpression::Variable(v) if v == walked) {
+                return None;
+            }
+            let dst_idx = ctx.get_string_iter_index(dst)?;
+            return Some(format!(
+                "{{\n    let __n = std::ffi::CStr::from_bytes_until_nul(&{src}[{idx}..])\
+                 .map_or({src}.len() - {idx}, |__c| __c.to_bytes().len());\n    \
+                 {dst}[{dst_idx}..{dst_idx} + __n].copy_from_slice(&{src}[{idx}..{idx} + __n]);\n    \
+                 {dst_idx} += __n;\n    {idx} += __n;\n}}",
+                src = walked,
+            ));
+        }
+
+        let (walk, increment) = body.split_at(body.len().checked_sub(1)?);
+        if !Self::is_unit_increment(increment, walked) {
+            return None;
+        }
+        let mut scan = StringWalkScan { walked, reads: 0, derefs: 0, escapes: false };
+        walk_statements(&mut scan, walk);
+        if scan.escapes || scan.reads != scan.derefs {
+            return None;
+        }
+
+        let byte = format!("__{}_byte", walked);
+        let mut code = format!(
+            "for &{} in {}[{}..].iter().take_while(|&&__b| __b != 0) {{\n",
+            byte, walked, idx
+        );
+        ctx.bind_walked_byte(walked.to_string(), byte);
+        for stmt in walk {
+            code.push_str("    ");
+            code.push_str(&self.generate_statement_with_context(
+                stmt,
+                function_name,
+                ctx,
+                return_type,
+            ));
+            code.push('\n');
+        }
+        ctx.unbind_walked_byte(walked);
+        code.push_str(&format!("    {} += 1;\n}}", idx));
+        Some(code)
+    }
+
+    /// The pointer in a NUL-scan condition: `*s`, `*s != 0` or `*s != '\0'`.
+    fn nul_scan_var(condition: &HirExpression) -> Option<&str> {
+        let deref = match condition {
+            HirExpression::BinaryOp { op: BinaryOperator::NotEqual, left, right }
+                if matches!(
+                    **right,
+                    HirExpression::IntLiteral(0) | HirExpression::CharLiteral(0)
+                ) =>
+            {
+                &**left
+            }
+            other => other,
+        };
+        match deref {
+            HirExpression::Dereference(inner) => match &**inner {
+                HirExpression::Variable(name) => Some(name),
+                _ => None,
+            },
+            _ => None,
+        }
+    }
+
     /// Generate a while statement.
     fn generate_while_statement(
         &self,
@@ -460,6 +739,17 @@ impl CodeGenerator {
         ctx: &mut TypeContext,
         return_type: Option<&HirType>,
     ) -> String {
+        if let Some(code) =
+            self.generate_read_to_end_loop(condition, body, function_name, ctx, return_type)
+        {
+            return code;
+        }
+        if let Some(code) =
+            self.generate_string_walk(condition, body, function_name, ctx, return_type)
+        {
+            return code;
+        }
+
         let mut code = String::new();
 
         // Generate while condition
@@ -509,6 +799,24 @@ impl CodeGenerator {
         value: &HirExpression,
         ctx: &mut TypeContext,
     ) -> String {
+        if let Some(targets) = ctx.dispatch_targets(target) {
+            if let [only] = targets {
+                return format!("// {} = {}, which is called directly", target, only);
+            }
+            let escaped = escape_rust_keyword(target);
+            let escaped = ctx.get_renamed_local(&escaped).cloned().unwrap_or(escaped);
+            return format!(
+                "{} = {};",
+                escaped,
+                self.generate_dispatch_value(target, targets, value, ctx)
+            );
+        }
+        if let Some(code) = Self::generate_growth_realloc(target, value, ctx) {
+            return code;
+        }
+        if let Some(code) = self.generate_atomic_global_store(target, value, ctx) {
+            return code;
+        }
         // Special handling for realloc() → Vec::resize/truncate/clear
         if let HirExpression::Realloc { pointer, new_size } = value {
             // target is a String (variable name) in Assignment statements
@@ -608,10 +916,9 @@ impl CodeGenerator {
                 result
             }
 
-            // DECY-241: Handle errno assignment specially
+            // DECY-241: errno is a thread-local Cell
             if target == "errno" {
-                let clean_value = strip_nested_unsafe(&value_code);
-                return format!("unsafe {{ ERRNO = {}; }}", clean_value);
+                return format!("ERRNO.set({});", value_code);
             }
             // DECY-220: Wrap global variable assignment in unsafe block
             // DECY-261: Strip nested unsafe from value_code to avoid redundancy
@@ -636,6 +943,18 @@ impl CodeGenerator {
         ctx: &mut TypeContext,
         return_type: Option<&HirType>,
     ) -> String {
+        if let Some(code) = self.generate_counted_loop(
+            init,
+            condition,
+            increment,
+            body,
+            function_name,
+            ctx,
+            return_type,
+        ) {
+            return code;
+        }
+
         let mut code = String::new();
 
         // DECY-224: Generate ALL init statements before loop
@@ -687,6 +1006,173 @@ impl CodeGenerator {
         code
     }
 
+    /// Lower `for (int i = k; i < bound; i++)` over buffers to a `for` over a
+    /// usize range.
+    ///
+    /// Locals indexed by `i` are indexed with the range variable itself, so when
+    /// `bound` is `a.len()` (from the slice parameter transform) or a constant
+    /// within a fixed array's size, rustc drops the per-element bounds checks
+    /// and can vectorise the loop. Other buffers that a straight-line body
+    /// touches on every iteration get one length assert before the loop.
+    /// Returns `None` to keep the `while` lowering.
+    #[allow(clippy::too_many_arguments)]
+    fn generate_counted_loop(
+        &self,
+        init: &[HirStatement],
+        condition: Option<&HirExpression>,
+        increment: &[HirStatement],
+        body: &[HirStatement],
+        function_name: Option<&str>,
+        ctx: &mut TypeContext,
+        return_type: Option<&HirType>,
+    ) -> Option<String> {
+        let [HirStatement::VariableDeclaration {
+            name: index,
+            var_type: HirType::Int,
+            initializer: Some(HirExpression::IntLiteral(start)),
+        }] = init
+        else {
+            return None;
+        };
+        let Some(HirExpression::BinaryOp { op: BinaryOperator::LessThan, left, right: bound }) =
+            condition
+        else {
+            return None;
+        };
+        if *start < 0
+            || ctx.is_global(index)
+            || !matches!(&**left, HirExpression::Variable(v) if v == index)
+            || !Self::is_unit_increment(increment, index)
+        {
+            return None;
+        }
+
+        // C re-evaluates the bound every iteration; the range evaluates it once,
+        // so it must be something the body cannot change.
+        let (end, bound_name, literal_bound) = match &**bound {
+            HirExpression::StringMethodCall { receiver, method, arguments }
+                if method == "len" && arguments.is_empty() =>
+            {
+                let HirExpression::Variable(array) = &**receiver else {
+                    return None;
+                };
+                Self::indexable_buffer(array, ctx)?;
+                let array_code = self.generate_expression_with_context(receiver, ctx);
+                (format!("{}.len()", array_code), Some(array), None)
+            }
+            HirExpression::IntLiteral(n) if *n >= 0 => (n.to_string(), None, Some(*n as usize)),
+            HirExpression::Variable(n)
+                if n != index && !ctx.is_global(n) && ctx.get_type(n) == Some(&HirType::Int) =>
+            {
+                let n_code = self.generate_expression_with_context(bound, ctx);
+                (format!("({}).max(0) as usize", n_code), Some(n), None)
+            }
+            _ => return None,
+        };
+
+        // A body that only folds elements into an accumulator becomes an iterator chain
+        if *start == 0 {
+            let whole = match &**bound {
+                HirExpression::StringMethodCall { .. } => bound_name.map(String::as_str),
+                _ => None,
+            };
+            if let Some(code) = self.generate_reduction(index, bound_name, &end, whole, body, ctx) {
+                return Some(code);
+            }
+        }
+
+        let mut scan = CountedLoopScan::new(index, bound_name.map(String::as_str), ctx);
+        walk_statements(&mut scan, body);
+        // Loops that never index a buffer by `i` gain nothing from the range
+        if scan.rejected || scan.rewritten == 0 {
+            return None;
+        }
+        let needs_index_value = scan.uses > scan.rewritten - scan.pinned;
+        let hoisted: Vec<String> = if *start == 0 && scan.straight_line {
+            scan.indexed
+                .iter()
+                .filter(|array| Some(*array) != bound_name)
+                .filter(|array| match (Self::indexable_buffer(array, ctx), literal_bound) {
+                    (Some(HirType::Array { size: Some(size), .. }), Some(n)) => n > *size,
+                    (Some(_), _) => true,
+                    (None, _) => false,
+                })
+                .map(|array| {
+                    self.generate_expression_with_context(
+                        &HirExpression::Variable(array.clone()),
+                        ctx,
+                    )
+                })
+                .collect()
+        } else {
+            Vec::new()
+        };
+
+        let binding = format!("__{}", index);
+        let mut code = String::new();
+        let end = if hoisted.is_empty() {
+            end
+        } else {
+            let end_var = format!("{}_end", binding);
+            code.push_str(&format!("let {} = {};\n", end_var, end));
+            let checks: Vec<String> =
+                hoisted.iter().map(|array| format!("{} <= {}.len()", end_var, array)).collect();
+            code.push_str(&format!("assert!({});\n", checks.join(" && ")));
+            end_var
+        };
+        code.push_str(&format!("for {} in {}..{} {{\n", binding, start, end));
+        if needs_index_value {
+            code.push_str(&format!("    let {}: i32 = {} as i32;\n", index, binding));
+        }
+
+        ctx.add_variable(index.clone(), HirType::Int);
+        ctx.bind_loop_index(index.clone(), binding);
+        for stmt in body {
+            code.push_str("    ");
+            code.push_str(&self.generate_statement_with_context(
+                stmt,
+                function_name,
+                ctx,
+                return_type,
+            ));
+            code.push('\n');
+        }
+        ctx.unbind_loop_index(index);
+
+        code.push('}');
+        Some(code)
+    }
+
+    /// `i++`, `++i` or `i = i + 1` as the only increment statement.
+    fn is_unit_increment(increment: &[HirStatement], index: &str) -> bool {
+        let is_index =
+            |expr: &HirExpression| matches!(expr, HirExpression::Variable(v) if v == index);
+        match increment {
+            [HirStatement::Assignment {
+                target,
+                value: HirExpression::BinaryOp { op: BinaryOperator::Add, left, right },
+            }] => {
+                target == index && is_index(left) && matches!(**right, HirExpression::IntLiteral(1))
+            }
+            [HirStatement::Expression(
+                HirExpression::PostIncrement { operand } | HirExpression::PreIncrement { operand },
+            )] => is_index(operand),
+            _ => false,
+        }
+    }
+
+    /// The array, Vec or slice type of a local buffer variable.
+    fn indexable_buffer<'a>(name: &str, ctx: &'a TypeContext) -> Option<&'a HirType> {
+        if ctx.is_global(name) {
+            return None;
+        }
+        let buffer = match ctx.get_type(name)? {
+            HirType::Reference { inner, .. } => inner.as_ref(),
+            other => other,
+        };
+        matches!(buffer, HirType::Array { .. } | HirType::Vec(_)).then_some(buffer)
+    }
+
     /// Generate a switch statement as a Rust match expression.
     fn generate_switch_statement(
         &self,
@@ -791,6 +1277,19 @@ impl CodeGenerator {
             return format!("{} = {};", target_code, value_code);
         }
 
+        // DECY-134: *ptr++ = value on a string iteration param writes and steps the index
+        if let HirExpression::PostIncrement { operand } = target {
+            if let HirExpression::Variable(var_name) = &**operand {
+                if let Some(idx_var) = ctx.get_string_iter_index(var_name) {
+                    let value_code = self.generate_expression_with_context(value, ctx);
+                    return format!(
+                        "{}[{}] = {}; {} += 1;",
+                        var_name, idx_var, value_code, idx_var
+                    );
+                }
+            }
+        }
+
         // DECY-134: Check for string iteration param - use slice indexing
         if let HirExpression::Variable(var_name) = target {
             if let Some(idx_var) = ctx.get_string_iter_index(var_name) {
@@ -916,6 +1415,11 @@ impl CodeGenerator {
             }
         }
 
+        if let Some(code) = self.generate_growth_append(array, index, &array_code, &value_code, ctx)
+        {
+            return code;
+        }
+
         if is_raw_pointer {
             // Raw pointer indexing: arr[i] = v becomes unsafe { *arr.add(i as usize) = v }
             // DECY-143: Add SAFETY comment
@@ -926,6 +1430,9 @@ impl CodeGenerator {
         } else {
             // DECY-072: Cast index to usize for slice indexing
             // DECY-150: Wrap index in parens to handle operator precedence
+            if let Some(binding) = Self::loop_index_binding(array, index, ctx) {
+                return format!("{}[{}] = {};", array_code, binding, value_code);
+            }
             // DECY-223: Wrap global array assignment in unsafe block
             if is_global_array {
                 format!("unsafe {{ {}[({}) as usize] = {}; }}", array_code, index_code, value_code)
@@ -982,3 +1489,192 @@ impl CodeGenerator {
         }
     }
 }
+
+/// Checks a counted loop body: the index and bound must stay fixed, and
+/// index uses that array indexing will rewrite are counted separately.
+struct CountedLoopScan<'a> {
+    index: &'a str,
+    bound: Option<&'a str>,
+    ctx: &'a TypeContext,
+    /// The body writes or redeclares the index or the bound
+    rejected: bool,
+    /// No branches, nested loops or early exits: every access runs each iteration
+    straight_line: bool,
+    /// Locals indexed directly by the loop index, in first-use order
+    indexed: Vec<String>,
+    /// Mentions of the index
+    uses: usize,
+    /// `a[i]` accesses that will use the range variable
+    rewritten: usize,
+    /// `&a[i]` whose index may be generated on its own
+    pinned: usize,
+}
+
+impl<'a> CountedLoopScan<'a> {
+    fn new(index: &'a str, bound: Option<&'a str>, ctx: &'a TypeContext) -> Self {
+        Self {
+            index,
+            bound,
+            ctx,
+            rejected: false,
+            straight_line: true,
+            indexed: Vec::new(),
+            uses: 0,
+            rewritten: 0,
+            pinned: 0,
+        }
+    }
+
+    fn is_fixed(&self, name: &str) -> bool {
+        name == self.index || Some(name) == self.bound
+    }
+
+    /// Whether `array[index]` is an access that will be rewritten.
+    fn rewrites(&self, array: &HirExpression, index: &HirExpression) -> bool {
+        match (array, index) {
+            (HirExpression::Variable(array), HirExpression::Variable(index)) => {
+                index == self.index && !self.ctx.is_global(array) && !self.ctx.is_pointer(array)
+            }
+            _ => false,
+        }
+    }
+
+    fn note_access(&mut self, array: &HirExpression, index: &HirExpression) {
+        if !self.rewrites(array, index) {
+            return;
+        }
+        self.rewritten += 1;
+        if let HirExpression::Variable(name) = array {
+            if !self.indexed.contains(name) {
+                self.indexed.push(name.clone());
+            }
+        }
+    }
+}
+
+impl Visitor for CountedLoopScan<'_> {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        match stmt {
+            HirStatement::VariableDeclaration { name: target, .. }
+            | HirStatement::Assignment { target, .. }
+                if self.is_fixed(target) =>
+            {
+                self.rejected = true
+            }
+            HirStatement::ArrayIndexAssignment { array, index, .. } => {
+                self.note_access(array, index)
+            }
+            HirStatement::If { .. }
+            | HirStatement::While { .. }
+            | HirStatement::For { .. }
+            | HirStatement::Switch { .. }
+            | HirStatement::Break
+            | HirStatement::Continue
+            | HirStatement::Return(_)
+            | HirStatement::InlineAsm { .. } => self.straight_line = false,
+            _ => {}
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        let names_fixed =
+            |e: &HirExpression| matches!(e, HirExpression::Variable(v) if self.is_fixed(v));
+        match expr {
+            HirExpression::Variable(name) if name == self.index => self.uses += 1,
+            HirExpression::ArrayIndex { array, index } => self.note_access(array, index),
+            HirExpression::PostIncrement { operand }
+            | HirExpression::PreIncrement { operand }
+            | HirExpression::PostDecrement { operand }
+            | HirExpression::PreDecrement { operand }
+                if names_fixed(operand) =>
+            {
+                self.rejected = true
+            }
+            HirExpression::BinaryOp { op: BinaryOperator::Assign, left, .. }
+                if names_fixed(left) =>
+            {
+                self.rejected = true
+            }
+            HirExpression::AddressOf(inner)
+            | HirExpression::UnaryOp { op: UnaryOperator::AddressOf, operand: inner } => {
+                match &**inner {
+                    inner if names_fixed(inner) => self.rejected = true,
+                    HirExpression::ArrayIndex { array, index } if self.rewrites(array, index) => {
+                        self.pinned += 1
+                    }
+                    _ => {}
+                }
+            }
+            HirExpression::BinaryOp {
+                op: BinaryOperator::LogicalAnd | BinaryOperator::LogicalOr,
+                ..
+            }
+            | HirExpression::Ternary { .. } => self.straight_line = false,
+            HirExpression::FunctionCall { function, .. }
+                if matches!(function.as_str(), "exit" | "abort" | "_Exit") =>
+            {
+                self.straight_line = false
+            }
+            _ => {}
+        }
+    }
+}
+
+/// Counts how a string walk body uses the walked pointer: only `*s` reads
+/// can come from the iterator, and `continue` would skip the `s++`.
+struct StringWalkScan<'a> {
+    walked: &'a str,
+    /// Mentions of the pointer
+    reads: usize,
+    /// `*s` reads
+    derefs: usize,
+    /// The body writes through or moves the pointer, or continues
+    escapes: bool,
+}
+
+impl Visitor for StringWalkScan<'_> {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        let is_walked =
+            |e: &HirExpression| matches!(e, HirExpression::Variable(v) if v == self.walked);
+        match stmt {
+            HirStatement::Continue => self.escapes = true,
+            HirStatement::Assignment { target, .. } if target == self.walked => self.escapes = true,
+            HirStatement::DerefAssignment { target, .. } if is_walked(target) => {
+                self.escapes = true
+            }
+            _ => {}
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        match expr {
+            HirExpression::Variable(name) if name == self.walked => self.reads += 1,
+            HirExpression::Dereference(inner) if matches!(&**inner, HirExpression::Variable(v) if v == self.walked) => {
+                self.derefs += 1
+            }
+            _ => {}
+        }
+    }
+}
+
+/// Flags loop bodies that mention the stream being read or `break` early.
+struct ReadLoopScan<'a> {
+    stream: &'a str,
+    escapes: bool,
+}
+
+impl Visitor for ReadLoopScan<'_> {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        match stmt {
+            HirStatement::Break => self.escapes = true,
+            HirStatement::Assignment { target, .. } if target == self.stream => self.escapes = true,
+            _ => {}
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        if matches!(expr, HirExpression::Variable(name) if name == self.stream) {
+            self.escapes = true;
+        }
+    }
+}
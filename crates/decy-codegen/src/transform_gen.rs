@@ -86,10 +86,19 @@ impl CodeGenerator {
         });
 
         // Add lifetime parameters only if we have non-slice references
+        let mut generic_params: Vec<String> = Vec::new();
         if !sig.lifetimes.is_empty() && has_non_slice_references {
-            let lifetime_params: Vec<String> =
-                sig.lifetimes.iter().map(|lt| lt.name.clone()).collect();
-            result.push_str(&format!("<{}>", lifetime_params.join(", ")));
+            generic_params.extend(sig.lifetimes.iter().map(|lt| lt.name.clone()));
+        }
+        // Callbacks passed straight through take one `FnMut` type parameter each
+        let callbacks = self.generic_callbacks_of(&sig.name);
+        for (k, (_, name)) in callbacks.iter().enumerate() {
+            if let Some(p) = sig.parameters.iter().find(|p| p.name == *name) {
+                generic_params.push(format!("F{}: {}", k, Self::callback_bound(&p.param_type)));
+            }
+        }
+        if !generic_params.is_empty() {
+            result.push_str(&format!("<{}>", generic_params.join(", ")));
         }
 
         // Add function parameters (DECY-084: filter out output params)
@@ -98,7 +107,13 @@ impl CodeGenerator {
             .parameters
             .iter()
             .filter(|p| !skip_output_params.contains(&p.name))
-            .map(|p| self.generate_annotated_param(p, func))
+            .map(|p| match callbacks.iter().position(|(_, name)| *name == p.name) {
+                Some(k) => format!("mut {}: F{}", p.name, k),
+                None if self.dispatch.params_of(&sig.name).iter().any(|(_, n)| *n == p.name) => {
+                    format!("{}: {}", p.name, Self::dispatch_bound(&p.param_type))
+                }
+                None => self.generate_annotated_param(p, func),
+            })
             .collect();
         result.push_str(&params.join(", "));
         result.push(')');
@@ -115,6 +130,45 @@ impl CodeGenerator {
         result
     }
 
+    /// `FnMut` bound for a generic callback parameter: its pointer arguments
+    /// are borrowed as `&mut T`.
+    fn callback_bound(param_type: &AnnotatedType) -> String {
+        let AnnotatedType::Simple(HirType::FunctionPointer { param_types, return_type }) =
+            param_type
+        else {
+            return "FnMut()".to_string();
+        };
+        let args: Vec<String> = param_types
+            .iter()
+            .map(|t| match t {
+                HirType::Pointer(inner) if **inner != HirType::Void => {
+                    format!("&mut {}", Self::map_type(inner))
+                }
+                other => Self::map_type(other),
+            })
+            .collect();
+        match return_type.as_ref() {
+            HirType::Void => format!("FnMut({})", args.join(", ")),
+            ret => format!("FnMut({}) -> {}", args.join(", "), Self::map_type(ret)),
+        }
+    }
+
+    /// `impl Fn` type of a function-pointer parameter dispatched statically.
+    /// It is `Copy` like the `fn` pointer, so it can be called and passed on
+    /// any number of times.
+    fn dispatch_bound(param_type: &AnnotatedType) -> String {
+        let AnnotatedType::Simple(HirType::FunctionPointer { param_types, return_type }) =
+            param_type
+        else {
+            return "impl Fn() + Copy".to_string();
+        };
+        let args: Vec<String> = param_types.iter().map(Self::map_type).collect();
+        match return_type.as_ref() {
+            HirType::Void => format!("impl Fn({}) + Copy", args.join(", ")),
+            ret => format!("impl Fn({}) -> {} + Copy", args.join(", "), Self::map_type(ret)),
+        }
+    }
+
     /// Detect output parameters from a function for signature transformation.
     /// Returns (skip_set, output_types, is_fallible).
     fn detect_output_params(
@@ -274,8 +328,14 @@ impl CodeGenerator {
         if matches!(*inner, HirType::Void) {
             return format!("{}: *mut ()", name);
         }
-        // Transform *mut T → &mut T for safety
+        // Transform *mut T → &mut T for safety; a `const T*` is never written through
         let inner_type = Self::map_type(inner);
+        let is_const = func
+            .and_then(|f| f.parameters().iter().find(|fp| fp.name() == name))
+            .is_some_and(|p| p.is_pointee_const());
+        if is_const {
+            return format!("{}: &{}", name, inner_type);
+        }
         format!("{}: &mut {}", name, inner_type)
     }
 
@@ -538,6 +598,7 @@ impl CodeGenerator {
 
         // Initialize type context for tracking variable types across statements
         let mut ctx = TypeContext::from_function(func);
+        code.push_str(self.buffered_stdout_prologue(func, &mut ctx));
 
         // DECY-129/DECY-148: Update context to reflect pointer-to-reference transformations
         // When pointer params are transformed to &mut T in signature, context must match
@@ -636,6 +697,7 @@ impl CodeGenerator {
 
         // Initialize type context with function parameters AND struct definitions
         let mut ctx = TypeContext::from_function(func);
+        code.push_str(self.buffered_stdout_prologue(func, &mut ctx));
 
         // DECY-165: Add struct definitions to context for field type lookup
         for struct_def in structs {
@@ -801,10 +863,17 @@ impl CodeGenerator {
 
         // DECY-041: Initialize type context with function parameters for pointer arithmetic
         let mut ctx = TypeContext::from_function(func);
+        code.push_str(self.buffered_stdout_prologue(func, &mut ctx));
+        for (_, name) in self.generic_callbacks_of(func.name()) {
+            ctx.add_generic_callback(name.clone());
+        }
+        for local in self.dispatch.locals_of(func.name()) {
+            ctx.add_dispatch_local(local.name.clone(), local.targets.clone());
+        }
 
         // DECY-220/233: Register global variables for unsafe access tracking and type inference
         for (name, var_type) in globals {
-            ctx.add_global(name.clone());
+            ctx.add_static(name.clone(), self.statics.storage(name));
             ctx.add_variable(name.clone(), var_type.clone());
         }
 
@@ -140,6 +140,113 @@ impl CodeGenerator {
         code
     }
 
+    /// Generate the index arena holding every node of a self-referential struct.
+    ///
+    /// `hir_struct` is the struct after its links were lowered to `u32`
+    /// indices (see `decy_ownership::arena`). Slot 0 is a permanently vacant
+    /// node standing for NULL; `free` keeps released slots for reuse by the
+    /// next `alloc`, and nodes are reached by indexing the arena. `reset`
+    /// releases every node at once.
+    ///
+    /// `capacity` bounds the arena like the C pool array it replaces: once
+    /// that many nodes are live, `alloc` returns 0 as the pool returned NULL.
+    pub fn generate_index_arena(
+        &self,
+        hir_struct: &decy_hir::HirStruct,
+        capacity: Option<usize>,
+    ) -> String {
+        fn vacant(ty: &HirType) -> String {
+            match ty {
+                HirType::Float | HirType::Double => "0.0".to_string(),
+                HirType::Bool => "false".to_string(),
+                HirType::Pointer(_) => "std::ptr::null_mut()".to_string(),
+                HirType::Array { element_type, size: Some(n) } => {
+                    format!("[{}; {}]", vacant(element_type), n)
+                }
+                _ => "0".to_string(),
+            }
+        }
+
+        let name = hir_struct.name();
+        let fields: Vec<String> = hir_struct
+            .fields()
+            .iter()
+            .map(|f| format!("{}: {}", escape_rust_keyword(f.name()), vacant(f.field_type())))
+            .collect();
+        // A bounded arena reserves its slots up front and refuses to grow past them
+        let (nodes, exhausted) = match capacity {
+            Some(n) => (
+                format!(
+                    "let mut nodes = Vec::with_capacity({});\n        \
+                     nodes.push(Self::vacant_node());\n        ",
+                    n + 1
+                ),
+                format!(
+                    "if self.nodes.len() > {} {{\n                    \
+                         return 0;\n                \
+                     }}\n                ",
+                    n
+                ),
+            ),
+            None => (String::new(), String::new()),
+        };
+        let init = if capacity.is_some() { "nodes" } else { "nodes: vec![Self::vacant_node()]" };
+        format!(
+            "/// Index arena for `{name}` nodes; index 0 stands for NULL.\n\
+             #[derive(Debug)]\n\
+             pub struct {name}Arena {{\n    \
+                 nodes: Vec<{name}>,\n    \
+                 vacant: Vec<u32>,\n\
+             }}\n\n\
+             #[allow(dead_code)]\n\
+             impl {name}Arena {{\n    \
+                 fn new() -> Self {{\n        \
+                     {nodes}Self {{ {init}, vacant: Vec::new() }}\n    \
+                 }}\n\n    \
+                 fn vacant_node() -> {name} {{\n        \
+                     {name} {{ {fields} }}\n    \
+                 }}\n\n    \
+                 fn alloc(&mut self) -> u32 {{\n        \
+                     match self.vacant.pop() {{\n            \
+                         Some(index) => {{\n                \
+                             self.nodes[index as usize] = Self::vacant_node();\n                \
+                             index\n            \
+                         }}\n            \
+                         None => {{\n                \
+                             {exhausted}self.nodes.push(Self::vacant_node());\n                \
+                             (self.nodes.len() - 1) as u32\n            \
+                         }}\n        \
+                     }}\n    \
+                 }}\n\n    \
+                 fn free(&mut self, index: u32) {{\n        \
+                     if index != 0 {{\n            \
+                         self.vacant.push(index);\n        \
+                     }}\n    \
+                 }}\n\n    \
+                 fn reset(&mut self) {{\n        \
+                     self.nodes.truncate(1);\n        \
+                     self.vacant.clear();\n    \
+                 }}\n\
+             }}\n\n\
+             impl std::ops::Index<usize> for {name}Arena {{\n    \
+                 type Output = {name};\n\n    \
+                 fn index(&self, index: usize) -> &{name} {{\n        \
+                     &self.nodes[index]\n    \
+                 }}\n\
+             }}\n\n\
+             impl std::ops::IndexMut<usize> for {name}Arena {{\n    \
+                 fn index_mut(&mut self, index: usize) -> &mut {name} {{\n        \
+                     &mut self.nodes[index]\n    \
+                 }}\n\
+             }}\n",
+            name = name,
+            fields = fields.join(", "),
+            nodes = nodes,
+            init = init,
+            exhausted = exhausted,
+        )
+    }
+
     /// DECY-202: Generate a Rust struct + impl block from a C++ class.
     ///
     /// Maps: class fields -> struct fields, methods -> impl block,
@@ -0,0 +1,178 @@
+//! Tests for buffered FILE* stream lowering.
+//!
+//! Reference: K&R §7.5, ISO C99 §7.19.5
+//!
+//! `fopen` handles held in locals become `Option<BufReader<File>>` or
+//! `Option<BufWriter<File>>`, so per-character `fgetc`/`fputc` hit an
+//! in-memory buffer instead of issuing one syscall each. `fclose` and
+//! `fflush` flush buffered writers, and whole-file `fgetc` loops read the
+//! file with a single `read_to_end`.
+
+use decy_codegen::CodeGenerator;
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirStatement, HirType};
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirExpression {
+    HirExpression::FunctionCall { function: function.to_string(), arguments }
+}
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn file_ptr() -> HirType {
+    HirType::Pointer(Box::new(HirType::Struct("FILE".to_string())))
+}
+
+fn open_stmt(name: &str, path: &str, mode: &str) -> HirStatement {
+    HirStatement::VariableDeclaration {
+        name: name.to_string(),
+        var_type: file_ptr(),
+        initializer: Some(call(
+            "fopen",
+            vec![
+                HirExpression::StringLiteral(path.to_string()),
+                HirExpression::StringLiteral(mode.to_string()),
+            ],
+        )),
+    }
+}
+
+/// `while ((c = fgetc(stream)) != EOF) { body }`
+fn fgetc_loop(stream: &str, body: Vec<HirStatement>) -> HirStatement {
+    HirStatement::While {
+        condition: HirExpression::BinaryOp {
+            op: BinaryOperator::NotEqual,
+            left: Box::new(HirExpression::BinaryOp {
+                op: BinaryOperator::Assign,
+                left: Box::new(var("c")),
+                right: Box::new(call("fgetc", vec![var(stream)])),
+            }),
+            right: Box::new(HirExpression::IntLiteral(-1)),
+        },
+        body,
+    }
+}
+
+fn copy_function(loop_body: Vec<HirStatement>) -> HirFunction {
+    HirFunction::new_with_body(
+        "copy".to_string(),
+        HirType::Int,
+        vec![],
+        vec![
+            open_stmt("in", "in.txt", "r"),
+            open_stmt("out", "out.txt", "w"),
+            HirStatement::VariableDeclaration {
+                name: "c".to_string(),
+                var_type: HirType::Int,
+                initializer: None,
+            },
+            fgetc_loop("in", loop_body),
+            HirStatement::Expression(call("fclose", vec![var("in")])),
+            HirStatement::Return(Some(call("fclose", vec![var("out")]))),
+        ],
+    )
+}
+
+/// C: FILE* in = fopen(.., "r"); FILE* out = fopen(.., "w");
+/// Rust: BufReader/BufWriter wrapped File handles
+#[test]
+fn test_fopen_locals_are_buffered() {
+    let func =
+        copy_function(vec![HirStatement::Expression(call("fputc", vec![var("c"), var("out")]))]);
+    let code = CodeGenerator::new().generate_function(&func);
+
+    assert!(code.contains("File::open(\"in.txt\").ok().map(std::io::BufReader::new)"), "{}", code);
+    assert!(
+        code.contains("File::create(\"out.txt\").ok().map(std::io::BufWriter::new)"),
+        "{}",
+        code
+    );
+    assert!(
+        code.contains("out.as_mut().map_or(-1"),
+        "fputc should go through the writer:\n{}",
+        code
+    );
+}
+
+/// Whole-file fgetc loop → one read_to_end, then iterate bytes
+#[test]
+fn test_fgetc_loop_reads_to_end() {
+    let func =
+        copy_function(vec![HirStatement::Expression(call("fputc", vec![var("c"), var("out")]))]);
+    let code = CodeGenerator::new().generate_function(&func);
+
+    assert!(code.contains("read_to_end(&mut __bytes)"), "{}", code);
+    assert!(code.contains("for __byte in __bytes"), "{}", code);
+    assert!(code.contains("c = __byte as i32;"), "{}", code);
+    assert!(!code.contains("read(&mut buf)"), "no per-byte reads expected:\n{}", code);
+}
+
+/// A loop body that reads the stream itself keeps the per-character loop
+#[test]
+fn test_fgetc_loop_touching_stream_stays_per_char() {
+    let func = copy_function(vec![HirStatement::Expression(call("fgetc", vec![var("in")]))]);
+    let code = CodeGenerator::new().generate_function(&func);
+
+    assert!(!code.contains("read_to_end"), "{}", code);
+    assert!(code.contains("in.as_mut().map_or(-1, |__r|"), "{}", code);
+    assert!(code.contains("Ok(1) => buf[0] as i32, _ => -1"), "EOF must yield -1:\n{}", code);
+}
+
+/// A body that can break out early keeps the per-character loop
+#[test]
+fn test_fgetc_loop_with_break_stays_per_char() {
+    let func = copy_function(vec![HirStatement::Break]);
+    let code = CodeGenerator::new().generate_function(&func);
+
+    assert!(!code.contains("read_to_end"), "{}", code);
+}
+
+/// fclose on a writer flushes; fclose on a reader just drops
+#[test]
+fn test_fclose_flushes_writer() {
+    let func = copy_function(vec![]);
+    let code = CodeGenerator::new().generate_function(&func);
+
+    assert!(code.contains("in.take().map_or(-1, |_| 0)"), "{}", code);
+    assert!(code.contains("out.take().map_or(-1, |mut __w|"), "{}", code);
+    assert!(code.contains("__w.flush()"), "{}", code);
+}
+
+/// fflush(out) flushes the BufWriter; fflush(stdout) flushes stdout
+#[test]
+fn test_fflush_mapped() {
+    let func = HirFunction::new_with_body(
+        "flush".to_string(),
+        HirType::Void,
+        vec![],
+        vec![
+            open_stmt("out", "out.txt", "a"),
+            HirStatement::Expression(call("fflush", vec![var("out")])),
+            HirStatement::Expression(call("fflush", vec![var("stdout")])),
+        ],
+    );
+    let code = CodeGenerator::new().generate_function(&func);
+
+    assert!(
+        code.contains("out.as_mut().map_or(-1, |__w| { use std::io::Write; __w.flush()"),
+        "{}",
+        code
+    );
+    assert!(code.contains("std::io::stdout().flush()"), "{}", code);
+    assert!(!code.contains("fflush("), "{}", code);
+}
+
+/// Read/write modes keep the unbuffered File handle
+#[test]
+fn test_update_mode_stays_unbuffered() {
+    let func = HirFunction::new_with_body(
+        "update".to_string(),
+        HirType::Void,
+        vec![],
+        vec![open_stmt("f", "data.bin", "r+")],
+    );
+    let code = CodeGenerator::new().generate_function(&func);
+
+    assert!(code.contains("std::fs::File::open(\"data.bin\").ok()"), "{}", code);
+    assert!(!code.contains("BufReader"), "{}", code);
+}
@@ -0,0 +1,284 @@
+//! Tests for the buffered stdout code generation mode.
+//!
+//! Reference: K&R §7.2, ISO C99 §7.19.6.3
+//!
+//! With `CodegenOptions::buffered_stdout`, a function that prints locks
+//! stdout once into a `BufWriter` and printf-family calls become `write!` on
+//! it, instead of taking the lock and line-flushing on every `print!`.
+
+use decy_analyzer::stdio_analysis::StdioAnalyzer;
+use decy_codegen::{CodeGenerator, CodegenOptions};
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirExpression {
+    HirExpression::FunctionCall { function: function.to_string(), arguments }
+}
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn buffered() -> CodeGenerator {
+    CodeGenerator::with_options(CodegenOptions { buffered_stdout: true, ..Default::default() })
+}
+
+/// int main() { for (i = 0; i < 10; i++) printf("%d\n", i); helper(); puts("done"); return 0; }
+fn printing_main() -> HirFunction {
+    HirFunction::new_with_body(
+        "main".to_string(),
+        HirType::Int,
+        vec![],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "i".to_string(),
+                var_type: HirType::Int,
+                initializer: Some(HirExpression::IntLiteral(0)),
+            },
+            HirStatement::While {
+                condition: HirExpression::BinaryOp {
+                    op: BinaryOperator::LessThan,
+                    left: Box::new(var("i")),
+                    right: Box::new(HirExpression::IntLiteral(10)),
+                },
+                body: vec![
+                    HirStatement::Expression(call(
+                        "printf",
+                        vec![HirExpression::StringLiteral("%d\\n".to_string()), var("i")],
+                    )),
+                    HirStatement::Assignment {
+                        target: "i".to_string(),
+                        value: HirExpression::BinaryOp {
+                            op: BinaryOperator::Add,
+                            left: Box::new(var("i")),
+                            right: Box::new(HirExpression::IntLiteral(1)),
+                        },
+                    },
+                ],
+            },
+            HirStatement::Expression(call("helper", vec![])),
+            HirStatement::Expression(call(
+                "puts",
+                vec![HirExpression::StringLiteral("done".to_string())],
+            )),
+            HirStatement::Return(Some(HirExpression::IntLiteral(0))),
+        ],
+    )
+}
+
+/// Printing functions lock stdout once and write through a BufWriter
+#[test]
+fn test_printf_writes_to_locked_buffer() {
+    let code = buffered().generate_function(&printing_main());
+
+    assert!(
+        code.contains("let mut __stdout = std::io::BufWriter::new(std::io::stdout().lock());"),
+        "{}",
+        code
+    );
+    assert!(code.contains("write!(__stdout, \"{}\\n\", i)"), "{}", code);
+    assert!(code.contains("writeln!(__stdout, \"{}\", \"done\")"), "{}", code);
+    assert!(!code.contains("print!"), "{}", code);
+    assert!(!code.contains("println!"), "{}", code);
+}
+
+/// Calls that may print themselves and the exit path flush the buffer first
+#[test]
+fn test_buffer_flushed_before_calls_and_exit() {
+    let code = buffered().generate_function(&printing_main());
+
+    assert!(code.contains("{ let _ = __stdout.flush(); helper() }"), "{}", code);
+    assert!(code.contains("let _ = __stdout.flush(); std::process::exit(0);"), "{}", code);
+}
+
+/// void table(int n) { for (i = 0; i < n; i++) printf("%d\n", square(i)); }
+fn table_of_squares() -> Vec<HirFunction> {
+    let square = HirFunction::new_with_body(
+        "square".to_string(),
+        HirType::Int,
+        vec![HirParameter::new("x".to_string(), HirType::Int)],
+        vec![HirStatement::Return(Some(HirExpression::BinaryOp {
+            op: BinaryOperator::Multiply,
+            left: Box::new(var("x")),
+            right: Box::new(var("x")),
+        }))],
+    );
+    let table = HirFunction::new_with_body(
+        "table".to_string(),
+        HirType::Void,
+        vec![HirParameter::new("n".to_string(), HirType::Int)],
+        vec![HirStatement::For {
+            init: vec![HirStatement::VariableDeclaration {
+                name: "i".to_string(),
+                var_type: HirType::Int,
+                initializer: Some(HirExpression::IntLiteral(0)),
+            }],
+            condition: Some(HirExpression::BinaryOp {
+                op: BinaryOperator::LessThan,
+                left: Box::new(var("i")),
+                right: Box::new(var("n")),
+            }),
+            increment: vec![HirStatement::Assignment {
+                target: "i".to_string(),
+                value: HirExpression::BinaryOp {
+                    op: BinaryOperator::Add,
+                    left: Box::new(var("i")),
+                    right: Box::new(HirExpression::IntLiteral(1)),
+                },
+            }],
+            body: vec![HirStatement::Expression(call(
+                "printf",
+                vec![
+                    HirExpression::StringLiteral("%d\\n".to_string()),
+                    call("square", vec![var("i")]),
+                ],
+            ))],
+        }],
+    );
+    vec![square, table]
+}
+
+/// A call that never reaches stdio keeps the buffer inside the loop
+#[test]
+fn test_quiet_callee_in_printf_is_not_flushed() {
+    let functions = table_of_squares();
+    let quiet = StdioAnalyzer::new().analyze(&functions);
+    let code = buffered().with_quiet_functions(quiet).generate_function(&functions[1]);
+
+    assert!(code.contains("let __arg0 = square(i);"), "{}", code);
+    assert!(code.contains("write!(__stdout, \"{}\\n\", __arg0)"), "{}", code);
+    assert!(!code.contains("flush"), "{}", code);
+}
+
+/// A callee that may print is flushed before, outside the write! that
+/// borrows the writer
+#[test]
+fn test_printing_callee_in_printf_is_evaluated_first() {
+    let functions = table_of_squares();
+    let code = buffered().generate_function(&functions[1]);
+
+    assert!(
+        code.contains(
+            "{ let __arg0 = { let _ = __stdout.flush(); square(i) }; \
+             let _ = write!(__stdout, \"{}\\n\", __arg0); }"
+        ),
+        "{}",
+        code
+    );
+}
+
+/// exit() flushes before terminating the process
+#[test]
+fn test_exit_flushes_buffer() {
+    let func = HirFunction::new_with_body(
+        "fail".to_string(),
+        HirType::Void,
+        vec![],
+        vec![
+            HirStatement::Expression(call(
+                "printf",
+                vec![HirExpression::StringLiteral("bye".to_string())],
+            )),
+            HirStatement::Expression(call("exit", vec![HirExpression::IntLiteral(2)])),
+        ],
+    );
+    let code = buffered().generate_function(&func);
+
+    assert!(code.contains("{ let _ = __stdout.flush(); std::process::exit(2) }"), "{}", code);
+}
+
+/// Functions that never print get no writer
+#[test]
+fn test_quiet_function_has_no_writer() {
+    let func = HirFunction::new_with_body(
+        "quiet".to_string(),
+        HirType::Int,
+        vec![],
+        vec![HirStatement::Return(Some(call("helper", vec![])))],
+    );
+    let code = buffered().generate_function(&func);
+
+    assert!(!code.contains("__stdout"), "{}", code);
+}
+
+/// The default mode keeps print!/println!
+#[test]
+fn test_default_mode_uses_print_macros() {
+    let code = CodeGenerator::new().generate_function(&printing_main());
+
+    assert!(code.contains("print!(\"{}\\n\", i)"), "{}", code);
+    assert!(code.contains("println!(\"{}\", \"done\")"), "{}", code);
+    assert!(!code.contains("__stdout"), "{}", code);
+}
+
+/// sprintf into a char array formats in place, with no intermediate String
+#[test]
+fn test_sprintf_writes_into_destination() {
+    let func = HirFunction::new_with_body(
+        "label".to_string(),
+        HirType::Void,
+        vec![],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "buf".to_string(),
+                var_type: HirType::Array { element_type: Box::new(HirType::Char), size: Some(32) },
+                initializer: None,
+            },
+            HirStatement::Expression(call(
+                "sprintf",
+                vec![
+                    var("buf"),
+                    HirExpression::StringLiteral("n=%d".to_string()),
+                    HirExpression::IntLiteral(7),
+                ],
+            )),
+            HirStatement::Expression(call(
+                "snprintf",
+                vec![
+                    var("buf"),
+                    HirExpression::IntLiteral(4),
+                    HirExpression::StringLiteral("%d".to_string()),
+                    HirExpression::IntLiteral(12345),
+                ],
+            )),
+        ],
+    );
+    let code = CodeGenerator::new().generate_function(&func);
+
+    assert!(code.contains("let __dst = &mut buf[..];"), "{}", code);
+    assert!(code.contains("__Truncate(&mut __dst[..__cap], 0)"), "{}", code);
+    assert!(code.contains("(4 as usize).min(__dst.len())"), "{}", code);
+    assert!(!code.contains("format!"), "{}", code);
+}
+
+/// snprintf yields the length of the whole output, so `>= size` detects
+/// truncation, and a size of 0 leaves the buffer alone
+#[test]
+fn test_snprintf_returns_untruncated_length() {
+    let func = HirFunction::new_with_body(
+        "fits".to_string(),
+        HirType::Int,
+        vec![HirParameter::new("size".to_string(), HirType::Int)],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "buf".to_string(),
+                var_type: HirType::Array { element_type: Box::new(HirType::Char), size: Some(4) },
+                initializer: None,
+            },
+            HirStatement::Return(Some(call(
+                "snprintf",
+                vec![
+                    var("buf"),
+                    var("size"),
+                    HirExpression::StringLiteral("%d".to_string()),
+                    HirExpression::IntLiteral(12345),
+                ],
+            ))),
+        ],
+    );
+    let code = CodeGenerator::new().generate_function(&func);
+
+    // Bytes past the limit are counted but not stored
+    assert!(code.contains("self.1 += s.len();"), "{}", code);
+    assert!(code.contains("__n as i32"), "{}", code);
+    assert!(code.contains("if __lim > 0 { __dst[__n.min(__cap)] = 0; }"), "{}", code);
+}
@@ -0,0 +1,197 @@
+//! Tests for counted `for` loops lowered to usize ranges.
+//!
+//! Reference: K&R §3.5, ISO C99 §6.8.5.3
+//!
+//! `for (int i = 0; i < bound; i++)` loops that index buffers by `i` become
+//! `for __i in 0..bound` and index with `__i` directly. With a bound of
+//! `a.len()` or a constant inside a fixed array, rustc can prove every
+//! access in bounds, drop the per-element checks and vectorise the loop.
+
+use decy_codegen::CodeGenerator;
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn int(value: i32) -> HirExpression {
+    HirExpression::IntLiteral(value)
+}
+
+fn binary(op: BinaryOperator, left: HirExpression, right: HirExpression) -> HirExpression {
+    HirExpression::BinaryOp { op, left: Box::new(left), right: Box::new(right) }
+}
+
+fn index(array: &str, i: &str) -> HirExpression {
+    HirExpression::ArrayIndex { array: Box::new(var(array)), index: Box::new(var(i)) }
+}
+
+fn len(array: &str) -> HirExpression {
+    HirExpression::StringMethodCall {
+        receiver: Box::new(var(array)),
+        method: "len".to_string(),
+        arguments: vec![],
+    }
+}
+
+fn slice(mutable: bool) -> HirType {
+    HirType::Reference {
+        inner: Box::new(HirType::Array { element_type: Box::new(HirType::Int), size: None }),
+        mutable,
+    }
+}
+
+/// `for (int i = 0; i < bound; i++) { body }`
+fn counted_for(bound: HirExpression, body: Vec<HirStatement>) -> HirStatement {
+    HirStatement::For {
+        init: vec![HirStatement::VariableDeclaration {
+            name: "i".to_string(),
+            var_type: HirType::Int,
+            initializer: Some(int(0)),
+        }],
+        condition: Some(binary(BinaryOperator::LessThan, var("i"), bound)),
+        increment: vec![HirStatement::Assignment {
+            target: "i".to_string(),
+            value: binary(BinaryOperator::Add, var("i"), int(1)),
+        }],
+        body,
+    }
+}
+
+fn generate(params: Vec<(&str, HirType)>, body: Vec<HirStatement>) -> String {
+    let params =
+        params.into_iter().map(|(name, ty)| HirParameter::new(name.to_string(), ty)).collect();
+    let func = HirFunction::new_with_body("kernel".to_string(), HirType::Void, params, body);
+    CodeGenerator::new().generate_function(&func)
+}
+
+/// C: for (i = 0; i < len; i++) s ^= a[i];  (len folded into a.len())
+/// Rust: for __i in 0..a.len() { s = s ^ a[__i]; }
+#[test]
+fn test_slice_length_loop_uses_range() {
+    let code = generate(
+        vec![("a", slice(false))],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "s".to_string(),
+                var_type: HirType::Int,
+                initializer: Some(int(0)),
+            },
+            counted_for(
+                len("a"),
+                vec![HirStatement::Assignment {
+                    target: "s".to_string(),
+                    value: binary(BinaryOperator::BitwiseXor, var("s"), index("a", "i")),
+                }],
+            ),
+        ],
+    );
+
+    assert!(code.contains("for __i in 0..a.len() {"), "{}", code);
+    assert!(code.contains("s = s ^ a[__i];"), "{}", code);
+    assert!(!code.contains("while"), "{}", code);
+    assert!(!code.contains("let i"), "index value is unused:\n{}", code);
+}
+
+/// Other slices touched every iteration get one hoisted length check
+#[test]
+fn test_parallel_slices_hoist_one_assert() {
+    let code = generate(
+        vec![("a", slice(false)), ("b", slice(false)), ("c", slice(true))],
+        vec![counted_for(
+            len("a"),
+            vec![HirStatement::ArrayIndexAssignment {
+                array: Box::new(var("c")),
+                index: Box::new(var("i")),
+                value: binary(BinaryOperator::Add, index("a", "i"), index("b", "i")),
+            }],
+        )],
+    );
+
+    assert!(code.contains("let __i_end = a.len();"), "{}", code);
+    assert!(code.contains("assert!(__i_end <= c.len() && __i_end <= b.len());"), "{}", code);
+    assert!(code.contains("for __i in 0..__i_end {"), "{}", code);
+    assert!(code.contains("c[__i] = a[__i] + b[__i];"), "{}", code);
+}
+
+/// Constant bounds inside a fixed array need no check; the index value stays available
+#[test]
+fn test_fixed_array_constant_bound() {
+    let code = generate(
+        vec![],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "squares".to_string(),
+                var_type: HirType::Array { element_type: Box::new(HirType::Int), size: Some(16) },
+                initializer: None,
+            },
+            counted_for(
+                int(16),
+                vec![HirStatement::ArrayIndexAssignment {
+                    array: Box::new(var("squares")),
+                    index: Box::new(var("i")),
+                    value: binary(BinaryOperator::Multiply, var("i"), var("i")),
+                }],
+            ),
+        ],
+    );
+
+    assert!(code.contains("for __i in 0..16 {"), "{}", code);
+    assert!(code.contains("let i: i32 = __i as i32;"), "{}", code);
+    assert!(code.contains("squares[__i] = i * i;"), "{}", code);
+    assert!(!code.contains("assert!"), "{}", code);
+}
+
+/// A variable bound is clamped at zero; a branching body gets no hoisted assert
+#[test]
+fn test_variable_bound_with_branch() {
+    let code = generate(
+        vec![("a", slice(false)), ("n", HirType::Int)],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "hits".to_string(),
+                var_type: HirType::Int,
+                initializer: Some(int(0)),
+            },
+            counted_for(
+                var("n"),
+                vec![HirStatement::If {
+                    condition: binary(BinaryOperator::Equal, index("a", "i"), int(0)),
+                    then_block: vec![HirStatement::Break],
+                    else_block: None,
+                }],
+            ),
+        ],
+    );
+
+    assert!(code.contains("for __i in 0..(n).max(0) as usize {"), "{}", code);
+    assert!(code.contains("a[__i] == 0"), "{}", code);
+    assert!(!code.contains("assert!"), "{}", code);
+}
+
+/// Bodies that change the index or the bound keep the while loop
+#[test]
+fn test_mutated_index_or_bound_keeps_while() {
+    for target in ["i", "n"] {
+        let code = generate(
+            vec![("a", slice(true)), ("n", HirType::Int)],
+            vec![counted_for(
+                var("n"),
+                vec![
+                    HirStatement::ArrayIndexAssignment {
+                        array: Box::new(var("a")),
+                        index: Box::new(var("i")),
+                        value: int(0),
+                    },
+                    HirStatement::Assignment {
+                        target: target.to_string(),
+                        value: binary(BinaryOperator::Add, var(target), int(1)),
+                    },
+                ],
+            )],
+        );
+
+        assert!(code.contains("while i < n {"), "{}", code);
+        assert!(!code.contains("__i"), "{}", code);
+    }
+}
@@ -0,0 +1,106 @@
+//! Tests for callbacks taken as a generic `FnMut` instead of a `fn` pointer.
+//!
+//! Reference: K&R §5.11, ISO C99 §6.7.5.3
+//!
+//! Once the `void*` of a callback API has a concrete type, the callback
+//! parameter becomes `F: FnMut(&mut T)`. rustc monomorphises the function
+//! for each callback passed in and can inline it, where a `fn` pointer
+//! would stay an indirect call.
+
+use decy_codegen::CodeGenerator;
+use decy_hir::{HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+use decy_ownership::lifetime_gen::LifetimeAnnotator;
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn int_ptr() -> HirType {
+    HirType::Pointer(Box::new(HirType::Int))
+}
+
+fn visit_type() -> HirType {
+    HirType::FunctionPointer { param_types: vec![int_ptr()], return_type: Box::new(HirType::Void) }
+}
+
+/// void apply(int *item, void (*visit)(int *)) { visit(item); }
+fn apply() -> HirFunction {
+    HirFunction::new_with_body(
+        "apply".to_string(),
+        HirType::Void,
+        vec![
+            HirParameter::new("item".to_string(), int_ptr()),
+            HirParameter::new("visit".to_string(), visit_type()),
+        ],
+        vec![HirStatement::Expression(HirExpression::FunctionCall {
+            function: "visit".to_string(),
+            arguments: vec![var("item")],
+        })],
+    )
+}
+
+/// void twice(int *item, void (*visit)(int *)) { apply(item, visit); apply(item, bump); }
+fn twice() -> HirFunction {
+    let call = |callback: &str| {
+        HirStatement::Expression(HirExpression::FunctionCall {
+            function: "apply".to_string(),
+            arguments: vec![var("item"), var(callback)],
+        })
+    };
+    HirFunction::new_with_body(
+        "twice".to_string(),
+        HirType::Void,
+        vec![
+            HirParameter::new("item".to_string(), int_ptr()),
+            HirParameter::new("visit".to_string(), visit_type()),
+        ],
+        vec![call("visit"), call("bump")],
+    )
+}
+
+fn generate(codegen: &CodeGenerator, func: &HirFunction) -> String {
+    let sig = LifetimeAnnotator::new().annotate_function(func);
+    let functions = vec![
+        ("apply".to_string(), vec![int_ptr(), visit_type()]),
+        ("bump".to_string(), vec![int_ptr()]),
+    ];
+    codegen.generate_function_with_lifetimes_and_structs(func, &sig, &[], &functions, &[], &[], &[])
+}
+
+fn codegen() -> CodeGenerator {
+    CodeGenerator::new().with_generic_callbacks([
+        ("apply".to_string(), vec![(1, "visit".to_string())]),
+        ("twice".to_string(), vec![(1, "visit".to_string())]),
+    ])
+}
+
+/// C: void (*visit)(int *)
+/// Rust: F0: FnMut(&mut i32), called directly
+#[test]
+fn test_callback_param_is_generic_fn_mut() {
+    let code = generate(&codegen(), &apply());
+
+    assert!(code.contains("F0: FnMut(&mut i32)"), "{}", code);
+    assert!(code.contains("mut visit: F0"), "{}", code);
+    assert!(code.contains("visit(item)"), "{}", code);
+    assert!(!code.contains("fn(*mut i32)"), "{}", code);
+}
+
+/// C: apply(item, visit); apply(item, bump);
+/// Rust: the generic callback is forwarded by `&mut`, a function by closure
+#[test]
+fn test_callbacks_passed_to_generic_callee() {
+    let code = generate(&codegen(), &twice());
+
+    assert!(code.contains("apply(item, &mut visit)"), "{}", code);
+    assert!(code.contains("apply(item, |a0| bump(a0))"), "{}", code);
+}
+
+/// Without generic callbacks the `fn` pointer type is kept
+#[test]
+fn test_plain_callback_param_stays_fn_pointer() {
+    let code = generate(&CodeGenerator::new(), &apply());
+
+    assert!(!code.contains("FnMut"), "{}", code);
+    assert!(code.contains("fn(*mut i32)"), "{}", code);
+}
@@ -0,0 +1,287 @@
+//! Tests for the storage of C globals and errno.
+//!
+//! Reference: K&R §4.3, ISO C99 §6.2.4, §7.5
+//!
+//! Globals that are never written become plain `static` tables and `const`
+//! scalars, integer scalars updated by assignment and increments become
+//! `Atomic*` with `Relaxed` ordering, and everything else keeps `static mut`. `errno` is a
+//! thread-local `Cell<i32>` declared only when the program uses it.
+
+use decy_codegen::{CodeGenerator, GlobalStorage, ModuleStatics};
+use decy_hir::{
+    BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType, UnaryOperator,
+};
+use decy_ownership::lifetime_gen::LifetimeAnnotator;
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn int(value: i32) -> HirExpression {
+    HirExpression::IntLiteral(value)
+}
+
+fn global(name: &str, var_type: HirType, initializer: Option<HirExpression>) -> HirStatement {
+    HirStatement::VariableDeclaration { name: name.to_string(), var_type, initializer }
+}
+
+fn function(name: &str, return_type: HirType, body: Vec<HirStatement>) -> HirFunction {
+    let params = vec![HirParameter::new("i".to_string(), HirType::Int)];
+    HirFunction::new_with_body(name.to_string(), return_type, params, body)
+}
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirStatement {
+    HirStatement::Expression(HirExpression::FunctionCall {
+        function: function.to_string(),
+        arguments,
+    })
+}
+
+/// Declarations and functions of a unit, as decy-core emits them.
+fn generate(globals: &[HirStatement], functions: &[HirFunction]) -> (ModuleStatics, String) {
+    let statics = ModuleStatics::analyze(globals, functions);
+    let codegen = CodeGenerator::new().with_module_statics(statics.clone());
+    let mut code = codegen.generate_errno_declaration().unwrap_or_default().to_string();
+    let mut global_vars = Vec::new();
+    for stmt in globals {
+        let HirStatement::VariableDeclaration { name, var_type, initializer } = stmt else {
+            continue;
+        };
+        let init = initializer.as_ref().map_or("0".to_string(), |e| codegen.generate_expression(e));
+        let type_str = CodeGenerator::map_type(var_type);
+        code.push_str(&codegen.generate_global_declaration(name, var_type, &type_str, &init));
+        global_vars.push((name.clone(), var_type.clone()));
+    }
+    for func in functions {
+        let sig = LifetimeAnnotator::new().annotate_function(func);
+        code.push_str(&codegen.generate_function_with_lifetimes_and_structs(
+            func,
+            &sig,
+            &[],
+            &[],
+            &[],
+            &[],
+            &global_vars,
+        ));
+    }
+    (statics, code)
+}
+
+fn table() -> HirStatement {
+    global(
+        "table",
+        HirType::Array { element_type: Box::new(HirType::Int), size: Some(4) },
+        Some(HirExpression::CompoundLiteral {
+            literal_type: HirType::Array { element_type: Box::new(HirType::Int), size: Some(4) },
+            initializers: vec![int(1), int(2), int(4), int(8)],
+        }),
+    )
+}
+
+fn lookup() -> HirFunction {
+    function(
+        "lookup",
+        HirType::Int,
+        vec![HirStatement::Return(Some(HirExpression::ArrayIndex {
+            array: Box::new(var("table")),
+            index: Box::new(var("i")),
+        }))],
+    )
+}
+
+/// `hits = hits + i; return hits++;`
+fn bump() -> HirFunction {
+    function(
+        "bump",
+        HirType::Int,
+        vec![
+            HirStatement::Assignment {
+                target: "hits".to_string(),
+                value: HirExpression::BinaryOp {
+                    op: BinaryOperator::Add,
+                    left: Box::new(var("hits")),
+                    right: Box::new(var("i")),
+                },
+            },
+            HirStatement::Return(Some(HirExpression::PostIncrement {
+                operand: Box::new(var("hits")),
+            })),
+        ],
+    )
+}
+
+/// C: static const-like table read only by indexing
+/// Rust: static table: [i32; 4] = ...; read without unsafe
+#[test]
+fn test_read_only_table_is_plain_static() {
+    let (statics, code) = generate(&[table()], &[lookup()]);
+
+    assert_eq!(statics.storage("table"), GlobalStorage::Immutable);
+    assert!(code.contains("static table: [i32; 4] = "), "{}", code);
+    assert!(!code.contains("static mut"), "{}", code);
+    assert!(!code.contains("unsafe"), "{}", code);
+}
+
+/// C: int limit = 64; ... return i < limit;
+/// Rust: const limit: i32 = 64; inlined into its uses
+#[test]
+fn test_read_only_scalar_is_const() {
+    let below = function(
+        "below",
+        HirType::Int,
+        vec![HirStatement::Return(Some(HirExpression::BinaryOp {
+            op: BinaryOperator::LessThan,
+            left: Box::new(var("i")),
+            right: Box::new(var("limit")),
+        }))],
+    );
+    let (statics, code) =
+        generate(&[global("limit", HirType::Int, Some(int(64))), table()], &[below]);
+
+    assert_eq!(statics.storage("limit"), GlobalStorage::Immutable);
+    assert!(code.contains("const limit: i32 = 64;"), "{}", code);
+    assert!(code.contains("static table: [i32; 4] = "), "tables stay in one place:\n{}", code);
+    assert!(!code.contains("unsafe"), "{}", code);
+}
+
+/// C: read-only pointer and struct globals
+/// Rust: never `const`, which would make a fresh value at every use
+#[test]
+fn test_read_only_aggregates_are_not_const() {
+    let cursor = global("cursor", HirType::Pointer(Box::new(HirType::Int)), None);
+    let origin = global("origin", HirType::Struct("Point".to_string()), None);
+    let read = function(
+        "read",
+        HirType::Int,
+        vec![HirStatement::Return(Some(HirExpression::BinaryOp {
+            op: BinaryOperator::Add,
+            left: Box::new(HirExpression::Dereference(Box::new(var("cursor")))),
+            right: Box::new(HirExpression::FieldAccess {
+                object: Box::new(var("origin")),
+                field: "x".to_string(),
+            }),
+        }))],
+    );
+    let (_, code) = generate(&[cursor, origin], &[read]);
+
+    assert!(!code.contains("const cursor"), "{}", code);
+    assert!(!code.contains("const origin"), "{}", code);
+}
+
+/// C: int hits; hits = hits + i; return hits++;
+/// Rust: static hits: AtomicI32 updated by Relaxed loads and stores
+#[test]
+fn test_counter_becomes_relaxed_atomic() {
+    let (statics, code) = generate(&[global("hits", HirType::Int, None)], &[bump()]);
+
+    assert_eq!(statics.storage("hits"), GlobalStorage::Atomic);
+    assert!(
+        code.contains(
+            "static hits: std::sync::atomic::AtomicI32 = std::sync::atomic::AtomicI32::new(0);"
+        ),
+        "{}",
+        code
+    );
+    assert!(
+        code.contains(
+            "hits.store(hits.load(std::sync::atomic::Ordering::Relaxed) + i, \
+             std::sync::atomic::Ordering::Relaxed);"
+        ),
+        "{}",
+        code
+    );
+    assert!(
+        code.contains(
+            "{ let __tmp = hits.load(std::sync::atomic::Ordering::Relaxed); \
+             hits.store(__tmp.wrapping_add(1), std::sync::atomic::Ordering::Relaxed); __tmp }"
+        ),
+        "{}",
+        code
+    );
+    assert!(!code.contains("fetch_add"), "no locked read-modify-write:\n{}", code);
+    assert!(!code.contains("unsafe"), "{}", code);
+}
+
+/// Floats, aliased globals and written tables keep `static mut`
+#[test]
+fn test_other_globals_stay_static_mut() {
+    let scale = function(
+        "scale",
+        HirType::Void,
+        vec![HirStatement::Assignment {
+            target: "ratio".to_string(),
+            value: HirExpression::FloatLiteral("0.5".to_string()),
+        }],
+    );
+    let alias = function(
+        "alias",
+        HirType::Void,
+        vec![
+            call(
+                "touch",
+                vec![HirExpression::UnaryOp {
+                    op: UnaryOperator::AddressOf,
+                    operand: Box::new(var("hits")),
+                }],
+            ),
+            HirStatement::ArrayIndexAssignment {
+                array: Box::new(var("table")),
+                index: Box::new(var("i")),
+                value: int(0),
+            },
+        ],
+    );
+    let globals =
+        [global("ratio", HirType::Float, None), global("hits", HirType::Int, None), table()];
+    let (statics, code) = generate(&globals, &[scale, alias, bump(), lookup()]);
+
+    assert_eq!(statics.storage("ratio"), GlobalStorage::Mutable);
+    assert_eq!(statics.storage("hits"), GlobalStorage::Mutable);
+    assert_eq!(statics.storage("table"), GlobalStorage::Mutable);
+    assert!(code.contains("static mut ratio: f32"), "{}", code);
+    assert!(code.contains("static mut hits: i32"), "{}", code);
+    assert!(code.contains("static mut table: [i32; 4]"), "{}", code);
+}
+
+/// Atomics need the program to start no threads, or to lock around shared state
+#[test]
+fn test_threads_without_locks_keep_static_mut() {
+    let spawn = function("spawn", HirType::Void, vec![call("pthread_create", vec![])]);
+    let globals = [global("hits", HirType::Int, None)];
+
+    let statics = ModuleStatics::analyze(&globals, &[bump(), spawn.clone()]);
+    assert_eq!(statics.storage("hits"), GlobalStorage::Mutable);
+
+    let lock = function("lock", HirType::Void, vec![call("pthread_mutex_lock", vec![])]);
+    let statics = ModuleStatics::analyze(&globals, &[bump(), spawn, lock]);
+    assert_eq!(statics.storage("hits"), GlobalStorage::Atomic);
+}
+
+/// C: errno = 0; return errno;
+/// Rust: thread_local ERRNO cell, declared only when used
+#[test]
+fn test_errno_is_thread_local_cell() {
+    let (_, code) = generate(&[table()], &[lookup()]);
+    assert!(!code.contains("ERRNO"), "{}", code);
+
+    let check = function(
+        "check",
+        HirType::Int,
+        vec![
+            HirStatement::Assignment { target: "errno".to_string(), value: int(0) },
+            HirStatement::Return(Some(var("errno"))),
+        ],
+    );
+    let (statics, code) = generate(&[], &[check]);
+
+    assert!(statics.uses_errno());
+    assert!(code.contains("thread_local! {"), "{}", code);
+    assert!(
+        code.contains("static ERRNO: std::cell::Cell<i32> = const { std::cell::Cell::new(0) };"),
+        "{}",
+        code
+    );
+    assert!(code.contains("ERRNO.set(0);"), "{}", code);
+    assert!(code.contains("return ERRNO.get();"), "{}", code);
+    assert!(!code.contains("unsafe"), "{}", code);
+}
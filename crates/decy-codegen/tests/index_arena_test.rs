@@ -0,0 +1,147 @@
+//! Tests for self-referential structs lowered onto index arenas.
+//!
+//! Reference: K&R §6.5, ISO C99 §6.7.2.3
+//!
+//! With `index_arenas`, list and tree nodes live in one `Vec` per struct
+//! type: links are `u32` indices with 0 for NULL, `malloc`/`free` of a node
+//! become `alloc()`/`free()` on the arena, and `p->field` indexes it.
+
+use decy_codegen::CodeGenerator;
+use decy_hir::{
+    BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirStruct,
+    HirStructField, HirType,
+};
+use decy_ownership::arena::IndexArenaPlan;
+use decy_ownership::lifetime_gen::LifetimeAnnotator;
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn tree_ptr() -> HirType {
+    HirType::Pointer(Box::new(HirType::Struct("TreeNode".to_string())))
+}
+
+fn arrow(pointer: &str, field: &str) -> HirExpression {
+    HirExpression::PointerFieldAccess { pointer: Box::new(var(pointer)), field: field.to_string() }
+}
+
+fn tree_node() -> HirStruct {
+    HirStruct::new(
+        "TreeNode".to_string(),
+        vec![
+            HirStructField::new("value".to_string(), HirType::Double),
+            HirStructField::new("left".to_string(), tree_ptr()),
+            HirStructField::new("right".to_string(), tree_ptr()),
+        ],
+    )
+}
+
+/// int depth(struct TreeNode *root) {
+///     if (root == NULL) return 0;
+///     int l = depth(root->left); int r = depth(root->right);
+///     return 1 + (l > r ? l : r);
+/// }
+fn depth() -> HirFunction {
+    let decl = |name: &str, child: &str| HirStatement::VariableDeclaration {
+        name: name.to_string(),
+        var_type: HirType::Int,
+        initializer: Some(HirExpression::FunctionCall {
+            function: "depth".to_string(),
+            arguments: vec![arrow("root", child)],
+        }),
+    };
+    HirFunction::new_with_body(
+        "depth".to_string(),
+        HirType::Int,
+        vec![HirParameter::new("root".to_string(), tree_ptr())],
+        vec![
+            HirStatement::If {
+                condition: HirExpression::BinaryOp {
+                    op: BinaryOperator::Equal,
+                    left: Box::new(var("root")),
+                    right: Box::new(HirExpression::NullLiteral),
+                },
+                then_block: vec![HirStatement::Return(Some(HirExpression::IntLiteral(0)))],
+                else_block: None,
+            },
+            decl("l", "left"),
+            decl("r", "right"),
+            HirStatement::Return(Some(HirExpression::BinaryOp {
+                op: BinaryOperator::Add,
+                left: Box::new(HirExpression::IntLiteral(1)),
+                right: Box::new(HirExpression::Ternary {
+                    condition: Box::new(HirExpression::BinaryOp {
+                        op: BinaryOperator::GreaterThan,
+                        left: Box::new(var("l")),
+                        right: Box::new(var("r")),
+                    }),
+                    then_expr: Box::new(var("l")),
+                    else_expr: Box::new(var("r")),
+                }),
+            })),
+        ],
+    )
+}
+
+/// C: struct TreeNode { double value; struct TreeNode *left, *right; };
+/// Rust: u32 links, plus an arena whose slot 0 is the vacant NULL node
+#[test]
+fn test_arena_type_for_tree_node() {
+    let plan = IndexArenaPlan::plan(&[tree_node()], &[], &[depth()]);
+    let lowered = plan.lower_struct(&tree_node());
+    let codegen = CodeGenerator::new();
+
+    let code = codegen.generate_struct(&lowered);
+    assert!(code.contains("pub left: u32,"), "{}", code);
+    assert!(code.contains("pub right: u32,"), "{}", code);
+
+    let code = codegen.generate_index_arena(&lowered, None);
+    assert!(code.contains("pub struct TreeNodeArena {"), "{}", code);
+    assert!(code.contains("nodes: Vec<TreeNode>,"), "{}", code);
+    assert!(code.contains("TreeNode { value: 0.0, left: 0, right: 0 }"), "{}", code);
+    assert!(code.contains("fn alloc(&mut self) -> u32 {"), "{}", code);
+    assert!(code.contains("fn free(&mut self, index: u32) {"), "{}", code);
+    assert!(code.contains("impl std::ops::IndexMut<usize> for TreeNodeArena {"), "{}", code);
+}
+
+/// C: depth(root->left)
+/// Rust: depth(tree_node_arena, tree_node_arena[(root) as usize].left), no unsafe
+#[test]
+fn test_recursive_walk_indexes_arena() {
+    let plan = IndexArenaPlan::plan(&[tree_node()], &[], &[depth()]);
+    let func = plan.lower_function(&depth());
+    let sig = LifetimeAnnotator::new().annotate_function(&func);
+    let code = CodeGenerator::new().generate_function_with_lifetimes_and_structs(
+        &func,
+        &sig,
+        &[plan.lower_struct(&tree_node())],
+        &[],
+        &[],
+        &[],
+        &[],
+    );
+
+    assert!(code.contains("tree_node_arena: &'a mut TreeNodeArena, mut root: u32"), "{}", code);
+    assert!(
+        code.contains("depth(tree_node_arena, tree_node_arena[(root) as usize].left)"),
+        "{}",
+        code
+    );
+    assert!(!code.contains("unsafe"), "{}", code);
+    assert!(!code.contains("*mut TreeNode"), "{}", code);
+}
+
+/// C: struct TreeNode pool[64]; handed out by a pool allocator
+/// Rust: arena reserving 64 nodes, whose alloc returns 0 (NULL) when full
+#[test]
+fn test_bounded_arena_for_pool_allocator() {
+    let plan = IndexArenaPlan::plan(&[tree_node()], &[], &[depth()]);
+    let code =
+        CodeGenerator::new().generate_index_arena(&plan.lower_struct(&tree_node()), Some(64));
+
+    assert!(code.contains("Vec::with_capacity(65)"), "{}", code);
+    assert!(code.contains("if self.nodes.len() > 64 {"), "{}", code);
+    assert!(code.contains("return 0;"), "{}", code);
+    assert!(code.contains("fn reset(&mut self) {"), "{}", code);
+}
@@ -0,0 +1,165 @@
+//! Tests for pointer-walking loops lowered to slice iteration.
+//!
+//! Reference: K&R §5.5, ISO C99 §6.5.6
+//!
+//! `char*` parameters stepped with `s++` become a `&[u8]` plus an index
+//! (DECY-134). NUL-terminated walks over them, `while (*s) { ...; s++; }`,
+//! iterate the bytes instead of indexing each one, and the copy idiom
+//! `while (*src) *dst++ = *src++;` becomes a single `copy_from_slice`.
+
+use decy_codegen::CodeGenerator;
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+use decy_ownership::lifetime_gen::LifetimeAnnotator;
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn deref(expr: HirExpression) -> HirExpression {
+    HirExpression::Dereference(Box::new(expr))
+}
+
+fn post_increment(name: &str) -> HirExpression {
+    HirExpression::PostIncrement { operand: Box::new(var(name)) }
+}
+
+fn char_ptr(name: &str) -> HirParameter {
+    HirParameter::new(name.to_string(), HirType::Pointer(Box::new(HirType::Char)))
+}
+
+/// `n++;` as the parser lowers it
+fn increment(name: &str) -> HirStatement {
+    HirStatement::Assignment {
+        target: name.to_string(),
+        value: HirExpression::BinaryOp {
+            op: BinaryOperator::Add,
+            left: Box::new(var(name)),
+            right: Box::new(HirExpression::IntLiteral(1)),
+        },
+    }
+}
+
+fn generate(params: Vec<HirParameter>, body: Vec<HirStatement>) -> String {
+    let func = HirFunction::new_with_body("walk".to_string(), HirType::Int, params, body);
+    let sig = LifetimeAnnotator::new().annotate_function(&func);
+    CodeGenerator::new().generate_function_with_lifetimes_and_structs(
+        &func,
+        &sig,
+        &[],
+        &[],
+        &[],
+        &[],
+        &[],
+    )
+}
+
+/// `int n = 0; while (*s) { if (*s == c) n++; s++; } return n;`
+fn count_body(extra: Option<HirStatement>) -> Vec<HirStatement> {
+    let mut walk = vec![HirStatement::If {
+        condition: HirExpression::BinaryOp {
+            op: BinaryOperator::Equal,
+            left: Box::new(deref(var("s"))),
+            right: Box::new(var("c")),
+        },
+        then_block: vec![increment("n")],
+        else_block: extra.map(|stmt| vec![stmt]),
+    }];
+    walk.push(increment("s"));
+    vec![
+        HirStatement::VariableDeclaration {
+            name: "n".to_string(),
+            var_type: HirType::Int,
+            initializer: Some(HirExpression::IntLiteral(0)),
+        },
+        HirStatement::While { condition: deref(var("s")), body: walk },
+        HirStatement::Return(Some(var("n"))),
+    ]
+}
+
+/// C: while (*s) { if (*s == c) n++; s++; }
+/// Rust: for &__s_byte in s[s_idx..].iter().take_while(..) { if __s_byte == c { .. } s_idx += 1; }
+#[test]
+fn test_nul_walk_iterates_bytes() {
+    let code = generate(
+        vec![char_ptr("s"), HirParameter::new("c".to_string(), HirType::Char)],
+        count_body(None),
+    );
+
+    assert!(
+        code.contains("for &__s_byte in s[s_idx..].iter().take_while(|&&__b| __b != 0) {"),
+        "{}",
+        code
+    );
+    assert!(code.contains("if __s_byte == c {"), "{}", code);
+    assert!(code.contains("s_idx += 1;\n}"), "{}", code);
+    assert!(!code.contains("while ("), "{}", code);
+    assert!(!code.contains("unsafe"), "{}", code);
+}
+
+/// `continue` would skip the `s++`, so the walk keeps its while loop
+#[test]
+fn test_nul_walk_with_continue_keeps_while() {
+    let code = generate(
+        vec![char_ptr("s"), HirParameter::new("c".to_string(), HirType::Char)],
+        count_body(Some(HirStatement::Continue)),
+    );
+
+    assert!(code.contains("while (s[s_idx]) != 0 {"), "{}", code);
+    assert!(!code.contains("take_while"), "{}", code);
+}
+
+/// C: while (*src) *dst++ = *src++; *dst = 0;
+/// Rust: one copy_from_slice of the NUL-terminated prefix, then dst[dst_idx] = 0
+#[test]
+fn test_copy_loop_uses_copy_from_slice() {
+    let code = generate(
+        vec![char_ptr("dst"), char_ptr("src")],
+        vec![
+            HirStatement::While {
+                condition: deref(var("src")),
+                body: vec![HirStatement::DerefAssignment {
+                    target: post_increment("dst"),
+                    value: deref(post_increment("src")),
+                }],
+            },
+            HirStatement::DerefAssignment {
+                target: var("dst"),
+                value: HirExpression::IntLiteral(0),
+            },
+            HirStatement::Return(Some(HirExpression::IntLiteral(0))),
+        ],
+    );
+
+    assert!(code.contains("dst: &mut [u8]"), "{}", code);
+    assert!(code.contains("std::ffi::CStr::from_bytes_until_nul(&src[src_idx..])"), "{}", code);
+    assert!(
+        code.contains("dst[dst_idx..dst_idx + __n].copy_from_slice(&src[src_idx..src_idx + __n]);"),
+        "{}",
+        code
+    );
+    assert!(code.contains("dst[dst_idx] = 0;"), "{}", code);
+    assert!(!code.contains("__tmp"), "{}", code);
+}
+
+/// Outside a recognised loop, *p++ still reads or writes and steps the index
+#[test]
+fn test_post_increment_deref_steps_index() {
+    let code = generate(
+        vec![char_ptr("dst"), char_ptr("src")],
+        vec![
+            HirStatement::DerefAssignment {
+                target: post_increment("dst"),
+                value: deref(post_increment("src")),
+            },
+            HirStatement::Return(Some(HirExpression::IntLiteral(0))),
+        ],
+    );
+
+    assert!(
+        code.contains(
+            "dst[dst_idx] = { let __c = src[src_idx]; src_idx += 1; __c }; dst_idx += 1;"
+        ),
+        "{}",
+        code
+    );
+}
@@ -0,0 +1,180 @@
+//! Tests for `qsort` and `bsearch` lowered onto slice sorting and searching.
+//!
+//! Reference: ISO C99 §7.20.5
+//!
+//! `qsort` becomes `sort_unstable*`, which like it sorts in place without
+//! allocating. A comparator ordering by one integer key is replaced by
+//! `sort_unstable()` or a key; any other is called inline with its `int`
+//! result compared with 0. `bsearch` becomes `binary_search*`, giving a
+//! pointer to the match or NULL.
+
+use decy_analyzer::comparator_analysis::{KeyComparator, SortKey};
+use decy_codegen::CodeGenerator;
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+use decy_ownership::lifetime_gen::LifetimeAnnotator;
+use decy_parser::parser::{Parameter, Type};
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirExpression {
+    HirExpression::FunctionCall { function: function.to_string(), arguments }
+}
+
+fn qsort(cmp: &str) -> HirStatement {
+    HirStatement::Expression(call(
+        "qsort",
+        vec![
+            var("data"),
+            HirExpression::IntLiteral(8),
+            HirExpression::Sizeof { type_name: "int".to_string() },
+            var(cmp),
+        ],
+    ))
+}
+
+/// void run(void) { int data[8]; int key = 3; body }
+fn run(body: Vec<HirStatement>) -> HirFunction {
+    let mut stmts = vec![
+        HirStatement::VariableDeclaration {
+            name: "data".to_string(),
+            var_type: HirType::Array { element_type: Box::new(HirType::Int), size: Some(8) },
+            initializer: None,
+        },
+        HirStatement::VariableDeclaration {
+            name: "key".to_string(),
+            var_type: HirType::Int,
+            initializer: Some(HirExpression::IntLiteral(3)),
+        },
+    ];
+    stmts.extend(body);
+    HirFunction::new_with_body("run".to_string(), HirType::Void, vec![], stmts)
+}
+
+fn generate(codegen: &CodeGenerator, func: &HirFunction) -> String {
+    let sig = LifetimeAnnotator::new().annotate_function(func);
+    let int_ref = HirType::Reference { inner: Box::new(HirType::Int), mutable: false };
+    let functions = vec![("cmp".to_string(), vec![int_ref.clone(), int_ref])];
+    codegen.generate_function_with_lifetimes_and_structs(func, &sig, &[], &functions, &[], &[], &[])
+}
+
+fn with_key(key: SortKey, descending: bool) -> CodeGenerator {
+    CodeGenerator::new().with_comparators([("cmp".to_string(), KeyComparator { key, descending })])
+}
+
+/// C: qsort(data, 8, sizeof(int), cmp) with cmp returning *(int *)a - *(int *)b
+/// Rust: data[..(8) as usize].sort_unstable()
+#[test]
+fn test_element_key_sorts_unstable() {
+    let code = generate(&with_key(SortKey::Element, false), &run(vec![qsort("cmp")]));
+
+    assert!(code.contains("data[..(8) as usize].sort_unstable();"), "{}", code);
+    assert!(!code.contains("cmp("), "{}", code);
+}
+
+/// C: a comparator returning (y->id > x->id) - (y->id < x->id)
+/// Rust: sort_unstable_by(|a, b| b.id.cmp(&a.id))
+#[test]
+fn test_descending_field_key() {
+    let code =
+        generate(&with_key(SortKey::Field("id".to_string()), true), &run(vec![qsort("cmp")]));
+
+    assert!(code.contains("sort_unstable_by(|a, b| b.id.cmp(&a.id))"), "{}", code);
+}
+
+/// C: qsort(data, 8, sizeof(int), cmp) with any other comparator
+/// Rust: its int result becomes an Ordering inline
+#[test]
+fn test_other_comparator_called_inline() {
+    let code = generate(&CodeGenerator::new(), &run(vec![qsort("cmp")]));
+
+    assert!(code.contains("sort_unstable_by(|a, b| cmp(a, b).cmp(&0))"), "{}", code);
+    assert!(!code.contains("sort_by("), "{}", code);
+}
+
+/// C: int *hit = bsearch(&key, data, 8, sizeof(int), cmp);
+/// Rust: binary_search, mapped to a pointer into the array or NULL
+#[test]
+fn test_bsearch_lowers_to_binary_search() {
+    let search = |codegen: &CodeGenerator| {
+        let hit = HirStatement::VariableDeclaration {
+            name: "hit".to_string(),
+            var_type: HirType::Pointer(Box::new(HirType::Int)),
+            initializer: Some(call(
+                "bsearch",
+                vec![
+                    HirExpression::AddressOf(Box::new(var("key"))),
+                    var("data"),
+                    HirExpression::IntLiteral(8),
+                    HirExpression::Sizeof { type_name: "int".to_string() },
+                    var("cmp"),
+                ],
+            )),
+        };
+        generate(codegen, &run(vec![hit]))
+    };
+
+    let code = search(&with_key(SortKey::Element, false));
+    assert!(code.contains("data[..(8) as usize].binary_search(&key)"), "{}", code);
+    assert!(
+        code.contains(".map_or(std::ptr::null_mut(), |i| data.as_ptr().wrapping_add(i) as *mut _)"),
+        "{}",
+        code
+    );
+
+    // cmp(key, e) > 0 when the element sorts before the key
+    let code = search(&CodeGenerator::new());
+    assert!(code.contains("binary_search_by(|e| 0.cmp(&cmp(&key, e)))"), "{}", code);
+}
+
+/// C: return (x > y) - (x < y);
+/// Rust: the comparisons are ints
+#[test]
+fn test_comparison_results_in_arithmetic_are_ints() {
+    let compare =
+        |op| HirExpression::BinaryOp { op, left: Box::new(var("x")), right: Box::new(var("y")) };
+    let func = HirFunction::new_with_body(
+        "sign".to_string(),
+        HirType::Int,
+        vec![
+            HirParameter::new("x".to_string(), HirType::Int),
+            HirParameter::new("y".to_string(), HirType::Int),
+        ],
+        vec![HirStatement::Return(Some(HirExpression::BinaryOp {
+            op: BinaryOperator::Subtract,
+            left: Box::new(compare(BinaryOperator::GreaterThan)),
+            right: Box::new(compare(BinaryOperator::LessThan)),
+        }))],
+    );
+    let code = generate(&CodeGenerator::new(), &func);
+
+    assert!(code.contains("((x > y) as i32) - ((x < y) as i32)"), "{}", code);
+}
+
+/// C: int cmp(const int *a, const int *b) { return *a - *b; }
+/// Rust: shared borrows, so the slice elements can be passed in
+#[test]
+fn test_const_pointer_params_are_shared_borrows() {
+    let param = |name: &str| {
+        HirParameter::from_ast_parameter(&Parameter {
+            name: name.to_string(),
+            param_type: Type::Pointer(Box::new(Type::Int)),
+            is_pointee_const: true,
+        })
+    };
+    let deref = |name: &str| HirExpression::Dereference(Box::new(var(name)));
+    let func = HirFunction::new_with_body(
+        "cmp".to_string(),
+        HirType::Int,
+        vec![param("a"), param("b")],
+        vec![HirStatement::Return(Some(HirExpression::BinaryOp {
+            op: BinaryOperator::Subtract,
+            left: Box::new(deref("a")),
+            right: Box::new(deref("b")),
+        }))],
+    );
+    let code = generate(&CodeGenerator::new(), &func);
+
+    assert!(code.contains("fn cmp(a: &i32, b: &i32) -> i32"), "{}", code);
+}
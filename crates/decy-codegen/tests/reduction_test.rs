@@ -0,0 +1,228 @@
+//! Tests for reduction loops lowered to iterator chains.
+//!
+//! Reference: K&R §3.5, ISO C99 §6.5.6
+//!
+//! Counted loops whose body only folds array elements into an accumulator
+//! (sum, dot product, count, minimum, maximum) become `sum`, `fold` and
+//! `filter().count()` over the indexed slices. Floating-point sums keep C's
+//! left-to-right order unless `reassociate_float_reductions` is enabled.
+
+use decy_codegen::{CodeGenerator, CodegenOptions};
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn int(value: i32) -> HirExpression {
+    HirExpression::IntLiteral(value)
+}
+
+fn binary(op: BinaryOperator, left: HirExpression, right: HirExpression) -> HirExpression {
+    HirExpression::BinaryOp { op, left: Box::new(left), right: Box::new(right) }
+}
+
+fn index(array: &str) -> HirExpression {
+    HirExpression::ArrayIndex { array: Box::new(var(array)), index: Box::new(var("i")) }
+}
+
+fn len(array: &str) -> HirExpression {
+    HirExpression::StringMethodCall {
+        receiver: Box::new(var(array)),
+        method: "len".to_string(),
+        arguments: vec![],
+    }
+}
+
+fn slice(element: HirType) -> HirType {
+    HirType::Reference {
+        inner: Box::new(HirType::Array { element_type: Box::new(element), size: None }),
+        mutable: false,
+    }
+}
+
+fn declare(name: &str, var_type: HirType, initializer: HirExpression) -> HirStatement {
+    HirStatement::VariableDeclaration {
+        name: name.to_string(),
+        var_type,
+        initializer: Some(initializer),
+    }
+}
+
+/// `acc = acc + value;`
+fn accumulate(acc: &str, value: HirExpression) -> HirStatement {
+    HirStatement::Assignment {
+        target: acc.to_string(),
+        value: binary(BinaryOperator::Add, var(acc), value),
+    }
+}
+
+/// `for (int i = 0; i < bound; i++) body`
+fn counted_for(bound: HirExpression, body: HirStatement) -> HirStatement {
+    HirStatement::For {
+        init: vec![declare("i", HirType::Int, int(0))],
+        condition: Some(binary(BinaryOperator::LessThan, var("i"), bound)),
+        increment: vec![accumulate("i", int(1))],
+        body: vec![body],
+    }
+}
+
+fn generate_with(
+    options: CodegenOptions,
+    params: Vec<(&str, HirType)>,
+    body: Vec<HirStatement>,
+) -> String {
+    let params =
+        params.into_iter().map(|(name, ty)| HirParameter::new(name.to_string(), ty)).collect();
+    let func = HirFunction::new_with_body("kernel".to_string(), HirType::Void, params, body);
+    CodeGenerator::with_options(options).generate_function(&func)
+}
+
+fn generate(params: Vec<(&str, HirType)>, body: Vec<HirStatement>) -> String {
+    generate_with(CodegenOptions::default(), params, body)
+}
+
+fn dot_product() -> Vec<HirStatement> {
+    vec![
+        declare("s", HirType::Double, HirExpression::FloatLiteral("0.0".to_string())),
+        counted_for(
+            var("n"),
+            accumulate("s", binary(BinaryOperator::Multiply, index("a"), index("b"))),
+        ),
+    ]
+}
+
+fn dot_params() -> Vec<(&'static str, HirType)> {
+    vec![("a", slice(HirType::Double)), ("b", slice(HirType::Double)), ("n", HirType::Int)]
+}
+
+/// C: for (i = 0; i < len; i++) s += a[i];
+/// Rust: s = s + a.iter().copied().sum::<i32>();
+#[test]
+fn test_integer_sum_uses_iter_sum() {
+    let code = generate(
+        vec![("a", slice(HirType::Int))],
+        vec![
+            declare("s", HirType::Int, int(0)),
+            counted_for(len("a"), accumulate("s", index("a"))),
+        ],
+    );
+
+    assert!(code.contains("s = s + a.iter().copied().sum::<i32>();"), "{}", code);
+    assert!(!code.contains("for "), "{}", code);
+}
+
+/// Float dot products keep C's order by default: zip + fold
+#[test]
+fn test_float_dot_product_folds_in_order() {
+    let code = generate(dot_params(), dot_product());
+
+    assert!(
+        code.contains(
+            "s = a[..(n).max(0) as usize].iter().zip(b[..(n).max(0) as usize].iter())\
+             .map(|(&__x, &__y)| __x * __y).fold(s, |__acc, __v| __acc + __v);"
+        ),
+        "{}",
+        code
+    );
+    assert!(!code.contains("chunks_exact"), "{}", code);
+}
+
+/// With reassociation enabled, float sums split across independent lanes
+#[test]
+fn test_reassociated_float_dot_product_uses_lanes() {
+    let options = CodegenOptions { reassociate_float_reductions: true, ..Default::default() };
+    let code = generate_with(options, dot_params(), dot_product());
+
+    assert!(code.contains("let mut __lanes: [f64; 8] = [0.0; 8];"), "{}", code);
+    assert!(code.contains("__lanes[__l] += __c[__l] * __d[__l];"), "{}", code);
+    assert!(code.contains("__cx.remainder().iter().zip(__cy.remainder().iter())"), "{}", code);
+    assert!(code.contains("__lanes.iter().sum::<f64>() + "), "{}", code);
+}
+
+/// C: for (i = 0; i < n; i++) if (a[i] > 0) c++;
+/// Rust: c = c + a[..n].iter().filter(|&&__x| __x > 0).count() as i32;
+#[test]
+fn test_count_uses_filter_count() {
+    let code = generate(
+        vec![("a", slice(HirType::Int)), ("n", HirType::Int)],
+        vec![
+            declare("c", HirType::Int, int(0)),
+            counted_for(
+                var("n"),
+                HirStatement::If {
+                    condition: binary(BinaryOperator::GreaterThan, index("a"), int(0)),
+                    then_block: vec![accumulate("c", int(1))],
+                    else_block: None,
+                },
+            ),
+        ],
+    );
+
+    assert!(
+        code.contains(
+            "c = c + a[..(n).max(0) as usize].iter().filter(|&&__x| __x > 0).count() as i32;"
+        ),
+        "{}",
+        code
+    );
+}
+
+/// Integer maximum uses Ord::max; float minimum keeps the C comparison for NaN
+#[test]
+fn test_min_max_fold() {
+    let extreme = |op, acc: &str, array: &str| {
+        counted_for(
+            len(array),
+            HirStatement::If {
+                condition: binary(op, index(array), var(acc)),
+                then_block: vec![HirStatement::Assignment {
+                    target: acc.to_string(),
+                    value: index(array),
+                }],
+                else_block: None,
+            },
+        )
+    };
+    let code = generate(
+        vec![("a", slice(HirType::Int)), ("f", slice(HirType::Float))],
+        vec![
+            declare("m", HirType::Int, int(0)),
+            declare("lo", HirType::Float, HirExpression::FloatLiteral("0.0".to_string())),
+            extreme(BinaryOperator::GreaterThan, "m", "a"),
+            extreme(BinaryOperator::LessThan, "lo", "f"),
+        ],
+    );
+
+    assert!(
+        code.contains("m = a.iter().copied().fold(m, |__m, __v| __m.max(__v));"),
+        "{}",
+        code
+    );
+    assert!(
+        code.contains(
+            "lo = f.iter().copied().fold(lo, |__m, __v| if __v < __m { __v } else { __m });"
+        ),
+        "{}",
+        code
+    );
+}
+
+/// An accumulator that is also the bound, or a wider body, keeps the loop
+#[test]
+fn test_non_reductions_keep_loop() {
+    let code = generate(
+        vec![("a", slice(HirType::Int)), ("n", HirType::Int)],
+        vec![counted_for(var("n"), accumulate("n", index("a")))],
+    );
+    assert!(!code.contains(".sum::<"), "{}", code);
+
+    let code = generate(
+        vec![("a", slice(HirType::Int)), ("b", slice(HirType::Double))],
+        vec![
+            declare("s", HirType::Int, int(0)),
+            counted_for(len("b"), accumulate("s", index("b"))),
+        ],
+    );
+    assert!(!code.contains(".sum::<"), "mixed types stay a loop:\n{}", code);
+}
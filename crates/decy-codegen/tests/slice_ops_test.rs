@@ -0,0 +1,205 @@
+//! Tests for string.h memory calls lowered to slice operations.
+//!
+//! Reference: K&R §B3, ISO C99 §7.21
+//!
+//! When the operands are known arrays, Vecs or slices, `memcpy`, `memmove`,
+//! `memset` and `memcmp` become `copy_from_slice`, `copy_within`, `fill` and
+//! slice comparison, NUL scans use `CStr::from_bytes_until_nul` and character
+//! searches use `iter().position`, instead of element-by-element loops or raw
+//! calls.
+
+use decy_codegen::CodeGenerator;
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirExpression {
+    HirExpression::FunctionCall { function: function.to_string(), arguments }
+}
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn int(value: i32) -> HirExpression {
+    HirExpression::IntLiteral(value)
+}
+
+fn array(name: &str, element: HirType, size: usize) -> HirStatement {
+    HirStatement::VariableDeclaration {
+        name: name.to_string(),
+        var_type: HirType::Array { element_type: Box::new(element), size: Some(size) },
+        initializer: None,
+    }
+}
+
+fn generate(body: Vec<HirStatement>) -> String {
+    let func = HirFunction::new_with_body("buffers".to_string(), HirType::Void, vec![], body);
+    CodeGenerator::new().generate_function(&func)
+}
+
+/// memcpy(dst, src, 64) between byte arrays → copy_from_slice
+#[test]
+fn test_memcpy_between_arrays_uses_copy_from_slice() {
+    let code = generate(vec![
+        array("src", HirType::Char, 64),
+        array("dst", HirType::Char, 64),
+        HirStatement::Expression(call("memcpy", vec![var("dst"), var("src"), int(64)])),
+    ]);
+
+    assert!(code.contains("let __n = (64) as usize;"), "{}", code);
+    assert!(code.contains("dst[..__n].copy_from_slice(&src[..__n]);"), "{}", code);
+    assert!(!code.contains("memcpy("), "{}", code);
+}
+
+/// Byte counts over wider elements are converted to element counts
+#[test]
+fn test_memcpy_int_arrays_scales_by_element_size() {
+    let code = generate(vec![
+        array("a", HirType::Int, 16),
+        array("b", HirType::Int, 16),
+        HirStatement::Expression(call("memcpy", vec![var("b"), var("a"), int(64)])),
+    ]);
+
+    assert!(code.contains("(64) as usize / std::mem::size_of::<i32>()"), "{}", code);
+    assert!(code.contains("b[..__n].copy_from_slice(&a[..__n]);"), "{}", code);
+}
+
+/// memmove within one buffer → copy_within, which allows overlap
+#[test]
+fn test_memmove_same_buffer_uses_copy_within() {
+    let code = generate(vec![
+        array("buf", HirType::Char, 32),
+        HirStatement::Expression(call(
+            "memmove",
+            vec![
+                HirExpression::BinaryOp {
+                    op: BinaryOperator::Add,
+                    left: Box::new(var("buf")),
+                    right: Box::new(int(1)),
+                },
+                var("buf"),
+                int(31),
+            ],
+        )),
+    ]);
+
+    assert!(code.contains("buf.copy_within(0..0 + __n, (1) as usize);"), "{}", code);
+}
+
+/// memset on bytes → fill; zeroing an int array → fill(0); other patterns stay calls
+#[test]
+fn test_memset_uses_fill() {
+    let code = generate(vec![
+        array("bytes", HirType::Char, 16),
+        array("ints", HirType::Int, 4),
+        array("floats", HirType::Double, 4),
+        HirStatement::Expression(call("memset", vec![var("bytes"), int(32), int(16)])),
+        HirStatement::Expression(call("memset", vec![var("ints"), int(0), int(16)])),
+        HirStatement::Expression(call("memset", vec![var("floats"), int(255), int(32)])),
+    ]);
+
+    assert!(code.contains("bytes[..__n].fill((32) as u8);"), "{}", code);
+    assert!(code.contains("ints[..__n].fill(0);"), "{}", code);
+    assert!(code.contains("memset(floats, 255, 32)"), "{}", code);
+}
+
+/// memcmp on byte arrays → slice comparison mapped to -1/0/1
+#[test]
+fn test_memcmp_compares_slices() {
+    let code = generate(vec![
+        array("a", HirType::Char, 8),
+        array("b", HirType::Char, 8),
+        HirStatement::VariableDeclaration {
+            name: "r".to_string(),
+            var_type: HirType::Int,
+            initializer: Some(call("memcmp", vec![var("a"), var("b"), int(8)])),
+        },
+    ]);
+
+    assert!(code.contains("a[..__n].cmp(&b[..__n]) as i32"), "{}", code);
+}
+
+/// strlen/strchr on a char array scan the slice instead of looping
+#[test]
+fn test_byte_scans_scan_slices() {
+    let code = generate(vec![
+        array("name", HirType::Char, 32),
+        HirStatement::VariableDeclaration {
+            name: "n".to_string(),
+            var_type: HirType::Int,
+            initializer: Some(call("strlen", vec![var("name")])),
+        },
+        HirStatement::Expression(call(
+            "strchr",
+            vec![var("name"), HirExpression::CharLiteral(b'=' as i8)],
+        )),
+    ]);
+
+    assert!(
+        code.contains("let __s = &name[..]; std::ffi::CStr::from_bytes_until_nul(__s)"),
+        "{}",
+        code
+    );
+    assert!(code.contains("__s[..__len].iter().position(|&b| b =="), "{}", code);
+    assert!(!code.contains("strchr("), "{}", code);
+}
+
+/// Operands that are not known buffers keep the plain call
+#[test]
+fn test_unknown_operands_keep_call() {
+    let code = generate(vec![HirStatement::Expression(call(
+        "memcpy",
+        vec![var("dst"), var("src"), int(8)],
+    ))]);
+
+    assert!(code.contains("memcpy(dst, src, 8)"), "{}", code);
+}
+
+/// char *nl = strchr(line, '\n'); if (nl) *nl = 0;
+/// The pointer found is written through, so it comes from a `&mut` borrow
+#[test]
+fn test_strchr_result_can_be_written_through() {
+    let code = generate(vec![
+        array("line", HirType::Char, 64),
+        HirStatement::VariableDeclaration {
+            name: "nl".to_string(),
+            var_type: HirType::Pointer(Box::new(HirType::Char)),
+            initializer: Some(call(
+                "strchr",
+                vec![var("line"), HirExpression::CharLiteral(b'\n' as i8)],
+            )),
+        },
+        HirStatement::If {
+            condition: var("nl"),
+            then_block: vec![HirStatement::DerefAssignment { target: var("nl"), value: int(0) }],
+            else_block: None,
+        },
+    ]);
+
+    assert!(code.contains("let __s = &mut line[..];"), "{}", code);
+    assert!(code.contains("__s.as_mut_ptr().wrapping_add(i)"), "{}", code);
+    assert!(!code.contains("as_ptr()"), "{}", code);
+}
+
+/// A read-only slice cannot hand out a `*mut` into itself
+#[test]
+fn test_memchr_on_read_only_slice_keeps_call() {
+    let func = HirFunction::new_with_body(
+        "find".to_string(),
+        HirType::Void,
+        vec![HirParameter::new(
+            "data".to_string(),
+            HirType::Reference {
+                inner: Box::new(HirType::Vec(Box::new(HirType::Char))),
+                mutable: false,
+            },
+        )],
+        vec![HirStatement::Expression(call(
+            "memchr",
+            vec![var("data"), HirExpression::CharLiteral(b'x' as i8), int(4)],
+        ))],
+    );
+    let code = CodeGenerator::new().generate_function(&func);
+
+    assert!(code.contains("memchr(data,"), "{}", code);
+    assert!(!code.contains("as_mut_ptr"), "{}", code);
+}
@@ -0,0 +1,132 @@
+//! Tests for calls through function pointers with known targets.
+//!
+//! Reference: K&R §5.11, ISO C99 §6.5.2.2
+//!
+//! A `fn` pointer is called indirectly, so the function behind it is never
+//! inlined. A function-pointer parameter that is only called or passed on
+//! becomes `impl Fn`, which rustc monomorphises for each function passed. A
+//! function-pointer local holding known functions is replaced by a direct
+//! call, or by a `match` over an enum of the functions it may hold.
+
+use decy_analyzer::dispatch_analysis::{PointerTargets, StaticDispatch};
+use decy_codegen::CodeGenerator;
+use decy_hir::{HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+use decy_ownership::lifetime_gen::LifetimeAnnotator;
+use std::collections::HashMap;
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirExpression {
+    HirExpression::FunctionCall { function: function.to_string(), arguments }
+}
+
+/// int (*)(int, int)
+fn binop() -> HirType {
+    HirType::FunctionPointer {
+        param_types: vec![HirType::Int, HirType::Int],
+        return_type: Box::new(HirType::Int),
+    }
+}
+
+fn generate(codegen: &CodeGenerator, func: &HirFunction) -> String {
+    let sig = LifetimeAnnotator::new().annotate_function(func);
+    let functions = vec![
+        ("add".to_string(), vec![HirType::Int, HirType::Int]),
+        ("mul".to_string(), vec![HirType::Int, HirType::Int]),
+    ];
+    codegen.generate_function_with_lifetimes_and_structs(func, &sig, &[], &functions, &[], &[], &[])
+}
+
+/// int apply(int (*op)(int, int), int x) { return op(x, x); }
+fn apply() -> HirFunction {
+    HirFunction::new_with_body(
+        "apply".to_string(),
+        HirType::Int,
+        vec![
+            HirParameter::new("op".to_string(), binop()),
+            HirParameter::new("x".to_string(), HirType::Int),
+        ],
+        vec![HirStatement::Return(Some(call("op", vec![var("x"), var("x")])))],
+    )
+}
+
+/// int run(int x) { int (*step)(int, int) = add; body return step(x, x); }
+fn run(body: Vec<HirStatement>) -> HirFunction {
+    let mut stmts = vec![HirStatement::VariableDeclaration {
+        name: "step".to_string(),
+        var_type: binop(),
+        initializer: Some(var("add")),
+    }];
+    stmts.extend(body);
+    stmts.push(HirStatement::Return(Some(call("step", vec![var("x"), var("x")]))));
+    HirFunction::new_with_body(
+        "run".to_string(),
+        HirType::Int,
+        vec![HirParameter::new("x".to_string(), HirType::Int)],
+        stmts,
+    )
+}
+
+fn with_targets(targets: &[&str]) -> CodeGenerator {
+    let local = PointerTargets {
+        name: "step".to_string(),
+        targets: targets.iter().map(|t| t.to_string()).collect(),
+    };
+    CodeGenerator::new().with_static_dispatch(StaticDispatch {
+        params: HashMap::new(),
+        locals: HashMap::from([("run".to_string(), vec![local])]),
+    })
+}
+
+/// C: int (*op)(int, int), only called
+/// Rust: impl Fn(i32, i32) -> i32 + Copy, monomorphised per caller
+#[test]
+fn test_dispatched_param_is_impl_fn() {
+    let codegen = CodeGenerator::new().with_static_dispatch(StaticDispatch {
+        params: HashMap::from([("apply".to_string(), vec![(0, "op".to_string())])]),
+        locals: HashMap::new(),
+    });
+    let code = generate(&codegen, &apply());
+
+    assert!(code.contains("op: impl Fn(i32, i32) -> i32 + Copy"), "{}", code);
+    assert!(code.contains("op(x, x)"), "{}", code);
+    assert!(!code.contains("fn(i32, i32) -> i32"), "{}", code);
+}
+
+/// Without static dispatch the `fn` pointer type is kept
+#[test]
+fn test_plain_fn_pointer_param_is_kept() {
+    let code = generate(&CodeGenerator::new(), &apply());
+
+    assert!(code.contains("op: fn(i32, i32) -> i32"), "{}", code);
+}
+
+/// C: step = add; ... step = mul; ... step(x, x)
+/// Rust: an enum of add and mul, matched on at the call
+#[test]
+fn test_local_with_several_targets_matches_on_enum() {
+    let assign = HirStatement::Assignment { target: "step".to_string(), value: var("mul") };
+    let code = generate(&with_targets(&["add", "mul"]), &run(vec![assign]));
+
+    assert!(code.contains("enum StepTarget { Add, Mul }"), "{}", code);
+    assert!(code.contains("let mut step: StepTarget = StepTarget::Add;"), "{}", code);
+    assert!(code.contains("step = StepTarget::Mul;"), "{}", code);
+    assert!(
+        code.contains("match step { StepTarget::Add => add(x, x), StepTarget::Mul => mul(x, x) }"),
+        "{}",
+        code
+    );
+}
+
+/// C: int (*step)(int, int) = add; return step(x, x);
+/// Rust: add(x, x), with no pointer left
+#[test]
+fn test_local_with_one_target_is_called_directly() {
+    let code = generate(&with_targets(&["add"]), &run(vec![]));
+
+    assert!(code.contains("return add(x, x);"), "{}", code);
+    assert!(!code.contains("let mut step"), "{}", code);
+    assert!(!code.contains("match"), "{}", code);
+}
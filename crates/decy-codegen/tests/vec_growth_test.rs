@@ -0,0 +1,267 @@
+//! Tests for heap buffers lowered onto Vec growth and reuse.
+//!
+//! Reference: K&R §8.7, ISO C99 §7.20.3
+//!
+//! Dynamic arrays grown with `if (len == cap) { ... p = realloc(...); }
+//! p[len++] = x;` become `Vec::push`, loop-body `malloc`/`free` pairs become
+//! one Vec declared before the loop and refilled each iteration, and
+//! `calloc` becomes a zeroed `vec!`.
+
+use decy_codegen::CodeGenerator;
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn int(value: i32) -> HirExpression {
+    HirExpression::IntLiteral(value)
+}
+
+fn binary(op: BinaryOperator, left: HirExpression, right: HirExpression) -> HirExpression {
+    HirExpression::BinaryOp { op, left: Box::new(left), right: Box::new(right) }
+}
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirExpression {
+    HirExpression::FunctionCall { function: function.to_string(), arguments }
+}
+
+fn int_ptr() -> HirType {
+    HirType::Pointer(Box::new(HirType::Int))
+}
+
+/// `count * sizeof(int)`
+fn ints(count: HirExpression) -> HirExpression {
+    binary(BinaryOperator::Multiply, count, HirExpression::Sizeof { type_name: "int".to_string() })
+}
+
+/// `count * sizeof *p`, which the parser leaves as `count * *p`
+fn elements(count: HirExpression) -> HirExpression {
+    binary(BinaryOperator::Multiply, count, HirExpression::Dereference(Box::new(var("p"))))
+}
+
+fn declare(name: &str, var_type: HirType, initializer: HirExpression) -> HirStatement {
+    HirStatement::VariableDeclaration {
+        name: name.to_string(),
+        var_type,
+        initializer: Some(initializer),
+    }
+}
+
+fn assign(target: &str, value: HirExpression) -> HirStatement {
+    HirStatement::Assignment { target: target.to_string(), value }
+}
+
+fn free(name: &str) -> HirStatement {
+    HirStatement::Expression(call("free", vec![var(name)]))
+}
+
+/// `if (len <op> cap) { cap = cap * 2; p = realloc(p, cap * sizeof(int)); }`
+fn grow(op: BinaryOperator) -> HirStatement {
+    grow_by(op, ints)
+}
+
+/// `if (len <op> cap) { cap = cap * 2; p = realloc(p, size(cap)); }`
+fn grow_by(op: BinaryOperator, size: fn(HirExpression) -> HirExpression) -> HirStatement {
+    HirStatement::If {
+        condition: binary(op, var("len"), var("cap")),
+        then_block: vec![
+            assign("cap", binary(BinaryOperator::Multiply, var("cap"), int(2))),
+            assign("p", call("realloc", vec![var("p"), size(var("cap"))])),
+        ],
+        else_block: None,
+    }
+}
+
+/// `for (int i = 0; i < n; i++) body`
+fn for_each(body: Vec<HirStatement>) -> HirStatement {
+    HirStatement::For {
+        init: vec![declare("i", HirType::Int, int(0))],
+        condition: Some(binary(BinaryOperator::LessThan, var("i"), var("n"))),
+        increment: vec![assign("i", binary(BinaryOperator::Add, var("i"), int(1)))],
+        body,
+    }
+}
+
+fn generate(body: Vec<HirStatement>) -> String {
+    let func = HirFunction::new_with_body(
+        "kernel".to_string(),
+        HirType::Int,
+        vec![HirParameter::new("n".to_string(), HirType::Int)],
+        body,
+    );
+    CodeGenerator::new().generate_function(&func)
+}
+
+/// Append loop: grow when full, then `p[len++] = i * i;`
+fn append_loop(start: HirExpression, append: Vec<HirStatement>) -> Vec<HirStatement> {
+    vec![
+        declare("len", HirType::Int, int(0)),
+        declare("cap", HirType::Int, int(4)),
+        declare("p", int_ptr(), start),
+        for_each([vec![grow(BinaryOperator::Equal)], append].concat()),
+        declare(
+            "last",
+            HirType::Int,
+            HirExpression::ArrayIndex {
+                array: Box::new(var("p")),
+                index: Box::new(binary(BinaryOperator::Subtract, var("len"), int(1))),
+            },
+        ),
+        free("p"),
+        HirStatement::Return(Some(var("last"))),
+    ]
+}
+
+fn post_increment_append() -> Vec<HirStatement> {
+    vec![HirStatement::ArrayIndexAssignment {
+        array: Box::new(var("p")),
+        index: Box::new(HirExpression::PostIncrement { operand: Box::new(var("len")) }),
+        value: binary(BinaryOperator::Multiply, var("i"), var("i")),
+    }]
+}
+
+/// C: if (len == cap) { cap *= 2; p = realloc(p, cap * sizeof(int)); } p[len++] = x;
+/// Rust: p.push(x); len += 1;
+#[test]
+fn test_growth_loop_uses_vec_push() {
+    let code =
+        generate(append_loop(call("malloc", vec![ints(var("cap"))]), post_increment_append()));
+
+    assert!(code.contains("let mut p: Vec<i32> = Vec::with_capacity((cap) as usize);"), "{}", code);
+    assert!(code.contains("p.push(i * i); len += 1;"), "{}", code);
+    assert!(code.contains("// 'p' grows in Vec::push"), "{}", code);
+    assert!(!code.contains("realloc"), "{}", code);
+    assert!(!code.contains("if len == cap"), "unread capacity checks are dropped:\n{}", code);
+}
+
+/// C: p = malloc(cap * sizeof *p); ... p = realloc(p, cap * sizeof *p);
+#[test]
+fn test_growth_sized_by_dereference_uses_vec_push() {
+    let mut body = append_loop(call("malloc", vec![elements(var("cap"))]), post_increment_append());
+    let HirStatement::For { body: loop_body, .. } = &mut body[3] else {
+        panic!("append loop is a for loop");
+    };
+    loop_body[0] = grow_by(BinaryOperator::Equal, elements);
+    let code = generate(body);
+
+    assert!(code.contains("let mut p: Vec<i32> = Vec::with_capacity((cap) as usize);"), "{}", code);
+    assert!(code.contains("p.push(i * i); len += 1;"), "{}", code);
+    assert!(!code.contains("realloc"), "{}", code);
+}
+
+/// `p[len] = x; len = len + 1;` from a NULL start; a capacity read elsewhere
+/// keeps its check
+#[test]
+fn test_growth_from_null_keeps_read_capacity() {
+    let append = vec![
+        HirStatement::ArrayIndexAssignment {
+            array: Box::new(var("p")),
+            index: Box::new(var("len")),
+            value: var("i"),
+        },
+        assign("len", binary(BinaryOperator::Add, var("len"), int(1))),
+    ];
+    let mut body = append_loop(HirExpression::NullLiteral, append);
+    body.insert(6, assign("last", binary(BinaryOperator::Add, var("last"), var("cap"))));
+    let code = generate(body);
+
+    assert!(code.contains("let mut p: Vec<i32> = Vec::new();"), "{}", code);
+    assert!(code.contains("p.push(i);"), "{}", code);
+    assert!(code.contains("if len == cap {"), "{}", code);
+    assert!(code.contains("// 'p' grows in Vec::push"), "{}", code);
+    assert!(!code.contains("realloc"), "{}", code);
+}
+
+/// A trailing write at `len` without an increment would desynchronise the
+/// Vec length, so the buffer keeps the realloc lowering
+#[test]
+fn test_unpaired_write_at_len_keeps_realloc() {
+    let mut body = append_loop(call("malloc", vec![ints(var("cap"))]), post_increment_append());
+    body.insert(
+        4,
+        HirStatement::ArrayIndexAssignment {
+            array: Box::new(var("p")),
+            index: Box::new(var("len")),
+            value: int(0),
+        },
+    );
+    let code = generate(body);
+
+    assert!(!code.contains(".push("), "{}", code);
+    assert!(code.contains("realloc("), "{}", code);
+}
+
+/// C: for (...) { int *tmp = malloc(n * sizeof(int)); ...; free(tmp); }
+/// Rust: one Vec before the loop, cleared and resized each iteration
+#[test]
+fn test_loop_body_allocation_is_hoisted() {
+    let code = generate(vec![
+        declare("s", HirType::Int, int(0)),
+        for_each(vec![
+            declare("tmp", int_ptr(), call("malloc", vec![ints(var("n"))])),
+            HirStatement::ArrayIndexAssignment {
+                array: Box::new(var("tmp")),
+                index: Box::new(var("i")),
+                value: var("i"),
+            },
+            assign(
+                "s",
+                binary(
+                    BinaryOperator::Add,
+                    var("s"),
+                    HirExpression::ArrayIndex {
+                        array: Box::new(var("tmp")),
+                        index: Box::new(var("i")),
+                    },
+                ),
+            ),
+            free("tmp"),
+        ]),
+        HirStatement::Return(Some(var("s"))),
+    ]);
+
+    assert!(code.contains("let mut tmp: Vec<i32> = Vec::new();"), "{}", code);
+    assert!(code.contains("tmp.clear(); tmp.resize((n) as usize, 0i32);"), "{}", code);
+    assert!(code.contains("// 'tmp' is reused by the next iteration"), "{}", code);
+    assert!(!code.contains("drop(tmp)"), "{}", code);
+    assert_eq!(code.matches("let mut tmp").count(), 1, "{}", code);
+    let hoisted = code.find("let mut tmp").unwrap();
+    assert!(hoisted < code.find("for ").or(code.find("while ")).unwrap(), "{}", code);
+}
+
+/// calloc(n, sizeof(T)) is a zeroed Vec, including arrays of structs
+#[test]
+fn test_calloc_is_zeroed_vec() {
+    let code = generate(vec![
+        declare(
+            "a",
+            int_ptr(),
+            call(
+                "calloc",
+                vec![
+                    binary(BinaryOperator::Add, var("n"), int(1)),
+                    HirExpression::Sizeof { type_name: "int".to_string() },
+                ],
+            ),
+        ),
+        HirStatement::Return(Some(HirExpression::ArrayIndex {
+            array: Box::new(var("a")),
+            index: Box::new(var("n")),
+        })),
+    ]);
+    assert!(code.contains("let mut a: Vec<i32> = vec![0i32; (n + 1) as usize];"), "{}", code);
+
+    let code = generate(vec![
+        declare(
+            "pts",
+            HirType::Pointer(Box::new(HirType::Struct("Point".to_string()))),
+            call(
+                "calloc",
+                vec![var("n"), HirExpression::Sizeof { type_name: "struct Point".to_string() }],
+            ),
+        ),
+        HirStatement::Return(Some(int(0))),
+    ]);
+    assert!(code.contains("let mut pts: Vec<Point> = vec!["), "{}", code);
+}
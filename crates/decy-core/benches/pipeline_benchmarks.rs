@@ -4,6 +4,7 @@
 
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
 use decy_core::{transpile, transpile_with_box_transform};
+use decy_synth::{generate, SynthConfig};
 
 // ============================================================================
 // Simple Function Benchmarks
@@ -219,6 +220,54 @@ fn bench_analysis_overhead(c: &mut Criterion) {
     group.finish();
 }
 
+// ============================================================================
+// Synthetic Scaling Benchmarks
+// ============================================================================
+
+/// End-to-end transpilation of synthetic programs, one generator axis at a
+/// time, so super-linear stages show up as a bend in the curve.
+fn bench_synthetic_scaling(c: &mut Criterion) {
+    let base = SynthConfig { functions: 10, statements_per_function: 20, ..Default::default() };
+
+    let axes: Vec<(&str, Vec<(usize, SynthConfig)>)> = vec![
+        (
+            "functions",
+            [5, 10, 25, 50]
+                .iter()
+                .map(|&n| (n, SynthConfig { functions: n, ..base.clone() }))
+                .collect(),
+        ),
+        (
+            "statements",
+            [10, 25, 50, 100]
+                .iter()
+                .map(|&n| (n, SynthConfig { statements_per_function: n, ..base.clone() }))
+                .collect(),
+        ),
+        (
+            "pointer_density",
+            [0, 25, 50, 100]
+                .iter()
+                .map(|&pct| {
+                    (pct, SynthConfig { pointer_density: pct as f64 / 100.0, ..base.clone() })
+                })
+                .collect(),
+        ),
+    ];
+
+    for (axis, configs) in axes {
+        let mut group = c.benchmark_group(format!("pipeline_synthetic_{}", axis));
+        group.sample_size(10);
+        for (size, config) in configs {
+            let source = generate(&config).flattened();
+            group.bench_with_input(BenchmarkId::from_parameter(size), &source, |b, source| {
+                b.iter(|| transpile(black_box(source)))
+            });
+        }
+        group.finish();
+    }
+}
+
 criterion_group!(
     benches,
     bench_simple_functions,
@@ -227,5 +276,6 @@ criterion_group!(
     bench_box_transformation_pipeline,
     bench_realistic_code,
     bench_analysis_overhead,
+    bench_synthetic_scaling,
 );
 criterion_main!(benches);
@@ -18,20 +18,36 @@ mod generated_contracts;
 
 pub mod metrics;
 pub mod optimize;
+pub mod sidecar;
 pub mod trace;
 
+pub use decy_codegen::CodegenOptions;
 pub use metrics::{
     CompileMetrics, ConvergenceReport, EquivalenceMetrics, TierMetrics, TranspilationResult,
 };
 
 use anyhow::{Context, Result};
+use decy_analyzer::comparator_analysis::{ComparatorAnalyzer, KeyComparator};
+use decy_analyzer::dispatch_analysis::{DispatchAnalyzer, DispatchScan, StaticDispatch};
 use decy_analyzer::patterns::PatternDetector;
-use decy_codegen::CodeGenerator;
-use decy_hir::{HirExpression, HirFunction, HirStatement};
+use decy_analyzer::pool_analysis::{PoolAllocator, PoolAnalyzer, PoolKind};
+use decy_analyzer::stdio_analysis::{QuietFunctions, StdioAnalyzer};
+use decy_analyzer::void_ptr_analysis::{VoidPtrAnalyzer, VoidPtrScan};
+use decy_codegen::{CodeGenerator, ModuleStatics, StaticsScan};
+use decy_hir::visit::{walk_statements, Visitor};
+use decy_hir::{HirExpression, HirFunction, HirStatement, HirType};
 use decy_ownership::{
-    array_slice::ArrayParameterTransformer, borrow_gen::BorrowGenerator,
-    classifier_integration::classify_with_rules, dataflow::DataflowAnalyzer,
-    lifetime::LifetimeAnalyzer, lifetime_gen::LifetimeAnnotator,
+    arena::{IndexArena, IndexArenaPlan},
+    array_slice::ArrayParameterTransformer,
+    borrow_gen::BorrowGenerator,
+    classifier_integration::classify_with_summaries,
+    dataflow::DataflowAnalyzer,
+    escape::EscapeAnalyzer,
+    lifetime::LifetimeAnalyzer,
+    lifetime_gen::LifetimeAnnotator,
+    monomorphize::Monomorphization,
+    raw_pointer,
+    summary::OwnershipSummaries,
 };
 use decy_parser::parser::CParser;
 use decy_stdlib::StdlibPrototypes;
@@ -246,6 +262,88 @@ impl DependencyGraph {
         Ok(build_order)
     }
 
+    /// Direct dependencies of `path`, sorted for deterministic output.
+    pub fn dependencies_of(&self, path: &Path) -> Vec<PathBuf> {
+        let Some(&node) = self.path_to_node.get(path) else {
+            return Vec::new();
+        };
+        let mut deps: Vec<PathBuf> =
+            self.graph.neighbors(node).map(|dep| self.graph[dep].clone()).collect();
+        deps.sort();
+        deps.dedup();
+        deps
+    }
+
+    /// Group files into build waves: every file's dependencies are in an
+    /// earlier wave, so the files of one wave can be transpiled in parallel.
+    ///
+    /// Files that depend on each other circularly land in the same wave.
+    pub fn build_waves(&self) -> Vec<Vec<PathBuf>> {
+        // tarjan_scc yields SCCs in reverse topological order: dependencies first
+        let sccs = petgraph::algo::tarjan_scc(&self.graph);
+        let mut scc_of = vec![0usize; self.graph.node_count()];
+        for (i, scc) in sccs.iter().enumerate() {
+            for node in scc {
+                scc_of[node.index()] = i;
+            }
+        }
+
+        let mut depth = vec![0usize; sccs.len()];
+        let mut waves: Vec<Vec<PathBuf>> = Vec::new();
+        for (i, scc) in sccs.iter().enumerate() {
+            depth[i] = scc
+                .iter()
+                .flat_map(|&node| self.graph.neighbors(node))
+                .map(|dep| scc_of[dep.index()])
+                .filter(|&j| j != i)
+                .map(|j| depth[j] + 1)
+                .max()
+                .unwrap_or(0);
+            if waves.len() <= depth[i] {
+                waves.resize_with(depth[i] + 1, Vec::new);
+            }
+            waves[depth[i]].extend(scc.iter().map(|&node| self.graph[node].clone()));
+        }
+        for wave in &mut waves {
+            wave.sort();
+        }
+        waves
+    }
+
+    /// Build a dependency graph between translation units.
+    ///
+    /// `a.c` depends on `b.c` when it includes a header named `b.h` (in any
+    /// directory) and `b.c` is one of `files`. This is the edge along which
+    /// ownership sidecars flow in project builds.
+    pub fn from_translation_units(files: &[PathBuf]) -> Result<Self> {
+        let mut graph = Self::new();
+        let mut by_stem: HashMap<String, Vec<&PathBuf>> = HashMap::new();
+        for file in files {
+            graph.add_file(file);
+            if let Some(stem) = file.file_stem().and_then(|s| s.to_str()) {
+                by_stem.entry(stem.to_string()).or_default().push(file);
+            }
+        }
+
+        for file in files {
+            let content = std::fs::read_to_string(file)
+                .with_context(|| format!("Failed to read file: {}", file.display()))?;
+
+            for include in Self::parse_include_directives(&content) {
+                let Some(stem) = Path::new(&include).file_stem().and_then(|s| s.to_str()) else {
+                    continue;
+                };
+                for &source in by_stem.get(stem).into_iter().flatten() {
+                    if source != file && !graph.has_dependency(file, source) {
+                        graph.add_dependency(file, source);
+                    }
+                }
+            }
+        }
+
+        Ok(graph)
+    }
+
     /// Build a dependency graph from a list of C files.
     ///
     /// Parses #include directives to build the dependency graph.
@@ -715,6 +813,33 @@ pub fn transpile(c_code: &str) -> Result<String> {
 /// # Ok::<(), anyhow::Error>(())
 /// ```
 pub fn transpile_with_trace(c_code: &str) -> Result<(String, trace::TraceCollector)> {
+    transpile_with_trace_and_options(c_code, None, &CodegenOptions::default())
+}
+
+/// Transpile C code with decision tracing and opt-in code generation modes.
+///
+/// Same as [`transpile_with_trace`], resolving `#include`s against
+/// `base_dir` and configuring the code generator with `options`. The trace
+/// also reports every hand-rolled pool allocator of the unit and whether it
+/// was replaced by an index arena.
+///
+/// # Examples
+///
+/// ```no_run
+/// use decy_core::{transpile_with_trace_and_options, CodegenOptions};
+///
+/// let options = CodegenOptions { index_arenas: true, ..Default::default() };
+/// let c_code = "int add(int a, int b) { return a + b; }";
+/// let (code, trace) = transpile_with_trace_and_options(c_code, None, &options)?;
+/// assert!(code.contains("fn add"));
+/// assert!(!trace.is_empty());
+/// # Ok::<(), anyhow::Error>(())
+/// ```
+pub fn transpile_with_trace_and_options(
+    c_code: &str,
+    base_dir: Option<&Path>,
+    options: &CodegenOptions,
+) -> Result<(String, trace::TraceCollector)> {
     contract_pre_configuration!();
     use trace::{DecisionType, PipelineStage, TraceCollector, TraceEntry};
 
@@ -731,8 +856,9 @@ pub fn transpile_with_trace(c_code: &str) -> Result<(String, trace::TraceCollect
         reason: "Using clang-sys for C parsing".to_string(),
     });
 
-    // Transpile normally
-    let rust_code = transpile(c_code)?;
+    // Transpile normally, recording the pipeline's own decisions
+    let (rust_code, _sidecar) =
+        transpile_unit(c_code, base_dir, &[], options, Some(&mut collector))?;
 
     // Record completion
     collector.record(TraceEntry {
@@ -801,53 +927,85 @@ fn deduplicate_functions(all_hir_functions: Vec<HirFunction>) -> Vec<HirFunction
     funcs
 }
 
+/// Indices of the functions [`deduplicate_functions`] would keep, in the
+/// same (name) order, without converting anything to HIR.
+fn deduplicated_function_order(functions: &[decy_parser::parser::Function]) -> Vec<usize> {
+    let mut by_name: HashMap<&str, usize> = HashMap::new();
+    for (index, func) in functions.iter().enumerate() {
+        by_name
+            .entry(func.name.as_str())
+            .and_modify(|existing| {
+                if !func.body.is_empty() && functions[*existing].body.is_empty() {
+                    *existing = index;
+                }
+            })
+            .or_insert(index);
+    }
+    let mut order: Vec<(&str, usize)> = by_name.into_iter().collect();
+    order.sort_unstable();
+    order.into_iter().map(|(_, index)| index).collect()
+}
+
 fn build_slice_func_arg_mappings(
     hir_functions: &[HirFunction],
 ) -> Vec<(String, Vec<(usize, usize)>)> {
-    hir_functions
-        .iter()
-        .filter_map(|func| {
-            let mut mappings = Vec::new();
-            let params = func.parameters();
+    hir_functions.iter().filter_map(slice_func_arg_mapping).collect()
+}
 
-            for (i, param) in params.iter().enumerate() {
-                if matches!(param.param_type(), decy_hir::HirType::Pointer(_))
-                    && i + 1 < params.len()
+fn slice_func_arg_mapping(func: &HirFunction) -> Option<(String, Vec<(usize, usize)>)> {
+    let mut mappings = Vec::new();
+    let params = func.parameters();
+
+    for (i, param) in params.iter().enumerate() {
+        if matches!(param.param_type(), decy_hir::HirType::Pointer(_)) && i + 1 < params.len() {
+            let next_param = &params[i + 1];
+            if matches!(next_param.param_type(), decy_hir::HirType::Int) {
+                let param_name = next_param.name().to_lowercase();
+                if param_name.contains("len")
+                    || param_name.contains("size")
+                    || param_name.contains("count")
+                    || param_name == "n"
+                    || param_name == "num"
                 {
-                    let next_param = &params[i + 1];
-                    if matches!(next_param.param_type(), decy_hir::HirType::Int) {
-                        let param_name = next_param.name().to_lowercase();
-                        if param_name.contains("len")
-                            || param_name.contains("size")
-                            || param_name.contains("count")
-                            || param_name == "n"
-                            || param_name == "num"
-                        {
-                            mappings.push((i, i + 1));
-                        }
-                    }
+                    mappings.push((i, i + 1));
                 }
             }
+        }
+    }
 
-            if mappings.is_empty() {
-                None
-            } else {
-                Some((func.name().to_string(), mappings))
-            }
-        })
-        .collect()
+    if mappings.is_empty() {
+        None
+    } else {
+        Some((func.name().to_string(), mappings))
+    }
 }
 
 fn transform_function_with_ownership(
     func: HirFunction,
+    summaries: &OwnershipSummaries,
+    structs: &[decy_hir::HirStruct],
 ) -> (HirFunction, decy_ownership::lifetime_gen::AnnotatedSignature) {
-    let dataflow_analyzer = DataflowAnalyzer::new();
+    let dataflow_analyzer = DataflowAnalyzer::with_summaries(summaries);
     let dataflow_graph = dataflow_analyzer.analyze(&func);
 
-    let ownership_inferences = classify_with_rules(&dataflow_graph, &func);
+    // Allocations that never leave the function become stack locals
+    let (func, dataflow_graph) =
+        match EscapeAnalyzer::with_structs(structs).promote(&func, &dataflow_graph) {
+            Some(promoted) => {
+                let graph = dataflow_analyzer.analyze(&promoted);
+                (promoted, graph)
+            }
+            None => (func, dataflow_graph),
+        };
+
+    let ownership_inferences = classify_with_summaries(&dataflow_graph, &func, summaries);
 
     let borrow_generator = BorrowGenerator::new();
-    let func_with_borrows = borrow_generator.transform_function(&func, &ownership_inferences);
+    let func_with_borrows = borrow_generator.transform_function_with_dataflow(
+        &func,
+        &ownership_inferences,
+        &dataflow_graph,
+    );
 
     let array_transformer = ArrayParameterTransformer::new();
     let func_with_slices = array_transformer.transform(&func_with_borrows, &dataflow_graph);
@@ -927,7 +1085,7 @@ fn generate_initialized_global_code(
         } else {
             code_generator.generate_expression(init_expr)
         };
-    format!("static mut {}: {} = {};\n", name, type_str, init_code)
+    code_generator.generate_global_declaration(name, var_type, type_str, &init_code)
 }
 
 fn generate_uninitialized_global_code(
@@ -935,10 +1093,16 @@ fn generate_uninitialized_global_code(
     var_type: &decy_hir::HirType,
     type_str: &str,
     hir_structs: &[decy_hir::HirStruct],
+    code_generator: &CodeGenerator,
 ) -> Option<String> {
     match var_type {
         decy_hir::HirType::FunctionPointer { .. } => {
-            Some(format!("static mut {}: Option<{}> = None;\n", name, type_str))
+            Some(code_generator.generate_global_declaration(
+                name,
+                var_type,
+                &format!("Option<{}>", type_str),
+                "None",
+            ))
         }
         _ => {
             let default_value = match var_type {
@@ -971,7 +1135,12 @@ fn generate_uninitialized_global_code(
                 }
                 _ => "Default::default()".to_string(),
             };
-            Some(format!("static mut {}: {} = {};\n", name, type_str, default_value))
+            Some(code_generator.generate_global_declaration(
+                name,
+                var_type,
+                type_str,
+                &default_value,
+            ))
         }
     }
 }
@@ -999,9 +1168,13 @@ fn generate_global_variable_code(
                     hir_structs,
                     code_generator,
                 ));
-            } else if let Some(code) =
-                generate_uninitialized_global_code(name, var_type, &type_str, hir_structs)
-            {
+            } else if let Some(code) = generate_uninitialized_global_code(
+                name,
+                var_type,
+                &type_str,
+                hir_structs,
+                code_generator,
+            ) {
                 rust_code.push_str(&code);
             }
         }
@@ -1014,173 +1187,418 @@ fn generate_global_variable_code(
 
 fn build_all_function_sigs(
     transformed_functions: &[(HirFunction, decy_ownership::lifetime_gen::AnnotatedSignature)],
+    summaries: &OwnershipSummaries,
 ) -> Vec<(String, Vec<decy_hir::HirType>)> {
-    transformed_functions
+    transformed_functions.iter().map(|(func, _sig)| function_call_sig(func, summaries)).collect()
+}
+
+fn function_call_sig(
+    func: &HirFunction,
+    summaries: &OwnershipSummaries,
+) -> (String, Vec<decy_hir::HirType>) {
+    let summary = summaries.get(func.name());
+    let param_types: Vec<decy_hir::HirType> = func
+        .parameters()
         .iter()
-        .map(|(func, _sig)| {
-            let param_types: Vec<decy_hir::HirType> = func
-                .parameters()
-                .iter()
-                .map(|p| {
-                    if let decy_hir::HirType::Pointer(inner) = p.param_type() {
-                        if uses_pointer_arithmetic(func, p.name())
-                            || pointer_compared_to_null(func, p.name())
-                        {
-                            p.param_type().clone()
-                        } else {
-                            decy_hir::HirType::Reference { inner: inner.clone(), mutable: true }
-                        }
-                    } else {
-                        p.param_type().clone()
+        .map(|p| {
+            if let decy_hir::HirType::Pointer(inner) = p.param_type() {
+                let needs_raw = match summary {
+                    Some(summary) => {
+                        summary.param_named(p.name()).is_some_and(|param| param.needs_raw_pointer())
                     }
-                })
-                .collect();
-            (func.name().to_string(), param_types)
+                    None => raw_pointer::needs_raw_pointer(func, p.name()),
+                };
+                if needs_raw {
+                    p.param_type().clone()
+                } else {
+                    let mutable = !p.is_pointee_const();
+                    decy_hir::HirType::Reference { inner: inner.clone(), mutable }
+                }
+            } else {
+                p.param_type().clone()
+            }
         })
-        .collect()
+        .collect();
+    (func.name().to_string(), param_types)
 }
 
-/// Transpile C code with include directive support and custom base directory.
-///
-/// # Arguments
-///
-/// * `c_code` - C source code to transpile
-/// * `base_dir` - Base directory for resolving #include paths (None = current dir)
-///
-/// # Examples
-///
-/// ```no_run
-/// use decy_core::transpile_with_includes;
-/// use std::path::Path;
-///
-/// let c_code = "#include \"utils.h\"\nint main() { return 0; }";
-/// let rust_code = transpile_with_includes(c_code, Some(Path::new("/tmp/project")))?;
-/// # Ok::<(), anyhow::Error>(())
-/// ```
-pub fn transpile_with_includes(c_code: &str, base_dir: Option<&Path>) -> Result<String> {
-    contract_pre_configuration!();
-    // Step 0: Preprocess #include directives (DECY-056) + Inject stdlib prototypes
-    let stdlib_prototypes = StdlibPrototypes::new();
-    let mut processed_files = std::collections::HashSet::new();
-    let mut injected_headers = std::collections::HashSet::new();
-    let preprocessed = preprocess_includes(
-        c_code,
-        base_dir,
-        &mut processed_files,
-        &stdlib_prototypes,
-        &mut injected_headers,
-    )?;
+/// Module-level items of a translation unit, converted to HIR.
+struct ModuleItems {
+    structs: Vec<decy_hir::HirStruct>,
+    enums: Vec<decy_hir::HirEnum>,
+    variables: Vec<decy_hir::HirStatement>,
+    typedefs: Vec<decy_hir::HirTypedef>,
+    /// Structs whose nodes live in an index arena
+    arenas: Vec<IndexArena>,
+}
 
-    // Step 1: Parse C code
-    // Note: We don't add standard type definitions (size_t, etc.) here because:
-    // 1. If code has #include directives, system headers define them
-    // 2. If code doesn't have includes and uses size_t, it should typedef it explicitly
-    // 3. Adding conflicting typedefs breaks parsing
-    let parser = CParser::new().context("Failed to create C parser")?;
-    let ast = parser.parse(&preprocessed).context("Failed to parse C code")?;
+impl ModuleItems {
+    fn from_ast(ast: &decy_parser::Ast) -> Self {
+        // Convert structs to HIR
+        let hir_structs: Vec<decy_hir::HirStruct> = ast
+            .structs()
+            .iter()
+            .map(|s| {
+                let fields = s
+                    .fields
+                    .iter()
+                    .map(|f| {
+                        decy_hir::HirStructField::new(
+                            f.name.clone(),
+                            decy_hir::HirType::from_ast_type(&f.field_type),
+                        )
+                    })
+                    .collect();
+                decy_hir::HirStruct::new(s.name.clone(), fields)
+            })
+            .collect();
 
-    // Step 2: Convert to HIR
-    let all_hir_functions: Vec<HirFunction> =
-        ast.functions().iter().map(HirFunction::from_ast_function).collect();
+        // DECY-240: Convert enums to HIR
+        let hir_enums: Vec<decy_hir::HirEnum> = ast
+            .enums()
+            .iter()
+            .map(|e| {
+                let variants = e
+                    .variants
+                    .iter()
+                    .map(|v| {
+                        decy_hir::HirEnumVariant::new(v.name.clone(), v.value.map(|val| val as i32))
+                    })
+                    .collect();
+                decy_hir::HirEnum::new(e.name.clone(), variants)
+            })
+            .collect();
 
-    // DECY-190: Deduplicate functions - when a C file has both a declaration
-    // (prototype) and a definition, only keep the definition.
-    // This prevents "the name X is defined multiple times" errors in Rust.
-    let hir_functions = deduplicate_functions(all_hir_functions);
+        // Convert global variables to HIR (DECY-054)
+        // DECY-223: Filter out extern references (they refer to existing globals, not new definitions)
+        // Also deduplicate by name (first definition wins)
+        let mut seen_globals: std::collections::HashSet<String> = std::collections::HashSet::new();
+        let hir_variables: Vec<decy_hir::HirStatement> = ast
+            .variables()
+            .iter()
+            .filter(|v| {
+                // Skip extern declarations without initializers (they're references, not definitions)
+                // extern int max; → skip (reference)
+                // int max = 0; → keep (definition)
+                // extern int max = 0; → keep (definition with extern linkage)
+                if v.is_extern() && v.initializer().is_none() {
+                    return false;
+                }
+                // Deduplicate by name
+                if seen_globals.contains(v.name()) {
+                    return false;
+                }
+                seen_globals.insert(v.name().to_string());
+                true
+            })
+            .map(|v| decy_hir::HirStatement::VariableDeclaration {
+                name: v.name().to_string(),
+                var_type: decy_hir::HirType::from_ast_type(v.var_type()),
+                initializer: v.initializer().map(|init| {
+                    optimize::fold_initializer(HirExpression::from_ast_expression(init))
+                }),
+            })
+            .collect();
 
-    // Convert structs to HIR
-    let hir_structs: Vec<decy_hir::HirStruct> = ast
-        .structs()
-        .iter()
-        .map(|s| {
-            let fields = s
-                .fields
-                .iter()
-                .map(|f| {
-                    decy_hir::HirStructField::new(
-                        f.name.clone(),
-                        decy_hir::HirType::from_ast_type(&f.field_type),
-                    )
-                })
-                .collect();
-            decy_hir::HirStruct::new(s.name.clone(), fields)
-        })
-        .collect();
+        // Convert typedefs to HIR (DECY-054, DECY-057)
+        let hir_typedefs: Vec<decy_hir::HirTypedef> = ast
+            .typedefs()
+            .iter()
+            .map(|t| {
+                decy_hir::HirTypedef::new(
+                    t.name().to_string(),
+                    decy_hir::HirType::from_ast_type(&t.underlying_type),
+                )
+            })
+            .collect();
 
-    // DECY-240: Convert enums to HIR
-    let hir_enums: Vec<decy_hir::HirEnum> = ast
-        .enums()
-        .iter()
-        .map(|e| {
-            let variants = e
-                .variants
-                .iter()
-                .map(|v| {
-                    decy_hir::HirEnumVariant::new(v.name.clone(), v.value.map(|val| val as i32))
-                })
-                .collect();
-            decy_hir::HirEnum::new(e.name.clone(), variants)
-        })
-        .collect();
+        Self {
+            structs: hir_structs,
+            enums: hir_enums,
+            variables: hir_variables,
+            typedefs: hir_typedefs,
+            arenas: Vec::new(),
+        }
+    }
 
-    // Convert global variables to HIR (DECY-054)
-    // DECY-223: Filter out extern references (they refer to existing globals, not new definitions)
-    // Also deduplicate by name (first definition wins)
-    let mut seen_globals: std::collections::HashSet<String> = std::collections::HashSet::new();
-    let hir_variables: Vec<decy_hir::HirStatement> = ast
-        .variables()
-        .iter()
-        .filter(|v| {
-            // Skip extern declarations without initializers (they're references, not definitions)
-            // extern int max; → skip (reference)
-            // int max = 0; → keep (definition)
-            // extern int max = 0; → keep (definition with extern linkage)
-            if v.is_extern() && v.initializer().is_none() {
-                return false;
+    /// Replace links to the plan's arena structs with `u32` indices.
+    fn lower_index_arenas(&mut self, plan: &IndexArenaPlan) {
+        self.structs = self.structs.iter().map(|s| plan.lower_struct(s)).collect();
+        self.typedefs = self
+            .typedefs
+            .iter()
+            .map(|t| {
+                decy_hir::HirTypedef::new(
+                    t.name().to_string(),
+                    plan.lower_type(t.underlying_type()),
+                )
+            })
+            .collect();
+        // Globals holding the state of a replaced pool allocator go with it
+        self.variables.retain(|v| {
+            !matches!(v, HirStatement::VariableDeclaration { name, .. } if plan.replaces_global(name))
+        });
+        self.arenas = plan.arenas().to_vec();
+    }
+}
+
+/// Unit-wide rewrites and analyses that code generation depends on.
+///
+/// Shared by the batch and streaming pipelines so both emit the same code.
+#[derive(Default)]
+struct UnitAnalysis {
+    /// `void*` parameters every use of which agrees on one type
+    monomorphization: Monomorphization,
+    /// Opt-in index arenas for list and tree nodes
+    plan: Option<IndexArenaPlan>,
+    generic_callbacks: Vec<(String, Vec<(usize, String)>)>,
+    comparators: Vec<(String, KeyComparator)>,
+    dispatch: StaticDispatch,
+    quiet: QuietFunctions,
+}
+
+impl UnitAnalysis {
+    /// Analyze the functions of a unit as converted from the AST, lowering
+    /// `items` along with them. Returns the lowered functions.
+    fn analyze(
+        hir_functions: Vec<HirFunction>,
+        items: &mut ModuleItems,
+        options: &CodegenOptions,
+        trace: Option<&mut trace::TraceCollector>,
+    ) -> (Self, Vec<HirFunction>) {
+        // void* parameters every use of which agrees on one type get that type,
+        // and the callbacks they are passed to become generic in codegen
+        let instances = VoidPtrAnalyzer::new().instantiate(&hir_functions);
+        let monomorphization = Monomorphization::new(&instances);
+        let hir_functions: Vec<HirFunction> = match monomorphization.is_empty() {
+            true => hir_functions,
+            false => hir_functions.iter().map(|f| monomorphization.lower_function(f)).collect(),
+        };
+        let generic_callbacks = monomorphization.generic_callbacks(&hir_functions);
+
+        // Hand-rolled pool allocators are reported in the trace and, with index
+        // arenas, replaced by the arena of the structs they hand out
+        let pools = if options.index_arenas || trace.is_some() {
+            PoolAnalyzer::new().analyze(&items.variables, &hir_functions)
+        } else {
+            Vec::new()
+        };
+
+        // Opt-in: list and tree nodes move into per-struct index arenas before
+        // ownership analysis, so their links are plain integers from here on
+        let plan = options.index_arenas.then(|| {
+            IndexArenaPlan::plan_with_pools(
+                &items.structs,
+                &items.variables,
+                &hir_functions,
+                &pools,
+            )
+        });
+        if let Some(collector) = trace {
+            trace_pools(collector, &pools, plan.as_ref());
+        }
+        let hir_functions: Vec<HirFunction> = match &plan {
+            Some(plan) => {
+                items.lower_index_arenas(plan);
+                hir_functions
+                    .iter()
+                    .filter(|f| !plan.replaces_function(f.name()))
+                    .map(|f| plan.lower_function(f))
+                    .collect()
             }
-            // Deduplicate by name
-            if seen_globals.contains(v.name()) {
-                return false;
+            None => hir_functions,
+        };
+
+        // qsort/bsearch comparators that order by one integer key sort by it directly
+        let comparators = ComparatorAnalyzer::new().analyze(&items.structs, &hir_functions);
+
+        // Calls through function pointers whose targets the unit shows are
+        // dispatched statically
+        let dispatch = DispatchAnalyzer::new().analyze(&items.variables, &hir_functions);
+
+        // With buffered stdout, calls to functions that never reach stdio keep the buffer
+        let quiet = match options.buffered_stdout {
+            true => StdioAnalyzer::new().analyze(&hir_functions),
+            false => QuietFunctions::default(),
+        };
+
+        let analysis =
+            Self { monomorphization, plan, generic_callbacks, comparators, dispatch, quiet };
+        (analysis, hir_functions)
+    }
+
+    /// [`UnitAnalysis::analyze`] one function at a time, for streaming.
+    ///
+    /// `functions` yields the unit's functions converted from the AST
+    /// afresh on each call; every pass drops each one after reading it, so
+    /// only the tables stay alive. Index arenas and buffered stdout are not
+    /// planned here.
+    fn scan<I: Iterator<Item = HirFunction>>(
+        functions: impl Fn() -> I,
+        items: &ModuleItems,
+    ) -> Self {
+        let mut instances = VoidPtrScan::new(functions());
+        functions().for_each(|f| instances.observe(&f));
+        let monomorphization = Monomorphization::new(&instances.finish());
+
+        let mut generic_callbacks = Vec::new();
+        let mut comparators = Vec::new();
+        let mut dispatch = DispatchScan::new(&items.variables);
+        for func in functions() {
+            let func = match monomorphization.is_empty() {
+                true => func,
+                false => monomorphization.lower_function(&func),
+            };
+            generic_callbacks
+                .extend(monomorphization.generic_callbacks(std::slice::from_ref(&func)));
+            if let Some(comparator) = ComparatorAnalyzer::new().recognize(&items.structs, &func) {
+                comparators.push((func.name().to_string(), comparator));
             }
-            seen_globals.insert(v.name().to_string());
-            true
-        })
-        .map(|v| decy_hir::HirStatement::VariableDeclaration {
-            name: v.name().to_string(),
-            var_type: decy_hir::HirType::from_ast_type(v.var_type()),
-            initializer: v.initializer().map(decy_hir::HirExpression::from_ast_expression),
-        })
-        .collect();
+            dispatch.observe(&func);
+        }
+        Self {
+            monomorphization,
+            plan: None,
+            generic_callbacks,
+            comparators,
+            dispatch: dispatch.finish(),
+            quiet: QuietFunctions::default(),
+        }
+    }
 
-    // Convert typedefs to HIR (DECY-054, DECY-057)
-    let hir_typedefs: Vec<decy_hir::HirTypedef> = ast
-        .typedefs()
-        .iter()
-        .map(|t| {
-            decy_hir::HirTypedef::new(
-                t.name().to_string(),
-                decy_hir::HirType::from_ast_type(&t.underlying_type),
-            )
-        })
-        .collect();
+    /// Whether the analyses may find anything in `func`. When they find
+    /// nothing in any function of a unit, streaming skips their passes.
+    fn applies_to(func: &HirFunction, options: &CodegenOptions) -> bool {
+        let is_indirect = |ty: &HirType| match ty {
+            HirType::FunctionPointer { .. } => true,
+            HirType::Pointer(inner) => **inner == HirType::Void,
+            _ => false,
+        };
+        let mut scan = IndirectionScan { found: false };
+        walk_statements(&mut scan, func.body());
+        options.index_arenas
+            || options.buffered_stdout
+            || func.parameters().iter().any(|p| is_indirect(p.param_type()))
+            || scan.found
+    }
 
-    // DECY-116: Build slice function arg mappings BEFORE transformation (while we still have original params)
-    let slice_func_args = build_slice_func_arg_mappings(&hir_functions);
+    /// Apply the unit-wide rewrites to one function converted from the AST,
+    /// or `None` when an index arena replaces it.
+    fn lower(&self, func: HirFunction) -> Option<HirFunction> {
+        let func = match self.monomorphization.is_empty() {
+            true => func,
+            false => self.monomorphization.lower_function(&func),
+        };
+        match &self.plan {
+            Some(plan) if plan.replaces_function(func.name()) => None,
+            Some(plan) => Some(plan.lower_function(&func)),
+            None => Some(func),
+        }
+    }
 
-    // Step 3: Analyze ownership and lifetimes
-    let transformed_functions: Vec<_> =
-        hir_functions.into_iter().map(transform_function_with_ownership).collect();
+    /// A code generator for the unit, with the storage chosen for its globals.
+    fn code_generator(&self, options: &CodegenOptions, statics: ModuleStatics) -> CodeGenerator {
+        CodeGenerator::with_options(options.clone())
+            .with_module_statics(statics)
+            .with_generic_callbacks(self.generic_callbacks.clone())
+            .with_comparators(self.comparators.clone())
+            .with_static_dispatch(self.dispatch.clone())
+            .with_quiet_functions(self.quiet.clone())
+    }
+}
 
-    // Step 4: Generate Rust code with lifetime annotations
-    let code_generator = CodeGenerator::new();
-    let mut rust_code = String::new();
+/// Finds function-pointer locals and `qsort`/`bsearch` calls.
+struct IndirectionScan {
+    found: bool,
+}
 
+impl Visitor for IndirectionScan {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        self.found |= matches!(
+            stmt,
+            HirStatement::VariableDeclaration { var_type: HirType::FunctionPointer { .. }, .. }
+        );
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        self.found |= matches!(
+            expr,
+            HirExpression::FunctionCall { function, .. } if function == "qsort" || function == "bsearch"
+        );
+    }
+}
+
+/// Record each pool allocator of a unit and what it was lowered to.
+fn trace_pools(
+    collector: &mut trace::TraceCollector,
+    pools: &[PoolAllocator],
+    plan: Option<&IndexArenaPlan>,
+) {
+    use trace::{DecisionType, PipelineStage, TraceEntry};
+
+    for pool in pools {
+        let kind = match pool.kind {
+            PoolKind::Bump => "bump pool",
+            PoolKind::FreeList => "free list",
+        };
+        let objects = pool.object_types.join("`, `");
+        let arenas: Vec<String> = pool.object_types.iter().map(|t| format!("{}Arena", t)).collect();
+        let (chosen, alternatives, reason) = match plan {
+            Some(plan) if plan.replaces_function(&pool.alloc) => (
+                arenas.join(", "),
+                vec!["raw pointers".to_string()],
+                format!(
+                    "{} of `{}` replaced by an index arena: alloc and free stay O(1), \
+                     pointers become u32 indices and the pool state is dropped",
+                    kind, objects
+                ),
+            ),
+            Some(_) => (
+                "raw pointers".to_string(),
+                arenas,
+                format!(
+                    "{} of `{}` kept: a struct it hands out is used in a way index arenas \
+                     cannot express",
+                    kind, objects
+                ),
+            ),
+            None => (
+                "raw pointers".to_string(),
+                arenas,
+                format!(
+                    "{} of `{}` recognised; transpile with --index-arenas to replace it \
+                     with a typed arena",
+                    kind, objects
+                ),
+            ),
+        };
+        collector.record(TraceEntry {
+            stage: PipelineStage::OwnershipInference,
+            source_location: Some(format!("function `{}`", pool.alloc)),
+            decision_type: DecisionType::PatternDetection,
+            chosen,
+            alternatives,
+            confidence: 1.0,
+            reason,
+        });
+    }
+}
+
+/// Emit every module-level definition ahead of the functions.
+///
+/// Returns the names and types of the global variables.
+fn generate_module_items(
+    ast: &decy_parser::Ast,
+    items: &ModuleItems,
+    code_generator: &CodeGenerator,
+    rust_code: &mut String,
+) -> Vec<(String, decy_hir::HirType)> {
     // DECY-119: Track emitted definitions to avoid duplicates
     let mut emitted_structs = std::collections::HashSet::new();
     let mut emitted_typedefs = std::collections::HashSet::new();
 
     // Generate struct definitions first (deduplicated)
-    for hir_struct in &hir_structs {
+    for hir_struct in &items.structs {
         let struct_name = hir_struct.name();
         if emitted_structs.contains(struct_name) {
             continue; // Skip duplicate
@@ -1190,10 +1608,13 @@ pub fn transpile_with_includes(c_code: &str, base_dir: Option<&Path>) -> Result<
         let struct_code = code_generator.generate_struct(hir_struct);
         rust_code.push_str(&struct_code);
         rust_code.push('\n');
+        if let Some(arena) = items.arenas.iter().find(|a| a.struct_name == struct_name) {
+            rust_code.push_str(&code_generator.generate_index_arena(hir_struct, arena.capacity));
+        }
     }
 
     // DECY-240: Generate enum definitions (as const i32 values)
-    for hir_enum in &hir_enums {
+    for hir_enum in &items.enums {
         let enum_code = code_generator.generate_enum(hir_enum);
         rust_code.push_str(&enum_code);
         rust_code.push('\n');
@@ -1219,11 +1640,13 @@ pub fn transpile_with_includes(c_code: &str, base_dir: Option<&Path>) -> Result<
         rust_code.push('\n');
     }
 
-    // DECY-241: Add errno global variable (C compatibility)
-    rust_code.push_str("static mut ERRNO: i32 = 0;\n");
+    // DECY-241: Add errno (C compatibility) when the program uses it
+    if let Some(errno) = code_generator.generate_errno_declaration() {
+        rust_code.push_str(errno);
+    }
 
     // Generate typedefs (DECY-054, DECY-057) - deduplicated
-    for typedef in &hir_typedefs {
+    for typedef in &items.typedefs {
         let typedef_name = typedef.name();
         if emitted_typedefs.contains(typedef_name) {
             continue; // Skip duplicate
@@ -1237,18 +1660,312 @@ pub fn transpile_with_includes(c_code: &str, base_dir: Option<&Path>) -> Result<
     }
 
     // Generate global variables and collect their names/types
-    let global_vars = generate_global_variable_code(
-        &hir_variables,
-        &hir_structs,
-        &code_generator,
-        &mut rust_code,
+    generate_global_variable_code(&items.variables, &items.structs, code_generator, rust_code)
+}
+
+/// Transpile C code with include directive support and custom base directory.
+///
+/// # Arguments
+///
+/// * `c_code` - C source code to transpile
+/// * `base_dir` - Base directory for resolving #include paths (None = current dir)
+///
+/// # Examples
+///
+/// ```no_run
+/// use decy_core::transpile_with_includes;
+/// use std::path::Path;
+///
+/// let c_code = "#include \"utils.h\"\nint main() { return 0; }";
+/// let rust_code = transpile_with_includes(c_code, Some(Path::new("/tmp/project")))?;
+/// # Ok::<(), anyhow::Error>(())
+/// ```
+pub fn transpile_with_includes(c_code: &str, base_dir: Option<&Path>) -> Result<String> {
+    contract_pre_configuration!();
+    transpile_unit(c_code, base_dir, &[], &CodegenOptions::default(), None)
+        .map(|(rust_code, _sidecar)| rust_code)
+}
+
+/// Transpile C code with opt-in code generation modes.
+///
+/// Same pipeline as [`transpile_with_includes`], with the code generator
+/// configured by `options` (for example buffered stdout).
+///
+/// # Examples
+///
+/// ```no_run
+/// use decy_core::{transpile_with_options, CodegenOptions};
+///
+/// let options = CodegenOptions { buffered_stdout: true, ..Default::default() };
+/// let c_code = "#include <stdio.h>\nint main() { printf(\"hi\\n\"); return 0; }";
+/// let rust_code = transpile_with_options(c_code, None, &options)?;
+/// assert!(rust_code.contains("__stdout"));
+/// # Ok::<(), anyhow::Error>(())
+/// ```
+pub fn transpile_with_options(
+    c_code: &str,
+    base_dir: Option<&Path>,
+    options: &CodegenOptions,
+) -> Result<String> {
+    contract_pre_configuration!();
+    transpile_unit(c_code, base_dir, &[], options, None).map(|(rust_code, _sidecar)| rust_code)
+}
+
+/// Transpile one translation unit against the sidecars of the units it calls into.
+///
+/// Calls to functions defined in another translation unit use the imported
+/// call-site signatures, ownership summaries, slice and string-iteration
+/// mappings instead of what can be guessed from a local prototype. Returns
+/// the generated Rust code and the sidecar describing this unit's exports.
+///
+/// # Examples
+///
+/// ```no_run
+/// use decy_core::transpile_with_sidecars;
+///
+/// let (_b_rust, b_meta) = transpile_with_sidecars("void clear(int* p) { *p = 0; }", None, &[])?;
+/// let a_code = "void clear(int* p);\nvoid reset(int* x) { clear(x); }";
+/// let (a_rust, _a_meta) = transpile_with_sidecars(a_code, None, &[b_meta])?;
+/// assert!(a_rust.contains("fn reset"));
+/// # Ok::<(), anyhow::Error>(())
+/// ```
+pub fn transpile_with_sidecars(
+    c_code: &str,
+    base_dir: Option<&Path>,
+    imports: &[sidecar::SignatureSidecar],
+) -> Result<(String, sidecar::SignatureSidecar)> {
+    transpile_unit(c_code, base_dir, imports, &CodegenOptions::default(), None)
+}
+
+/// Transpile one translation unit function by function, writing to `sink`.
+///
+/// Produces the same code as [`transpile_with_includes`] for huge
+/// translation units such as amalgamations without holding every function's
+/// HIR, transformed form and output at once. Module-level definitions and
+/// the cross-function call-site tables are collected first; each function
+/// then goes from the AST through HIR, ownership and codegen to `sink` and
+/// is freed before the next. Peak memory beyond the parsed AST is bounded by
+/// the largest function plus those tables, at the cost of running the
+/// ownership transforms twice per function.
+///
+/// # Examples
+///
+/// ```no_run
+/// use decy_core::transpile_streaming;
+///
+/// let mut out = Vec::new();
+/// transpile_streaming("int add(int a, int b) { return a + b; }", None, &mut out)?;
+/// assert!(String::from_utf8(out)?.contains("fn add"));
+/// # Ok::<(), anyhow::Error>(())
+/// ```
+pub fn transpile_streaming<W: std::io::Write>(
+    c_code: &str,
+    base_dir: Option<&Path>,
+    sink: &mut W,
+) -> Result<()> {
+    let stdlib_prototypes = StdlibPrototypes::new();
+    let mut processed_files = std::collections::HashSet::new();
+    let mut injected_headers = std::collections::HashSet::new();
+    let preprocessed = preprocess_includes(
+        c_code,
+        base_dir,
+        &mut processed_files,
+        &stdlib_prototypes,
+        &mut injected_headers,
+    )?;
+
+    let parser = CParser::new().context("Failed to create C parser")?;
+    let ast = parser.parse(&preprocessed).context("Failed to parse C code")?;
+    drop(preprocessed);
+
+    stream_ast_to_rust(ast, sink)
+}
+
+fn stream_ast_to_rust<W: std::io::Write>(mut ast: decy_parser::Ast, sink: &mut W) -> Result<()> {
+    let options = CodegenOptions::default();
+    let order = deduplicated_function_order(ast.functions());
+    let mut items = ModuleItems::from_ast(&ast);
+
+    // Unit-wide analyses see one function at a time and keep only their
+    // tables; units they can find nothing in skip them
+    let lower = |index: usize| HirFunction::from_ast_function(&ast.functions()[index]);
+    let analysis = match order.iter().any(|&i| UnitAnalysis::applies_to(&lower(i), &options)) {
+        true if options.index_arenas || options.buffered_stdout => {
+            tracing::debug!(
+                functions = order.len(),
+                "index arenas and buffered stdout plan over the whole unit; holding every function"
+            );
+            let functions = order.iter().map(|&i| lower(i)).collect();
+            UnitAnalysis::analyze(functions, &mut items, &options, None).0
+        }
+        true => UnitAnalysis::scan(|| order.iter().map(|&i| lower(i)), &items),
+        false => UnitAnalysis::default(),
+    };
+    let lower = |index: usize| analysis.lower(lower(index));
+    let code_generator = analysis.code_generator(&options, ModuleStatics::default());
+
+    // Module tables: each function is lowered and transformed on its own and
+    // only what callers need from it is kept.
+    let ownership_summaries = OwnershipSummaries::compute_streaming(
+        order.iter().filter_map(|&i| lower(i)),
+        std::iter::empty(),
+    );
+    let mut slice_func_args = Vec::new();
+    let mut all_function_sigs = Vec::with_capacity(order.len());
+    let mut string_iter_funcs = Vec::new();
+    let mut statics = StaticsScan::new(&items.variables);
+    for &index in &order {
+        let Some(func) = lower(index) else { continue };
+        slice_func_args.extend(slice_func_arg_mapping(&func));
+        let (func, _) =
+            transform_function_with_ownership(func, &ownership_summaries, &items.structs);
+        all_function_sigs.push(function_call_sig(&func, &ownership_summaries));
+        let params = code_generator.get_string_iteration_params(&func);
+        if !params.is_empty() {
+            string_iter_funcs.push((func.name().to_string(), params));
+        }
+        statics.observe(&func);
+    }
+    let code_generator = code_generator.with_module_statics(statics.finish());
+
+    let mut prelude = String::new();
+    let global_vars = generate_module_items(&ast, &items, &code_generator, &mut prelude);
+    sink.write_all(prelude.as_bytes()).context("Failed to write Rust output")?;
+    drop(prelude);
+
+    // Only the kept definitions stay alive; each is dropped once emitted
+    let mut keep = vec![false; ast.functions().len()];
+    order.iter().for_each(|&index| keep[index] = true);
+    let mut pending: Vec<Option<decy_parser::parser::Function>> =
+        ast.take_functions().into_iter().zip(keep).map(|(f, keep)| keep.then_some(f)).collect();
+
+    for index in order {
+        let Some(ast_func) = pending[index].take() else { continue };
+        let func = HirFunction::from_ast_function(&ast_func);
+        drop(ast_func);
+        let Some(func) = analysis.lower(func) else { continue };
+
+        let (func, annotated_sig) =
+            transform_function_with_ownership(func, &ownership_summaries, &items.structs);
+        let mut generated = code_generator.generate_function_with_lifetimes_and_structs(
+            &func,
+            &annotated_sig,
+            &items.structs,
+            &all_function_sigs,
+            &slice_func_args,
+            &string_iter_funcs,
+            &global_vars,
+        );
+        generated.push('\n');
+        sink.write_all(generated.as_bytes()).context("Failed to write Rust output")?;
+    }
+    Ok(())
+}
+
+/// Replace or append entries for functions this unit only declares.
+fn merge_imported<T: Clone>(
+    local: &mut Vec<(String, T)>,
+    imported: impl Iterator<Item = (String, T)>,
+    defined: &std::collections::HashSet<String>,
+) {
+    for (name, value) in imported {
+        if defined.contains(&name) {
+            continue;
+        }
+        match local.iter_mut().find(|(existing, _)| *existing == name) {
+            Some(entry) => entry.1 = value,
+            None => local.push((name, value)),
+        }
+    }
+}
+
+fn transpile_unit(
+    c_code: &str,
+    base_dir: Option<&Path>,
+    imports: &[sidecar::SignatureSidecar],
+    options: &CodegenOptions,
+    trace: Option<&mut trace::TraceCollector>,
+) -> Result<(String, sidecar::SignatureSidecar)> {
+    let imported = || imports.iter().flat_map(|sidecar| sidecar.functions.iter());
+    // Step 0: Preprocess #include directives (DECY-056) + Inject stdlib prototypes
+    let stdlib_prototypes = StdlibPrototypes::new();
+    let mut processed_files = std::collections::HashSet::new();
+    let mut injected_headers = std::collections::HashSet::new();
+    let preprocessed = preprocess_includes(
+        c_code,
+        base_dir,
+        &mut processed_files,
+        &stdlib_prototypes,
+        &mut injected_headers,
+    )?;
+
+    // Step 1: Parse C code
+    // Note: We don't add standard type definitions (size_t, etc.) here because:
+    // 1. If code has #include directives, system headers define them
+    // 2. If code doesn't have includes and uses size_t, it should typedef it explicitly
+    // 3. Adding conflicting typedefs breaks parsing
+    let parser = CParser::new().context("Failed to create C parser")?;
+    let ast = parser.parse(&preprocessed).context("Failed to parse C code")?;
+
+    // Step 2: Convert to HIR
+    let all_hir_functions: Vec<HirFunction> =
+        ast.functions().iter().map(HirFunction::from_ast_function).collect();
+
+    // DECY-190: Deduplicate functions - when a C file has both a declaration
+    // (prototype) and a definition, only keep the definition.
+    // This prevents "the name X is defined multiple times" errors in Rust.
+    let hir_functions = deduplicate_functions(all_hir_functions);
+
+    let mut items = ModuleItems::from_ast(&ast);
+    let (analysis, hir_functions) =
+        UnitAnalysis::analyze(hir_functions, &mut items, options, trace);
+
+    // Functions with a body here take precedence over anything imported
+    let defined_functions: std::collections::HashSet<String> =
+        hir_functions.iter().filter(|f| f.has_body()).map(|f| f.name().to_string()).collect();
+
+    // DECY-116: Build slice function arg mappings BEFORE transformation (while we still have original params)
+    let mut slice_func_args = build_slice_func_arg_mappings(&hir_functions);
+    merge_imported(
+        &mut slice_func_args,
+        imported()
+            .filter(|f| !f.slice_args.is_empty())
+            .map(|f| (f.name().to_string(), f.slice_args.clone())),
+        &defined_functions,
     );
 
+    // Step 3: Analyze ownership and lifetimes
+    // Summaries are computed once over the call graph so callers see what
+    // their callees do with pointer arguments.
+    let ownership_summaries = OwnershipSummaries::compute_with_external(
+        &hir_functions,
+        imported().map(|f| f.summary.clone()),
+    );
+    let transformed_functions: Vec<_> = hir_functions
+        .into_iter()
+        .map(|func| transform_function_with_ownership(func, &ownership_summaries, &items.structs))
+        .collect();
+
+    // Step 4: Generate Rust code with lifetime annotations
+    // Globals get the narrowest storage their uses across the unit allow
+    let statics =
+        ModuleStatics::analyze(&items.variables, transformed_functions.iter().map(|(f, _)| f));
+    let code_generator = analysis.code_generator(options, statics);
+    let mut rust_code = String::new();
+
+    let global_vars = generate_module_items(&ast, &items, &code_generator, &mut rust_code);
+
     // DECY-117: Build function signatures for call site reference mutability
-    let all_function_sigs = build_all_function_sigs(&transformed_functions);
+    let mut all_function_sigs =
+        build_all_function_sigs(&transformed_functions, &ownership_summaries);
+    merge_imported(
+        &mut all_function_sigs,
+        imported().map(|f| (f.name().to_string(), f.call_param_types.clone())),
+        &defined_functions,
+    );
 
     // DECY-134b: Build string iteration function info for call site transformation
-    let string_iter_funcs: Vec<(String, Vec<(usize, bool)>)> = transformed_functions
+    let mut string_iter_funcs: Vec<(String, Vec<(usize, bool)>)> = transformed_functions
         .iter()
         .filter_map(|(func, _)| {
             let params = code_generator.get_string_iteration_params(func);
@@ -1259,6 +1976,13 @@ pub fn transpile_with_includes(c_code: &str, base_dir: Option<&Path>) -> Result<
             }
         })
         .collect();
+    merge_imported(
+        &mut string_iter_funcs,
+        imported()
+            .filter(|f| !f.string_iter_params.is_empty())
+            .map(|f| (f.name().to_string(), f.string_iter_params.clone())),
+        &defined_functions,
+    );
 
     // Generate functions with struct definitions for field type awareness
     // Note: slice_func_args was built at line 814 BEFORE transformation to capture original params
@@ -1267,7 +1991,7 @@ pub fn transpile_with_includes(c_code: &str, base_dir: Option<&Path>) -> Result<
         let generated = code_generator.generate_function_with_lifetimes_and_structs(
             func,
             annotated_sig,
-            &hir_structs,
+            &items.structs,
             &all_function_sigs,
             &slice_func_args,
             &string_iter_funcs,
@@ -1277,7 +2001,60 @@ pub fn transpile_with_includes(c_code: &str, base_dir: Option<&Path>) -> Result<
         rust_code.push('\n');
     }
 
-    Ok(rust_code)
+    let exports = build_sidecar(
+        &transformed_functions,
+        &items.structs,
+        &ownership_summaries,
+        &all_function_sigs,
+        &slice_func_args,
+        &string_iter_funcs,
+    );
+
+    Ok((rust_code, exports))
+}
+
+/// Collect what other translation units need to call into this one.
+///
+/// The call-site tables may already contain imported entries, but never for
+/// functions defined here, so lookups for exported functions are local.
+fn build_sidecar(
+    transformed_functions: &[(HirFunction, decy_ownership::lifetime_gen::AnnotatedSignature)],
+    hir_structs: &[decy_hir::HirStruct],
+    summaries: &OwnershipSummaries,
+    function_sigs: &[(String, Vec<decy_hir::HirType>)],
+    slice_func_args: &[(String, Vec<(usize, usize)>)],
+    string_iter_funcs: &[(String, Vec<(usize, bool)>)],
+) -> sidecar::SignatureSidecar {
+    fn lookup<T: Clone + Default>(table: &[(String, T)], name: &str) -> T {
+        table.iter().find(|(n, _)| n == name).map(|(_, v)| v.clone()).unwrap_or_default()
+    }
+
+    let functions = transformed_functions
+        .iter()
+        .filter(|(func, _)| func.has_body())
+        .filter_map(|(func, signature)| {
+            let name = func.name();
+            Some(sidecar::ExportedFunction {
+                signature: signature.clone(),
+                call_param_types: lookup(function_sigs, name),
+                summary: summaries.get(name)?.clone(),
+                slice_args: lookup(slice_func_args, name),
+                string_iter_params: lookup(string_iter_funcs, name),
+            })
+        })
+        .collect();
+
+    let annotator = decy_ownership::struct_lifetime::StructLifetimeAnnotator::new();
+    let structs = hir_structs
+        .iter()
+        .map(|s| {
+            let fields: Vec<(&str, decy_hir::HirType)> =
+                s.fields().iter().map(|f| (f.name(), f.field_type().clone())).collect();
+            annotator.annotate_struct(s.name(), &fields)
+        })
+        .collect();
+
+    sidecar::SignatureSidecar { functions, structs }
 }
 
 /// DECY-237: Transpile directly from a C file path.
@@ -1400,7 +2177,9 @@ fn process_ast_to_rust(ast: decy_parser::Ast, _base_dir: Option<&Path>) -> Resul
         .map(|v| decy_hir::HirStatement::VariableDeclaration {
             name: v.name().to_string(),
             var_type: decy_hir::HirType::from_ast_type(v.var_type()),
-            initializer: v.initializer().map(decy_hir::HirExpression::from_ast_expression),
+            initializer: v
+                .initializer()
+                .map(|init| optimize::fold_initializer(HirExpression::from_ast_expression(init))),
         })
         .collect();
 
@@ -1417,7 +2196,10 @@ fn process_ast_to_rust(ast: decy_parser::Ast, _base_dir: Option<&Path>) -> Resul
         .collect();
 
     // Create code generator
-    let code_generator = CodeGenerator::new();
+    // Functions here are generated without global tracking, so globals keep
+    // `static mut`; the analysis only decides whether errno is declared.
+    let code_generator =
+        CodeGenerator::new().with_module_statics(ModuleStatics::analyze(&[], &hir_functions));
     let mut rust_code = String::new();
 
     // Track emitted items to avoid duplicates
@@ -1463,8 +2245,10 @@ fn process_ast_to_rust(ast: decy_parser::Ast, _base_dir: Option<&Path>) -> Resul
         rust_code.push('\n');
     }
 
-    // DECY-241: Add errno global variable (C compatibility)
-    rust_code.push_str("static mut ERRNO: i32 = 0;\n");
+    // DECY-241: Add errno (C compatibility) when the program uses it
+    if let Some(errno) = code_generator.generate_errno_declaration() {
+        rust_code.push_str(errno);
+    }
 
     // Generate typedefs
     for typedef in &hir_typedefs {
@@ -1487,8 +2271,10 @@ fn process_ast_to_rust(ast: decy_parser::Ast, _base_dir: Option<&Path>) -> Resul
             let type_str = CodeGenerator::map_type(var_type);
             if let Some(init_expr) = initializer {
                 let init_code = code_generator.generate_expression(init_expr);
-                rust_code
-                    .push_str(&format!("static mut {}: {} = {};\n", name, type_str, init_code));
+                rust_code.push_str(
+                    &code_generator
+                        .generate_global_declaration(name, var_type, &type_str, &init_code),
+                );
             } else {
                 let default_value = match var_type {
                     decy_hir::HirType::Int => "0".to_string(),
@@ -1516,8 +2302,12 @@ fn process_ast_to_rust(ast: decy_parser::Ast, _base_dir: Option<&Path>) -> Resul
                     }
                     _ => "Default::default()".to_string(),
                 };
-                rust_code
-                    .push_str(&format!("static mut {}: {} = {};\n", name, type_str, default_value));
+                rust_code.push_str(&code_generator.generate_global_declaration(
+                    name,
+                    var_type,
+                    &type_str,
+                    &default_value,
+                ));
             }
         }
     }
@@ -1714,131 +2504,6 @@ fn generate_ffi_declarations(functions: &[String]) -> String {
     ffi
 }
 
-/// Check if a function parameter uses pointer arithmetic (DECY-125).
-///
-/// Returns true if the parameter is used in `p = p + n` or `p = p - n` patterns.
-fn uses_pointer_arithmetic(func: &HirFunction, param_name: &str) -> bool {
-    for stmt in func.body() {
-        if statement_uses_pointer_arithmetic(stmt, param_name) {
-            return true;
-        }
-    }
-    false
-}
-
-/// DECY-159: Check if a pointer parameter is compared to NULL.
-///
-/// If a pointer is compared to NULL, it means NULL is a valid input value.
-/// Such parameters must remain as raw pointers, not references,
-/// to avoid dereferencing NULL at call sites.
-fn pointer_compared_to_null(func: &HirFunction, param_name: &str) -> bool {
-    for stmt in func.body() {
-        if statement_compares_to_null(stmt, param_name) {
-            return true;
-        }
-    }
-    false
-}
-
-/// DECY-159: Recursively check if a statement compares a variable to NULL.
-fn statement_compares_to_null(stmt: &HirStatement, var_name: &str) -> bool {
-    match stmt {
-        HirStatement::If { condition, then_block, else_block } => {
-            // Check if condition is var == NULL or var != NULL
-            if expression_compares_to_null(condition, var_name) {
-                return true;
-            }
-            // Recurse into blocks
-            then_block.iter().any(|s| statement_compares_to_null(s, var_name))
-                || else_block
-                    .as_ref()
-                    .is_some_and(|blk| blk.iter().any(|s| statement_compares_to_null(s, var_name)))
-        }
-        HirStatement::While { condition, body } => {
-            expression_compares_to_null(condition, var_name)
-                || body.iter().any(|s| statement_compares_to_null(s, var_name))
-        }
-        HirStatement::For { condition, body, .. } => {
-            condition.as_ref().is_some_and(|c| expression_compares_to_null(c, var_name))
-                || body.iter().any(|s| statement_compares_to_null(s, var_name))
-        }
-        HirStatement::Switch { condition, cases, .. } => {
-            expression_compares_to_null(condition, var_name)
-                || cases
-                    .iter()
-                    .any(|c| c.body.iter().any(|s| statement_compares_to_null(s, var_name)))
-        }
-        _ => false,
-    }
-}
-
-/// DECY-159: Check if an expression compares a variable to NULL.
-///
-/// NULL in C can be:
-/// - `NullLiteral` (explicit NULL)
-/// - `IntLiteral(0)` (NULL macro expanded to 0)
-/// - Cast of 0 to void* (less common)
-fn expression_compares_to_null(expr: &HirExpression, var_name: &str) -> bool {
-    use decy_hir::BinaryOperator;
-    match expr {
-        HirExpression::BinaryOp { op, left, right } => {
-            // Check for var == NULL or var != NULL
-            if matches!(op, BinaryOperator::Equal | BinaryOperator::NotEqual) {
-                let left_is_var =
-                    matches!(&**left, HirExpression::Variable(name) if name == var_name);
-                let right_is_var =
-                    matches!(&**right, HirExpression::Variable(name) if name == var_name);
-                // NULL can be NullLiteral or IntLiteral(0) (when NULL macro expands to 0)
-                let left_is_null =
-                    matches!(&**left, HirExpression::NullLiteral | HirExpression::IntLiteral(0));
-                let right_is_null =
-                    matches!(&**right, HirExpression::NullLiteral | HirExpression::IntLiteral(0));
-
-                if (left_is_var && right_is_null) || (right_is_var && left_is_null) {
-                    return true;
-                }
-            }
-            // Recurse into binary op children for nested comparisons
-            expression_compares_to_null(left, var_name)
-                || expression_compares_to_null(right, var_name)
-        }
-        HirExpression::UnaryOp { operand, .. } => expression_compares_to_null(operand, var_name),
-        _ => false,
-    }
-}
-
-/// Recursively check if a statement uses pointer arithmetic on a variable (DECY-125).
-fn statement_uses_pointer_arithmetic(stmt: &HirStatement, var_name: &str) -> bool {
-    use decy_hir::BinaryOperator;
-    match stmt {
-        HirStatement::Assignment { target, value } => {
-            // Check if this is var = var + n or var = var - n (pointer arithmetic)
-            if target == var_name {
-                if let HirExpression::BinaryOp { op, left, .. } = value {
-                    if matches!(op, BinaryOperator::Add | BinaryOperator::Subtract) {
-                        if let HirExpression::Variable(name) = &**left {
-                            if name == var_name {
-                                return true;
-                            }
-                        }
-                    }
-                }
-            }
-            false
-        }
-        HirStatement::If { then_block, else_block, .. } => {
-            then_block.iter().any(|s| statement_uses_pointer_arithmetic(s, var_name))
-                || else_block.as_ref().is_some_and(|blk| {
-                    blk.iter().any(|s| statement_uses_pointer_arithmetic(s, var_name))
-                })
-        }
-        HirStatement::While { body, .. } | HirStatement::For { body, .. } => {
-            body.iter().any(|s| statement_uses_pointer_arithmetic(s, var_name))
-        }
-        _ => false,
-    }
-}
-
 #[cfg(test)]
 #[path = "tests.rs"]
 mod tests;
@@ -29,9 +29,8 @@
 //! assert_eq!(optimized.body().len(), 1);
 //! ```
 
-#[cfg(test)]
-use decy_hir::HirType;
-use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirStatement};
+use decy_hir::visit::{fold_expression_children, walk_statements, Fold, Visitor};
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirStatement, HirType, UnaryOperator};
 
 /// Maximum number of fixed-point iterations.
 const MAX_ITERATIONS: usize = 3;
@@ -40,7 +39,13 @@ const MAX_ITERATIONS: usize = 3;
 ///
 /// Runs constant folding, dead branch removal, and temporary elimination
 /// in a fixed-point loop until no more changes are made or MAX_ITERATIONS is reached.
+///
+/// A body that no pass would rewrite is shared with the input rather than copied.
 pub fn optimize_function(func: &HirFunction) -> HirFunction {
+    if !needs_optimization(func.body()) {
+        return func.clone();
+    }
+
     let mut body = func.body().to_vec();
     let mut changed = true;
     let mut iterations = 0;
@@ -59,15 +64,84 @@ pub fn optimize_function(func: &HirFunction) -> HirFunction {
         iterations += 1;
     }
 
-    let mut result = HirFunction::new_with_body(
-        func.name().to_string(),
-        func.return_type().clone(),
-        func.parameters().to_vec(),
-        body,
-    );
-    // DECY-221: Preserve CUDA qualifier through optimization
-    result.set_cuda_qualifier(func.cuda_qualifier());
-    result
+    if body == func.body() {
+        return func.clone();
+    }
+    // DECY-221: with_body preserves the CUDA qualifier through optimization
+    func.with_body(body)
+}
+
+// ============================================================================
+// Change detection
+// ============================================================================
+
+/// Conservatively check whether any pass could rewrite these statements.
+///
+/// False positives only cost a full optimization run; a false negative would
+/// skip a rewrite, so every pattern the passes match must be covered here.
+fn needs_optimization(stmts: &[HirStatement]) -> bool {
+    // Temporary elimination only looks at the top-level statement list
+    let has_temporary = stmts.windows(2).any(|pair| {
+        matches!(
+            pair,
+            [
+                HirStatement::VariableDeclaration { name, initializer: Some(_), .. },
+                HirStatement::Return(Some(HirExpression::Variable(ret_var))),
+            ] if name == ret_var
+        )
+    });
+    if has_temporary {
+        return true;
+    }
+    let mut finder = OptimizationFinder::default();
+    walk_statements(&mut finder, stmts);
+    finder.found
+}
+
+/// Flags the first dead branch or foldable expression anywhere in a body.
+#[derive(Default)]
+struct OptimizationFinder {
+    found: bool,
+}
+
+impl Visitor for OptimizationFinder {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        self.found |= match stmt {
+            HirStatement::If { condition, .. } => is_constant_truthy(condition).is_some(),
+            HirStatement::While { condition, .. } => is_constant_truthy(condition) == Some(false),
+            _ => false,
+        };
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        self.found |= match expr {
+            HirExpression::BinaryOp { left, right, .. } => {
+                is_constant_expr(left) && is_constant_expr(right)
+            }
+            HirExpression::UnaryOp { op: UnaryOperator::Minus, operand } => {
+                is_constant_expr(operand)
+            }
+            _ => false,
+        };
+    }
+}
+
+/// Check whether `expr` is built only from literals, integer casts of
+/// literals and `sizeof` of scalar types.
+fn is_constant_expr(expr: &HirExpression) -> bool {
+    match expr {
+        HirExpression::IntLiteral(_) | HirExpression::CharLiteral(_) => true,
+        HirExpression::FloatLiteral(value) => double_literal(value).is_some(),
+        HirExpression::Sizeof { type_name } => scalar_size(type_name).is_some(),
+        HirExpression::Cast { target_type, expr } => {
+            is_int_cast(target_type) && is_constant_expr(expr)
+        }
+        HirExpression::BinaryOp { left, right, .. } => {
+            is_constant_expr(left) && is_constant_expr(right)
+        }
+        HirExpression::UnaryOp { op: UnaryOperator::Minus, operand } => is_constant_expr(operand),
+        _ => false,
+    }
 }
 
 // ============================================================================
@@ -76,72 +150,224 @@ pub fn optimize_function(func: &HirFunction) -> HirFunction {
 
 /// Fold constant expressions in a statement.
 fn fold_constants_stmt(stmt: HirStatement) -> HirStatement {
-    match stmt {
-        HirStatement::VariableDeclaration { name, var_type, initializer } => {
-            HirStatement::VariableDeclaration {
-                name,
-                var_type,
-                initializer: initializer.map(fold_constants_expr),
+    ConstantFolder::default().fold_statement(stmt)
+}
+
+/// Fold a global initializer so constant tables and macro-derived values
+/// reach codegen as literals.
+pub fn fold_initializer(expr: HirExpression) -> HirExpression {
+    ConstantFolder::default().fold_expression(expr)
+}
+
+/// Bottom-up constant folder over every expression position.
+///
+/// Operands are promoted the way C does: `char` literals and narrowing
+/// integer casts fold as `int`, `sizeof` of scalar types as `size_t`, and an
+/// `int` meeting a `double` literal folds as `double`. Integer trees are
+/// evaluated whole, so a `size_t` result that does not fit an `int` literal,
+/// such as `sizeof(char) - 2`, is left as written. `sizeof` is kept inside
+/// call and allocation arguments, where codegen reads the element type from
+/// it.
+#[derive(Default)]
+struct ConstantFolder {
+    call_depth: usize,
+}
+
+impl Fold for ConstantFolder {
+    fn fold_expression(&mut self, expr: HirExpression) -> HirExpression {
+        if matches!(
+            expr,
+            HirExpression::BinaryOp { .. }
+                | HirExpression::UnaryOp { op: UnaryOperator::Minus, .. }
+        ) {
+            match self.constant(&expr) {
+                Some(Constant::Int(v)) => return HirExpression::IntLiteral(v),
+                Some(Constant::Size(v)) => {
+                    return i32::try_from(v).map_or(expr, HirExpression::IntLiteral)
+                }
+                None => {}
             }
         }
-        HirStatement::Return(expr) => HirStatement::Return(expr.map(fold_constants_expr)),
-        HirStatement::Assignment { target, value } => {
-            HirStatement::Assignment { target, value: fold_constants_expr(value) }
+        let is_call = matches!(
+            expr,
+            HirExpression::FunctionCall { .. }
+                | HirExpression::Malloc { .. }
+                | HirExpression::Calloc { .. }
+                | HirExpression::Realloc { .. }
+        );
+        self.call_depth += usize::from(is_call);
+        let expr = fold_expression_children(self, expr);
+        self.call_depth -= usize::from(is_call);
+
+        match expr {
+            HirExpression::BinaryOp { op, left, right } => {
+                match self.fold_double_binary(&left, op, &right) {
+                    Some(result) => result,
+                    None => HirExpression::BinaryOp { op, left, right },
+                }
+            }
+            HirExpression::UnaryOp { op: UnaryOperator::Minus, operand } => {
+                match operand.as_ref() {
+                    HirExpression::IntLiteral(v) if v.checked_neg().is_some() => {
+                        HirExpression::IntLiteral(-v)
+                    }
+                    HirExpression::FloatLiteral(v) => match double_literal(v) {
+                        Some(v) => float_literal(-v),
+                        None => HirExpression::UnaryOp { op: UnaryOperator::Minus, operand },
+                    },
+                    _ => HirExpression::UnaryOp { op: UnaryOperator::Minus, operand },
+                }
+            }
+            other => other,
         }
-        HirStatement::If { condition, then_block, else_block } => HirStatement::If {
-            condition: fold_constants_expr(condition),
-            then_block: then_block.into_iter().map(fold_constants_stmt).collect(),
-            else_block: else_block
-                .map(|block| block.into_iter().map(fold_constants_stmt).collect()),
-        },
-        HirStatement::While { condition, body } => HirStatement::While {
-            condition: fold_constants_expr(condition),
-            body: body.into_iter().map(fold_constants_stmt).collect(),
-        },
-        HirStatement::For { init, condition, increment, body } => HirStatement::For {
-            init: init.into_iter().map(fold_constants_stmt).collect(),
-            condition: condition.map(fold_constants_expr),
-            increment: increment.into_iter().map(fold_constants_stmt).collect(),
-            body: body.into_iter().map(fold_constants_stmt).collect(),
-        },
-        HirStatement::Expression(expr) => HirStatement::Expression(fold_constants_expr(expr)),
-        // Statements without foldable expressions pass through
-        other => other,
     }
 }
 
-/// Fold constant expressions recursively.
-fn fold_constants_expr(expr: HirExpression) -> HirExpression {
-    match expr {
-        HirExpression::BinaryOp { op, left, right } => {
-            let left = fold_constants_expr(*left);
-            let right = fold_constants_expr(*right);
-
-            // Try to fold integer arithmetic
-            if let (HirExpression::IntLiteral(l), HirExpression::IntLiteral(r)) = (&left, &right) {
-                if let Some(result) = fold_int_binary(*l, op, *r) {
-                    return HirExpression::IntLiteral(result);
-                }
-            }
+/// An integer constant in the type C gives it.
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum Constant {
+    /// `int`, which literals, `char` literals and narrowing casts promote to
+    Int(i32),
+    /// `size_t`, the type of `sizeof`
+    Size(u64),
+}
 
-            HirExpression::BinaryOp { op, left: Box::new(left), right: Box::new(right) }
+impl Constant {
+    /// The value as `size_t`, which an `int` converts to modulo 2^64.
+    fn size(self) -> u64 {
+        match self {
+            Constant::Int(v) => v as i64 as u64,
+            Constant::Size(v) => v,
         }
-        HirExpression::UnaryOp { op, operand } => {
-            let operand = fold_constants_expr(*operand);
-            if let (decy_hir::UnaryOperator::Minus, HirExpression::IntLiteral(v)) = (op, &operand) {
-                return HirExpression::IntLiteral(-v);
+    }
+}
+
+impl ConstantFolder {
+    /// Value of an integer constant tree, or `None` when part of it is not
+    /// constant or C leaves the result undefined.
+    fn constant(&self, expr: &HirExpression) -> Option<Constant> {
+        match expr {
+            HirExpression::IntLiteral(v) => Some(Constant::Int(*v)),
+            HirExpression::CharLiteral(c) => Some(Constant::Int(i32::from(*c))),
+            HirExpression::Sizeof { type_name } if self.call_depth == 0 => {
+                scalar_size(type_name).map(|v| Constant::Size(u64::from(v)))
+            }
+            HirExpression::Cast { target_type, expr } if is_int_cast(target_type) => {
+                let v = match self.constant(expr)? {
+                    Constant::Int(v) => v,
+                    Constant::Size(v) => v as i32,
+                };
+                match target_type {
+                    HirType::Char => Some(Constant::Int(i32::from(v as u8))),
+                    HirType::SignedChar => Some(Constant::Int(i32::from(v as i8))),
+                    _ => Some(Constant::Int(v)),
+                }
+            }
+            HirExpression::BinaryOp { op, left, right } => {
+                fold_constant_binary(self.constant(left)?, *op, self.constant(right)?)
+            }
+            HirExpression::UnaryOp { op: UnaryOperator::Minus, operand } => {
+                match self.constant(operand)? {
+                    Constant::Int(v) => v.checked_neg().map(Constant::Int),
+                    Constant::Size(v) => Some(Constant::Size(v.wrapping_neg())),
+                }
             }
-            HirExpression::UnaryOp { op, operand: Box::new(operand) }
+            _ => None,
         }
-        // Recurse into nested expressions
-        HirExpression::FunctionCall { function, arguments } => HirExpression::FunctionCall {
-            function,
-            arguments: arguments.into_iter().map(fold_constants_expr).collect(),
-        },
-        other => other,
+    }
+
+    /// `double` arithmetic where one side is a `double` literal and the
+    /// other a `double` literal or an `int` operand.
+    fn fold_double_binary(
+        &self,
+        left: &HirExpression,
+        op: BinaryOperator,
+        right: &HirExpression,
+    ) -> Option<HirExpression> {
+        let operand = |expr: &HirExpression| match expr {
+            HirExpression::FloatLiteral(v) => double_literal(v).map(|v| (v, true)),
+            other => match self.constant(other)? {
+                Constant::Int(v) => Some((f64::from(v), false)),
+                Constant::Size(v) => Some((v as f64, false)),
+            },
+        };
+        let ((l, l_double), (r, r_double)) = (operand(left)?, operand(right)?);
+        if !(l_double || r_double) {
+            return None;
+        }
+        let result = match op {
+            BinaryOperator::Add => l + r,
+            BinaryOperator::Subtract => l - r,
+            BinaryOperator::Multiply => l * r,
+            BinaryOperator::Divide => l / r,
+            _ => return None,
+        };
+        result.is_finite().then(|| float_literal(result))
     }
 }
 
+/// Casts that keep a constant an `int` operand once promoted.
+fn is_int_cast(target_type: &HirType) -> bool {
+    matches!(target_type, HirType::Int | HirType::Char | HirType::SignedChar)
+}
+
+/// Value of an unsuffixed floating literal, which C types as `double`.
+fn double_literal(value: &str) -> Option<f64> {
+    if value.ends_with(['f', 'F', 'l', 'L']) {
+        return None;
+    }
+    value.parse::<f64>().ok().filter(|v| v.is_finite())
+}
+
+/// A folded `double`, spelled so that it parses back to the same value.
+fn float_literal(value: f64) -> HirExpression {
+    HirExpression::FloatLiteral(format!("{:?}", value))
+}
+
+/// `sizeof` of a scalar C type, as codegen maps it (`long` is `i64`).
+fn scalar_size(type_name: &str) -> Option<u32> {
+    match type_name.trim() {
+        "char" | "signed char" | "unsigned char" | "_Bool" => Some(1),
+        "short" | "short int" | "unsigned short" | "unsigned short int" => Some(2),
+        "int" | "signed int" | "signed" | "unsigned" | "unsigned int" | "float" => Some(4),
+        "long" | "long int" | "unsigned long" | "unsigned long int" | "long long"
+        | "unsigned long long" | "double" => Some(8),
+        _ => None,
+    }
+}
+
+/// Evaluate a binary operation on integer constants. An `int` meeting a
+/// `size_t` is converted to it and the result wraps, as in C; a shift has
+/// the type of its left operand.
+fn fold_constant_binary(left: Constant, op: BinaryOperator, right: Constant) -> Option<Constant> {
+    let (l, r) = match (left, right) {
+        (Constant::Int(l), Constant::Int(r)) => {
+            return fold_int_binary(l, op, r).map(Constant::Int)
+        }
+        (Constant::Int(l), _)
+            if matches!(op, BinaryOperator::LeftShift | BinaryOperator::RightShift) =>
+        {
+            let r = i32::try_from(right.size()).ok()?;
+            return fold_int_binary(l, op, r).map(Constant::Int);
+        }
+        _ => (left.size(), right.size()),
+    };
+    let result = match op {
+        BinaryOperator::Add => l.wrapping_add(r),
+        BinaryOperator::Subtract => l.wrapping_sub(r),
+        BinaryOperator::Multiply => l.wrapping_mul(r),
+        BinaryOperator::Divide => l.checked_div(r)?,
+        BinaryOperator::Modulo => l.checked_rem(r)?,
+        BinaryOperator::LeftShift if right.size() < 64 => l << r,
+        BinaryOperator::RightShift if right.size() < 64 => l >> r,
+        BinaryOperator::BitwiseAnd => l & r,
+        BinaryOperator::BitwiseOr => l | r,
+        BinaryOperator::BitwiseXor => l ^ r,
+        _ => return None,
+    };
+    Some(Constant::Size(result))
+}
+
 /// Try to evaluate a binary operation on integer literals.
 fn fold_int_binary(left: i32, op: BinaryOperator, right: i32) -> Option<i32> {
     match op {
@@ -307,53 +533,43 @@ fn is_allocation_expr(expr: &HirExpression) -> bool {
 
 /// Count how many times a variable is used in a slice of statements.
 fn count_uses(name: &str, stmts: &[HirStatement]) -> usize {
-    let mut count = 0;
-    for stmt in stmts {
-        count += count_uses_in_stmt(name, stmt);
-    }
-    count
+    let mut uses = UseCounter { name, count: 0 };
+    walk_statements(&mut uses, stmts);
+    uses.count
 }
 
-/// Count uses of a variable in a single statement.
-fn count_uses_in_stmt(name: &str, stmt: &HirStatement) -> usize {
-    match stmt {
-        HirStatement::Return(Some(expr)) => count_uses_in_expr(name, expr),
-        HirStatement::Assignment { value, .. } => count_uses_in_expr(name, value),
-        HirStatement::Expression(expr) => count_uses_in_expr(name, expr),
-        HirStatement::If { condition, then_block, else_block } => {
-            let mut c = count_uses_in_expr(name, condition);
-            for s in then_block {
-                c += count_uses_in_stmt(name, s);
-            }
-            if let Some(block) = else_block {
-                for s in block {
-                    c += count_uses_in_stmt(name, s);
-                }
-            }
-            c
-        }
-        _ => 0,
-    }
+/// Counts reads of one variable at any depth.
+struct UseCounter<'a> {
+    name: &'a str,
+    count: usize,
 }
 
-/// Count uses of a variable in an expression.
-fn count_uses_in_expr(name: &str, expr: &HirExpression) -> usize {
-    match expr {
-        HirExpression::Variable(v) if v == name => 1,
-        HirExpression::BinaryOp { left, right, .. } => {
-            count_uses_in_expr(name, left) + count_uses_in_expr(name, right)
+impl Visitor for UseCounter<'_> {
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        if matches!(expr, HirExpression::Variable(v) if v == self.name) {
+            self.count += 1;
         }
-        HirExpression::FunctionCall { arguments, .. } => {
-            arguments.iter().map(|a| count_uses_in_expr(name, a)).sum()
-        }
-        HirExpression::UnaryOp { operand, .. } => count_uses_in_expr(name, operand),
-        _ => 0,
     }
 }
 
 #[cfg(test)]
 mod tests {
     use super::*;
+    use decy_hir::visit::walk_expression;
+
+    fn fold_constants_expr(expr: HirExpression) -> HirExpression {
+        ConstantFolder::default().fold_expression(expr)
+    }
+
+    fn count_uses_in_stmt(name: &str, stmt: &HirStatement) -> usize {
+        count_uses(name, std::slice::from_ref(stmt))
+    }
+
+    fn count_uses_in_expr(name: &str, expr: &HirExpression) -> usize {
+        let mut uses = UseCounter { name, count: 0 };
+        walk_expression(&mut uses, expr);
+        uses.count
+    }
 
     #[test]
     fn test_constant_folding_add() {
@@ -1063,6 +1279,62 @@ mod tests {
         assert_eq!(optimized.body().len(), 1);
     }
 
+    #[test]
+    fn test_optimize_unchanged_function_shares_body() {
+        let func = HirFunction::new_with_body(
+            "noop".to_string(),
+            HirType::Int,
+            vec![],
+            vec![
+                HirStatement::If {
+                    condition: HirExpression::Variable("x".to_string()),
+                    then_block: vec![HirStatement::Return(Some(HirExpression::IntLiteral(1)))],
+                    else_block: None,
+                },
+                HirStatement::Return(Some(HirExpression::IntLiteral(0))),
+            ],
+        );
+        let optimized = optimize_function(&func);
+        assert_eq!(optimized, func);
+        assert!(optimized.shares_body_with(&func));
+    }
+
+    #[test]
+    fn test_optimize_nested_fold_is_detected() {
+        // f(-(2 + 3)) inside a loop body still gets folded
+        let func = HirFunction::new_with_body(
+            "nested".to_string(),
+            HirType::Void,
+            vec![],
+            vec![HirStatement::While {
+                condition: HirExpression::Variable("x".to_string()),
+                body: vec![HirStatement::Expression(HirExpression::FunctionCall {
+                    function: "f".to_string(),
+                    arguments: vec![HirExpression::UnaryOp {
+                        op: decy_hir::UnaryOperator::Minus,
+                        operand: Box::new(HirExpression::BinaryOp {
+                            op: BinaryOperator::Add,
+                            left: Box::new(HirExpression::IntLiteral(2)),
+                            right: Box::new(HirExpression::IntLiteral(3)),
+                        }),
+                    }],
+                })],
+            }],
+        );
+        let optimized = optimize_function(&func);
+        assert!(!optimized.shares_body_with(&func));
+        let HirStatement::While { body, .. } = &optimized.body()[0] else {
+            panic!("expected while");
+        };
+        assert_eq!(
+            body[0],
+            HirStatement::Expression(HirExpression::FunctionCall {
+                function: "f".to_string(),
+                arguments: vec![HirExpression::IntLiteral(-5)],
+            })
+        );
+    }
+
     #[test]
     fn test_optimize_empty_function() {
         let func = HirFunction::new_with_body("empty".to_string(), HirType::Void, vec![], vec![]);
@@ -1213,25 +1485,23 @@ mod tests {
 
     #[test]
     fn test_count_uses_in_var_decl_stmt() {
-        // VariableDeclaration falls through to _ => 0
+        // Initializers read the variable like any other expression
         let stmts = vec![HirStatement::VariableDeclaration {
             name: "y".to_string(),
             var_type: HirType::Int,
             initializer: Some(HirExpression::Variable("x".to_string())),
         }];
-        // VariableDeclaration is handled by _ => 0, so x is NOT counted
-        assert_eq!(count_uses("x", &stmts), 0);
+        assert_eq!(count_uses("x", &stmts), 1);
     }
 
     #[test]
     fn test_count_uses_in_while_stmt() {
-        // While falls through to _ => 0
+        // Loop conditions and bodies are both counted
         let stmts = vec![HirStatement::While {
             condition: HirExpression::Variable("x".to_string()),
             body: vec![HirStatement::Expression(HirExpression::Variable("x".to_string()))],
         }];
-        // While is handled by _ => 0
-        assert_eq!(count_uses("x", &stmts), 0);
+        assert_eq!(count_uses("x", &stmts), 2);
     }
 
     #[test]
@@ -1382,7 +1652,6 @@ mod tests {
 
     #[test]
     fn test_count_uses_in_stmt_with_while() {
-        // While statements fall through to _ => 0 in count_uses_in_stmt
         let stmt = HirStatement::While {
             condition: HirExpression::Variable("x".to_string()),
             body: vec![HirStatement::Assignment {
@@ -1390,8 +1659,8 @@ mod tests {
                 value: HirExpression::Variable("x".to_string()),
             }],
         };
-        // While is not handled by count_uses_in_stmt — returns 0
-        assert_eq!(count_uses_in_stmt("x", &stmt), 0);
+        // Uses inside loops must block temporary elimination
+        assert_eq!(count_uses_in_stmt("x", &stmt), 2);
     }
 
     #[test]
@@ -1431,4 +1700,173 @@ mod tests {
         assert_eq!(count_uses_in_expr("x", &expr), 1);
         assert_eq!(count_uses_in_expr("y", &expr), 0);
     }
+
+    // ============================================================================
+    // Promoted operands: char literals, narrowing casts, sizeof, doubles
+    // ============================================================================
+
+    fn int(value: i32) -> HirExpression {
+        HirExpression::IntLiteral(value)
+    }
+
+    fn binary(op: BinaryOperator, left: HirExpression, right: HirExpression) -> HirExpression {
+        HirExpression::BinaryOp { op, left: Box::new(left), right: Box::new(right) }
+    }
+
+    fn sizeof(type_name: &str) -> HirExpression {
+        HirExpression::Sizeof { type_name: type_name.to_string() }
+    }
+
+    fn float(value: &str) -> HirExpression {
+        HirExpression::FloatLiteral(value.to_string())
+    }
+
+    #[test]
+    fn test_char_literal_folds_as_int() {
+        // 'a' + 1 → 98
+        let expr = binary(BinaryOperator::Add, HirExpression::CharLiteral(b'a' as i8), int(1));
+        assert_eq!(fold_constants_expr(expr), int(98));
+    }
+
+    #[test]
+    fn test_narrowing_cast_wraps_before_folding() {
+        // (char)300 + (signed char)200 + (int)1 → 44 + -56 + 1
+        let cast =
+            |target_type, value| HirExpression::Cast { target_type, expr: Box::new(int(value)) };
+        let expr = binary(
+            BinaryOperator::Add,
+            binary(BinaryOperator::Add, cast(HirType::Char, 300), cast(HirType::SignedChar, 200)),
+            cast(HirType::Int, 1),
+        );
+        assert_eq!(fold_constants_expr(expr), int(-11));
+    }
+
+    #[test]
+    fn test_unsigned_cast_is_not_folded() {
+        let expr = binary(
+            BinaryOperator::Divide,
+            HirExpression::Cast { target_type: HirType::UnsignedInt, expr: Box::new(int(-1)) },
+            int(2),
+        );
+        assert!(matches!(fold_constants_expr(expr), HirExpression::BinaryOp { .. }));
+    }
+
+    #[test]
+    fn test_sizeof_of_scalar_folds() {
+        // 16 * sizeof(long) + sizeof(short) → 130
+        let expr = binary(
+            BinaryOperator::Add,
+            binary(BinaryOperator::Multiply, int(16), sizeof("long")),
+            sizeof("short"),
+        );
+        assert_eq!(fold_constants_expr(expr), int(130));
+
+        let expr = binary(BinaryOperator::Multiply, int(2), sizeof("struct Point"));
+        assert!(matches!(fold_constants_expr(expr), HirExpression::BinaryOp { .. }));
+    }
+
+    #[test]
+    fn test_sizeof_arithmetic_is_unsigned() {
+        // sizeof(char) - 2 is SIZE_MAX, not -1
+        let wraps = binary(BinaryOperator::Subtract, sizeof("char"), int(2));
+        assert_eq!(fold_constants_expr(wraps.clone()), wraps);
+
+        // Nothing inside is folded to an int either
+        let expr = binary(
+            BinaryOperator::Subtract,
+            binary(BinaryOperator::Multiply, sizeof("int"), int(2)),
+            int(10),
+        );
+        assert_eq!(fold_constants_expr(expr.clone()), expr);
+        let negated =
+            HirExpression::UnaryOp { op: UnaryOperator::Minus, operand: Box::new(sizeof("int")) };
+        assert_eq!(fold_constants_expr(negated.clone()), negated);
+
+        // The whole tree is evaluated, so a wrapped intermediate comes back
+        let expr = binary(BinaryOperator::Add, wraps, int(3));
+        assert_eq!(fold_constants_expr(expr), int(2));
+
+        // An int cast of a size_t converts it; a shift keeps its left type
+        let cast = HirExpression::Cast {
+            target_type: HirType::Int,
+            expr: Box::new(binary(BinaryOperator::Subtract, sizeof("char"), int(2))),
+        };
+        assert_eq!(fold_constants_expr(binary(BinaryOperator::Add, cast, int(1))), int(0));
+        let shift = binary(BinaryOperator::LeftShift, int(1), sizeof("short"));
+        assert_eq!(fold_constants_expr(shift), int(4));
+    }
+
+    #[test]
+    fn test_sizeof_is_kept_in_allocation_arguments() {
+        // malloc(4 * sizeof(int)) keeps its element type for codegen
+        let size = binary(BinaryOperator::Multiply, int(4), sizeof("int"));
+        let call = HirExpression::FunctionCall {
+            function: "malloc".to_string(),
+            arguments: vec![size.clone()],
+        };
+        assert_eq!(fold_constants_expr(call.clone()), call);
+
+        let malloc = HirExpression::Malloc { size: Box::new(size) };
+        assert_eq!(fold_constants_expr(malloc.clone()), malloc);
+    }
+
+    #[test]
+    fn test_double_arithmetic_folds() {
+        // 2 * 3.5 - 0.25 → 6.75
+        let expr = binary(
+            BinaryOperator::Subtract,
+            binary(BinaryOperator::Multiply, int(2), float("3.5")),
+            float("0.25"),
+        );
+        assert_eq!(fold_constants_expr(expr), float("6.75"));
+
+        let expr = HirExpression::UnaryOp {
+            op: UnaryOperator::Minus,
+            operand: Box::new(binary(BinaryOperator::Divide, float("1.0"), int(4))),
+        };
+        assert_eq!(fold_constants_expr(expr), float("-0.25"));
+    }
+
+    #[test]
+    fn test_float_suffix_and_non_finite_results_are_not_folded() {
+        // 1.5f is a float, not a double; 1.0 / 0 is not a finite literal
+        let expr = binary(BinaryOperator::Add, float("1.5f"), float("1.0"));
+        assert!(matches!(fold_constants_expr(expr), HirExpression::BinaryOp { .. }));
+
+        let expr = binary(BinaryOperator::Divide, float("1.0"), int(0));
+        assert!(matches!(fold_constants_expr(expr), HirExpression::BinaryOp { .. }));
+    }
+
+    #[test]
+    fn test_fold_initializer_folds_table_entries() {
+        // { 1 << 4, sizeof(int) * 2, 'A' + 1 }
+        let table = HirExpression::CompoundLiteral {
+            literal_type: HirType::Array { element_type: Box::new(HirType::Int), size: Some(3) },
+            initializers: vec![
+                binary(BinaryOperator::LeftShift, int(1), int(4)),
+                binary(BinaryOperator::Multiply, sizeof("int"), int(2)),
+                binary(BinaryOperator::Add, HirExpression::CharLiteral(b'A' as i8), int(1)),
+            ],
+        };
+        let HirExpression::CompoundLiteral { initializers, .. } = fold_initializer(table) else {
+            panic!("expected compound literal");
+        };
+        assert_eq!(initializers, vec![int(16), int(8), int(66)]);
+    }
+
+    #[test]
+    fn test_optimize_detects_promoted_operands() {
+        let func = HirFunction::new_with_body(
+            "promoted".to_string(),
+            HirType::Double,
+            vec![],
+            vec![HirStatement::Return(Some(binary(
+                BinaryOperator::Multiply,
+                float("0.5"),
+                sizeof("double"),
+            )))],
+        );
+        let optimized = optimize_function(&func);
+        assert_eq!(optimized.body(), [HirStatement::Return(Some(float("4.0")))]);
+    }
 }
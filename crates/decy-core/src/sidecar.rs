@@ -0,0 +1,595 @@
+//! Cross-translation-unit ownership signature sidecars.
+//!
+//! After a translation unit is transpiled, everything a dependent file needs
+//! to call into it is written to a compact binary `.decymeta` file next to
+//! the generated Rust, in the spirit of rustc's `.rmeta`:
+//!
+//! - the annotated signature of every exported function,
+//! - its interprocedural ownership summary,
+//! - the call-site parameter types, slice/length and string-iteration mappings,
+//! - lifetime annotations of the structs it defines.
+//!
+//! Dependent files load sidecars instead of re-parsing and re-analysing the
+//! defining file, so a dependency-ordered project build only needs the
+//! sidecars of the previous waves.
+//!
+//! # Examples
+//!
+//! ```
+//! use decy_core::sidecar::SignatureSidecar;
+//!
+//! let sidecar = SignatureSidecar::default();
+//! let bytes = sidecar.to_bytes();
+//! assert_eq!(SignatureSidecar::from_bytes(&bytes).unwrap(), sidecar);
+//! ```
+
+use anyhow::{bail, Context, Result};
+use decy_hir::HirType;
+use decy_ownership::lifetime_gen::{
+    AnnotatedParameter, AnnotatedSignature, AnnotatedType, LifetimeParam,
+};
+use decy_ownership::struct_lifetime::{AnnotatedField, AnnotatedStruct};
+use decy_ownership::summary::{FunctionSummary, ParamSummary};
+use std::path::{Path, PathBuf};
+
+/// File extension used for sidecar files.
+pub const SIDECAR_EXTENSION: &str = "decymeta";
+
+/// Leading bytes of every sidecar file.
+const MAGIC: &[u8; 8] = b"DECYMETA";
+
+/// Bumped whenever the encoding changes; older sidecars are rejected.
+const FORMAT_VERSION: u8 = 1;
+
+/// Everything a caller in another translation unit needs about one function.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ExportedFunction {
+    /// Lifetime-annotated signature
+    pub signature: AnnotatedSignature,
+    /// Parameter types as seen from call sites (DECY-117)
+    pub call_param_types: Vec<HirType>,
+    /// Interprocedural ownership summary
+    pub summary: FunctionSummary,
+    /// (array param index, length param index) pairs (DECY-116)
+    pub slice_args: Vec<(usize, usize)>,
+    /// (param index, is mutable) string-iteration params (DECY-134b)
+    pub string_iter_params: Vec<(usize, bool)>,
+}
+
+impl ExportedFunction {
+    /// Function name.
+    pub fn name(&self) -> &str {
+        &self.signature.name
+    }
+}
+
+/// Ownership metadata exported by one translation unit.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct SignatureSidecar {
+    /// Functions defined (with a body) in the translation unit
+    pub functions: Vec<ExportedFunction>,
+    /// Struct lifetime annotations from `StructLifetimeAnnotator`
+    pub structs: Vec<AnnotatedStruct>,
+}
+
+impl SignatureSidecar {
+    /// Look up an exported function by name.
+    pub fn function(&self, name: &str) -> Option<&ExportedFunction> {
+        self.functions.iter().find(|f| f.name() == name)
+    }
+
+    /// Look up a struct's lifetime annotation by name.
+    pub fn struct_lifetimes(&self, name: &str) -> Option<&AnnotatedStruct> {
+        self.structs.iter().find(|s| s.name == name)
+    }
+
+    /// Sidecar path for a generated Rust file (`foo.rs` → `foo.decymeta`).
+    pub fn path_for(output_path: &Path) -> PathBuf {
+        output_path.with_extension(SIDECAR_EXTENSION)
+    }
+
+    /// Encode to the binary sidecar format.
+    pub fn to_bytes(&self) -> Vec<u8> {
+        let mut enc = Encoder::default();
+        enc.buf.extend_from_slice(MAGIC);
+        enc.u8(FORMAT_VERSION);
+        enc.len(self.functions.len());
+        for func in &self.functions {
+            enc.signature(&func.signature);
+            enc.seq(&func.call_param_types, Encoder::hir_type);
+            enc.summary(&func.summary);
+            enc.seq(&func.slice_args, |e, &(a, b)| {
+                e.len(a);
+                e.len(b);
+            });
+            enc.seq(&func.string_iter_params, |e, &(i, mutable)| {
+                e.len(i);
+                e.bool(mutable);
+            });
+        }
+        enc.seq(&self.structs, Encoder::annotated_struct);
+        enc.buf
+    }
+
+    /// Decode from the binary sidecar format.
+    pub fn from_bytes(bytes: &[u8]) -> Result<Self> {
+        let Some(rest) = bytes.strip_prefix(MAGIC.as_slice()) else {
+            bail!("not a decy sidecar (bad magic)");
+        };
+        let mut dec = Decoder { bytes: rest, pos: 0 };
+        let version = dec.u8()?;
+        if version != FORMAT_VERSION {
+            bail!("unsupported sidecar version {} (expected {})", version, FORMAT_VERSION);
+        }
+        let functions = dec.seq(|d| {
+            Ok(ExportedFunction {
+                signature: d.signature()?,
+                call_param_types: d.seq(Decoder::hir_type)?,
+                summary: d.summary()?,
+                slice_args: d.seq(|d| Ok((d.len()?, d.len()?)))?,
+                string_iter_params: d.seq(|d| Ok((d.len()?, d.bool()?)))?,
+            })
+        })?;
+        let structs = dec.seq(Decoder::annotated_struct)?;
+        if dec.pos != dec.bytes.len() {
+            bail!("trailing bytes after sidecar payload");
+        }
+        Ok(Self { functions, structs })
+    }
+
+    /// Write the sidecar to `path`.
+    pub fn write(&self, path: &Path) -> Result<()> {
+        std::fs::write(path, self.to_bytes())
+            .with_context(|| format!("Failed to write sidecar {}", path.display()))
+    }
+
+    /// Read a sidecar from `path`.
+    pub fn read(path: &Path) -> Result<Self> {
+        let bytes = std::fs::read(path)
+            .with_context(|| format!("Failed to read sidecar {}", path.display()))?;
+        Self::from_bytes(&bytes).with_context(|| format!("Invalid sidecar {}", path.display()))
+    }
+}
+
+#[derive(Default)]
+struct Encoder {
+    buf: Vec<u8>,
+}
+
+impl Encoder {
+    fn u8(&mut self, value: u8) {
+        self.buf.push(value);
+    }
+
+    fn bool(&mut self, value: bool) {
+        self.u8(u8::from(value));
+    }
+
+    /// LEB128 variable-length unsigned integer.
+    fn len(&mut self, mut value: usize) {
+        loop {
+            let byte = (value & 0x7f) as u8;
+            value >>= 7;
+            if value == 0 {
+                self.u8(byte);
+                return;
+            }
+            self.u8(byte | 0x80);
+        }
+    }
+
+    fn str(&mut self, value: &str) {
+        self.len(value.len());
+        self.buf.extend_from_slice(value.as_bytes());
+    }
+
+    fn seq<T>(&mut self, items: &[T], mut each: impl FnMut(&mut Self, &T)) {
+        self.len(items.len());
+        for item in items {
+            each(self, item);
+        }
+    }
+
+    fn hir_type(&mut self, ty: &HirType) {
+        match ty {
+            HirType::Void => self.u8(0),
+            HirType::Bool => self.u8(1),
+            HirType::Int => self.u8(2),
+            HirType::UnsignedInt => self.u8(3),
+            HirType::Float => self.u8(4),
+            HirType::Double => self.u8(5),
+            HirType::Char => self.u8(6),
+            HirType::SignedChar => self.u8(7),
+            HirType::Pointer(inner) => {
+                self.u8(8);
+                self.hir_type(inner);
+            }
+            HirType::Box(inner) => {
+                self.u8(9);
+                self.hir_type(inner);
+            }
+            HirType::Vec(inner) => {
+                self.u8(10);
+                self.hir_type(inner);
+            }
+            HirType::Option(inner) => {
+                self.u8(11);
+                self.hir_type(inner);
+            }
+            HirType::Reference { inner, mutable } => {
+                self.u8(12);
+                self.bool(*mutable);
+                self.hir_type(inner);
+            }
+            HirType::Struct(name) => {
+                self.u8(13);
+                self.str(name);
+            }
+            HirType::Enum(name) => {
+                self.u8(14);
+                self.str(name);
+            }
+            HirType::Union(fields) => {
+                self.u8(15);
+                self.seq(fields, |e, (name, ty)| {
+                    e.str(name);
+                    e.hir_type(ty);
+                });
+            }
+            HirType::Array { element_type, size } => {
+                self.u8(16);
+                self.hir_type(element_type);
+                match size {
+                    Some(n) => {
+                        self.bool(true);
+                        self.len(*n);
+                    }
+                    None => self.bool(false),
+                }
+            }
+            HirType::FunctionPointer { param_types, return_type } => {
+                self.u8(17);
+                self.seq(param_types, Self::hir_type);
+                self.hir_type(return_type);
+            }
+            HirType::StringLiteral => self.u8(18),
+            HirType::OwnedString => self.u8(19),
+            HirType::StringReference => self.u8(20),
+            HirType::TypeAlias(name) => {
+                self.u8(21);
+                self.str(name);
+            }
+        }
+    }
+
+    fn lifetime(&mut self, lifetime: &LifetimeParam) {
+        self.str(&lifetime.name);
+    }
+
+    fn annotated_type(&mut self, ty: &AnnotatedType) {
+        match ty {
+            AnnotatedType::Simple(inner) => {
+                self.u8(0);
+                self.hir_type(inner);
+            }
+            AnnotatedType::Reference { inner, mutable, lifetime } => {
+                self.u8(1);
+                self.bool(*mutable);
+                match lifetime {
+                    Some(lifetime) => {
+                        self.bool(true);
+                        self.lifetime(lifetime);
+                    }
+                    None => self.bool(false),
+                }
+                self.annotated_type(inner);
+            }
+        }
+    }
+
+    fn signature(&mut self, sig: &AnnotatedSignature) {
+        self.str(&sig.name);
+        self.seq(&sig.lifetimes, Self::lifetime);
+        self.seq(&sig.parameters, |e, p| {
+            e.str(&p.name);
+            e.annotated_type(&p.param_type);
+        });
+        self.annotated_type(&sig.return_type);
+    }
+
+    fn summary(&mut self, summary: &FunctionSummary) {
+        self.str(&summary.name);
+        self.bool(summary.has_body);
+        self.seq(&summary.params, |e, p| {
+            e.str(&p.name);
+            let flags =
+                [p.writes, p.escapes, p.consumed, p.frees, p.pointer_arithmetic, p.null_checked];
+            e.u8(flags.iter().enumerate().fold(0, |acc, (bit, &set)| acc | (u8::from(set) << bit)));
+        });
+    }
+
+    fn annotated_struct(&mut self, s: &AnnotatedStruct) {
+        self.str(&s.name);
+        self.seq(&s.lifetimes, Self::lifetime);
+        self.seq(&s.fields, |e, f| {
+            e.str(&f.name);
+            e.annotated_type(&f.field_type);
+        });
+    }
+}
+
+struct Decoder<'a> {
+    bytes: &'a [u8],
+    pos: usize,
+}
+
+impl Decoder<'_> {
+    fn u8(&mut self) -> Result<u8> {
+        let Some(&byte) = self.bytes.get(self.pos) else {
+            bail!("truncated sidecar at byte {}", self.pos);
+        };
+        self.pos += 1;
+        Ok(byte)
+    }
+
+    fn bool(&mut self) -> Result<bool> {
+        match self.u8()? {
+            0 => Ok(false),
+            1 => Ok(true),
+            other => bail!("invalid bool {} at byte {}", other, self.pos - 1),
+        }
+    }
+
+    fn len(&mut self) -> Result<usize> {
+        let mut value = 0usize;
+        let mut shift = 0;
+        loop {
+            let byte = self.u8()?;
+            if shift >= usize::BITS {
+                bail!("varint overflow at byte {}", self.pos - 1);
+            }
+            value |= usize::from(byte & 0x7f) << shift;
+            if byte & 0x80 == 0 {
+                return Ok(value);
+            }
+            shift += 7;
+        }
+    }
+
+    fn str(&mut self) -> Result<String> {
+        let len = self.len()?;
+        let end = self.pos.checked_add(len).filter(|&end| end <= self.bytes.len());
+        let Some(end) = end else {
+            bail!("truncated string at byte {}", self.pos);
+        };
+        let value = std::str::from_utf8(&self.bytes[self.pos..end])
+            .context("sidecar string is not UTF-8")?
+            .to_string();
+        self.pos = end;
+        Ok(value)
+    }
+
+    fn seq<T>(&mut self, mut each: impl FnMut(&mut Self) -> Result<T>) -> Result<Vec<T>> {
+        let len = self.len()?;
+        // Every element takes at least one byte; reject absurd lengths early
+        if len > self.bytes.len() - self.pos {
+            bail!("sequence length {} exceeds remaining input", len);
+        }
+        (0..len).map(|_| each(self)).collect()
+    }
+
+    fn boxed_type(&mut self) -> Result<Box<HirType>> {
+        Ok(Box::new(self.hir_type()?))
+    }
+
+    fn hir_type(&mut self) -> Result<HirType> {
+        Ok(match self.u8()? {
+            0 => HirType::Void,
+            1 => HirType::Bool,
+            2 => HirType::Int,
+            3 => HirType::UnsignedInt,
+            4 => HirType::Float,
+            5 => HirType::Double,
+            6 => HirType::Char,
+            7 => HirType::SignedChar,
+            8 => HirType::Pointer(self.boxed_type()?),
+            9 => HirType::Box(self.boxed_type()?),
+            10 => HirType::Vec(self.boxed_type()?),
+            11 => HirType::Option(self.boxed_type()?),
+            12 => {
+                let mutable = self.bool()?;
+                HirType::Reference { inner: self.boxed_type()?, mutable }
+            }
+            13 => HirType::Struct(self.str()?),
+            14 => HirType::Enum(self.str()?),
+            15 => HirType::Union(self.seq(|d| Ok((d.str()?, d.hir_type()?)))?),
+            16 => {
+                let element_type = self.boxed_type()?;
+                let size = if self.bool()? { Some(self.len()?) } else { None };
+                HirType::Array { element_type, size }
+            }
+            17 => HirType::FunctionPointer {
+                param_types: self.seq(Self::hir_type)?,
+                return_type: self.boxed_type()?,
+            },
+            18 => HirType::StringLiteral,
+            19 => HirType::OwnedString,
+            20 => HirType::StringReference,
+            21 => HirType::TypeAlias(self.str()?),
+            tag => bail!("unknown type tag {} at byte {}", tag, self.pos - 1),
+        })
+    }
+
+    fn lifetime(&mut self) -> Result<LifetimeParam> {
+        Ok(LifetimeParam::new(self.str()?))
+    }
+
+    fn annotated_type(&mut self) -> Result<AnnotatedType> {
+        match self.u8()? {
+            0 => Ok(AnnotatedType::Simple(self.hir_type()?)),
+            1 => {
+                let mutable = self.bool()?;
+                let lifetime = if self.bool()? { Some(self.lifetime()?) } else { None };
+                Ok(AnnotatedType::Reference {
+                    inner: Box::new(self.annotated_type()?),
+                    mutable,
+                    lifetime,
+                })
+            }
+            tag => bail!("unknown annotated type tag {} at byte {}", tag, self.pos - 1),
+        }
+    }
+
+    fn signature(&mut self) -> Result<AnnotatedSignature> {
+        Ok(AnnotatedSignature {
+            name: self.str()?,
+            lifetimes: self.seq(Self::lifetime)?,
+            parameters: self.seq(|d| {
+                Ok(AnnotatedParameter { name: d.str()?, param_type: d.annotated_type()? })
+            })?,
+            return_type: self.annotated_type()?,
+        })
+    }
+
+    fn summary(&mut self) -> Result<FunctionSummary> {
+        Ok(FunctionSummary {
+            name: self.str()?,
+            has_body: self.bool()?,
+            params: self.seq(|d| {
+                let name = d.str()?;
+                let flags = d.u8()?;
+                let bit = |n: u8| flags & (1 << n) != 0;
+                Ok(ParamSummary {
+                    name,
+                    writes: bit(0),
+                    escapes: bit(1),
+                    consumed: bit(2),
+                    frees: bit(3),
+                    pointer_arithmetic: bit(4),
+                    null_checked: bit(5),
+                })
+            })?,
+        })
+    }
+
+    fn annotated_struct(&mut self) -> Result<AnnotatedStruct> {
+        Ok(AnnotatedStruct {
+            name: self.str()?,
+            lifetimes: self.seq(Self::lifetime)?,
+            fields: self
+                .seq(|d| Ok(AnnotatedField { name: d.str()?, field_type: d.annotated_type()? }))?,
+        })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn sample() -> SignatureSidecar {
+        let lifetime = LifetimeParam::standard(0);
+        SignatureSidecar {
+            functions: vec![ExportedFunction {
+                signature: AnnotatedSignature {
+                    name: "first".to_string(),
+                    lifetimes: vec![lifetime.clone()],
+                    parameters: vec![
+                        AnnotatedParameter {
+                            name: "items".to_string(),
+                            param_type: AnnotatedType::Reference {
+                                inner: Box::new(AnnotatedType::Simple(HirType::Int)),
+                                mutable: false,
+                                lifetime: Some(lifetime.clone()),
+                            },
+                        },
+                        AnnotatedParameter {
+                            name: "len".to_string(),
+                            param_type: AnnotatedType::Simple(HirType::Int),
+                        },
+                    ],
+                    return_type: AnnotatedType::Simple(HirType::FunctionPointer {
+                        param_types: vec![HirType::Array {
+                            element_type: Box::new(HirType::Char),
+                            size: Some(300),
+                        }],
+                        return_type: Box::new(HirType::Union(vec![(
+                            "tag".to_string(),
+                            HirType::Enum("kind".to_string()),
+                        )])),
+                    }),
+                },
+                call_param_types: vec![
+                    HirType::Reference { inner: Box::new(HirType::Int), mutable: true },
+                    HirType::Int,
+                ],
+                summary: FunctionSummary {
+                    name: "first".to_string(),
+                    params: vec![ParamSummary {
+                        name: "items".to_string(),
+                        frees: true,
+                        null_checked: true,
+                        ..ParamSummary::default()
+                    }],
+                    has_body: true,
+                },
+                slice_args: vec![(0, 1)],
+                string_iter_params: vec![(0, false)],
+            }],
+            structs: vec![AnnotatedStruct {
+                name: "Node".to_string(),
+                lifetimes: vec![lifetime.clone()],
+                fields: vec![AnnotatedField {
+                    name: "next".to_string(),
+                    field_type: AnnotatedType::Reference {
+                        inner: Box::new(AnnotatedType::Simple(HirType::Struct("Node".to_string()))),
+                        mutable: false,
+                        lifetime: Some(lifetime),
+                    },
+                }],
+            }],
+        }
+    }
+
+    #[test]
+    fn test_roundtrip() {
+        let sidecar = sample();
+        let decoded = SignatureSidecar::from_bytes(&sidecar.to_bytes()).unwrap();
+        assert_eq!(decoded, sidecar);
+        assert!(decoded.function("first").is_some());
+        assert!(decoded.struct_lifetimes("Node").is_some());
+    }
+
+    #[test]
+    fn test_encoding_is_compact() {
+        let bytes = sample().to_bytes();
+        assert!(bytes.len() < 160, "sidecar took {} bytes", bytes.len());
+    }
+
+    #[test]
+    fn test_rejects_bad_magic_and_version() {
+        assert!(SignatureSidecar::from_bytes(b"NOTMETA!").is_err());
+
+        let mut bytes = sample().to_bytes();
+        bytes[MAGIC.len()] = FORMAT_VERSION + 1;
+        let err = SignatureSidecar::from_bytes(&bytes).unwrap_err();
+        assert!(err.to_string().contains("unsupported sidecar version"));
+    }
+
+    #[test]
+    fn test_rejects_truncated_input() {
+        let bytes = sample().to_bytes();
+        for cut in MAGIC.len()..bytes.len() {
+            assert!(SignatureSidecar::from_bytes(&bytes[..cut]).is_err(), "cut at {}", cut);
+        }
+    }
+
+    #[test]
+    fn test_write_and_read_file() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = SignatureSidecar::path_for(&dir.path().join("b.rs"));
+        assert_eq!(path.extension().unwrap(), SIDECAR_EXTENSION);
+
+        sample().write(&path).unwrap();
+        assert_eq!(SignatureSidecar::read(&path).unwrap(), sample());
+    }
+}
@@ -1,5 +1,9 @@
 
 use super::*;
+use decy_ownership::raw_pointer::{
+    expression_compares_to_null, pointer_compared_to_null, statement_compares_to_null,
+    uses_pointer_arithmetic,
+};
 
 use tempfile::TempDir;
 
@@ -1358,7 +1362,8 @@ fn test_transpile_global_variable() {
         "#;
 
     let result = transpile(c_code).unwrap();
-    assert!(result.contains("static mut global_counter"));
+    assert!(result.contains("static global_counter: std::sync::atomic::AtomicI32"));
+    assert!(result.contains("global_counter.store(global_counter.load("));
 }
 
 #[test]
@@ -1662,6 +1667,54 @@ fn test_uses_pointer_arithmetic_with_increment() {
     assert!(uses_pointer_arithmetic(&func, "p"));
 }
 
+#[test]
+fn test_call_sig_matches_signature_for_reassigned_pointer_params() {
+    use decy_hir::{BinaryOperator, HirParameter, HirType};
+    let node = HirType::Pointer(Box::new(HirType::Struct("Node".to_string())));
+    let int_ptr = HirType::Pointer(Box::new(HirType::Int));
+    let deref = |name: &str| {
+        Box::new(HirExpression::Dereference(Box::new(HirExpression::Variable(name.to_string()))))
+    };
+    // int walk(struct Node* n, int* q, int* r) { n = n->next; q++; return *q + *r; }
+    let func = HirFunction::new_with_body(
+        "walk".to_string(),
+        HirType::Int,
+        vec![
+            HirParameter::new("n".to_string(), node),
+            HirParameter::new("q".to_string(), int_ptr.clone()),
+            HirParameter::new("r".to_string(), int_ptr),
+        ],
+        vec![
+            HirStatement::Assignment {
+                target: "n".to_string(),
+                value: HirExpression::PointerFieldAccess {
+                    pointer: Box::new(HirExpression::Variable("n".to_string())),
+                    field: "next".to_string(),
+                },
+            },
+            HirStatement::Expression(HirExpression::PostIncrement {
+                operand: Box::new(HirExpression::Variable("q".to_string())),
+            }),
+            HirStatement::Return(Some(HirExpression::BinaryOp {
+                op: BinaryOperator::Add,
+                left: deref("q"),
+                right: deref("r"),
+            })),
+        ],
+    );
+
+    let summaries = OwnershipSummaries::compute(std::slice::from_ref(&func));
+    let (_, params) = function_call_sig(&func, &summaries);
+    assert!(matches!(params[0], HirType::Pointer(_)), "{:?}", params);
+    assert!(matches!(params[1], HirType::Pointer(_)), "{:?}", params);
+    assert!(matches!(params[2], HirType::Reference { .. }), "{:?}", params);
+
+    // Call sites pass what the generated signature takes
+    let code = CodeGenerator::new().generate_function(&func);
+    assert!(code.contains("mut n: *mut Node"), "{}", code);
+    assert!(code.contains("mut q: *mut i32"), "{}", code);
+}
+
 // ========================================================================
 // statement_compares_to_null: switch and for(;;)
 // ========================================================================
@@ -1705,3 +1758,98 @@ fn test_statement_compares_to_null_for_with_null_in_body() {
     };
     assert!(statement_compares_to_null(&stmt, "ptr"));
 }
+
+#[test]
+fn test_transpile_streaming_matches_batch() {
+    let c_code = r#"
+        struct Point { int x; int y; };
+        int counter = 0;
+        int sum(int* arr, int len);
+        void bump(int* p) { *p = *p + 1; counter = counter + 1; }
+        int sum(int* arr, int len) {
+            int total = 0;
+            for (int i = 0; i < len; i++) { total = total + arr[i]; }
+            return total;
+        }
+        int main() { int v = 1; bump(&v); return v; }
+    "#;
+    // Unit-wide analyses: a key comparator, a void* callback and function pointers
+    let indirect = r#"
+        void qsort(void* base, unsigned long n, unsigned long size, int (*cmp)(const void*, const void*));
+        int cmp_int(const void* a, const void* b) {
+            int x = *(const int*)a;
+            int y = *(const int*)b;
+            return x - y;
+        }
+        void incr(void* p) { int* q = (int*)p; *q = *q + 1; }
+        void call_with(void (*f)(void*), void* arg) { f(arg); }
+        int add(int a, int b) { return a + b; }
+        int mul(int a, int b) { return a * b; }
+        int apply(int (*op)(int, int), int x) { return op(x, x); }
+        int main() {
+            int v[3] = {3, 1, 2};
+            qsort(v, 3, sizeof(int), cmp_int);
+            call_with(incr, &v[0]);
+            int (*step)(int, int) = add;
+            if (v[0] > 1) { step = mul; }
+            return apply(add, step(v[0], v[1]));
+        }
+    "#;
+
+    for c_code in [c_code, indirect] {
+        let batch = transpile_with_includes(c_code, None).unwrap();
+        let mut streamed = Vec::new();
+        transpile_streaming(c_code, None, &mut streamed).unwrap();
+        assert_eq!(String::from_utf8(streamed).unwrap(), batch);
+    }
+}
+
+#[test]
+fn test_transpile_with_options_buffers_stdout() {
+    let c_code = r#"
+        int printf(const char* fmt, ...);
+        int main() {
+            for (int i = 0; i < 3; i++) { printf("%d\n", i); }
+            return 0;
+        }
+    "#;
+
+    let options = CodegenOptions { buffered_stdout: true, ..Default::default() };
+    let buffered = transpile_with_options(c_code, None, &options).unwrap();
+    assert!(buffered.contains("std::io::BufWriter::new(std::io::stdout().lock())"));
+    assert!(buffered.contains("write!(__stdout"));
+
+    let plain = transpile_with_options(c_code, None, &CodegenOptions::default()).unwrap();
+    assert_eq!(plain, transpile_with_includes(c_code, None).unwrap());
+}
+
+#[test]
+fn test_transpile_promotes_non_escaping_malloc_to_stack() {
+    let c_code = r#"
+        #include <stdlib.h>
+        struct Point { int x; int y; };
+        int scratch(int a) {
+            struct Point* p = malloc(sizeof(struct Point));
+            int* buf = malloc(16 * sizeof(int));
+            if (p == NULL) { return -1; }
+            p->x = a;
+            p->y = 2;
+            buf[0] = p->x + p->y;
+            int r = buf[0];
+            free(buf);
+            free(p);
+            return r;
+        }
+        struct Point* escape(void) {
+            struct Point* q = malloc(sizeof(struct Point));
+            q->x = 1;
+            return q;
+        }
+    "#;
+
+    let rust = transpile(c_code).unwrap();
+    assert!(rust.contains("let mut p: Point = Point::default();"), "{}", rust);
+    assert!(rust.contains("let mut buf: [i32; 16] = [0i32; 16];"), "{}", rust);
+    assert!(rust.contains("p.x = a;"), "{}", rust);
+    assert!(rust.contains("Box"), "returned allocation stays on the heap:\n{}", rust);
+}
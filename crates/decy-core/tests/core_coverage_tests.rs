@@ -160,7 +160,10 @@ fn core_coverage_global_unsigned_int_default() {
     let result = decy_core::transpile(c_code);
     assert!(result.is_ok());
     let code = result.unwrap();
-    assert!(code.contains("static mut flags"), "Should declare flags as static mut");
+    assert!(
+        code.contains("static flags: std::sync::atomic::AtomicU32"),
+        "Should declare flags as an atomic"
+    );
 }
 
 #[test]
@@ -196,7 +199,7 @@ fn core_coverage_global_char_default() {
     let result = decy_core::transpile(c_code);
     assert!(result.is_ok());
     let code = result.unwrap();
-    assert!(code.contains("static mut letter"));
+    assert!(code.contains("static letter: std::sync::atomic::AtomicU8"));
 }
 
 #[test]
@@ -237,7 +240,7 @@ fn core_coverage_global_int_array_default() {
     let result = decy_core::transpile(c_code);
     assert!(result.is_ok());
     let code = result.unwrap();
-    assert!(code.contains("static mut data"));
+    assert!(code.contains("static data: [i32; 10]"), "Read-only table is a plain static");
 }
 
 #[test]
@@ -800,7 +803,12 @@ fn core_coverage_extern_with_initializer_kept() {
 fn core_coverage_errno_global() {
     let c_code = "int main() { return 0; }";
     let result = decy_core::transpile(c_code).unwrap();
-    assert!(result.contains("ERRNO"), "Should always include ERRNO global variable");
+    assert!(!result.contains("ERRNO"), "ERRNO is only declared when errno is used");
+
+    let c_code = "int main() { errno = 0; return errno; }";
+    let result = decy_core::transpile(c_code).unwrap();
+    assert!(result.contains("static ERRNO: std::cell::Cell<i32>"), "{}", result);
+    assert!(!result.contains("static mut ERRNO"), "{}", result);
 }
 
 // ============================================================================
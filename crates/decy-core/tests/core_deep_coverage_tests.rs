@@ -1258,8 +1258,8 @@ fn deep_transpile_comprehensive_c_program() {
     assert!(rust.contains("fn area"), "Should contain area function");
     assert!(rust.contains("fn main"), "Should contain main");
     assert!(
-        rust.contains("ERRNO") || rust.contains("static mut"),
-        "Should contain errno or static mut globals"
+        rust.contains("const default_width: i32 = 800;"),
+        "Read-only scalar globals should be consts"
     );
 }
 
@@ -1368,10 +1368,15 @@ fn deep_transpile_nested_if() {
 
 #[test]
 fn deep_transpile_errno_generation() {
-    // Every transpilation should generate the ERRNO global
+    // ERRNO is a thread-local cell, declared only when errno is used
     let c_code = "int main() { return 0; }";
     let result = transpile(c_code).unwrap();
-    assert!(result.contains("ERRNO"), "Should generate ERRNO static variable");
+    assert!(!result.contains("ERRNO"), "Should not generate an unused ERRNO");
+
+    let c_code = "int main() { if (errno != 0) { return 1; } return 0; }";
+    let result = transpile(c_code).unwrap();
+    assert!(result.contains("thread_local!"), "Should generate ERRNO thread-local");
+    assert!(result.contains("ERRNO.get()"), "Should read ERRNO through the cell");
 }
 
 // ============================================================================
@@ -0,0 +1,82 @@
+//! Cross-translation-unit ownership sidecar tests.
+//!
+//! A unit that only declares a function must pick up the defining unit's
+//! ownership facts from its sidecar instead of guessing from the prototype.
+
+use decy_core::sidecar::SignatureSidecar;
+use decy_core::transpile_with_sidecars;
+use decy_ownership::summary::ParamEffect;
+
+const B_C: &str = r#"
+#include <stdlib.h>
+
+void fill(int* out, int value) {
+    *out = value;
+}
+
+int first_or_zero(int* items) {
+    if (items == 0) {
+        return 0;
+    }
+    return *items;
+}
+
+void release(int* p) {
+    free(p);
+}
+"#;
+
+const A_C: &str = r#"
+void fill(int* out, int value);
+int first_or_zero(int* items);
+void release(int* p);
+
+int use_b(int* slot, int* owned) {
+    fill(slot, 7);
+    release(owned);
+    return first_or_zero(slot);
+}
+"#;
+
+#[test]
+fn test_sidecar_exports_defined_functions() {
+    let (_rust, sidecar) = transpile_with_sidecars(B_C, None, &[]).expect("b.c transpiles");
+
+    let fill = sidecar.function("fill").expect("fill exported");
+    assert_eq!(fill.summary.param(0).unwrap().effect(), ParamEffect::BorrowedMut);
+
+    let first = sidecar.function("first_or_zero").expect("first_or_zero exported");
+    assert!(first.summary.param(0).unwrap().needs_raw_pointer());
+
+    let release = sidecar.function("release").expect("release exported");
+    assert_eq!(release.summary.param(0).unwrap().effect(), ParamEffect::Freed);
+}
+
+#[test]
+fn test_sidecar_roundtrips_through_bytes() {
+    let (_rust, sidecar) = transpile_with_sidecars(B_C, None, &[]).expect("b.c transpiles");
+    let decoded = SignatureSidecar::from_bytes(&sidecar.to_bytes()).expect("decodes");
+    assert_eq!(decoded, sidecar);
+}
+
+#[test]
+fn test_dependent_unit_uses_imported_summaries() {
+    let (_b_rust, b_meta) = transpile_with_sidecars(B_C, None, &[]).expect("b.c transpiles");
+    let (_a_rust, a_meta) = transpile_with_sidecars(A_C, None, &[b_meta]).expect("a.c transpiles");
+
+    let use_b = a_meta.function("use_b").expect("use_b exported");
+    let slot = use_b.summary.param_named("slot").unwrap();
+    let owned = use_b.summary.param_named("owned").unwrap();
+    assert!(slot.writes, "write inherited from fill() in b.c");
+    assert_eq!(owned.effect(), ParamEffect::Freed, "free inherited from release() in b.c");
+
+    // Prototypes are not re-exported
+    assert!(a_meta.function("fill").is_none());
+}
+
+#[test]
+fn test_without_sidecar_prototypes_look_borrowed() {
+    let (_rust, a_meta) = transpile_with_sidecars(A_C, None, &[]).expect("a.c transpiles");
+    let use_b = a_meta.function("use_b").expect("use_b exported");
+    assert_eq!(use_b.summary.param_named("owned").unwrap().effect(), ParamEffect::Borrowed);
+}
@@ -228,3 +228,58 @@ fn test_build_order_integration() {
     assert!(types_pos < utils_pos, "types.h before utils.h");
     assert!(utils_pos < main_pos, "utils.h before main.c");
 }
+
+#[test]
+fn test_translation_unit_dependencies_follow_headers() {
+    // a.c includes b.h, so a.c depends on b.c (where b.h is implemented)
+    let temp = TempDir::new().unwrap();
+    let b_c =
+        create_temp_c_file(&temp, "b.c", "#include \"b.h\"\nint twice(int x) { return 2 * x; }");
+    let a_c = create_temp_c_file(&temp, "a.c", "#include \"b.h\"\nint main() { return twice(1); }");
+    let c_c = create_temp_c_file(&temp, "c.c", "int standalone() { return 0; }");
+
+    let files = vec![a_c.clone(), b_c.clone(), c_c.clone()];
+    let graph = DependencyGraph::from_translation_units(&files).expect("Should build graph");
+
+    assert!(graph.has_dependency(&a_c, &b_c), "a.c should depend on b.c");
+    assert!(!graph.has_dependency(&b_c, &b_c), "No self dependency");
+    assert_eq!(graph.dependencies_of(&a_c), vec![b_c.clone()]);
+    assert!(graph.dependencies_of(&c_c).is_empty());
+}
+
+#[test]
+fn test_build_waves_group_independent_files() {
+    let mut graph = DependencyGraph::new();
+    let base = PathBuf::from("/tmp/base.c");
+    let left = PathBuf::from("/tmp/left.c");
+    let right = PathBuf::from("/tmp/right.c");
+    let top = PathBuf::from("/tmp/top.c");
+    for file in [&base, &left, &right, &top] {
+        graph.add_file(file);
+    }
+    graph.add_dependency(&left, &base);
+    graph.add_dependency(&right, &base);
+    graph.add_dependency(&top, &left);
+    graph.add_dependency(&top, &right);
+
+    let waves = graph.build_waves();
+    assert_eq!(waves, vec![vec![base], vec![left, right], vec![top]]);
+}
+
+#[test]
+fn test_build_waves_tolerate_cycles() {
+    // Mutually including units are built together instead of failing
+    let mut graph = DependencyGraph::new();
+    let a = PathBuf::from("/tmp/a.c");
+    let b = PathBuf::from("/tmp/b.c");
+    let main = PathBuf::from("/tmp/main.c");
+    for file in [&a, &b, &main] {
+        graph.add_file(file);
+    }
+    graph.add_dependency(&a, &b);
+    graph.add_dependency(&b, &a);
+    graph.add_dependency(&main, &a);
+
+    let waves = graph.build_waves();
+    assert_eq!(waves, vec![vec![a, b], vec![main]]);
+}
@@ -186,6 +186,38 @@ fn test_realloc_resize_pattern() {
     assert!(unsafe_count <= 6, "realloc should minimize unsafe (found {})", unsafe_count);
 }
 
+#[test]
+fn test_realloc_growth_loop_sized_by_dereference() {
+    // Dynamic array sized with `sizeof *p`, which has no parentheses
+    let c_code = r#"
+        #include <stdlib.h>
+
+        int squares(int n) {
+            int len = 0;
+            int cap = 4;
+            int* p = malloc(cap * sizeof *p);
+
+            for (int i = 0; i < n; i++) {
+                if (len == cap) {
+                    cap = cap * 2;
+                    p = realloc(p, cap * sizeof *p);
+                }
+                p[len++] = i * i;
+            }
+
+            int last = p[len - 1];
+            free(p);
+            return last;
+        }
+    "#;
+
+    let result = transpile(c_code).expect("Should transpile");
+
+    assert!(result.contains("Vec::with_capacity"), "Should start a Vec:\n{}", result);
+    assert!(result.contains("p.push(i * i)"), "Should append with push:\n{}", result);
+    assert!(!result.contains("realloc("), "Vec::push replaces realloc:\n{}", result);
+}
+
 // ============================================================================
 // RED PHASE: Struct Allocation
 // ============================================================================
@@ -0,0 +1,103 @@
+//! Peak-memory regression test for the streaming transpilation pipeline.
+//!
+//! Runs in its own test binary so the tracking allocator only sees these
+//! tests, which take turns measuring. Peak live heap is what the process's
+//! max RSS follows.
+
+use decy_core::{transpile_streaming, transpile_with_includes};
+use decy_synth::{generate, SynthConfig};
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Mutex;
+
+/// System allocator wrapper tracking live and peak heap bytes.
+struct PeakAllocator;
+
+static LIVE: AtomicUsize = AtomicUsize::new(0);
+static PEAK: AtomicUsize = AtomicUsize::new(0);
+static MEASURING: Mutex<()> = Mutex::new(());
+
+fn grow(bytes: usize) {
+    let live = LIVE.fetch_add(bytes, Ordering::Relaxed) + bytes;
+    PEAK.fetch_max(live, Ordering::Relaxed);
+}
+
+#[allow(unsafe_code)]
+unsafe impl GlobalAlloc for PeakAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        grow(layout.size());
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        LIVE.fetch_sub(layout.size(), Ordering::Relaxed);
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        if new_size > layout.size() {
+            grow(new_size - layout.size());
+        } else {
+            LIVE.fetch_sub(layout.size() - new_size, Ordering::Relaxed);
+        }
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: PeakAllocator = PeakAllocator;
+
+/// Peak heap growth above the live heap at entry while running `f`.
+fn peak_growth(f: impl FnOnce()) -> usize {
+    let base = LIVE.load(Ordering::Relaxed);
+    PEAK.store(base, Ordering::Relaxed);
+    f();
+    PEAK.load(Ordering::Relaxed) - base
+}
+
+/// Streaming peak beyond the AST stays under half of the batch's.
+fn assert_streaming_below_batch(source: &str) {
+    let _turn = MEASURING.lock().unwrap_or_else(|e| e.into_inner());
+
+    // The parsed AST is alive in both modes; measure it on its own
+    let parser = decy_parser::CParser::new().unwrap();
+    let ast_peak = peak_growth(|| drop(parser.parse(source).unwrap()));
+
+    let mut batch_len = 0;
+    let batch_peak =
+        peak_growth(|| batch_len = transpile_with_includes(source, None).unwrap().len());
+    let streaming_peak =
+        peak_growth(|| transpile_streaming(source, None, &mut std::io::sink()).unwrap());
+
+    // The batch output alone outweighs everything streaming keeps per function
+    assert!(batch_len > 0);
+    let batch_extra = batch_peak.saturating_sub(ast_peak);
+    let streaming_extra = streaming_peak.saturating_sub(ast_peak);
+    assert!(
+        streaming_extra * 2 < batch_extra,
+        "streaming used {streaming_extra} bytes beyond the AST, batch {batch_extra}"
+    );
+}
+
+#[test]
+fn test_streaming_peak_memory_stays_below_batch() {
+    let source = generate(&SynthConfig { functions: 400, ..SynthConfig::default() }).flattened();
+    assert_streaming_below_batch(&source);
+}
+
+#[test]
+fn test_streaming_peak_memory_with_function_pointers() {
+    // A callback parameter and a function-pointer local bring in the
+    // unit-wide dispatch and void* analyses
+    let mut source =
+        generate(&SynthConfig { functions: 400, ..SynthConfig::default() }).flattened();
+    source.push_str(
+        "int twice(int x) { return x * 2; }\n\
+         int apply_callback(int (*op)(int), int x) { return op(x); }\n\
+         int run_callbacks(int x) {\n\
+             int (*step)(int) = twice;\n\
+             return apply_callback(twice, step(x));\n\
+         }\n",
+    );
+    assert_streaming_below_batch(&source);
+}
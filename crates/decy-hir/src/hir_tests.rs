@@ -215,4 +215,27 @@ mod tests {
         assert_eq!(hir_func.parameters()[2].param_type(), &HirType::Double);
         assert_eq!(hir_func.parameters()[3].param_type(), &HirType::Char);
     }
+
+    #[test]
+    fn test_function_body_is_copy_on_write() {
+        let func = HirFunction::new_with_body(
+            "f".to_string(),
+            HirType::Int,
+            vec![],
+            vec![HirStatement::Return(Some(HirExpression::IntLiteral(0)))],
+        );
+
+        let renamed = func.with_parameters(vec![HirParameter::new("n".to_string(), HirType::Int)]);
+        let mut edited = func.clone();
+        assert!(renamed.shares_body_with(&func));
+        assert!(edited.shares_body_with(&func));
+
+        edited.body_mut().push(HirStatement::Break);
+        assert!(!edited.shares_body_with(&func));
+        assert_eq!(func.body().len(), 1, "mutation must not leak into the original");
+        assert_eq!(edited.body().len(), 2);
+
+        let declaration = HirFunction::new("g".to_string(), HirType::Void, vec![]);
+        assert!(!declaration.with_parameters(vec![]).has_body());
+    }
 }
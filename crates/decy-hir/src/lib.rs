@@ -26,6 +26,10 @@
 #[allow(unused_macros)]
 mod generated_contracts;
 
+pub mod visit;
+
+use std::sync::Arc;
+
 /// Represents a C type in HIR.
 #[derive(Debug, Clone, PartialEq, Eq)]
 pub enum HirType {
@@ -783,12 +787,15 @@ pub enum HirCudaQualifier {
 }
 
 /// Represents a function in HIR.
+///
+/// The body is reference-counted so cloning a function, or deriving a new one
+/// that only changes the signature, shares the statements instead of copying them.
 #[derive(Debug, Clone, PartialEq)]
 pub struct HirFunction {
     name: String,
     return_type: HirType,
     parameters: Vec<HirParameter>,
-    body: Option<Vec<HirStatement>>,
+    body: Option<Arc<Vec<HirStatement>>>,
     /// CUDA qualifier (DECY-199), None for plain C/C++ functions
     cuda_qualifier: Option<HirCudaQualifier>,
 }
@@ -853,7 +860,7 @@ impl HirFunction {
         let body = if ast_func.body.is_empty() {
             None
         } else {
-            Some(ast_func.body.iter().map(HirStatement::from_ast_statement).collect())
+            Some(Arc::new(ast_func.body.iter().map(HirStatement::from_ast_statement).collect()))
         };
 
         let cuda_qualifier = ast_func.cuda_qualifier.map(|q| match q {
@@ -902,12 +909,70 @@ impl HirFunction {
         parameters: Vec<HirParameter>,
         body: Vec<HirStatement>,
     ) -> Self {
-        Self { name, return_type, parameters, body: Some(body), cuda_qualifier: None }
+        Self { name, return_type, parameters, body: Some(Arc::new(body)), cuda_qualifier: None }
     }
 
     /// Get the function body.
     pub fn body(&self) -> &[HirStatement] {
-        self.body.as_deref().unwrap_or(&[])
+        self.body.as_deref().map_or(&[], Vec::as_slice)
+    }
+
+    /// Get mutable access to the function body, copying it first if it is shared.
+    ///
+    /// A declaration without a body becomes a definition with an empty body.
+    pub fn body_mut(&mut self) -> &mut Vec<HirStatement> {
+        Arc::make_mut(self.body.get_or_insert_with(Default::default))
+    }
+
+    /// Derive a function with new parameters that shares this function's body.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use decy_hir::{HirFunction, HirParameter, HirStatement, HirType};
+    ///
+    /// let func = HirFunction::new_with_body(
+    ///     "f".to_string(),
+    ///     HirType::Void,
+    ///     vec![],
+    ///     vec![HirStatement::Return(None)],
+    /// );
+    /// let with_param =
+    ///     func.with_parameters(vec![HirParameter::new("n".to_string(), HirType::Int)]);
+    ///
+    /// assert_eq!(with_param.parameters().len(), 1);
+    /// assert!(with_param.shares_body_with(&func));
+    /// ```
+    pub fn with_parameters(&self, parameters: Vec<HirParameter>) -> Self {
+        Self {
+            name: self.name.clone(),
+            return_type: self.return_type.clone(),
+            parameters,
+            body: self.body.clone(),
+            cuda_qualifier: self.cuda_qualifier,
+        }
+    }
+
+    /// Derive a function with the same signature and a replacement body.
+    pub fn with_body(&self, body: Vec<HirStatement>) -> Self {
+        Self {
+            name: self.name.clone(),
+            return_type: self.return_type.clone(),
+            parameters: self.parameters.clone(),
+            body: Some(Arc::new(body)),
+            cuda_qualifier: self.cuda_qualifier,
+        }
+    }
+
+    /// Check whether two functions share the same body allocation.
+    ///
+    /// Passes use this to confirm an unchanged body was not copied.
+    pub fn shares_body_with(&self, other: &HirFunction) -> bool {
+        match (&self.body, &other.body) {
+            (Some(a), Some(b)) => Arc::ptr_eq(a, b),
+            (None, None) => true,
+            _ => false,
+        }
     }
 
     /// DECY-190: Check if this function has a body (is a definition, not just a declaration).
@@ -1653,3 +1718,7 @@ mod macro_definition_tests;
 #[cfg(test)]
 #[path = "coverage_tests.rs"]
 mod coverage_tests;
+
+#[cfg(test)]
+#[path = "visit_tests.rs"]
+mod visit_tests;
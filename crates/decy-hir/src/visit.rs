@@ -0,0 +1,490 @@
+//! Generic traversal over HIR statements and expressions.
+//!
+//! [`Visitor`] observes a body without changing it and [`Fold`] rebuilds it.
+//! Both share one definition of "the children of a node", so analyses stop
+//! hand-writing recursive walks that silently skip `Switch`, `For` or
+//! less common expression forms.
+//!
+//! Visitors only supply per-node hooks; the traversal itself lives in
+//! [`walk_statements`]. That lets several analyses share a single pass: a
+//! tuple, slice or `&mut` of visitors is itself a visitor that forwards every
+//! hook to each member in order.
+//!
+//! # Examples
+//!
+//! ```
+//! use decy_hir::visit::{walk_statements, Visitor};
+//! use decy_hir::{HirExpression, HirStatement};
+//!
+//! #[derive(Default)]
+//! struct CountVariables(usize);
+//!
+//! impl Visitor for CountVariables {
+//!     fn visit_expression(&mut self, expr: &HirExpression) {
+//!         if matches!(expr, HirExpression::Variable(_)) {
+//!             self.0 += 1;
+//!         }
+//!     }
+//! }
+//!
+//! #[derive(Default)]
+//! struct CountReturns(usize);
+//!
+//! impl Visitor for CountReturns {
+//!     fn visit_statement(&mut self, stmt: &HirStatement) {
+//!         if matches!(stmt, HirStatement::Return(_)) {
+//!             self.0 += 1;
+//!         }
+//!     }
+//! }
+//!
+//! let body = vec![
+//!     HirStatement::Expression(HirExpression::Variable("x".to_string())),
+//!     HirStatement::Return(Some(HirExpression::Variable("y".to_string()))),
+//! ];
+//!
+//! // Both analyses run in one traversal
+//! let mut fused = (CountVariables::default(), CountReturns::default());
+//! walk_statements(&mut fused, &body);
+//! assert_eq!(fused.0 .0, 2);
+//! assert_eq!(fused.1 .0, 1);
+//! ```
+
+use crate::{HirExpression, HirStatement, SwitchCase};
+
+/// Read-only per-node hooks driven by [`walk_statements`].
+///
+/// Statements are visited before their children and left after them;
+/// expressions are visited before their children. Statement-level
+/// identifiers that are not expressions, such as an assignment target or a
+/// declared name, are only reachable through the statement hook.
+pub trait Visitor {
+    /// Called before a statement's children are walked.
+    fn visit_statement(&mut self, _stmt: &HirStatement) {}
+
+    /// Called after a statement's children have been walked.
+    fn leave_statement(&mut self, _stmt: &HirStatement) {}
+
+    /// Called before an expression's children are walked.
+    fn visit_expression(&mut self, _expr: &HirExpression) {}
+}
+
+/// Walk every statement in a block, including all nested blocks and expressions.
+pub fn walk_statements<V: Visitor + ?Sized>(visitor: &mut V, stmts: &[HirStatement]) {
+    for stmt in stmts {
+        walk_statement(visitor, stmt);
+    }
+}
+
+/// Walk a statement and everything below it.
+pub fn walk_statement<V: Visitor + ?Sized>(visitor: &mut V, stmt: &HirStatement) {
+    visitor.visit_statement(stmt);
+    match stmt {
+        HirStatement::VariableDeclaration { initializer, .. } => {
+            if let Some(init) = initializer {
+                walk_expression(visitor, init);
+            }
+        }
+        HirStatement::Return(expr) => {
+            if let Some(expr) = expr {
+                walk_expression(visitor, expr);
+            }
+        }
+        HirStatement::If { condition, then_block, else_block } => {
+            walk_expression(visitor, condition);
+            walk_statements(visitor, then_block);
+            if let Some(block) = else_block {
+                walk_statements(visitor, block);
+            }
+        }
+        HirStatement::While { condition, body } => {
+            walk_expression(visitor, condition);
+            walk_statements(visitor, body);
+        }
+        HirStatement::For { init, condition, increment, body } => {
+            walk_statements(visitor, init);
+            if let Some(cond) = condition {
+                walk_expression(visitor, cond);
+            }
+            walk_statements(visitor, body);
+            walk_statements(visitor, increment);
+        }
+        HirStatement::Switch { condition, cases, default_case } => {
+            walk_expression(visitor, condition);
+            for case in cases {
+                if let Some(value) = &case.value {
+                    walk_expression(visitor, value);
+                }
+                walk_statements(visitor, &case.body);
+            }
+            if let Some(block) = default_case {
+                walk_statements(visitor, block);
+            }
+        }
+        HirStatement::Assignment { value, .. } => walk_expression(visitor, value),
+        HirStatement::DerefAssignment { target, value } => {
+            walk_expression(visitor, target);
+            walk_expression(visitor, value);
+        }
+        HirStatement::ArrayIndexAssignment { array, index, value } => {
+            walk_expression(visitor, array);
+            walk_expression(visitor, index);
+            walk_expression(visitor, value);
+        }
+        HirStatement::FieldAssignment { object, value, .. } => {
+            walk_expression(visitor, object);
+            walk_expression(visitor, value);
+        }
+        HirStatement::Free { pointer } => walk_expression(visitor, pointer),
+        HirStatement::Expression(expr) => walk_expression(visitor, expr),
+        HirStatement::Break | HirStatement::Continue | HirStatement::InlineAsm { .. } => {}
+    }
+    visitor.leave_statement(stmt);
+}
+
+/// Walk an expression and all of its subexpressions in pre-order.
+pub fn walk_expression<V: Visitor + ?Sized>(visitor: &mut V, expr: &HirExpression) {
+    visitor.visit_expression(expr);
+    match expr {
+        HirExpression::BinaryOp { left, right, .. } => {
+            walk_expression(visitor, left);
+            walk_expression(visitor, right);
+        }
+        HirExpression::Dereference(inner)
+        | HirExpression::AddressOf(inner)
+        | HirExpression::IsNotNull(inner)
+        | HirExpression::UnaryOp { operand: inner, .. }
+        | HirExpression::PostIncrement { operand: inner }
+        | HirExpression::PreIncrement { operand: inner }
+        | HirExpression::PostDecrement { operand: inner }
+        | HirExpression::PreDecrement { operand: inner }
+        | HirExpression::FieldAccess { object: inner, .. }
+        | HirExpression::PointerFieldAccess { pointer: inner, .. }
+        | HirExpression::Calloc { count: inner, .. }
+        | HirExpression::Malloc { size: inner }
+        | HirExpression::Cast { expr: inner, .. }
+        | HirExpression::CxxDelete { operand: inner } => walk_expression(visitor, inner),
+        HirExpression::ArrayIndex { array, index }
+        | HirExpression::SliceIndex { slice: array, index, .. } => {
+            walk_expression(visitor, array);
+            walk_expression(visitor, index);
+        }
+        HirExpression::Realloc { pointer, new_size } => {
+            walk_expression(visitor, pointer);
+            walk_expression(visitor, new_size);
+        }
+        HirExpression::FunctionCall { arguments, .. }
+        | HirExpression::CompoundLiteral { initializers: arguments, .. }
+        | HirExpression::CxxNew { arguments, .. } => {
+            for arg in arguments {
+                walk_expression(visitor, arg);
+            }
+        }
+        HirExpression::StringMethodCall { receiver, arguments, .. } => {
+            walk_expression(visitor, receiver);
+            for arg in arguments {
+                walk_expression(visitor, arg);
+            }
+        }
+        HirExpression::Ternary { condition, then_expr, else_expr } => {
+            walk_expression(visitor, condition);
+            walk_expression(visitor, then_expr);
+            walk_expression(visitor, else_expr);
+        }
+        HirExpression::IntLiteral(_)
+        | HirExpression::FloatLiteral(_)
+        | HirExpression::StringLiteral(_)
+        | HirExpression::CharLiteral(_)
+        | HirExpression::Variable(_)
+        | HirExpression::Sizeof { .. }
+        | HirExpression::NullLiteral => {}
+    }
+}
+
+impl<V: Visitor + ?Sized> Visitor for &mut V {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        (**self).visit_statement(stmt);
+    }
+
+    fn leave_statement(&mut self, stmt: &HirStatement) {
+        (**self).leave_statement(stmt);
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        (**self).visit_expression(expr);
+    }
+}
+
+impl<V: Visitor + ?Sized> Visitor for Box<V> {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        (**self).visit_statement(stmt);
+    }
+
+    fn leave_statement(&mut self, stmt: &HirStatement) {
+        (**self).leave_statement(stmt);
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        (**self).visit_expression(expr);
+    }
+}
+
+/// An optional visitor lets a fused pass switch members off: `None` skips every hook.
+impl<V: Visitor> Visitor for Option<V> {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        if let Some(v) = self {
+            v.visit_statement(stmt);
+        }
+    }
+
+    fn leave_statement(&mut self, stmt: &HirStatement) {
+        if let Some(v) = self {
+            v.leave_statement(stmt);
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        if let Some(v) = self {
+            v.visit_expression(expr);
+        }
+    }
+}
+
+/// A slice of visitors fuses them: each hook runs on every element in order.
+impl<V: Visitor> Visitor for [V] {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        self.iter_mut().for_each(|v| v.visit_statement(stmt));
+    }
+
+    fn leave_statement(&mut self, stmt: &HirStatement) {
+        self.iter_mut().for_each(|v| v.leave_statement(stmt));
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        self.iter_mut().for_each(|v| v.visit_expression(expr));
+    }
+}
+
+macro_rules! fused_visitor {
+    ($($v:ident),+) => {
+        /// A tuple of visitors fuses them: each hook runs on every member in order.
+        #[allow(non_snake_case)]
+        impl<$($v: Visitor),+> Visitor for ($($v,)+) {
+            fn visit_statement(&mut self, stmt: &HirStatement) {
+                let ($($v,)+) = self;
+                $($v.visit_statement(stmt);)+
+            }
+
+            fn leave_statement(&mut self, stmt: &HirStatement) {
+                let ($($v,)+) = self;
+                $($v.leave_statement(stmt);)+
+            }
+
+            fn visit_expression(&mut self, expr: &HirExpression) {
+                let ($($v,)+) = self;
+                $($v.visit_expression(expr);)+
+            }
+        }
+    };
+}
+
+fused_visitor!(A, B);
+fused_visitor!(A, B, C);
+fused_visitor!(A, B, C, D);
+fused_visitor!(A, B, C, D, E);
+fused_visitor!(A, B, C, D, E, F);
+
+/// Owning rewrite of HIR, node by node.
+///
+/// Override a hook to rewrite the nodes you care about and call the matching
+/// `fold_*_children` function to keep descending. The defaults rebuild the
+/// node from its folded children, reusing existing boxes.
+pub trait Fold {
+    /// Rewrite a statement; the default folds its children.
+    fn fold_statement(&mut self, stmt: HirStatement) -> HirStatement {
+        fold_statement_children(self, stmt)
+    }
+
+    /// Rewrite an expression; the default folds its children.
+    fn fold_expression(&mut self, expr: HirExpression) -> HirExpression {
+        fold_expression_children(self, expr)
+    }
+
+    /// Rewrite a block; the default folds each statement in place.
+    fn fold_block(&mut self, block: Vec<HirStatement>) -> Vec<HirStatement> {
+        block.into_iter().map(|stmt| self.fold_statement(stmt)).collect()
+    }
+}
+
+/// Fold every child of `stmt` with `folder`, keeping the statement's own shape.
+pub fn fold_statement_children<F: Fold + ?Sized>(
+    folder: &mut F,
+    stmt: HirStatement,
+) -> HirStatement {
+    match stmt {
+        HirStatement::VariableDeclaration { name, var_type, initializer } => {
+            HirStatement::VariableDeclaration {
+                name,
+                var_type,
+                initializer: initializer.map(|e| folder.fold_expression(e)),
+            }
+        }
+        HirStatement::Return(expr) => HirStatement::Return(expr.map(|e| folder.fold_expression(e))),
+        HirStatement::If { condition, then_block, else_block } => HirStatement::If {
+            condition: folder.fold_expression(condition),
+            then_block: folder.fold_block(then_block),
+            else_block: else_block.map(|block| folder.fold_block(block)),
+        },
+        HirStatement::While { condition, body } => HirStatement::While {
+            condition: folder.fold_expression(condition),
+            body: folder.fold_block(body),
+        },
+        HirStatement::For { init, condition, increment, body } => HirStatement::For {
+            init: folder.fold_block(init),
+            condition: condition.map(|c| folder.fold_expression(c)),
+            increment: folder.fold_block(increment),
+            body: folder.fold_block(body),
+        },
+        HirStatement::Switch { condition, cases, default_case } => HirStatement::Switch {
+            condition: folder.fold_expression(condition),
+            cases: cases
+                .into_iter()
+                .map(|case| SwitchCase {
+                    value: case.value.map(|v| folder.fold_expression(v)),
+                    body: folder.fold_block(case.body),
+                })
+                .collect(),
+            default_case: default_case.map(|block| folder.fold_block(block)),
+        },
+        HirStatement::Assignment { target, value } => {
+            HirStatement::Assignment { target, value: folder.fold_expression(value) }
+        }
+        HirStatement::DerefAssignment { target, value } => HirStatement::DerefAssignment {
+            target: folder.fold_expression(target),
+            value: folder.fold_expression(value),
+        },
+        HirStatement::ArrayIndexAssignment { array, index, value } => {
+            HirStatement::ArrayIndexAssignment {
+                array: fold_box(folder, array),
+                index: fold_box(folder, index),
+                value: folder.fold_expression(value),
+            }
+        }
+        HirStatement::FieldAssignment { object, field, value } => HirStatement::FieldAssignment {
+            object: folder.fold_expression(object),
+            field,
+            value: folder.fold_expression(value),
+        },
+        HirStatement::Free { pointer } => {
+            HirStatement::Free { pointer: folder.fold_expression(pointer) }
+        }
+        HirStatement::Expression(expr) => HirStatement::Expression(folder.fold_expression(expr)),
+        stmt @ (HirStatement::Break | HirStatement::Continue | HirStatement::InlineAsm { .. }) => {
+            stmt
+        }
+    }
+}
+
+/// Fold every subexpression of `expr` with `folder`, keeping the node's own shape.
+pub fn fold_expression_children<F: Fold + ?Sized>(
+    folder: &mut F,
+    expr: HirExpression,
+) -> HirExpression {
+    match expr {
+        HirExpression::BinaryOp { op, left, right } => HirExpression::BinaryOp {
+            op,
+            left: fold_box(folder, left),
+            right: fold_box(folder, right),
+        },
+        HirExpression::Dereference(inner) => HirExpression::Dereference(fold_box(folder, inner)),
+        HirExpression::AddressOf(inner) => HirExpression::AddressOf(fold_box(folder, inner)),
+        HirExpression::IsNotNull(inner) => HirExpression::IsNotNull(fold_box(folder, inner)),
+        HirExpression::UnaryOp { op, operand } => {
+            HirExpression::UnaryOp { op, operand: fold_box(folder, operand) }
+        }
+        HirExpression::PostIncrement { operand } => {
+            HirExpression::PostIncrement { operand: fold_box(folder, operand) }
+        }
+        HirExpression::PreIncrement { operand } => {
+            HirExpression::PreIncrement { operand: fold_box(folder, operand) }
+        }
+        HirExpression::PostDecrement { operand } => {
+            HirExpression::PostDecrement { operand: fold_box(folder, operand) }
+        }
+        HirExpression::PreDecrement { operand } => {
+            HirExpression::PreDecrement { operand: fold_box(folder, operand) }
+        }
+        HirExpression::FunctionCall { function, arguments } => {
+            HirExpression::FunctionCall { function, arguments: fold_all(folder, arguments) }
+        }
+        HirExpression::FieldAccess { object, field } => {
+            HirExpression::FieldAccess { object: fold_box(folder, object), field }
+        }
+        HirExpression::PointerFieldAccess { pointer, field } => {
+            HirExpression::PointerFieldAccess { pointer: fold_box(folder, pointer), field }
+        }
+        HirExpression::ArrayIndex { array, index } => HirExpression::ArrayIndex {
+            array: fold_box(folder, array),
+            index: fold_box(folder, index),
+        },
+        HirExpression::SliceIndex { slice, index, element_type } => HirExpression::SliceIndex {
+            slice: fold_box(folder, slice),
+            index: fold_box(folder, index),
+            element_type,
+        },
+        HirExpression::Calloc { count, element_type } => {
+            HirExpression::Calloc { count: fold_box(folder, count), element_type }
+        }
+        HirExpression::Malloc { size } => HirExpression::Malloc { size: fold_box(folder, size) },
+        HirExpression::Realloc { pointer, new_size } => HirExpression::Realloc {
+            pointer: fold_box(folder, pointer),
+            new_size: fold_box(folder, new_size),
+        },
+        HirExpression::StringMethodCall { receiver, method, arguments } => {
+            HirExpression::StringMethodCall {
+                receiver: fold_box(folder, receiver),
+                method,
+                arguments: fold_all(folder, arguments),
+            }
+        }
+        HirExpression::Cast { target_type, expr } => {
+            HirExpression::Cast { target_type, expr: fold_box(folder, expr) }
+        }
+        HirExpression::CompoundLiteral { literal_type, initializers } => {
+            HirExpression::CompoundLiteral {
+                literal_type,
+                initializers: fold_all(folder, initializers),
+            }
+        }
+        HirExpression::Ternary { condition, then_expr, else_expr } => HirExpression::Ternary {
+            condition: fold_box(folder, condition),
+            then_expr: fold_box(folder, then_expr),
+            else_expr: fold_box(folder, else_expr),
+        },
+        HirExpression::CxxNew { allocated_type, arguments } => {
+            HirExpression::CxxNew { allocated_type, arguments: fold_all(folder, arguments) }
+        }
+        HirExpression::CxxDelete { operand } => {
+            HirExpression::CxxDelete { operand: fold_box(folder, operand) }
+        }
+        leaf @ (HirExpression::IntLiteral(_)
+        | HirExpression::FloatLiteral(_)
+        | HirExpression::StringLiteral(_)
+        | HirExpression::CharLiteral(_)
+        | HirExpression::Variable(_)
+        | HirExpression::Sizeof { .. }
+        | HirExpression::NullLiteral) => leaf,
+    }
+}
+
+/// Fold a boxed expression, reusing its allocation for the result.
+fn fold_box<F: Fold + ?Sized>(folder: &mut F, mut boxed: Box<HirExpression>) -> Box<HirExpression> {
+    let expr = std::mem::replace(&mut *boxed, HirExpression::NullLiteral);
+    *boxed = folder.fold_expression(expr);
+    boxed
+}
+
+/// Fold a list of expressions, reusing the vector's allocation.
+fn fold_all<F: Fold + ?Sized>(folder: &mut F, exprs: Vec<HirExpression>) -> Vec<HirExpression> {
+    exprs.into_iter().map(|e| folder.fold_expression(e)).collect()
+}
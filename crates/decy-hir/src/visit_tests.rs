@@ -0,0 +1,143 @@
+//! Tests for the HIR visitor and fold traversals.
+
+use super::visit::*;
+use super::*;
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+/// Records every variable read, in traversal order.
+#[derive(Default)]
+struct Reads(Vec<String>);
+
+impl Visitor for Reads {
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        if let HirExpression::Variable(name) = expr {
+            self.0.push(name.clone());
+        }
+    }
+}
+
+/// Tracks block nesting through the enter/leave statement hooks.
+#[derive(Default)]
+struct Depth {
+    current: usize,
+    max: usize,
+}
+
+impl Visitor for Depth {
+    fn visit_statement(&mut self, _stmt: &HirStatement) {
+        self.current += 1;
+        self.max = self.max.max(self.current);
+    }
+
+    fn leave_statement(&mut self, _stmt: &HirStatement) {
+        self.current -= 1;
+    }
+}
+
+#[test]
+fn test_walk_reaches_switch_for_and_nested_expressions() {
+    let body = vec![
+        HirStatement::Switch {
+            condition: var("s"),
+            cases: vec![SwitchCase {
+                value: Some(HirExpression::IntLiteral(1)),
+                body: vec![HirStatement::Free { pointer: var("p") }],
+            }],
+            default_case: Some(vec![HirStatement::Expression(HirExpression::Ternary {
+                condition: Box::new(var("c")),
+                then_expr: Box::new(var("t")),
+                else_expr: Box::new(HirExpression::StringMethodCall {
+                    receiver: Box::new(var("r")),
+                    method: "len".to_string(),
+                    arguments: vec![var("a")],
+                }),
+            })]),
+        },
+        HirStatement::For {
+            init: vec![HirStatement::Assignment {
+                target: "i".to_string(),
+                value: HirExpression::IntLiteral(0),
+            }],
+            condition: Some(var("i")),
+            increment: vec![HirStatement::Expression(HirExpression::PostIncrement {
+                operand: Box::new(var("inc")),
+            })],
+            body: vec![HirStatement::ArrayIndexAssignment {
+                array: Box::new(var("arr")),
+                index: Box::new(var("idx")),
+                value: HirExpression::Realloc {
+                    pointer: Box::new(var("q")),
+                    new_size: Box::new(var("n")),
+                },
+            }],
+        },
+    ];
+
+    let mut reads = Reads::default();
+    walk_statements(&mut reads, &body);
+    assert_eq!(reads.0, vec!["s", "p", "c", "t", "r", "a", "i", "arr", "idx", "q", "n", "inc"]);
+}
+
+#[test]
+fn test_fused_visitors_share_one_traversal() {
+    let body = vec![HirStatement::If {
+        condition: var("x"),
+        then_block: vec![HirStatement::While {
+            condition: var("y"),
+            body: vec![HirStatement::Return(Some(var("z")))],
+        }],
+        else_block: None,
+    }];
+
+    let mut fused = (Reads::default(), Depth::default());
+    walk_statements(&mut fused, &body);
+    assert_eq!(fused.0 .0, vec!["x", "y", "z"]);
+    assert_eq!(fused.1.max, 3);
+    assert_eq!(fused.1.current, 0);
+
+    // Heterogeneous visitors fuse through a slice of trait objects
+    let (mut reads, mut depth) = (Reads::default(), Depth::default());
+    let mut dynamic: [&mut dyn Visitor; 2] = [&mut reads, &mut depth];
+    walk_statements(&mut dynamic[..], &body);
+    assert_eq!(reads.0.len(), 3);
+    assert_eq!(depth.max, 3);
+}
+
+/// Renames one variable everywhere it is read.
+struct Rename;
+
+impl Fold for Rename {
+    fn fold_expression(&mut self, expr: HirExpression) -> HirExpression {
+        match expr {
+            HirExpression::Variable(name) if name == "old" => var("new"),
+            other => fold_expression_children(self, other),
+        }
+    }
+}
+
+#[test]
+fn test_fold_rewrites_every_position() {
+    let stmt = HirStatement::Switch {
+        condition: var("old"),
+        cases: vec![SwitchCase {
+            value: None,
+            body: vec![HirStatement::DerefAssignment {
+                target: HirExpression::Dereference(Box::new(var("old"))),
+                value: HirExpression::Cast {
+                    target_type: HirType::Int,
+                    expr: Box::new(var("keep")),
+                },
+            }],
+        }],
+        default_case: Some(vec![HirStatement::Free { pointer: var("old") }]),
+    };
+
+    let folded = Rename.fold_statement(stmt);
+
+    let mut reads = Reads::default();
+    walk_statement(&mut reads, &folded);
+    assert_eq!(reads.0, vec!["new", "new", "keep", "new"]);
+}
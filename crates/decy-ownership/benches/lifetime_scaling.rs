@@ -0,0 +1,81 @@
+//! Benchmarks for scope-based lifetime analysis
+//!
+//! Measures how scope-tree construction, nesting queries and lifetime
+//! relationship inference scale with nesting depth.
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
+use decy_hir::{HirExpression, HirFunction, HirStatement, HirType};
+use decy_ownership::lifetime::LifetimeAnalyzer;
+
+fn declare(name: String) -> HirStatement {
+    HirStatement::VariableDeclaration {
+        name,
+        var_type: HirType::Pointer(Box::new(HirType::Int)),
+        initializer: None,
+    }
+}
+
+/// A chain of `depth` nested loops, each declaring one pointer.
+fn create_nested_function(depth: usize) -> HirFunction {
+    let mut body = vec![declare(format!("v_{}", depth))];
+    for level in (0..depth).rev() {
+        body = vec![
+            declare(format!("v_{}", level)),
+            HirStatement::While { condition: HirExpression::IntLiteral(1), body },
+        ];
+    }
+    HirFunction::new_with_body("nested".to_string(), HirType::Void, vec![], body)
+}
+
+fn bench_build_scope_tree(c: &mut Criterion) {
+    let analyzer = LifetimeAnalyzer::new();
+    let mut group = c.benchmark_group("lifetime_build_scope_tree");
+
+    for depth in [10, 50, 100, 200].iter() {
+        let func = create_nested_function(*depth);
+        group.bench_with_input(BenchmarkId::from_parameter(depth), depth, |b, _| {
+            b.iter(|| analyzer.build_scope_tree(black_box(&func)))
+        });
+    }
+    group.finish();
+}
+
+fn bench_nesting_queries(c: &mut Criterion) {
+    let analyzer = LifetimeAnalyzer::new();
+    let mut group = c.benchmark_group("lifetime_nesting_all_pairs");
+
+    for depth in [10, 50, 100, 200].iter() {
+        let tree = analyzer.build_scope_tree(&create_nested_function(*depth));
+        let count = tree.scopes().len();
+        group.bench_with_input(BenchmarkId::from_parameter(depth), depth, |b, _| {
+            b.iter(|| {
+                let mut nested = 0;
+                for inner in 0..count {
+                    for outer in 0..count {
+                        nested += tree.is_nested_in(black_box(inner), black_box(outer)) as usize;
+                    }
+                }
+                nested
+            })
+        });
+    }
+    group.finish();
+}
+
+fn bench_infer_relationships(c: &mut Criterion) {
+    let analyzer = LifetimeAnalyzer::new();
+    let mut group = c.benchmark_group("lifetime_infer_relationships");
+
+    for depth in [10, 50, 100].iter() {
+        let func = create_nested_function(*depth);
+        let tree = analyzer.build_scope_tree(&func);
+        let lifetimes = analyzer.track_lifetimes(&func, &tree);
+        group.bench_with_input(BenchmarkId::from_parameter(depth), depth, |b, _| {
+            b.iter(|| analyzer.infer_lifetime_relationships(black_box(&lifetimes), &tree))
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_build_scope_tree, bench_nesting_queries, bench_infer_relationships);
+criterion_main!(benches);
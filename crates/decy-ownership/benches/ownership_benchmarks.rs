@@ -0,0 +1,357 @@
+//! Benchmarks for the per-function ownership analyses
+//!
+//! Covers dataflow, inference, borrow generation, array-slice transforms and
+//! lifetime analysis/annotation on synthetic functions scaled by statement
+//! count, pointer count and nesting depth. Each size also reports the number
+//! of heap allocations per call (via a counting global allocator) and warns
+//! when allocations per input unit grow across sizes, which indicates a
+//! super-linear regression even when timings are noisy.
+//!
+//! The `ownership_synthetic_*` groups run every analysis over whole programs
+//! produced by `decy-synth` and parsed to HIR, scaled by function count,
+//! pointer density and expression depth.
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+use decy_ownership::array_slice::ArrayParameterTransformer;
+use decy_ownership::borrow_gen::BorrowGenerator;
+use decy_ownership::dataflow::DataflowAnalyzer;
+use decy_ownership::inference::OwnershipInferencer;
+use decy_ownership::lifetime::LifetimeAnalyzer;
+use decy_ownership::lifetime_gen::LifetimeAnnotator;
+use decy_synth::{generate, SynthConfig};
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+/// System allocator wrapper counting allocation calls and bytes.
+struct CountingAllocator;
+
+static ALLOCATIONS: AtomicUsize = AtomicUsize::new(0);
+static ALLOCATED_BYTES: AtomicUsize = AtomicUsize::new(0);
+
+#[allow(unsafe_code)]
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        ALLOCATED_BYTES.fetch_add(layout.size(), Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        ALLOCATED_BYTES.fetch_add(new_size, Ordering::Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAllocator = CountingAllocator;
+
+/// Allocation calls and bytes for one invocation of `f`.
+fn count_allocations<T>(f: impl FnOnce() -> T) -> (usize, usize) {
+    let calls = ALLOCATIONS.load(Ordering::Relaxed);
+    let bytes = ALLOCATED_BYTES.load(Ordering::Relaxed);
+    black_box(f());
+    (ALLOCATIONS.load(Ordering::Relaxed) - calls, ALLOCATED_BYTES.load(Ordering::Relaxed) - bytes)
+}
+
+/// Shape of a synthetic function.
+#[derive(Debug, Clone, Copy)]
+struct Shape {
+    statements: usize,
+    pointers: usize,
+    depth: usize,
+}
+
+impl std::fmt::Display for Shape {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        write!(f, "s{}_p{}_d{}", self.statements, self.pointers, self.depth)
+    }
+}
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+/// One statement touching pointer `p`, cycling through the patterns the
+/// analyses care about.
+fn pointer_statement(i: usize, p: &str) -> HirStatement {
+    match i % 5 {
+        0 => HirStatement::DerefAssignment {
+            target: var(p),
+            value: HirExpression::IntLiteral(i as i32),
+        },
+        1 => HirStatement::ArrayIndexAssignment {
+            array: Box::new(var(p)),
+            index: Box::new(var("i")),
+            value: HirExpression::IntLiteral(0),
+        },
+        2 => HirStatement::VariableDeclaration {
+            name: format!("alias_{}", i),
+            var_type: HirType::Pointer(Box::new(HirType::Int)),
+            initializer: Some(var(p)),
+        },
+        3 => HirStatement::If {
+            condition: HirExpression::IsNotNull(Box::new(var(p))),
+            then_block: vec![HirStatement::Assignment {
+                target: "acc".to_string(),
+                value: HirExpression::BinaryOp {
+                    op: BinaryOperator::Add,
+                    left: Box::new(var("acc")),
+                    right: Box::new(HirExpression::Dereference(Box::new(var(p)))),
+                },
+            }],
+            else_block: None,
+        },
+        _ => HirStatement::Expression(HirExpression::FunctionCall {
+            function: "consume".to_string(),
+            arguments: vec![var(p), var("acc")],
+        }),
+    }
+}
+
+/// Build a function with `pointers` pointer/length parameter pairs and
+/// `statements` statements spread over `depth` nested loops.
+fn create_function(shape: Shape) -> HirFunction {
+    let mut params = Vec::new();
+    for p in 0..shape.pointers.max(1) {
+        params.push(HirParameter::new(
+            format!("buf_{}", p),
+            HirType::Pointer(Box::new(HirType::Int)),
+        ));
+        params.push(HirParameter::new(format!("len_{}", p), HirType::Int));
+    }
+
+    let levels = shape.depth + 1;
+    let per_level = shape.statements.div_ceil(levels);
+    let mut body = Vec::new();
+    for level in (0..levels).rev() {
+        let mut block: Vec<HirStatement> = (0..per_level)
+            .map(|i| {
+                let idx = level * per_level + i;
+                pointer_statement(idx, &format!("buf_{}", idx % shape.pointers.max(1)))
+            })
+            .collect();
+        if !body.is_empty() {
+            block.push(HirStatement::While {
+                condition: HirExpression::BinaryOp {
+                    op: BinaryOperator::LessThan,
+                    left: Box::new(var("i")),
+                    right: Box::new(var("len_0")),
+                },
+                body,
+            });
+        }
+        body = block;
+    }
+    body.insert(
+        0,
+        HirStatement::VariableDeclaration {
+            name: "acc".to_string(),
+            var_type: HirType::Int,
+            initializer: Some(HirExpression::IntLiteral(0)),
+        },
+    );
+    body.insert(
+        0,
+        HirStatement::VariableDeclaration {
+            name: "i".to_string(),
+            var_type: HirType::Int,
+            initializer: Some(HirExpression::IntLiteral(0)),
+        },
+    );
+
+    HirFunction::new_with_body("synthetic".to_string(), HirType::Int, params, body)
+}
+
+fn scaling_shapes() -> Vec<(&'static str, Vec<Shape>)> {
+    vec![
+        (
+            "statements",
+            [25, 50, 100, 200, 400]
+                .iter()
+                .map(|&statements| Shape { statements, pointers: 4, depth: 2 })
+                .collect(),
+        ),
+        (
+            "pointers",
+            [2, 4, 8, 16, 32]
+                .iter()
+                .map(|&pointers| Shape { statements: 100, pointers, depth: 2 })
+                .collect(),
+        ),
+        (
+            "depth",
+            [1, 4, 8, 16, 32]
+                .iter()
+                .map(|&depth| Shape { statements: 100, pointers: 4, depth })
+                .collect(),
+        ),
+    ]
+}
+
+/// Size of the scaled dimension, used to normalise allocation counts.
+fn units(axis: &str, shape: Shape) -> usize {
+    match axis {
+        "statements" => shape.statements,
+        "pointers" => shape.pointers,
+        _ => shape.depth,
+    }
+}
+
+/// Benchmark one analysis across every scaling axis.
+fn bench_scaling<T>(c: &mut Criterion, name: &str, run: impl Fn(&HirFunction) -> T) {
+    for (axis, shapes) in scaling_shapes() {
+        let group_name = format!("{}_{}", name, axis);
+        let mut group = c.benchmark_group(&group_name);
+        let mut per_unit = Vec::new();
+
+        for shape in shapes {
+            let func = create_function(shape);
+            let (calls, bytes) = count_allocations(|| run(&func));
+            println!("{}/{}: {} allocations, {} bytes", group_name, shape, calls, bytes);
+            per_unit.push(calls as f64 / units(axis, shape) as f64);
+
+            group.bench_with_input(BenchmarkId::from_parameter(shape), &func, |b, func| {
+                b.iter(|| run(black_box(func)))
+            });
+        }
+        group.finish();
+
+        if let (Some(first), Some(last)) = (per_unit.first(), per_unit.last()) {
+            if *first > 0.0 && last / first > 4.0 {
+                println!(
+                    "warning: {} allocations per {} grew {:.1}x across sizes (super-linear?)",
+                    group_name,
+                    axis,
+                    last / first
+                );
+            }
+        }
+    }
+}
+
+fn bench_dataflow(c: &mut Criterion) {
+    let analyzer = DataflowAnalyzer::new();
+    bench_scaling(c, "dataflow_analyze", |func| analyzer.analyze(func));
+}
+
+fn bench_inference(c: &mut Criterion) {
+    let analyzer = DataflowAnalyzer::new();
+    let inferencer = OwnershipInferencer::new();
+    bench_scaling(c, "ownership_infer", |func| inferencer.infer(&analyzer.analyze(func)));
+}
+
+fn bench_borrow_generation(c: &mut Criterion) {
+    let analyzer = DataflowAnalyzer::new();
+    let inferencer = OwnershipInferencer::new();
+    let generator = BorrowGenerator::new();
+    bench_scaling(c, "borrow_transform_function", |func| {
+        let inferences = inferencer.infer(&analyzer.analyze(func));
+        generator.transform_function(func, &inferences)
+    });
+}
+
+fn bench_array_slice(c: &mut Criterion) {
+    let analyzer = DataflowAnalyzer::new();
+    let transformer = ArrayParameterTransformer::new();
+    bench_scaling(c, "array_slice_transform", |func| {
+        transformer.transform(func, &analyzer.analyze(func))
+    });
+}
+
+fn bench_lifetime_analysis(c: &mut Criterion) {
+    let analyzer = LifetimeAnalyzer::new();
+    bench_scaling(c, "lifetime_analyze", |func| {
+        let tree = analyzer.build_scope_tree(func);
+        let lifetimes = analyzer.track_lifetimes(func, &tree);
+        analyzer.detect_dangling_pointers(&lifetimes)
+    });
+}
+
+fn bench_lifetime_annotation(c: &mut Criterion) {
+    let annotator = LifetimeAnnotator::new();
+    bench_scaling(c, "lifetime_annotate_function", |func| annotator.annotate_function(func));
+}
+
+/// Parse a synthetic program to HIR functions (outside the timed region).
+fn synthetic_functions(config: &SynthConfig) -> Vec<HirFunction> {
+    let parser = decy_parser::CParser::new().expect("Failed to create parser");
+    let ast = parser.parse(&generate(config).flattened()).expect("Parse failed");
+    ast.functions().iter().map(HirFunction::from_ast_function).collect()
+}
+
+/// Every per-function analysis, as the pipeline runs them.
+fn analyze_program(functions: &[HirFunction]) -> usize {
+    let analyzer = DataflowAnalyzer::new();
+    let inferencer = OwnershipInferencer::new();
+    let generator = BorrowGenerator::new();
+    let annotator = LifetimeAnnotator::new();
+    let mut total = 0;
+    for func in functions {
+        let graph = analyzer.analyze(func);
+        let inferences = inferencer.infer(&graph);
+        let transformed = generator.transform_function(func, &inferences);
+        total += annotator.annotate_function(&transformed).lifetimes.len() + inferences.len();
+    }
+    total
+}
+
+fn bench_synthetic_programs(c: &mut Criterion) {
+    let base = SynthConfig { functions: 20, statements_per_function: 30, ..Default::default() };
+    let axes: Vec<(&str, Vec<(usize, SynthConfig)>)> = vec![
+        (
+            "functions",
+            [10, 25, 50, 100]
+                .iter()
+                .map(|&n| (n, SynthConfig { functions: n, ..base.clone() }))
+                .collect(),
+        ),
+        (
+            "pointer_density",
+            [0, 25, 50, 100]
+                .iter()
+                .map(|&pct| {
+                    (pct, SynthConfig { pointer_density: pct as f64 / 100.0, ..base.clone() })
+                })
+                .collect(),
+        ),
+        (
+            "expression_depth",
+            [1, 3, 5, 7]
+                .iter()
+                .map(|&n| (n, SynthConfig { expression_depth: n, ..base.clone() }))
+                .collect(),
+        ),
+    ];
+
+    for (axis, configs) in axes {
+        let group_name = format!("ownership_synthetic_{}", axis);
+        let mut group = c.benchmark_group(&group_name);
+        for (size, config) in configs {
+            let functions = synthetic_functions(&config);
+            let (calls, bytes) = count_allocations(|| analyze_program(&functions));
+            println!("{}/{}: {} allocations, {} bytes", group_name, size, calls, bytes);
+            group.bench_with_input(BenchmarkId::from_parameter(size), &functions, |b, f| {
+                b.iter(|| analyze_program(black_box(f)))
+            });
+        }
+        group.finish();
+    }
+}
+
+criterion_group!(
+    benches,
+    bench_dataflow,
+    bench_inference,
+    bench_borrow_generation,
+    bench_array_slice,
+    bench_lifetime_analysis,
+    bench_lifetime_annotation,
+    bench_synthetic_programs,
+);
+criterion_main!(benches);
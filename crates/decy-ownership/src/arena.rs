@@ -0,0 +1,1354 @@
+//! Index-arena lowering for self-referential structs.
+//!
+//! Linked lists and trees built from `struct Node *next` links scatter their
+//! nodes across the heap, one `malloc` chunk each. With this opt-in lowering
+//! every node of such a struct lives in one `Vec` per struct type, and links
+//! become `u32` indices into it, index 0 standing for NULL:
+//!
+//! - `struct Node *` in fields, parameters, locals and return types → `u32`
+//! - `malloc(sizeof(struct Node))` → `node_arena.alloc()`,
+//!   `free(p)` → `node_arena.free(p)`
+//! - `p->field` and `(*p).field` → `node_arena[p].field`
+//! - `if (p)`, `!p` and `p == NULL` → comparisons with 0
+//!
+//! Functions that touch nodes, directly or through their callees, take the
+//! arena as a leading `&mut` parameter; `main` owns it as a local.
+//!
+//! A struct is lowered only when every use of its pointers is one of the
+//! above, a copy between links, or an argument to a function defined in the
+//! same unit. Pointer arithmetic, indexing, `&` of a link or of a node
+//! field, casts to other pointer types, nodes held by value, globals and
+//! calls to external functions all keep the pointer lowering for that struct.
+//!
+//! Hand-rolled pool allocators and free lists found by
+//! [`PoolAnalyzer`](decy_analyzer::pool_analysis::PoolAnalyzer) are replaced
+//! by the arena of the structs they hand out: calls of the allocation,
+//! release and reset functions become `alloc()`, `free()` and `reset()`, and
+//! the pool functions and their state globals are dropped. A typed backing
+//! array `struct Node pool[N]` bounds the arena to N nodes.
+
+use decy_analyzer::pool_analysis::PoolAllocator;
+use decy_hir::visit::{fold_expression_children, fold_statement_children, walk_statements};
+use decy_hir::visit::{Fold, Visitor};
+use decy_hir::{
+    BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirStruct,
+    HirStructField, HirType, UnaryOperator,
+};
+use std::collections::{BTreeSet, HashMap, HashSet};
+
+/// A self-referential struct whose nodes live in an index arena.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct IndexArena {
+    /// The C struct, e.g. `TreeNode`
+    pub struct_name: String,
+    /// Rust type holding the nodes, e.g. `TreeNodeArena`
+    pub arena_type: String,
+    /// Parameter or local holding the arena, e.g. `tree_node_arena`
+    pub variable: String,
+    /// Nodes the C pool allocator could hand out, when bounded by an array
+    pub capacity: Option<usize>,
+}
+
+impl IndexArena {
+    fn new(struct_name: &str) -> Self {
+        Self {
+            struct_name: struct_name.to_string(),
+            arena_type: format!("{}Arena", struct_name),
+            variable: format!("{}_arena", snake_case(struct_name)),
+            capacity: None,
+        }
+    }
+}
+
+/// Which structs of a unit move into index arenas, and which functions need them.
+#[derive(Debug, Clone, Default)]
+pub struct IndexArenaPlan {
+    arenas: Vec<IndexArena>,
+    /// Field types of every struct, before lowering
+    fields: HashMap<String, Vec<(String, HirType)>>,
+    globals: HashMap<String, HirType>,
+    /// Parameter and return types of every function, before lowering
+    signatures: HashMap<String, (Vec<HirType>, HirType)>,
+    /// Functions defined with a body in this unit
+    defined: HashSet<String>,
+    /// Arenas each function reaches, directly or through its callees
+    needs: HashMap<String, BTreeSet<usize>>,
+    /// Pool allocators replaced by arenas
+    pools: Vec<PoolAllocator>,
+}
+
+/// What one function does with the arenas, found while lowering it.
+#[derive(Debug, Default)]
+struct ArenaUse {
+    /// First struct used in a way the lowering cannot express
+    rejected: Option<String>,
+    used: BTreeSet<usize>,
+    calls: BTreeSet<String>,
+    /// Functions named as values rather than called
+    referenced: BTreeSet<String>,
+}
+
+impl IndexArenaPlan {
+    /// Choose the structs of a unit that can live in index arenas.
+    ///
+    /// Candidates are structs with a pointer to their own type and only
+    /// scalar, pointer or fixed-array fields. A candidate with any use the
+    /// lowering cannot express is dropped, and the rest are re-checked.
+    pub fn plan(
+        structs: &[HirStruct],
+        globals: &[HirStatement],
+        functions: &[HirFunction],
+    ) -> Self {
+        Self::plan_with_pools(structs, globals, functions, &[])
+    }
+
+    /// Like [`plan`](Self::plan), also moving the objects of recognised pool
+    /// allocators into arenas.
+    ///
+    /// A pool is replaced only when every struct it hands out gets an arena
+    /// and no other pool serves them.
+    pub fn plan_with_pools(
+        structs: &[HirStruct],
+        globals: &[HirStatement],
+        functions: &[HirFunction],
+        pools: &[PoolAllocator],
+    ) -> Self {
+        let mut plan = Self {
+            fields: structs
+                .iter()
+                .map(|s| {
+                    let fields =
+                        s.fields().iter().map(|f| (f.name().to_string(), f.field_type().clone()));
+                    (s.name().to_string(), fields.collect())
+                })
+                .collect(),
+            globals: globals
+                .iter()
+                .filter_map(|stmt| match stmt {
+                    HirStatement::VariableDeclaration { name, var_type, .. } => {
+                        Some((name.clone(), var_type.clone()))
+                    }
+                    _ => None,
+                })
+                .collect(),
+            signatures: functions
+                .iter()
+                .map(|f| {
+                    let params = f.parameters().iter().map(|p| p.param_type().clone()).collect();
+                    (f.name().to_string(), (params, f.return_type().clone()))
+                })
+                .collect(),
+            defined: functions
+                .iter()
+                .filter(|f| f.has_body())
+                .map(|f| f.name().to_string())
+                .collect(),
+            ..Self::default()
+        };
+
+        let mut taken: HashSet<String> = plan.fields.keys().cloned().collect();
+        taken.extend(plan.globals.keys().cloned());
+        taken.extend(plan.signatures.keys().cloned());
+        for func in functions {
+            let mut locals = Locals::default();
+            walk_statements(&mut locals, func.body());
+            taken.extend(locals.0.into_keys());
+            taken.extend(func.parameters().iter().map(|p| p.name().to_string()));
+        }
+        let served = |name: &str| {
+            let mut serving = pools.iter().filter(|p| p.object_types.iter().any(|t| t == name));
+            serving.next().is_some() && serving.next().is_none()
+        };
+        let mut candidates: Vec<IndexArena> = structs
+            .iter()
+            .filter(|s| {
+                (is_self_referential(s) || served(s.name()))
+                    && s.fields().iter().all(|f| is_plain(f.field_type()))
+            })
+            .map(|s| IndexArena::new(s.name()))
+            .filter(|arena| !taken.contains(&arena.arena_type) && !taken.contains(&arena.variable))
+            .collect();
+        candidates.dedup_by(|a, b| a.struct_name == b.struct_name);
+
+        let linked: HashSet<&str> =
+            structs.iter().filter(|s| is_self_referential(s)).map(|s| s.name()).collect();
+        loop {
+            plan.pools = pools
+                .iter()
+                .filter(|pool| {
+                    pool.object_types.iter().all(|t| {
+                        served(t) && candidates.iter().any(|arena| arena.struct_name == *t)
+                    })
+                })
+                .cloned()
+                .collect();
+            // A struct only in the arena for its pool leaves with the pool
+            candidates.retain(|arena| {
+                linked.contains(arena.struct_name.as_str())
+                    || plan.pool_of(&arena.struct_name).is_some()
+            });
+            plan.arenas = candidates
+                .iter()
+                .map(|arena| IndexArena {
+                    capacity: plan.pool_of(&arena.struct_name).and_then(|pool| pool.capacity),
+                    ..arena.clone()
+                })
+                .collect();
+            match plan.check(functions) {
+                Ok(needs) => {
+                    plan.needs = needs;
+                    return plan;
+                }
+                Err(rejected) => candidates.retain(|arena| arena.struct_name != rejected),
+            }
+        }
+    }
+
+    /// Arenas chosen for the unit, in struct order.
+    pub fn arenas(&self) -> &[IndexArena] {
+        &self.arenas
+    }
+
+    /// Pool allocators replaced by the arenas.
+    pub fn pools(&self) -> &[PoolAllocator] {
+        &self.pools
+    }
+
+    /// Whether a function belongs to a replaced pool and is dropped.
+    pub fn replaces_function(&self, name: &str) -> bool {
+        self.pools.iter().any(|pool| pool.owns_function(name))
+    }
+
+    /// Whether a global holds state of a replaced pool and is dropped.
+    pub fn replaces_global(&self, name: &str) -> bool {
+        self.pools.iter().any(|pool| pool.state.iter().any(|s| s == name))
+    }
+
+    /// Whether no struct of the unit is lowered.
+    pub fn is_empty(&self) -> bool {
+        self.arenas.is_empty()
+    }
+
+    /// `struct S *` → `u32` for an arena struct, also as a fixed-array element.
+    pub fn lower_type(&self, ty: &HirType) -> HirType {
+        match ty {
+            ty if self.link_arena(ty).is_some() => HirType::UnsignedInt,
+            HirType::Array { element_type, size } => HirType::Array {
+                element_type: Box::new(self.lower_type(element_type)),
+                size: *size,
+            },
+            other => other.clone(),
+        }
+    }
+
+    /// A struct with its links to arena structs replaced by indices.
+    pub fn lower_struct(&self, hir_struct: &HirStruct) -> HirStruct {
+        let fields = hir_struct
+            .fields()
+            .iter()
+            .map(|f| HirStructField::new(f.name().to_string(), self.lower_type(f.field_type())))
+            .collect();
+        HirStruct::new(hir_struct.name().to_string(), fields)
+    }
+
+    /// A function with links lowered to indices and the arenas it needs threaded in.
+    pub fn lower_function(&self, func: &HirFunction) -> HirFunction {
+        if self.is_empty() || !func.has_body() {
+            return func.clone();
+        }
+        let owns = func.name() == "main";
+        let mut rewriter = ArenaRewriter::new(self, func, owns, true);
+        let mut body = rewriter.fold_block(func.body().to_vec());
+        let needs: Vec<&IndexArena> = self
+            .needs
+            .get(func.name())
+            .into_iter()
+            .flatten()
+            .map(|&index| &self.arenas[index])
+            .collect();
+
+        let mut parameters = Vec::new();
+        if owns {
+            let locals = needs.iter().map(|arena| HirStatement::VariableDeclaration {
+                name: arena.variable.clone(),
+                var_type: HirType::Struct(arena.arena_type.clone()),
+                initializer: Some(HirExpression::FunctionCall {
+                    function: format!("{}::new", arena.arena_type),
+                    arguments: vec![],
+                }),
+            });
+            body.splice(0..0, locals);
+        } else {
+            parameters.extend(needs.iter().map(|arena| {
+                let arena_ref = HirType::Reference {
+                    inner: Box::new(HirType::Struct(arena.arena_type.clone())),
+                    mutable: true,
+                };
+                HirParameter::new(arena.variable.clone(), arena_ref)
+            }));
+        }
+        parameters
+            .extend(func.parameters().iter().map(|p| p.with_type(self.lower_type(p.param_type()))));
+
+        let mut lowered = HirFunction::new_with_body(
+            func.name().to_string(),
+            self.lower_type(func.return_type()),
+            parameters,
+            body,
+        );
+        lowered.set_cuda_qualifier(func.cuda_qualifier());
+        lowered
+    }
+
+    /// Lower every function once without threading arenas, rejecting the
+    /// first struct with an unsupported use, and work out which functions
+    /// reach which arenas.
+    fn check(&self, functions: &[HirFunction]) -> Result<HashMap<String, BTreeSet<usize>>, String> {
+        if self.is_empty() {
+            return Ok(HashMap::new());
+        }
+        for fields in self.fields.values() {
+            self.check_types(fields.iter().map(|(_, ty)| ty))?;
+        }
+        let globals = self.globals.iter().filter(|(name, _)| !self.replaces_global(name));
+        if let Some(arena) = globals.into_iter().find_map(|(_, ty)| self.arena_in(ty)) {
+            return Err(self.arenas[arena].struct_name.clone());
+        }
+
+        let mut uses = HashMap::new();
+        for func in functions.iter().filter(|f| !self.replaces_function(f.name())) {
+            let (params, ret) = &self.signatures[func.name()];
+            self.check_types(params.iter().chain([ret]))?;
+            if !func.has_body() {
+                if let Some(arena) = params.iter().chain([ret]).find_map(|ty| self.arena_in(ty)) {
+                    return Err(self.arenas[arena].struct_name.clone());
+                }
+                continue;
+            }
+            let mut rewriter = ArenaRewriter::new(self, func, false, false);
+            self.check_types(rewriter.locals.values())?;
+            rewriter.fold_block(func.body().to_vec());
+            if let Some(rejected) = rewriter.found.rejected.take() {
+                return Err(rejected);
+            }
+            uses.insert(func.name().to_string(), rewriter.found);
+        }
+
+        let mut needs: HashMap<String, BTreeSet<usize>> =
+            uses.iter().map(|(name, found)| (name.clone(), found.used.clone())).collect();
+        let mut changed = true;
+        while changed {
+            changed = false;
+            for (name, found) in &uses {
+                let reached: BTreeSet<usize> = found
+                    .calls
+                    .iter()
+                    .filter_map(|callee| needs.get(callee))
+                    .flatten()
+                    .copied()
+                    .collect();
+                let own = needs.entry(name.clone()).or_default();
+                let before = own.len();
+                own.extend(reached);
+                changed |= own.len() != before;
+            }
+        }
+
+        // A function used as a value cannot grow an arena parameter or change
+        // its signature
+        for found in uses.values() {
+            for name in &found.referenced {
+                let (params, ret) = &self.signatures[name];
+                let in_signature = params.iter().chain([ret]).find_map(|ty| self.arena_in(ty));
+                if let Some(arena) = in_signature.or_else(|| needs[name].first().copied()) {
+                    return Err(self.arenas[arena].struct_name.clone());
+                }
+            }
+        }
+        Ok(needs)
+    }
+
+    /// Reject an arena struct that remains in a type after lowering: held by
+    /// value, behind two pointers, or in a function pointer.
+    fn check_types<'t>(&self, types: impl Iterator<Item = &'t HirType>) -> Result<(), String> {
+        for ty in types {
+            if let Some(arena) = self.arena_in(&self.lower_type(ty)) {
+                return Err(self.arenas[arena].struct_name.clone());
+            }
+        }
+        Ok(())
+    }
+
+    fn pool_of(&self, struct_name: &str) -> Option<&PoolAllocator> {
+        self.pools.iter().find(|pool| pool.object_types.iter().any(|t| t == struct_name))
+    }
+
+    /// The struct a call of a pool's allocation function hands out:
+    /// `node_alloc()` of a typed pool, or `pool_alloc(sizeof(struct S))`.
+    fn pool_allocated_type<'e>(&'e self, expr: &'e HirExpression) -> Option<&'e str> {
+        match expr {
+            HirExpression::Cast { expr, .. } => self.pool_allocated_type(expr),
+            HirExpression::FunctionCall { function, arguments } => {
+                let pool = self.pools.iter().find(|pool| pool.alloc == *function)?;
+                match arguments.as_slice() {
+                    [] => pool.object_types.first().map(String::as_str),
+                    [HirExpression::Sizeof { type_name }] => Some(type_name.trim()),
+                    _ => None,
+                }
+            }
+            _ => None,
+        }
+    }
+
+    fn arena_index(&self, struct_name: &str) -> Option<usize> {
+        self.arenas.iter().position(|arena| arena.struct_name == struct_name)
+    }
+
+    /// The arena of a `struct S *` link.
+    fn link_arena(&self, ty: &HirType) -> Option<usize> {
+        match ty {
+            HirType::Pointer(inner) => match inner.as_ref() {
+                HirType::Struct(name) => self.arena_index(name),
+                _ => None,
+            },
+            _ => None,
+        }
+    }
+
+    /// The first arena struct appearing anywhere in a type.
+    fn arena_in(&self, ty: &HirType) -> Option<usize> {
+        match ty {
+            HirType::Struct(name) => self.arena_index(name),
+            HirType::Pointer(inner)
+            | HirType::Box(inner)
+            | HirType::Vec(inner)
+            | HirType::Option(inner)
+            | HirType::Reference { inner, .. }
+            | HirType::Array { element_type: inner, .. } => self.arena_in(inner),
+            HirType::FunctionPointer { param_types, return_type } => {
+                param_types.iter().chain([return_type.as_ref()]).find_map(|t| self.arena_in(t))
+            }
+            HirType::Union(fields) => fields.iter().find_map(|(_, t)| self.arena_in(t)),
+            _ => None,
+        }
+    }
+
+    fn field_type(&self, struct_name: &str, field: &str) -> Option<&HirType> {
+        self.fields.get(struct_name)?.iter().find(|(name, _)| name == field).map(|(_, ty)| ty)
+    }
+}
+
+/// Whether a struct has a field pointing to its own type.
+fn is_self_referential(hir_struct: &HirStruct) -> bool {
+    hir_struct.fields().iter().any(|f| {
+        matches!(f.field_type(), HirType::Pointer(inner)
+            if matches!(inner.as_ref(), HirType::Struct(name) if name == hir_struct.name()))
+    })
+}
+
+/// Field types an arena can zero without knowing other structs.
+fn is_plain(ty: &HirType) -> bool {
+    match ty {
+        HirType::Bool
+        | HirType::Int
+        | HirType::UnsignedInt
+        | HirType::Float
+        | HirType::Double
+        | HirType::Char
+        | HirType::SignedChar
+        | HirType::Pointer(_) => true,
+        HirType::Array { element_type, size: Some(_) } => is_plain(element_type),
+        _ => false,
+    }
+}
+
+fn snake_case(name: &str) -> String {
+    let mut snake = String::with_capacity(name.len() + 4);
+    for (i, c) in name.chars().enumerate() {
+        if c.is_ascii_uppercase() {
+            if i > 0 && !snake.ends_with('_') {
+                snake.push('_');
+            }
+            snake.push(c.to_ascii_lowercase());
+        } else {
+            snake.push(c);
+        }
+    }
+    snake
+}
+
+fn is_null(expr: &HirExpression) -> bool {
+    match expr {
+        HirExpression::NullLiteral | HirExpression::IntLiteral(0) => true,
+        HirExpression::Cast { expr, .. } => is_null(expr),
+        _ => false,
+    }
+}
+
+/// The type named by `malloc(sizeof(T))` or `calloc(1, sizeof(T))`.
+fn allocated_type(expr: &HirExpression) -> Option<&str> {
+    match expr {
+        HirExpression::Cast { expr, .. } => allocated_type(expr),
+        HirExpression::FunctionCall { function, arguments } => {
+            match (function.as_str(), arguments.as_slice()) {
+                ("malloc", [HirExpression::Sizeof { type_name }])
+                | ("calloc", [HirExpression::IntLiteral(1), HirExpression::Sizeof { type_name }]) => {
+                    Some(type_name.trim())
+                }
+                _ => None,
+            }
+        }
+        _ => None,
+    }
+}
+
+fn names_struct(type_name: &str, struct_name: &str) -> bool {
+    type_name == struct_name || type_name.strip_prefix("struct ") == Some(struct_name)
+}
+
+/// Every local declared in a body, with its C type.
+#[derive(Default)]
+struct Locals(HashMap<String, HirType>);
+
+impl Visitor for Locals {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        if let HirStatement::VariableDeclaration { name, var_type, .. } = stmt {
+            self.0.insert(name.clone(), var_type.clone());
+        }
+    }
+}
+
+/// Rewrites one function body onto arena indices.
+struct ArenaRewriter<'a> {
+    plan: &'a IndexArenaPlan,
+    /// Parameters and locals of the function, with their C types
+    locals: HashMap<String, HirType>,
+    return_type: HirType,
+    /// `main` holds the arenas by value and lends them to callees
+    owns_arenas: bool,
+    /// Pass the arenas a callee needs as leading arguments
+    thread_arenas: bool,
+    found: ArenaUse,
+}
+
+impl<'a> ArenaRewriter<'a> {
+    fn new(plan: &'a IndexArenaPlan, func: &HirFunction, owns: bool, thread: bool) -> Self {
+        let mut locals = Locals::default();
+        walk_statements(&mut locals, func.body());
+        let mut locals = locals.0;
+        for param in func.parameters() {
+            locals.insert(param.name().to_string(), param.param_type().clone());
+        }
+        Self {
+            plan,
+            locals,
+            return_type: func.return_type().clone(),
+            owns_arenas: owns,
+            thread_arenas: thread,
+            found: ArenaUse::default(),
+        }
+    }
+
+    fn reject(&mut self, arena: usize) {
+        let name = &self.plan.arenas[arena].struct_name;
+        self.found.rejected.get_or_insert_with(|| name.clone());
+    }
+
+    fn variable_type(&self, name: &str) -> Option<&HirType> {
+        self.locals.get(name).or_else(|| self.plan.globals.get(name))
+    }
+
+    /// C type of an expression, as far as the lowering needs it.
+    fn type_of(&self, expr: &HirExpression) -> Option<HirType> {
+        match expr {
+            HirExpression::Variable(name) => self.variable_type(name).cloned(),
+            HirExpression::PointerFieldAccess { pointer, field } => match self.type_of(pointer)? {
+                HirType::Pointer(inner) => self.struct_field(&inner, field),
+                _ => None,
+            },
+            HirExpression::FieldAccess { object, field } => {
+                self.struct_field(&self.type_of(object)?, field)
+            }
+            HirExpression::Dereference(inner) | HirExpression::ArrayIndex { array: inner, .. } => {
+                match self.type_of(inner)? {
+                    HirType::Pointer(element) | HirType::Array { element_type: element, .. } => {
+                        Some(*element)
+                    }
+                    _ => None,
+                }
+            }
+            HirExpression::AddressOf(inner)
+            | HirExpression::UnaryOp { op: UnaryOperator::AddressOf, operand: inner } => {
+                Some(HirType::Pointer(Box::new(self.type_of(inner)?)))
+            }
+            HirExpression::FunctionCall { function, .. } => {
+                self.plan.signatures.get(function).map(|(_, ret)| ret.clone())
+            }
+            HirExpression::Cast { target_type, .. } => Some(target_type.clone()),
+            HirExpression::Ternary { then_expr, else_expr, .. } => {
+                self.type_of(then_expr).or_else(|| self.type_of(else_expr))
+            }
+            HirExpression::PostIncrement { operand }
+            | HirExpression::PreIncrement { operand }
+            | HirExpression::PostDecrement { operand }
+            | HirExpression::PreDecrement { operand } => self.type_of(operand),
+            HirExpression::BinaryOp {
+                op: BinaryOperator::Add | BinaryOperator::Subtract,
+                left,
+                right,
+            } => [left, right]
+                .into_iter()
+                .filter_map(|side| self.type_of(side))
+                .find(|ty| matches!(ty, HirType::Pointer(_))),
+            _ => None,
+        }
+    }
+
+    fn struct_field(&self, ty: &HirType, field: &str) -> Option<HirType> {
+        match ty {
+            HirType::Struct(name) => self.plan.field_type(name, field).cloned(),
+            _ => None,
+        }
+    }
+
+    /// The arena of an expression holding a link.
+    fn link(&self, expr: &HirExpression) -> Option<usize> {
+        self.plan.link_arena(&self.type_of(expr)?)
+    }
+
+    /// The arena an expression's type mentions in any position.
+    fn mentions(&self, expr: &HirExpression) -> Option<usize> {
+        self.plan.arena_in(&self.type_of(expr)?)
+    }
+
+    fn arena_argument(&self, arena: usize) -> HirExpression {
+        let variable = HirExpression::Variable(self.plan.arenas[arena].variable.clone());
+        if self.owns_arenas {
+            HirExpression::AddressOf(Box::new(variable))
+        } else {
+            variable
+        }
+    }
+
+    /// `arena[p]`, the node a link points to.
+    fn node(&mut self, arena: usize, link: HirExpression) -> HirExpression {
+        self.found.used.insert(arena);
+        HirExpression::ArrayIndex {
+            array: Box::new(HirExpression::Variable(self.plan.arenas[arena].variable.clone())),
+            index: Box::new(self.fold_expression(link)),
+        }
+    }
+
+    fn arena_call(
+        &mut self,
+        arena: usize,
+        method: &str,
+        arguments: Vec<HirExpression>,
+    ) -> HirExpression {
+        self.found.used.insert(arena);
+        HirExpression::StringMethodCall {
+            receiver: Box::new(HirExpression::Variable(self.plan.arenas[arena].variable.clone())),
+            method: method.to_string(),
+            arguments,
+        }
+    }
+
+    /// The object of a field assignment: `p` and `*p` for a link become its node.
+    fn object(&mut self, object: HirExpression) -> HirExpression {
+        if let Some(arena) = self.link(&object) {
+            return self.node(arena, object);
+        }
+        match object {
+            HirExpression::Dereference(inner) if self.link(&inner).is_some() => {
+                let arena = self.link(&inner).unwrap_or_default();
+                self.node(arena, *inner)
+            }
+            other => self.fold_expression(other),
+        }
+    }
+
+    /// An expression stored into a place of type `expected`.
+    ///
+    /// Into a link, NULL becomes 0 and a node allocation becomes `alloc()`;
+    /// a link stored anywhere else keeps the struct out of the arena.
+    fn value(&mut self, expr: HirExpression, expected: Option<&HirType>) -> HirExpression {
+        let Some(arena) = expected.and_then(|ty| self.plan.link_arena(ty)) else {
+            if let Some(arena) = self.mentions(&expr) {
+                self.reject(arena);
+            }
+            return self.fold_expression(expr);
+        };
+        if is_null(&expr) {
+            return HirExpression::IntLiteral(0);
+        }
+        let plan = self.plan;
+        if let Some(type_name) = allocated_type(&expr).or_else(|| plan.pool_allocated_type(&expr)) {
+            if names_struct(type_name, &self.plan.arenas[arena].struct_name) {
+                return self.arena_call(arena, "alloc", vec![]);
+            }
+            self.reject(arena);
+            return expr;
+        }
+        if self.link(&expr) != Some(arena) {
+            self.reject(arena);
+            return expr;
+        }
+        self.fold_expression(expr)
+    }
+
+    /// A condition, with a link's truthiness spelled as `p != 0`.
+    fn condition(&mut self, expr: HirExpression) -> HirExpression {
+        if self.link(&expr).is_none() {
+            return self.fold_expression(expr);
+        }
+        self.compare(BinaryOperator::NotEqual, expr)
+    }
+
+    fn compare(&mut self, op: BinaryOperator, link: HirExpression) -> HirExpression {
+        HirExpression::BinaryOp {
+            op,
+            left: Box::new(self.fold_expression(link)),
+            right: Box::new(HirExpression::IntLiteral(0)),
+        }
+    }
+
+    /// The arena reached by taking the address of `place`: a link, a node,
+    /// or a field of a node.
+    fn address_reaches(&self, place: &HirExpression) -> Option<usize> {
+        self.mentions(place).or_else(|| match place {
+            HirExpression::PointerFieldAccess { pointer, .. } => self.link(pointer),
+            HirExpression::FieldAccess { object, .. }
+            | HirExpression::ArrayIndex { array: object, .. } => self.address_reaches(object),
+            HirExpression::Dereference(inner) => self.link(inner),
+            _ => None,
+        })
+    }
+
+    fn call(&mut self, function: String, arguments: Vec<HirExpression>) -> HirExpression {
+        let plan = self.plan;
+        if let Some(pool) = plan.pools.iter().find(|pool| pool.owns_function(&function)) {
+            if pool.release.as_ref() == Some(&function) {
+                if let [arg] = arguments.as_slice() {
+                    if let Some(arena) = self.link(arg) {
+                        let arguments =
+                            arguments.into_iter().map(|a| self.fold_expression(a)).collect();
+                        return self.arena_call(arena, "free", arguments);
+                    }
+                }
+            }
+            // Allocations outside a link and resets used as values
+            for name in &pool.object_types {
+                if let Some(arena) = plan.arena_index(name) {
+                    self.reject(arena);
+                }
+            }
+            return HirExpression::FunctionCall { function, arguments };
+        }
+        if function == "free" {
+            if let [arg] = arguments.as_slice() {
+                if let Some(arena) = self.link(arg) {
+                    let arguments =
+                        arguments.into_iter().map(|a| self.fold_expression(a)).collect();
+                    return self.arena_call(arena, "free", arguments);
+                }
+            }
+        }
+        if !self.plan.defined.contains(&function) {
+            for arg in &arguments {
+                if let Some(arena) = self.mentions(arg) {
+                    self.reject(arena);
+                }
+            }
+            let arguments = arguments.into_iter().map(|a| self.fold_expression(a)).collect();
+            return HirExpression::FunctionCall { function, arguments };
+        }
+
+        self.found.calls.insert(function.clone());
+        let plan = self.plan;
+        let params = &plan.signatures[&function].0;
+        let mut lowered: Vec<HirExpression> = Vec::with_capacity(arguments.len());
+        if self.thread_arenas {
+            if let Some(needs) = plan.needs.get(&function) {
+                lowered.extend(needs.iter().map(|&arena| self.arena_argument(arena)));
+            }
+        }
+        for (i, arg) in arguments.into_iter().enumerate() {
+            lowered.push(self.value(arg, params.get(i)));
+        }
+        HirExpression::FunctionCall { function, arguments: lowered }
+    }
+}
+
+impl Fold for ArenaRewriter<'_> {
+    fn fold_block(&mut self, block: Vec<HirStatement>) -> Vec<HirStatement> {
+        let mut folded = Vec::with_capacity(block.len());
+        for stmt in block {
+            let reset = match &stmt {
+                HirStatement::Expression(HirExpression::FunctionCall { function, arguments })
+                    if arguments.is_empty() =>
+                {
+                    self.plan.pools.iter().find(|pool| pool.reset.contains(function))
+                }
+                _ => None,
+            };
+            match reset {
+                Some(pool) => {
+                    let plan = self.plan;
+                    for name in &pool.object_types {
+                        let arena = plan.arena_index(name).unwrap_or_default();
+                        folded.push(HirStatement::Expression(self.arena_call(
+                            arena,
+                            "reset",
+                            vec![],
+                        )));
+                    }
+                }
+                None => folded.push(self.fold_statement(stmt)),
+            }
+        }
+        folded
+    }
+
+    fn fold_statement(&mut self, stmt: HirStatement) -> HirStatement {
+        match stmt {
+            HirStatement::VariableDeclaration { name, var_type, initializer } => {
+                HirStatement::VariableDeclaration {
+                    initializer: initializer.map(|e| self.value(e, Some(&var_type))),
+                    var_type: self.plan.lower_type(&var_type),
+                    name,
+                }
+            }
+            HirStatement::Assignment { target, value } => {
+                let expected = self.variable_type(&target).cloned();
+                HirStatement::Assignment { value: self.value(value, expected.as_ref()), target }
+            }
+            HirStatement::FieldAssignment { object, field, value } => {
+                let expected = match self.type_of(&object) {
+                    Some(HirType::Pointer(inner)) => self.struct_field(&inner, &field),
+                    Some(ty) => self.struct_field(&ty, &field),
+                    None => None,
+                };
+                let value = self.value(value, expected.as_ref());
+                HirStatement::FieldAssignment { object: self.object(object), field, value }
+            }
+            HirStatement::ArrayIndexAssignment { array, index, value } => {
+                let expected = match self.type_of(&array) {
+                    Some(
+                        HirType::Pointer(element) | HirType::Array { element_type: element, .. },
+                    ) => Some(*element),
+                    _ => None,
+                };
+                if let Some(arena) = self.link(&array) {
+                    self.reject(arena);
+                }
+                HirStatement::ArrayIndexAssignment {
+                    value: self.value(value, expected.as_ref()),
+                    array: Box::new(self.fold_expression(*array)),
+                    index: Box::new(self.fold_expression(*index)),
+                }
+            }
+            HirStatement::DerefAssignment { target, value } => {
+                let expected = match self.type_of(&target) {
+                    Some(HirType::Pointer(pointee)) => Some(*pointee),
+                    _ => None,
+                };
+                if let Some(arena) = self.link(&target) {
+                    self.reject(arena);
+                }
+                HirStatement::DerefAssignment {
+                    value: self.value(value, expected.as_ref()),
+                    target: self.fold_expression(target),
+                }
+            }
+            HirStatement::Return(Some(value)) => {
+                let expected = self.return_type.clone();
+                HirStatement::Return(Some(self.value(value, Some(&expected))))
+            }
+            HirStatement::If { condition, then_block, else_block } => HirStatement::If {
+                condition: self.condition(condition),
+                then_block: self.fold_block(then_block),
+                else_block: else_block.map(|block| self.fold_block(block)),
+            },
+            HirStatement::While { condition, body } => HirStatement::While {
+                condition: self.condition(condition),
+                body: self.fold_block(body),
+            },
+            HirStatement::For { init, condition, increment, body } => HirStatement::For {
+                init: self.fold_block(init),
+                condition: condition.map(|c| self.condition(c)),
+                increment: self.fold_block(increment),
+                body: self.fold_block(body),
+            },
+            HirStatement::Free { pointer } if self.link(&pointer).is_some() => {
+                HirStatement::Expression(self.call("free".to_string(), vec![pointer]))
+            }
+            other => fold_statement_children(self, other),
+        }
+    }
+
+    fn fold_expression(&mut self, expr: HirExpression) -> HirExpression {
+        match expr {
+            HirExpression::Variable(ref name) => {
+                if self.plan.defined.contains(name) && self.variable_type(name).is_none() {
+                    self.found.referenced.insert(name.clone());
+                }
+                expr
+            }
+            HirExpression::PointerFieldAccess { pointer, field } => match self.link(&pointer) {
+                Some(arena) => HirExpression::FieldAccess {
+                    object: Box::new(self.node(arena, *pointer)),
+                    field,
+                },
+                None => fold_expression_children(
+                    self,
+                    HirExpression::PointerFieldAccess { pointer, field },
+                ),
+            },
+            HirExpression::FieldAccess { object, field } => {
+                HirExpression::FieldAccess { object: Box::new(self.object(*object)), field }
+            }
+            HirExpression::BinaryOp {
+                op: op @ (BinaryOperator::LogicalAnd | BinaryOperator::LogicalOr),
+                left,
+                right,
+            } => HirExpression::BinaryOp {
+                op,
+                left: Box::new(self.condition(*left)),
+                right: Box::new(self.condition(*right)),
+            },
+            HirExpression::BinaryOp {
+                op: op @ (BinaryOperator::Equal | BinaryOperator::NotEqual),
+                left,
+                right,
+            } => match self.link(&left).or_else(|| self.link(&right)) {
+                Some(arena) => {
+                    let link = HirType::Pointer(Box::new(HirType::Struct(
+                        self.plan.arenas[arena].struct_name.clone(),
+                    )));
+                    HirExpression::BinaryOp {
+                        op,
+                        left: Box::new(self.value(*left, Some(&link))),
+                        right: Box::new(self.value(*right, Some(&link))),
+                    }
+                }
+                None => fold_expression_children(self, HirExpression::BinaryOp { op, left, right }),
+            },
+            HirExpression::UnaryOp { op: UnaryOperator::LogicalNot, operand }
+                if self.link(&operand).is_some() =>
+            {
+                self.compare(BinaryOperator::Equal, *operand)
+            }
+            HirExpression::IsNotNull(inner) if self.link(&inner).is_some() => {
+                self.compare(BinaryOperator::NotEqual, *inner)
+            }
+            HirExpression::Ternary { condition, then_expr, else_expr } => {
+                let link = self.link(&then_expr).or_else(|| self.link(&else_expr)).map(|arena| {
+                    HirType::Pointer(Box::new(HirType::Struct(
+                        self.plan.arenas[arena].struct_name.clone(),
+                    )))
+                });
+                HirExpression::Ternary {
+                    condition: Box::new(self.condition(*condition)),
+                    then_expr: Box::new(self.value(*then_expr, link.as_ref())),
+                    else_expr: Box::new(self.value(*else_expr, link.as_ref())),
+                }
+            }
+            HirExpression::Cast { target_type, expr }
+                if self.plan.link_arena(&target_type).is_some() =>
+            {
+                self.value(*expr, Some(&target_type))
+            }
+            HirExpression::FunctionCall { function, arguments } => self.call(function, arguments),
+            other => {
+                let arena = match &other {
+                    HirExpression::AddressOf(place)
+                    | HirExpression::UnaryOp { op: UnaryOperator::AddressOf, operand: place } => {
+                        self.address_reaches(place)
+                    }
+                    // Pointer arithmetic, ordering, indexing and dereference of a link
+                    HirExpression::BinaryOp { left, right, .. } => {
+                        self.link(left).or_else(|| self.link(right))
+                    }
+                    HirExpression::UnaryOp { operand: inner, .. }
+                    | HirExpression::PostIncrement { operand: inner }
+                    | HirExpression::PreIncrement { operand: inner }
+                    | HirExpression::PostDecrement { operand: inner }
+                    | HirExpression::PreDecrement { operand: inner }
+                    | HirExpression::Dereference(inner)
+                    | HirExpression::ArrayIndex { array: inner, .. } => self.link(inner),
+                    // Casts to other types and sizes of a node outside an allocation
+                    HirExpression::Cast { expr, .. } => self.mentions(expr),
+                    HirExpression::Sizeof { type_name } => self
+                        .plan
+                        .arenas
+                        .iter()
+                        .position(|arena| names_struct(type_name.trim(), &arena.struct_name)),
+                    HirExpression::CompoundLiteral { literal_type, .. } => {
+                        self.plan.arena_in(literal_type)
+                    }
+                    _ => None,
+                };
+                if let Some(arena) = arena {
+                    self.reject(arena);
+                }
+                fold_expression_children(self, other)
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn var(name: &str) -> HirExpression {
+        HirExpression::Variable(name.to_string())
+    }
+
+    fn int(value: i32) -> HirExpression {
+        HirExpression::IntLiteral(value)
+    }
+
+    fn node_ptr() -> HirType {
+        HirType::Pointer(Box::new(HirType::Struct("Node".to_string())))
+    }
+
+    fn arrow(pointer: &str, field: &str) -> HirExpression {
+        HirExpression::PointerFieldAccess {
+            pointer: Box::new(var(pointer)),
+            field: field.to_string(),
+        }
+    }
+
+    fn call(function: &str, arguments: Vec<HirExpression>) -> HirExpression {
+        HirExpression::FunctionCall { function: function.to_string(), arguments }
+    }
+
+    fn node() -> HirStruct {
+        HirStruct::new(
+            "Node".to_string(),
+            vec![
+                HirStructField::new("data".to_string(), HirType::Int),
+                HirStructField::new("next".to_string(), node_ptr()),
+            ],
+        )
+    }
+
+    /// struct Node *push(struct Node *head, int v) {
+    ///     struct Node *n = malloc(sizeof(struct Node));
+    ///     n->data = v; n->next = head; return n;
+    /// }
+    fn push() -> HirFunction {
+        HirFunction::new_with_body(
+            "push".to_string(),
+            node_ptr(),
+            vec![
+                HirParameter::new("head".to_string(), node_ptr()),
+                HirParameter::new("v".to_string(), HirType::Int),
+            ],
+            vec![
+                HirStatement::VariableDeclaration {
+                    name: "n".to_string(),
+                    var_type: node_ptr(),
+                    initializer: Some(call(
+                        "malloc",
+                        vec![HirExpression::Sizeof { type_name: "struct Node".to_string() }],
+                    )),
+                },
+                HirStatement::FieldAssignment {
+                    object: var("n"),
+                    field: "data".to_string(),
+                    value: var("v"),
+                },
+                HirStatement::FieldAssignment {
+                    object: var("n"),
+                    field: "next".to_string(),
+                    value: var("head"),
+                },
+                HirStatement::Return(Some(var("n"))),
+            ],
+        )
+    }
+
+    /// int main() { struct Node *list = push(NULL, 1); if (list) return list->data; return 0; }
+    fn main_fn() -> HirFunction {
+        HirFunction::new_with_body(
+            "main".to_string(),
+            HirType::Int,
+            vec![],
+            vec![
+                HirStatement::VariableDeclaration {
+                    name: "list".to_string(),
+                    var_type: node_ptr(),
+                    initializer: Some(call("push", vec![HirExpression::NullLiteral, int(1)])),
+                },
+                HirStatement::If {
+                    condition: var("list"),
+                    then_block: vec![HirStatement::Return(Some(arrow("list", "data")))],
+                    else_block: None,
+                },
+                HirStatement::Return(Some(int(0))),
+            ],
+        )
+    }
+
+    fn plan(functions: &[HirFunction]) -> IndexArenaPlan {
+        IndexArenaPlan::plan(&[node()], &[], functions)
+    }
+
+    #[test]
+    fn test_self_referential_struct_gets_arena() {
+        let plan = plan(&[push(), main_fn()]);
+
+        assert_eq!(
+            plan.arenas(),
+            &[IndexArena {
+                struct_name: "Node".to_string(),
+                arena_type: "NodeArena".to_string(),
+                variable: "node_arena".to_string(),
+                capacity: None,
+            }]
+        );
+        let lowered = plan.lower_struct(&node());
+        assert_eq!(lowered.fields()[1].field_type(), &HirType::UnsignedInt);
+    }
+
+    #[test]
+    fn test_links_become_indices_into_arena_parameter() {
+        let plan = plan(&[push(), main_fn()]);
+        let lowered = plan.lower_function(&push());
+
+        assert_eq!(lowered.return_type(), &HirType::UnsignedInt);
+        let params: Vec<(&str, &HirType)> =
+            lowered.parameters().iter().map(|p| (p.name(), p.param_type())).collect();
+        assert_eq!(
+            params,
+            [
+                (
+                    "node_arena",
+                    &HirType::Reference {
+                        inner: Box::new(HirType::Struct("NodeArena".to_string())),
+                        mutable: true,
+                    }
+                ),
+                ("head", &HirType::UnsignedInt),
+                ("v", &HirType::Int),
+            ]
+        );
+        assert_eq!(
+            lowered.body()[0],
+            HirStatement::VariableDeclaration {
+                name: "n".to_string(),
+                var_type: HirType::UnsignedInt,
+                initializer: Some(HirExpression::StringMethodCall {
+                    receiver: Box::new(var("node_arena")),
+                    method: "alloc".to_string(),
+                    arguments: vec![],
+                }),
+            }
+        );
+        assert_eq!(
+            lowered.body()[1],
+            HirStatement::FieldAssignment {
+                object: HirExpression::ArrayIndex {
+                    array: Box::new(var("node_arena")),
+                    index: Box::new(var("n")),
+                },
+                field: "data".to_string(),
+                value: var("v"),
+            }
+        );
+    }
+
+    #[test]
+    fn test_main_owns_arena_and_lends_it() {
+        let plan = plan(&[push(), main_fn()]);
+        let lowered = plan.lower_function(&main_fn());
+        let body = lowered.body();
+
+        assert!(lowered.parameters().is_empty());
+        assert_eq!(
+            body[0],
+            HirStatement::VariableDeclaration {
+                name: "node_arena".to_string(),
+                var_type: HirType::Struct("NodeArena".to_string()),
+                initializer: Some(call("NodeArena::new", vec![])),
+            }
+        );
+        let HirStatement::VariableDeclaration { initializer: Some(init), .. } = &body[1] else {
+            panic!("expected declaration, got {:?}", body[1]);
+        };
+        assert_eq!(
+            *init,
+            call(
+                "push",
+                vec![HirExpression::AddressOf(Box::new(var("node_arena"))), int(0), int(1)]
+            )
+        );
+        let HirStatement::If { condition, .. } = &body[2] else {
+            panic!("expected if, got {:?}", body[2]);
+        };
+        assert_eq!(
+            *condition,
+            HirExpression::BinaryOp {
+                op: BinaryOperator::NotEqual,
+                left: Box::new(var("list")),
+                right: Box::new(int(0)),
+            }
+        );
+    }
+
+    #[test]
+    fn test_pointer_arithmetic_keeps_pointers() {
+        let walk = HirFunction::new_with_body(
+            "walk".to_string(),
+            node_ptr(),
+            vec![HirParameter::new("head".to_string(), node_ptr())],
+            vec![HirStatement::Return(Some(HirExpression::BinaryOp {
+                op: BinaryOperator::Add,
+                left: Box::new(var("head")),
+                right: Box::new(int(1)),
+            }))],
+        );
+        assert!(plan(&[push(), walk]).is_empty());
+    }
+
+    #[test]
+    fn test_external_call_with_link_keeps_pointers() {
+        let log = HirFunction::new_with_body(
+            "log".to_string(),
+            HirType::Void,
+            vec![HirParameter::new("head".to_string(), node_ptr())],
+            vec![HirStatement::Expression(call(
+                "printf",
+                vec![HirExpression::StringLiteral("%p".to_string()), var("head")],
+            ))],
+        );
+        assert!(plan(&[push(), log]).is_empty());
+    }
+
+    #[test]
+    fn test_address_of_node_field_keeps_pointers() {
+        let field_ptr = HirFunction::new_with_body(
+            "data_ptr".to_string(),
+            HirType::Pointer(Box::new(HirType::Int)),
+            vec![HirParameter::new("head".to_string(), node_ptr())],
+            vec![HirStatement::Return(Some(HirExpression::AddressOf(Box::new(arrow(
+                "head", "data",
+            )))))],
+        );
+        assert!(plan(&[push(), field_ptr]).is_empty());
+    }
+
+    #[test]
+    fn test_node_global_keeps_pointers() {
+        let global = HirStatement::VariableDeclaration {
+            name: "list_head".to_string(),
+            var_type: node_ptr(),
+            initializer: None,
+        };
+        assert!(IndexArenaPlan::plan(&[node()], &[global], &[push()]).is_empty());
+    }
+
+    /// A free list over `struct Node pool[256]` with a reset function
+    fn free_list() -> PoolAllocator {
+        PoolAllocator {
+            kind: decy_analyzer::pool_analysis::PoolKind::FreeList,
+            object_types: vec!["Node".to_string()],
+            alloc: "node_alloc".to_string(),
+            release: Some("node_release".to_string()),
+            reset: vec!["pool_reset".to_string()],
+            state: vec!["pool".to_string(), "next_slot".to_string(), "free_list".to_string()],
+            capacity: Some(256),
+        }
+    }
+
+    /// void churn(void) { struct Node *n = node_alloc(); node_release(n); pool_reset(); }
+    fn churn() -> HirFunction {
+        HirFunction::new_with_body(
+            "churn".to_string(),
+            HirType::Void,
+            vec![],
+            vec![
+                HirStatement::VariableDeclaration {
+                    name: "n".to_string(),
+                    var_type: node_ptr(),
+                    initializer: Some(call("node_alloc", vec![])),
+                },
+                HirStatement::Expression(call("node_release", vec![var("n")])),
+                HirStatement::Expression(call("pool_reset", vec![])),
+            ],
+        )
+    }
+
+    fn pool_globals() -> Vec<HirStatement> {
+        vec![HirStatement::VariableDeclaration {
+            name: "free_list".to_string(),
+            var_type: node_ptr(),
+            initializer: Some(HirExpression::NullLiteral),
+        }]
+    }
+
+    #[test]
+    fn test_pool_allocator_becomes_bounded_arena() {
+        let functions = [churn(), push(), main_fn()];
+        let plan =
+            IndexArenaPlan::plan_with_pools(&[node()], &pool_globals(), &functions, &[free_list()]);
+
+        assert_eq!(plan.arenas().len(), 1);
+        assert_eq!(plan.arenas()[0].capacity, Some(256));
+        assert!(plan.replaces_function("node_alloc"));
+        assert!(plan.replaces_function("pool_reset"));
+        assert!(plan.replaces_global("free_list"));
+        assert!(!plan.replaces_function("push"));
+    }
+
+    #[test]
+    fn test_pool_calls_become_arena_methods() {
+        let functions = [churn(), push(), main_fn()];
+        let plan =
+            IndexArenaPlan::plan_with_pools(&[node()], &pool_globals(), &functions, &[free_list()]);
+        let lowered = plan.lower_function(&churn());
+        let method = |method: &str, arguments| HirExpression::StringMethodCall {
+            receiver: Box::new(var("node_arena")),
+            method: method.to_string(),
+            arguments,
+        };
+
+        assert_eq!(
+            lowered.body(),
+            &[
+                HirStatement::VariableDeclaration {
+                    name: "n".to_string(),
+                    var_type: HirType::UnsignedInt,
+                    initializer: Some(method("alloc", vec![])),
+                },
+                HirStatement::Expression(method("free", vec![var("n")])),
+                HirStatement::Expression(method("reset", vec![])),
+            ]
+        );
+        assert_eq!(lowered.parameters()[0].name(), "node_arena");
+    }
+
+    #[test]
+    fn test_pool_allocation_outside_link_keeps_pointers() {
+        let leak = HirFunction::new_with_body(
+            "leak".to_string(),
+            HirType::Void,
+            vec![],
+            vec![HirStatement::Expression(call("node_alloc", vec![]))],
+        );
+        let functions = [leak, push()];
+        let plan =
+            IndexArenaPlan::plan_with_pools(&[node()], &pool_globals(), &functions, &[free_list()]);
+
+        assert!(plan.is_empty());
+        assert!(!plan.replaces_function("node_alloc"));
+    }
+
+    #[test]
+    fn test_snake_case_arena_names() {
+        assert_eq!(IndexArena::new("TreeNode").variable, "tree_node_arena");
+        assert_eq!(IndexArena::new("node").variable, "node_arena");
+    }
+}
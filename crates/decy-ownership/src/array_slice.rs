@@ -7,10 +7,14 @@
 //! - `void modify(int* arr, int len)` → `fn modify(arr: &mut [i32])`
 //!
 //! It also transforms the function body to replace length parameter
-//! references with `.len()` calls on the slice.
+//! references with `.len()` calls on the slice, and rewrites pointer walks
+//! bounded by the length (`while (arr < end) { ...; arr++; }`) into index
+//! loops so the walked parameter can become a slice as well.
 
 use crate::dataflow::DataflowGraph;
-use decy_hir::{HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+use decy_hir::visit::{fold_expression_children, fold_statement_children, walk_statements};
+use decy_hir::visit::{Fold, Visitor};
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
 use std::collections::HashMap;
 
 /// Information about an array parameter transformation
@@ -55,6 +59,9 @@ impl ArrayParameterTransformer {
             return func.clone();
         }
 
+        let walked = Self::index_pointer_walks(func, &array_params, dataflow);
+        let func = walked.as_ref().unwrap_or(func);
+
         // Build map of array params and length params to remove
         // DECY-163: Don't remove length params when array uses pointer arithmetic
         let mut array_param_map: HashMap<String, Option<String>> = HashMap::new();
@@ -119,6 +126,11 @@ impl ArrayParameterTransformer {
             })
             .collect();
 
+        // Without a length parameter to replace, the body is shared unchanged
+        if length_params_to_remove.is_empty() {
+            return func.with_parameters(new_parameters);
+        }
+
         // Transform function body to replace length parameter references with .len()
         let new_body: Vec<HirStatement> = func
             .body()
@@ -328,6 +340,255 @@ impl ArrayParameterTransformer {
             _ => false,
         }
     }
+
+    /// Rewrite pointer walks over array parameters into index loops.
+    ///
+    /// `T* end = arr + len; while (arr < end) { ... *arr ...; arr++; }`, and the
+    /// `for (; arr < end; arr++)` form, visit each element once in order. They
+    /// become `for (int arr_idx = 0; arr_idx < len; arr_idx++)` with `*arr`
+    /// read and written as `arr[arr_idx]`, after which the parameter no longer
+    /// uses pointer arithmetic and is transformed to a slice like any other.
+    ///
+    /// Returns `None` when no walk was rewritten.
+    fn index_pointer_walks(
+        func: &HirFunction,
+        array_params: &[(String, Option<String>)],
+        dataflow: &DataflowGraph,
+    ) -> Option<HirFunction> {
+        let mut body = func.body().to_vec();
+        // Index in `func` of each statement of `body`, for liveness queries
+        let mut origin: Vec<usize> = (0..body.len()).collect();
+        let mut changed = false;
+
+        for (array_param, length_param) in array_params {
+            let Some(len) = length_param else { continue };
+            let live_after = |pos: usize| dataflow.is_live_after(array_param, origin[pos]);
+            if let Some((walked, decl_pos)) =
+                Self::index_pointer_walk(&body, array_param, len, live_after)
+            {
+                body = walked;
+                origin.remove(decl_pos);
+                changed = true;
+            }
+        }
+
+        changed.then(|| func.with_body(body))
+    }
+
+    /// Rewrite the walk of `arr` up to `arr + len` in `body`, if it is the only
+    /// pointer arithmetic on `arr` and `arr` is not read after it, as told by
+    /// `live_after` for the statement at a position. Also returns the position
+    /// of the removed `end` declaration.
+    fn index_pointer_walk(
+        body: &[HirStatement],
+        arr: &str,
+        len: &str,
+        live_after: impl Fn(usize) -> bool,
+    ) -> Option<(Vec<HirStatement>, usize)> {
+        // T* end = arr + len;
+        let (decl_pos, end) = body.iter().enumerate().find_map(|(pos, stmt)| match stmt {
+            HirStatement::VariableDeclaration {
+                name,
+                var_type: HirType::Pointer(_),
+                initializer: Some(HirExpression::BinaryOp { op: BinaryOperator::Add, left, right }),
+            } if is_variable(left, arr) && is_variable(right, len) => Some((pos, name.as_str())),
+            _ => None,
+        })?;
+
+        let loop_pos = decl_pos
+            + 1
+            + body[decl_pos + 1..].iter().position(|s| walk_body(s, arr, end).is_some())?;
+        let (walk, is_while) = walk_body(&body[loop_pos], arr, end)?;
+
+        // `end` only bounds the loop, `arr` is dead afterwards and the index is fresh
+        let index = format!("{}_idx", arr);
+        let end_uses = NameUses::scan(body, end);
+        if end_uses.reads != 1 || end_uses.writes != 1 {
+            return None;
+        }
+        if live_after(loop_pos)
+            || NameUses::scan(&body[loop_pos + 1..], arr).writes != 0
+            || NameUses::scan(body, &index).mentioned()
+        {
+            return None;
+        }
+
+        // Inside the loop `arr` is only dereferenced; `continue` would skip `arr++`
+        let uses = NameUses::scan(walk, arr);
+        if uses.writes != 0 || uses.reads != uses.derefs || (is_while && uses.continues != 0) {
+            return None;
+        }
+
+        let index_var = || HirExpression::Variable(index.clone());
+        let walk = IndexCursor { cursor: arr, index: &index }.fold_block(walk.to_vec());
+        let counted = HirStatement::For {
+            init: vec![HirStatement::VariableDeclaration {
+                name: index.clone(),
+                var_type: HirType::Int,
+                initializer: Some(HirExpression::IntLiteral(0)),
+            }],
+            condition: Some(HirExpression::BinaryOp {
+                op: BinaryOperator::LessThan,
+                left: Box::new(index_var()),
+                right: Box::new(HirExpression::Variable(len.to_string())),
+            }),
+            increment: vec![HirStatement::Assignment {
+                target: index.clone(),
+                value: HirExpression::BinaryOp {
+                    op: BinaryOperator::Add,
+                    left: Box::new(index_var()),
+                    right: Box::new(HirExpression::IntLiteral(1)),
+                },
+            }],
+            body: walk,
+        };
+
+        let mut result = body.to_vec();
+        result[loop_pos] = counted;
+        result.remove(decl_pos);
+        if result.iter().any(|s| Self::statement_uses_pointer_arithmetic(s, arr)) {
+            return None;
+        }
+        Some((result, decl_pos))
+    }
+}
+
+fn is_variable(expr: &HirExpression, name: &str) -> bool {
+    matches!(expr, HirExpression::Variable(var) if var == name)
+}
+
+/// `p++`, `++p` or `p = p + 1` as a statement.
+fn is_unit_increment(stmt: &HirStatement, var: &str) -> bool {
+    match stmt {
+        HirStatement::Assignment {
+            target,
+            value: HirExpression::BinaryOp { op: BinaryOperator::Add, left, right },
+        } => target == var && is_variable(left, var) && **right == HirExpression::IntLiteral(1),
+        HirStatement::Expression(
+            HirExpression::PostIncrement { operand } | HirExpression::PreIncrement { operand },
+        ) => is_variable(operand, var),
+        _ => false,
+    }
+}
+
+/// Split `while (p < end) { body; p++; }` or `for (; p < end; p++) { body }`
+/// into its body without the increment, and whether it is the `while` form.
+fn walk_body<'a>(stmt: &'a HirStatement, p: &str, end: &str) -> Option<(&'a [HirStatement], bool)> {
+    let bounded = |cond: &HirExpression| {
+        matches!(
+            cond,
+            HirExpression::BinaryOp {
+                op: BinaryOperator::LessThan | BinaryOperator::NotEqual,
+                left,
+                right,
+            } if is_variable(left, p) && is_variable(right, end)
+        )
+    };
+    match stmt {
+        HirStatement::While { condition, body } if bounded(condition) => match body.split_last() {
+            Some((last, rest)) if is_unit_increment(last, p) => Some((rest, true)),
+            _ => None,
+        },
+        HirStatement::For { init, condition: Some(condition), increment, body }
+            if init.is_empty()
+                && bounded(condition)
+                && matches!(increment.as_slice(), [inc] if is_unit_increment(inc, p)) =>
+        {
+            Some((body, false))
+        }
+        _ => None,
+    }
+}
+
+/// How a name is used in a block.
+#[derive(Default)]
+struct NameUses<'a> {
+    name: &'a str,
+    /// Occurrences as an expression
+    reads: usize,
+    /// Occurrences as `*name`, read or written
+    derefs: usize,
+    /// Declarations of and assignments to the name
+    writes: usize,
+    /// `continue` statements anywhere in the block
+    continues: usize,
+}
+
+impl<'a> NameUses<'a> {
+    fn scan(stmts: &[HirStatement], name: &'a str) -> Self {
+        let mut uses = NameUses { name, ..Default::default() };
+        walk_statements(&mut uses, stmts);
+        uses
+    }
+
+    fn mentioned(&self) -> bool {
+        self.reads != 0 || self.writes != 0
+    }
+}
+
+impl Visitor for NameUses<'_> {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        match stmt {
+            HirStatement::VariableDeclaration { name, .. }
+            | HirStatement::Assignment { target: name, .. }
+                if name == self.name =>
+            {
+                self.writes += 1
+            }
+            HirStatement::DerefAssignment { target, .. } if is_variable(target, self.name) => {
+                self.derefs += 1
+            }
+            HirStatement::Continue => self.continues += 1,
+            _ => {}
+        }
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        match expr {
+            HirExpression::Variable(name) if name == self.name => self.reads += 1,
+            HirExpression::Dereference(inner) if is_variable(inner, self.name) => self.derefs += 1,
+            _ => {}
+        }
+    }
+}
+
+/// Replaces `*cursor` with `cursor[index]`.
+struct IndexCursor<'a> {
+    cursor: &'a str,
+    index: &'a str,
+}
+
+impl IndexCursor<'_> {
+    fn element(&self) -> HirExpression {
+        HirExpression::ArrayIndex {
+            array: Box::new(HirExpression::Variable(self.cursor.to_string())),
+            index: Box::new(HirExpression::Variable(self.index.to_string())),
+        }
+    }
+}
+
+impl Fold for IndexCursor<'_> {
+    fn fold_statement(&mut self, stmt: HirStatement) -> HirStatement {
+        match stmt {
+            HirStatement::DerefAssignment { target, value }
+                if is_variable(&target, self.cursor) =>
+            {
+                HirStatement::ArrayIndexAssignment {
+                    array: Box::new(target),
+                    index: Box::new(HirExpression::Variable(self.index.to_string())),
+                    value: self.fold_expression(value),
+                }
+            }
+            other => fold_statement_children(self, other),
+        }
+    }
+
+    fn fold_expression(&mut self, expr: HirExpression) -> HirExpression {
+        match expr {
+            HirExpression::Dereference(inner) if is_variable(&inner, self.cursor) => self.element(),
+            other => fold_expression_children(self, other),
+        }
+    }
 }
 
 impl Default for ArrayParameterTransformer {
@@ -1343,4 +1604,185 @@ mod tests {
         assert_eq!(result.parameters()[0].name(), "a");
         assert_eq!(result.parameters()[1].name(), "b");
     }
+
+    /// `int* end = arr + len;` as an HIR declaration
+    fn end_of(arr: &str, len: &str) -> HirStatement {
+        HirStatement::VariableDeclaration {
+            name: "end".to_string(),
+            var_type: HirType::Pointer(Box::new(HirType::Int)),
+            initializer: Some(HirExpression::BinaryOp {
+                op: BinaryOperator::Add,
+                left: Box::new(HirExpression::Variable(arr.to_string())),
+                right: Box::new(HirExpression::Variable(len.to_string())),
+            }),
+        }
+    }
+
+    fn arr_before_end() -> HirExpression {
+        HirExpression::BinaryOp {
+            op: BinaryOperator::LessThan,
+            left: Box::new(HirExpression::Variable("arr".to_string())),
+            right: Box::new(HirExpression::Variable("end".to_string())),
+        }
+    }
+
+    fn arr_increment() -> HirStatement {
+        HirStatement::Expression(HirExpression::PostIncrement {
+            operand: Box::new(HirExpression::Variable("arr".to_string())),
+        })
+    }
+
+    fn int_array_params() -> Vec<HirParameter> {
+        vec![
+            HirParameter::new("arr".to_string(), HirType::Pointer(Box::new(HirType::Int))),
+            HirParameter::new("size".to_string(), HirType::Int),
+        ]
+    }
+
+    #[test]
+    fn test_transform_pointer_walk_becomes_index_loop() {
+        // int sum(int* arr, int size) {
+        //     int s = 0; int* end = arr + size;
+        //     while (arr < end) { s = s + *arr; arr++; }
+        //     return s;
+        // }
+        let func = HirFunction::new_with_body(
+            "sum".to_string(),
+            HirType::Int,
+            int_array_params(),
+            vec![
+                HirStatement::VariableDeclaration {
+                    name: "s".to_string(),
+                    var_type: HirType::Int,
+                    initializer: Some(HirExpression::IntLiteral(0)),
+                },
+                end_of("arr", "size"),
+                HirStatement::While {
+                    condition: arr_before_end(),
+                    body: vec![
+                        HirStatement::Assignment {
+                            target: "s".to_string(),
+                            value: HirExpression::BinaryOp {
+                                op: BinaryOperator::Add,
+                                left: Box::new(HirExpression::Variable("s".to_string())),
+                                right: Box::new(HirExpression::Dereference(Box::new(
+                                    HirExpression::Variable("arr".to_string()),
+                                ))),
+                            },
+                        },
+                        arr_increment(),
+                    ],
+                },
+                HirStatement::Return(Some(HirExpression::Variable("s".to_string()))),
+            ],
+        );
+
+        let dfg = crate::dataflow::DataflowAnalyzer::new().analyze(&func);
+        let result = ArrayParameterTransformer::new().transform(&func, &dfg);
+
+        // The walk no longer moves arr, so it becomes a slice and size goes away
+        assert_eq!(result.parameters().len(), 1);
+        assert!(matches!(
+            result.parameters()[0].param_type(),
+            HirType::Reference { mutable: false, .. }
+        ));
+
+        // end is dropped and the loop counts arr_idx up to arr.len()
+        assert_eq!(result.body().len(), 3);
+        let HirStatement::For { init, condition, body, .. } = &result.body()[1] else {
+            panic!("expected an index loop, got {:?}", result.body()[1]);
+        };
+        assert!(matches!(
+            &init[..],
+            [HirStatement::VariableDeclaration { name, .. }] if name == "arr_idx"
+        ));
+        assert!(matches!(
+            condition,
+            Some(HirExpression::BinaryOp { right, .. })
+                if matches!(&**right, HirExpression::StringMethodCall { method, .. } if method == "len")
+        ));
+        assert!(matches!(
+            &body[..],
+            [HirStatement::Assignment { value: HirExpression::BinaryOp { right, .. }, .. }]
+                if matches!(&**right, HirExpression::ArrayIndex { index, .. }
+                    if **index == HirExpression::Variable("arr_idx".to_string()))
+        ));
+    }
+
+    #[test]
+    fn test_transform_for_pointer_walk_writes_through_index() {
+        // void clear(int* arr, int size) {
+        //     int* end = arr + size;
+        //     for (; arr < end; arr++) *arr = 0;
+        // }
+        let func = HirFunction::new_with_body(
+            "clear".to_string(),
+            HirType::Void,
+            int_array_params(),
+            vec![
+                end_of("arr", "size"),
+                HirStatement::For {
+                    init: vec![],
+                    condition: Some(arr_before_end()),
+                    increment: vec![arr_increment()],
+                    body: vec![HirStatement::DerefAssignment {
+                        target: HirExpression::Variable("arr".to_string()),
+                        value: HirExpression::IntLiteral(0),
+                    }],
+                },
+            ],
+        );
+
+        let dfg = crate::dataflow::DataflowAnalyzer::new().analyze(&func);
+        let result = ArrayParameterTransformer::new().transform(&func, &dfg);
+
+        assert_eq!(result.parameters().len(), 1);
+        assert!(matches!(
+            result.parameters()[0].param_type(),
+            HirType::Reference { mutable: true, .. }
+        ));
+        let HirStatement::For { body, .. } = &result.body()[0] else {
+            panic!("expected an index loop, got {:?}", result.body()[0]);
+        };
+        assert!(matches!(&body[..], [HirStatement::ArrayIndexAssignment { .. }]));
+    }
+
+    #[test]
+    fn test_transform_pointer_walk_read_after_loop_keeps_pointer() {
+        // int* skip(int* arr, int size) {
+        //     int* end = arr + size;
+        //     while (arr < end) { if (*arr) break; arr++; }
+        //     return arr;
+        // }
+        let func = HirFunction::new_with_body(
+            "skip".to_string(),
+            HirType::Pointer(Box::new(HirType::Int)),
+            int_array_params(),
+            vec![
+                end_of("arr", "size"),
+                HirStatement::While {
+                    condition: arr_before_end(),
+                    body: vec![
+                        HirStatement::If {
+                            condition: HirExpression::Dereference(Box::new(
+                                HirExpression::Variable("arr".to_string()),
+                            )),
+                            then_block: vec![HirStatement::Break],
+                            else_block: None,
+                        },
+                        arr_increment(),
+                    ],
+                },
+                HirStatement::Return(Some(HirExpression::Variable("arr".to_string()))),
+            ],
+        );
+
+        let dfg = crate::dataflow::DataflowAnalyzer::new().analyze(&func);
+        let result = ArrayParameterTransformer::new().transform(&func, &dfg);
+
+        // The final position escapes, so the walk stays on the raw pointer
+        assert_eq!(result.parameters().len(), 2);
+        assert!(matches!(result.parameters()[0].param_type(), HirType::Pointer(_)));
+        assert!(matches!(result.body()[1], HirStatement::While { .. }));
+    }
 }
@@ -102,13 +102,28 @@ impl BorrowGenerator {
         inferences: &HashMap<String, OwnershipInference>,
     ) -> HirFunction {
         // DECY-072: Build dataflow graph to detect array parameters
-        let dataflow_analyzer = crate::dataflow::DataflowAnalyzer::new();
-        let dataflow_graph = dataflow_analyzer.analyze(func);
+        let dataflow_graph = crate::dataflow::DataflowAnalyzer::new().analyze(func);
+        self.transform_function_with_dataflow(func, inferences, &dataflow_graph)
+    }
 
+    /// [`transform_function`](Self::transform_function) with the dataflow
+    /// graph the inferences were made from.
+    pub fn transform_function_with_dataflow(
+        &self,
+        func: &HirFunction,
+        inferences: &HashMap<String, OwnershipInference>,
+        dataflow_graph: &crate::dataflow::DataflowGraph,
+    ) -> HirFunction {
         // DECY-072: Transform parameters with array detection
         // DECY-161: Also pass function to check for pointer arithmetic
         let (transformed_params, length_params_to_remove) =
-            self.transform_parameters_with_array_detection(func, inferences, &dataflow_graph);
+            self.transform_parameters_with_array_detection(func, inferences, dataflow_graph);
+
+        // The body only changes when a length parameter is replaced or an array
+        // pointer is indexed; otherwise share it instead of rebuilding it.
+        if length_params_to_remove.is_empty() && !Self::has_array_pointers(inferences) {
+            return func.with_parameters(transformed_params);
+        }
 
         // DECY-070 + DECY-072: Transform function body
         // - Convert pointer arithmetic to SliceIndex (DECY-070)
@@ -136,6 +151,12 @@ impl BorrowGenerator {
         result
     }
 
+    /// Check whether any variable was inferred as an array pointer, the only
+    /// inference that makes the DECY-070 rewrite touch the body.
+    fn has_array_pointers(inferences: &HashMap<String, OwnershipInference>) -> bool {
+        inferences.values().any(|inf| matches!(inf.kind, OwnershipKind::ArrayPointer { .. }))
+    }
+
     /// Transform parameters with array parameter detection.
     /// DECY-072: Detects array parameters and transforms them to slices.
     /// DECY-161: Skip slice transformation if parameter uses pointer arithmetic.
@@ -242,13 +263,16 @@ impl BorrowGenerator {
     }
 
     /// Check if a parameter is mutated in the function body.
-    /// DECY-072: Scans for ArrayIndexAssignment statements that modify the parameter.
+    /// DECY-072: Scans for ArrayIndexAssignment statements that modify the parameter,
+    /// and asks the dataflow graph for writes the scan misses, such as an
+    /// element address handed to a callee.
     fn is_parameter_mutated(
         &self,
         var_name: &str,
         dataflow_graph: &crate::dataflow::DataflowGraph,
     ) -> bool {
         dataflow_graph.body().iter().any(|stmt| self.statement_mutates_variable(stmt, var_name))
+            || dataflow_graph.is_modified(var_name)
     }
 
     /// Recursively check if a statement mutates a variable.
@@ -2458,3 +2458,34 @@ fn test_transform_inline_asm_passes_through() {
         other => panic!("Expected InlineAsm, got {:?}", other),
     }
 }
+
+#[test]
+fn test_transform_function_shares_untouched_body() {
+    // Only the parameter type changes, so the body must not be rebuilt
+    let func = HirFunction::new_with_body(
+        "read".to_string(),
+        HirType::Int,
+        vec![HirParameter::new("p".to_string(), HirType::Pointer(Box::new(HirType::Int)))],
+        vec![HirStatement::Return(Some(HirExpression::Dereference(Box::new(
+            HirExpression::Variable("p".to_string()),
+        ))))],
+    );
+    let mut inferences = HashMap::new();
+    inferences.insert(
+        "p".to_string(),
+        OwnershipInference {
+            variable: "p".to_string(),
+            kind: OwnershipKind::ImmutableBorrow,
+            confidence: 0.8,
+            reason: "Test inference".to_string(),
+        },
+    );
+
+    let transformed = BorrowGenerator::new().transform_function(&func, &inferences);
+
+    assert!(transformed.shares_body_with(&func));
+    assert_eq!(
+        transformed.parameters()[0].param_type(),
+        &HirType::Reference { inner: Box::new(HirType::Int), mutable: false }
+    );
+}
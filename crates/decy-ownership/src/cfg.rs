@@ -0,0 +1,902 @@
+//! Control-flow graph and bitvector dataflow solver.
+//!
+//! Lowers a HIR function body to a statement-level control-flow graph with
+//! dense variable ids, then solves gen/kill problems over bitvectors with a
+//! worklist. Three analyses are provided on top of the generic solver:
+//! reaching definitions, liveness and "maybe freed" state. Loops and branches
+//! are modelled explicitly, so a `free()` at the end of a loop body reaches a
+//! use at the top of the next iteration, and a reassignment after `free()`
+//! clears the freed state on that path only.
+//!
+//! Lowering also records what each pointer definition binds, so the
+//! [`DataflowGraph`](crate::dataflow::DataflowGraph) is built from the CFG
+//! alone.
+//!
+//! A call writes through a pointer argument when the callee's ownership
+//! summary or C library prototype says so, or when it goes through a
+//! function pointer, whose target is unknown.
+
+use crate::dataflow::{self, NodeKind};
+use crate::summary::{self, OwnershipSummaries};
+use decy_hir::{HirExpression, HirFunction, HirStatement, HirType, UnaryOperator};
+use std::collections::{HashMap, HashSet, VecDeque};
+
+/// Dense identifier for a variable within one function.
+pub type VarId = usize;
+
+/// Fixed-size bitvector used as the dataflow lattice element.
+#[derive(Debug, Clone, Default, PartialEq, Eq, Hash)]
+pub struct BitSet {
+    words: Vec<u64>,
+    size: usize,
+}
+
+impl BitSet {
+    /// Create an empty set over `size` elements.
+    pub fn new(size: usize) -> Self {
+        Self { words: vec![0; size.div_ceil(64)], size }
+    }
+
+    /// Create a set containing every element in `0..size`.
+    pub fn full(size: usize) -> Self {
+        let mut set = Self { words: vec![u64::MAX; size.div_ceil(64)], size };
+        if size % 64 != 0 {
+            if let Some(last) = set.words.last_mut() {
+                *last = (1u64 << (size % 64)) - 1;
+            }
+        }
+        set
+    }
+
+    /// Number of elements in the universe.
+    pub fn capacity(&self) -> usize {
+        self.size
+    }
+
+    /// Insert an element. Returns true if it was not already present.
+    pub fn insert(&mut self, bit: usize) -> bool {
+        let (word, mask) = (bit / 64, 1u64 << (bit % 64));
+        let was_set = self.words[word] & mask != 0;
+        self.words[word] |= mask;
+        !was_set
+    }
+
+    /// Remove an element.
+    pub fn remove(&mut self, bit: usize) {
+        self.words[bit / 64] &= !(1u64 << (bit % 64));
+    }
+
+    /// Check whether an element is present.
+    pub fn contains(&self, bit: usize) -> bool {
+        bit < self.size && self.words[bit / 64] & (1u64 << (bit % 64)) != 0
+    }
+
+    /// In-place union. Returns true if `self` changed.
+    pub fn union_with(&mut self, other: &BitSet) -> bool {
+        let mut changed = false;
+        for (a, b) in self.words.iter_mut().zip(&other.words) {
+            let next = *a | b;
+            changed |= next != *a;
+            *a = next;
+        }
+        changed
+    }
+
+    /// In-place intersection. Returns true if `self` changed.
+    pub fn intersect_with(&mut self, other: &BitSet) -> bool {
+        let mut changed = false;
+        for (a, b) in self.words.iter_mut().zip(&other.words) {
+            let next = *a & b;
+            changed |= next != *a;
+            *a = next;
+        }
+        changed
+    }
+
+    /// In-place difference (`self \ other`).
+    pub fn subtract(&mut self, other: &BitSet) {
+        for (a, b) in self.words.iter_mut().zip(&other.words) {
+            *a &= !b;
+        }
+    }
+
+    /// Check whether the set is empty.
+    pub fn is_empty(&self) -> bool {
+        self.words.iter().all(|w| *w == 0)
+    }
+
+    /// Number of elements present.
+    pub fn count(&self) -> usize {
+        self.words.iter().map(|w| w.count_ones() as usize).sum()
+    }
+
+    /// Iterate over present elements in ascending order.
+    pub fn iter(&self) -> impl Iterator<Item = usize> + '_ {
+        self.words.iter().enumerate().flat_map(|(i, &word)| {
+            let mut rest = word;
+            std::iter::from_fn(move || {
+                if rest == 0 {
+                    return None;
+                }
+                let bit = rest.trailing_zeros() as usize;
+                rest &= rest - 1;
+                Some(i * 64 + bit)
+            })
+        })
+    }
+}
+
+/// Interning table mapping variable names to dense ids.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct VarTable {
+    ids: HashMap<String, VarId>,
+    names: Vec<String>,
+}
+
+impl VarTable {
+    /// Get or assign the id for a variable name.
+    pub fn intern(&mut self, name: &str) -> VarId {
+        if let Some(&id) = self.ids.get(name) {
+            return id;
+        }
+        let id = self.names.len();
+        self.ids.insert(name.to_string(), id);
+        self.names.push(name.to_string());
+        id
+    }
+
+    /// Look up the id of a variable name.
+    pub fn id(&self, name: &str) -> Option<VarId> {
+        self.ids.get(name).copied()
+    }
+
+    /// Look up the name of a variable id.
+    pub fn name(&self, id: VarId) -> &str {
+        &self.names[id]
+    }
+
+    /// Number of distinct variables.
+    pub fn len(&self) -> usize {
+        self.names.len()
+    }
+
+    /// Whether no variables have been interned.
+    pub fn is_empty(&self) -> bool {
+        self.names.is_empty()
+    }
+}
+
+/// Kind of a CFG node.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum CfgNodeKind {
+    /// Function entry (defines parameters)
+    Entry,
+    /// Function exit
+    Exit,
+    /// Straight-line statement
+    Statement,
+    /// Branch or loop condition
+    Condition,
+}
+
+/// A single node of the control-flow graph with its variable facts.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct CfgNode {
+    /// Node kind
+    pub kind: CfgNodeKind,
+    /// Index of the enclosing top-level statement in the function body
+    pub stmt_index: usize,
+    /// Variables (re)defined here
+    pub defs: Vec<VarId>,
+    /// Of those, pointers and arrays, with what the definition binds
+    pub pointer_defs: Vec<(VarId, NodeKind)>,
+    /// Variables read here
+    pub uses: Vec<VarId>,
+    /// Pointers released here (`free`, `delete`)
+    pub frees: Vec<VarId>,
+    /// Pointers written through here (`*p = v`, `p[i] = v`, or passed to a
+    /// callee that writes through them)
+    pub writes_through: Vec<VarId>,
+    /// Successor node indices
+    pub succs: Vec<usize>,
+    /// Predecessor node indices
+    pub preds: Vec<usize>,
+}
+
+impl CfgNode {
+    fn new(kind: CfgNodeKind, stmt_index: usize) -> Self {
+        Self {
+            kind,
+            stmt_index,
+            defs: Vec::new(),
+            pointer_defs: Vec::new(),
+            uses: Vec::new(),
+            frees: Vec::new(),
+            writes_through: Vec::new(),
+            succs: Vec::new(),
+            preds: Vec::new(),
+        }
+    }
+}
+
+/// Statement-level control-flow graph of one function.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct Cfg {
+    nodes: Vec<CfgNode>,
+    vars: VarTable,
+}
+
+/// Index of the entry node.
+pub const ENTRY: usize = 0;
+/// Index of the exit node.
+pub const EXIT: usize = 1;
+
+impl Cfg {
+    /// Lower a HIR function to a control-flow graph. Of direct calls, only
+    /// C library functions are known to write through their arguments.
+    pub fn build(func: &HirFunction) -> Self {
+        Self::lower_function(func, None)
+    }
+
+    /// Lower a HIR function to a control-flow graph, taking what calls to
+    /// the unit's functions write through from their ownership summaries.
+    pub fn build_with_summaries(func: &HirFunction, summaries: &OwnershipSummaries) -> Self {
+        Self::lower_function(func, Some(summaries))
+    }
+
+    fn lower_function(func: &HirFunction, summaries: Option<&OwnershipSummaries>) -> Self {
+        let mut builder = CfgBuilder { summaries, ..CfgBuilder::default() };
+        builder.nodes.push(CfgNode::new(CfgNodeKind::Entry, 0));
+        builder.nodes.push(CfgNode::new(CfgNodeKind::Exit, func.body().len()));
+        for param in func.parameters() {
+            let id = builder.vars.intern(param.name());
+            builder.nodes[ENTRY].defs.push(id);
+            match param.param_type() {
+                HirType::Pointer(_) | HirType::Box(_) => {
+                    builder.pointers.insert(id);
+                    builder.nodes[ENTRY].pointer_defs.push((id, NodeKind::Parameter));
+                }
+                HirType::FunctionPointer { .. } => {
+                    builder.callbacks.insert(param.name().to_string());
+                }
+                _ => {}
+            }
+        }
+
+        let mut frontier = vec![ENTRY];
+        for (index, stmt) in func.body().iter().enumerate() {
+            frontier = builder.lower(stmt, index, frontier);
+        }
+        builder.connect_all(&frontier, EXIT);
+
+        Self { nodes: builder.nodes, vars: builder.vars }
+    }
+
+    /// All nodes, indexed by node id.
+    pub fn nodes(&self) -> &[CfgNode] {
+        &self.nodes
+    }
+
+    /// Variable interning table.
+    pub fn vars(&self) -> &VarTable {
+        &self.vars
+    }
+
+    /// Nodes in reverse post-order from the entry (reachable nodes only).
+    pub fn reverse_postorder(&self) -> Vec<usize> {
+        let mut visited = vec![false; self.nodes.len()];
+        let mut order = Vec::with_capacity(self.nodes.len());
+        let mut stack = vec![(ENTRY, 0usize)];
+        visited[ENTRY] = true;
+        while let Some(top) = stack.last_mut() {
+            let (node, next) = *top;
+            if let Some(&succ) = self.nodes[node].succs.get(next) {
+                top.1 += 1;
+                if !visited[succ] {
+                    visited[succ] = true;
+                    stack.push((succ, 0));
+                }
+            } else {
+                order.push(node);
+                stack.pop();
+            }
+        }
+        order.reverse();
+        order
+    }
+
+    /// Solve reaching definitions.
+    ///
+    /// The domain is every definition site; each site kills all other
+    /// definitions of the same variable.
+    pub fn reaching_definitions(&self) -> ReachingDefinitions {
+        let mut sites = Vec::new();
+        let mut sites_by_var: Vec<Vec<usize>> = vec![Vec::new(); self.vars.len()];
+        for (node, n) in self.nodes.iter().enumerate() {
+            for &var in &n.defs {
+                sites_by_var[var].push(sites.len());
+                sites.push((node, var));
+            }
+        }
+
+        let domain = sites.len();
+        let mut gen = vec![BitSet::new(domain); self.nodes.len()];
+        let mut kill = vec![BitSet::new(domain); self.nodes.len()];
+        for (site, &(node, var)) in sites.iter().enumerate() {
+            for &other in &sites_by_var[var] {
+                kill[node].insert(other);
+            }
+            gen[node].insert(site);
+        }
+        for (node, g) in gen.iter().enumerate() {
+            kill[node].subtract(g);
+        }
+
+        let problem = GenKill {
+            direction: Direction::Forward,
+            meet: Meet::Union,
+            domain,
+            gen,
+            kill,
+            boundary: BitSet::new(domain),
+        };
+        ReachingDefinitions { sites, solution: problem.solve(self) }
+    }
+
+    /// Solve liveness: a variable is live before a node if some path from
+    /// there reads it before redefining it.
+    pub fn liveness(&self) -> Solution {
+        let domain = self.vars.len();
+        let problem = GenKill {
+            direction: Direction::Backward,
+            meet: Meet::Union,
+            domain,
+            gen: self.nodes.iter().map(|n| bitset_of(domain, &n.uses)).collect(),
+            kill: self.nodes.iter().map(|n| bitset_of(domain, &n.defs)).collect(),
+            boundary: BitSet::new(domain),
+        };
+        problem.solve(self)
+    }
+
+    /// Solve "maybe freed": a pointer is freed before a node if some path
+    /// from the entry frees it without redefining it afterwards.
+    pub fn freed_state(&self) -> Solution {
+        let domain = self.vars.len();
+        let problem = GenKill {
+            direction: Direction::Forward,
+            meet: Meet::Union,
+            domain,
+            gen: self.nodes.iter().map(|n| bitset_of(domain, &n.frees)).collect(),
+            kill: self.nodes.iter().map(|n| bitset_of(domain, &n.defs)).collect(),
+            boundary: BitSet::new(domain),
+        };
+        problem.solve(self)
+    }
+
+    /// Uses of pointers that may already have been freed, as
+    /// `(variable, top-level statement index)` pairs.
+    pub fn use_after_free(&self) -> Vec<(VarId, usize)> {
+        let freed = self.freed_state();
+        let mut found = Vec::new();
+        for (node, n) in self.nodes.iter().enumerate() {
+            for &var in &n.uses {
+                if freed.before[node].contains(var) {
+                    found.push((var, n.stmt_index));
+                }
+            }
+        }
+        found.sort_unstable();
+        found.dedup();
+        found
+    }
+}
+
+fn bitset_of(domain: usize, items: &[usize]) -> BitSet {
+    let mut set = BitSet::new(domain);
+    for &item in items {
+        set.insert(item);
+    }
+    set
+}
+
+/// Direction in which facts propagate.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Direction {
+    /// Along control flow (entry to exit)
+    Forward,
+    /// Against control flow (exit to entry)
+    Backward,
+}
+
+/// How facts from several incoming edges combine.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Meet {
+    /// May analysis: fact holds on some path
+    Union,
+    /// Must analysis: fact holds on every path
+    Intersection,
+}
+
+/// A gen/kill dataflow problem over a [`Cfg`].
+#[derive(Debug, Clone)]
+pub struct GenKill {
+    /// Propagation direction
+    pub direction: Direction,
+    /// Meet operator
+    pub meet: Meet,
+    /// Size of the fact domain
+    pub domain: usize,
+    /// Facts generated per node
+    pub gen: Vec<BitSet>,
+    /// Facts killed per node
+    pub kill: Vec<BitSet>,
+    /// Facts at the entry (forward) or exit (backward) boundary
+    pub boundary: BitSet,
+}
+
+/// Fixpoint of a dataflow problem, in program order.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct Solution {
+    /// Facts holding immediately before each node executes
+    pub before: Vec<BitSet>,
+    /// Facts holding immediately after each node executes
+    pub after: Vec<BitSet>,
+}
+
+impl GenKill {
+    /// Solve the problem to a fixpoint with a worklist seeded in
+    /// (reverse) post-order.
+    pub fn solve(&self, cfg: &Cfg) -> Solution {
+        let count = cfg.nodes.len();
+        let top = match self.meet {
+            Meet::Union => BitSet::new(self.domain),
+            Meet::Intersection => BitSet::full(self.domain),
+        };
+        // `input` is what flows into the transfer function, `output` what leaves it
+        let mut input = vec![top.clone(); count];
+        let mut output = vec![top.clone(); count];
+
+        let mut order = cfg.reverse_postorder();
+        let boundary_node = match self.direction {
+            Direction::Forward => ENTRY,
+            Direction::Backward => {
+                order.reverse();
+                EXIT
+            }
+        };
+        // Unreachable nodes still get a (meet-of-nothing) solution
+        let mut queued = vec![false; count];
+        for &node in &order {
+            queued[node] = true;
+        }
+        for (node, seen) in queued.iter_mut().enumerate() {
+            if !*seen {
+                order.push(node);
+                *seen = true;
+            }
+        }
+        let mut worklist: VecDeque<usize> = order.into();
+
+        while let Some(node) = worklist.pop_front() {
+            queued[node] = false;
+            let n = &cfg.nodes[node];
+            let (sources, targets) = match self.direction {
+                Direction::Forward => (&n.preds, &n.succs),
+                Direction::Backward => (&n.succs, &n.preds),
+            };
+
+            let mut incoming = if node == boundary_node {
+                self.boundary.clone()
+            } else if sources.is_empty() {
+                top.clone()
+            } else {
+                let mut acc = output[sources[0]].clone();
+                for &src in &sources[1..] {
+                    match self.meet {
+                        Meet::Union => acc.union_with(&output[src]),
+                        Meet::Intersection => acc.intersect_with(&output[src]),
+                    };
+                }
+                acc
+            };
+            input[node] = incoming.clone();
+
+            incoming.subtract(&self.kill[node]);
+            incoming.union_with(&self.gen[node]);
+            if incoming != output[node] {
+                output[node] = incoming;
+                for &target in targets {
+                    if !queued[target] {
+                        queued[target] = true;
+                        worklist.push_back(target);
+                    }
+                }
+            }
+        }
+
+        match self.direction {
+            Direction::Forward => Solution { before: input, after: output },
+            Direction::Backward => Solution { before: output, after: input },
+        }
+    }
+}
+
+/// Reaching-definitions result.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct ReachingDefinitions {
+    /// Definition sites as `(node, variable)`; the bit index is the site id
+    pub sites: Vec<(usize, VarId)>,
+    /// Fixpoint over site ids
+    pub solution: Solution,
+}
+
+impl ReachingDefinitions {
+    /// Nodes whose definition of `var` may reach the start of `node`.
+    pub fn reaching(&self, node: usize, var: VarId) -> Vec<usize> {
+        self.solution.before[node]
+            .iter()
+            .map(|site| self.sites[site])
+            .filter(|&(_, v)| v == var)
+            .map(|(def_node, _)| def_node)
+            .collect()
+    }
+}
+
+/// Pending jump targets for the innermost breakable construct.
+struct JumpScope {
+    is_loop: bool,
+    breaks: Vec<usize>,
+    continues: Vec<usize>,
+}
+
+#[derive(Default)]
+struct CfgBuilder<'a> {
+    nodes: Vec<CfgNode>,
+    vars: VarTable,
+    scopes: Vec<JumpScope>,
+    /// What the unit's functions do with their arguments
+    summaries: Option<&'a OwnershipSummaries>,
+    /// Function-pointer parameters and locals
+    callbacks: HashSet<String>,
+    /// Variables currently declared as pointers
+    pointers: HashSet<VarId>,
+}
+
+impl CfgBuilder<'_> {
+    fn add(&mut self, node: CfgNode, preds: &[usize]) -> usize {
+        let id = self.nodes.len();
+        self.nodes.push(node);
+        self.connect_all(preds, id);
+        id
+    }
+
+    fn connect(&mut self, from: usize, to: usize) {
+        if !self.nodes[from].succs.contains(&to) {
+            self.nodes[from].succs.push(to);
+            self.nodes[to].preds.push(from);
+        }
+    }
+
+    fn connect_all(&mut self, from: &[usize], to: usize) {
+        for &f in from {
+            self.connect(f, to);
+        }
+    }
+
+    fn condition(&mut self, expr: Option<&HirExpression>, index: usize, preds: &[usize]) -> usize {
+        let mut node = CfgNode::new(CfgNodeKind::Condition, index);
+        if let Some(expr) = expr {
+            self.expression(expr, &mut node);
+        }
+        self.add(node, preds)
+    }
+
+    fn lower_block(
+        &mut self,
+        stmts: &[HirStatement],
+        index: usize,
+        preds: Vec<usize>,
+    ) -> Vec<usize> {
+        stmts.iter().fold(preds, |frontier, stmt| self.lower(stmt, index, frontier))
+    }
+
+    /// Lower one statement; returns the nodes that fall through to whatever
+    /// comes next.
+    fn lower(&mut self, stmt: &HirStatement, index: usize, preds: Vec<usize>) -> Vec<usize> {
+        match stmt {
+            HirStatement::If { condition, then_block, else_block } => {
+                let cond = self.condition(Some(condition), index, &preds);
+                let mut out = self.lower_block(then_block, index, vec![cond]);
+                match else_block {
+                    Some(else_stmts) => out.extend(self.lower_block(else_stmts, index, vec![cond])),
+                    None => out.push(cond),
+                }
+                out
+            }
+            HirStatement::While { condition, body } => {
+                let cond = self.condition(Some(condition), index, &preds);
+                let scope = self.in_scope(true, |b| b.lower_block(body, index, vec![cond]));
+                self.connect_all(&scope.0, cond);
+                self.connect_all(&scope.1.continues, cond);
+                let mut out = scope.1.breaks;
+                out.push(cond);
+                out
+            }
+            HirStatement::For { init, condition, increment, body } => {
+                let init_out = self.lower_block(init, index, preds);
+                let cond = self.condition(condition.as_ref(), index, &init_out);
+                let (body_out, jumps) =
+                    self.in_scope(true, |b| b.lower_block(body, index, vec![cond]));
+                let mut latch = body_out;
+                latch.extend(jumps.continues);
+                let inc_out = self.lower_block(increment, index, latch);
+                self.connect_all(&inc_out, cond);
+                let mut out = jumps.breaks;
+                if condition.is_some() {
+                    out.push(cond);
+                }
+                out
+            }
+            HirStatement::Switch { condition, cases, default_case } => {
+                let cond = self.condition(Some(condition), index, &preds);
+                let (last_out, jumps) = self.in_scope(false, |b| {
+                    // Case bodies fall through into the next case
+                    let mut fallthrough = Vec::new();
+                    for case in cases {
+                        let mut entry = fallthrough;
+                        entry.push(cond);
+                        fallthrough = b.lower_block(&case.body, index, entry);
+                    }
+                    if let Some(default_stmts) = default_case {
+                        let mut entry = fallthrough;
+                        entry.push(cond);
+                        fallthrough = b.lower_block(default_stmts, index, entry);
+                    }
+                    fallthrough
+                });
+                let mut out = last_out;
+                out.extend(jumps.breaks);
+                if default_case.is_none() {
+                    out.push(cond);
+                }
+                out
+            }
+            HirStatement::Break => {
+                match self.scopes.last_mut() {
+                    Some(scope) => scope.breaks.extend(preds),
+                    None => self.connect_all(&preds, EXIT),
+                }
+                Vec::new()
+            }
+            HirStatement::Continue => {
+                match self.scopes.iter_mut().rev().find(|s| s.is_loop) {
+                    Some(scope) => scope.continues.extend(preds),
+                    None => self.connect_all(&preds, EXIT),
+                }
+                Vec::new()
+            }
+            HirStatement::Return(expr) => {
+                let mut node = CfgNode::new(CfgNodeKind::Statement, index);
+                if let Some(expr) = expr {
+                    self.expression(expr, &mut node);
+                }
+                let id = self.add(node, &preds);
+                self.connect(id, EXIT);
+                Vec::new()
+            }
+            _ => {
+                let mut node = CfgNode::new(CfgNodeKind::Statement, index);
+                self.simple_statement(stmt, &mut node);
+                vec![self.add(node, &preds)]
+            }
+        }
+    }
+
+    fn in_scope<T>(&mut self, is_loop: bool, f: impl FnOnce(&mut Self) -> T) -> (T, JumpScope) {
+        self.scopes.push(JumpScope { is_loop, breaks: Vec::new(), continues: Vec::new() });
+        let result = f(self);
+        let scope = self.scopes.pop().expect("scope pushed above");
+        (result, scope)
+    }
+
+    /// Record the facts of a statement without nested blocks.
+    fn simple_statement(&mut self, stmt: &HirStatement, node: &mut CfgNode) {
+        match stmt {
+            HirStatement::VariableDeclaration { name, var_type, initializer } => {
+                if let Some(init) = initializer {
+                    self.expression(init, node);
+                }
+                let id = self.vars.intern(name);
+                node.defs.push(id);
+                self.pointers.remove(&id);
+                match var_type {
+                    HirType::Array { element_type, size } => {
+                        let kind = NodeKind::ArrayAllocation {
+                            size: *size,
+                            element_type: (**element_type).clone(),
+                        };
+                        node.pointer_defs.push((id, kind));
+                    }
+                    HirType::Pointer(_) | HirType::Box(_) => {
+                        self.pointers.insert(id);
+                        if let Some(init) = initializer {
+                            node.pointer_defs.push((id, dataflow::classify_initialization(init)));
+                        }
+                    }
+                    HirType::FunctionPointer { .. } => {
+                        self.callbacks.insert(name.clone());
+                    }
+                    _ => {}
+                }
+            }
+            HirStatement::Assignment { target, value } => {
+                self.expression(value, node);
+                let id = self.vars.intern(target);
+                node.defs.push(id);
+                if self.pointers.contains(&id) {
+                    node.pointer_defs.push((id, dataflow::classify_initialization(value)));
+                }
+            }
+            HirStatement::DerefAssignment { target, value } => {
+                self.expression(target, node);
+                self.expression(value, node);
+                if let HirExpression::Variable(name) = target {
+                    node.writes_through.push(self.vars.intern(name));
+                }
+            }
+            HirStatement::ArrayIndexAssignment { array, index, value } => {
+                self.expression(array, node);
+                self.expression(index, node);
+                self.expression(value, node);
+                if let HirExpression::Variable(name) = &**array {
+                    node.writes_through.push(self.vars.intern(name));
+                }
+            }
+            HirStatement::FieldAssignment { object, value, .. } => {
+                self.expression(object, node);
+                self.expression(value, node);
+            }
+            HirStatement::Free { pointer } => {
+                self.expression(pointer, node);
+                if let HirExpression::Variable(name) = pointer {
+                    node.frees.push(self.vars.intern(name));
+                }
+            }
+            HirStatement::Expression(expr) => self.expression(expr, node),
+            // Control flow is lowered by `lower`; inline asm has no tracked facts
+            HirStatement::Return(_)
+            | HirStatement::If { .. }
+            | HirStatement::While { .. }
+            | HirStatement::For { .. }
+            | HirStatement::Switch { .. }
+            | HirStatement::Break
+            | HirStatement::Continue
+            | HirStatement::InlineAsm { .. } => {}
+        }
+    }
+
+    /// Whether a call to `function` may write through its argument at
+    /// `index`. A call through a function pointer may write through any.
+    fn callee_writes_through(&self, function: &str, index: usize) -> bool {
+        if self.callbacks.contains(function) {
+            return true;
+        }
+        match self.summaries {
+            Some(summaries) => summaries.writes_through(function, index),
+            None => summary::libc_writes_through(function, index),
+        }
+    }
+
+    /// Record variable reads (and in-expression frees/updates) of an expression.
+    fn expression(&mut self, expr: &HirExpression, node: &mut CfgNode) {
+        match expr {
+            HirExpression::Variable(name) => node.uses.push(self.vars.intern(name)),
+            HirExpression::FunctionCall { function, arguments } => {
+                let frees = function == "free";
+                if frees {
+                    if let Some(HirExpression::Variable(name)) = arguments.first() {
+                        node.frees.push(self.vars.intern(name));
+                    }
+                }
+                for (index, arg) in arguments.iter().enumerate() {
+                    self.expression(arg, node);
+                    if !frees && self.callee_writes_through(function, index) {
+                        if let Some(name) = written_pointer(arg) {
+                            node.writes_through.push(self.vars.intern(name));
+                        }
+                    }
+                }
+            }
+            HirExpression::CxxDelete { operand } => {
+                self.expression(operand, node);
+                if let HirExpression::Variable(name) = &**operand {
+                    node.frees.push(self.vars.intern(name));
+                }
+            }
+            HirExpression::PostIncrement { operand }
+            | HirExpression::PreIncrement { operand }
+            | HirExpression::PostDecrement { operand }
+            | HirExpression::PreDecrement { operand } => {
+                self.expression(operand, node);
+                if let HirExpression::Variable(name) = &**operand {
+                    node.defs.push(self.vars.intern(name));
+                }
+            }
+            HirExpression::Dereference(inner)
+            | HirExpression::AddressOf(inner)
+            | HirExpression::IsNotNull(inner) => self.expression(inner, node),
+            HirExpression::UnaryOp { operand, .. } => self.expression(operand, node),
+            HirExpression::BinaryOp { left, right, .. } => {
+                self.expression(left, node);
+                self.expression(right, node);
+            }
+            HirExpression::FieldAccess { object, .. } => self.expression(object, node),
+            HirExpression::PointerFieldAccess { pointer, .. } => self.expression(pointer, node),
+            HirExpression::ArrayIndex { array, index } => {
+                self.expression(array, node);
+                self.expression(index, node);
+            }
+            HirExpression::SliceIndex { slice, index, .. } => {
+                self.expression(slice, node);
+                self.expression(index, node);
+            }
+            HirExpression::Cast { expr, .. } => self.expression(expr, node),
+            HirExpression::CompoundLiteral { initializers, .. } => {
+                for init in initializers {
+                    self.expression(init, node);
+                }
+            }
+            HirExpression::Calloc { count, .. } => self.expression(count, node),
+            HirExpression::Malloc { size } => self.expression(size, node),
+            HirExpression::Realloc { pointer, new_size } => {
+                self.expression(pointer, node);
+                self.expression(new_size, node);
+            }
+            HirExpression::StringMethodCall { receiver, arguments, .. } => {
+                self.expression(receiver, node);
+                for arg in arguments {
+                    self.expression(arg, node);
+                }
+            }
+            HirExpression::Ternary { condition, then_expr, else_expr } => {
+                self.expression(condition, node);
+                self.expression(then_expr, node);
+                self.expression(else_expr, node);
+            }
+            HirExpression::CxxNew { arguments, .. } => {
+                for arg in arguments {
+                    self.expression(arg, node);
+                }
+            }
+            HirExpression::IntLiteral(_)
+            | HirExpression::FloatLiteral(_)
+            | HirExpression::StringLiteral(_)
+            | HirExpression::CharLiteral(_)
+            | HirExpression::Sizeof { .. }
+            | HirExpression::NullLiteral => {}
+        }
+    }
+}
+
+/// The pointer a callee given `arg` writes through: `p`, `(T*)p`, or the
+/// array of an element address `&p[i]`.
+fn written_pointer(arg: &HirExpression) -> Option<&str> {
+    match arg {
+        HirExpression::Variable(name) => Some(name),
+        HirExpression::Cast { expr, .. } => written_pointer(expr),
+        HirExpression::AddressOf(place)
+        | HirExpression::UnaryOp { op: UnaryOperator::AddressOf, operand: place } => match &**place
+        {
+            HirExpression::ArrayIndex { array, .. } => match &**array {
+                HirExpression::Variable(name) => Some(name),
+                _ => None,
+            },
+            _ => None,
+        },
+        _ => None,
+    }
+}
+
+#[cfg(test)]
+#[path = "cfg_tests.rs"]
+mod cfg_tests;
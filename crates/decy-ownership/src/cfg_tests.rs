@@ -0,0 +1,280 @@
+//! Tests for the control-flow graph and bitvector dataflow solver.
+
+use super::*;
+use decy_hir::{HirExpression, HirFunction, HirParameter, HirStatement, HirType, SwitchCase};
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn int_ptr(name: &str) -> HirParameter {
+    HirParameter::new(name.to_string(), HirType::Pointer(Box::new(HirType::Int)))
+}
+
+fn free(name: &str) -> HirStatement {
+    HirStatement::Free { pointer: var(name) }
+}
+
+fn read(name: &str) -> HirStatement {
+    HirStatement::Expression(HirExpression::Dereference(Box::new(var(name))))
+}
+
+fn assign(target: &str, value: HirExpression) -> HirStatement {
+    HirStatement::Assignment { target: target.to_string(), value }
+}
+
+fn func(params: Vec<HirParameter>, body: Vec<HirStatement>) -> HirFunction {
+    HirFunction::new_with_body("f".to_string(), HirType::Void, params, body)
+}
+
+fn uaf_names(cfg: &Cfg) -> Vec<(String, usize)> {
+    cfg.use_after_free().into_iter().map(|(v, i)| (cfg.vars().name(v).to_string(), i)).collect()
+}
+
+#[test]
+fn test_bitset_operations() {
+    let mut a = BitSet::new(130);
+    assert!(a.insert(0));
+    assert!(!a.insert(0));
+    a.insert(64);
+    a.insert(129);
+    assert_eq!(a.iter().collect::<Vec<_>>(), vec![0, 64, 129]);
+    assert_eq!(a.count(), 3);
+
+    let full = BitSet::full(130);
+    assert_eq!(full.count(), 130);
+    assert!(!full.contains(130));
+
+    let mut b = BitSet::new(130);
+    b.insert(64);
+    assert!(!b.union_with(&b.clone()));
+    let mut c = a.clone();
+    assert!(c.intersect_with(&b));
+    assert_eq!(c.iter().collect::<Vec<_>>(), vec![64]);
+    a.subtract(&b);
+    a.remove(0);
+    assert_eq!(a.iter().collect::<Vec<_>>(), vec![129]);
+    assert!(BitSet::new(10).is_empty());
+}
+
+#[test]
+fn test_straight_line_use_after_free() {
+    let cfg = Cfg::build(&func(vec![int_ptr("p")], vec![read("p"), free("p"), read("p")]));
+    assert_eq!(uaf_names(&cfg), vec![("p".to_string(), 2)]);
+}
+
+#[test]
+fn test_reassignment_clears_freed_state() {
+    let cfg = Cfg::build(&func(
+        vec![int_ptr("p")],
+        vec![free("p"), assign("p", HirExpression::NullLiteral), read("p")],
+    ));
+    assert!(cfg.use_after_free().is_empty());
+}
+
+#[test]
+fn test_free_in_one_branch_is_maybe_freed() {
+    let cfg = Cfg::build(&func(
+        vec![int_ptr("p")],
+        vec![
+            HirStatement::If {
+                condition: HirExpression::IntLiteral(1),
+                then_block: vec![free("p")],
+                else_block: Some(vec![read("p")]),
+            },
+            read("p"),
+        ],
+    ));
+    // The else-branch read is fine; the read after the join may follow the free
+    assert_eq!(uaf_names(&cfg), vec![("p".to_string(), 1)]);
+}
+
+#[test]
+fn test_free_reaches_next_loop_iteration() {
+    let cfg = Cfg::build(&func(
+        vec![int_ptr("p")],
+        vec![HirStatement::While {
+            condition: HirExpression::IntLiteral(1),
+            body: vec![read("p"), free("p")],
+        }],
+    ));
+    assert_eq!(uaf_names(&cfg), vec![("p".to_string(), 0)]);
+}
+
+#[test]
+fn test_break_skips_back_edge() {
+    let cfg = Cfg::build(&func(
+        vec![int_ptr("p")],
+        vec![HirStatement::While {
+            condition: HirExpression::IntLiteral(1),
+            body: vec![read("p"), free("p"), HirStatement::Break],
+        }],
+    ));
+    assert!(cfg.use_after_free().is_empty(), "break leaves before the next read");
+}
+
+#[test]
+fn test_for_continue_runs_increment() {
+    // for (; p; p = 0) { free(p); continue; }: the increment redefines p
+    // before the condition reads it again
+    let body = vec![HirStatement::For {
+        init: vec![],
+        condition: Some(var("p")),
+        increment: vec![assign("p", HirExpression::NullLiteral)],
+        body: vec![free("p"), HirStatement::Continue],
+    }];
+    let cfg = Cfg::build(&func(vec![int_ptr("p")], body));
+    assert!(cfg.use_after_free().is_empty());
+}
+
+#[test]
+fn test_for_increment_reaches_condition() {
+    let body = vec![HirStatement::For {
+        init: vec![assign("i", HirExpression::IntLiteral(0))],
+        condition: Some(var("i")),
+        increment: vec![HirStatement::Expression(HirExpression::PostIncrement {
+            operand: Box::new(var("i")),
+        })],
+        body: vec![HirStatement::Continue],
+    }];
+    let cfg = Cfg::build(&func(vec![], body));
+    let rd = cfg.reaching_definitions();
+    let i = cfg.vars().id("i").unwrap();
+    let cond = cfg.nodes().iter().position(|n| n.kind == CfgNodeKind::Condition).unwrap();
+    // Both the init and the increment reach the loop condition
+    assert_eq!(rd.reaching(cond, i).len(), 2);
+}
+
+#[test]
+fn test_reassignment_kills_earlier_definition() {
+    let cfg = Cfg::build(&func(
+        vec![int_ptr("p"), int_ptr("q")],
+        vec![
+            HirStatement::If {
+                condition: HirExpression::IntLiteral(1),
+                then_block: vec![assign("p", var("q"))],
+                else_block: None,
+            },
+            read("p"),
+            assign("p", var("q")),
+            read("p"),
+        ],
+    ));
+    let rd = cfg.reaching_definitions();
+    let p = cfg.vars().id("p").unwrap();
+    let at = |index| cfg.nodes().iter().position(|n| n.stmt_index == index).unwrap();
+    // The parameter and the conditional assignment both reach the first read
+    assert_eq!(rd.reaching(at(1), p).len(), 2);
+    assert_eq!(rd.reaching(at(3), p), vec![at(2)]);
+}
+
+#[test]
+fn test_pointer_definitions_record_what_they_bind() {
+    let cfg = Cfg::build(&func(
+        vec![int_ptr("p")],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "q".to_string(),
+                var_type: HirType::Pointer(Box::new(HirType::Int)),
+                initializer: None,
+            },
+            assign("q", var("p")),
+            assign("n", HirExpression::IntLiteral(0)),
+        ],
+    ));
+    let (p, q) = (cfg.vars().id("p").unwrap(), cfg.vars().id("q").unwrap());
+    let pointer_defs: Vec<_> = cfg.nodes().iter().flat_map(|n| n.pointer_defs.clone()).collect();
+    assert_eq!(
+        pointer_defs,
+        vec![(p, NodeKind::Parameter), (q, NodeKind::Assignment { source: "p".to_string() })]
+    );
+}
+
+#[test]
+fn test_switch_fallthrough_and_break() {
+    let case = |body| SwitchCase { value: Some(HirExpression::IntLiteral(0)), body };
+    let cfg = Cfg::build(&func(
+        vec![int_ptr("p"), int_ptr("q")],
+        vec![
+            HirStatement::Switch {
+                condition: HirExpression::IntLiteral(0),
+                cases: vec![case(vec![free("p")]), case(vec![read("p"), HirStatement::Break])],
+                default_case: Some(vec![free("q"), HirStatement::Break]),
+            },
+            read("q"),
+        ],
+    ));
+    // p's read falls through from the freeing case; q is freed on the default path
+    let found = uaf_names(&cfg);
+    assert!(found.contains(&("p".to_string(), 0)));
+    assert!(found.contains(&("q".to_string(), 1)));
+}
+
+#[test]
+fn test_code_after_return_is_unreachable() {
+    let cfg = Cfg::build(&func(
+        vec![int_ptr("p")],
+        vec![free("p"), HirStatement::Return(None), read("p")],
+    ));
+    assert!(cfg.use_after_free().is_empty());
+    let rpo = cfg.reverse_postorder();
+    assert_eq!(rpo.first(), Some(&ENTRY));
+    assert!(rpo.len() < cfg.nodes().len());
+}
+
+#[test]
+fn test_liveness_across_loop() {
+    let cfg = Cfg::build(&func(
+        vec![int_ptr("p"), int_ptr("q")],
+        vec![
+            HirStatement::While { condition: var("p"), body: vec![read("q")] },
+            HirStatement::Return(None),
+        ],
+    ));
+    let live = cfg.liveness();
+    let (p, q) = (cfg.vars().id("p").unwrap(), cfg.vars().id("q").unwrap());
+    let cond = cfg.nodes().iter().position(|n| n.kind == CfgNodeKind::Condition).unwrap();
+    assert!(live.before[cond].contains(p));
+    assert!(live.before[cond].contains(q), "q is read on a later iteration");
+    assert!(!live.before[EXIT].contains(q));
+}
+
+#[test]
+fn test_must_analysis_uses_intersection() {
+    // Hand-rolled "definitely freed" problem: freed on only one branch is not definite
+    let cfg = Cfg::build(&func(
+        vec![int_ptr("p")],
+        vec![
+            HirStatement::If {
+                condition: HirExpression::IntLiteral(1),
+                then_block: vec![free("p")],
+                else_block: None,
+            },
+            read("p"),
+        ],
+    ));
+    let domain = cfg.vars().len();
+    let problem = GenKill {
+        direction: Direction::Forward,
+        meet: Meet::Intersection,
+        domain,
+        gen: cfg.nodes().iter().map(|n| bitset_of(domain, &n.frees)).collect(),
+        kill: cfg.nodes().iter().map(|n| bitset_of(domain, &n.defs)).collect(),
+        boundary: BitSet::new(domain),
+    };
+    let solution = problem.solve(&cfg);
+    assert!(!solution.before[EXIT].contains(cfg.vars().id("p").unwrap()));
+}
+
+#[test]
+fn test_many_variables_span_words() {
+    let mut body = Vec::new();
+    for i in 0..200 {
+        body.push(assign(&format!("v{i}"), HirExpression::NullLiteral));
+        body.push(free(&format!("v{i}")));
+    }
+    body.push(read("v199"));
+    let cfg = Cfg::build(&func(vec![], body));
+    assert_eq!(cfg.vars().len(), 200);
+    assert_eq!(uaf_names(&cfg), vec![("v199".to_string(), 400)]);
+}
@@ -11,6 +11,7 @@ use crate::inference::{OwnershipInference, OwnershipKind};
 use crate::ml_features::{
     AllocationKind, InferredOwnership, OwnershipFeatures, OwnershipFeaturesBuilder,
 };
+use crate::summary::{FunctionSummary, OwnershipSummaries, ParamSummary};
 use decy_hir::{HirFunction, HirType};
 use std::collections::HashMap;
 
@@ -34,6 +35,32 @@ pub fn classify_with_rules(
     classify_function_variables(&classifier, graph, func)
 }
 
+/// Classify function variables using a rule-based classifier and
+/// interprocedural ownership summaries.
+///
+/// Parameter features are augmented with effects inherited from callees:
+/// a parameter passed to a function that frees or stores it counts as
+/// deallocated, and one passed to a function that writes through it counts
+/// as written.
+///
+/// # Arguments
+///
+/// * `graph` - Dataflow graph from analysis
+/// * `func` - HIR function being analyzed
+/// * `summaries` - Summaries computed over the whole translation unit
+///
+/// # Returns
+///
+/// HashMap mapping variable names to ownership inferences.
+pub fn classify_with_summaries(
+    graph: &DataflowGraph,
+    func: &HirFunction,
+    summaries: &OwnershipSummaries,
+) -> HashMap<String, OwnershipInference> {
+    let classifier = RuleBasedClassifier::new();
+    classify_variables(&classifier, graph, func, summaries.get(func.name()))
+}
+
 /// Classify all pointer variables in a function using a classifier.
 ///
 /// Extracts features from the dataflow graph and applies the classifier
@@ -52,6 +79,15 @@ pub fn classify_function_variables(
     classifier: &dyn OwnershipClassifier,
     graph: &DataflowGraph,
     func: &HirFunction,
+) -> HashMap<String, OwnershipInference> {
+    classify_variables(classifier, graph, func, None)
+}
+
+fn classify_variables(
+    classifier: &dyn OwnershipClassifier,
+    graph: &DataflowGraph,
+    func: &HirFunction,
+    summary: Option<&FunctionSummary>,
 ) -> HashMap<String, OwnershipInference> {
     let mut result = HashMap::new();
 
@@ -59,7 +95,10 @@ pub fn classify_function_variables(
     for param in func.parameters() {
         if is_pointer_type(param.param_type()) {
             let var_name = param.name();
-            let features = extract_features_for_variable(var_name, graph, func);
+            let mut features = extract_features_for_variable(var_name, graph, func);
+            if let Some(param_summary) = summary.and_then(|s| s.param_named(var_name)) {
+                apply_param_summary(&mut features, param_summary);
+            }
             let prediction = classifier.classify(&features);
 
             let inference = prediction_to_inference(var_name, &prediction, classifier.name());
@@ -124,6 +163,15 @@ pub fn extract_features_for_variable(
         builder = builder.write_count(1);
     }
 
+    // Locals that own a heap allocation and release it
+    if graph.is_heap_allocated(var_name) {
+        builder = builder.allocation_site(AllocationKind::Malloc);
+    }
+    let frees = graph.free_count(var_name);
+    if frees > 0 {
+        builder = builder.deallocation_count(u8::try_from(frees).unwrap_or(u8::MAX));
+    }
+
     // DECY-183: Check if pointer is derived from array (CRITICAL for safe slice indexing)
     // This detects patterns like: int arr[10]; int* p = arr;
     if graph.array_base_for(var_name).is_some() {
@@ -154,6 +202,19 @@ pub fn extract_features_for_variable(
     builder.build()
 }
 
+/// Fold a parameter's interprocedural summary into its features.
+fn apply_param_summary(features: &mut OwnershipFeatures, summary: &ParamSummary) {
+    if summary.writes && features.write_count == 0 {
+        features.write_count = 1;
+    }
+    if summary.transfers_ownership() && features.deallocation_count == 0 {
+        features.deallocation_count = 1;
+    }
+    if summary.escapes {
+        features.escape_scope = true;
+    }
+}
+
 /// Convert classifier prediction to ownership inference.
 fn prediction_to_inference(
     var_name: &str,
@@ -247,7 +308,7 @@ fn has_size_parameter(var_name: &str, func: &HirFunction) -> bool {
 mod tests {
     use super::*;
     use crate::dataflow::DataflowAnalyzer;
-    use decy_hir::HirParameter;
+    use decy_hir::{HirExpression, HirParameter, HirStatement};
 
     #[test]
     fn test_classify_with_rules_basic() {
@@ -268,6 +329,34 @@ mod tests {
         assert!(inferences.contains_key("data"));
     }
 
+    #[test]
+    fn test_classify_freed_heap_local_as_owning() {
+        // int *p = malloc(sizeof(int)); *p = 1; free(p);
+        let p = || HirExpression::Variable("p".to_string());
+        let func = HirFunction::new_with_body(
+            "test".to_string(),
+            HirType::Void,
+            vec![],
+            vec![
+                HirStatement::VariableDeclaration {
+                    name: "p".to_string(),
+                    var_type: HirType::Pointer(Box::new(HirType::Int)),
+                    initializer: Some(HirExpression::FunctionCall {
+                        function: "malloc".to_string(),
+                        arguments: vec![HirExpression::Sizeof { type_name: "int".to_string() }],
+                    }),
+                },
+                HirStatement::DerefAssignment { target: p(), value: HirExpression::IntLiteral(1) },
+                HirStatement::Free { pointer: p() },
+            ],
+        );
+
+        let graph = DataflowAnalyzer::new().analyze(&func);
+        let inferences = classify_with_rules(&graph, &func);
+
+        assert_eq!(inferences["p"].kind, OwnershipKind::Owning);
+    }
+
     #[test]
     fn test_classify_function_variables_with_custom_classifier() {
         // DECY-182: Custom classifier should be used
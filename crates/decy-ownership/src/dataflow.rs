@@ -2,7 +2,13 @@
 //!
 //! This module builds a dataflow graph that tracks how pointers flow through
 //! functions, enabling detection of ownership patterns and use-after-free issues.
+//! The graph is built from the function's [`Cfg`] in one lowering pass:
+//! pointer nodes and dependencies come from the definitions it records, array
+//! bases from reaching definitions, and flow-sensitive queries (use-after-free,
+//! mutation through a pointer, liveness) from the bitvector solutions.
 
+use crate::cfg::{BitSet, Cfg, CfgNodeKind, ReachingDefinitions, Solution};
+use crate::summary::OwnershipSummaries;
 use decy_hir::{HirExpression, HirFunction, HirStatement, HirType};
 use std::collections::{HashMap, HashSet};
 
@@ -54,10 +60,15 @@ pub struct DataflowGraph {
     use_after_free: HashMap<String, Vec<usize>>,
     /// DECY-067 GREEN: Array base tracking (pointer -> array it's derived from)
     array_bases: HashMap<String, String>,
-    /// DECY-071 GREEN: Function parameters for array detection
-    parameters: Vec<decy_hir::HirParameter>,
-    /// DECY-071 GREEN: Function body for usage analysis
-    body: Vec<decy_hir::HirStatement>,
+    /// DECY-071 GREEN: The analyzed function, sharing its body, for
+    /// parameter and usage analysis
+    function: HirFunction,
+    /// Control-flow graph of the function body
+    cfg: Cfg,
+    /// Variables written through (`*p = v`, `p[i] = v`), by CFG variable id
+    written_through: BitSet,
+    /// Live variables before each CFG node
+    liveness: Solution,
 }
 
 impl DataflowGraph {
@@ -68,8 +79,10 @@ impl DataflowGraph {
             dependencies: HashMap::new(),
             use_after_free: HashMap::new(),
             array_bases: HashMap::new(), // DECY-067 GREEN
-            parameters: Vec::new(),      // DECY-071 GREEN
-            body: Vec::new(),            // DECY-071 GREEN
+            function: HirFunction::new(String::new(), HirType::Void, Vec::new()),
+            cfg: Cfg::default(),
+            written_through: BitSet::default(),
+            liveness: Solution::default(),
         }
     }
 
@@ -107,19 +120,20 @@ impl DataflowGraph {
     /// Get the function body for mutation analysis.
     /// DECY-072 GREEN: Access function body to check for parameter mutations
     pub fn body(&self) -> &[HirStatement] {
-        &self.body
+        self.function.body()
     }
 
     /// Get all array parameters with their associated length parameters.
     /// Returns a vector of (array_param_name, optional_length_param_name) pairs.
     pub fn get_array_parameters(&self) -> Vec<(String, Option<String>)> {
         let mut result = Vec::new();
+        let parameters = self.function.parameters();
 
-        for (i, param) in self.parameters.iter().enumerate() {
+        for (i, param) in parameters.iter().enumerate() {
             if self.is_array_parameter(param.name()) == Some(true) {
                 // Check if next parameter is likely a length parameter
-                let length_param = if i + 1 < self.parameters.len() {
-                    let next_param = &self.parameters[i + 1];
+                let length_param = if i + 1 < parameters.len() {
+                    let next_param = &parameters[i + 1];
                     let next_name = next_param.name().to_lowercase();
                     if matches!(next_param.param_type(), HirType::Int)
                         && (next_name.contains("len")
@@ -143,49 +157,47 @@ impl DataflowGraph {
         result
     }
 
+    /// Get the control-flow graph the flow-sensitive queries are answered from.
+    pub fn cfg(&self) -> &Cfg {
+        &self.cfg
+    }
+
     /// Check if a parameter is modified (mutated) in the function body.
-    /// Returns true if the parameter is assigned to or passed as mutable reference.
+    /// Returns true if the pointer is written through (`*p = v` or `p[i] = v`)
+    /// anywhere in the body, including inside switch cases.
     pub fn is_modified(&self, var: &str) -> bool {
-        for stmt in &self.body {
-            if self.statement_modifies_var(stmt, var) {
-                return true;
-            }
-        }
-        false
+        self.cfg.vars().id(var).is_some_and(|id| self.written_through.contains(id))
     }
 
-    /// Check if a statement modifies a variable.
-    fn statement_modifies_var(&self, stmt: &HirStatement, var: &str) -> bool {
-        match stmt {
-            HirStatement::ArrayIndexAssignment { array, .. } => {
-                // arr[i] = value modifies arr
-                if let HirExpression::Variable(name) = &**array {
-                    if name == var {
-                        return true;
-                    }
-                }
-                false
-            }
-            HirStatement::DerefAssignment { target, .. } => {
-                // *ptr = value modifies ptr's contents
-                if let HirExpression::Variable(name) = target {
-                    if name == var {
-                        return true;
-                    }
-                }
-                false
-            }
-            HirStatement::If { then_block, else_block, .. } => {
-                then_block.iter().any(|s| self.statement_modifies_var(s, var))
-                    || else_block
-                        .as_ref()
-                        .is_some_and(|blk| blk.iter().any(|s| self.statement_modifies_var(s, var)))
-            }
-            HirStatement::While { body, .. } | HirStatement::For { body, .. } => {
-                body.iter().any(|s| self.statement_modifies_var(s, var))
-            }
-            _ => false,
-        }
+    /// Check if every definition of `var` is a heap allocation
+    /// (`malloc(sizeof(T))`).
+    pub fn is_heap_allocated(&self, var: &str) -> bool {
+        self.nodes.get(var).is_some_and(|nodes| {
+            !nodes.is_empty() && nodes.iter().all(|node| node.kind == NodeKind::Allocation)
+        })
+    }
+
+    /// Number of places where `var` is freed.
+    pub fn free_count(&self, var: &str) -> usize {
+        self.cfg
+            .vars()
+            .id(var)
+            .map_or(0, |id| self.cfg.nodes().iter().filter(|node| node.frees.contains(&id)).count())
+    }
+
+    /// Check if `var` may be read after top-level statement `index` finishes,
+    /// before it is redefined.
+    pub fn is_live_after(&self, var: &str, index: usize) -> bool {
+        let Some(id) = self.cfg.vars().id(var) else {
+            return false;
+        };
+        let nodes = self.cfg.nodes();
+        nodes
+            .iter()
+            .filter(|node| node.kind != CfgNodeKind::Entry && node.stmt_index == index)
+            .flat_map(|node| &node.succs)
+            .filter(|&&succ| nodes[succ].stmt_index != index)
+            .any(|&succ| self.liveness.before[succ].contains(id))
     }
 
     /// Check if a parameter is an array pointer (has associated length parameter).
@@ -193,8 +205,9 @@ impl DataflowGraph {
     /// Detects the pattern: fn(int* arr, int len) where pointer param followed by int param
     pub fn is_array_parameter(&self, var: &str) -> Option<bool> {
         // Find the parameter in the parameter list
-        let param_index = self.parameters.iter().position(|p| p.name() == var)?;
-        let param = &self.parameters[param_index];
+        let parameters = self.function.parameters();
+        let param_index = parameters.iter().position(|p| p.name() == var)?;
+        let param = &parameters[param_index];
 
         // Only check pointer parameters
         if !matches!(param.param_type(), HirType::Pointer(_)) {
@@ -214,8 +227,8 @@ impl DataflowGraph {
 
         // Heuristic 1: Check if followed by an integer parameter (length param)
         // Pattern: (T* arr, int len) or (T* arr, size_t size)
-        if param_index + 1 < self.parameters.len() {
-            let next_param = &self.parameters[param_index + 1];
+        if param_index + 1 < parameters.len() {
+            let next_param = &parameters[param_index + 1];
             if matches!(next_param.param_type(), HirType::Int) {
                 confidence += 3; // Strong signal
                 signals += 1;
@@ -236,8 +249,8 @@ impl DataflowGraph {
         }
 
         // Check if next param has length-like name
-        if param_index + 1 < self.parameters.len() {
-            let next_name = self.parameters[param_index + 1].name().to_lowercase();
+        if param_index + 1 < parameters.len() {
+            let next_name = parameters[param_index + 1].name().to_lowercase();
             if next_name.contains("len")
                 || next_name.contains("size")
                 || next_name.contains("count")
@@ -271,7 +284,7 @@ impl DataflowGraph {
     /// Check if a variable is used with array indexing in the function body.
     /// DECY-071 GREEN: Helper for array detection
     fn has_array_indexing(&self, var: &str) -> bool {
-        for stmt in &self.body {
+        for stmt in self.body() {
             if self.statement_has_array_indexing(stmt, var) {
                 return true;
             }
@@ -305,7 +318,7 @@ impl DataflowGraph {
     /// Check if a variable is used with pointer arithmetic in the function body.
     /// DECY-071 GREEN: Helper for array detection (negative signal)
     fn has_pointer_arithmetic(&self, var: &str) -> bool {
-        for stmt in &self.body {
+        for stmt in self.body() {
             if self.statement_has_pointer_arithmetic(stmt, var) {
                 return true;
             }
@@ -363,356 +376,134 @@ impl Default for DataflowGraph {
 }
 
 /// Analyzer that builds dataflow graphs from HIR functions.
-#[derive(Debug)]
-pub struct DataflowAnalyzer;
+#[derive(Debug, Default)]
+pub struct DataflowAnalyzer<'a> {
+    /// What the unit's functions do with their pointer arguments
+    summaries: Option<&'a OwnershipSummaries>,
+}
 
-impl DataflowAnalyzer {
+impl<'a> DataflowAnalyzer<'a> {
     /// Create a new dataflow analyzer.
     pub fn new() -> Self {
-        Self
+        Self::default()
+    }
+
+    /// Create a dataflow analyzer that knows which pointer arguments calls
+    /// to the unit's functions write through.
+    pub fn with_summaries(summaries: &'a OwnershipSummaries) -> Self {
+        Self { summaries: Some(summaries) }
     }
 
     /// Build a dataflow graph for a function.
     ///
-    /// Analyzes pointer usage patterns throughout the function body.
+    /// Lowers the function to a CFG once and derives every query from it.
     pub fn analyze(&self, func: &HirFunction) -> DataflowGraph {
-        let mut graph = DataflowGraph::new();
-
-        // DECY-071 GREEN: Store parameters and body for array detection
-        graph.parameters = func.parameters().to_vec();
-        graph.body = func.body().to_vec();
+        let cfg = match self.summaries {
+            Some(summaries) => Cfg::build_with_summaries(func, summaries),
+            None => Cfg::build(func),
+        };
+        let reaching = cfg.reaching_definitions();
 
-        // Track function parameters (pointer parameters only)
-        for param in func.parameters() {
-            if matches!(param.param_type(), HirType::Pointer(_) | HirType::Box(_)) {
+        let mut graph = DataflowGraph::new();
+        // DECY-071 GREEN: Keep the function for array detection; the body is shared
+        graph.function = func.clone();
+
+        // Pointer definitions in program order, parameters first
+        for (index, node) in cfg.nodes().iter().enumerate() {
+            for (var, kind) in &node.pointer_defs {
+                let name = cfg.vars().name(*var);
+                if let NodeKind::Assignment { source } = kind {
+                    graph.dependencies.entry(name.to_string()).or_default().insert(source.clone());
+                    // DECY-067 GREEN: Derived from an array on every path here
+                    if Self::is_array_at(&cfg, &reaching, index, source) {
+                        graph.array_bases.insert(name.to_string(), source.clone());
+                    }
+                }
                 let node = PointerNode {
-                    name: param.name().to_string(),
-                    def_index: 0,
-                    kind: NodeKind::Parameter,
+                    name: name.to_string(),
+                    def_index: node.stmt_index,
+                    kind: kind.clone(),
                 };
-                graph.nodes.entry(param.name().to_string()).or_default().push(node);
+                graph.nodes.entry(name.to_string()).or_default().push(node);
             }
         }
 
-        // Analyze function body
-        for (index, stmt) in func.body().iter().enumerate() {
-            self.track_statement(stmt, &mut graph, index);
+        // Flow-sensitive facts from the CFG
+        graph.written_through = BitSet::new(cfg.vars().len());
+        for node in cfg.nodes() {
+            for &var in &node.writes_through {
+                graph.written_through.insert(var);
+            }
         }
-
-        // Detect use-after-free patterns (future enhancement)
+        graph.liveness = cfg.liveness();
+        graph.cfg = cfg;
         self.detect_use_after_free(&mut graph);
 
         graph
     }
 
-    /// Track pointer operations in a statement.
-    fn track_statement(&self, stmt: &HirStatement, graph: &mut DataflowGraph, index: usize) {
-        match stmt {
-            HirStatement::VariableDeclaration { name, var_type, initializer } => {
-                // DECY-067 GREEN: Detect array allocations (stack arrays)
-                if let HirType::Array { element_type, size } = var_type {
-                    // Stack array allocation: int arr[10];
-                    let node = PointerNode {
-                        name: name.clone(),
-                        def_index: index,
-                        kind: NodeKind::ArrayAllocation {
-                            size: *size,
-                            element_type: (**element_type).clone(),
-                        },
-                    };
-                    graph.nodes.entry(name.clone()).or_default().push(node);
-                    return; // Early return after handling array
-                }
-
-                // Track pointer types
-                if matches!(var_type, HirType::Pointer(_) | HirType::Box(_)) {
-                    if let Some(init_expr) = initializer {
-                        let kind = self.classify_initialization(init_expr);
-
-                        // Add dependencies if assignment from variable
-                        if let NodeKind::Assignment { ref source } = kind {
-                            graph
-                                .dependencies
-                                .entry(name.clone())
-                                .or_default()
-                                .insert(source.clone());
-
-                            // DECY-067 GREEN: Track if assigned from an array
-                            // Check if source is an array by looking up its node
-                            if let Some(source_nodes) = graph.nodes.get(source) {
-                                if let Some(first_node) = source_nodes.first() {
-                                    if matches!(first_node.kind, NodeKind::ArrayAllocation { .. }) {
-                                        // This pointer is derived from an array!
-                                        graph.array_bases.insert(name.clone(), source.clone());
-                                    }
-                                }
-                            }
-                        }
-
-                        let node = PointerNode { name: name.clone(), def_index: index, kind };
-                        graph.nodes.entry(name.clone()).or_default().push(node);
-                    }
-                }
-            }
-            HirStatement::Assignment { target: _, value } => {
-                // Track uses of pointers in the value expression
-                self.track_expression_uses(value, graph, index);
-            }
-            HirStatement::DerefAssignment { target, value } => {
-                // Track uses of pointers in both target and value expressions
-                self.track_expression_uses(target, graph, index);
-                self.track_expression_uses(value, graph, index);
-            }
-            HirStatement::ArrayIndexAssignment { array, index: idx, value } => {
-                // Track uses of pointers in array, index, and value expressions
-                self.track_expression_uses(array, graph, index);
-                self.track_expression_uses(idx, graph, index);
-                self.track_expression_uses(value, graph, index);
-            }
-            HirStatement::FieldAssignment { object, field: _, value } => {
-                // Track uses of pointers in object and value expressions
-                self.track_expression_uses(object, graph, index);
-                self.track_expression_uses(value, graph, index);
-            }
-            HirStatement::If { condition, then_block, else_block } => {
-                self.track_expression_uses(condition, graph, index);
-                for s in then_block {
-                    self.track_statement(s, graph, index);
-                }
-                if let Some(else_stmts) = else_block {
-                    for s in else_stmts {
-                        self.track_statement(s, graph, index);
-                    }
-                }
-            }
-            HirStatement::While { condition, body } => {
-                self.track_expression_uses(condition, graph, index);
-                for s in body {
-                    self.track_statement(s, graph, index);
-                }
-            }
-            HirStatement::For { init, condition, increment, body } => {
-                // DECY-224: Track all init statements
-                for init_stmt in init {
-                    self.track_statement(init_stmt, graph, index);
-                }
-                // Track condition expression (if present; None = for(;;))
-                if let Some(cond) = condition {
-                    self.track_expression_uses(cond, graph, index);
-                }
-                // Track loop body
-                for s in body {
-                    self.track_statement(s, graph, index);
-                }
-                // DECY-224: Track all increment statements
-                for inc_stmt in increment {
-                    self.track_statement(inc_stmt, graph, index);
-                }
-            }
-            HirStatement::Return(expr_opt) => {
-                if let Some(expr) = expr_opt {
-                    self.track_expression_uses(expr, graph, index);
-                }
-            }
-            HirStatement::Break | HirStatement::Continue => {
-                // No pointer tracking needed
-            }
-            HirStatement::Switch { condition, cases, default_case } => {
-                self.track_expression_uses(condition, graph, index);
-                for case in cases {
-                    for stmt in &case.body {
-                        self.track_statement(stmt, graph, index);
-                    }
-                }
-                if let Some(default_stmts) = default_case {
-                    for stmt in default_stmts {
-                        self.track_statement(stmt, graph, index);
-                    }
-                }
-            }
-            HirStatement::Free { pointer } => {
-                // Track free() call - marks the pointer as freed
-                // Future: detect use-after-free by tracking subsequent uses
-                self.track_expression_uses(pointer, graph, index);
-            }
-            HirStatement::Expression(expr) => {
-                // Track pointer uses in expression statements (DECY-065)
-                // e.g., printf() calls, function calls, etc.
-                self.track_expression_uses(expr, graph, index);
-            }
-            // DECY-197: Inline assembly has no pointer operations to track
-            HirStatement::InlineAsm { .. } => {}
-        }
+    /// Whether every definition of `var` reaching CFG node `node` is an array.
+    fn is_array_at(cfg: &Cfg, reaching: &ReachingDefinitions, node: usize, var: &str) -> bool {
+        let Some(id) = cfg.vars().id(var) else {
+            return false;
+        };
+        let defs = reaching.reaching(node, id);
+        !defs.is_empty()
+            && defs.iter().all(|&def| {
+                cfg.nodes()[def]
+                    .pointer_defs
+                    .iter()
+                    .any(|(v, kind)| *v == id && matches!(kind, NodeKind::ArrayAllocation { .. }))
+            })
     }
 
-    /// Classify the initialization expression to determine node kind.
-    fn classify_initialization(&self, expr: &HirExpression) -> NodeKind {
-        match expr {
-            HirExpression::FunctionCall { function, arguments } if function == "malloc" => {
-                // DECY-067 GREEN: Detect heap array pattern: malloc(n * sizeof(T))
-                // Clippy: Collapse nested if-let into single pattern
-                if let Some(HirExpression::BinaryOp {
-                    op: decy_hir::BinaryOperator::Multiply,
-                    right,
-                    ..
-                }) = arguments.first()
-                {
-                    // Check if multiplying by sizeof
-                    if matches!(**right, HirExpression::Sizeof { .. }) {
-                        // This is an array allocation pattern
-                        // Extract element type from sizeof
-                        if let HirExpression::Sizeof { type_name } = &**right {
-                            // Map type name to HirType (simplified)
-                            let element_type = match type_name.as_str() {
-                                "int" => HirType::Int,
-                                "char" => HirType::Char,
-                                "signed char" => HirType::SignedChar, // DECY-250
-                                "_Bool" => HirType::Bool,
-                                "float" => HirType::Float,
-                                "double" => HirType::Double,
-                                _ => HirType::Int, // Default fallback
-                            };
-                            return NodeKind::ArrayAllocation {
-                                size: None, // Runtime size
-                                element_type,
-                            };
-                        }
-                    }
-                }
-                // Regular malloc (not array pattern)
-                NodeKind::Allocation
-            }
-            HirExpression::Malloc { .. } => NodeKind::Allocation,
-            HirExpression::Variable(var_name) => NodeKind::Assignment { source: var_name.clone() },
-            HirExpression::Dereference(_) => NodeKind::Dereference,
-            _ => NodeKind::Assignment { source: "unknown".to_string() },
+    /// Detect use-after-free patterns.
+    ///
+    /// A use is reported when some path from the entry frees the pointer
+    /// without reassigning it first. Indices are top-level statement indices.
+    fn detect_use_after_free(&self, graph: &mut DataflowGraph) {
+        for (var, index) in graph.cfg.use_after_free() {
+            let name = graph.cfg.vars().name(var).to_string();
+            graph.use_after_free.entry(name).or_default().push(index);
         }
     }
+}
 
-    /// Track uses of pointer variables in an expression.
-    fn track_expression_uses(&self, expr: &HirExpression, graph: &mut DataflowGraph, index: usize) {
-        Self::track_expr_recursive(expr, graph, index);
-    }
-
-    /// Recursively track expression uses (helper for track_expression_uses).
-    fn track_expr_recursive(expr: &HirExpression, _graph: &mut DataflowGraph, _index: usize) {
-        match expr {
-            HirExpression::Variable(_) => {
-                // Pointer variable used - track it
-                // Future: detect use-after-free here
-            }
-            HirExpression::Dereference(inner) => {
-                Self::track_expr_recursive(inner, _graph, _index);
-            }
-            HirExpression::UnaryOp { operand, .. } => {
-                Self::track_expr_recursive(operand, _graph, _index);
-            }
-            HirExpression::BinaryOp { left, right, .. } => {
-                Self::track_expr_recursive(left, _graph, _index);
-                Self::track_expr_recursive(right, _graph, _index);
-            }
-            HirExpression::AddressOf(inner) => {
-                Self::track_expr_recursive(inner, _graph, _index);
-            }
-            HirExpression::FunctionCall { arguments, .. } => {
-                for arg in arguments {
-                    Self::track_expr_recursive(arg, _graph, _index);
-                }
-            }
-            HirExpression::FieldAccess { object, .. } => {
-                Self::track_expr_recursive(object, _graph, _index);
-            }
-            HirExpression::PointerFieldAccess { pointer, .. } => {
-                Self::track_expr_recursive(pointer, _graph, _index);
-            }
-            HirExpression::ArrayIndex { array, index } => {
-                Self::track_expr_recursive(array, _graph, _index);
-                Self::track_expr_recursive(index, _graph, _index);
-            }
-            HirExpression::Cast { expr, .. } => {
-                // Track the expression being cast
-                Self::track_expr_recursive(expr, _graph, _index);
-            }
-            HirExpression::CompoundLiteral { initializers, .. } => {
-                // Track all initializer expressions
-                for init in initializers {
-                    Self::track_expr_recursive(init, _graph, _index);
-                }
-            }
-            HirExpression::IntLiteral(_)
-            | HirExpression::FloatLiteral(_)
-            | HirExpression::StringLiteral(_)
-            | HirExpression::CharLiteral(_)
-            | HirExpression::Sizeof { .. }
-            | HirExpression::NullLiteral => {
-                // No tracking needed for literals, sizeof, or NULL
-            }
-            HirExpression::IsNotNull(inner) => {
-                Self::track_expr_recursive(inner, _graph, _index);
-            }
-            HirExpression::Calloc { count, .. } => {
-                // Track the count expression (may use variables)
-                Self::track_expr_recursive(count, _graph, _index);
-            }
-            HirExpression::Malloc { size } => {
-                // Track the size expression (may use variables)
-                Self::track_expr_recursive(size, _graph, _index);
-            }
-            HirExpression::Realloc { pointer, new_size } => {
-                // Track both pointer and new_size expressions
-                Self::track_expr_recursive(pointer, _graph, _index);
-                Self::track_expr_recursive(new_size, _graph, _index);
-            }
-            HirExpression::StringMethodCall { receiver, arguments, .. } => {
-                // Track receiver and arguments
-                Self::track_expr_recursive(receiver, _graph, _index);
-                for arg in arguments {
-                    Self::track_expr_recursive(arg, _graph, _index);
-                }
-            }
-            HirExpression::SliceIndex { slice, index, .. } => {
-                // DECY-069: Track safe slice indexing
-                Self::track_expr_recursive(slice, _graph, _index);
-                Self::track_expr_recursive(index, _graph, _index);
-            }
-            // DECY-139: Track increment/decrement expressions
-            HirExpression::PostIncrement { operand }
-            | HirExpression::PreIncrement { operand }
-            | HirExpression::PostDecrement { operand }
-            | HirExpression::PreDecrement { operand } => {
-                Self::track_expr_recursive(operand, _graph, _index);
-            }
-            // DECY-192: Track ternary expressions
-            HirExpression::Ternary { condition, then_expr, else_expr } => {
-                Self::track_expr_recursive(condition, _graph, _index);
-                Self::track_expr_recursive(then_expr, _graph, _index);
-                Self::track_expr_recursive(else_expr, _graph, _index);
-            }
-            // DECY-207: C++ new allocates, delete frees
-            HirExpression::CxxNew { arguments, .. } => {
-                for arg in arguments {
-                    Self::track_expr_recursive(arg, _graph, _index);
+/// Classify what a pointer definition binds, from its value.
+pub(crate) fn classify_initialization(expr: &HirExpression) -> NodeKind {
+    match expr {
+        HirExpression::FunctionCall { function, arguments } if function == "malloc" => {
+            // DECY-067 GREEN: Detect heap array pattern: malloc(n * sizeof(T))
+            if let Some(HirExpression::BinaryOp {
+                op: decy_hir::BinaryOperator::Multiply,
+                right,
+                ..
+            }) = arguments.first()
+            {
+                if let HirExpression::Sizeof { type_name } = &**right {
+                    // Map type name to HirType (simplified)
+                    let element_type = match type_name.as_str() {
+                        "int" => HirType::Int,
+                        "char" => HirType::Char,
+                        "signed char" => HirType::SignedChar, // DECY-250
+                        "_Bool" => HirType::Bool,
+                        "float" => HirType::Float,
+                        "double" => HirType::Double,
+                        _ => HirType::Int, // Default fallback
+                    };
+                    return NodeKind::ArrayAllocation {
+                        size: None, // Runtime size
+                        element_type,
+                    };
                 }
             }
-            HirExpression::CxxDelete { operand } => {
-                Self::track_expr_recursive(operand, _graph, _index);
-            }
+            // Regular malloc (not array pattern)
+            NodeKind::Allocation
         }
-    }
-
-    /// Detect use-after-free patterns.
-    ///
-    /// Currently a placeholder - requires ExpressionStatement support in HIR
-    /// to properly detect free() calls.
-    fn detect_use_after_free(&self, _graph: &mut DataflowGraph) {
-        // Placeholder for future implementation
-        // Will require tracking free() calls and subsequent uses
-    }
-}
-
-impl Default for DataflowAnalyzer {
-    fn default() -> Self {
-        Self::new()
+        HirExpression::Malloc { .. } => NodeKind::Allocation,
+        HirExpression::Variable(var_name) => NodeKind::Assignment { source: var_name.clone() },
+        HirExpression::Dereference(_) => NodeKind::Dereference,
+        _ => NodeKind::Assignment { source: "unknown".to_string() },
     }
 }
 
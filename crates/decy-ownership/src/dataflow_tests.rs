@@ -1,6 +1,7 @@
 //! Tests for dataflow analysis module.
 
 use crate::dataflow::*;
+use crate::summary::OwnershipSummaries;
 use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
 
 #[test]
@@ -843,6 +844,141 @@ fn test_is_modified_with_deref_assignment() {
     assert!(graph.is_modified("ptr"));
 }
 
+/// `test(arr)` passing `&arr[0]` to `callee`.
+fn element_address_call(callee: &str) -> HirFunction {
+    HirFunction::new_with_body(
+        "test".to_string(),
+        HirType::Void,
+        vec![HirParameter::new("arr".to_string(), HirType::Pointer(Box::new(HirType::Int)))],
+        vec![HirStatement::Expression(HirExpression::FunctionCall {
+            function: callee.to_string(),
+            arguments: vec![HirExpression::AddressOf(Box::new(HirExpression::ArrayIndex {
+                array: Box::new(HirExpression::Variable("arr".to_string())),
+                index: Box::new(HirExpression::IntLiteral(0)),
+            }))],
+        })],
+    )
+}
+
+#[test]
+fn test_is_modified_with_element_address_passed_to_writing_call() {
+    // visit(&arr[0]) where visit stores through its parameter
+    let visit = HirFunction::new_with_body(
+        "visit".to_string(),
+        HirType::Void,
+        vec![HirParameter::new("p".to_string(), HirType::Pointer(Box::new(HirType::Int)))],
+        vec![HirStatement::DerefAssignment {
+            target: HirExpression::Variable("p".to_string()),
+            value: HirExpression::IntLiteral(0),
+        }],
+    );
+    let func = element_address_call("visit");
+    let summaries = OwnershipSummaries::compute(&[visit, func.clone()]);
+
+    let graph = DataflowAnalyzer::with_summaries(&summaries).analyze(&func);
+
+    assert!(graph.is_modified("arr"));
+}
+
+#[test]
+fn test_not_modified_with_element_address_passed_to_reading_call() {
+    // show(&arr[0]) where show only reads, and printf("%d", &arr[0])
+    let show = HirFunction::new_with_body(
+        "show".to_string(),
+        HirType::Int,
+        vec![HirParameter::new("p".to_string(), HirType::Pointer(Box::new(HirType::Int)))],
+        vec![HirStatement::Return(Some(HirExpression::Dereference(Box::new(
+            HirExpression::Variable("p".to_string()),
+        ))))],
+    );
+    let func = element_address_call("show");
+    let summaries = OwnershipSummaries::compute(&[show, func.clone()]);
+
+    let graph = DataflowAnalyzer::with_summaries(&summaries).analyze(&func);
+    assert!(!graph.is_modified("arr"));
+
+    let graph = DataflowAnalyzer::new().analyze(&element_address_call("printf"));
+    assert!(!graph.is_modified("arr"));
+}
+
+#[test]
+fn test_is_modified_with_element_address_passed_to_callback() {
+    // void each(int *arr, void (*f)(int*)) { f(&arr[0]); }
+    let func = HirFunction::new_with_body(
+        "each".to_string(),
+        HirType::Void,
+        vec![
+            HirParameter::new("arr".to_string(), HirType::Pointer(Box::new(HirType::Int))),
+            HirParameter::new(
+                "f".to_string(),
+                HirType::FunctionPointer {
+                    param_types: vec![HirType::Pointer(Box::new(HirType::Int))],
+                    return_type: Box::new(HirType::Void),
+                },
+            ),
+        ],
+        element_address_call("f").body().to_vec(),
+    );
+
+    let graph = DataflowAnalyzer::new().analyze(&func);
+
+    assert!(graph.is_modified("arr"));
+}
+
+#[test]
+fn test_is_modified_when_sorted_by_qsort() {
+    // qsort(arr, n, sizeof(int), cmp): sorted in place
+    let func = HirFunction::new_with_body(
+        "test".to_string(),
+        HirType::Void,
+        vec![
+            HirParameter::new("arr".to_string(), HirType::Pointer(Box::new(HirType::Int))),
+            HirParameter::new("n".to_string(), HirType::Int),
+        ],
+        vec![HirStatement::Expression(HirExpression::FunctionCall {
+            function: "qsort".to_string(),
+            arguments: vec![
+                HirExpression::Variable("arr".to_string()),
+                HirExpression::Variable("n".to_string()),
+                HirExpression::Sizeof { type_name: "int".to_string() },
+                HirExpression::Variable("cmp".to_string()),
+            ],
+        })],
+    );
+
+    let analyzer = DataflowAnalyzer::new();
+    let graph = analyzer.analyze(&func);
+
+    assert!(graph.is_modified("arr"));
+}
+
+#[test]
+fn test_not_modified_when_searched_by_bsearch() {
+    // bsearch(&key, arr, n, sizeof(int), cmp): base is const void*
+    let func = HirFunction::new_with_body(
+        "test".to_string(),
+        HirType::Void,
+        vec![
+            HirParameter::new("arr".to_string(), HirType::Pointer(Box::new(HirType::Int))),
+            HirParameter::new("n".to_string(), HirType::Int),
+        ],
+        vec![HirStatement::Expression(HirExpression::FunctionCall {
+            function: "bsearch".to_string(),
+            arguments: vec![
+                HirExpression::AddressOf(Box::new(HirExpression::Variable("key".to_string()))),
+                HirExpression::Variable("arr".to_string()),
+                HirExpression::Variable("n".to_string()),
+                HirExpression::Sizeof { type_name: "int".to_string() },
+                HirExpression::Variable("cmp".to_string()),
+            ],
+        })],
+    );
+
+    let graph = DataflowAnalyzer::new().analyze(&func);
+
+    assert!(!graph.is_modified("arr"));
+}
+
 #[test]
 fn test_is_modified_in_if_block() {
     let func = HirFunction::new_with_body(
@@ -1244,7 +1380,7 @@ fn test_dataflow_graph_default_trait() {
 
 #[test]
 fn test_dataflow_analyzer_default_trait() {
-    let analyzer = DataflowAnalyzer;
+    let analyzer = DataflowAnalyzer::new();
     let func = HirFunction::new_with_body("test".to_string(), HirType::Void, vec![], vec![]);
     let graph = analyzer.analyze(&func);
     assert!(graph.variables().is_empty());
@@ -1314,3 +1450,211 @@ fn test_get_array_parameters_with_length_detection() {
         assert_eq!(array_params[0].1, Some("len".to_string()));
     }
 }
+
+#[test]
+fn test_is_modified_in_switch_case() {
+    let func = HirFunction::new_with_body(
+        "test".to_string(),
+        HirType::Void,
+        vec![HirParameter::new("out".to_string(), HirType::Pointer(Box::new(HirType::Int)))],
+        vec![HirStatement::Switch {
+            condition: HirExpression::IntLiteral(1),
+            cases: vec![decy_hir::SwitchCase {
+                value: Some(HirExpression::IntLiteral(1)),
+                body: vec![HirStatement::DerefAssignment {
+                    target: HirExpression::Variable("out".to_string()),
+                    value: HirExpression::IntLiteral(0),
+                }],
+            }],
+            default_case: None,
+        }],
+    );
+
+    let graph = DataflowAnalyzer::new().analyze(&func);
+    assert!(graph.is_modified("out"));
+}
+
+#[test]
+fn test_use_after_free_detected_across_loop() {
+    // while (n) { use(*ptr); free(ptr); }  -- second iteration reads freed memory
+    let func = HirFunction::new_with_body(
+        "test".to_string(),
+        HirType::Void,
+        vec![
+            HirParameter::new("ptr".to_string(), HirType::Pointer(Box::new(HirType::Int))),
+            HirParameter::new("n".to_string(), HirType::Int),
+        ],
+        vec![HirStatement::While {
+            condition: HirExpression::Variable("n".to_string()),
+            body: vec![
+                HirStatement::Expression(HirExpression::FunctionCall {
+                    function: "use".to_string(),
+                    arguments: vec![HirExpression::Dereference(Box::new(HirExpression::Variable(
+                        "ptr".to_string(),
+                    )))],
+                }),
+                HirStatement::Free { pointer: HirExpression::Variable("ptr".to_string()) },
+            ],
+        }],
+    );
+
+    let graph = DataflowAnalyzer::new().analyze(&func);
+    assert!(graph.has_use_after_free("ptr"));
+    assert_eq!(graph.use_after_free_indices("ptr"), Some(&vec![0]));
+    assert!(!graph.has_use_after_free("n"));
+}
+
+#[test]
+fn test_free_then_reassign_is_not_use_after_free() {
+    let ptr = || HirExpression::Variable("ptr".to_string());
+    let func = HirFunction::new_with_body(
+        "test".to_string(),
+        HirType::Void,
+        vec![HirParameter::new("ptr".to_string(), HirType::Pointer(Box::new(HirType::Int)))],
+        vec![
+            HirStatement::Free { pointer: ptr() },
+            HirStatement::Assignment {
+                target: "ptr".to_string(),
+                value: HirExpression::Malloc { size: Box::new(HirExpression::IntLiteral(4)) },
+            },
+            HirStatement::DerefAssignment { target: ptr(), value: HirExpression::IntLiteral(1) },
+        ],
+    );
+
+    let graph = DataflowAnalyzer::new().analyze(&func);
+    assert!(!graph.has_use_after_free("ptr"));
+    assert!(graph.is_modified("ptr"));
+}
+
+fn int_ptr_decl(name: &str, initializer: Option<HirExpression>) -> HirStatement {
+    HirStatement::VariableDeclaration {
+        name: name.to_string(),
+        var_type: HirType::Pointer(Box::new(HirType::Int)),
+        initializer,
+    }
+}
+
+#[test]
+fn test_pointer_assigned_after_declaration_is_tracked() {
+    // int arr[4]; int *p; p = arr;
+    let func = HirFunction::new_with_body(
+        "test".to_string(),
+        HirType::Void,
+        vec![],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "arr".to_string(),
+                var_type: HirType::Array { element_type: Box::new(HirType::Int), size: Some(4) },
+                initializer: None,
+            },
+            int_ptr_decl("p", None),
+            HirStatement::Assignment {
+                target: "p".to_string(),
+                value: HirExpression::Variable("arr".to_string()),
+            },
+        ],
+    );
+
+    let graph = DataflowAnalyzer::new().analyze(&func);
+
+    let nodes = graph.nodes_for("p").unwrap();
+    assert_eq!(nodes.len(), 1);
+    assert_eq!(nodes[0].def_index, 2);
+    assert!(graph.dependencies_for("p").unwrap().contains("arr"));
+    assert_eq!(graph.array_base_for("p"), Some("arr"));
+}
+
+#[test]
+fn test_array_base_needs_array_on_every_path() {
+    // int *q = arr; if (c) q = p; int *r = q;
+    let func = HirFunction::new_with_body(
+        "test".to_string(),
+        HirType::Void,
+        vec![
+            HirParameter::new("p".to_string(), HirType::Pointer(Box::new(HirType::Int))),
+            HirParameter::new("c".to_string(), HirType::Int),
+        ],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "arr".to_string(),
+                var_type: HirType::Array { element_type: Box::new(HirType::Int), size: Some(4) },
+                initializer: None,
+            },
+            int_ptr_decl("q", Some(HirExpression::Variable("arr".to_string()))),
+            HirStatement::If {
+                condition: HirExpression::Variable("c".to_string()),
+                then_block: vec![HirStatement::Assignment {
+                    target: "q".to_string(),
+                    value: HirExpression::Variable("p".to_string()),
+                }],
+                else_block: None,
+            },
+            int_ptr_decl("r", Some(HirExpression::Variable("q".to_string()))),
+        ],
+    );
+
+    let graph = DataflowAnalyzer::new().analyze(&func);
+
+    assert_eq!(graph.array_base_for("q"), Some("arr"));
+    assert_eq!(graph.nodes_for("q").unwrap().len(), 2);
+    assert_eq!(graph.array_base_for("r"), None);
+}
+
+#[test]
+fn test_is_live_after_statement() {
+    // while (p) { p = 0; } return *q; with q only read after the loop
+    let func = HirFunction::new_with_body(
+        "test".to_string(),
+        HirType::Int,
+        vec![
+            HirParameter::new("p".to_string(), HirType::Pointer(Box::new(HirType::Int))),
+            HirParameter::new("q".to_string(), HirType::Pointer(Box::new(HirType::Int))),
+        ],
+        vec![
+            HirStatement::While {
+                condition: HirExpression::Variable("p".to_string()),
+                body: vec![HirStatement::Assignment {
+                    target: "p".to_string(),
+                    value: HirExpression::NullLiteral,
+                }],
+            },
+            HirStatement::Return(Some(HirExpression::Dereference(Box::new(
+                HirExpression::Variable("q".to_string()),
+            )))),
+        ],
+    );
+
+    let graph = DataflowAnalyzer::new().analyze(&func);
+
+    assert!(graph.is_live_after("q", 0));
+    assert!(!graph.is_live_after("p", 0));
+    assert!(!graph.is_live_after("q", 1));
+    assert!(!graph.is_live_after("missing", 0));
+}
+
+#[test]
+fn test_heap_allocation_and_frees() {
+    // int *p = malloc(4); free(p); with q only borrowed
+    let func = HirFunction::new_with_body(
+        "test".to_string(),
+        HirType::Void,
+        vec![HirParameter::new("q".to_string(), HirType::Pointer(Box::new(HirType::Int)))],
+        vec![
+            int_ptr_decl(
+                "p",
+                Some(HirExpression::FunctionCall {
+                    function: "malloc".to_string(),
+                    arguments: vec![HirExpression::IntLiteral(4)],
+                }),
+            ),
+            HirStatement::Free { pointer: HirExpression::Variable("p".to_string()) },
+        ],
+    );
+
+    let graph = DataflowAnalyzer::new().analyze(&func);
+
+    assert!(graph.is_heap_allocated("p"));
+    assert_eq!(graph.free_count("p"), 1);
+    assert!(!graph.is_heap_allocated("q"));
+    assert_eq!(graph.free_count("q"), 0);
+}
@@ -0,0 +1,786 @@
+//! Escape analysis for heap allocations.
+//!
+//! `malloc`/`calloc` results that never leave the function that allocated
+//! them do not need the heap. This module finds those allocations from the
+//! dataflow graph and rewrites them as stack storage:
+//!
+//! - `T* p = malloc(sizeof(T))` → a plain `T p` local, when `T` is a scalar
+//!   or a struct whose size is known and within [`MAX_INLINE_BYTES`]
+//! - `T* buf = malloc(16 * sizeof(T))` or `calloc(16, sizeof(T))` → `T buf[16]`,
+//!   up to [`MAX_INLINE_BYTES`]
+//!
+//! An allocation escapes when its pointer is used as a value: returned,
+//! passed to a function other than `free`, stored, aliased, compared with
+//! anything but NULL, offset, or reassigned. Only dereferences, field
+//! accesses, indexing, `free` and NULL checks of the malloc result stay
+//! inside the function. Taking the address of anything inside the
+//! allocation (`&p->x`, `&buf[i]`) escapes too, unless that address is only
+//! lent to a library function that does not keep it.
+
+use crate::dataflow::DataflowGraph;
+use decy_hir::visit::{fold_expression_children, fold_statement_children, walk_statements};
+use decy_hir::visit::{Fold, Visitor};
+use decy_hir::{
+    BinaryOperator, HirExpression, HirFunction, HirStatement, HirStruct, HirType, UnaryOperator,
+};
+
+/// Largest allocation, in bytes, promoted to stack storage.
+pub const MAX_INLINE_BYTES: usize = 4096;
+
+/// A heap allocation that can live on the stack instead.
+#[derive(Debug, Clone, PartialEq)]
+pub struct StackCandidate {
+    /// Variable holding the allocated pointer
+    pub variable: String,
+    /// Top-level statement index of the allocating declaration
+    pub decl_index: usize,
+    /// Stack type replacing the pointer: the pointee, or a fixed array of it
+    pub storage: HirType,
+}
+
+impl StackCandidate {
+    fn is_array(&self) -> bool {
+        matches!(self.storage, HirType::Array { .. })
+    }
+}
+
+/// Finds non-escaping allocations and promotes them to stack storage.
+#[derive(Debug, Clone, Default)]
+pub struct EscapeAnalyzer<'a> {
+    /// Struct definitions, to size `malloc(sizeof(struct T))`
+    structs: &'a [HirStruct],
+}
+
+impl<'a> EscapeAnalyzer<'a> {
+    /// Create a new escape analyzer that knows no struct sizes, so struct
+    /// allocations stay on the heap.
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Create an escape analyzer that can promote allocations of `structs`.
+    pub fn with_structs(structs: &'a [HirStruct]) -> Self {
+        Self { structs }
+    }
+
+    /// Find top-level allocations whose pointer never escapes the function.
+    ///
+    /// Allocations with a use after `free`, or a variable defined more than
+    /// once, are left alone.
+    pub fn find_stack_candidates(&self, dataflow: &DataflowGraph) -> Vec<StackCandidate> {
+        let body = dataflow.body();
+        body.iter()
+            .enumerate()
+            .filter_map(|(decl_index, stmt)| {
+                let HirStatement::VariableDeclaration {
+                    name,
+                    var_type: HirType::Pointer(pointee),
+                    initializer: Some(init),
+                } = stmt
+                else {
+                    return None;
+                };
+                let storage = stack_storage(init, pointee, name, self.structs)?;
+                let redefined = dataflow.nodes_for(name).is_some_and(|nodes| nodes.len() > 1);
+                if redefined || dataflow.has_use_after_free(name) {
+                    return None;
+                }
+                let candidate = StackCandidate { variable: name.clone(), decl_index, storage };
+                let mut scan = EscapeScan::new(&candidate);
+                walk_statements(&mut scan, &body[decl_index + 1..]);
+                (!scan.escapes()).then_some(candidate)
+            })
+            .collect()
+    }
+
+    /// Rewrite non-escaping allocations as stack locals.
+    ///
+    /// Returns `None` when nothing was promoted.
+    pub fn promote(&self, func: &HirFunction, dataflow: &DataflowGraph) -> Option<HirFunction> {
+        let candidates = self.find_stack_candidates(dataflow);
+        if candidates.is_empty() {
+            return None;
+        }
+        let body = PromoteToStack { candidates: &candidates }.fold_block(func.body().to_vec());
+        Some(func.with_body(body))
+    }
+}
+
+/// Stack type for `init` assigned to a `pointee*`, if it is a fixed-size allocation.
+fn stack_storage(
+    init: &HirExpression,
+    pointee: &HirType,
+    var: &str,
+    structs: &[HirStruct],
+) -> Option<HirType> {
+    match init {
+        HirExpression::Cast { expr, .. } => stack_storage(expr, pointee, var, structs),
+        HirExpression::FunctionCall { function, arguments } if function == "malloc" => {
+            match arguments.as_slice() {
+                [size] => malloc_storage(size, pointee, var, structs),
+                _ => None,
+            }
+        }
+        HirExpression::Malloc { size } => malloc_storage(size, pointee, var, structs),
+        HirExpression::FunctionCall { function, arguments } if function == "calloc" => {
+            match arguments.as_slice() {
+                [count, size] if is_sizeof(size, pointee, var) => array_storage(count, pointee),
+                _ => None,
+            }
+        }
+        HirExpression::Calloc { count, element_type } if **element_type == *pointee => {
+            array_storage(count, pointee)
+        }
+        _ => None,
+    }
+}
+
+/// `sizeof(T)` → `T`; `n * sizeof(T)` or `sizeof(T) * n` → `T[n]`.
+fn malloc_storage(
+    size: &HirExpression,
+    pointee: &HirType,
+    var: &str,
+    structs: &[HirStruct],
+) -> Option<HirType> {
+    if is_sizeof(size, pointee, var) {
+        let bytes = value_bytes(pointee, structs)?;
+        return (bytes <= MAX_INLINE_BYTES).then(|| pointee.clone());
+    }
+    let HirExpression::BinaryOp { op: BinaryOperator::Multiply, left, right } = size else {
+        return None;
+    };
+    if is_sizeof(right, pointee, var) {
+        array_storage(left, pointee)
+    } else if is_sizeof(left, pointee, var) {
+        array_storage(right, pointee)
+    } else {
+        None
+    }
+}
+
+/// `T[count]` for a constant count within [`MAX_INLINE_BYTES`].
+fn array_storage(count: &HirExpression, element: &HirType) -> Option<HirType> {
+    let HirExpression::IntLiteral(count) = count else {
+        return None;
+    };
+    let count = usize::try_from(*count).ok().filter(|&n| n > 0)?;
+    (count * element_bytes(element)? <= MAX_INLINE_BYTES)
+        .then(|| HirType::Array { element_type: Box::new(element.clone()), size: Some(count) })
+}
+
+/// Size in bytes of a scalar C type.
+fn element_bytes(ty: &HirType) -> Option<usize> {
+    match ty {
+        HirType::Bool | HirType::Char | HirType::SignedChar => Some(1),
+        HirType::Int | HirType::UnsignedInt | HirType::Float => Some(4),
+        HirType::Double => Some(8),
+        _ => None,
+    }
+}
+
+/// Size in bytes of a value of `ty`, without padding: structs add up their
+/// fields. `None` when any part of it is of unknown size.
+fn value_bytes(ty: &HirType, structs: &[HirStruct]) -> Option<usize> {
+    match ty {
+        HirType::Pointer(_) | HirType::FunctionPointer { .. } => Some(8),
+        HirType::Enum(_) => Some(4),
+        HirType::Array { element_type, size: Some(count) } => {
+            value_bytes(element_type, structs)?.checked_mul(*count)
+        }
+        HirType::Struct(name) => {
+            let definition = structs.iter().find(|s| s.name() == name)?;
+            definition.fields().iter().try_fold(0usize, |total, field| {
+                total.checked_add(value_bytes(field.field_type(), structs)?)
+            })
+        }
+        _ => element_bytes(ty),
+    }
+}
+
+/// `sizeof(T)` naming `pointee`, or `sizeof(*var)`.
+fn is_sizeof(expr: &HirExpression, pointee: &HirType, var: &str) -> bool {
+    let HirExpression::Sizeof { type_name } = expr else {
+        return false;
+    };
+    let type_name = type_name.trim();
+    type_name == var
+        || match pointee {
+            HirType::Bool => matches!(type_name, "_Bool" | "bool"),
+            HirType::Char => type_name == "char",
+            HirType::SignedChar => type_name == "signed char",
+            HirType::Int => matches!(type_name, "int" | "signed int" | "signed"),
+            HirType::UnsignedInt => matches!(type_name, "unsigned int" | "unsigned"),
+            HirType::Float => type_name == "float",
+            HirType::Double => type_name == "double",
+            HirType::Struct(name) => {
+                type_name == name || type_name.strip_prefix("struct ") == Some(name.as_str())
+            }
+            _ => false,
+        }
+}
+
+fn is_variable(expr: &HirExpression, name: &str) -> bool {
+    matches!(expr, HirExpression::Variable(var) if var == name)
+}
+
+fn is_null(expr: &HirExpression) -> bool {
+    match expr {
+        HirExpression::NullLiteral | HirExpression::IntLiteral(0) => true,
+        HirExpression::Cast { expr, .. } => is_null(expr),
+        _ => false,
+    }
+}
+
+/// `Some(true)` for `!p` or `p == NULL`, `Some(false)` for `p` or `p != NULL`.
+fn null_check(cond: &HirExpression, var: &str) -> Option<bool> {
+    match cond {
+        HirExpression::Variable(_) if is_variable(cond, var) => Some(false),
+        HirExpression::IsNotNull(inner) if is_variable(inner, var) => Some(false),
+        HirExpression::UnaryOp { op: UnaryOperator::LogicalNot, operand }
+            if is_variable(operand, var) =>
+        {
+            Some(true)
+        }
+        HirExpression::BinaryOp {
+            op: op @ (BinaryOperator::Equal | BinaryOperator::NotEqual),
+            left,
+            right,
+        } if (is_variable(left, var) && is_null(right))
+            || (is_null(left) && is_variable(right, var)) =>
+        {
+            Some(*op == BinaryOperator::Equal)
+        }
+        _ => None,
+    }
+}
+
+/// `free(p)` as a statement.
+fn is_free_of(stmt: &HirStatement, var: &str) -> bool {
+    match stmt {
+        HirStatement::Free { pointer } => is_variable(pointer, var),
+        HirStatement::Expression(HirExpression::FunctionCall { function, arguments }) => {
+            function == "free" && matches!(arguments.as_slice(), [arg] if is_variable(arg, var))
+        }
+        _ => false,
+    }
+}
+
+/// Library functions that only use their pointer arguments during the call
+/// and return nothing derived from them.
+const NON_CAPTURING: &[&str] = &[
+    "printf", "fprintf", "sprintf", "snprintf", "scanf", "fscanf", "sscanf", "puts", "fputs",
+    "fread", "fwrite", "strlen", "strcmp", "strncmp", "memcmp", "atoi", "atol", "atof",
+];
+
+/// Library functions that only use their pointer arguments during the call
+/// but return the destination, so they do not keep an address only when
+/// their result is discarded.
+const RETURNS_DESTINATION: &[&str] =
+    &["memcpy", "memmove", "memset", "strcpy", "strncpy", "strcat", "strncat"];
+
+/// `p->f`, `*p`, `buf[i]` or a field of one of them: a place inside the
+/// allocation `var` points to.
+fn is_inside(expr: &HirExpression, var: &str) -> bool {
+    let inner = match expr {
+        HirExpression::Dereference(inner) => inner,
+        HirExpression::ArrayIndex { array, .. } => array,
+        HirExpression::PointerFieldAccess { pointer, .. } => pointer,
+        HirExpression::FieldAccess { object, .. } => object,
+        _ => return false,
+    };
+    is_variable(inner, var) || is_inside(inner, var)
+}
+
+/// `&place` with the place inside the allocation `var` points to.
+fn is_address_inside(expr: &HirExpression, var: &str) -> bool {
+    match expr {
+        HirExpression::AddressOf(inner)
+        | HirExpression::UnaryOp { op: UnaryOperator::AddressOf, operand: inner } => {
+            is_inside(inner, var)
+        }
+        _ => false,
+    }
+}
+
+/// Counts every use of the pointer and the uses that keep it inside the function.
+struct EscapeScan<'a> {
+    var: &'a str,
+    is_array: bool,
+    is_struct: bool,
+    uses: usize,
+    contained: usize,
+    rebound: bool,
+    /// Addresses taken of places inside the allocation
+    addresses: usize,
+    /// Of those, the ones only lent to a call that does not keep them
+    lent: usize,
+}
+
+impl<'a> EscapeScan<'a> {
+    fn new(candidate: &'a StackCandidate) -> Self {
+        Self {
+            var: &candidate.variable,
+            is_array: candidate.is_array(),
+            is_struct: matches!(candidate.storage, HirType::Struct(_)),
+            uses: 0,
+            contained: 0,
+            rebound: false,
+            addresses: 0,
+            lent: 0,
+        }
+    }
+
+    fn escapes(&self) -> bool {
+        self.rebound || self.uses != self.contained || self.addresses != self.lent
+    }
+
+    fn lend_arguments(&mut self, arguments: &[HirExpression]) {
+        self.lent += arguments.iter().filter(|a| is_address_inside(a, self.var)).count();
+    }
+}
+
+impl Visitor for EscapeScan<'_> {
+    fn visit_statement(&mut self, stmt: &HirStatement) {
+        let var = self.var;
+        let contained = match stmt {
+            HirStatement::Assignment { target, .. } => {
+                self.rebound |= target == var;
+                false
+            }
+            HirStatement::VariableDeclaration { name, .. } => {
+                self.rebound |= name == var;
+                false
+            }
+            HirStatement::DerefAssignment { target, .. } => is_variable(target, var),
+            HirStatement::ArrayIndexAssignment { array, .. } => {
+                self.is_array && is_variable(array, var)
+            }
+            HirStatement::FieldAssignment { object, .. } => {
+                self.is_struct && is_variable(object, var)
+            }
+            HirStatement::If { condition, .. } => null_check(condition, var).is_some(),
+            HirStatement::Expression(HirExpression::FunctionCall { function, arguments })
+                if RETURNS_DESTINATION.contains(&function.as_str()) =>
+            {
+                self.lend_arguments(arguments);
+                false
+            }
+            other => is_free_of(other, var),
+        };
+        self.contained += usize::from(contained);
+    }
+
+    fn visit_expression(&mut self, expr: &HirExpression) {
+        let var = self.var;
+        let contained = match expr {
+            HirExpression::Variable(name) => {
+                self.uses += usize::from(name == var);
+                false
+            }
+            HirExpression::Dereference(inner) => is_variable(inner, var),
+            HirExpression::ArrayIndex { array, .. } => self.is_array && is_variable(array, var),
+            HirExpression::PointerFieldAccess { pointer, .. } => {
+                self.is_struct && is_variable(pointer, var)
+            }
+            HirExpression::FunctionCall { function, arguments }
+                if NON_CAPTURING.contains(&function.as_str()) =>
+            {
+                self.lend_arguments(arguments);
+                false
+            }
+            _ => {
+                self.addresses += usize::from(is_address_inside(expr, var));
+                false
+            }
+        };
+        self.contained += usize::from(contained);
+    }
+}
+
+/// Rewrites promoted pointers as the stack values they point to.
+struct PromoteToStack<'a> {
+    candidates: &'a [StackCandidate],
+}
+
+impl PromoteToStack<'_> {
+    fn promoted(&self, expr: &HirExpression) -> Option<&StackCandidate> {
+        match expr {
+            HirExpression::Variable(name) => self.candidates.iter().find(|c| c.variable == *name),
+            _ => None,
+        }
+    }
+
+    /// `buf[0]` for a promoted array, the local itself otherwise.
+    fn pointee(&self, candidate: &StackCandidate) -> HirExpression {
+        let var = HirExpression::Variable(candidate.variable.clone());
+        if candidate.is_array() {
+            HirExpression::ArrayIndex {
+                array: Box::new(var),
+                index: Box::new(HirExpression::IntLiteral(0)),
+            }
+        } else {
+            var
+        }
+    }
+}
+
+impl Fold for PromoteToStack<'_> {
+    fn fold_block(&mut self, block: Vec<HirStatement>) -> Vec<HirStatement> {
+        let mut result = Vec::with_capacity(block.len());
+        for stmt in block {
+            let candidates = self.candidates;
+            match stmt {
+                // Stack storage cannot fail to allocate and is never freed
+                ref free if candidates.iter().any(|c| is_free_of(free, &c.variable)) => {}
+                HirStatement::If { condition, then_block, else_block }
+                    if candidates.iter().any(|c| null_check(&condition, &c.variable).is_some()) =>
+                {
+                    let is_null = candidates
+                        .iter()
+                        .find_map(|c| null_check(&condition, &c.variable))
+                        .unwrap_or(false);
+                    let taken = if is_null { else_block.unwrap_or_default() } else { then_block };
+                    result.extend(self.fold_block(taken));
+                }
+                HirStatement::VariableDeclaration { name, var_type, initializer } => {
+                    match candidates.iter().find(|c| c.variable == name) {
+                        Some(candidate) => result.push(HirStatement::VariableDeclaration {
+                            name,
+                            var_type: candidate.storage.clone(),
+                            initializer: None,
+                        }),
+                        None => {
+                            result.push(self.fold_statement(HirStatement::VariableDeclaration {
+                                name,
+                                var_type,
+                                initializer,
+                            }))
+                        }
+                    }
+                }
+                other => result.push(self.fold_statement(other)),
+            }
+        }
+        result
+    }
+
+    fn fold_statement(&mut self, stmt: HirStatement) -> HirStatement {
+        match stmt {
+            HirStatement::DerefAssignment { target, value } => match self.promoted(&target) {
+                Some(candidate) => match self.pointee(candidate) {
+                    HirExpression::ArrayIndex { array, index } => {
+                        HirStatement::ArrayIndexAssignment {
+                            array,
+                            index,
+                            value: self.fold_expression(value),
+                        }
+                    }
+                    _ => HirStatement::Assignment {
+                        target: candidate.variable.clone(),
+                        value: self.fold_expression(value),
+                    },
+                },
+                None => {
+                    fold_statement_children(self, HirStatement::DerefAssignment { target, value })
+                }
+            },
+            other => fold_statement_children(self, other),
+        }
+    }
+
+    fn fold_expression(&mut self, expr: HirExpression) -> HirExpression {
+        match expr {
+            HirExpression::Dereference(inner) => match self.promoted(&inner) {
+                Some(candidate) => self.pointee(candidate),
+                None => fold_expression_children(self, HirExpression::Dereference(inner)),
+            },
+            HirExpression::PointerFieldAccess { pointer, field }
+                if self.promoted(&pointer).is_some() =>
+            {
+                HirExpression::FieldAccess { object: pointer, field }
+            }
+            other => fold_expression_children(self, other),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::dataflow::DataflowAnalyzer;
+    use decy_hir::{HirParameter, HirStructField};
+
+    fn var(name: &str) -> HirExpression {
+        HirExpression::Variable(name.to_string())
+    }
+
+    fn sizeof(type_name: &str) -> HirExpression {
+        HirExpression::Sizeof { type_name: type_name.to_string() }
+    }
+
+    fn malloc(size: HirExpression) -> HirExpression {
+        HirExpression::FunctionCall { function: "malloc".to_string(), arguments: vec![size] }
+    }
+
+    fn free(name: &str) -> HirStatement {
+        HirStatement::Expression(HirExpression::FunctionCall {
+            function: "free".to_string(),
+            arguments: vec![var(name)],
+        })
+    }
+
+    fn alloc(name: &str, pointee: HirType, size: HirExpression) -> HirStatement {
+        HirStatement::VariableDeclaration {
+            name: name.to_string(),
+            var_type: HirType::Pointer(Box::new(pointee)),
+            initializer: Some(malloc(size)),
+        }
+    }
+
+    fn point_alloc() -> HirStatement {
+        alloc("p", HirType::Struct("Point".to_string()), sizeof("struct Point"))
+    }
+
+    fn buffer_alloc(count: i32) -> HirStatement {
+        alloc(
+            "buf",
+            HirType::Int,
+            HirExpression::BinaryOp {
+                op: BinaryOperator::Multiply,
+                left: Box::new(HirExpression::IntLiteral(count)),
+                right: Box::new(sizeof("int")),
+            },
+        )
+    }
+
+    fn structs() -> Vec<HirStruct> {
+        let field =
+            |name: &str, field_type: HirType| HirStructField::new(name.to_string(), field_type);
+        vec![
+            HirStruct::new(
+                "Point".to_string(),
+                vec![field("x", HirType::Int), field("y", HirType::Int)],
+            ),
+            HirStruct::new(
+                "Big".to_string(),
+                vec![
+                    field("len", HirType::Int),
+                    field(
+                        "data",
+                        HirType::Array {
+                            element_type: Box::new(HirType::Char),
+                            size: Some(1 << 20),
+                        },
+                    ),
+                ],
+            ),
+        ]
+    }
+
+    fn promote(params: Vec<HirParameter>, body: Vec<HirStatement>) -> Option<Vec<HirStatement>> {
+        let func = HirFunction::new_with_body("f".to_string(), HirType::Int, params, body);
+        let dataflow = DataflowAnalyzer::new().analyze(&func);
+        let structs = structs();
+        EscapeAnalyzer::with_structs(&structs).promote(&func, &dataflow).map(|f| f.body().to_vec())
+    }
+
+    /// struct Point *p = malloc(sizeof(struct Point)); if (!p) return -1;
+    /// p->x = 1; int r = p->x; free(p); return r;
+    #[test]
+    fn test_scratch_struct_becomes_local() {
+        let body = promote(
+            vec![],
+            vec![
+                point_alloc(),
+                HirStatement::If {
+                    condition: HirExpression::UnaryOp {
+                        op: UnaryOperator::LogicalNot,
+                        operand: Box::new(var("p")),
+                    },
+                    then_block: vec![HirStatement::Return(Some(HirExpression::IntLiteral(-1)))],
+                    else_block: None,
+                },
+                HirStatement::FieldAssignment {
+                    object: var("p"),
+                    field: "x".to_string(),
+                    value: HirExpression::IntLiteral(1),
+                },
+                HirStatement::VariableDeclaration {
+                    name: "r".to_string(),
+                    var_type: HirType::Int,
+                    initializer: Some(HirExpression::PointerFieldAccess {
+                        pointer: Box::new(var("p")),
+                        field: "x".to_string(),
+                    }),
+                },
+                free("p"),
+                HirStatement::Return(Some(var("r"))),
+            ],
+        )
+        .expect("scratch struct is promoted");
+
+        assert_eq!(body.len(), 4, "{:?}", body);
+        assert_eq!(
+            body[0],
+            HirStatement::VariableDeclaration {
+                name: "p".to_string(),
+                var_type: HirType::Struct("Point".to_string()),
+                initializer: None,
+            }
+        );
+        assert!(matches!(
+            &body[2],
+            HirStatement::VariableDeclaration {
+                initializer: Some(HirExpression::FieldAccess { .. }),
+                ..
+            }
+        ));
+    }
+
+    /// int *buf = malloc(16 * sizeof(int)); *buf = 1; buf[1] = buf[0]; free(buf);
+    #[test]
+    fn test_small_buffer_becomes_array() {
+        let body = promote(
+            vec![],
+            vec![
+                buffer_alloc(16),
+                HirStatement::DerefAssignment {
+                    target: var("buf"),
+                    value: HirExpression::IntLiteral(1),
+                },
+                HirStatement::ArrayIndexAssignment {
+                    array: Box::new(var("buf")),
+                    index: Box::new(HirExpression::IntLiteral(1)),
+                    value: HirExpression::Dereference(Box::new(var("buf"))),
+                },
+                free("buf"),
+                HirStatement::Return(Some(HirExpression::IntLiteral(0))),
+            ],
+        )
+        .expect("small buffer is promoted");
+
+        assert_eq!(
+            body[0],
+            HirStatement::VariableDeclaration {
+                name: "buf".to_string(),
+                var_type: HirType::Array { element_type: Box::new(HirType::Int), size: Some(16) },
+                initializer: None,
+            }
+        );
+        assert!(matches!(body[1], HirStatement::ArrayIndexAssignment { .. }));
+        assert!(matches!(
+            &body[2],
+            HirStatement::ArrayIndexAssignment { value: HirExpression::ArrayIndex { .. }, .. }
+        ));
+        assert_eq!(body.len(), 4);
+    }
+
+    /// Returned, passed on, offset, oversized or runtime-sized allocations stay on the heap
+    #[test]
+    fn test_escaping_allocations_stay_on_heap() {
+        let call = |name: &str| {
+            HirStatement::Expression(HirExpression::FunctionCall {
+                function: "consume".to_string(),
+                arguments: vec![var(name)],
+            })
+        };
+        let offset = HirStatement::VariableDeclaration {
+            name: "q".to_string(),
+            var_type: HirType::Pointer(Box::new(HirType::Int)),
+            initializer: Some(HirExpression::BinaryOp {
+                op: BinaryOperator::Add,
+                left: Box::new(var("buf")),
+                right: Box::new(HirExpression::IntLiteral(1)),
+            }),
+        };
+        let runtime = alloc(
+            "buf",
+            HirType::Int,
+            HirExpression::BinaryOp {
+                op: BinaryOperator::Multiply,
+                left: Box::new(var("n")),
+                right: Box::new(sizeof("int")),
+            },
+        );
+
+        for body in [
+            vec![point_alloc(), HirStatement::Return(Some(var("p")))],
+            vec![point_alloc(), call("p"), free("p")],
+            vec![buffer_alloc(16), offset, free("buf")],
+            vec![buffer_alloc(4096), free("buf")],
+            vec![runtime, free("buf")],
+        ] {
+            let params = vec![HirParameter::new("n".to_string(), HirType::Int)];
+            assert_eq!(promote(params, body.clone()), None, "{:?}", body);
+        }
+    }
+
+    fn address_of(place: HirExpression) -> HirExpression {
+        HirExpression::UnaryOp { op: UnaryOperator::AddressOf, operand: Box::new(place) }
+    }
+
+    fn field_of_p() -> HirExpression {
+        HirExpression::PointerFieldAccess { pointer: Box::new(var("p")), field: "x".to_string() }
+    }
+
+    fn call(function: &str, arguments: Vec<HirExpression>) -> HirStatement {
+        HirStatement::Expression(HirExpression::FunctionCall {
+            function: function.to_string(),
+            arguments,
+        })
+    }
+
+    /// `return &p->x;`, `q = &buf[1];` and `keep(&p->x)` hand out an address
+    /// inside the allocation
+    #[test]
+    fn test_addresses_inside_allocation_escape() {
+        let element = HirExpression::ArrayIndex {
+            array: Box::new(var("buf")),
+            index: Box::new(HirExpression::IntLiteral(1)),
+        };
+        let alias = HirStatement::VariableDeclaration {
+            name: "q".to_string(),
+            var_type: HirType::Pointer(Box::new(HirType::Int)),
+            initializer: Some(address_of(element)),
+        };
+
+        for body in [
+            vec![point_alloc(), HirStatement::Return(Some(address_of(field_of_p())))],
+            vec![buffer_alloc(16), alias, free("buf")],
+            vec![point_alloc(), call("keep", vec![address_of(field_of_p())]), free("p")],
+        ] {
+            assert_eq!(promote(vec![], body.clone()), None, "{:?}", body);
+        }
+    }
+
+    /// `scanf("%d", &p->x)` only uses the address during the call
+    #[test]
+    fn test_address_lent_to_library_call_stays_local() {
+        let read = call(
+            "scanf",
+            vec![HirExpression::StringLiteral("%d".to_string()), address_of(field_of_p())],
+        );
+        let body = vec![point_alloc(), read, HirStatement::Return(Some(field_of_p()))];
+
+        assert!(promote(vec![], body).is_some());
+    }
+
+    /// struct Big *b = malloc(sizeof(struct Big)); b->len = 0; free(b);
+    /// with a 1 MiB array field, and the same for a struct with no definition
+    #[test]
+    fn test_large_or_unknown_structs_stay_on_heap() {
+        for name in ["Big", "Opaque"] {
+            let body = vec![
+                alloc("b", HirType::Struct(name.to_string()), sizeof(&format!("struct {name}"))),
+                HirStatement::FieldAssignment {
+                    object: var("b"),
+                    field: "len".to_string(),
+                    value: HirExpression::IntLiteral(0),
+                },
+                free("b"),
+                HirStatement::Return(Some(HirExpression::IntLiteral(0))),
+            ];
+            assert_eq!(promote(vec![], body), None, "struct {name} must not be promoted");
+        }
+    }
+}
@@ -21,20 +21,26 @@ mod generated_contracts;
 
 pub mod ab_testing;
 pub mod active_learning;
+pub mod arena;
 pub mod array_slice;
 pub mod borrow_gen;
+pub mod cfg;
 pub mod classifier;
 pub mod classifier_integration;
 pub mod dataflow;
 pub mod error_tracking;
+pub mod escape;
 pub mod hybrid_classifier;
 pub mod inference;
 pub mod lifetime;
 pub mod lifetime_gen;
 pub mod ml_features;
 pub mod model_versioning;
+pub mod monomorphize;
+pub mod raw_pointer;
 pub mod retraining_pipeline;
 pub mod struct_lifetime;
+pub mod summary;
 pub mod threshold_tuning;
 pub mod training_data;
 
@@ -104,9 +110,13 @@ pub use inference::{OwnershipInference, OwnershipKind};
 
 // Re-export classifier integration types (DECY-182)
 pub use classifier_integration::{
-    classify_function_variables, classify_with_rules, extract_features_for_variable,
+    classify_function_variables, classify_with_rules, classify_with_summaries,
+    extract_features_for_variable,
 };
 
+// Re-export interprocedural ownership summaries
+pub use summary::{FunctionSummary, OwnershipSummaries, ParamEffect, ParamSummary};
+
 #[cfg(test)]
 mod ab_testing_coverage_tests;
 #[cfg(test)]
@@ -37,21 +37,32 @@ pub struct VariableLifetime {
 }
 
 /// Scope tree representing nested scopes in a function.
+///
+/// Scope IDs are dense indices into the tree. After [`ScopeTree::number_scopes`]
+/// each scope carries a pre-order interval `[enter, exit]` covering its
+/// subtree, so [`ScopeTree::is_nested_in`] is a constant-time range check.
+/// Adding a scope invalidates the numbering and nesting queries fall back to
+/// walking parent links until the tree is renumbered.
 #[derive(Debug, Clone, PartialEq, Eq)]
 pub struct ScopeTree {
     /// All scopes in the function
     scopes: Vec<Scope>,
     /// Next scope ID to assign
     next_id: usize,
+    /// Pre-order `[enter, exit]` interval per scope ID (empty when stale)
+    intervals: Vec<(usize, usize)>,
 }
 
+/// Interval for scopes not reachable from a root (malformed parent links).
+const UNNUMBERED: (usize, usize) = (usize::MAX, 0);
+
 impl ScopeTree {
     /// Create a new scope tree with a root function scope.
     pub fn new() -> Self {
         let root =
             Scope { id: 0, parent: None, variables: Vec::new(), statement_range: (0, usize::MAX) };
 
-        Self { scopes: vec![root], next_id: 1 }
+        Self { scopes: vec![root], next_id: 1, intervals: vec![(0, 0)] }
     }
 
     /// Add a new scope as a child of the given parent.
@@ -63,19 +74,20 @@ impl ScopeTree {
             Scope { id: scope_id, parent: Some(parent_id), variables: Vec::new(), statement_range };
 
         self.scopes.push(scope);
+        self.intervals.clear();
         scope_id
     }
 
     /// Add a variable to a scope.
     pub fn add_variable(&mut self, scope_id: usize, var_name: String) {
-        if let Some(scope) = self.scopes.iter_mut().find(|s| s.id == scope_id) {
+        if let Some(scope) = self.scopes.get_mut(scope_id) {
             scope.variables.push(var_name);
         }
     }
 
     /// Get a scope by ID.
     pub fn get_scope(&self, scope_id: usize) -> Option<&Scope> {
-        self.scopes.iter().find(|s| s.id == scope_id)
+        self.scopes.get(scope_id)
     }
 
     /// Get all scopes.
@@ -83,17 +95,72 @@ impl ScopeTree {
         &self.scopes
     }
 
+    /// Number every scope with its pre-order subtree interval.
+    ///
+    /// Runs in O(scopes) with an explicit stack, so deeply nested trees do not
+    /// recurse. [`LifetimeAnalyzer::build_scope_tree`] calls this once the tree
+    /// is complete.
+    pub fn number_scopes(&mut self) {
+        let count = self.scopes.len();
+        let mut children: Vec<Vec<usize>> = vec![Vec::new(); count];
+        let mut roots = Vec::new();
+        for scope in &self.scopes {
+            match scope.parent {
+                Some(parent) if parent < count && parent != scope.id => {
+                    children[parent].push(scope.id)
+                }
+                _ => roots.push(scope.id),
+            }
+        }
+
+        let mut intervals = vec![UNNUMBERED; count];
+        let mut counter = 0;
+        // (scope, next child index)
+        let mut stack: Vec<(usize, usize)> = Vec::new();
+        for root in roots {
+            intervals[root].0 = counter;
+            counter += 1;
+            stack.push((root, 0));
+            while let Some(top) = stack.last_mut() {
+                let (scope, next) = *top;
+                if let Some(&child) = children[scope].get(next) {
+                    top.1 += 1;
+                    intervals[child].0 = counter;
+                    counter += 1;
+                    stack.push((child, 0));
+                } else {
+                    intervals[scope].1 = counter - 1;
+                    stack.pop();
+                }
+            }
+        }
+
+        self.intervals = intervals;
+    }
+
+    /// Pre-order `[enter, exit]` interval of a scope, if the tree is numbered.
+    pub fn interval(&self, scope_id: usize) -> Option<(usize, usize)> {
+        self.intervals.get(scope_id).copied().filter(|&iv| iv != UNNUMBERED)
+    }
+
     /// Check if one scope is nested within another.
     pub fn is_nested_in(&self, inner_id: usize, outer_id: usize) -> bool {
+        if let (Some(inner), Some(outer)) = (self.interval(inner_id), self.interval(outer_id)) {
+            return outer.0 <= inner.0 && inner.0 <= outer.1;
+        }
+
+        // Stale numbering: walk parent links (bounded in case of malformed cycles)
         let mut current = inner_id;
-        while let Some(scope) = self.get_scope(current) {
+        for _ in 0..self.scopes.len() {
+            let Some(scope) = self.get_scope(current) else {
+                break;
+            };
             if scope.id == outer_id {
                 return true;
             }
-            if let Some(parent_id) = scope.parent {
-                current = parent_id;
-            } else {
-                break;
+            match scope.parent {
+                Some(parent_id) => current = parent_id,
+                None => break,
             }
         }
         false
@@ -138,6 +205,7 @@ impl LifetimeAnalyzer {
 
         // Process function body
         self.analyze_statements(func.body(), &mut tree, root_scope, 0);
+        tree.number_scopes();
 
         tree
     }
@@ -200,6 +268,7 @@ impl LifetimeAnalyzer {
         scope_tree: &ScopeTree,
     ) -> HashMap<String, VariableLifetime> {
         let mut lifetimes = HashMap::new();
+        let returned = self.returned_expressions(func);
 
         // Track each variable's lifetime
         for scope in scope_tree.scopes() {
@@ -209,7 +278,9 @@ impl LifetimeAnalyzer {
                     declared_in_scope: scope.id,
                     first_use: scope.statement_range.0,
                     last_use: scope.statement_range.1,
-                    escapes: self.check_if_escapes(var_name, func),
+                    escapes: returned
+                        .iter()
+                        .any(|expr| self.expression_uses_variable(expr, var_name)),
                 };
                 lifetimes.insert(var_name.clone(), lifetime);
             }
@@ -218,17 +289,18 @@ impl LifetimeAnalyzer {
         lifetimes
     }
 
-    /// Check if a variable escapes the function (returned or stored).
-    fn check_if_escapes(&self, var_name: &str, func: &HirFunction) -> bool {
-        // Check if variable appears in return statement
-        for stmt in func.body() {
-            if let HirStatement::Return(Some(expr)) = stmt {
-                if self.expression_uses_variable(expr, var_name) {
-                    return true;
-                }
-            }
-        }
-        false
+    /// Collect the expressions returned at the top level of the function body.
+    ///
+    /// Gathered once per function so escape checks only rescan return values,
+    /// not the whole body, for each variable.
+    fn returned_expressions<'a>(&self, func: &'a HirFunction) -> Vec<&'a decy_hir::HirExpression> {
+        func.body()
+            .iter()
+            .filter_map(|stmt| match stmt {
+                HirStatement::Return(Some(expr)) => Some(expr),
+                _ => None,
+            })
+            .collect()
     }
 
     /// Check if an expression uses a variable.
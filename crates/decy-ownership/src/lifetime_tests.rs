@@ -1671,3 +1671,58 @@ fn test_realloc_variable_not_present() {
 
     assert!(!lifetimes["unused"].escapes, "Variable not in realloc should not escape");
 }
+
+#[test]
+fn test_numbered_nesting_matches_parent_walk() {
+    // Interval numbering must agree with the parent-link walk for every pair
+    let mut tree = ScopeTree::new();
+    let a = tree.add_scope(0, (1, 10));
+    let b = tree.add_scope(a, (2, 5));
+    let c = tree.add_scope(0, (11, 20));
+    let d = tree.add_scope(b, (3, 4));
+    let e = tree.add_scope(c, (12, 15));
+    let ids = [0, a, b, c, d, e];
+
+    let stale: Vec<bool> = ids
+        .iter()
+        .flat_map(|&i| ids.iter().map(move |&o| (i, o)))
+        .map(|(i, o)| tree.is_nested_in(i, o))
+        .collect();
+    assert!(tree.interval(a).is_none(), "adding scopes leaves the tree unnumbered");
+
+    tree.number_scopes();
+    assert_eq!(tree.interval(0), Some((0, 5)));
+    let numbered: Vec<bool> = ids
+        .iter()
+        .flat_map(|&i| ids.iter().map(move |&o| (i, o)))
+        .map(|(i, o)| tree.is_nested_in(i, o))
+        .collect();
+    assert_eq!(stale, numbered);
+    assert!(!tree.is_nested_in(999, 0));
+}
+
+#[test]
+fn test_build_scope_tree_numbers_scopes() {
+    let inner_if = HirStatement::If {
+        condition: HirExpression::IntLiteral(1),
+        then_block: vec![HirStatement::VariableDeclaration {
+            name: "inner".to_string(),
+            var_type: HirType::Int,
+            initializer: None,
+        }],
+        else_block: None,
+    };
+    let func = HirFunction::new_with_body(
+        "nested".to_string(),
+        HirType::Void,
+        vec![],
+        vec![HirStatement::While { condition: HirExpression::IntLiteral(1), body: vec![inner_if] }],
+    );
+
+    let tree = LifetimeAnalyzer::new().build_scope_tree(&func);
+    assert_eq!(tree.scopes().len(), 3);
+    assert!(tree.interval(2).is_some());
+    assert!(tree.is_nested_in(2, 1));
+    assert!(tree.is_nested_in(2, 0));
+    assert!(!tree.is_nested_in(1, 2));
+}
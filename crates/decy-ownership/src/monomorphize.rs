@@ -0,0 +1,312 @@
+//! Concrete types for `void*`-polymorphic functions.
+//!
+//! C container and callback APIs erase their element type behind `void*`:
+//!
+//! ```c
+//! void foreach(void *items, int n, void (*visit)(void *));
+//! void bump(void *p) { int *ip = (int *)p; *ip += 1; }
+//! foreach(data, n, bump);
+//! ```
+//!
+//! When [`VoidPtrAnalyzer::instantiate`] finds that every use of such a
+//! parameter agrees on one pointee type, the unit is rewritten as if C had
+//! spelled that type out:
+//!
+//! - the `void*` parameter becomes `T*`, and the `void*` argument of a
+//!   callback parameter becomes `T*` in its function-pointer type
+//! - casts of the parameter to `T*` inside the function are dropped
+//! - `(void*)` casts of arguments passed at those positions are dropped
+//!
+//! Callback parameters whose argument was retyped are reported by
+//! [`Monomorphization::generic_callbacks`] so codegen can take them as a
+//! generic `F: FnMut` and let rustc inline the function passed in.
+//!
+//! [`VoidPtrAnalyzer::instantiate`]: decy_analyzer::void_ptr_analysis::VoidPtrAnalyzer::instantiate
+
+use decy_analyzer::void_ptr_analysis::VoidPtrInstantiation;
+use decy_hir::visit::{fold_expression_children, Fold};
+use decy_hir::{HirExpression, HirFunction, HirParameter, HirType};
+use std::collections::HashMap;
+
+/// The `void*` parameters of a unit that take a concrete type.
+#[derive(Debug, Clone, Default)]
+pub struct Monomorphization {
+    /// Pointee of each instantiated (function, parameter, callback argument)
+    pointees: HashMap<(String, usize, Option<usize>), HirType>,
+}
+
+impl Monomorphization {
+    /// Build the rewrite from the instantiations found for a unit.
+    pub fn new(instances: &[VoidPtrInstantiation]) -> Self {
+        let pointees = instances
+            .iter()
+            .map(|i| ((i.function.clone(), i.param, i.callback_arg), i.pointee.clone()))
+            .collect();
+        Self { pointees }
+    }
+
+    /// True when nothing is instantiated and lowering is the identity.
+    pub fn is_empty(&self) -> bool {
+        self.pointees.is_empty()
+    }
+
+    /// Callback parameters whose `void*` argument was retyped, as the
+    /// position and name of each, by function.
+    ///
+    /// They are only ever called or forwarded, so they can be generic.
+    pub fn generic_callbacks(
+        &self,
+        functions: &[HirFunction],
+    ) -> Vec<(String, Vec<(usize, String)>)> {
+        functions
+            .iter()
+            .filter(|f| f.has_body())
+            .filter_map(|f| {
+                let params: Vec<(usize, String)> = f
+                    .parameters()
+                    .iter()
+                    .enumerate()
+                    .filter(|(k, p)| {
+                        callback_args(p.param_type())
+                            .any(|j| self.pointee(f.name(), *k, Some(j)).is_some())
+                    })
+                    .map(|(k, p)| (k, p.name().to_string()))
+                    .collect();
+                (!params.is_empty()).then(|| (f.name().to_string(), params))
+            })
+            .collect()
+    }
+
+    /// Retype a function's instantiated parameters and drop the casts they
+    /// no longer need, in its body and at its call sites.
+    pub fn lower_function(&self, func: &HirFunction) -> HirFunction {
+        if self.is_empty() || !func.has_body() {
+            return func.clone();
+        }
+        let parameters: Vec<HirParameter> = func
+            .parameters()
+            .iter()
+            .enumerate()
+            .map(|(k, p)| p.with_type(self.param_type(func.name(), k, p.param_type())))
+            .collect();
+        let mut rewriter =
+            CastRewriter { plan: self, function: func.name(), parameters: &parameters };
+        let body = rewriter.fold_block(func.body().to_vec());
+        func.with_parameters(parameters).with_body(body)
+    }
+
+    fn pointee(
+        &self,
+        function: &str,
+        param: usize,
+        callback_arg: Option<usize>,
+    ) -> Option<&HirType> {
+        self.pointees.get(&(function.to_string(), param, callback_arg))
+    }
+
+    fn param_type(&self, function: &str, param: usize, ty: &HirType) -> HirType {
+        if let Some(pointee) = self.pointee(function, param, None) {
+            return HirType::Pointer(Box::new(pointee.clone()));
+        }
+        match ty {
+            HirType::FunctionPointer { param_types, return_type } => HirType::FunctionPointer {
+                param_types: param_types
+                    .iter()
+                    .enumerate()
+                    .map(|(j, t)| match self.pointee(function, param, Some(j)) {
+                        Some(pointee) => HirType::Pointer(Box::new(pointee.clone())),
+                        None => t.clone(),
+                    })
+                    .collect(),
+                return_type: return_type.clone(),
+            },
+            other => other.clone(),
+        }
+    }
+}
+
+/// Argument positions of a function-pointer type.
+fn callback_args(ty: &HirType) -> std::ops::Range<usize> {
+    match ty {
+        HirType::FunctionPointer { param_types, .. } => 0..param_types.len(),
+        _ => 0..0,
+    }
+}
+
+/// Drops casts made redundant by retyped parameters in one function.
+struct CastRewriter<'a> {
+    plan: &'a Monomorphization,
+    function: &'a str,
+    /// The function's parameters, already retyped
+    parameters: &'a [HirParameter],
+}
+
+impl CastRewriter<'_> {
+    fn param(&self, name: &str) -> Option<(usize, &HirParameter)> {
+        self.parameters.iter().enumerate().find(|(_, p)| p.name() == name)
+    }
+
+    /// Whether `expr` names an instantiated parameter now of type `ty`.
+    fn is_retyped_param(&self, expr: &HirExpression, ty: &HirType) -> bool {
+        let HirExpression::Variable(name) = expr else {
+            return false;
+        };
+        self.param(name).is_some_and(|(k, p)| {
+            self.plan.pointee(self.function, k, None).is_some() && p.param_type() == ty
+        })
+    }
+
+    /// Whether a call to `function` takes a retyped pointer at `arg`.
+    fn retyped_argument(&self, function: &str, arg: usize) -> bool {
+        match self.param(function) {
+            // A call through one of our own callback parameters
+            Some((k, _)) => self.plan.pointee(self.function, k, Some(arg)).is_some(),
+            None => self.plan.pointee(function, arg, None).is_some(),
+        }
+    }
+}
+
+impl Fold for CastRewriter<'_> {
+    fn fold_expression(&mut self, expr: HirExpression) -> HirExpression {
+        match expr {
+            // (T *)p where p is now a T *
+            HirExpression::Cast { target_type, expr: operand }
+                if self.is_retyped_param(&operand, &target_type) =>
+            {
+                *operand
+            }
+            HirExpression::FunctionCall { function, arguments } => {
+                let arguments = arguments
+                    .into_iter()
+                    .enumerate()
+                    .map(|(k, arg)| match arg {
+                        HirExpression::Cast { target_type: HirType::Pointer(inner), expr }
+                            if matches!(inner.as_ref(), HirType::Void)
+                                && self.retyped_argument(&function, k) =>
+                        {
+                            self.fold_expression(*expr)
+                        }
+                        other => self.fold_expression(other),
+                    })
+                    .collect();
+                HirExpression::FunctionCall { function, arguments }
+            }
+            other => fold_expression_children(self, other),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use decy_hir::HirStatement;
+
+    fn var(name: &str) -> HirExpression {
+        HirExpression::Variable(name.to_string())
+    }
+
+    fn void_ptr() -> HirType {
+        HirType::Pointer(Box::new(HirType::Void))
+    }
+
+    fn int_ptr() -> HirType {
+        HirType::Pointer(Box::new(HirType::Int))
+    }
+
+    fn instance(function: &str, param: usize, callback_arg: Option<usize>) -> VoidPtrInstantiation {
+        VoidPtrInstantiation {
+            function: function.to_string(),
+            param,
+            callback_arg,
+            pointee: HirType::Int,
+        }
+    }
+
+    /// void apply(void *item, void (*visit)(void *)) { visit((void *)item); }
+    fn apply() -> HirFunction {
+        let visit = HirType::FunctionPointer {
+            param_types: vec![void_ptr()],
+            return_type: Box::new(HirType::Void),
+        };
+        HirFunction::new_with_body(
+            "apply".to_string(),
+            HirType::Void,
+            vec![
+                HirParameter::new("item".to_string(), void_ptr()),
+                HirParameter::new("visit".to_string(), visit),
+            ],
+            vec![HirStatement::Expression(HirExpression::FunctionCall {
+                function: "visit".to_string(),
+                arguments: vec![HirExpression::Cast {
+                    target_type: void_ptr(),
+                    expr: Box::new(var("item")),
+                }],
+            })],
+        )
+    }
+
+    #[test]
+    fn test_retypes_params_and_callback_arguments() {
+        let plan =
+            Monomorphization::new(&[instance("apply", 0, None), instance("apply", 1, Some(0))]);
+        let lowered = plan.lower_function(&apply());
+
+        assert_eq!(*lowered.parameters()[0].param_type(), int_ptr());
+        assert_eq!(
+            *lowered.parameters()[1].param_type(),
+            HirType::FunctionPointer {
+                param_types: vec![int_ptr()],
+                return_type: Box::new(HirType::Void)
+            }
+        );
+        // The (void *) cast at the callback call is gone
+        assert_eq!(
+            lowered.body()[0],
+            HirStatement::Expression(HirExpression::FunctionCall {
+                function: "visit".to_string(),
+                arguments: vec![var("item")],
+            })
+        );
+        assert_eq!(
+            plan.generic_callbacks(&[lowered]),
+            vec![("apply".to_string(), vec![(1, "visit".to_string())])]
+        );
+    }
+
+    #[test]
+    fn test_drops_casts_of_retyped_param() {
+        // void bump(void *p) { int *ip = (int *)p; }
+        let bump = HirFunction::new_with_body(
+            "bump".to_string(),
+            HirType::Void,
+            vec![HirParameter::new("p".to_string(), void_ptr())],
+            vec![HirStatement::VariableDeclaration {
+                name: "ip".to_string(),
+                var_type: int_ptr(),
+                initializer: Some(HirExpression::Cast {
+                    target_type: int_ptr(),
+                    expr: Box::new(var("p")),
+                }),
+            }],
+        );
+        let lowered = Monomorphization::new(&[instance("bump", 0, None)]).lower_function(&bump);
+
+        assert_eq!(
+            lowered.body()[0],
+            HirStatement::VariableDeclaration {
+                name: "ip".to_string(),
+                var_type: int_ptr(),
+                initializer: Some(var("p")),
+            }
+        );
+    }
+
+    #[test]
+    fn test_empty_plan_is_identity() {
+        let func = apply();
+        let lowered = Monomorphization::default().lower_function(&func);
+
+        assert!(lowered.shares_body_with(&func));
+        assert!(Monomorphization::default().generic_callbacks(&[func]).is_empty());
+    }
+}
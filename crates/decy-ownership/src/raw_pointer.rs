@@ -0,0 +1,119 @@
+//! Pointer parameters that must stay raw pointers.
+//!
+//! A Rust reference can be neither reassigned nor null, so a pointer
+//! parameter that is stepped (`p++`, `p = p + n`, `p = p->next`) or compared
+//! against NULL keeps its `*mut T` type (DECY-123, DECY-137, DECY-159).
+//!
+//! Codegen decides a function's signature with [`needs_raw_pointer`], and
+//! the ownership summaries its call sites are built from record the same
+//! two facts, so a caller passes exactly what the callee takes.
+
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirStatement};
+
+/// Whether pointer parameter `name` of `func` must stay a raw pointer.
+pub fn needs_raw_pointer(func: &HirFunction, name: &str) -> bool {
+    uses_pointer_arithmetic(func, name) || pointer_compared_to_null(func, name)
+}
+
+/// Whether `func` steps or reassigns the pointer `name`.
+pub fn uses_pointer_arithmetic(func: &HirFunction, name: &str) -> bool {
+    func.body().iter().any(|s| statement_uses_pointer_arithmetic(s, name))
+}
+
+/// Whether `func` compares the pointer `name` against NULL, which makes
+/// NULL a valid input.
+pub fn pointer_compared_to_null(func: &HirFunction, name: &str) -> bool {
+    func.body().iter().any(|s| statement_compares_to_null(s, name))
+}
+
+/// Whether `stmt` steps or reassigns `var`:
+/// - `var = var + n` / `var = var - n`
+/// - `var = other->field` (linked-list traversal)
+/// - `var++`, `--var` as statements, and `*var++ = *src++`
+pub fn statement_uses_pointer_arithmetic(stmt: &HirStatement, var: &str) -> bool {
+    let any =
+        |block: &[HirStatement]| block.iter().any(|s| statement_uses_pointer_arithmetic(s, var));
+    match stmt {
+        HirStatement::Assignment { target, value } if target == var => match value {
+            HirExpression::BinaryOp {
+                op: BinaryOperator::Add | BinaryOperator::Subtract,
+                left,
+                ..
+            } => matches!(&**left, HirExpression::Variable(name) if name == var),
+            HirExpression::PointerFieldAccess { .. } => true,
+            _ => false,
+        },
+        HirStatement::Expression(expr) => steps(expr, var),
+        HirStatement::DerefAssignment { target, value } => {
+            steps(target, var)
+                || matches!(value, HirExpression::Dereference(inner) if steps(inner, var))
+        }
+        HirStatement::If { then_block, else_block, .. } => {
+            any(then_block) || else_block.as_deref().is_some_and(any)
+        }
+        HirStatement::While { body, .. } | HirStatement::For { body, .. } => any(body),
+        HirStatement::Switch { cases, default_case, .. } => {
+            cases.iter().any(|c| any(&c.body)) || default_case.as_deref().is_some_and(any)
+        }
+        _ => false,
+    }
+}
+
+/// Whether a condition in `stmt`, or in a statement nested in it, compares
+/// `var` against NULL.
+pub fn statement_compares_to_null(stmt: &HirStatement, var: &str) -> bool {
+    let any = |block: &[HirStatement]| block.iter().any(|s| statement_compares_to_null(s, var));
+    match stmt {
+        HirStatement::If { condition, then_block, else_block } => {
+            expression_compares_to_null(condition, var)
+                || any(then_block)
+                || else_block.as_deref().is_some_and(any)
+        }
+        HirStatement::While { condition, body } => {
+            expression_compares_to_null(condition, var) || any(body)
+        }
+        HirStatement::For { condition, body, .. } => {
+            condition.as_ref().is_some_and(|c| expression_compares_to_null(c, var)) || any(body)
+        }
+        HirStatement::Switch { condition, cases, default_case } => {
+            expression_compares_to_null(condition, var)
+                || cases.iter().any(|c| any(&c.body))
+                || default_case.as_deref().is_some_and(any)
+        }
+        _ => false,
+    }
+}
+
+/// Whether `expr` compares `var` against NULL: `var == NULL`, `0 != var`,
+/// or a bare `var` tested for non-null, possibly inside `!`, `&&` or `||`.
+///
+/// NULL is either `NullLiteral` or `0` once the macro has been expanded.
+pub fn expression_compares_to_null(expr: &HirExpression, var: &str) -> bool {
+    let is_var = |e: &HirExpression| matches!(e, HirExpression::Variable(name) if name == var);
+    let is_null =
+        |e: &HirExpression| matches!(e, HirExpression::NullLiteral | HirExpression::IntLiteral(0));
+    match expr {
+        HirExpression::BinaryOp { op, left, right } => {
+            (matches!(op, BinaryOperator::Equal | BinaryOperator::NotEqual)
+                && (is_var(left) && is_null(right) || is_null(left) && is_var(right)))
+                || expression_compares_to_null(left, var)
+                || expression_compares_to_null(right, var)
+        }
+        HirExpression::IsNotNull(inner) => is_var(inner),
+        HirExpression::UnaryOp { operand, .. } => expression_compares_to_null(operand, var),
+        _ => false,
+    }
+}
+
+/// `var++`, `++var`, `var--` or `--var`.
+fn steps(expr: &HirExpression, var: &str) -> bool {
+    match expr {
+        HirExpression::PostIncrement { operand }
+        | HirExpression::PreIncrement { operand }
+        | HirExpression::PostDecrement { operand }
+        | HirExpression::PreDecrement { operand } => {
+            matches!(&**operand, HirExpression::Variable(name) if name == var)
+        }
+        _ => false,
+    }
+}
@@ -0,0 +1,637 @@
+//! Interprocedural ownership summaries.
+//!
+//! Each function body is walked once to record what it does with its pointer
+//! parameters: writes through them, frees them, stores them somewhere that
+//! outlives the call, or returns them. Summaries are then propagated
+//! bottom-up over the call graph in strongly-connected-component order, so a
+//! caller that hands a pointer to a callee inherits the callee's effect on
+//! that argument without re-walking the callee body.
+//!
+//! Mutually recursive functions share an SCC and are solved to a fixpoint.
+//! SCCs at the same depth of the condensed call graph do not depend on each
+//! other and are analysed in parallel.
+
+use crate::raw_pointer;
+use decy_hir::{HirExpression, HirFunction, HirStatement};
+use decy_stdlib::StdlibPrototypes;
+use petgraph::algo::tarjan_scc;
+use petgraph::graph::{DiGraph, NodeIndex};
+use std::collections::{HashMap, HashSet};
+use std::sync::OnceLock;
+
+/// Below this many functions the thread start-up cost outweighs the work.
+const PARALLEL_THRESHOLD: usize = 64;
+
+/// Dominant effect a function has on one of its pointer parameters.
+///
+/// Variants are ordered from weakest to strongest, so `max` of two effects
+/// is the effect of doing both.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub enum ParamEffect {
+    /// Only read through; can be passed as `&T`.
+    Borrowed,
+    /// Written through (`*p = v`, `p[i] = v`); needs `&mut T`.
+    BorrowedMut,
+    /// Returned or stored in a global, so it outlives the call.
+    Escapes,
+    /// Stored into caller-visible memory or handed to `realloc`.
+    Consumed,
+    /// Released with `free`.
+    Freed,
+}
+
+/// What a function does with one pointer parameter, including effects of
+/// the callees it passes the parameter to.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct ParamSummary {
+    /// Parameter name
+    pub name: String,
+    /// Pointee is written through the parameter
+    pub writes: bool,
+    /// Parameter is returned or stored in a global
+    pub escapes: bool,
+    /// Parameter is stored into another object or reallocated
+    pub consumed: bool,
+    /// Parameter is freed
+    pub frees: bool,
+    /// Parameter is stepped or reassigned (local only)
+    pub pointer_arithmetic: bool,
+    /// Parameter is compared against NULL, so NULL is a valid input (local only)
+    pub null_checked: bool,
+}
+
+impl ParamSummary {
+    fn new(name: &str) -> Self {
+        Self { name: name.to_string(), ..Self::default() }
+    }
+
+    /// Strongest effect recorded for this parameter.
+    pub fn effect(&self) -> ParamEffect {
+        if self.frees {
+            ParamEffect::Freed
+        } else if self.consumed {
+            ParamEffect::Consumed
+        } else if self.escapes {
+            ParamEffect::Escapes
+        } else if self.writes {
+            ParamEffect::BorrowedMut
+        } else {
+            ParamEffect::Borrowed
+        }
+    }
+
+    /// Whether the callee takes ownership of the pointee.
+    pub fn transfers_ownership(&self) -> bool {
+        self.frees || self.consumed
+    }
+
+    /// Whether the parameter must stay a raw pointer at call sites; see
+    /// [`crate::raw_pointer`].
+    pub fn needs_raw_pointer(&self) -> bool {
+        self.pointer_arithmetic || self.null_checked
+    }
+
+    /// Merge a callee's effect on the argument this parameter was passed as.
+    ///
+    /// Pointer arithmetic and NULL checks are properties of the callee's own
+    /// signature and do not flow back to the caller.
+    fn absorb(&mut self, callee: &ParamSummary) -> bool {
+        let before = (self.writes, self.escapes, self.consumed, self.frees);
+        self.writes |= callee.writes;
+        self.escapes |= callee.escapes;
+        self.consumed |= callee.consumed;
+        self.frees |= callee.frees;
+        before != (self.writes, self.escapes, self.consumed, self.frees)
+    }
+}
+
+/// Ownership summary for one function.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct FunctionSummary {
+    /// Function name
+    pub name: String,
+    /// One entry per parameter, in declaration order
+    pub params: Vec<ParamSummary>,
+    /// False for prototypes; their parameters are assumed borrowed
+    pub has_body: bool,
+}
+
+impl FunctionSummary {
+    /// Summarise a function from its own body only, ignoring callee effects.
+    pub fn local(func: &HirFunction) -> Self {
+        LocalFacts::collect(func).summary
+    }
+
+    /// Summary for the parameter at `index`.
+    pub fn param(&self, index: usize) -> Option<&ParamSummary> {
+        self.params.get(index)
+    }
+
+    /// Summary for the parameter called `name`.
+    pub fn param_named(&self, name: &str) -> Option<&ParamSummary> {
+        self.params.iter().find(|p| p.name == name)
+    }
+}
+
+/// A parameter passed directly as an argument to another function.
+#[derive(Debug, Clone)]
+struct CallSite {
+    callee: String,
+    arg_index: usize,
+    param_index: usize,
+}
+
+/// Per-function facts gathered in a single walk of the body.
+#[derive(Debug, Clone)]
+struct LocalFacts {
+    summary: FunctionSummary,
+    calls: Vec<CallSite>,
+}
+
+impl LocalFacts {
+    fn collect(func: &HirFunction) -> Self {
+        let params: Vec<ParamSummary> = func
+            .parameters()
+            .iter()
+            .map(|p| ParamSummary {
+                pointer_arithmetic: raw_pointer::uses_pointer_arithmetic(func, p.name()),
+                null_checked: raw_pointer::pointer_compared_to_null(func, p.name()),
+                ..ParamSummary::new(p.name())
+            })
+            .collect();
+        let mut walker = FactWalker {
+            params: func
+                .parameters()
+                .iter()
+                .enumerate()
+                .map(|(i, p)| (p.name().to_string(), i))
+                .collect(),
+            locals: HashSet::new(),
+            summary: params,
+            calls: Vec::new(),
+        };
+        for stmt in func.body() {
+            walker.statement(stmt);
+        }
+        Self {
+            summary: FunctionSummary {
+                name: func.name().to_string(),
+                params: walker.summary,
+                has_body: func.has_body(),
+            },
+            calls: walker.calls,
+        }
+    }
+}
+
+/// The variable a field store writes through: `s` in `s->a.b`, `(*s).a`
+/// or `s[i].a`.
+fn base_of(object: &HirExpression) -> &HirExpression {
+    match object {
+        HirExpression::PointerFieldAccess { pointer: inner, .. }
+        | HirExpression::FieldAccess { object: inner, .. }
+        | HirExpression::ArrayIndex { array: inner, .. }
+        | HirExpression::Dereference(inner) => base_of(inner),
+        _ => object,
+    }
+}
+
+struct FactWalker {
+    params: HashMap<String, usize>,
+    locals: HashSet<String>,
+    summary: Vec<ParamSummary>,
+    calls: Vec<CallSite>,
+}
+
+impl FactWalker {
+    /// Parameter index if `expr` is a (possibly cast) unshadowed parameter.
+    fn param_of(&self, expr: &HirExpression) -> Option<usize> {
+        match expr {
+            HirExpression::Variable(name) if !self.locals.contains(name) => {
+                self.params.get(name).copied()
+            }
+            HirExpression::Cast { expr, .. } => self.param_of(expr),
+            _ => None,
+        }
+    }
+
+    fn mark(&mut self, expr: &HirExpression, set: impl FnOnce(&mut ParamSummary)) {
+        if let Some(index) = self.param_of(expr) {
+            set(&mut self.summary[index]);
+        }
+    }
+
+    fn block(&mut self, stmts: &[HirStatement]) {
+        for stmt in stmts {
+            self.statement(stmt);
+        }
+    }
+
+    fn statement(&mut self, stmt: &HirStatement) {
+        match stmt {
+            HirStatement::VariableDeclaration { name, initializer, .. } => {
+                if let Some(init) = initializer {
+                    self.expression(init);
+                }
+                self.locals.insert(name.clone());
+            }
+            HirStatement::Return(value) => {
+                if let Some(value) = value {
+                    self.mark(value, |p| p.escapes = true);
+                    self.expression(value);
+                }
+            }
+            HirStatement::If { condition, then_block, else_block } => {
+                self.expression(condition);
+                self.block(then_block);
+                if let Some(else_block) = else_block {
+                    self.block(else_block);
+                }
+            }
+            HirStatement::While { condition, body } => {
+                self.expression(condition);
+                self.block(body);
+            }
+            HirStatement::For { init, condition, increment, body } => {
+                self.block(init);
+                if let Some(condition) = condition {
+                    self.expression(condition);
+                }
+                self.block(increment);
+                self.block(body);
+            }
+            HirStatement::Switch { condition, cases, default_case } => {
+                self.expression(condition);
+                for case in cases {
+                    if let Some(value) = &case.value {
+                        self.expression(value);
+                    }
+                    self.block(&case.body);
+                }
+                if let Some(default_case) = default_case {
+                    self.block(default_case);
+                }
+            }
+            HirStatement::Assignment { target, value } => {
+                if !self.params.contains_key(target) && !self.locals.contains(target) {
+                    // Neither a parameter nor a local: a global outlives the call
+                    self.mark(value, |p| p.escapes = true);
+                }
+                self.expression(value);
+            }
+            HirStatement::DerefAssignment { target, value } => {
+                self.mark(target, |p| p.writes = true);
+                self.mark(value, |p| p.consumed = true);
+                self.expression(target);
+                self.expression(value);
+            }
+            HirStatement::ArrayIndexAssignment { array, index, value } => {
+                self.mark(array, |p| p.writes = true);
+                self.mark(value, |p| p.consumed = true);
+                self.expression(array);
+                self.expression(index);
+                self.expression(value);
+            }
+            HirStatement::FieldAssignment { object, value, .. } => {
+                self.mark(base_of(object), |p| p.writes = true);
+                self.mark(value, |p| p.consumed = true);
+                self.expression(object);
+                self.expression(value);
+            }
+            HirStatement::Free { pointer } => {
+                self.mark(pointer, |p| p.frees = true);
+                self.expression(pointer);
+            }
+            HirStatement::Expression(expr) => self.expression(expr),
+            HirStatement::Break | HirStatement::Continue | HirStatement::InlineAsm { .. } => {}
+        }
+    }
+
+    fn expression(&mut self, expr: &HirExpression) {
+        match expr {
+            HirExpression::FunctionCall { function, arguments } => {
+                if function == "free" {
+                    if let Some(arg) = arguments.first() {
+                        self.mark(arg, |p| p.frees = true);
+                    }
+                } else {
+                    for (arg_index, arg) in arguments.iter().enumerate() {
+                        if let Some(param_index) = self.param_of(arg) {
+                            self.calls.push(CallSite {
+                                callee: function.clone(),
+                                arg_index,
+                                param_index,
+                            });
+                        }
+                    }
+                }
+                for arg in arguments {
+                    self.expression(arg);
+                }
+            }
+            HirExpression::Realloc { pointer, new_size } => {
+                self.mark(pointer, |p| p.consumed = true);
+                self.expression(pointer);
+                self.expression(new_size);
+            }
+            HirExpression::BinaryOp { left, right, .. } => {
+                self.expression(left);
+                self.expression(right);
+            }
+            HirExpression::Dereference(inner)
+            | HirExpression::IsNotNull(inner)
+            | HirExpression::AddressOf(inner)
+            | HirExpression::UnaryOp { operand: inner, .. }
+            | HirExpression::PostIncrement { operand: inner }
+            | HirExpression::PreIncrement { operand: inner }
+            | HirExpression::PostDecrement { operand: inner }
+            | HirExpression::PreDecrement { operand: inner }
+            | HirExpression::FieldAccess { object: inner, .. }
+            | HirExpression::PointerFieldAccess { pointer: inner, .. }
+            | HirExpression::Cast { expr: inner, .. }
+            | HirExpression::Malloc { size: inner }
+            | HirExpression::Calloc { count: inner, .. }
+            | HirExpression::CxxDelete { operand: inner } => self.expression(inner),
+            HirExpression::ArrayIndex { array, index } => {
+                self.expression(array);
+                self.expression(index);
+            }
+            HirExpression::SliceIndex { slice, index, .. } => {
+                self.expression(slice);
+                self.expression(index);
+            }
+            HirExpression::StringMethodCall { receiver, arguments, .. } => {
+                self.expression(receiver);
+                for arg in arguments {
+                    self.expression(arg);
+                }
+            }
+            HirExpression::CompoundLiteral { initializers: items, .. }
+            | HirExpression::CxxNew { arguments: items, .. } => {
+                for item in items {
+                    self.expression(item);
+                }
+            }
+            HirExpression::Ternary { condition, then_expr, else_expr } => {
+                self.expression(condition);
+                self.expression(then_expr);
+                self.expression(else_expr);
+            }
+            HirExpression::IntLiteral(_)
+            | HirExpression::FloatLiteral(_)
+            | HirExpression::StringLiteral(_)
+            | HirExpression::CharLiteral(_)
+            | HirExpression::Variable(_)
+            | HirExpression::Sizeof { .. }
+            | HirExpression::NullLiteral => {}
+        }
+    }
+}
+
+/// Ownership summaries for every function of a translation unit.
+#[derive(Debug, Clone, Default)]
+pub struct OwnershipSummaries {
+    summaries: HashMap<String, FunctionSummary>,
+    external: HashMap<String, FunctionSummary>,
+    sccs: Vec<Vec<String>>,
+}
+
+impl OwnershipSummaries {
+    /// Compute summaries for `functions`, propagating callee effects to callers.
+    ///
+    /// When a name is both declared and defined, the definition is used.
+    pub fn compute(functions: &[HirFunction]) -> Self {
+        Self::compute_with_external(functions, std::iter::empty())
+    }
+
+    /// Compute summaries, resolving calls to functions defined in other
+    /// translation units against their already-computed summaries.
+    ///
+    /// A local prototype is replaced by the external summary of the same
+    /// name; a local definition always wins.
+    pub fn compute_with_external(
+        functions: &[HirFunction],
+        external: impl IntoIterator<Item = FunctionSummary>,
+    ) -> Self {
+        let external: HashMap<String, FunctionSummary> =
+            external.into_iter().map(|summary| (summary.name.clone(), summary)).collect();
+        let mut by_name: HashMap<&str, &HirFunction> = HashMap::new();
+        for func in functions.iter().filter(|f| f.has_body() || !external.contains_key(f.name())) {
+            by_name
+                .entry(func.name())
+                .and_modify(|existing| {
+                    if func.has_body() && !existing.has_body() {
+                        *existing = func;
+                    }
+                })
+                .or_insert(func);
+        }
+        let mut names: Vec<&str> = by_name.keys().copied().collect();
+        names.sort_unstable();
+
+        let facts: Vec<LocalFacts> =
+            parallel_map(&names, |name| LocalFacts::collect(by_name[name]));
+        Self::solve(&facts, external)
+    }
+
+    /// Compute summaries from functions produced one at a time.
+    ///
+    /// Each function is only borrowed while its local facts are collected, so
+    /// callers can build HIR lazily and drop it straight afterwards; only the
+    /// per-function facts stay alive. Duplicates and prototypes resolve as in
+    /// [`compute_with_external`](Self::compute_with_external).
+    pub fn compute_streaming(
+        functions: impl IntoIterator<Item = HirFunction>,
+        external: impl IntoIterator<Item = FunctionSummary>,
+    ) -> Self {
+        let external: HashMap<String, FunctionSummary> =
+            external.into_iter().map(|summary| (summary.name.clone(), summary)).collect();
+        let mut by_name: HashMap<String, LocalFacts> = HashMap::new();
+        for func in functions {
+            if !func.has_body() && external.contains_key(func.name()) {
+                continue;
+            }
+            if let Some(existing) = by_name.get(func.name()) {
+                if !func.has_body() || existing.summary.has_body {
+                    continue;
+                }
+            }
+            by_name.insert(func.name().to_string(), LocalFacts::collect(&func));
+        }
+        let mut facts: Vec<LocalFacts> = by_name.into_values().collect();
+        facts.sort_unstable_by(|a, b| a.summary.name.cmp(&b.summary.name));
+        Self::solve(&facts, external)
+    }
+
+    /// Propagate callee effects over the call graph of `facts`, which must be
+    /// sorted by function name.
+    fn solve(facts: &[LocalFacts], external: HashMap<String, FunctionSummary>) -> Self {
+        let names: Vec<&str> = facts.iter().map(|f| f.summary.name.as_str()).collect();
+        let facts: HashMap<&str, &LocalFacts> = names.iter().copied().zip(facts).collect();
+
+        // Call graph: caller -> callee, restricted to functions we know about
+        let mut graph: DiGraph<&str, ()> = DiGraph::new();
+        let nodes: HashMap<&str, NodeIndex> =
+            names.iter().map(|&name| (name, graph.add_node(name))).collect();
+        for &caller in &names {
+            let mut seen = HashSet::new();
+            for call in &facts[caller].calls {
+                if let Some(&callee) = nodes.get(call.callee.as_str()) {
+                    if seen.insert(callee) {
+                        graph.add_edge(nodes[caller], callee, ());
+                    }
+                }
+            }
+        }
+
+        // tarjan_scc yields SCCs in reverse topological order: callees first
+        let sccs = tarjan_scc(&graph);
+        let mut scc_of = vec![0usize; graph.node_count()];
+        for (i, scc) in sccs.iter().enumerate() {
+            for node in scc {
+                scc_of[node.index()] = i;
+            }
+        }
+        let mut depth = vec![0usize; sccs.len()];
+        for (i, scc) in sccs.iter().enumerate() {
+            depth[i] = scc
+                .iter()
+                .flat_map(|&node| graph.neighbors(node))
+                .map(|callee| scc_of[callee.index()])
+                .filter(|&j| j != i)
+                .map(|j| depth[j] + 1)
+                .max()
+                .unwrap_or(0);
+        }
+        let mut waves: Vec<Vec<Vec<&str>>> = Vec::new();
+        for (i, scc) in sccs.iter().enumerate() {
+            if waves.len() <= depth[i] {
+                waves.resize_with(depth[i] + 1, Vec::new);
+            }
+            let mut members: Vec<&str> = scc.iter().map(|&node| graph[node]).collect();
+            members.sort_unstable();
+            waves[depth[i]].push(members);
+        }
+
+        let mut result = Self { external, ..Self::default() };
+        for wave in waves {
+            let solved = parallel_map(&wave, |members| solve_scc(members, &facts, &result));
+            for (members, summaries) in wave.into_iter().zip(solved) {
+                for summary in summaries {
+                    result.summaries.insert(summary.name.clone(), summary);
+                }
+                result.sccs.push(members.into_iter().map(str::to_string).collect());
+            }
+        }
+        result
+    }
+
+    /// Summary for the function called `name`, local or external.
+    pub fn get(&self, name: &str) -> Option<&FunctionSummary> {
+        self.summaries.get(name).or_else(|| self.external.get(name))
+    }
+
+    /// Whether a call to `function` may write through its argument at
+    /// `index`. A function with a body, here or in an imported unit, answers
+    /// from its summary; anything else from its C library prototype.
+    pub fn writes_through(&self, function: &str, index: usize) -> bool {
+        match self.get(function).filter(|summary| summary.has_body) {
+            Some(summary) => summary.param(index).is_some_and(|param| param.writes),
+            None => libc_writes_through(function, index),
+        }
+    }
+
+    /// Summaries of the functions of this translation unit.
+    pub fn iter(&self) -> impl Iterator<Item = &FunctionSummary> {
+        self.summaries.values()
+    }
+
+    /// Call-graph SCCs in the order they were solved (callees before callers).
+    pub fn sccs(&self) -> &[Vec<String>] {
+        &self.sccs
+    }
+
+    /// Number of summarised local functions.
+    pub fn len(&self) -> usize {
+        self.summaries.len()
+    }
+
+    /// Whether no local functions were summarised.
+    pub fn is_empty(&self) -> bool {
+        self.summaries.is_empty()
+    }
+}
+
+/// Whether the C library function `function` may write through its argument
+/// at `index`, i.e. the parameter there points to non-const. Variadic
+/// arguments and functions without a prototype are assumed only read.
+pub fn libc_writes_through(function: &str, index: usize) -> bool {
+    static PROTOTYPES: OnceLock<StdlibPrototypes> = OnceLock::new();
+    PROTOTYPES
+        .get_or_init(StdlibPrototypes::new)
+        .get_prototype(function)
+        .and_then(|proto| proto.parameters.get(index))
+        .is_some_and(|param| {
+            let param_type = param.type_str.trim();
+            param_type.ends_with('*') && !param_type.starts_with("const")
+        })
+}
+
+/// Solve one SCC to a fixpoint against the already-solved lower waves.
+fn solve_scc(
+    members: &[&str],
+    facts: &HashMap<&str, &LocalFacts>,
+    solved: &OwnershipSummaries,
+) -> Vec<FunctionSummary> {
+    let mut current: HashMap<&str, FunctionSummary> =
+        members.iter().map(|&name| (name, facts[name].summary.clone())).collect();
+
+    loop {
+        let mut changed = false;
+        for &caller in members {
+            for call in &facts[caller].calls {
+                let callee = match current.get(call.callee.as_str()) {
+                    Some(summary) => summary.param(call.arg_index).cloned(),
+                    None => solved.get(&call.callee).and_then(|s| s.param(call.arg_index).cloned()),
+                };
+                let Some(callee) = callee else { continue };
+                if let Some(summary) = current.get_mut(caller) {
+                    changed |= summary.params[call.param_index].absorb(&callee);
+                }
+            }
+        }
+        if !changed {
+            break;
+        }
+    }
+
+    members.iter().filter_map(|name| current.remove(name)).collect()
+}
+
+/// Map `f` over `items`, splitting across scoped threads for large inputs.
+fn parallel_map<T, R, F>(items: &[T], f: F) -> Vec<R>
+where
+    T: Sync,
+    R: Send,
+    F: Fn(&T) -> R + Sync,
+{
+    let threads = std::thread::available_parallelism().map_or(1, |n| n.get());
+    if items.len() < PARALLEL_THRESHOLD || threads < 2 {
+        return items.iter().map(f).collect();
+    }
+    let chunk_size = items.len().div_ceil(threads);
+    std::thread::scope(|scope| {
+        let handles: Vec<_> = items
+            .chunks(chunk_size)
+            .map(|chunk| scope.spawn(|| chunk.iter().map(&f).collect::<Vec<R>>()))
+            .collect();
+        handles
+            .into_iter()
+            .flat_map(|handle| handle.join().expect("summary worker panicked"))
+            .collect()
+    })
+}
+
+#[cfg(test)]
+#[path = "summary_tests.rs"]
+mod summary_tests;
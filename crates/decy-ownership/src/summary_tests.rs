@@ -0,0 +1,335 @@
+//! Tests for interprocedural ownership summaries.
+
+use crate::summary::*;
+use decy_hir::{BinaryOperator, HirExpression, HirFunction, HirParameter, HirStatement, HirType};
+
+fn int_ptr(name: &str) -> HirParameter {
+    HirParameter::new(name.to_string(), HirType::Pointer(Box::new(HirType::Int)))
+}
+
+fn var(name: &str) -> HirExpression {
+    HirExpression::Variable(name.to_string())
+}
+
+fn call(function: &str, arguments: Vec<HirExpression>) -> HirStatement {
+    HirStatement::Expression(HirExpression::FunctionCall {
+        function: function.to_string(),
+        arguments,
+    })
+}
+
+fn func(name: &str, params: Vec<HirParameter>, body: Vec<HirStatement>) -> HirFunction {
+    HirFunction::new_with_body(name.to_string(), HirType::Void, params, body)
+}
+
+#[test]
+fn test_local_read_only_param_is_borrowed() {
+    let f = func(
+        "read",
+        vec![int_ptr("p")],
+        vec![HirStatement::Expression(HirExpression::Dereference(Box::new(var("p"))))],
+    );
+
+    let summary = FunctionSummary::local(&f);
+    assert_eq!(summary.param(0).unwrap().effect(), ParamEffect::Borrowed);
+}
+
+#[test]
+fn test_local_effects() {
+    let f = func(
+        "effects",
+        vec![int_ptr("w"), int_ptr("f"), int_ptr("s"), int_ptr("r")],
+        vec![
+            HirStatement::DerefAssignment { target: var("w"), value: HirExpression::IntLiteral(1) },
+            HirStatement::Free { pointer: var("f") },
+            HirStatement::FieldAssignment {
+                object: var("node"),
+                field: "next".to_string(),
+                value: var("s"),
+            },
+            HirStatement::Return(Some(var("r"))),
+        ],
+    );
+
+    let summary = FunctionSummary::local(&f);
+    assert_eq!(summary.param_named("w").unwrap().effect(), ParamEffect::BorrowedMut);
+    assert_eq!(summary.param_named("f").unwrap().effect(), ParamEffect::Freed);
+    assert_eq!(summary.param_named("s").unwrap().effect(), ParamEffect::Consumed);
+    assert_eq!(summary.param_named("r").unwrap().effect(), ParamEffect::Escapes);
+}
+
+#[test]
+fn test_free_call_and_global_store() {
+    let f = func(
+        "release",
+        vec![int_ptr("p"), int_ptr("q")],
+        vec![
+            call("free", vec![var("p")]),
+            HirStatement::Assignment { target: "g_last".to_string(), value: var("q") },
+        ],
+    );
+
+    let summary = FunctionSummary::local(&f);
+    assert!(summary.param(0).unwrap().frees);
+    assert!(summary.param(1).unwrap().escapes);
+}
+
+#[test]
+fn test_shadowed_param_is_not_tracked() {
+    let f = func(
+        "shadow",
+        vec![int_ptr("p")],
+        vec![
+            HirStatement::VariableDeclaration {
+                name: "p".to_string(),
+                var_type: HirType::Pointer(Box::new(HirType::Int)),
+                initializer: None,
+            },
+            HirStatement::Free { pointer: var("p") },
+        ],
+    );
+
+    assert_eq!(FunctionSummary::local(&f).param(0).unwrap().effect(), ParamEffect::Borrowed);
+}
+
+#[test]
+fn test_raw_pointer_facts_in_nested_switch() {
+    let f = func(
+        "walk",
+        vec![int_ptr("p")],
+        vec![HirStatement::Switch {
+            condition: HirExpression::IntLiteral(0),
+            cases: vec![decy_hir::SwitchCase {
+                value: Some(HirExpression::IntLiteral(0)),
+                body: vec![HirStatement::If {
+                    condition: HirExpression::BinaryOp {
+                        op: BinaryOperator::NotEqual,
+                        left: Box::new(HirExpression::NullLiteral),
+                        right: Box::new(var("p")),
+                    },
+                    then_block: vec![HirStatement::Assignment {
+                        target: "p".to_string(),
+                        value: HirExpression::BinaryOp {
+                            op: BinaryOperator::Add,
+                            left: Box::new(var("p")),
+                            right: Box::new(HirExpression::IntLiteral(1)),
+                        },
+                    }],
+                    else_block: None,
+                }],
+            }],
+            default_case: None,
+        }],
+    );
+
+    let summary = FunctionSummary::local(&f);
+    let p = summary.param(0).unwrap();
+    assert!(p.null_checked);
+    assert!(p.pointer_arithmetic);
+    assert!(p.needs_raw_pointer());
+}
+
+#[test]
+fn test_effects_propagate_bottom_up() {
+    // destroy frees its argument; wrapper forwards to destroy; outer forwards to wrapper
+    let functions = vec![
+        func("outer", vec![int_ptr("a")], vec![call("wrapper", vec![var("a")])]),
+        func("wrapper", vec![int_ptr("b")], vec![call("destroy", vec![var("b")])]),
+        func("destroy", vec![int_ptr("c")], vec![HirStatement::Free { pointer: var("c") }]),
+    ];
+
+    let summaries = OwnershipSummaries::compute(&functions);
+    assert_eq!(summaries.len(), 3);
+    for name in ["outer", "wrapper", "destroy"] {
+        let effect = summaries.get(name).unwrap().param(0).unwrap().effect();
+        assert_eq!(effect, ParamEffect::Freed, "{name} should free its argument");
+    }
+
+    let order: Vec<&str> = summaries.sccs().iter().map(|scc| scc[0].as_str()).collect();
+    assert_eq!(order, vec!["destroy", "wrapper", "outer"]);
+}
+
+#[test]
+fn test_argument_position_is_respected() {
+    let functions = vec![
+        func(
+            "set",
+            vec![int_ptr("dst"), int_ptr("src")],
+            vec![HirStatement::DerefAssignment {
+                target: var("dst"),
+                value: HirExpression::Dereference(Box::new(var("src"))),
+            }],
+        ),
+        func(
+            "caller",
+            vec![int_ptr("x"), int_ptr("y")],
+            vec![call("set", vec![var("y"), var("x")])],
+        ),
+    ];
+
+    let summaries = OwnershipSummaries::compute(&functions);
+    let caller = summaries.get("caller").unwrap();
+    assert_eq!(caller.param_named("x").unwrap().effect(), ParamEffect::Borrowed);
+    assert_eq!(caller.param_named("y").unwrap().effect(), ParamEffect::BorrowedMut);
+}
+
+#[test]
+fn test_mutual_recursion_reaches_fixpoint() {
+    let functions = vec![
+        func("ping", vec![int_ptr("p")], vec![call("pong", vec![var("p")])]),
+        func(
+            "pong",
+            vec![int_ptr("q")],
+            vec![
+                call("ping", vec![var("q")]),
+                HirStatement::DerefAssignment {
+                    target: var("q"),
+                    value: HirExpression::IntLiteral(0),
+                },
+            ],
+        ),
+    ];
+
+    let summaries = OwnershipSummaries::compute(&functions);
+    assert_eq!(summaries.sccs().len(), 1);
+    assert_eq!(summaries.sccs()[0], vec!["ping".to_string(), "pong".to_string()]);
+    assert!(summaries.get("ping").unwrap().param(0).unwrap().writes);
+    assert!(summaries.get("pong").unwrap().param(0).unwrap().writes);
+}
+
+#[test]
+fn test_local_facts_do_not_propagate() {
+    // A callee's NULL check does not make the caller's parameter nullable
+    let functions = vec![
+        func(
+            "check",
+            vec![int_ptr("p")],
+            vec![HirStatement::If {
+                condition: HirExpression::IsNotNull(Box::new(var("p"))),
+                then_block: vec![],
+                else_block: None,
+            }],
+        ),
+        func("caller", vec![int_ptr("q")], vec![call("check", vec![var("q")])]),
+    ];
+
+    let summaries = OwnershipSummaries::compute(&functions);
+    assert!(summaries.get("check").unwrap().param(0).unwrap().null_checked);
+    assert!(!summaries.get("caller").unwrap().param(0).unwrap().null_checked);
+}
+
+#[test]
+fn test_definition_wins_over_prototype() {
+    let functions = vec![
+        HirFunction::new("sink".to_string(), HirType::Void, vec![int_ptr("p")]),
+        func("sink", vec![int_ptr("p")], vec![HirStatement::Free { pointer: var("p") }]),
+    ];
+
+    let summaries = OwnershipSummaries::compute(&functions);
+    let sink = summaries.get("sink").unwrap();
+    assert!(sink.has_body);
+    assert!(sink.param(0).unwrap().frees);
+}
+
+#[test]
+fn test_streaming_matches_batch() {
+    let functions = vec![
+        func("caller", vec![int_ptr("q")], vec![call("sink", vec![var("q")])]),
+        HirFunction::new("sink".to_string(), HirType::Void, vec![int_ptr("p")]),
+        func("sink", vec![int_ptr("p")], vec![HirStatement::Free { pointer: var("p") }]),
+        HirFunction::new("sink".to_string(), HirType::Void, vec![int_ptr("p")]),
+    ];
+
+    let batch = OwnershipSummaries::compute(&functions);
+    let streamed = OwnershipSummaries::compute_streaming(functions, std::iter::empty());
+    assert_eq!(streamed.len(), batch.len());
+    assert_eq!(streamed.sccs(), batch.sccs());
+    for name in ["caller", "sink"] {
+        assert_eq!(streamed.get(name), batch.get(name));
+    }
+    assert!(streamed.get("caller").unwrap().param(0).unwrap().frees);
+}
+
+#[test]
+fn test_parallel_waves_match_sequential() {
+    // Enough independent chains to cross the parallel threshold
+    let mut functions = Vec::new();
+    for i in 0..100 {
+        functions.push(func(
+            &format!("leaf_{i}"),
+            vec![int_ptr("p")],
+            vec![HirStatement::Free { pointer: var("p") }],
+        ));
+        functions.push(func(
+            &format!("mid_{i}"),
+            vec![int_ptr("p")],
+            vec![call(&format!("leaf_{i}"), vec![var("p")])],
+        ));
+    }
+
+    let summaries = OwnershipSummaries::compute(&functions);
+    assert_eq!(summaries.len(), 200);
+    for i in 0..100 {
+        assert!(summaries.get(&format!("mid_{i}")).unwrap().param(0).unwrap().frees);
+    }
+}
+
+#[test]
+fn test_classify_with_summaries_marks_forwarded_write() {
+    use crate::classifier_integration::{classify_with_rules, classify_with_summaries};
+    use crate::dataflow::DataflowAnalyzer;
+    use crate::inference::OwnershipKind;
+
+    let functions = vec![
+        func(
+            "store",
+            vec![int_ptr("p")],
+            vec![HirStatement::DerefAssignment {
+                target: var("p"),
+                value: HirExpression::IntLiteral(1),
+            }],
+        ),
+        func("forward", vec![int_ptr("q")], vec![call("store", vec![var("q")])]),
+    ];
+    let summaries = OwnershipSummaries::compute(&functions);
+    let forward = &functions[1];
+    let graph = DataflowAnalyzer::new().analyze(forward);
+
+    let without = classify_with_rules(&graph, forward);
+    assert_ne!(without["q"].kind, OwnershipKind::MutableBorrow);
+
+    let with = classify_with_summaries(&graph, forward, &summaries);
+    assert_eq!(with["q"].kind, OwnershipKind::MutableBorrow);
+}
+
+#[test]
+fn test_field_store_propagates_through_wrapper() {
+    let struct_ptr = |name: &str| {
+        HirParameter::new(
+            name.to_string(),
+            HirType::Pointer(Box::new(HirType::Struct("S".to_string()))),
+        )
+    };
+    // void init(struct S *s) { s->inner.x = 0; }  void w(struct S *t) { init(t); }
+    let functions = vec![
+        func(
+            "init",
+            vec![struct_ptr("s")],
+            vec![HirStatement::FieldAssignment {
+                object: HirExpression::PointerFieldAccess {
+                    pointer: Box::new(var("s")),
+                    field: "inner".to_string(),
+                },
+                field: "x".to_string(),
+                value: HirExpression::IntLiteral(0),
+            }],
+        ),
+        func("w", vec![struct_ptr("t")], vec![call("init", vec![var("t")])]),
+    ];
+
+    let summaries = OwnershipSummaries::compute(&functions);
+    for name in ["init", "w"] {
+        let effect = summaries.get(name).unwrap().param(0).unwrap().effect();
+        assert_eq!(effect, ParamEffect::BorrowedMut, "{name} should write through its argument");
+    }
+}
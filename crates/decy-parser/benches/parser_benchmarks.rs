@@ -4,6 +4,7 @@
 
 use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
 use decy_parser::CParser;
+use decy_synth::{generate, SynthConfig};
 
 fn bench_simple_function(c: &mut Criterion) {
     let parser = CParser::new().expect("Failed to create parser");
@@ -157,6 +158,61 @@ fn bench_type_variations(c: &mut Criterion) {
     });
 }
 
+/// Parse synthetic programs scaled along one generator axis at a time.
+fn bench_synthetic_scaling(c: &mut Criterion) {
+    let parser = CParser::new().expect("Failed to create parser");
+    let base = SynthConfig { functions: 20, statements_per_function: 20, ..Default::default() };
+
+    let axes: Vec<(&str, Vec<(usize, SynthConfig)>)> = vec![
+        (
+            "functions",
+            [10, 50, 100, 200]
+                .iter()
+                .map(|&n| (n, SynthConfig { functions: n, ..base.clone() }))
+                .collect(),
+        ),
+        (
+            "statements",
+            [10, 50, 100, 200]
+                .iter()
+                .map(|&n| (n, SynthConfig { statements_per_function: n, ..base.clone() }))
+                .collect(),
+        ),
+        (
+            "expression_depth",
+            [1, 3, 5, 7]
+                .iter()
+                .map(|&n| (n, SynthConfig { expression_depth: n, ..base.clone() }))
+                .collect(),
+        ),
+        (
+            "structs",
+            [1, 10, 50, 100]
+                .iter()
+                .map(|&n| (n, SynthConfig { structs: n, struct_fields: 8, ..base.clone() }))
+                .collect(),
+        ),
+        (
+            "macros",
+            [1, 10, 50, 100]
+                .iter()
+                .map(|&n| (n, SynthConfig { macros: n, ..base.clone() }))
+                .collect(),
+        ),
+    ];
+
+    for (axis, configs) in axes {
+        let mut group = c.benchmark_group(format!("parse_synthetic_{}", axis));
+        for (size, config) in configs {
+            let source = generate(&config).flattened();
+            group.bench_with_input(BenchmarkId::from_parameter(size), &source, |b, source| {
+                b.iter(|| parser.parse(black_box(source)).expect("Parse failed"))
+            });
+        }
+        group.finish();
+    }
+}
+
 criterion_group!(
     benches,
     bench_simple_function,
@@ -167,5 +223,6 @@ criterion_group!(
     bench_struct_definition,
     bench_control_flow,
     bench_type_variations,
+    bench_synthetic_scaling,
 );
 criterion_main!(benches);
@@ -984,6 +984,13 @@ impl Ast {
         &mut self.functions
     }
 
+    /// Move the functions out of the AST, leaving the other items in place.
+    ///
+    /// Lets a streaming pipeline free each function once it has been processed.
+    pub fn take_functions(&mut self) -> Vec<Function> {
+        std::mem::take(&mut self.functions)
+    }
+
     /// Add a function to the AST.
     pub fn add_function(&mut self, function: Function) {
         self.functions.push(function);
@@ -15,7 +15,8 @@ use oracle_integration::{OracleOptions, OracleTranspileResult};
 use anyhow::{Context, Result};
 use clap::{Parser, Subcommand};
 use std::fs;
-use std::path::PathBuf;
+use std::io::{self, Write};
+use std::path::{Path, PathBuf};
 
 /// Decy: C-to-Rust Transpiler with EXTREME Quality Standards
 #[derive(Parser, Debug)]
@@ -70,6 +71,27 @@ enum Commands {
         /// Verify that generated Rust compiles (runs rustc type-check)
         #[arg(long)]
         verify: bool,
+
+        /// Emit each function as soon as it is generated, keeping memory bounded
+        /// for very large translation units
+        #[arg(long, conflicts_with_all = ["trace", "oracle", "verify"])]
+        streaming: bool,
+
+        /// Write printf/puts/putchar output through one locked, buffered
+        /// stdout per function instead of a line-flushed print! per call
+        #[arg(long, conflicts_with_all = ["oracle", "streaming"])]
+        buffered_stdout: bool,
+
+        /// Split floating-point sum and dot-product loops across independent
+        /// lanes so they vectorise (reassociates additions; results may differ
+        /// from C in the last bits)
+        #[arg(long, conflicts_with_all = ["oracle", "streaming"])]
+        reassociate_float_reductions: bool,
+
+        /// Allocate list and tree nodes from one Vec arena per struct type
+        /// and link them by u32 index instead of by pointer
+        #[arg(long, conflicts_with_all = ["oracle", "streaming"])]
+        index_arenas: bool,
     },
     /// Transpile an entire C project (directory)
     TranspileProject {
@@ -284,12 +306,25 @@ fn run() -> Result<()> {
             import_patterns,
             oracle_report,
             verify,
+            streaming,
+            buffered_stdout,
+            reassociate_float_reductions,
+            index_arenas,
         }) => {
+            if streaming {
+                transpile_file_streaming(&input, output.as_deref())?;
+                return Ok(());
+            }
             let oracle_opts = OracleOptions::new(oracle, Some(oracle_threshold), auto_fix)
                 .with_capture(capture)
                 .with_import(import_patterns)
                 .with_report_format(oracle_report);
-            transpile_file(input, output, &oracle_opts, trace, verify)?;
+            let codegen_opts = decy_core::CodegenOptions {
+                buffered_stdout,
+                reassociate_float_reductions,
+                index_arenas,
+            };
+            transpile_file(input, output, &oracle_opts, &codegen_opts, trace, verify)?;
         }
         Some(Commands::TranspileProject {
             input,
@@ -362,6 +397,7 @@ fn transpile_file(
     input: PathBuf,
     output: Option<PathBuf>,
     oracle_opts: &OracleOptions,
+    codegen_opts: &decy_core::CodegenOptions,
     trace_enabled: bool,
     verify: bool,
 ) -> Result<()> {
@@ -387,7 +423,8 @@ fn transpile_file(
     } else if trace_enabled {
         // DECY-193: Transpile with decision tracing
         let (code, trace_collector) =
-            decy_core::transpile_with_trace(&c_code).with_context(|| {
+            decy_core::transpile_with_trace_and_options(&c_code, base_dir, codegen_opts)
+                .with_context(|| {
                 format!(
                     "Failed to transpile {}\n\nTry: Check if the C code has syntax errors\n  or: Preprocess the file first: gcc -E {} -o preprocessed.c",
                     input.display(),
@@ -399,13 +436,14 @@ fn transpile_file(
         (code, None)
     } else {
         // Standard transpilation using decy-core with #include support
-        let code = decy_core::transpile_with_includes(&c_code, base_dir).with_context(|| {
-            format!(
-                "Failed to transpile {}\n\nTry: Check if the C code has syntax errors\n  or: Preprocess the file first: gcc -E {} -o preprocessed.c",
-                input.display(),
-                input.display()
-            )
-        })?;
+        let code = decy_core::transpile_with_options(&c_code, base_dir, codegen_opts)
+            .with_context(|| {
+                format!(
+                    "Failed to transpile {}\n\nTry: Check if the C code has syntax errors\n  or: Preprocess the file first: gcc -E {} -o preprocessed.c",
+                    input.display(),
+                    input.display()
+                )
+            })?;
         (code, None)
     };
 
@@ -471,6 +509,45 @@ fn transpile_file(
     Ok(())
 }
 
+/// Transpile one file function by function straight into the output.
+fn transpile_file_streaming(input: &Path, output: Option<&Path>) -> Result<()> {
+    let c_code = fs::read_to_string(input).with_context(|| {
+        format!(
+            "Failed to read input file: {}\n\nTry: Check that the file exists and is readable\n  or: Verify the file path is correct",
+            input.display()
+        )
+    })?;
+    let transpile_failed = || {
+        format!(
+            "Failed to transpile {}\n\nTry: Check if the C code has syntax errors\n  or: Preprocess the file first: gcc -E {} -o preprocessed.c",
+            input.display(),
+            input.display()
+        )
+    };
+
+    match output {
+        Some(output_path) => {
+            let file = fs::File::create(output_path).with_context(|| {
+                format!("Failed to write output file: {}", output_path.display())
+            })?;
+            let mut writer = io::BufWriter::new(file);
+            decy_core::transpile_streaming(&c_code, input.parent(), &mut writer)
+                .with_context(transpile_failed)?;
+            writer.flush().with_context(|| {
+                format!("Failed to write output file: {}", output_path.display())
+            })?;
+            eprintln!("✓ Transpiled {} → {}", input.display(), output_path.display());
+        }
+        None => {
+            let mut writer = io::BufWriter::new(io::stdout().lock());
+            decy_core::transpile_streaming(&c_code, input.parent(), &mut writer)
+                .with_context(transpile_failed)?;
+            writer.flush().context("Failed to write to stdout")?;
+        }
+    }
+    Ok(())
+}
+
 fn print_oracle_stats(result: &OracleTranspileResult, opts: &OracleOptions) {
     // Check if we should output in a specific format
     if let Some(ref format) = opts.report_format {
@@ -683,8 +760,12 @@ fn transpile_project(
     stats: bool,
     _oracle_opts: &OracleOptions,
 ) -> Result<()> {
+    use decy_core::sidecar::SignatureSidecar;
     use decy_core::{DependencyGraph, TranspilationCache};
     use indicatif::{ProgressBar, ProgressStyle};
+    use std::collections::HashMap;
+    use std::sync::atomic::{AtomicUsize, Ordering};
+    use std::sync::Mutex;
     use std::time::Instant;
     use walkdir::WalkDir;
 
@@ -745,16 +826,13 @@ fn transpile_project(
         TranspilationCache::new()
     };
 
-    // Build dependency graph (simplified - actual implementation in decy-core)
-    let mut dep_graph = DependencyGraph::new();
-    for file in &c_files {
-        dep_graph.add_file(file);
-    }
+    // Build dependency graph between translation units: a.c depends on b.c
+    // when it includes b.h, so b.c's ownership sidecar is ready before a.c
+    let dep_graph = DependencyGraph::from_translation_units(&c_files)
+        .with_context(|| "Failed to compute build order")?;
 
-    // Get build order
-    let build_order = dep_graph
-        .topological_sort()
-        .with_context(|| "Failed to compute build order (circular dependencies?)")?;
+    // Files in one wave only depend on earlier waves
+    let build_waves = dep_graph.build_waves();
 
     // Setup progress bar (unless quiet mode)
     let pb = if quiet {
@@ -774,75 +852,115 @@ fn transpile_project(
     let mut transpiled_count = 0;
     let mut cached_count = 0;
     let mut total_lines = 0;
+    let mut sidecars: HashMap<PathBuf, SignatureSidecar> = HashMap::new();
+    let workers = std::thread::available_parallelism().map_or(1, |n| n.get());
+
+    // Transpile files wave by wave, in parallel within a wave
+    for wave in build_waves {
+        let mut pending = Vec::new();
+
+        for file_path in wave {
+            let relative_path = file_path.strip_prefix(&input_dir).unwrap_or(&file_path);
+            let output_path = output_dir.join(relative_path).with_extension("rs");
+
+            // Check cache; a hit is only usable if its sidecar is still on disk
+            if use_cache && cache.get(&file_path).is_some() {
+                if let Ok(sidecar) =
+                    SignatureSidecar::read(&SignatureSidecar::path_for(&output_path))
+                {
+                    if verbose {
+                        println!("✓ Cached: {}", relative_path.display());
+                    }
+                    pb.set_message(format!("✓ Cached {}", relative_path.display()));
+                    sidecars.insert(file_path.clone(), sidecar);
+                    cached_count += 1;
+                    pb.inc(1);
+                    continue;
+                }
+            }
 
-    // Transpile files in dependency order
-    for file_path in build_order {
-        let relative_path = file_path.strip_prefix(&input_dir).unwrap_or(&file_path);
-        pb.set_message(format!("Transpiling {}", relative_path.display()));
-
-        // Check cache
-        if use_cache {
-            if let Some(_cached) = cache.get(&file_path) {
-                if verbose {
-                    println!("✓ Cached: {}", relative_path.display());
+            if dry_run {
+                // Dry run mode - always show what would be done (that's the point of dry-run!)
+                if !quiet {
+                    println!("Would transpile: {}", relative_path.display());
                 }
-                pb.set_message(format!("✓ Cached {}", relative_path.display()));
-                cached_count += 1;
+                pb.set_message(format!("Would transpile {}", relative_path.display()));
                 pb.inc(1);
                 continue;
             }
-        }
 
-        // Read C code
-        let c_code = fs::read_to_string(&file_path)
-            .with_context(|| format!("Failed to read {}", file_path.display()))?;
+            // Dependencies from earlier waves export their ownership signatures
+            let imports: Vec<SignatureSidecar> = dep_graph
+                .dependencies_of(&file_path)
+                .iter()
+                .filter_map(|dep| sidecars.get(dep).cloned())
+                .collect();
+            pending.push((file_path, output_path, imports));
+        }
 
-        if dry_run {
-            // Dry run mode - always show what would be done (that's the point of dry-run!)
-            if !quiet {
-                println!("Would transpile: {}", relative_path.display());
+        let next = AtomicUsize::new(0);
+        let results = Mutex::new(Vec::with_capacity(pending.len()));
+        std::thread::scope(|scope| {
+            for _ in 0..workers.min(pending.len()) {
+                scope.spawn(|| loop {
+                    let index = next.fetch_add(1, Ordering::Relaxed);
+                    let Some((file_path, _, imports)) = pending.get(index) else {
+                        break;
+                    };
+                    let result = fs::read_to_string(file_path)
+                        .with_context(|| format!("Failed to read {}", file_path.display()))
+                        .and_then(|c_code| {
+                            decy_core::transpile_with_sidecars(&c_code, None, imports).with_context(
+                                || format!("Failed to transpile {}", file_path.display()),
+                            )
+                        });
+                    results.lock().expect("results lock poisoned").push((index, result));
+                });
             }
-            pb.set_message(format!("Would transpile {}", relative_path.display()));
-            pb.inc(1);
-            continue;
-        }
+        });
+        let mut results = results.into_inner().expect("results lock poisoned");
+        results.sort_by_key(|(index, _)| *index);
 
-        // Transpile
-        let rust_code = decy_core::transpile(&c_code)
-            .with_context(|| format!("Failed to transpile {}", file_path.display()))?;
+        for ((file_path, output_path, _), (_, result)) in pending.into_iter().zip(results) {
+            let relative_path = file_path.strip_prefix(&input_dir).unwrap_or(&file_path);
+            let (rust_code, sidecar) = result?;
 
-        total_lines += rust_code.lines().count();
+            total_lines += rust_code.lines().count();
 
-        // Compute output path (preserve directory structure)
-        let output_path = output_dir.join(relative_path).with_extension("rs");
+            // Create parent directory if needed
+            if let Some(parent) = output_path.parent() {
+                fs::create_dir_all(parent)?;
+            }
 
-        // Create parent directory if needed
-        if let Some(parent) = output_path.parent() {
-            fs::create_dir_all(parent)?;
-        }
+            // Write output and its ownership sidecar
+            fs::write(&output_path, &rust_code)
+                .with_context(|| format!("Failed to write {}", output_path.display()))?;
+            sidecar.write(&SignatureSidecar::path_for(&output_path))?;
 
-        // Write output
-        fs::write(&output_path, &rust_code)
-            .with_context(|| format!("Failed to write {}", output_path.display()))?;
+            if verbose {
+                println!("✓ Transpiled: {} → {}", relative_path.display(), output_path.display());
+            }
 
-        if verbose {
-            println!("✓ Transpiled: {} → {}", relative_path.display(), output_path.display());
-        }
+            // Update cache
+            if use_cache {
+                let transpiled = decy_core::TranspiledFile {
+                    source_path: file_path.clone(),
+                    rust_code: rust_code.clone(),
+                    dependencies: dep_graph.dependencies_of(&file_path),
+                    functions_exported: sidecar
+                        .functions
+                        .iter()
+                        .map(|f| f.name().to_string())
+                        .collect(),
+                    ffi_declarations: String::new(), // Would be populated by actual parser
+                };
+                cache.insert(&file_path, &transpiled);
+            }
 
-        // Update cache
-        if use_cache {
-            let transpiled = decy_core::TranspiledFile {
-                source_path: file_path.clone(),
-                rust_code: rust_code.clone(),
-                dependencies: vec![], // Would be populated by actual parser
-                functions_exported: vec![], // Would be populated by actual parser
-                ffi_declarations: String::new(), // Would be populated by actual parser
-            };
-            cache.insert(&file_path, &transpiled);
+            sidecars.insert(file_path, sidecar);
+            transpiled_count += 1;
+            pb.inc(1);
         }
-
-        transpiled_count += 1;
-        pb.inc(1);
     }
 
     pb.finish_with_message("Done");
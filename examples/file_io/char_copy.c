@@ -0,0 +1,28 @@
+// Character-at-a-time file copy
+// Tests: fopen, fgetc, fputc, fclose, whole-file read loops
+
+#include <stdio.h>
+
+int main(void) {
+    FILE* in = fopen("input.txt", "r");
+    if (in == NULL) {
+        return 1;
+    }
+    FILE* out = fopen("output.txt", "w");
+    if (out == NULL) {
+        fclose(in);
+        return 1;
+    }
+
+    int count = 0;
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        fputc(c, out);
+        count++;
+    }
+
+    fclose(in);
+    fclose(out);
+    printf("%d\n", count);
+    return 0;
+}
@@ -0,0 +1,76 @@
+#!/usr/bin/env bash
+# Runtime benchmark: C vs transpiled Rust for the file I/O examples
+#
+# For each program in examples/file_io:
+# 1. Compile with gcc -O2
+# 2. Transpile with decy, compile with rustc -O
+# 3. Run both against the same generated input file and compare wall time
+#
+# Usage: ./scripts/bench-file-io.sh [input_size_mb] [runs]
+
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+EXAMPLES_DIR="$PROJECT_DIR/examples/file_io"
+SIZE_MB="${1:-64}"
+RUNS="${2:-5}"
+TEMP_DIR=$(mktemp -d)
+trap 'rm -rf "$TEMP_DIR"' EXIT
+
+echo "Building decy..."
+export LLVM_CONFIG_PATH=/usr/bin/llvm-config-14
+export LIBCLANG_PATH=/usr/lib/llvm-14/lib
+cargo build -p decy --release --quiet 2>/dev/null || cargo build -p decy --release
+DECY="$PROJECT_DIR/target/release/decy"
+
+# Shared input: CSV-shaped text so line- and char-oriented programs both apply
+awk -v bytes=$((SIZE_MB * 1024 * 1024)) 'BEGIN {
+    n = 0
+    while (n < bytes) { line = "name" NR++ "," (NR % 90) ",city" (NR % 500); print line; n += length(line) + 1 }
+}' > "$TEMP_DIR/input.txt"
+
+# Mean wall time in seconds of running $1 in the temp dir $RUNS times
+time_runs() {
+    local bin="$1" start end
+    start=$(date +%s.%N)
+    for _ in $(seq "$RUNS"); do
+        (cd "$TEMP_DIR" && "$bin" > /dev/null)
+    done
+    end=$(date +%s.%N)
+    echo "scale=4; ($end - $start) / $RUNS" | bc
+}
+
+echo ""
+echo "## File I/O Runtime Benchmark (${SIZE_MB} MiB input, ${RUNS} runs)"
+echo ""
+echo "| Program | C (s) | Rust (s) | Rust/C |"
+echo "|---------|-------|----------|--------|"
+
+for c_file in "$EXAMPLES_DIR"/*.c; do
+    name=$(basename "$c_file" .c)
+    c_bin="$TEMP_DIR/c_${name}"
+    rs_file="$TEMP_DIR/rs_${name}.rs"
+    rust_bin="$TEMP_DIR/rust_${name}"
+
+    if ! gcc -std=c99 -O2 -o "$c_bin" "$c_file" 2>/dev/null; then
+        echo "| $name | gcc failed | - | - |"
+        continue
+    fi
+    if ! "$DECY" transpile "$c_file" -o "$rs_file" 2>/dev/null; then
+        echo "| $name | - | transpile failed | - |"
+        continue
+    fi
+    if ! rustc --edition 2021 -O -o "$rust_bin" "$rs_file" 2>/dev/null; then
+        echo "| $name | - | rustc failed | - |"
+        continue
+    fi
+
+    c_time=$(time_runs "$c_bin")
+    rust_time=$(time_runs "$rust_bin")
+    ratio=$(echo "scale=2; $rust_time / $c_time" | bc)
+    echo "| $name | $c_time | $rust_time | ${ratio}x |"
+done
+
+echo ""
+echo "Generated: $(date -Iseconds)"